@@ -3,9 +3,54 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 
 namespace calibration {
 
+namespace {
+
+constexpr int DETECTION_MAX_WIDTH = 640;     // 棋盘粗检测的图像宽度上限
+constexpr int SUBPIX_MAX_HALF_WINDOW = 11;   // 亚像素细化窗口半宽上限
+constexpr int SUBPIX_MIN_HALF_WINDOW = 3;
+
+constexpr int COVERAGE_COLS = 8;              // 覆盖统计的图像网格
+constexpr int COVERAGE_ROWS = 6;
+constexpr int MIN_NEW_CELLS = 2;              // 位姿相近但覆盖至少这么多新网格的视角仍然接受
+constexpr int INCREMENTAL_MIN_VIEWS = 3;      // 开始增量估计所需的视角数
+constexpr int CONVERGENCE_WINDOW = 3;         // 连续这么多次估计的内参变化都低于阈值才算收敛
+constexpr double MIN_CONVERGED_COVERAGE = 0.5; // 提前结束前角点至少覆盖的图像网格比例
+
+int countCells(uint64_t mask) {
+    int count = 0;
+    for (; mask; mask &= mask - 1) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief 增量内参估计：以上次估计为初值，迭代次数较少
+ */
+bool estimateIntrinsics(const std::vector<std::vector<cv::Point3f>>& objectPoints,
+                        const std::vector<std::vector<cv::Point2f>>& imagePoints,
+                        const cv::Size& imageSize, cv::Mat& cameraMatrix, cv::Mat& distCoeffs, double& rms) {
+    try {
+        std::vector<cv::Mat> rvecs, tvecs;
+        int flags = cameraMatrix.empty() ? 0 : cv::CALIB_USE_INTRINSIC_GUESS;
+        rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrix, distCoeffs, rvecs, tvecs,
+                                  flags, cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 20, 1e-6));
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARN("Incremental calibration estimate failed: ", e.what());
+        return false;
+    }
+}
+
+} // namespace
+
 CalibrationManager& CalibrationManager::getInstance() {
     static CalibrationManager instance;
     return instance;
@@ -29,8 +74,24 @@ bool CalibrationManager::initialize() {
     objectPoints_.clear();
     imageSize_ = cv::Size(0, 0);
     lastResult_ = CalibrationResult{};
+    views_.clear();
+    coverageMask_ = 0;
+    estimate_ = CalibrationEstimate{};
+    estimateCameraMatrix_ = cv::Mat();
+    estimateDistCoeffs_ = cv::Mat();
+    stableEstimates_ = 0;
     lastCaptureTime_ = std::chrono::steady_clock::now();
     
+    // 启动棋盘检测线程
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        stopDetection_ = false;
+        hasPendingFrame_ = false;
+        pendingCompute_ = nullptr;
+        detectionStats_ = ChessboardDetectionStats{};
+    }
+    detectionThread_ = std::thread(&CalibrationManager::detectionWorker, this);
+    
     initialized_ = true;
     LOG_INFO("CalibrationManager initialized successfully");
     return true;
@@ -63,6 +124,12 @@ bool CalibrationManager::startCalibration(const ConfigHelper::CalibrationConfig&
     objectPoints_.clear();
     imageSize_ = cv::Size(0, 0);
     lastResult_ = CalibrationResult{};
+    views_.clear();
+    coverageMask_ = 0;
+    estimate_ = CalibrationEstimate{};
+    estimateCameraMatrix_ = cv::Mat();
+    estimateDistCoeffs_ = cv::Mat();
+    stableEstimates_ = 0;
     
     // 创建保存目录
     try {
@@ -103,32 +170,403 @@ void CalibrationManager::stopCalibration() {
 }
 
 bool CalibrationManager::processFrame(const cv::Mat& frame) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!initialized_ || state_ != CalibrationState::COLLECTING || frame.empty()) {
+            return false;
+        }
+        
+        // 检查是否应该采集当前帧
+        if (!shouldCaptureFrame()) {
+            return false;
+        }
+    }
     
-    if (!initialized_ || state_ != CalibrationState::COLLECTING || frame.empty()) {
+    // 交给检测线程：槽位中尚未处理的旧帧被覆盖，拷贝复用槽位缓冲区
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        if (hasPendingFrame_) {
+            detectionStats_.framesDropped++;
+        }
+        frame.copyTo(pendingFrame_);
+        hasPendingFrame_ = true;
+        detectionStats_.framesSubmitted++;
+    }
+    pendingCondition_.notify_one();
+    return true;
+}
+
+void CalibrationManager::detectionWorker() {
+    cv::Mat frame;
+    cv::Mat gray;
+    std::vector<cv::Point2f> corners;
+    
+    while (true) {
+        std::function<void()> compute;
+        {
+            std::unique_lock<std::mutex> pendingLock(pendingMutex_);
+            pendingCondition_.wait(pendingLock, [this] {
+                return stopDetection_ || hasPendingFrame_ || pendingCompute_;
+            });
+            if (stopDetection_) {
+                return;
+            }
+            if (pendingCompute_) {
+                compute = std::move(pendingCompute_);
+                pendingCompute_ = nullptr;
+            } else {
+                // 交换缓冲区，检测期间采集线程可以写入新帧
+                cv::swap(frame, pendingFrame_);
+                hasPendingFrame_ = false;
+            }
+        }
+        if (compute) {
+            compute();
+            continue;
+        }
+        
+        cv::Size boardSize;
+        bool useSubPixel = true;
+        std::vector<cv::Point3f> boardPoints;
+        cv::Mat cameraMatrix, distCoeffs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != CalibrationState::COLLECTING) {
+                continue;
+            }
+            boardSize = cv::Size(config_.boardWidth, config_.boardHeight);
+            useSubPixel = config_.useSubPixel;
+            boardPoints = generateChessboardPoints();
+            cameraMatrix = estimateCameraMatrix_.clone();
+            distCoeffs = estimateDistCoeffs_.clone();
+        }
+        
+        auto startTime = std::chrono::steady_clock::now();
+        bool found = false;
+        try {
+            if (frame.channels() == 3) {
+                cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+            } else {
+                gray = frame;
+            }
+            found = detectChessboard(gray, boardSize, corners, useSubPixel);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Chessboard detection failed: ", e.what());
+        }
+        double detectionMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - startTime).count();
+        
+        {
+            std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+            detectionStats_.lastDetectionMs = detectionMs;
+            if (found) {
+                detectionStats_.boardsFound++;
+            }
+        }
+        
+        if (!found) {
+            continue;
+        }
+        
+        // 位姿与覆盖在锁外计算
+        ViewFeatures view;
+        try {
+            view = computeViewFeatures(corners, boardPoints, boardSize, gray.size(), cameraMatrix, distCoeffs);
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to estimate board pose: ", e.what());
+            continue;
+        }
+        
+        // 只在判断与追加结果时持有锁
+        bool runEstimate = false;
+        std::vector<std::vector<cv::Point3f>> objectPoints;
+        std::vector<std::vector<cv::Point2f>> imagePoints;
+        cv::Size imageSize;
+        CalibrationProgressCallback callback;
+        CalibrationState state = CalibrationState::COLLECTING;
+        std::string message;
+        int currentFrames = 0;
+        int totalFrames = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != CalibrationState::COLLECTING) {
+                continue;
+            }
+            if (!isInformativeViewLocked(view)) {
+                estimate_.rejectedViews++;
+                LOG_DEBUG("Calibration view rejected: too similar to collected views");
+                continue;
+            }
+            addCornersLocked(corners, gray.size(), view);
+            
+            currentFrames = static_cast<int>(imagePoints_.size());
+            totalFrames = config_.maxFrames;
+            callback = progressCallback_;
+            std::ostringstream oss;
+            oss << "已采集 " << currentFrames << " 帧 (覆盖 " << static_cast<int>(estimate_.coverage * 100) << "%)";
+            message = oss.str();
+            
+            state = state_;
+            runEstimate = state_ == CalibrationState::COLLECTING && config_.incrementalCalibration &&
+                          currentFrames >= INCREMENTAL_MIN_VIEWS;
+            if (runEstimate) {
+                objectPoints = objectPoints_;
+                imagePoints = imagePoints_;
+                imageSize = imageSize_;
+            }
+        }
+        
+        // 增量内参估计在检测线程上执行，不持有锁
+        if (runEstimate) {
+            CalibrationResult result;
+            if (estimateIntrinsics(objectPoints, imagePoints, imageSize, cameraMatrix, distCoeffs, result.rms)) {
+                result.cameraMatrix = cameraMatrix;
+                result.distCoeffs = distCoeffs;
+                result.imageSize = imageSize;
+                result.isValid = true;
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ == CalibrationState::COLLECTING && result.isValid) {
+                message = updateEstimateLocked(result);
+            }
+            state = state_;
+        }
+        
+        if (callback) {
+            callback(state, currentFrames, totalFrames, message);
+        }
+    }
+}
+
+bool CalibrationManager::detectChessboard(const cv::Mat& gray, const cv::Size& boardSize,
+                                          std::vector<cv::Point2f>& corners, bool useSubPixel) {
+    corners.clear();
+    if (gray.empty() || boardSize.width <= 0 || boardSize.height <= 0) {
         return false;
     }
     
-    // 检查是否应该采集当前帧
-    if (!shouldCaptureFrame()) {
+    // 在缩小的图像上粗检测，FAST_CHECK 快速拒绝没有棋盘的帧
+    double scale = std::min(1.0, static_cast<double>(DETECTION_MAX_WIDTH) / gray.cols);
+    cv::Mat small = gray;
+    if (scale < 1.0) {
+        cv::resize(gray, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    
+    if (!cv::findChessboardCorners(small, boardSize, corners,
+                                   cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE |
+                                   cv::CALIB_CB_FAST_CHECK)) {
+        corners.clear();
         return false;
     }
     
+    if (scale < 1.0) {
+        for (auto& corner : corners) {
+            corner.x = static_cast<float>((corner.x + 0.5) / scale - 0.5);
+            corner.y = static_cast<float>((corner.y + 0.5) / scale - 0.5);
+        }
+    } else if (!useSubPixel) {
+        return true;
+    }
+    
+    // 原分辨率亚像素细化：窗口覆盖缩放引入的误差，且不超过半个方格（避免跨到相邻角点）
+    float spacing = static_cast<float>(gray.cols);
+    for (int row = 0; row < boardSize.height; row++) {
+        for (int col = 1; col < boardSize.width; col++) {
+            const auto& a = corners[row * boardSize.width + col - 1];
+            const auto& b = corners[row * boardSize.width + col];
+            spacing = std::min(spacing, std::hypot(b.x - a.x, b.y - a.y));
+        }
+    }
+    int halfWindow = std::clamp(static_cast<int>(spacing * 0.4f), SUBPIX_MIN_HALF_WINDOW, SUBPIX_MAX_HALF_WINDOW);
+    cv::cornerSubPix(gray, corners, cv::Size(halfWindow, halfWindow), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1));
+    return true;
+}
+
+void CalibrationManager::addCornersLocked(const std::vector<cv::Point2f>& corners, const cv::Size& imageSize,
+                                          const ViewFeatures& view) {
+    // 添加角点
+    imagePoints_.push_back(corners);
+    
+    // 生成对应的世界坐标点
+    objectPoints_.push_back(generateChessboardPoints());
+    
+    // 记录图像大小
+    if (imageSize_.width == 0) {
+        imageSize_ = imageSize;
+    }
+    
+    // 记录视角与覆盖
+    views_.push_back(view);
+    coverageMask_ |= view.cells;
+    estimate_.views = static_cast<int>(views_.size());
+    estimate_.coverage = static_cast<double>(countCells(coverageMask_)) / (COVERAGE_COLS * COVERAGE_ROWS);
+    
+    // 更新最后采集时间
+    lastCaptureTime_ = std::chrono::steady_clock::now();
+    
+    int currentFrames = static_cast<int>(imagePoints_.size());
+    LOG_INFO("Captured calibration frame ", currentFrames, "/", config_.maxFrames,
+             " (coverage ", static_cast<int>(estimate_.coverage * 100), "%)");
+    
+    // 检查是否达到最小帧数，可以进行标定
+    if (currentFrames >= config_.minValidFrames) {
+        LOG_INFO("Minimum frames collected, can perform calibration");
+    }
+    
     // 检查是否已采集足够的帧
-    if (static_cast<int>(imagePoints_.size()) >= config_.maxFrames) {
+    if (currentFrames >= config_.maxFrames) {
         LOG_INFO("Reached maximum number of frames, starting calibration");
-        state_ = CalibrationState::PROCESSING;
+        launchCalibrationLocked();
+    }
+}
+
+CalibrationManager::ViewFeatures CalibrationManager::computeViewFeatures(
+        const std::vector<cv::Point2f>& corners, const std::vector<cv::Point3f>& boardPoints,
+        const cv::Size& boardSize, const cv::Size& imageSize,
+        const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs) {
+    ViewFeatures view;
+    double width = imageSize.width;
+    double height = imageSize.height;
+    
+    // 位置与覆盖网格
+    double sumX = 0.0, sumY = 0.0;
+    for (const auto& corner : corners) {
+        sumX += corner.x;
+        sumY += corner.y;
+        int col = std::clamp(static_cast<int>(corner.x / width * COVERAGE_COLS), 0, COVERAGE_COLS - 1);
+        int row = std::clamp(static_cast<int>(corner.y / height * COVERAGE_ROWS), 0, COVERAGE_ROWS - 1);
+        view.cells |= uint64_t(1) << (row * COVERAGE_COLS + col);
+    }
+    view.centerX = sumX / corners.size() / width;
+    view.centerY = sumY / corners.size() / height;
+    
+    // 尺度：四个外角点围成的四边形面积（鞋带公式）
+    const cv::Point2f quad[4] = {corners[0], corners[boardSize.width - 1], corners.back(),
+                                 corners[corners.size() - boardSize.width]};
+    double area = 0.0;
+    for (int i = 0; i < 4; i++) {
+        const auto& a = quad[i];
+        const auto& b = quad[(i + 1) % 4];
+        area += static_cast<double>(a.x) * b.y - static_cast<double>(b.x) * a.y;
+    }
+    view.scale = std::sqrt(std::fabs(area) * 0.5 / (width * height));
+    
+    // 倾斜：还没有内参估计时按 90° 左右视场猜测焦距，倾斜方向足够区分视角
+    cv::Mat intrinsics = cameraMatrix;
+    if (intrinsics.empty()) {
+        intrinsics = cv::Mat::eye(3, 3, CV_64F);
+        intrinsics.at<double>(0, 0) = std::max(width, height);
+        intrinsics.at<double>(1, 1) = std::max(width, height);
+        intrinsics.at<double>(0, 2) = width * 0.5;
+        intrinsics.at<double>(1, 2) = height * 0.5;
+    }
+    cv::Mat rvec, tvec, rotation;
+    if (cv::solvePnP(boardPoints, corners, intrinsics, distCoeffs, rvec, tvec)) {
+        cv::Rodrigues(rvec, rotation);
+        view.normalX = rotation.at<double>(0, 2);
+        view.normalY = rotation.at<double>(1, 2);
+    }
+    return view;
+}
+
+bool CalibrationManager::isInformativeViewLocked(const ViewFeatures& view) const {
+    if (views_.empty() || config_.minViewDistance <= 0.0) {
+        return true;
+    }
+    
+    // 覆盖了足够多的新网格（例如图像边角处畸变大的区域）
+    if (countCells(view.cells & ~coverageMask_) >= MIN_NEW_CELLS) {
+        return true;
+    }
+    
+    // 与最相近的已采集视角的位姿距离
+    double minDistance = INFINITY;
+    for (const auto& other : views_) {
+        double dx = view.centerX - other.centerX;
+        double dy = view.centerY - other.centerY;
+        double ds = view.scale - other.scale;
+        double dnx = view.normalX - other.normalX;
+        double dny = view.normalY - other.normalY;
+        minDistance = std::min(minDistance, std::sqrt(dx * dx + dy * dy + ds * ds + dnx * dnx + dny * dny));
+    }
+    return minDistance >= config_.minViewDistance;
+}
+
+std::string CalibrationManager::updateEstimateLocked(const CalibrationResult& result) {
+    double fx = result.cameraMatrix.at<double>(0, 0);
+    double fy = result.cameraMatrix.at<double>(1, 1);
+    double cx = result.cameraMatrix.at<double>(0, 2);
+    double cy = result.cameraMatrix.at<double>(1, 2);
+    
+    // 内参相对变化（主点变化相对焦距计算）
+    double change = INFINITY;
+    if (estimate_.valid && estimate_.fx > 0.0) {
+        change = std::max({std::fabs(fx - estimate_.fx) / estimate_.fx, std::fabs(fy - estimate_.fy) / estimate_.fy,
+                           std::fabs(cx - estimate_.cx) / estimate_.fx, std::fabs(cy - estimate_.cy) / estimate_.fy});
+    }
+    double previousRms = estimate_.rmsHistory.empty() ? result.rms : estimate_.rmsHistory.back();
+    
+    estimate_.valid = true;
+    estimate_.fx = fx;
+    estimate_.fy = fy;
+    estimate_.cx = cx;
+    estimate_.cy = cy;
+    estimate_.rms = result.rms;
+    estimate_.rmsHistory.push_back(result.rms);
+    estimateCameraMatrix_ = result.cameraMatrix.clone();
+    estimateDistCoeffs_ = result.distCoeffs.clone();
+    
+    stableEstimates_ = (change < config_.convergenceThreshold) ? stableEstimates_ + 1 : 0;
+    
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "已采集 " << estimate_.views << " 帧 (覆盖 " << static_cast<int>(estimate_.coverage * 100)
+        << "%), fx=" << std::setprecision(1) << fx << ", fy=" << fy << ", RMS " << std::setprecision(3)
+        << result.rms << " (" << (result.rms <= previousRms ? "-" : "+") << std::fabs(result.rms - previousRms)
+        << ")";
+    LOG_INFO("Calibration estimate: views=", estimate_.views, ", fx=", fx, ", fy=", fy,
+             ", cx=", cx, ", cy=", cy, ", rms=", result.rms, ", change=", change);
+    
+    // 内参连续稳定且覆盖足够时提前开始最终标定
+    if (config_.convergenceThreshold > 0.0 && stableEstimates_ >= CONVERGENCE_WINDOW &&
+        estimate_.views >= config_.minValidFrames && estimate_.coverage >= MIN_CONVERGED_COVERAGE) {
+        estimate_.converged = true;
+        LOG_INFO("Calibration converged after ", estimate_.views, " views, starting calibration");
+        oss << ", 已收敛";
+        launchCalibrationLocked();
+    }
+    return oss.str();
+}
+
+void CalibrationManager::launchCalibrationLocked() {
+    state_ = CalibrationState::PROCESSING;
+    
+    // 在检测线程中执行标定计算（使用数据快照，计算期间不持有锁）：PROCESSING 期间不再检测棋盘，
+    // 且 stop() 会等待该线程结束，计算结束前对象不会被析构
+    auto compute = [this, objectPoints = objectPoints_, imagePoints = imagePoints_, imageSize = imageSize_,
+                    minValidFrames = config_.minValidFrames]() {
+        CalibrationResult result;
+        if (imagePoints.size() < static_cast<size_t>(minValidFrames)) {
+            LOG_ERROR("Insufficient calibration frames: ", imagePoints.size(), " < ", minValidFrames);
+        } else {
+            result = performCalibration(objectPoints, imagePoints, imageSize);
+        }
         
-        // 在另一个线程中执行标定计算
-        std::thread([this]() {
-            CalibrationResult result;
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                result = performCalibration();
-                lastResult_ = result;
+        CalibrationProgressCallback callback;
+        CalibrationState state;
+        int currentFrames = static_cast<int>(imagePoints.size());
+        int totalFrames = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != CalibrationState::PROCESSING) {
+                // 计算期间标定被停止
+                return;
             }
+            lastResult_ = result;
             
-            std::lock_guard<std::mutex> lock(mutex_);
             if (result.isValid) {
                 state_ = CalibrationState::COMPLETED;
                 LOG_INFO("Calibration completed successfully");
@@ -137,80 +575,27 @@ bool CalibrationManager::processFrame(const cv::Mat& frame) {
                 if (!config_.saveDirectory.empty()) {
                     saveCalibrationResult(result);
                 }
-                
-                if (progressCallback_) {
-                    progressCallback_(state_, static_cast<int>(imagePoints_.size()), 
-                                    config_.maxFrames, "标定完成");
-                }
             } else {
                 state_ = CalibrationState::FAILED;
                 LOG_ERROR("Calibration failed");
-                
-                if (progressCallback_) {
-                    progressCallback_(state_, static_cast<int>(imagePoints_.size()), 
-                                    config_.maxFrames, "标定失败");
-                }
             }
-        }).detach();
-        
-        return true;
-    }
-    
-    // 转换为灰度图像
-    cv::Mat gray;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = frame;
-    }
-    
-    // 查找棋盘角点
-    std::vector<cv::Point2f> corners;
-    cv::Size boardSize(config_.boardWidth, config_.boardHeight);
-    
-    bool found = cv::findChessboardCorners(gray, boardSize, corners, 
-                                          cv::CALIB_CB_ADAPTIVE_THRESH | 
-                                          cv::CALIB_CB_NORMALIZE_IMAGE);
-    
-    if (found) {
-        // 亚像素精度角点检测
-        if (config_.useSubPixel) {
-            cv::cornerSubPix(gray, corners, cv::Size(11, 11), cv::Size(-1, -1),
-                           cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 
-                                          30, 0.1));
-        }
-        
-        // 添加角点
-        imagePoints_.push_back(corners);
-        
-        // 生成对应的世界坐标点
-        objectPoints_.push_back(generateChessboardPoints());
-        
-        // 记录图像大小
-        if (imageSize_.width == 0) {
-            imageSize_ = gray.size();
-        }
-        
-        // 更新最后采集时间
-        lastCaptureTime_ = std::chrono::steady_clock::now();
-        
-        int currentFrames = static_cast<int>(imagePoints_.size());
-        LOG_INFO("Captured calibration frame ", currentFrames, "/", config_.maxFrames);
-        
-        if (progressCallback_) {
-            std::string message = "已采集 " + std::to_string(currentFrames) + " 帧";
-            progressCallback_(state_, currentFrames, config_.maxFrames, message);
+            
+            callback = progressCallback_;
+            state = state_;
+            totalFrames = config_.maxFrames;
         }
         
-        // 检查是否达到最小帧数，可以进行标定
-        if (currentFrames >= config_.minValidFrames) {
-            LOG_INFO("Minimum frames collected, can perform calibration");
+        // 回调可能查询标定结果，在锁外调用
+        if (callback) {
+            callback(state, currentFrames, totalFrames, result.isValid ? "标定完成" : "标定失败");
         }
-        
-        return true;
-    }
+    };
     
-    return false;
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        pendingCompute_ = std::move(compute);
+    }
+    pendingCondition_.notify_one();
 }
 
 bool CalibrationManager::processFrame(std::shared_ptr<ob::Frame> frame) {
@@ -226,28 +611,24 @@ bool CalibrationManager::processFrame(std::shared_ptr<ob::Frame> frame) {
     return processFrame(image);
 }
 
-CalibrationResult CalibrationManager::performCalibration() {
+CalibrationResult CalibrationManager::performCalibration(const std::vector<std::vector<cv::Point3f>>& objectPoints,
+                                                         const std::vector<std::vector<cv::Point2f>>& imagePoints,
+                                                         const cv::Size& imageSize) {
     CalibrationResult result;
     
-    if (imagePoints_.empty() || objectPoints_.empty()) {
+    if (imagePoints.empty() || objectPoints.empty()) {
         LOG_ERROR("No calibration data available");
         return result;
     }
     
-    if (imagePoints_.size() < static_cast<size_t>(config_.minValidFrames)) {
-        LOG_ERROR("Insufficient calibration frames: ", imagePoints_.size(), 
-                  " < ", config_.minValidFrames);
-        return result;
-    }
-    
     try {
-        LOG_INFO("Starting calibration computation with ", imagePoints_.size(), " frames");
+        LOG_INFO("Starting calibration computation with ", imagePoints.size(), " frames");
         
         // 执行相机标定
         cv::Mat cameraMatrix, distCoeffs;
         std::vector<cv::Mat> rvecs, tvecs;
         
-        double rms = cv::calibrateCamera(objectPoints_, imagePoints_, imageSize_,
+        double rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize,
                                        cameraMatrix, distCoeffs, rvecs, tvecs);
         
         // 填充结果
@@ -256,7 +637,7 @@ CalibrationResult CalibrationManager::performCalibration() {
         result.rvecs = rvecs;
         result.tvecs = tvecs;
         result.rms = rms;
-        result.imageSize = imageSize_;
+        result.imageSize = imageSize;
         result.isValid = true;
         
         LOG_INFO("Calibration completed successfully");
@@ -311,11 +692,12 @@ bool CalibrationManager::saveCalibrationResult(const CalibrationResult& result,
     }
 }
 
-CalibrationResult CalibrationManager::loadCalibrationResult(const std::string& filename) {
+CalibrationResult CalibrationManager::loadCalibrationResult(const std::string& filename,
+                                                           const std::string& directory) {
     CalibrationResult result;
     
     try {
-        std::string filepath = config_.saveDirectory + filename + ".xml";
+        std::string filepath = (directory.empty() ? config_.saveDirectory : directory) + filename + ".xml";
         cv::FileStorage fs(filepath, cv::FileStorage::READ);
         
         if (!fs.isOpened()) {
@@ -381,20 +763,37 @@ void CalibrationManager::setProgressCallback(CalibrationProgressCallback callbac
     progressCallback_ = callback;
 }
 
+ChessboardDetectionStats CalibrationManager::getDetectionStats() const {
+    std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+    return detectionStats_;
+}
+
 void CalibrationManager::stop() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (!initialized_) {
-        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!initialized_) {
+            return;
+        }
+        
+        // 停止标定
+        if (state_ != CalibrationState::IDLE) {
+            state_ = CalibrationState::IDLE;
+        }
+        
+        progressCallback_ = nullptr;
+        initialized_ = false;
     }
     
-    // 停止标定
-    if (state_ != CalibrationState::IDLE) {
-        state_ = CalibrationState::IDLE;
+    // 停止检测线程（检测线程追加结果时需要 mutex_，不能持锁等待）
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        stopDetection_ = true;
+    }
+    pendingCondition_.notify_all();
+    if (detectionThread_.joinable()) {
+        detectionThread_.join();
     }
-    
-    progressCallback_ = nullptr;
-    initialized_ = false;
     
     LOG_INFO("CalibrationManager stopped");
 }
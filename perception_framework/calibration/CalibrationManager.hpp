@@ -8,6 +8,7 @@
 #include <functional>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
 #include <thread>
 #include <chrono>
 #include "libobsensor/ObSensor.hpp"
@@ -73,9 +74,42 @@ using CalibrationProgressCallback = std::function<void(CalibrationState state,
                                                       int totalFrames, 
                                                       const std::string& message)>;
 
+/**
+ * @brief 棋盘检测统计
+ */
+struct ChessboardDetectionStats {
+    uint64_t framesSubmitted = 0;   // 提交给检测线程的帧数
+    uint64_t framesDropped = 0;     // 检测线程忙时被新帧覆盖的帧数
+    uint64_t boardsFound = 0;       // 检测到棋盘的帧数
+    double lastDetectionMs = 0.0;   // 最近一次检测耗时(毫秒)
+};
+
+/**
+ * @brief 采集过程中的增量内参估计
+ */
+struct CalibrationEstimate {
+    int views = 0;                  // 已采集的视角数
+    int rejectedViews = 0;          // 与已有视角过于相似而被拒绝的视角数
+    double coverage = 0.0;          // 角点覆盖的图像网格比例 [0, 1]
+    bool valid = false;             // 是否已有内参估计
+    double fx = 0.0, fy = 0.0;      // 焦距(像素)
+    double cx = 0.0, cy = 0.0;      // 主点(像素)
+    double rms = 0.0;               // 最近一次估计的重投影误差
+    std::vector<double> rmsHistory; // 每次估计的重投影误差
+    bool converged = false;         // 内参已收敛，提前结束采集
+};
+
 /**
  * @brief 标定管理器 - 单例模式
  * 负责相机标定的所有功能，与其他组件保持低耦合
+ *
+ * 棋盘检测在独立的检测线程中执行，processFrame 只把帧放入单帧槽位（新帧覆盖
+ * 尚未处理的旧帧）后立即返回，采集线程不会被检测阻塞。
+ *
+ * 视角选择：检测到的棋盘按位置、尺度、倾斜（用当前内参估计 solvePnP 得到板面法向）
+ * 和图像网格覆盖评估，与所有已采集视角的位姿距离小于 minViewDistance 且没有覆盖
+ * 新网格的视角被拒绝。每采集一个视角在检测线程上用上次估计作为初值更新内参，
+ * 通过进度回调报告重投影误差趋势；内参连续收敛且覆盖足够时提前开始最终标定。
  */
 class CalibrationManager {
 public:
@@ -107,8 +141,9 @@ public:
     
     /**
      * @brief 处理输入帧（主要接口）
+     * 到达采集间隔时将帧交给检测线程，不等待检测结果
      * @param frame 输入帧
-     * @return 是否成功处理
+     * @return 是否提交给检测线程
      */
     bool processFrame(const cv::Mat& frame);
     
@@ -137,6 +172,14 @@ public:
         return static_cast<int>(imagePoints_.size()); 
     }
     
+    /**
+     * @brief 获取当前的增量内参估计
+     */
+    CalibrationEstimate getCurrentEstimate() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return estimate_;
+    }
+    
     /**
      * @brief 获取最后的标定结果
      * @return 标定结果
@@ -158,12 +201,14 @@ public:
     /**
      * @brief 加载标定结果
      * @param filename 文件名（不含扩展名）
+     * @param directory 目录（为空时使用标定配置的保存目录）
      * @return 标定结果
      */
-    CalibrationResult loadCalibrationResult(const std::string& filename = "camera_calibration");
+    CalibrationResult loadCalibrationResult(const std::string& filename = "camera_calibration",
+                                            const std::string& directory = "");
     
     /**
-     * @brief 应用去畸变
+     * @brief 应用去畸变（单张图像；每次调用都重新计算映射，视频流请使用 UndistortionStage）
      * @param src 源图像
      * @param dst 目标图像
      * @param result 标定结果
@@ -172,6 +217,23 @@ public:
     static bool undistortImage(const cv::Mat& src, cv::Mat& dst, 
                               const CalibrationResult& result);
     
+    /**
+     * @brief 在灰度图上检测棋盘角点
+     * 先在缩小后的图像上检测（带快速拒绝），找到棋盘后再在原分辨率上亚像素细化
+     * @param gray 8位灰度图
+     * @param boardSize 棋盘内角点数
+     * @param corners 输出的原分辨率角点
+     * @param useSubPixel 原图未缩小时是否做亚像素细化（缩小检测时总是细化）
+     * @return 是否找到棋盘
+     */
+    static bool detectChessboard(const cv::Mat& gray, const cv::Size& boardSize,
+                                 std::vector<cv::Point2f>& corners, bool useSubPixel = true);
+    
+    /**
+     * @brief 获取棋盘检测统计
+     */
+    ChessboardDetectionStats getDetectionStats() const;
+    
     /**
      * @brief 绘制棋盘角点
      * @param image 图像
@@ -207,10 +269,42 @@ private:
     CalibrationManager& operator=(const CalibrationManager&) = delete;
     
     /**
-     * @brief 执行标定计算
+     * @brief 棋盘视角特征（用于视角多样性判断）
+     */
+    struct ViewFeatures {
+        double centerX = 0.0, centerY = 0.0;    // 棋盘中心（按图像尺寸归一化）
+        double scale = 0.0;                     // 棋盘面积占图像面积的平方根
+        double normalX = 0.0, normalY = 0.0;    // 板面法向在相机坐标系中的 x/y 分量（倾斜程度）
+        uint64_t cells = 0;                     // 角点落入的图像网格（位掩码）
+    };
+    
+    /**
+     * @brief 执行标定计算（不访问成员，调用方传入数据快照）
      * @return 标定结果
      */
-    CalibrationResult performCalibration();
+    static CalibrationResult performCalibration(const std::vector<std::vector<cv::Point3f>>& objectPoints,
+                                                const std::vector<std::vector<cv::Point2f>>& imagePoints,
+                                                const cv::Size& imageSize);
+    
+    /**
+     * @brief 计算棋盘视角特征
+     * @param cameraMatrix 当前内参估计（为空时使用按图像尺寸猜测的内参）
+     */
+    static ViewFeatures computeViewFeatures(const std::vector<cv::Point2f>& corners,
+                                            const std::vector<cv::Point3f>& boardPoints,
+                                            const cv::Size& boardSize, const cv::Size& imageSize,
+                                            const cv::Mat& cameraMatrix, const cv::Mat& distCoeffs);
+    
+    /**
+     * @brief 视角是否提供足够的新信息（调用方持有 mutex_）
+     */
+    bool isInformativeViewLocked(const ViewFeatures& view) const;
+    
+    /**
+     * @brief 用增量估计结果更新内参估计并判断是否收敛（调用方持有 mutex_）
+     * @return 进度消息
+     */
+    std::string updateEstimateLocked(const CalibrationResult& result);
     
     /**
      * @brief 转换Orbbec帧为OpenCV Mat
@@ -230,6 +324,22 @@ private:
      * @return 是否应该采集
      */
     bool shouldCaptureFrame();
+    
+    /**
+     * @brief 棋盘检测线程：取出最新帧检测，找到棋盘后加锁追加角点；也执行排队的标定计算
+     */
+    void detectionWorker();
+    
+    /**
+     * @brief 追加一帧的角点，达到最大帧数时启动标定计算（调用方持有 mutex_）
+     */
+    void addCornersLocked(const std::vector<cv::Point2f>& corners, const cv::Size& imageSize,
+                          const ViewFeatures& view);
+    
+    /**
+     * @brief 把标定计算交给检测线程执行（调用方持有 mutex_）
+     */
+    void launchCalibrationLocked();
 
 private:
     mutable std::mutex mutex_;                    // 线程同步
@@ -244,7 +354,23 @@ private:
     cv::Size imageSize_;                          // 图像大小
     
     CalibrationResult lastResult_;                // 最后的标定结果
+    std::vector<ViewFeatures> views_;             // 已采集视角的特征
+    uint64_t coverageMask_ = 0;                   // 已覆盖的图像网格
+    CalibrationEstimate estimate_;                // 增量内参估计
+    cv::Mat estimateCameraMatrix_;                // 增量估计的内参矩阵（下次估计与 solvePnP 的初值）
+    cv::Mat estimateDistCoeffs_;
+    int stableEstimates_ = 0;                     // 内参变化连续低于收敛阈值的估计次数
     std::chrono::steady_clock::time_point lastCaptureTime_; // 最后采集时间
+    
+    // 棋盘检测线程（单帧槽位，只保留最新帧）
+    std::thread detectionThread_;
+    mutable std::mutex pendingMutex_;
+    std::condition_variable pendingCondition_;
+    cv::Mat pendingFrame_;                        // 待检测帧（复用缓冲区）
+    bool hasPendingFrame_ = false;
+    bool stopDetection_ = false;
+    std::function<void()> pendingCompute_;        // 待执行的标定计算（PROCESSING 期间检测线程空闲）
+    ChessboardDetectionStats detectionStats_;     // 由 pendingMutex_ 保护
 };
 
 } // namespace calibration 
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "UndistortionStage.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace calibration {
+
+namespace {
+
+constexpr int MIN_BAND_ROWS = 32;       // 每个并行分带的最少行数
+
+} // namespace
+
+void UndistortionStage::setCalibration(const CalibrationResult& result) {
+    if (!result.isValid || result.cameraMatrix.empty() || result.imageSize.width <= 0) {
+        reset();
+        return;
+    }
+
+    auto maps = std::make_shared<Maps>();
+    maps->calibration = result;
+    std::atomic_store(&maps_, maps);
+    LOG_INFO("Undistortion stage updated (calibrated at ", result.imageSize.width, "x", result.imageSize.height,
+             ", rms ", result.rms, ")");
+}
+
+void UndistortionStage::reset() {
+    std::atomic_store(&maps_, std::shared_ptr<Maps>());
+}
+
+bool UndistortionStage::isActive() const {
+    return std::atomic_load(&maps_) != nullptr;
+}
+
+std::shared_ptr<const UndistortionStage::MapSet> UndistortionStage::getMaps(Maps& maps, const cv::Size& size) {
+    std::lock_guard<std::mutex> lock(maps.mutex);
+
+    auto key = std::make_pair(size.width, size.height);
+    auto it = maps.bySize.find(key);
+    if (it != maps.bySize.end()) {
+        return it->second;
+    }
+
+    // 分辨率不同但宽高比相同（同一传感器的不同输出模式）时按比例缩放内参
+    const auto& calibration = maps.calibration;
+    double scaleX = static_cast<double>(size.width) / calibration.imageSize.width;
+    double scaleY = static_cast<double>(size.height) / calibration.imageSize.height;
+    std::shared_ptr<const MapSet> entry;
+    if (std::fabs(scaleX - scaleY) > 1e-3) {
+        LOG_WARN("Undistortion disabled for ", size.width, "x", size.height, ": aspect ratio differs from calibration (",
+                 calibration.imageSize.width, "x", calibration.imageSize.height, ")");
+    } else {
+        cv::Mat cameraMatrix = calibration.cameraMatrix.clone();
+        cameraMatrix.at<double>(0, 0) *= scaleX;
+        cameraMatrix.at<double>(0, 2) *= scaleX;
+        cameraMatrix.at<double>(1, 1) *= scaleY;
+        cameraMatrix.at<double>(1, 2) *= scaleY;
+
+        // 定点映射：remap 使用整数坐标 + 插值表，比浮点映射少一半内存带宽
+        auto mapSet = std::make_shared<MapSet>();
+        mapSet->cameraMatrix = cameraMatrix;
+        auto startTime = std::chrono::steady_clock::now();
+        cv::initUndistortRectifyMap(cameraMatrix, calibration.distCoeffs, cv::Mat(), cameraMatrix, size,
+                                    CV_16SC2, mapSet->map1, mapSet->map2);
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        entry = std::move(mapSet);
+        mapsBuilt_.fetch_add(1);
+        LOG_INFO("Undistortion maps built for ", size.width, "x", size.height, " in ", buildMs, " ms");
+    }
+
+    // 不兼容的分辨率也缓存（空指针），避免每帧重复判断和告警
+    maps.bySize[key] = entry;
+    return entry;
+}
+
+bool UndistortionStage::apply(const cv::Mat& src, cv::Mat& dst) {
+    auto maps = std::atomic_load(&maps_);
+    if (!maps || src.empty()) {
+        return false;
+    }
+
+    try {
+        auto entry = getMaps(*maps, src.size());
+        if (!entry) {
+            return false;
+        }
+        const cv::Mat& map1 = entry->map1;
+        const cv::Mat& map2 = entry->map2;
+
+        auto startTime = std::chrono::steady_clock::now();
+        dst.create(src.size(), src.type());
+
+        // 按行分带并行：每个分带只读取自己那部分映射表，输出行互不重叠
+        int bands = std::max(1, std::min(cv::getNumThreads(), src.rows / MIN_BAND_ROWS));
+        cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+            for (int band = range.start; band < range.end; band++) {
+                int rowBegin = src.rows * band / bands;
+                int rowEnd = src.rows * (band + 1) / bands;
+                cv::Mat out = dst.rowRange(rowBegin, rowEnd);
+                cv::remap(src, out, map1.rowRange(rowBegin, rowEnd), map2.rowRange(rowBegin, rowEnd),
+                          cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+            }
+        });
+
+        double remapMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        double currentTotal = totalRemapMs_.load();
+        while (!totalRemapMs_.compare_exchange_weak(currentTotal, currentTotal + remapMs)) {
+        }
+        framesProcessed_.fetch_add(1);
+        return true;
+    } catch (const cv::Exception& e) {
+        LOG_ERROR("Error in undistortion: ", e.what());
+        return false;
+    }
+}
+
+bool UndistortionStage::distortPoints(std::vector<cv::Point2f>& points, const cv::Size& size) {
+    auto maps = std::atomic_load(&maps_);
+    if (!maps || points.empty()) {
+        return false;
+    }
+
+    try {
+        auto entry = getMaps(*maps, size);
+        if (!entry) {
+            return false;
+        }
+
+        // 映射时新旧内参相同：去畸变像素 -> 归一化坐标 -> 按畸变模型重新投影
+        const cv::Mat& cameraMatrix = entry->cameraMatrix;
+        double fx = cameraMatrix.at<double>(0, 0);
+        double fy = cameraMatrix.at<double>(1, 1);
+        double cx = cameraMatrix.at<double>(0, 2);
+        double cy = cameraMatrix.at<double>(1, 2);
+        std::vector<cv::Point3f> normalized;
+        normalized.reserve(points.size());
+        for (const auto& point : points) {
+            normalized.emplace_back(static_cast<float>((point.x - cx) / fx), static_cast<float>((point.y - cy) / fy), 1.0f);
+        }
+        std::vector<cv::Point2f> distorted;
+        cv::Mat zero = cv::Mat::zeros(3, 1, CV_64F);
+        cv::projectPoints(normalized, zero, zero, cameraMatrix, maps->calibration.distCoeffs, distorted);
+        points.swap(distorted);
+        return true;
+    } catch (const cv::Exception& e) {
+        LOG_ERROR("Error mapping points to distorted image: ", e.what());
+        return false;
+    }
+}
+
+bool UndistortionStage::distortBox(cv::Rect2f& box, const cv::Size& size) {
+    float left = box.x;
+    float top = box.y;
+    float right = box.x + box.width;
+    float bottom = box.y + box.height;
+    float centerX = left + box.width * 0.5f;
+    float centerY = top + box.height * 0.5f;
+    std::vector<cv::Point2f> points = {
+        {left, top}, {centerX, top}, {right, top}, {right, centerY},
+        {right, bottom}, {centerX, bottom}, {left, bottom}, {left, centerY}};
+    if (!distortPoints(points, size)) {
+        return false;
+    }
+
+    float minX = points[0].x, maxX = points[0].x;
+    float minY = points[0].y, maxY = points[0].y;
+    for (const auto& point : points) {
+        minX = std::min(minX, point.x);
+        maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y);
+        maxY = std::max(maxY, point.y);
+    }
+    minX = std::max(0.0f, minX);
+    minY = std::max(0.0f, minY);
+    maxX = std::min(static_cast<float>(size.width), maxX);
+    maxY = std::min(static_cast<float>(size.height), maxY);
+    box = cv::Rect2f(minX, minY, std::max(0.0f, maxX - minX), std::max(0.0f, maxY - minY));
+    return true;
+}
+
+UndistortionStage::Stats UndistortionStage::getStats() const {
+    Stats stats;
+    stats.framesProcessed = framesProcessed_.load();
+    stats.mapsBuilt = mapsBuilt_.load();
+    stats.avgRemapMs = stats.framesProcessed > 0 ? totalRemapMs_.load() / stats.framesProcessed : 0.0;
+    return stats;
+}
+
+} // namespace calibration
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <opencv2/calib3d.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "CalibrationManager.hpp"
+
+namespace calibration {
+
+/**
+ * @brief 流式去畸变处理阶段
+ *
+ * cv::undistort 每次调用都重新计算去畸变映射。本阶段对每组标定结果和每个输入分辨率
+ * 只调用一次 initUndistortRectifyMap，生成定点格式（CV_16SC2 + 插值表）映射并缓存，
+ * 之后每帧只做 remap，按行分带并行执行。
+ * 标定分辨率与输入分辨率不同（宽高比相同）时按比例缩放内参。
+ * 加载新的标定结果时整体替换映射表（shared_ptr 原子替换），正在处理的帧继续使用旧映射。
+ * 只对推理输入去畸变，显示、保存与共享内存发布的仍是原始图像，
+ * 推理结果用 distortBox 映射回原始图像坐标。
+ * 线程安全。
+ */
+class UndistortionStage {
+public:
+    /**
+     * @brief 统计信息
+     */
+    struct Stats {
+        uint64_t framesProcessed = 0;   ///< 已去畸变的帧数
+        uint64_t mapsBuilt = 0;         ///< 生成映射表的次数
+        double avgRemapMs = 0.0;        ///< 每帧平均 remap 耗时(毫秒)
+    };
+
+    UndistortionStage() = default;
+    ~UndistortionStage() = default;
+    UndistortionStage(const UndistortionStage&) = delete;
+    UndistortionStage& operator=(const UndistortionStage&) = delete;
+
+    /**
+     * @brief 设置标定结果（丢弃已缓存的映射表）
+     * @param result 标定结果，无效时关闭去畸变
+     */
+    void setCalibration(const CalibrationResult& result);
+
+    /**
+     * @brief 清除标定结果，之后 apply 直接返回 false
+     */
+    void reset();
+
+    /**
+     * @brief 是否已设置有效的标定结果
+     */
+    bool isActive() const;
+
+    /**
+     * @brief 对一帧去畸变
+     * @param src 输入图像
+     * @param dst 输出图像（与 src 不能是同一块内存）
+     * @return 是否已去畸变（没有标定结果或分辨率不兼容时返回 false，dst 不变）
+     */
+    bool apply(const cv::Mat& src, cv::Mat& dst);
+
+    /**
+     * @brief 把去畸变图像上的点映射回原始（带畸变）图像坐标
+     * @param points 去畸变图像上的点，原地替换
+     * @param size 图像分辨率
+     * @return 是否已映射（没有标定结果或分辨率不兼容时返回 false，points 不变）
+     */
+    bool distortPoints(std::vector<cv::Point2f>& points, const cv::Size& size);
+
+    /**
+     * @brief 把去畸变图像上的框映射回原始图像坐标
+     * 畸变使直边弯曲，取四角与各边中点映射后的外接矩形（限制在图像范围内）
+     * @return 是否已映射
+     */
+    bool distortBox(cv::Rect2f& box, const cv::Size& size);
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * @brief 一个分辨率的映射表
+     */
+    struct MapSet {
+        cv::Mat map1;
+        cv::Mat map2;
+        cv::Mat cameraMatrix;           ///< 按分辨率缩放后的内参
+    };
+
+    /**
+     * @brief 一组标定结果对应的映射表（按分辨率缓存）
+     */
+    struct Maps {
+        CalibrationResult calibration;
+        std::mutex mutex;                                               ///< 保护 bySize
+        std::map<std::pair<int, int>, std::shared_ptr<const MapSet>> bySize;
+    };
+
+    /**
+     * @brief 获取指定分辨率的映射表，第一次使用时生成
+     */
+    std::shared_ptr<const MapSet> getMaps(Maps& maps, const cv::Size& size);
+
+    std::shared_ptr<Maps> maps_;        ///< 用 std::atomic_load/atomic_store 访问
+
+    std::atomic<uint64_t> framesProcessed_{0};
+    std::atomic<uint64_t> mapsBuilt_{0};
+    std::atomic<double> totalRemapMs_{0.0};
+};
+
+} // namespace calibration
@@ -0,0 +1,166 @@
+#include "BinaryFrame.hpp"
+#include <array>
+#include <cstring>
+
+namespace {
+
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+/**
+ * @brief slicing-by-8 查表：tables[k][b] 为字节 b 后接 k 个 0 字节的 CRC
+ */
+CrcTables makeCrcTables() {
+    CrcTables tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; bit++) {
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+        }
+        tables[0][i] = value;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (size_t k = 1; k < 8; k++) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+const CrcTables CRC_TABLES = makeCrcTables();
+
+template <typename T>
+void storeLE(uint8_t* out, T value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+template <typename T>
+T loadLE(const uint8_t* in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+uint32_t BinaryFrame::crc32(const void* data, size_t size, uint32_t crc) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const auto& t = CRC_TABLES;
+    crc = ~crc;
+
+    // 每次处理 8 字节
+    while (size >= 8) {
+        uint32_t low = crc ^ (static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+                              static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = t[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void BinaryFrame::writeHeader(uint8_t* out, const FrameHeader& header, uint32_t length) {
+    out[0] = MAGIC0;
+    out[1] = MAGIC1;
+    out[2] = VERSION;
+    out[3] = header.type;
+    storeLE<uint16_t>(out + 4, header.flags);
+    storeLE<uint16_t>(out + 6, 0);
+    storeLE<uint32_t>(out + 8, header.sequence);
+    storeLE<uint64_t>(out + 12, header.timestampUs);
+    storeLE<uint32_t>(out + 20, length);
+    storeLE<uint16_t>(out + 6, static_cast<uint16_t>(crc32(out, HEADER_SIZE)));
+}
+
+BinaryFrame::ScanResult BinaryFrame::scan(const char* data, size_t size, size_t& frameSize) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    if (size == 0) {
+        return ScanResult::NEED_MORE;
+    }
+    if (bytes[0] != MAGIC0 || (size > 1 && bytes[1] != MAGIC1) || (size > 2 && bytes[2] != VERSION)) {
+        return ScanResult::INVALID;
+    }
+    if (size < HEADER_SIZE) {
+        return ScanResult::NEED_MORE;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    std::memcpy(header, bytes, HEADER_SIZE);
+    header[6] = header[7] = 0;
+    if (static_cast<uint16_t>(crc32(header, HEADER_SIZE)) != loadLE<uint16_t>(bytes + 6)) {
+        return ScanResult::INVALID;
+    }
+
+    uint32_t length = loadLE<uint32_t>(bytes + 20);
+    if (length > MAX_PAYLOAD) {
+        return ScanResult::INVALID;
+    }
+    size_t total = OVERHEAD + length;
+    if (size < total) {
+        return ScanResult::NEED_MORE;
+    }
+
+    if (crc32(bytes, HEADER_SIZE + length) != loadLE<uint32_t>(bytes + HEADER_SIZE + length)) {
+        return ScanResult::INVALID;
+    }
+    frameSize = total;
+    return ScanResult::FRAME;
+}
+
+size_t BinaryFrame::encode(char* out, size_t capacity, const FrameHeader& header, const void* payload,
+                           size_t payloadSize) {
+    if (payloadSize > MAX_PAYLOAD || capacity < OVERHEAD + payloadSize) {
+        return 0;
+    }
+
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(out);
+    writeHeader(bytes, header, static_cast<uint32_t>(payloadSize));
+    if (payloadSize > 0) {
+        std::memcpy(bytes + HEADER_SIZE, payload, payloadSize);
+    }
+    storeLE<uint32_t>(bytes + HEADER_SIZE + payloadSize, crc32(bytes, HEADER_SIZE + payloadSize));
+    return OVERHEAD + payloadSize;
+}
+
+bool BinaryFrame::prepare(IoVec& vec, const FrameHeader& header, const void* payload, size_t payloadSize) {
+    if (payloadSize > MAX_PAYLOAD) {
+        return false;
+    }
+
+    writeHeader(vec.header, header, static_cast<uint32_t>(payloadSize));
+    uint32_t crc = crc32(vec.header, HEADER_SIZE);
+    crc = crc32(payload, payloadSize, crc);
+    storeLE<uint32_t>(vec.trailer, crc);
+
+    vec.iov[0].iov_base = vec.header;
+    vec.iov[0].iov_len = HEADER_SIZE;
+    vec.iov[1].iov_base = const_cast<void*>(payload);
+    vec.iov[1].iov_len = payloadSize;
+    vec.iov[2].iov_base = vec.trailer;
+    vec.iov[2].iov_len = TRAILER_SIZE;
+    return true;
+}
+
+bool BinaryFrame::decode(std::string_view frame, FrameHeader& header, std::string_view& payload) {
+    size_t frameSize = 0;
+    if (scan(frame.data(), frame.size(), frameSize) != ScanResult::FRAME || frameSize != frame.size()) {
+        return false;
+    }
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(frame.data());
+    header.version = bytes[2];
+    header.type = bytes[3];
+    header.flags = loadLE<uint16_t>(bytes + 4);
+    header.sequence = loadLE<uint32_t>(bytes + 8);
+    header.timestampUs = loadLE<uint64_t>(bytes + 12);
+    header.length = loadLE<uint32_t>(bytes + 20);
+    payload = frame.substr(HEADER_SIZE, header.length);
+    return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <sys/uio.h>
+
+/**
+ * @brief 二进制帧头部字段
+ */
+struct FrameHeader {
+    uint8_t version = 1;            ///< 协议版本（编码时固定为 BinaryFrame::VERSION）
+    uint8_t type = 0;               ///< 消息类型（CommunicationProxy::MessageType）
+    uint16_t flags = 0;             ///< 标志位
+    uint32_t sequence = 0;          ///< 发送序号
+    uint64_t timestampUs = 0;       ///< 发送时间（steady_clock，微秒）
+    uint32_t length = 0;            ///< 载荷长度(字节)
+};
+
+/**
+ * @brief 二进制消息帧编解码
+ *
+ * 帧布局（小端）：
+ *   0  magic      2  0xA5 0x5A
+ *   2  version    1
+ *   3  type       1
+ *   4  flags      2
+ *   6  hcheck     2  头部校验：头部（本字段置 0）CRC-32 的低 16 位
+ *   8  sequence   4
+ *  12  timestamp  8
+ *  20  length     4
+ *  24  payload    length
+ *  24+length crc32 4  覆盖头部和载荷
+ *
+ * 文本协议的消息以数字开头，首字节 0xA5 不会出现在文本消息开头，
+ * 接收端按首字节区分两种格式，过渡期内两种消息可以混在同一个流中。
+ * 头部单独校验，长度字段损坏时收到头部即可判定无效，不必等待（可能永远不会到达的）载荷。
+ */
+class BinaryFrame {
+public:
+    static constexpr uint8_t MAGIC0 = 0xA5;
+    static constexpr uint8_t MAGIC1 = 0x5A;
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 24;
+    static constexpr size_t TRAILER_SIZE = 4;
+    static constexpr size_t OVERHEAD = HEADER_SIZE + TRAILER_SIZE;
+    static constexpr uint32_t MAX_PAYLOAD = 1024 * 1024;
+
+    static constexpr uint16_t FLAG_REQUEST = 0x0001;   ///< 请求：载荷前 REQUEST_ID_SIZE 字节为请求编号（小端）
+    static constexpr uint16_t FLAG_RESPONSE = 0x0002;  ///< 回复：载荷前 REQUEST_ID_SIZE 字节为所回复的请求编号
+    static constexpr size_t REQUEST_ID_SIZE = 4;
+
+    /**
+     * @brief 流中一段数据的检查结果
+     */
+    enum class ScanResult {
+        NEED_MORE,      ///< 数据不足一帧
+        FRAME,          ///< 完整有效的帧
+        INVALID         ///< 不是有效的帧（魔数、版本、长度或 CRC 不符）
+    };
+
+    /**
+     * @brief 分散写入用的帧描述：头部和校验码存放在本结构内，载荷直接引用调用方内存
+     */
+    struct IoVec {
+        uint8_t header[HEADER_SIZE];
+        uint8_t trailer[TRAILER_SIZE];
+        iovec iov[3];
+    };
+
+    /**
+     * @brief 首字节是否为帧魔数
+     */
+    static bool isFrameStart(const char* data, size_t size) {
+        return size > 0 && static_cast<uint8_t>(data[0]) == MAGIC0;
+    }
+
+    /**
+     * @brief 检查从 data 开始的数据是否为完整的帧
+     * @param frameSize 返回帧总长度（FRAME 时有效）
+     */
+    static ScanResult scan(const char* data, size_t size, size_t& frameSize);
+
+    /**
+     * @brief 编码到调用方预分配的缓冲区
+     * @param header 头部字段（length 由 payloadSize 决定）
+     * @return 写入的字节数，缓冲区不足或载荷过大时返回 0
+     */
+    static size_t encode(char* out, size_t capacity, const FrameHeader& header, const void* payload,
+                         size_t payloadSize);
+
+    /**
+     * @brief 生成 writev 用的三段描述（头部、载荷、校验码），载荷不拷贝
+     * @return 载荷是否在允许范围内
+     */
+    static bool prepare(IoVec& vec, const FrameHeader& header, const void* payload, size_t payloadSize);
+
+    /**
+     * @brief 解码一个完整的帧并校验
+     * @param payload 指向 frame 内部的载荷
+     * @return 是否有效
+     */
+    static bool decode(std::string_view frame, FrameHeader& header, std::string_view& payload);
+
+    /**
+     * @brief CRC-32（IEEE 802.3，slicing-by-8 查表实现）
+     * @param crc 上一段数据的结果，用于分段计算
+     */
+    static uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+private:
+    static void writeHeader(uint8_t* out, const FrameHeader& header, uint32_t length);
+};
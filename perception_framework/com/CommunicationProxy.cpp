@@ -1,9 +1,11 @@
 #include "CommunicationProxy.hpp"
 #include "FifoComm.hpp"
+#include "BinaryFrame.hpp"
 #include "Logger.hpp"
 #include <chrono>
 #include <algorithm>
 #include <cstring>
+#include <stdexcept>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -13,14 +15,25 @@
 // Default thread pool size
 constexpr size_t DEFAULT_THREAD_POOL_SIZE = 3;
 
+// Maximum time the receiving thread blocks waiting for data; bounds how late a
+// connection state change is noticed
+constexpr int RECEIVE_WAIT_MS = 100;
+
+// Messages a strand handles before giving its worker back to other message types
+constexpr size_t STRAND_BATCH = 32;
+
+// Protocol negotiation line, sent in the text format. The type is outside MessageType,
+// so peers that only speak text ignore it
+constexpr std::string_view PROTOCOL_OFFER = "99:binary-frame/1";
+
 // CommunicationProxy implementation
 CommunicationProxy& CommunicationProxy::getInstance() {
     static CommunicationProxy instance;
     return instance;
 }
 
-CommunicationProxy::CommunicationProxy() {
-    // Constructor
+CommunicationProxy::CommunicationProxy()
+    : callbacks_(std::make_shared<const CallbackMap>()) {
 }
 
 CommunicationProxy::~CommunicationProxy() {
@@ -38,8 +51,20 @@ bool CommunicationProxy::initialize(const std::string& basePath, CommRole role)
     // Set initial connection state to connecting
     setConnectionState(ConnectionState::CONNECTING);
     
-    // Create FIFO communication implementation
-    commImpl_ = std::make_unique<FifoCommImpl>(basePath, role);
+    // Create communication implementation for the selected transport
+    if (transport_ == Transport::UDS) {
+        commImpl_ = std::make_unique<UdsCommImpl>(basePath + ".sock", role);
+    } else {
+        commImpl_ = std::make_unique<FifoCommImpl>(basePath, role);
+    }
+    
+    // A newly connected peer may be a different build; negotiate the wire format again
+    commImpl_->setPeerConnectedHandler([this]() {
+        peerSupportsBinary_ = false;
+        if (binaryFramingEnabled_ && isRunning_) {
+            sendProtocolOffer();
+        }
+    });
     
     // Initialize communication implementation
     if (!commImpl_->initialize()) {
@@ -77,6 +102,11 @@ void CommunicationProxy::start() {
     // Start message receiving thread
     receivingThread_ = std::thread(&CommunicationProxy::messageReceivingThread, this);
     
+    // Offer binary framing; until the peer answers, messages use the text protocol
+    if (binaryFramingEnabled_) {
+        sendProtocolOffer();
+    }
+    
     // Start different initialization flow based on role
     if (commImpl_->isServer()) {
         LOG_INFO("Server started, waiting for client connection...");
@@ -102,14 +132,28 @@ void CommunicationProxy::stop() {
         connectionCondition_.notify_all();
     }
     
+    // Wake the receiving thread if it is blocked waiting for data
+    if (commImpl_) {
+        commImpl_->interruptReceive();
+    }
+    
     // Wait for thread to end
     if(receivingThread_.joinable()) {
         receivingThread_.join();
     }
     
+    // No replies can arrive any more; release waiters while the pool can still run their callbacks
+    failPendingRequests("communication proxy stopped");
+    
     // Destroy thread pool (destructor will handle thread shutdown)
     threadPool_.reset();
     
+    // Messages left in a strand were dropped with the pool
+    {
+        std::lock_guard<std::mutex> lock(strandsMutex_);
+        strands_.clear();
+    }
+    
     // Clean up communication resources
     if (commImpl_) {
         commImpl_->cleanup();
@@ -136,32 +180,296 @@ bool CommunicationProxy::sendMessage(MessageType type, const std::string& conten
         return false;
     }
     
+    LOG_DEBUG("Sending message: type=", static_cast<int>(type), ", content=", content);
+    
     // Create message, set priority
     MessagePriority priority = getMessagePriority(type);
     Message message(type, content, priority);
+    bool result = transmit(message);
     
-    LOG_DEBUG("Sending message: type=", static_cast<int>(type), ", content=", content);
+    // If send fails, connection may be broken
+    if (!result) {
+        setConnectionState(ConnectionState::DISCONNECTED);
+    }
     
-    // Serialize message and send through communication implementation
-    bool result = commImpl_->sendMessage(message.serialize());
+    return result;
+}
+
+bool CommunicationProxy::sendBinary(MessageType type, const void* data, size_t size, uint32_t coalesceKey) {
+    if(!isRunning_) {
+        LOG_ERROR("Cannot send message: communication proxy not running");
+        return false;
+    }
     
-    // If send fails, connection may be broken
+    if (connectionState_ != ConnectionState::CONNECTED) {
+        return false;
+    }
+    
+    // Text protocol cannot carry arbitrary bytes
+    if (!isBinaryFramingActive()) {
+        LOG_DEBUG("Cannot send binary payload: peer has not negotiated binary framing");
+        return false;
+    }
+    
+    bool result = sendFrame(type, data, size, 0, coalesceKey);
     if (!result) {
         setConnectionState(ConnectionState::DISCONNECTED);
     }
+    return result;
+}
+
+bool CommunicationProxy::transmit(const Message& message) {
+    if (!isBinaryFramingActive()) {
+        // Serialize message and send through communication implementation
+        return commImpl_->sendMessage(message.serialize());
+    }
+    if (message.requestId == 0) {
+        return sendFrame(message.type, message.content.data(), message.content.size());
+    }
     
+    // Requests and replies carry the request id (little-endian) ahead of the content
+    std::string payload(BinaryFrame::REQUEST_ID_SIZE + message.content.size(), '\0');
+    for (size_t i = 0; i < BinaryFrame::REQUEST_ID_SIZE; ++i) {
+        payload[i] = static_cast<char>((message.requestId >> (8 * i)) & 0xFF);
+    }
+    std::memcpy(&payload[BinaryFrame::REQUEST_ID_SIZE], message.content.data(), message.content.size());
+    return sendFrame(message.type, payload.data(), payload.size(),
+                     message.isResponse ? BinaryFrame::FLAG_RESPONSE : BinaryFrame::FLAG_REQUEST);
+}
+
+std::future<CommunicationProxy::Message> CommunicationProxy::request(MessageType type, const std::string& content,
+                                                                     int timeoutMs) {
+    PendingRequest pending;
+    pending.promise = std::make_shared<std::promise<Message>>();
+    std::future<Message> future = pending.promise->get_future();
+    startRequest(type, content, timeoutMs, std::move(pending));
+    return future;
+}
+
+void CommunicationProxy::request(MessageType type, const std::string& content, int timeoutMs,
+                                 ResponseCallback callback) {
+    PendingRequest pending;
+    pending.callback = std::move(callback);
+    startRequest(type, content, timeoutMs, std::move(pending));
+}
+
+void CommunicationProxy::startRequest(MessageType type, const std::string& content, int timeoutMs,
+                                      PendingRequest pending) {
+    Message message(type, content, getMessagePriority(type));
+    if (!isRunning_ || connectionState_ != ConnectionState::CONNECTED) {
+        completeRequest(pending, message, "not connected");
+        return;
+    }
+    
+    // Zero marks plain messages; skip it when the counter wraps
+    uint32_t id = nextRequestId_.fetch_add(1);
+    if (id == 0) {
+        id = nextRequestId_.fetch_add(1);
+    }
+    message.requestId = id;
+    
+    // Register before sending, the reply may arrive before transmit returns
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pendingRequests_.emplace(id, std::move(pending));
+    }
+    
+    // The timeout runs on the shared timer wheel; attach it unless the request already completed
+    auto& wheel = utils::TimerWheel::getInstance();
+    utils::TimerWheel::TimerId timer = wheel.schedule(std::chrono::milliseconds(std::max(timeoutMs, 0)),
+                                                      [this, id]() { expireRequest(id); });
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        auto it = pendingRequests_.find(id);
+        if (it != pendingRequests_.end()) {
+            it->second.timer = timer;
+            timer = utils::TimerWheel::INVALID_TIMER;
+        }
+    }
+    wheel.cancel(timer);
+    
+    LOG_DEBUG("Sending request ", id, ": type=", static_cast<int>(type), ", content=", content);
+    
+    if (!transmit(message)) {
+        PendingRequest failed;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            auto it = pendingRequests_.find(id);
+            if (it != pendingRequests_.end()) {
+                failed = std::move(it->second);
+                pendingRequests_.erase(it);
+                found = true;
+            }
+        }
+        if (found) {
+            completeRequest(failed, message, "send failed");
+        }
+        setConnectionState(ConnectionState::DISCONNECTED);
+    }
+}
+
+bool CommunicationProxy::reply(const Message& request, MessageType type, const std::string& content) {
+    if (request.requestId == 0) {
+        return sendMessage(type, content);
+    }
+    
+    if (!isRunning_ || connectionState_ != ConnectionState::CONNECTED) {
+        LOG_WARN("Failed to reply to request ", request.requestId, ": not connected");
+        return false;
+    }
+    
+    Message message(type, content, getMessagePriority(type));
+    message.requestId = request.requestId;
+    message.isResponse = true;
+    
+    bool result = transmit(message);
+    if (!result) {
+        setConnectionState(ConnectionState::DISCONNECTED);
+    }
     return result;
 }
 
+size_t CommunicationProxy::pendingRequestCount() const {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    return pendingRequests_.size();
+}
+
+void CommunicationProxy::completeRequest(PendingRequest& pending, const Message& response, const std::string& error) {
+    // No-op when called from the request's own timeout
+    utils::TimerWheel::getInstance().cancel(pending.timer);
+    pending.timer = utils::TimerWheel::INVALID_TIMER;
+    
+    if (pending.promise) {
+        if (error.empty()) {
+            pending.promise->set_value(response);
+        } else {
+            pending.promise->set_exception(std::make_exception_ptr(std::runtime_error("Request failed: " + error)));
+        }
+    }
+    
+    if (pending.callback) {
+        Message result = response;
+        if (!error.empty()) {
+            result.content = error;
+        }
+        bool success = error.empty();
+        auto task = [callback = std::move(pending.callback), success, result]() {
+            try {
+                callback(success, result);
+            }
+            catch(const std::exception& e) {
+                LOG_ERROR("Response callback exception: ", e.what());
+            }
+        };
+        
+        // Never run user code on the receiving thread
+        if (threadPool_) {
+            threadPool_->submit(std::move(task));
+        } else {
+            task();
+        }
+    }
+}
+
+void CommunicationProxy::expireRequest(uint32_t id) {
+    PendingRequest expired;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        auto it = pendingRequests_.find(id);
+        if (it == pendingRequests_.end()) {
+            return;
+        }
+        expired = std::move(it->second);
+        pendingRequests_.erase(it);
+    }
+    
+    LOG_DEBUG("Request ", id, " timed out");
+    completeRequest(expired, Message(), "timeout");
+}
+
+void CommunicationProxy::failPendingRequests(const std::string& error) {
+    std::map<uint32_t, PendingRequest> failed;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        failed.swap(pendingRequests_);
+    }
+    
+    if (!failed.empty()) {
+        LOG_WARN("Failing ", failed.size(), " pending requests: ", error);
+    }
+    for (auto& entry : failed) {
+        completeRequest(entry.second, Message(), error);
+    }
+}
+
+bool CommunicationProxy::sendFrame(MessageType type, const void* data, size_t size, uint16_t flags,
+                                   uint32_t coalesceKey) {
+    FrameHeader header;
+    header.type = static_cast<uint8_t>(type);
+    header.flags = flags;
+    header.sequence = nextSequence_.fetch_add(1);
+    header.timestampUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    
+    // Header and CRC live on the stack, payload is written straight from the caller's buffer
+    BinaryFrame::IoVec frame;
+    if (!BinaryFrame::prepare(frame, header, data, size)) {
+        LOG_ERROR("Binary payload too large: ", size, " bytes");
+        return false;
+    }
+    return coalesceKey != 0 ? commImpl_->sendCoalesced(frame.iov, 3, coalesceKey) : commImpl_->sendBuffers(frame.iov, 3);
+}
+
+void CommunicationProxy::sendProtocolOffer() {
+    // With no peer yet (UDS server), the offer goes out when a peer connects
+    if (commImpl_ && commImpl_->isConnected() && !commImpl_->sendMessage(std::string(PROTOCOL_OFFER))) {
+        LOG_WARN("Failed to send protocol negotiation message");
+    }
+}
+
+void CommunicationProxy::setTransport(Transport transport) {
+    if (isInitialized_) {
+        LOG_WARN("Transport cannot be changed after initialization");
+        return;
+    }
+    transport_ = transport;
+}
+
+bool CommunicationProxy::parseTransport(const std::string& name, Transport& transport) {
+    if (name == "fifo") {
+        transport = Transport::FIFO;
+        return true;
+    }
+    if (name == "uds") {
+        transport = Transport::UDS;
+        return true;
+    }
+    return false;
+}
+
+void CommunicationProxy::setBinaryFraming(bool enabled) {
+    binaryFramingEnabled_ = enabled;
+}
+
+bool CommunicationProxy::isBinaryFramingActive() const {
+    return binaryFramingEnabled_ && peerSupportsBinary_;
+}
+
 void CommunicationProxy::registerCallback(MessageType type, MessageCallback callback) {
+    // Copy-on-write: readers keep using the snapshot they loaded
     std::lock_guard<std::mutex> lock(callbackMutex_);
-    callbacks_[type] = callback;
+    auto updated = std::make_shared<CallbackMap>(*std::atomic_load(&callbacks_));
+    (*updated)[type] = std::move(callback);
+    std::atomic_store(&callbacks_, std::shared_ptr<const CallbackMap>(std::move(updated)));
     LOG_DEBUG("Registered callback for message type: ", static_cast<int>(type));
 }
 
 void CommunicationProxy::unregisterCallback(MessageType type) {
     std::lock_guard<std::mutex> lock(callbackMutex_);
-    callbacks_.erase(type);
+    auto updated = std::make_shared<CallbackMap>(*std::atomic_load(&callbacks_));
+    updated->erase(type);
+    std::atomic_store(&callbacks_, std::shared_ptr<const CallbackMap>(std::move(updated)));
     LOG_DEBUG("Unregistered callback for message type: ", static_cast<int>(type));
 }
 
@@ -193,56 +501,35 @@ void CommunicationProxy::messageReceivingThread() {
     // Flag for first successful message reception
     bool firstMessageReceived = false;
     
-    // Message processing counter
-    int messagesProcessedInBatch = 0;
-    const int MAX_MESSAGES_PER_BATCH = 10; // Maximum messages to process in a single loop
+    const int LARGE_BATCH = 100; // Batch size worth logging as possible message accumulation
     
-    while(isRunning_) {
+    auto handleMessage = [this, &firstMessageReceived](std::string_view messageData) {
         try {
-            // Reset batch processing counter
-            messagesProcessedInBatch = 0;
-            
-            // Use polling to receive messages, process all available messages in loop
-            while(isRunning_ && messagesProcessedInBatch < MAX_MESSAGES_PER_BATCH) {
-                std::string messageData;
-                if(commImpl_->receiveMessage(messageData)) {
-                    // If this is the first message received, update connection state
-                    if (!firstMessageReceived) {
-                        firstMessageReceived = true;
-                        setConnectionState(ConnectionState::CONNECTED);
-                        LOG_INFO("Successfully received first message, connection established");
-                    }
-                    
-                    // Deserialize message
-                    Message message = Message::deserialize(messageData);
-                    
-                    LOG_DEBUG("Received message: type=", static_cast<int>(message.type), 
-                             ", content=", message.content);
-                    
-                    // Process high priority messages synchronously, submit others to thread pool
-                    if (message.priority == MessagePriority::HIGH) {
-                        // Process high priority messages synchronously (like heartbeat)
-                        processReceivedMessage(message);
-                    } else {
-                        // Process other messages asynchronously
-                        Message msgCopy = message; // Create a copy of the message
-                        threadPool_->submit([this, msgCopy]() {
-                            processReceivedMessage(msgCopy);
-                        });
-                    }
-                    
-                    // Increment batch processing counter
-                    messagesProcessedInBatch++;
-                } else {
-                    // No more messages to process, exit inner loop
-                    break;
-                }
+            // If this is the first message received, update connection state
+            if (!firstMessageReceived) {
+                firstMessageReceived = true;
+                setConnectionState(ConnectionState::CONNECTED);
+                LOG_INFO("Successfully received first message, connection established");
             }
             
-            // If a large number of messages were processed in a single loop, log it
-            if (messagesProcessedInBatch >= MAX_MESSAGES_PER_BATCH) {
-                LOG_WARN("Processed large number of messages in a single loop: ", messagesProcessedInBatch, 
-                        ", possible message accumulation");
+            handleIncomingMessage(messageData);
+        }
+        catch(const std::exception& e) {
+            // A malformed message must not abort the rest of the batch
+            LOG_ERROR("Failed to handle received message: ", e.what());
+        }
+    };
+    
+    while(isRunning_) {
+        try {
+            // Block until data arrives (or stop() wakes us), then handle every complete message
+            int messagesProcessed = commImpl_->receiveMessages(handleMessage, RECEIVE_WAIT_MS);
+            
+            if (messagesProcessed >= LARGE_BATCH) {
+                LOG_DEBUG("Processed ", messagesProcessed, " messages in a single wake-up");
+            } else if (messagesProcessed < 0) {
+                // Receive error, back off instead of spinning
+                std::this_thread::sleep_for(std::chrono::milliseconds(RECEIVE_WAIT_MS));
             }
             
             // Check connection state
@@ -255,9 +542,6 @@ void CommunicationProxy::messageReceivingThread() {
                     setConnectionState(ConnectionState::DISCONNECTED);
                 }
             }
-            
-            // Sleep to avoid busy loop
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
         catch(const std::exception& e) {
             LOG_ERROR("Message receiving thread exception: ", e.what());
@@ -269,12 +553,139 @@ void CommunicationProxy::messageReceivingThread() {
     LOG_DEBUG("Message receiving thread stopped");
 }
 
+void CommunicationProxy::handleIncomingMessage(std::string_view data) {
+    Message message;
+    
+    if (BinaryFrame::isFrameStart(data.data(), data.size())) {
+        FrameHeader header;
+        std::string_view payload;
+        if (!BinaryFrame::decode(data, header, payload)) {
+            LOG_WARN("Dropping invalid binary frame (", data.size(), " bytes)");
+            return;
+        }
+        if (header.flags & (BinaryFrame::FLAG_REQUEST | BinaryFrame::FLAG_RESPONSE)) {
+            if (payload.size() < BinaryFrame::REQUEST_ID_SIZE) {
+                LOG_WARN("Dropping request frame without a request id");
+                return;
+            }
+            for (size_t i = 0; i < BinaryFrame::REQUEST_ID_SIZE; ++i) {
+                message.requestId |= static_cast<uint32_t>(static_cast<uint8_t>(payload[i])) << (8 * i);
+            }
+            message.isResponse = (header.flags & BinaryFrame::FLAG_RESPONSE) != 0;
+            payload.remove_prefix(BinaryFrame::REQUEST_ID_SIZE);
+        }
+        message.type = static_cast<MessageType>(header.type);
+        message.content.assign(payload.data(), payload.size());
+        message.sequence = header.sequence;
+        message.timestampUs = header.timestampUs;
+        message.priority = (message.type == MessageType::HEARTBEAT) ? MessagePriority::HIGH : MessagePriority::NORMAL;
+        
+        LOG_DEBUG("Received frame: type=", static_cast<int>(message.type), ", seq=", message.sequence,
+                 ", size=", message.content.size());
+    } else if (data == PROTOCOL_OFFER) {
+        // Peer can decode binary frames; answer once so it learns the same about us
+        if (binaryFramingEnabled_ && !peerSupportsBinary_.exchange(true)) {
+            LOG_INFO("Peer supports binary framing, switching from text protocol");
+            sendProtocolOffer();
+        }
+        return;
+    } else {
+        // Deserialize message
+        message = Message::deserialize(data);
+        
+        LOG_DEBUG("Received message: type=", static_cast<int>(message.type), 
+                 ", content=", message.content);
+    }
+    
+    // A reply completes its request instead of going to the type callback
+    if (message.isResponse && message.requestId != 0) {
+        PendingRequest pending;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            auto it = pendingRequests_.find(message.requestId);
+            if (it != pendingRequests_.end()) {
+                pending = std::move(it->second);
+                pendingRequests_.erase(it);
+                found = true;
+            }
+        }
+        if (found) {
+            completeRequest(pending, message, "");
+            return;
+        }
+        // Late reply to a request that already timed out, deliver it like a plain message
+        LOG_DEBUG("Reply to unknown request ", message.requestId, ", dispatching by type");
+    }
+    
+    // Process high priority messages synchronously, queue others on their type's strand
+    if (message.priority == MessagePriority::HIGH) {
+        // Process high priority messages synchronously (like heartbeat)
+        processReceivedMessage(message);
+    } else {
+        // Process other messages asynchronously, in arrival order per message type
+        dispatchToStrand(std::move(message));
+    }
+}
+
+void CommunicationProxy::dispatchToStrand(Message message) {
+    // Nobody listens for this type; dropping it here keeps strands to registered types only
+    auto callbacks = std::atomic_load(&callbacks_);
+    if (callbacks->find(message.type) == callbacks->end()) {
+        return;
+    }
+    
+    Strand* strand;
+    {
+        std::lock_guard<std::mutex> lock(strandsMutex_);
+        auto& entry = strands_[message.type];
+        if (!entry) {
+            entry = std::make_unique<Strand>();
+        }
+        strand = entry.get();
+    }
+    
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> lock(strand->mutex);
+        strand->queue.push_back(std::move(message));
+        schedule = !strand->scheduled;
+        strand->scheduled = true;
+    }
+    
+    // At most one pool task per strand, so messages of one type never run concurrently
+    if (schedule) {
+        utils::ThreadPool* pool = threadPool_.get();
+        pool->submit([this, strand, pool]() { drainStrand(*strand, *pool); });
+    }
+}
+
+void CommunicationProxy::drainStrand(Strand& strand, utils::ThreadPool& pool) {
+    for (size_t i = 0; i < STRAND_BATCH; ++i) {
+        Message message;
+        {
+            std::lock_guard<std::mutex> lock(strand.mutex);
+            if (strand.queue.empty()) {
+                strand.scheduled = false;
+                return;
+            }
+            message = std::move(strand.queue.front());
+            strand.queue.pop_front();
+        }
+        processReceivedMessage(message);
+    }
+    
+    // Requeue behind other work so a busy type does not starve the others; the strand stays
+    // scheduled. During stop() the pool refuses the task and the remaining messages are dropped
+    pool.submit([this, &strand, &pool]() { drainStrand(strand, pool); });
+}
+
 void CommunicationProxy::processReceivedMessage(const Message& message) {
     try {
-        // Call registered callback for message type
-        std::lock_guard<std::mutex> lock(callbackMutex_);
-        auto it = callbacks_.find(message.type);
-        if (it != callbacks_.end() && it->second) {
+        // Call registered callback for message type, without holding the registry lock
+        auto callbacks = std::atomic_load(&callbacks_);
+        auto it = callbacks->find(message.type);
+        if (it != callbacks->end() && it->second) {
             it->second(message);
         }
     }
@@ -321,6 +732,14 @@ void CommunicationProxy::setConnectionState(ConnectionState newState) {
     if (oldState != newState) {
         connectionState_ = newState;
         
+        // A reconnecting peer may be a different build; negotiate again
+        if (newState == ConnectionState::DISCONNECTED) {
+            peerSupportsBinary_ = false;
+            
+            // A restarted peer will never answer requests sent to its previous instance
+            failPendingRequests("disconnected");
+        }
+        
         LOG_INFO("Communication connection state changed: ", static_cast<int>(newState));
         
         // Notify waiters
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <queue>
+#include <deque>
+#include <future>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
@@ -13,7 +17,9 @@
 #include <vector>
 #include "ICommunicationImpl.hpp"
 #include "FifoComm.hpp"
+#include "UdsComm.hpp"
 #include "ThreadPool.hpp"
+#include "TimerWheel.hpp"
 
 /**
  * @brief 通信代理类 - 单例模式
@@ -43,6 +49,14 @@ public:
         LOW             // 低优先级（非关键操作）
     };
     
+    /**
+     * @brief 传输方式
+     */
+    enum class Transport {
+        FIFO,           // 命名管道（<basePath>_in / _out），一对一
+        UDS             // Unix 域套接字（<basePath>.sock），服务端可同时连接多个客户端
+    };
+    
     /**
      * @brief 连接状态枚举
      */
@@ -54,11 +68,23 @@ public:
     
     /**
      * @brief 消息结构体
+     *
+     * 线路上有两种格式：文本 "<type>:<content>\n"，以及 BinaryFrame 二进制帧
+     * （载荷可以包含任意字节）。双方启动时互相发送文本格式的协商消息，
+     * 确认对方能解析二进制帧后改用二进制帧发送；旧版本把协商消息当作未知类型忽略，
+     * 继续使用文本格式。
+     * 请求和回复带有请求编号：文本格式为 "<type>#<id>:<content>"（请求）和
+     * "<type>@<id>:<content>"（回复），二进制帧用 FLAG_REQUEST / FLAG_RESPONSE 标志，
+     * 编号放在载荷开头。
      */
     struct Message {
         MessageType type;  // 消息类型
         std::string content;  // 消息内容
         MessagePriority priority; // 消息优先级
+        uint32_t sequence = 0;    // 发送序号（仅二进制帧）
+        uint64_t timestampUs = 0; // 发送时间，steady_clock 微秒（仅二进制帧）
+        uint32_t requestId = 0;   // 请求编号，0 表示普通消息
+        bool isResponse = false;  // 是否为对 requestId 请求的回复
         
         Message() : type(MessageType::COMMAND), priority(MessagePriority::NORMAL) {}
         
@@ -67,17 +93,28 @@ public:
         
         // 序列化为字符串
         std::string serialize() const {
-            return std::to_string(static_cast<int>(type)) + ":" + content;
+            std::string prefix = std::to_string(static_cast<int>(type));
+            if (requestId != 0) {
+                prefix += isResponse ? '@' : '#';
+                prefix += std::to_string(requestId);
+            }
+            return prefix + ":" + content;
         }
         
-        // 从字符串反序列化
-        static Message deserialize(const std::string& data) {
+        // 从文本格式反序列化
+        static Message deserialize(std::string_view data) {
             Message msg;
             size_t pos = data.find(':');
-            if(pos != std::string::npos) {
-                int type = std::stoi(data.substr(0, pos));
+            if(pos != std::string_view::npos) {
+                std::string_view prefix = data.substr(0, pos);
+                size_t mark = prefix.find_first_of("#@");
+                int type = std::stoi(std::string(prefix.substr(0, mark)));
                 msg.type = static_cast<MessageType>(type);
-                msg.content = data.substr(pos + 1);
+                if (mark != std::string_view::npos) {
+                    msg.isResponse = prefix[mark] == '@';
+                    msg.requestId = static_cast<uint32_t>(std::stoul(std::string(prefix.substr(mark + 1))));
+                }
+                msg.content.assign(data.data() + pos + 1, data.size() - pos - 1);
                 
                 // 设置默认优先级（心跳消息为高优先级）
                 if (msg.type == MessageType::HEARTBEAT) {
@@ -93,6 +130,13 @@ public:
      */
     using MessageCallback = std::function<void(const Message&)>;
     
+    /**
+     * @brief 请求回复回调函数类型
+     * @param success 是否收到回复（超时、断开或发送失败时为 false）
+     * @param response 回复消息（success 为 false 时 content 为失败原因）
+     */
+    using ResponseCallback = std::function<void(bool success, const Message& response)>;
+    
     /**
      * @brief 连接状态变化回调函数类型
      */
@@ -136,8 +180,80 @@ public:
      */
     bool sendMessage(MessageType type, const std::string& content);
     
+    /**
+     * @brief 发送二进制载荷（需要对方支持二进制帧）
+     * @param type 消息类型
+     * @param data 载荷，最大 BinaryFrame::MAX_PAYLOAD 字节，直接写入通信管道，不拷贝
+     * @param size 载荷长度
+     * @param coalesceKey 合并键：非 0 时对端拥塞、发送队列中有同键的未发出消息时只保留最新的一条（UDS）
+     * @return 是否成功（对方只支持文本格式时返回 false）
+     */
+    bool sendBinary(MessageType type, const void* data, size_t size, uint32_t coalesceKey = 0);
+    
+    /**
+     * @brief 发送请求，异步等待对方回复
+     *
+     * 可以同时有多个未完成的请求（流水线），回复按请求编号匹配，与到达顺序无关。
+     * @param type 消息类型
+     * @param content 消息内容
+     * @param timeoutMs 超时时间(毫秒)
+     * @return 收到回复时就绪；超时、连接断开或发送失败时 get() 抛出 std::runtime_error
+     */
+    std::future<Message> request(MessageType type, const std::string& content, int timeoutMs = 1000);
+    
+    /**
+     * @brief 发送请求，收到回复或失败后在线程池中调用 callback
+     * @param type 消息类型
+     * @param content 消息内容
+     * @param timeoutMs 超时时间(毫秒)
+     * @param callback 回复回调（每个请求恰好调用一次）
+     */
+    void request(MessageType type, const std::string& content, int timeoutMs, ResponseCallback callback);
+    
+    /**
+     * @brief 回复一条消息
+     * @param request 收到的消息（不是请求时按普通消息发送，兼容旧版本的对方）
+     * @param type 回复的消息类型
+     * @param content 回复内容
+     * @return 是否成功
+     */
+    bool reply(const Message& request, MessageType type, const std::string& content);
+    
+    /**
+     * @brief 未完成的请求数
+     */
+    size_t pendingRequestCount() const;
+    
+    /**
+     * @brief 选择传输方式，需在 initialize 之前调用
+     * @param transport 传输方式
+     */
+    void setTransport(Transport transport);
+    
+    /**
+     * @brief 按名称解析传输方式（"fifo" / "uds"）
+     * @param name 名称
+     * @param transport 解析结果
+     * @return 名称是否有效
+     */
+    static bool parseTransport(const std::string& name, Transport& transport);
+    
+    /**
+     * @brief 启用/禁用二进制帧（禁用时不发送协商消息，只使用文本格式），需在 start 之前调用
+     * @param enabled 是否启用
+     */
+    void setBinaryFraming(bool enabled);
+    
+    /**
+     * @brief 是否已与对方协商使用二进制帧
+     */
+    bool isBinaryFramingActive() const;
+    
     /**
      * @brief 注册消息回调
+     *
+     * 同一类型的消息按到达顺序依次处理（不同类型之间并行），
+     * 回调执行期间不持有注册表的锁，回调中可以注册/取消回调或发送请求。
      * @param type 消息类型
      * @param callback 回调函数
      */
@@ -189,6 +305,78 @@ private:
      */
     void messageReceivingThread();
     
+    /**
+     * @brief 解析并分发一条接收到的消息（文本、二进制帧或协商消息）
+     * @param data 消息数据
+     */
+    void handleIncomingMessage(std::string_view data);
+    
+    /**
+     * @brief 以二进制帧发送
+     */
+    bool sendFrame(MessageType type, const void* data, size_t size, uint16_t flags = 0, uint32_t coalesceKey = 0);
+    
+    /**
+     * @brief 按协商的格式发送一条消息（含请求编号）
+     */
+    bool transmit(const Message& message);
+    
+    /**
+     * @brief 一个未完成的请求
+     */
+    struct PendingRequest {
+        utils::TimerWheel::TimerId timer = utils::TimerWheel::INVALID_TIMER;  // 超时定时器
+        std::shared_ptr<std::promise<Message>> promise;   // future 形式的请求
+        ResponseCallback callback;                        // 回调形式的请求
+    };
+    
+    /**
+     * @brief 登记并发送请求，失败时立即完成该请求
+     */
+    void startRequest(MessageType type, const std::string& content, int timeoutMs, PendingRequest pending);
+    
+    /**
+     * @brief 完成一个请求（取消超时定时器，设置 future 或在线程池中调用回调）
+     * @param error 失败原因，为空表示成功
+     * @note 不能在持有 pendingMutex_ 时调用：取消定时器会等待正在执行的超时回调
+     */
+    void completeRequest(PendingRequest& pending, const Message& response, const std::string& error);
+    
+    /**
+     * @brief 请求的超时定时器到期（在时间轮线程中执行），以超时完成该请求
+     */
+    void expireRequest(uint32_t id);
+    
+    /**
+     * @brief 以失败完成所有未完成的请求
+     */
+    void failPendingRequests(const std::string& error);
+    
+    /**
+     * @brief 同一消息类型的处理队列，保证按到达顺序处理
+     */
+    struct Strand {
+        std::mutex mutex;
+        std::deque<Message> queue;    // 等待处理的消息
+        bool scheduled = false;       // 是否已有线程池任务在处理该队列
+    };
+    
+    /**
+     * @brief 把消息放入所属类型的处理队列
+     */
+    void dispatchToStrand(Message message);
+    
+    /**
+     * @brief 在线程池中依次处理一个队列中的消息
+     * @param pool 所在的线程池（stop 销毁线程池期间 threadPool_ 已为空）
+     */
+    void drainStrand(Strand& strand, utils::ThreadPool& pool);
+    
+    /**
+     * @brief 发送协议协商消息（文本格式）
+     */
+    void sendProtocolOffer();
+    
     /**
      * @brief 处理接收到的消息
      * @param message 消息对象
@@ -217,13 +405,29 @@ private:
     
     // 通信实现
     std::unique_ptr<ICommunicationImpl> commImpl_;
+    Transport transport_{Transport::FIFO};    // 传输方式
+    
+    // 二进制帧
+    std::atomic<bool> binaryFramingEnabled_{true};  // 本端是否启用
+    std::atomic<bool> peerSupportsBinary_{false};   // 对方是否已声明支持
+    std::atomic<uint32_t> nextSequence_{0};         // 下一帧序号
+    
+    // 请求
+    std::map<uint32_t, PendingRequest> pendingRequests_;  // 请求编号 -> 未完成的请求
+    mutable std::mutex pendingMutex_;                     // 请求表锁
+    std::atomic<uint32_t> nextRequestId_{1};              // 下一个请求编号
+    
+    // 按消息类型串行处理的队列（只为注册了回调的类型创建）
+    std::map<MessageType, std::unique_ptr<Strand>> strands_;
+    std::mutex strandsMutex_;
     
     // 线程池
     std::unique_ptr<utils::ThreadPool> threadPool_;
     
-    // 回调函数
-    std::map<MessageType, MessageCallback> callbacks_; // 回调函数映射
-    std::mutex callbackMutex_;                // 回调锁
+    // 回调函数：写时复制，处理消息时取快照后不持锁调用
+    using CallbackMap = std::map<MessageType, MessageCallback>;
+    std::shared_ptr<const CallbackMap> callbacks_;  // 回调函数映射（只通过 atomic_load/atomic_store 访问）
+    std::mutex callbackMutex_;                // 串行化注册/取消注册
     
     // 线程
     std::thread receivingThread_;             // 消息接收线程
@@ -1,17 +1,22 @@
 #include "FifoComm.hpp"
 #include "Logger.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <vector>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 // FifoCommImpl implementation
 FifoCommImpl::FifoCommImpl(const std::string& basePath, CommRole role)
     : basePath_(basePath), inPipePath_(basePath_ + "_in"), outPipePath_(basePath_ + "_out"),
-      isServer_(false), role_(role), readFd_(-1), writeFd_(-1) {
+      isServer_(false), role_(role), readFd_(-1), writeFd_(-1), epollFd_(-1), wakeFd_(-1) {
     // Pipe path setup completed in initialization list
 }
 
@@ -200,6 +205,10 @@ bool FifoCommImpl::openPipes() {
             return false;
         }
         
+        // Set non-blocking mode (a full pipe is handled in sendBuffers/sendCoalesced)
+        int flags = fcntl(writeFd_, F_GETFL, 0);
+        fcntl(writeFd_, F_SETFL, flags | O_NONBLOCK);
+        
         LOG_INFO("Client: Opening inbound pipe");
         readFd_ = open(outPipePath_.c_str(), O_RDONLY | O_NONBLOCK); // Client's inbound is server's outbound
         if (readFd_ == -1) {
@@ -210,6 +219,14 @@ bool FifoCommImpl::openPipes() {
         }
     }
     
+    if (!createEventLoop()) {
+        close(readFd_);
+        close(writeFd_);
+        readFd_ = -1;
+        writeFd_ = -1;
+        return false;
+    }
+    
     LOG_INFO("Pipes opened successfully");
     // Notify successful connection
     isConnected_ = true;
@@ -249,7 +266,71 @@ bool FifoCommImpl::openPipesWithRetry() {
     return false;
 }
 
+bool FifoCommImpl::createEventLoop() {
+    if (epollFd_ != -1) {
+        close(epollFd_);
+    }
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+    }
+    
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ == -1 || wakeFd_ == -1) {
+        LOG_ERROR("Failed to create event loop: ", strerror(errno));
+        return false;
+    }
+    
+    // Edge-triggered: a closed writer (EPOLLHUP) is reported once instead of on every wait.
+    // Receive calls may stop before the pipe is empty; readPending_ records that so the
+    // next call reads without waiting for another edge
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = readFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, readFd_, &event) == -1) {
+        LOG_ERROR("Failed to register read pipe with epoll: ", strerror(errno));
+        return false;
+    }
+    
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event) == -1) {
+        LOG_ERROR("Failed to register wake-up eventfd with epoll: ", strerror(errno));
+        return false;
+    }
+    
+    rxBuffer_.clear();
+    readPending_ = false;
+    
+    // Messages queued for a previous reader are dropped
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    txPending_.clear();
+    coalescedQueue_.clear();
+    writeArmed_ = false;
+    return true;
+}
+
 void FifoCommImpl::cleanup() {
+    // Close event loop
+    if (epollFd_ != -1) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+    
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+    
+    rxBuffer_.clear();
+    readPending_ = false;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        txPending_.clear();
+        coalescedQueue_.clear();
+        writeArmed_ = false;
+    }
+    
     // Close file descriptors
     if (readFd_ != -1) {
         close(readFd_);
@@ -275,95 +356,377 @@ void FifoCommImpl::cleanup() {
 }
 
 bool FifoCommImpl::sendMessage(const std::string& message) {
+    // Add separator for easier parsing by receiver, without copying the message
+    static const char separator = '\n';
+    iovec iov[2];
+    iov[0].iov_base = const_cast<char*>(message.data());
+    iov[0].iov_len = message.size();
+    iov[1].iov_base = const_cast<char*>(&separator);
+    iov[1].iov_len = 1;
+    return sendBuffers(iov, 2);
+}
+
+bool FifoCommImpl::sendBuffers(const iovec* iov, int count) {
+    const int WRITE_WAIT_MS = 100; // Maximum wait for a full pipe to drain
+    
+    std::lock_guard<std::mutex> lock(sendMutex_);
     if (writeFd_ == -1) {
         LOG_ERROR("Cannot send message: Write pipe not opened");
         return false;
     }
     
-    std::string data = message + "\n";  // Add separator for easier parsing by receiver
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += iov[i].iov_len;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WRITE_WAIT_MS);
+    auto waitWritable = [this, &deadline]() {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        pollfd pfd{writeFd_, POLLOUT, 0};
+        return remaining.count() > 0 && poll(&pfd, 1, static_cast<int>(remaining.count())) > 0;
+    };
     
-    // Send message
-    ssize_t bytesWritten = write(writeFd_, data.c_str(), data.size());
-    if (bytesWritten != static_cast<ssize_t>(data.size())) {
-        if (bytesWritten == -1) {
-            LOG_ERROR("Failed to write to pipe: ", strerror(errno));
-            
-            // Check if due to pipe disconnection
-            if (errno == EPIPE) {
-                LOG_ERROR("Pipe disconnected, receiver may have closed");
+    // Queued coalescable messages and the rest of a partially written one go out first
+    while (!flushPendingLocked()) {
+        if (!waitWritable()) {
+            LOG_ERROR("Write to pipe timed out: pipe full, ", total, " bytes not sent");
+            return false;
+        }
+    }
+    
+    // A message larger than PIPE_BUF may be written in several parts; keep writing the
+    // remainder so the receiver never sees a truncated message
+    std::vector<iovec> pending(iov, iov + count);
+    size_t written = 0;
+    size_t index = 0;
+    while (index < pending.size()) {
+        ssize_t bytesWritten = writeSome(pending.data() + index, static_cast<int>(pending.size() - index));
+        if (bytesWritten < 0) {
+            return false;
+        }
+        if (bytesWritten == 0) {
+            if (waitWritable()) {
+                continue;
             }
-        } else {
-            LOG_ERROR("Incomplete write to pipe: ", bytesWritten, "/", data.size());
+            if (written == 0) {
+                LOG_ERROR("Write to pipe timed out: pipe full, ", total, " bytes not sent");
+                return false;
+            }
+            // Part of the message is already in the pipe: keep the rest for when it becomes writable
+            LOG_WARN("Write to pipe timed out: ", written, "/", total, " bytes sent, rest queued");
+            for (size_t i = index; i < pending.size(); i++) {
+                txPending_.append(static_cast<const char*>(pending[i].iov_base), pending[i].iov_len);
+            }
+            armWriteLocked(true);
+            return true;
         }
+        
+        written += static_cast<size_t>(bytesWritten);
+        size_t remaining = static_cast<size_t>(bytesWritten);
+        while (index < pending.size() && remaining >= pending[index].iov_len) {
+            remaining -= pending[index].iov_len;
+            index++;
+        }
+        if (index < pending.size()) {
+            pending[index].iov_base = static_cast<char*>(pending[index].iov_base) + remaining;
+            pending[index].iov_len -= remaining;
+        }
+    }
+    
+    return true;
+}
+
+bool FifoCommImpl::sendCoalesced(const iovec* iov, int count, uint32_t key) {
+    if (key == 0) {
+        return sendBuffers(iov, count);
+    }
+    
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (writeFd_ == -1) {
+        LOG_ERROR("Cannot send message: Write pipe not opened");
         return false;
     }
     
+    // Never waits: write what the pipe takes now
+    if (flushPendingLocked()) {
+        size_t total = 0;
+        for (int i = 0; i < count; i++) {
+            total += iov[i].iov_len;
+        }
+        ssize_t written = writeSome(iov, count);
+        if (written < 0) {
+            return false;
+        }
+        if (static_cast<size_t>(written) == total) {
+            return true;
+        }
+        if (written > 0) {
+            // The rest of this message goes out before anything else
+            size_t skip = static_cast<size_t>(written);
+            for (int i = 0; i < count; i++) {
+                size_t offset = std::min(skip, iov[i].iov_len);
+                txPending_.append(static_cast<const char*>(iov[i].iov_base) + offset, iov[i].iov_len - offset);
+                skip -= offset;
+            }
+            armWriteLocked(true);
+            return true;
+        }
+    }
+    
+    // Pipe full: the newest message replaces the waiting one with the same key
+    std::string* data = nullptr;
+    for (auto& message : coalescedQueue_) {
+        if (message.key == key) {
+            data = &message.data;
+            data->clear();
+            coalescedMessages_.fetch_add(1);
+            break;
+        }
+    }
+    if (!data) {
+        coalescedQueue_.push_back(CoalescedMessage{key, std::string()});
+        data = &coalescedQueue_.back().data;
+    }
+    for (int i = 0; i < count; i++) {
+        data->append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    }
+    armWriteLocked(true);
+    return true;
+}
+
+ssize_t FifoCommImpl::writeSome(const iovec* iov, int count) {
+    ssize_t bytesWritten;
+    do {
+        bytesWritten = writev(writeFd_, iov, count);
+    } while (bytesWritten == -1 && errno == EINTR);
+    
+    if (bytesWritten >= 0) {
+        return bytesWritten;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+    }
+    
+    LOG_ERROR("Failed to write to pipe: ", strerror(errno));
+    
+    // Check if due to pipe disconnection
+    if (errno == EPIPE) {
+        LOG_ERROR("Pipe disconnected, receiver may have closed");
+    }
+    return -1;
+}
+
+bool FifoCommImpl::flushPendingLocked() {
+    while (!txPending_.empty() || !coalescedQueue_.empty()) {
+        if (txPending_.empty()) {
+            txPending_.swap(coalescedQueue_.front().data);
+            coalescedQueue_.pop_front();
+        }
+        
+        iovec iov;
+        iov.iov_base = txPending_.data();
+        iov.iov_len = txPending_.size();
+        ssize_t written = writeSome(&iov, 1);
+        if (written < 0) {
+            // The reader is gone, queued messages are stale for the next one
+            txPending_.clear();
+            coalescedQueue_.clear();
+            break;
+        }
+        txPending_.erase(0, static_cast<size_t>(written));
+        if (!txPending_.empty()) {
+            armWriteLocked(true);
+            return false;
+        }
+    }
+    
+    armWriteLocked(false);
     return true;
 }
 
+void FifoCommImpl::armWriteLocked(bool enable) {
+    if (writeArmed_ == enable || epollFd_ == -1 || writeFd_ == -1) {
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLOUT;
+    event.data.fd = writeFd_;
+    if (epoll_ctl(epollFd_, enable ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, writeFd_, &event) == 0) {
+        writeArmed_ = enable;
+    }
+}
+
 bool FifoCommImpl::receiveMessage(std::string& message) {
     if (readFd_ == -1) {
         LOG_ERROR("Cannot receive message: Read pipe not opened");
         return false;
     }
     
-    // Check if there is enough data to process
-    if (!partialData_.empty()) {
-        // Find a complete message
-        size_t pos = partialData_.find('\n');
-        if (pos != std::string::npos) {
-            // Extract a complete message
-            message = partialData_.substr(0, pos);
-            partialData_ = partialData_.substr(pos + 1);
-            
-            // If there is still a lot of data left to process, log it
-            if (partialData_.size() > 200) {
-                LOG_WARN("FIFO receive buffer has a lot of data to process: ", partialData_.size(), " bytes");
-            }
-            
+    // Messages left over from a previous read are returned without touching the pipe
+    std::string_view view;
+    if (rxBuffer_.nextMessage(view)) {
+        message.assign(view.data(), view.size());
+        return true;
+    }
+    
+    // Edge-triggered: only wait when the pipe is known to be drained
+    if (!readPending_) {
+        if (receiveTimeoutMs_ > 0 && !waitReadable(receiveTimeoutMs_)) {
+            return false;
+        }
+        readPending_ = true;
+    }
+    
+    // Return as soon as one message is complete; the rest stays in the pipe for the next call
+    while (readPending_) {
+        if (readChunk() <= 0) {
+            readPending_ = false;
+            break;
+        }
+        if (rxBuffer_.nextMessage(view)) {
+            message.assign(view.data(), view.size());
             return true;
         }
     }
     
-    // Read data from pipe
-    char buffer[4096];
-    ssize_t bytesRead = read(readFd_, buffer, sizeof(buffer) - 1);
+    return false;
+}
+
+int FifoCommImpl::receiveMessages(const MessageHandler& handler, int timeoutMs) {
+    if (readFd_ == -1) {
+        LOG_ERROR("Cannot receive messages: Read pipe not opened");
+        return -1;
+    }
+    
+    // Only block when nothing is buffered and the pipe is known to be drained
+    int count = dispatchMessages(handler);
+    if (count == 0 && !readPending_) {
+        if (!waitReadable(timeoutMs)) {
+            return 0;
+        }
+        readPending_ = true;
+    }
+    
+    // Handle messages as each chunk arrives; stop after MAX_READ_PER_RECEIVE bytes so a
+    // writer that keeps the pipe full cannot hold the caller here indefinitely
+    const size_t MAX_READ_PER_RECEIVE = 256 * 1024;
+    size_t budget = MAX_READ_PER_RECEIVE;
+    ssize_t bytesRead = 0;
+    while (readPending_ && budget > 0) {
+        bytesRead = readChunk();
+        if (bytesRead <= 0) {
+            readPending_ = false;
+            break;
+        }
+        budget -= std::min(budget, static_cast<size_t>(bytesRead));
+        count += dispatchMessages(handler);
+    }
+    
+    return (bytesRead < 0 && count == 0) ? -1 : count;
+}
+
+void FifoCommImpl::interruptReceive() {
+    if (wakeFd_ != -1) {
+        uint64_t one = 1;
+        ssize_t ret = write(wakeFd_, &one, sizeof(one));
+        (void)ret;
+    }
+}
+
+bool FifoCommImpl::waitReadable(int timeoutMs) {
+    if (epollFd_ == -1) {
+        return false;
+    }
+    
+    epoll_event events[3];
+    int count = epoll_wait(epollFd_, events, 3, timeoutMs);
+    if (count == -1) {
+        if (errno != EINTR) {
+            LOG_ERROR("epoll_wait failed: ", strerror(errno));
+        }
+        return false;
+    }
+    
+    bool readable = false;
+    for (int i = 0; i < count; i++) {
+        if (events[i].data.fd == wakeFd_) {
+            uint64_t value;
+            ssize_t ret = read(wakeFd_, &value, sizeof(value));
+            (void)ret;
+        } else if (events[i].data.fd == writeFd_) {
+            // Write pipe drained: send queued messages. A sender holding the lock flushes them itself
+            std::unique_lock<std::mutex> lock(sendMutex_, std::try_to_lock);
+            if (lock.owns_lock()) {
+                flushPendingLocked();
+            }
+        } else {
+            readable = true;
+        }
+    }
+    return readable;
+}
+
+ssize_t FifoCommImpl::readChunk() {
+    const size_t CHUNK_SIZE = 16 * 1024;
+    
+    char* dest = rxBuffer_.prepareWrite(CHUNK_SIZE);
+    if (!dest) {
+        LOG_ERROR("FIFO receive buffer overflow, dropping ", rxBuffer_.size(), " bytes without message separator");
+        rxBuffer_.clear();
+        dest = rxBuffer_.prepareWrite(CHUNK_SIZE);
+    }
+    
+    ssize_t bytesRead;
+    do {
+        bytesRead = read(readFd_, dest, rxBuffer_.writableSize());
+    } while (bytesRead == -1 && errno == EINTR);
     
     if (bytesRead > 0) {
-        // Ensure string ends
-        buffer[bytesRead] = '\0';
-        
-        // Add to partial data
-        partialData_ += buffer;
-        
-        // Loop to extract all complete messages until no complete message is found
-        size_t pos = partialData_.find('\n');
-        if (pos != std::string::npos) {
-            // Extract a complete message
-            message = partialData_.substr(0, pos);
-            partialData_ = partialData_.substr(pos + 1);
-            
-            // Record remaining data to process
-            if (!partialData_.empty()) {
-                LOG_DEBUG("FIFO receive processed one message, ", partialData_.size(), " bytes of data left to process");
+        rxBuffer_.commitWrite(static_cast<size_t>(bytesRead));
+        if (!isConnected_) {
+            LOG_INFO("FIFO peer reconnected");
+            isConnected_ = true;
+            if (peerConnectedHandler_) {
+                peerConnectedHandler_();
             }
-            
-            return true;
         }
+        return bytesRead;
     }
-    else if (bytesRead == -1) {
-        // In non-blocking mode, no data to read returns -1 and EAGAIN
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            LOG_ERROR("Read from pipe failed: ", strerror(errno));
+    
+    if (bytesRead == 0) {
+        // All writers closed the pipe
+        if (isConnected_) {
+            LOG_WARN("FIFO peer closed the pipe");
+            isConnected_ = false;
         }
+        return 0;
     }
     
-    return false;
+    // In non-blocking mode, no data to read returns -1 and EAGAIN
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+    }
+    LOG_ERROR("Read from pipe failed: ", strerror(errno));
+    return -1;
+}
+
+int FifoCommImpl::dispatchMessages(const MessageHandler& handler) {
+    int count = 0;
+    std::string_view message;
+    while (rxBuffer_.nextMessage(message)) {
+        handler(message);
+        count++;
+    }
+    return count;
 }
 
 void FifoCommImpl::setReceiveTimeout(int milliseconds) {
-    // FIFO implementation does not support timeout setting, use non-blocking mode
-    (void)milliseconds;
+    receiveTimeoutMs_ = std::max(0, milliseconds);
+}
+
+void FifoCommImpl::setPeerConnectedHandler(PeerConnectedHandler handler) {
+    peerConnectedHandler_ = std::move(handler);
 }
 
 bool FifoCommImpl::isConnected() const {
@@ -2,14 +2,26 @@
 
 #include <string>
 #include <atomic>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <functional>
+#include <sys/types.h>
 #include "ICommunicationImpl.hpp"
+#include "MessageRingBuffer.hpp"
 #include "Logger.hpp"
 
 /**
  * @brief FIFO通信实现类 - 使用命名管道实现进程间通信
+ *
+ * 读端由 epoll（边沿触发）等待，数据到达后连续读取并处理已到达的消息，
+ * 单次接收调用读取的字节数有上限；未读完时记下标志，下次调用直接读取而不等待
+ * 新的事件。另有 eventfd 用于从其他线程唤醒等待。
+ * 写端关闭（对端退出）时标记为未连接，对端重新打开并写入数据后恢复。
+ *
+ * 写管道为非阻塞模式。一条消息写了一部分时剩余字节先保存下来，写完之前不写其他数据，
+ * 对端不会收到截断的消息。可合并的消息（sendCoalesced）从不等待：管道写满时每个 key
+ * 只保留最新的一条，写管道注册到 epoll，可写时由接收线程写出。
  */
 class FifoCommImpl : public ICommunicationImpl {
 public:
@@ -46,6 +58,28 @@ public:
      */
     bool sendMessage(const std::string& message) override;
     
+    /**
+     * @brief 分散写入（writev），写满时等待管道可写，保证一条消息不被其他发送打断
+     * @param iov 数据段
+     * @param count 段数
+     * @return 是否全部写入
+     */
+    bool sendBuffers(const iovec* iov, int count) override;
+    
+    /**
+     * @brief 写入一条可合并的消息，不等待管道可写；写不下时替换同 key 尚未写出的消息
+     * @param iov 数据段
+     * @param count 段数
+     * @param key 合并键，0 表示不合并（等同 sendBuffers）
+     * @return 是否已写出或排队
+     */
+    bool sendCoalesced(const iovec* iov, int count, uint32_t key) override;
+    
+    /**
+     * @brief 排队中被新消息替换的可合并消息数
+     */
+    uint64_t coalescedMessages() const { return coalescedMessages_; }
+    
     /**
      * @brief 接收消息
      * @param message 接收到的消息
@@ -54,11 +88,29 @@ public:
     bool receiveMessage(std::string& message) override;
     
     /**
-     * @brief 设置接收超时
-     * @param milliseconds 超时时间(毫秒)
+     * @brief 等待数据到达并处理所有完整消息
+     * @param handler 消息处理函数
+     * @param timeoutMs 最长等待时间(毫秒)，0 表示不等待，-1 表示一直等待
+     * @return 处理的消息数，出错返回 -1
+     */
+    int receiveMessages(const MessageHandler& handler, int timeoutMs) override;
+    
+    /**
+     * @brief 唤醒阻塞在 receiveMessages 中的线程
+     */
+    void interruptReceive() override;
+    
+    /**
+     * @brief 设置接收超时（receiveMessage 没有缓存消息时最多等待的时间）
+     * @param milliseconds 超时时间(毫秒)，0 表示不等待
      */
     void setReceiveTimeout(int milliseconds) override;
     
+    /**
+     * @brief 设置对端重新连接时的回调（在接收线程中调用）
+     */
+    void setPeerConnectedHandler(PeerConnectedHandler handler) override;
+    
     /**
      * @brief 获取连接状态
      * @return 是否已连接
@@ -111,6 +163,48 @@ private:
      */
     bool openPipesWithRetry();
     
+    /**
+     * @brief 创建 epoll 实例和唤醒用的 eventfd，并注册读管道
+     * @return 是否成功
+     */
+    bool createEventLoop();
+    
+    /**
+     * @brief 等待读管道可读
+     * @param timeoutMs 最长等待时间(毫秒)
+     * @return 读管道是否有新事件（超时或被唤醒时返回 false）
+     */
+    bool waitReadable(int timeoutMs);
+    
+    /**
+     * @brief 从读管道读取一次数据到接收缓冲区
+     * @return 读取的字节数，0 表示管道已空或写端已关闭，-1 表示出错
+     */
+    ssize_t readChunk();
+    
+    /**
+     * @brief 非阻塞写入
+     * @return 写入的字节数，0 表示管道已满，-1 表示出错
+     */
+    ssize_t writeSome(const iovec* iov, int count);
+    
+    /**
+     * @brief 写出部分写入消息的剩余字节和排队的可合并消息（不等待，需持有 sendMutex_）
+     * @return 是否已全部写出
+     */
+    bool flushPendingLocked();
+    
+    /**
+     * @brief 注册或取消写管道的可写事件（需持有 sendMutex_）
+     */
+    void armWriteLocked(bool enable);
+    
+    /**
+     * @brief 处理接收缓冲区中的所有完整消息
+     * @return 处理的消息数
+     */
+    int dispatchMessages(const MessageHandler& handler);
+    
 private:
     std::string basePath_;              // 基础路径
     std::string inPipePath_;            // 输入管道路径
@@ -119,6 +213,21 @@ private:
     CommRole role_{CommRole::AUTO};     // 通信角色
     int readFd_{-1};                    // 读文件描述符
     int writeFd_{-1};                   // 写文件描述符
-    std::string partialData_;           // 部分数据(未完成的消息)
+    int epollFd_{-1};                   // epoll 实例
+    int wakeFd_{-1};                    // 唤醒用 eventfd
+    int receiveTimeoutMs_{0};           // receiveMessage 的等待时间
+    MessageRingBuffer rxBuffer_;        // 接收缓冲区(含未完成的消息)
+    bool readPending_{false};           // 读管道可能还有未读数据（边沿触发不会再通知）
+    std::mutex sendMutex_;              // 串行化发送，避免消息交错
+    
+    struct CoalescedMessage {
+        uint32_t key;
+        std::string data;
+    };
+    std::string txPending_;             // 部分写入消息的剩余字节，写完前不写其他数据 (sendMutex_)
+    std::deque<CoalescedMessage> coalescedQueue_; // 等待管道可写的可合并消息，每个 key 一条 (sendMutex_)
+    bool writeArmed_{false};            // 写管道是否已注册可写事件 (sendMutex_)
+    std::atomic<uint64_t> coalescedMessages_{0}; // 被替换的可合并消息数
+    PeerConnectedHandler peerConnectedHandler_; // 对端重新连接回调
     std::atomic<bool> isConnected_{false}; // 连接状态
 }; 
\ No newline at end of file
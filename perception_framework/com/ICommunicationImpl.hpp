@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <functional>
+#include <sys/uio.h>
 
 /**
  * @brief 通信接口 - 定义通信方法
@@ -16,6 +20,16 @@ public:
         CLIENT
     };
 
+    /**
+     * @brief 消息处理函数，参数指向接收缓冲区，只在回调内有效
+     */
+    using MessageHandler = std::function<void(std::string_view message)>;
+
+    /**
+     * @brief 新对端连接时的回调（对端可能是重新启动的另一个版本，需要重新协商协议）
+     */
+    using PeerConnectedHandler = std::function<void()>;
+
     virtual ~ICommunicationImpl() = default;
     
     // 初始化通信
@@ -27,12 +41,28 @@ public:
     // 发送消息
     virtual bool sendMessage(const std::string& message) = 0;
     
+    // 分散写入一条完整的二进制帧(各段按顺序连续发送，不与其他发送交错)
+    virtual bool sendBuffers(const iovec* iov, int count) = 0;
+    
+    // 分散写入一条可合并的二进制帧，不等待对端：对端拥塞时替换发送队列中 key 相同、尚未发出的帧，
+    // 只保留最新的一帧 (key 为 0 时等同 sendBuffers)
+    virtual bool sendCoalesced(const iovec* iov, int count, uint32_t key) = 0;
+    
     // 接收消息
     virtual bool receiveMessage(std::string& message) = 0;
     
+    // 等待数据到达(最多 timeoutMs 毫秒)并处理所有已到达的完整消息，返回处理的消息数，出错返回 -1
+    virtual int receiveMessages(const MessageHandler& handler, int timeoutMs) = 0;
+    
+    // 唤醒阻塞在 receiveMessages 中的线程
+    virtual void interruptReceive() = 0;
+    
     // 设置接收超时
     virtual void setReceiveTimeout(int milliseconds) = 0;
     
+    // 设置新对端连接时的回调(在接收线程中调用)
+    virtual void setPeerConnectedHandler(PeerConnectedHandler handler) = 0;
+    
     // 获取连接状态
     virtual bool isConnected() const = 0;
     
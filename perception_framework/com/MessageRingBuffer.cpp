@@ -0,0 +1,131 @@
+#include "MessageRingBuffer.hpp"
+#include "BinaryFrame.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t MAX_TYPE_DIGITS = 10;  // 文本消息类型编号（及请求编号）的最大位数
+
+} // namespace
+
+MessageRingBuffer::MessageRingBuffer(size_t capacity, size_t maxCapacity)
+    : buffer_(std::max<size_t>(capacity, 1)), maxCapacity_(std::max(maxCapacity, buffer_.size())) {
+}
+
+char* MessageRingBuffer::prepareWrite(size_t minSpace) {
+    if (writableSize() >= minSpace) {
+        return buffer_.data() + writePos_;
+    }
+
+    // 把未取出的数据移回起始位置（读写位置重合时无需移动）
+    size_t pending = size();
+    if (readPos_ > 0) {
+        if (pending > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + readPos_, pending);
+        }
+        scanPos_ -= readPos_;
+        readPos_ = 0;
+        writePos_ = pending;
+    }
+
+    if (writableSize() < minSpace) {
+        if (pending + minSpace > maxCapacity_) {
+            return nullptr;
+        }
+        size_t newCapacity = buffer_.size();
+        while (newCapacity < pending + minSpace) {
+            newCapacity *= 2;
+        }
+        buffer_.resize(std::min(newCapacity, maxCapacity_));
+    }
+    return buffer_.data() + writePos_;
+}
+
+bool MessageRingBuffer::nextMessage(std::string_view& message, char delimiter) {
+    while (readPos_ < writePos_) {
+        const char* begin = buffer_.data();
+
+        if (BinaryFrame::isFrameStart(begin + readPos_, size())) {
+            size_t frameSize = 0;
+            switch (BinaryFrame::scan(begin + readPos_, size(), frameSize)) {
+                case BinaryFrame::ScanResult::NEED_MORE:
+                    return false;
+                case BinaryFrame::ScanResult::FRAME:
+                    take(message, readPos_ + frameSize, readPos_ + frameSize);
+                    return true;
+                case BinaryFrame::ScanResult::INVALID:
+                    skipInvalid(delimiter);
+                    continue;
+            }
+        }
+
+        // 文本消息以 "<类型编号>:" 或 "<类型编号>#<请求编号>:"（'@' 为回复）开头，
+        // 其他数据说明流中有损坏
+        size_t pos = readPos_;
+        while (pos < writePos_ && pos - readPos_ <= MAX_TYPE_DIGITS && begin[pos] >= '0' && begin[pos] <= '9') {
+            pos++;
+        }
+        if (pos < writePos_ && pos > readPos_ && (begin[pos] == '#' || begin[pos] == '@')) {
+            size_t idStart = ++pos;
+            while (pos < writePos_ && pos - idStart <= MAX_TYPE_DIGITS && begin[pos] >= '0' && begin[pos] <= '9') {
+                pos++;
+            }
+            if (pos < writePos_ && pos == idStart) {
+                skipInvalid(delimiter);
+                continue;
+            }
+        }
+        if (pos == writePos_) {
+            return false;
+        }
+        if (pos == readPos_ || begin[pos] != ':') {
+            skipInvalid(delimiter);
+            continue;
+        }
+
+        size_t from = std::max(scanPos_, readPos_);
+        const void* found = std::memchr(begin + from, delimiter, writePos_ - from);
+        if (!found) {
+            scanPos_ = writePos_;
+            return false;
+        }
+
+        size_t end = static_cast<size_t>(static_cast<const char*>(found) - begin);
+        take(message, end, end + 1);
+        return true;
+    }
+    return false;
+}
+
+void MessageRingBuffer::take(std::string_view& message, size_t end, size_t next) {
+    message = std::string_view(buffer_.data() + readPos_, end - readPos_);
+    readPos_ = next;
+    scanPos_ = readPos_;
+
+    // 全部取完时回到起始位置，下次读取不需要移动数据
+    if (readPos_ == writePos_) {
+        readPos_ = scanPos_ = writePos_ = 0;
+    }
+}
+
+void MessageRingBuffer::skipInvalid(char delimiter) {
+    size_t pos = readPos_ + 1;
+    while (pos < writePos_ && static_cast<uint8_t>(buffer_[pos]) != BinaryFrame::MAGIC0 && buffer_[pos] != delimiter) {
+        pos++;
+    }
+    if (pos < writePos_ && buffer_[pos] == delimiter) {
+        pos++;
+    }
+
+    droppedBytes_ += pos - readPos_;
+    readPos_ = pos;
+    scanPos_ = std::max(scanPos_, readPos_);
+    if (readPos_ == writePos_) {
+        readPos_ = scanPos_ = writePos_ = 0;
+    }
+}
+
+void MessageRingBuffer::clear() {
+    readPos_ = scanPos_ = writePos_ = 0;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 接收缓冲区 - 切分文本消息和二进制帧，不拷贝消息内容
+ *
+ * 以 BinaryFrame 魔数开头的数据按帧头中的长度切分（载荷中可以包含分隔符），
+ * 以 "<数字>:" 或 "<数字>#<数字>:" / "<数字>@<数字>:" 开头的按分隔符切分（文本消息）。其他数据以及校验失败的帧被丢弃，
+ * 直到下一个魔数或分隔符，之后的消息不受影响。
+ * 数据写入一块连续内存，读位置前移即表示消息已取出。
+ * 取出的消息以 string_view 返回，指向缓冲区内部，在下一次 prepareWrite 之前有效。
+ * 尾部空间不足时把未取出的数据（通常只是半条消息）移回起始位置，
+ * 仍不足时按倍数扩容，直到 maxCapacity。
+ * 已扫描过的部分不会重复查找分隔符。
+ * 非线程安全，由接收线程独占使用。
+ */
+class MessageRingBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 初始容量(字节)
+     * @param maxCapacity 最大容量(字节)，单条消息超过该长度时丢弃
+     */
+    explicit MessageRingBuffer(size_t capacity = 64 * 1024, size_t maxCapacity = 4 * 1024 * 1024);
+
+    /**
+     * @brief 获取可写区域，保证至少 minSpace 字节
+     * @param minSpace 需要的最小可写字节数
+     * @return 可写区域起始地址，超过最大容量时返回 nullptr
+     */
+    char* prepareWrite(size_t minSpace);
+
+    /**
+     * @brief 当前可写字节数（prepareWrite 之后有效）
+     */
+    size_t writableSize() const { return buffer_.size() - writePos_; }
+
+    /**
+     * @brief 确认已写入 n 字节
+     */
+    void commitWrite(size_t n) { writePos_ += n; }
+
+    /**
+     * @brief 取出下一条完整消息（文本消息不含分隔符，二进制帧包含帧头和校验码）
+     * @param message 消息内容，在下一次 prepareWrite 之前有效
+     * @param delimiter 消息分隔符
+     * @return 是否有完整消息
+     */
+    bool nextMessage(std::string_view& message, char delimiter = '\n');
+
+    /**
+     * @brief 未取出的字节数
+     */
+    size_t size() const { return writePos_ - readPos_; }
+
+    /**
+     * @brief 当前容量
+     */
+    size_t capacity() const { return buffer_.size(); }
+
+    /**
+     * @brief 因数据无效而丢弃的累计字节数
+     */
+    size_t droppedBytes() const { return droppedBytes_; }
+
+    /**
+     * @brief 丢弃所有未取出的数据
+     */
+    void clear();
+
+private:
+    /**
+     * @brief 丢弃无效帧：跳到下一个魔数或分隔符之后
+     */
+    void skipInvalid(char delimiter);
+
+    /**
+     * @brief 取出 [readPos_, end) 作为一条消息，next 为下一条消息的起始位置
+     */
+    void take(std::string_view& message, size_t end, size_t next);
+
+    std::vector<char> buffer_;
+    size_t maxCapacity_;
+    size_t readPos_{0};             // 下一条消息的起始位置
+    size_t scanPos_{0};             // 已确认不含分隔符的位置
+    size_t writePos_{0};            // 已写入数据的末尾
+    size_t droppedBytes_{0};        // 丢弃的无效数据
+};
@@ -0,0 +1,115 @@
+#include "ResultRecord.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+template <typename T>
+void storeLE(uint8_t* out, T value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+template <typename T>
+T loadLE(const uint8_t* in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void storeFloat(uint8_t* out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    storeLE<uint32_t>(out, bits);
+}
+
+float loadFloat(const uint8_t* in) {
+    uint32_t bits = loadLE<uint32_t>(in);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+size_t ResultRecord::encode(uint8_t* out, size_t capacity, const ResultRecordHeader& header,
+                            const ResultBox* boxes, size_t count) {
+    count = std::min(count, MAX_ENTRIES);
+    size_t size = encodedSize(count);
+    if (capacity < size) {
+        return 0;
+    }
+
+    out[0] = MAGIC0;
+    out[1] = MAGIC1;
+    out[2] = VERSION;
+    out[3] = static_cast<uint8_t>(header.kind);
+    storeLE<uint16_t>(out + 4, header.modelId);
+    storeLE<uint16_t>(out + 6, static_cast<uint16_t>(count));
+    storeLE<uint64_t>(out + 8, header.frameIndex);
+    storeLE<uint64_t>(out + 16, header.deviceTimestampUs);
+    storeLE<uint64_t>(out + 24, header.captureTimeUs);
+    storeLE<uint64_t>(out + 32, header.resultTimeUs);
+    storeLE<uint32_t>(out + 40, header.inferenceTimeUs);
+    storeLE<uint16_t>(out + 44, header.imageWidth);
+    storeLE<uint16_t>(out + 46, header.imageHeight);
+
+    uint8_t* entry = out + HEADER_SIZE;
+    for (size_t i = 0; i < count; i++, entry += ENTRY_SIZE) {
+        const ResultBox& box = boxes[i];
+        storeFloat(entry, box.x);
+        storeFloat(entry + 4, box.y);
+        storeFloat(entry + 8, box.width);
+        storeFloat(entry + 12, box.height);
+        storeFloat(entry + 16, box.score);
+        storeLE<uint32_t>(entry + 20, static_cast<uint32_t>(box.classId));
+    }
+    return size;
+}
+
+void ResultRecord::encode(std::vector<uint8_t>& out, const ResultRecordHeader& header,
+                          const ResultBox* boxes, size_t count) {
+    out.resize(encodedSize(std::min(count, MAX_ENTRIES)));
+    encode(out.data(), out.size(), header, boxes, count);
+}
+
+bool ResultRecord::decode(const void* data, size_t size, ResultRecordHeader& header, std::vector<ResultBox>& boxes) {
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    if (size < HEADER_SIZE || in[0] != MAGIC0 || in[1] != MAGIC1 || in[2] != VERSION) {
+        return false;
+    }
+    if (in[3] < static_cast<uint8_t>(ResultKind::CLASSIFICATION) ||
+        in[3] > static_cast<uint8_t>(ResultKind::SEGMENTATION)) {
+        return false;
+    }
+    size_t count = loadLE<uint16_t>(in + 6);
+    if (size != encodedSize(count)) {
+        return false;
+    }
+
+    header.kind = static_cast<ResultKind>(in[3]);
+    header.modelId = loadLE<uint16_t>(in + 4);
+    header.frameIndex = loadLE<uint64_t>(in + 8);
+    header.deviceTimestampUs = loadLE<uint64_t>(in + 16);
+    header.captureTimeUs = loadLE<uint64_t>(in + 24);
+    header.resultTimeUs = loadLE<uint64_t>(in + 32);
+    header.inferenceTimeUs = loadLE<uint32_t>(in + 40);
+    header.imageWidth = loadLE<uint16_t>(in + 44);
+    header.imageHeight = loadLE<uint16_t>(in + 46);
+
+    boxes.resize(count);
+    const uint8_t* entry = in + HEADER_SIZE;
+    for (size_t i = 0; i < count; i++, entry += ENTRY_SIZE) {
+        ResultBox& box = boxes[i];
+        box.x = loadFloat(entry);
+        box.y = loadFloat(entry + 4);
+        box.width = loadFloat(entry + 8);
+        box.height = loadFloat(entry + 12);
+        box.score = loadFloat(entry + 16);
+        box.classId = static_cast<int32_t>(loadLE<uint32_t>(entry + 20));
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 推理结果类型
+ */
+enum class ResultKind : uint8_t {
+    CLASSIFICATION = 1,     ///< 一个条目：整幅图像为框，score 为置信度
+    DETECTION = 2,          ///< 每个检测框一个条目
+    SEGMENTATION = 3        ///< 掩码中每个取值一个条目：外接框，score 为面积占整幅图像的比例
+};
+
+/**
+ * @brief 结果记录头部字段
+ */
+struct ResultRecordHeader {
+    ResultKind kind = ResultKind::DETECTION;
+    uint16_t modelId = 0;           ///< 模型编号（名称与编号的对应关系通过 GET_MODELS 命令查询）
+    uint64_t frameIndex = 0;        ///< 设备帧号
+    uint64_t deviceTimestampUs = 0; ///< 设备时间戳(微秒)
+    uint64_t captureTimeUs = 0;     ///< 帧到达主机的时刻（steady_clock，微秒）
+    uint64_t resultTimeUs = 0;      ///< 推理完成的时刻（steady_clock，微秒）
+    uint32_t inferenceTimeUs = 0;   ///< 推理耗时(微秒)
+    uint16_t imageWidth = 0;        ///< 输入图像宽度
+    uint16_t imageHeight = 0;       ///< 输入图像高度
+};
+
+/**
+ * @brief 定长结果条目（输入图像像素坐标）
+ */
+struct ResultBox {
+    float x = 0.0f;                 ///< 左上角 x
+    float y = 0.0f;                 ///< 左上角 y
+    float width = 0.0f;             ///< 宽度
+    float height = 0.0f;            ///< 高度
+    float score = 0.0f;             ///< 置信度（分割为面积比例）
+    int32_t classId = -1;           ///< 类别编号（分割为掩码取值）
+};
+
+/**
+ * @brief 推理结果记录编解码（MessageType::DATA 的二进制载荷）
+ *
+ * 记录布局（小端）：
+ *   0  magic        2  'P' 'R'
+ *   2  version      1
+ *   3  kind         1
+ *   4  modelId      2
+ *   6  count        2  条目数
+ *   8  frameIndex   8
+ *  16  deviceTs     8
+ *  24  captureTs    8
+ *  32  resultTs     8
+ *  40  inferenceUs  4
+ *  44  width        2
+ *  46  height       2
+ *  48  entries      count * 24：x y width height score（float32）classId（int32）
+ *
+ * 记录由 BinaryFrame 承载，完整性由帧的 CRC 保证，记录本身不再校验。
+ */
+class ResultRecord {
+public:
+    static constexpr uint8_t MAGIC0 = 'P';
+    static constexpr uint8_t MAGIC1 = 'R';
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 48;
+    static constexpr size_t ENTRY_SIZE = 24;
+    static constexpr size_t MAX_ENTRIES = 0xFFFF;
+
+    /**
+     * @brief count 个条目的记录长度
+     */
+    static constexpr size_t encodedSize(size_t count) {
+        return HEADER_SIZE + count * ENTRY_SIZE;
+    }
+
+    /**
+     * @brief 编码到调用方预分配的缓冲区（超过 MAX_ENTRIES 的条目被截断）
+     * @return 写入的字节数，缓冲区不足时返回 0
+     */
+    static size_t encode(uint8_t* out, size_t capacity, const ResultRecordHeader& header,
+                         const ResultBox* boxes, size_t count);
+
+    /**
+     * @brief 编码到 out（按需扩容，复用已有容量）
+     */
+    static void encode(std::vector<uint8_t>& out, const ResultRecordHeader& header,
+                       const ResultBox* boxes, size_t count);
+
+    /**
+     * @brief 解码并检查魔数、版本和长度
+     * @return 是否有效
+     */
+    static bool decode(const void* data, size_t size, ResultRecordHeader& header, std::vector<ResultBox>& boxes);
+};
@@ -0,0 +1,416 @@
+#include "ShmFrameRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t RING_MAGIC = 0x46534250;     // "PBSF"
+constexpr uint32_t RING_VERSION = 1;
+constexpr uint32_t MAX_CONSUMERS = 16;
+constexpr size_t CACHE_LINE = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory atomics must be lock free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory atomics must be lock free");
+
+/**
+ * @brief 读端表项
+ */
+struct alignas(CACHE_LINE) ConsumerEntry {
+    std::atomic<int32_t> pid;           // 0 表示空闲
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> dropped;
+};
+
+/**
+ * @brief 槽头，seq 为 0 表示空，2s+1 表示第 s 帧写入中，2s+2 表示第 s 帧完成
+ */
+struct alignas(CACHE_LINE) SlotHeader {
+    std::atomic<uint64_t> seq;
+    ShmFrameInfo info;
+};
+
+size_t alignUp(size_t value) {
+    return (value + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+std::string shmName(const std::string& name) {
+    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+uint64_t monotonicUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool processAlive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+} // namespace
+
+/**
+ * @brief 共享内存头部，其后依次为各槽位（槽头 + 载荷，按缓存行对齐）
+ */
+struct ShmRingHeader {
+    std::atomic<uint32_t> magic;        // 初始化完成后写入
+    uint32_t version;
+    uint32_t slotCount;
+    int32_t producerPid;
+    uint64_t slotCapacity;
+    uint64_t slotStride;
+    uint64_t slotsOffset;
+
+    alignas(CACHE_LINE) std::atomic<uint64_t> writeSeq;    // 已发布帧数
+    std::atomic<uint32_t> futexWord;    // 每次发布加 1，读端在此等待
+    std::atomic<uint32_t> waiters;      // 正在等待的读端数
+    std::atomic<uint32_t> closed;       // 写端已关闭
+
+    ConsumerEntry consumers[MAX_CONSUMERS];
+
+    SlotHeader* slot(uint64_t sequence) {
+        auto* base = reinterpret_cast<uint8_t*>(this) + slotsOffset;
+        return reinterpret_cast<SlotHeader*>(base + (sequence % slotCount) * slotStride);
+    }
+
+    static uint8_t* payload(SlotHeader* slot) {
+        return reinterpret_cast<uint8_t*>(slot) + alignUp(sizeof(SlotHeader));
+    }
+};
+
+namespace {
+
+long futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs) {
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    // 共享映射上的 futex 不能使用 FUTEX_PRIVATE_FLAG
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+ShmFrameRingWriter::~ShmFrameRingWriter() {
+    close();
+}
+
+bool ShmFrameRingWriter::create(const std::string& name, uint32_t slotCount, size_t slotCapacity) {
+    close();
+    if (slotCount < 2 || slotCapacity == 0) {
+        lastError_ = "invalid ring geometry";
+        return false;
+    }
+
+    name_ = shmName(name);
+    size_t slotsOffset = alignUp(sizeof(ShmRingHeader));
+    size_t slotStride = alignUp(sizeof(SlotHeader)) + alignUp(slotCapacity);
+    size_t totalSize = slotsOffset + slotStride * slotCount;
+
+    // Readers still attached to a previous segment keep their mapping; they
+    // notice the old producer is gone and reopen by name.
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0) {
+        lastError_ = "shm_open failed: " + std::string(strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0) {
+        lastError_ = "ftruncate failed: " + std::string(strerror(errno));
+        ::close(fd);
+        shm_unlink(name_.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        lastError_ = "mmap failed: " + std::string(strerror(errno));
+        shm_unlink(name_.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills the segment, which is a valid initial state for
+    // every atomic; placement new only starts their lifetime.
+    auto* header = new (base) ShmRingHeader;
+    header->version = RING_VERSION;
+    header->slotCount = slotCount;
+    header->producerPid = static_cast<int32_t>(getpid());
+    header->slotCapacity = slotCapacity;
+    header->slotStride = slotStride;
+    header->slotsOffset = slotsOffset;
+    header->writeSeq.store(0, std::memory_order_relaxed);
+    header->futexWord.store(0, std::memory_order_relaxed);
+    header->waiters.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    for (auto& consumer : header->consumers) {
+        consumer.pid.store(0, std::memory_order_relaxed);
+        consumer.received.store(0, std::memory_order_relaxed);
+        consumer.dropped.store(0, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < slotCount; i++) {
+        new (header->slot(i)) SlotHeader;
+        header->slot(i)->seq.store(0, std::memory_order_relaxed);
+    }
+    header->magic.store(RING_MAGIC, std::memory_order_release);
+
+    header_ = header;
+    mappedSize_ = totalSize;
+    return true;
+}
+
+void ShmFrameRingWriter::close() {
+    if (!header_) {
+        return;
+    }
+    header_->closed.store(1, std::memory_order_seq_cst);
+    header_->futexWord.fetch_add(1, std::memory_order_seq_cst);
+    futexWakeAll(&header_->futexWord);
+
+    munmap(header_, mappedSize_);
+    shm_unlink(name_.c_str());
+    header_ = nullptr;
+    mappedSize_ = 0;
+}
+
+bool ShmFrameRingWriter::publish(const ShmFrameInfo& info, const void* data, size_t size) {
+    if (!header_ || size > header_->slotCapacity) {
+        return false;
+    }
+
+    uint64_t sequence = header_->writeSeq.load(std::memory_order_relaxed);
+    SlotHeader* slot = header_->slot(sequence);
+
+    // Mark the slot as being written before touching its contents so that a
+    // reader copying the previous frame in this slot detects the overwrite.
+    slot->seq.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ShmFrameInfo stored = info;
+    stored.sequence = sequence;
+    stored.publishTimeUs = monotonicUs();
+    stored.dataSize = static_cast<uint32_t>(size);
+    std::memcpy(&slot->info, &stored, sizeof(stored));
+    if (size > 0) {
+        std::memcpy(ShmRingHeader::payload(slot), data, size);
+    }
+
+    slot->seq.store(2 * sequence + 2, std::memory_order_release);
+    header_->writeSeq.store(sequence + 1, std::memory_order_release);
+
+    // Pairs with the waiter registration in ShmFrameRingReader::waitPublish:
+    // either the reader sees the new futex word, or we see its waiter count.
+    header_->futexWord.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->waiters.load(std::memory_order_seq_cst) > 0) {
+        futexWakeAll(&header_->futexWord);
+    }
+    return true;
+}
+
+uint64_t ShmFrameRingWriter::publishedCount() const {
+    return header_ ? header_->writeSeq.load(std::memory_order_relaxed) : 0;
+}
+
+size_t ShmFrameRingWriter::slotCapacity() const {
+    return header_ ? header_->slotCapacity : 0;
+}
+
+std::vector<ShmConsumerStats> ShmFrameRingWriter::consumers() const {
+    std::vector<ShmConsumerStats> result;
+    if (!header_) {
+        return result;
+    }
+    for (const auto& entry : header_->consumers) {
+        int32_t pid = entry.pid.load(std::memory_order_acquire);
+        if (pid != 0 && processAlive(pid)) {
+            ShmConsumerStats stats;
+            stats.pid = pid;
+            stats.received = entry.received.load(std::memory_order_relaxed);
+            stats.dropped = entry.dropped.load(std::memory_order_relaxed);
+            result.push_back(stats);
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+ShmFrameRingReader::~ShmFrameRingReader() {
+    close();
+}
+
+bool ShmFrameRingReader::open(const std::string& name, bool latestOnly) {
+    close();
+
+    std::string path = shmName(name);
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        lastError_ = "shm_open failed: " + std::string(strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+        lastError_ = "shared memory not initialized";
+        ::close(fd);
+        return false;
+    }
+    size_t mappedSize = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        lastError_ = "mmap failed: " + std::string(strerror(errno));
+        return false;
+    }
+
+    auto* header = static_cast<ShmRingHeader*>(base);
+    if (header->magic.load(std::memory_order_acquire) != RING_MAGIC || header->version != RING_VERSION ||
+        header->slotsOffset + header->slotStride * header->slotCount > mappedSize) {
+        lastError_ = "shared memory layout mismatch";
+        munmap(base, mappedSize);
+        return false;
+    }
+
+    header_ = header;
+    mappedSize_ = mappedSize;
+    latestOnly_ = latestOnly;
+    cursor_ = header_->writeSeq.load(std::memory_order_acquire);
+    received_ = 0;
+    dropped_ = 0;
+
+    // Take a free entry, or one left behind by a reader that exited without closing
+    int32_t self = static_cast<int32_t>(getpid());
+    for (uint32_t i = 0; i < MAX_CONSUMERS && consumerIndex_ < 0; i++) {
+        auto& entry = header_->consumers[i];
+        int32_t pid = entry.pid.load(std::memory_order_acquire);
+        if ((pid == 0 || !processAlive(pid)) && entry.pid.compare_exchange_strong(pid, self)) {
+            entry.received.store(0, std::memory_order_relaxed);
+            entry.dropped.store(0, std::memory_order_relaxed);
+            consumerIndex_ = static_cast<int>(i);
+        }
+    }
+    return true;
+}
+
+void ShmFrameRingReader::close() {
+    if (!header_) {
+        return;
+    }
+    if (consumerIndex_ >= 0) {
+        header_->consumers[consumerIndex_].pid.store(0, std::memory_order_release);
+        consumerIndex_ = -1;
+    }
+    munmap(header_, mappedSize_);
+    header_ = nullptr;
+    mappedSize_ = 0;
+}
+
+size_t ShmFrameRingReader::slotCapacity() const {
+    return header_ ? header_->slotCapacity : 0;
+}
+
+ShmReadStatus ShmFrameRingReader::read(ShmFrameInfo& info, std::vector<uint8_t>& data, int timeoutMs) {
+    if (!header_) {
+        return ShmReadStatus::CLOSED;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+    for (;;) {
+        uint64_t written = header_->writeSeq.load(std::memory_order_acquire);
+        if (cursor_ < written) {
+            uint64_t oldest = written > header_->slotCount ? written - header_->slotCount : 0;
+            uint64_t target = latestOnly_ ? written - 1 : std::max(cursor_, oldest);
+            dropped_ += target - cursor_;
+            cursor_ = target + 1;
+
+            bool copied = copySlot(target, info, data);
+            if (copied) {
+                received_++;
+            } else {
+                // Overwritten while copying; the next attempt picks up a newer frame
+                dropped_++;
+            }
+            if (consumerIndex_ >= 0) {
+                auto& entry = header_->consumers[consumerIndex_];
+                entry.received.store(received_, std::memory_order_relaxed);
+                entry.dropped.store(dropped_, std::memory_order_relaxed);
+            }
+            if (copied) {
+                return ShmReadStatus::FRAME;
+            }
+            continue;
+        }
+
+        if (producerGone()) {
+            return ShmReadStatus::CLOSED;
+        }
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return ShmReadStatus::TIMEOUT;
+        }
+        waitPublish(static_cast<int>(remaining));
+    }
+}
+
+bool ShmFrameRingReader::copySlot(uint64_t sequence, ShmFrameInfo& info, std::vector<uint8_t>& data) const {
+    SlotHeader* slot = header_->slot(sequence);
+    uint64_t expected = 2 * sequence + 2;
+    if (slot->seq.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+
+    ShmFrameInfo local;
+    std::memcpy(&local, &slot->info, sizeof(local));
+    if (local.dataSize > header_->slotCapacity) {
+        return false;
+    }
+    data.resize(local.dataSize);
+    if (local.dataSize > 0) {
+        std::memcpy(data.data(), ShmRingHeader::payload(slot), local.dataSize);
+    }
+
+    // The copy is only valid if the writer did not start reusing the slot meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->seq.load(std::memory_order_relaxed) != expected) {
+        return false;
+    }
+    info = local;
+    return true;
+}
+
+void ShmFrameRingReader::waitPublish(int timeoutMs) {
+    // Wake up periodically to notice a producer that exited without closing
+    timeoutMs = std::min(timeoutMs, 200);
+
+    header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+    uint32_t word = header_->futexWord.load(std::memory_order_seq_cst);
+    if (header_->writeSeq.load(std::memory_order_acquire) <= cursor_ &&
+        !header_->closed.load(std::memory_order_acquire)) {
+        futexWait(&header_->futexWord, word, timeoutMs);
+    }
+    header_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+bool ShmFrameRingReader::producerGone() const {
+    return header_->closed.load(std::memory_order_acquire) != 0 || !processAlive(header_->producerPid);
+}
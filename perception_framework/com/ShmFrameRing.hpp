@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ShmRingHeader;
+
+/**
+ * @brief 共享内存环中一帧的描述
+ */
+struct ShmFrameInfo {
+    uint64_t sequence = 0;          ///< 发布序号（写端分配，从 0 开始连续递增）
+    uint64_t frameIndex = 0;        ///< 设备帧号
+    uint64_t deviceTimestampUs = 0; ///< 设备时间戳(微秒)
+    uint64_t publishTimeUs = 0;     ///< 发布时间（steady_clock/CLOCK_MONOTONIC，微秒，同一台机器上跨进程可比）
+    uint32_t streamType = 0;        ///< 流类型（OBFrameType 数值，结果流为 SHM_STREAM_RESULTS）
+    uint32_t format = 0;            ///< 像素格式（OBFormat 数值，深度流启用 RVL 时为 OB_FORMAT_RVL，载荷用 utils::DepthCodec 解码）
+    uint32_t width = 0;             ///< 宽度
+    uint32_t height = 0;            ///< 高度
+    uint32_t dataSize = 0;          ///< 载荷长度(字节)
+    uint32_t reserved = 0;
+};
+
+/**
+ * @brief 结果流载荷中的检测框，载荷为 ShmDetection 数组
+ * 结果流的 frameIndex/deviceTimestampUs 为推理输入帧的值，与帧流中的同一帧相同
+ */
+struct ShmDetection {
+    float x = 0.0f;                 ///< 左上角 x（原始帧像素坐标）
+    float y = 0.0f;                 ///< 左上角 y
+    float width = 0.0f;             ///< 宽度
+    float height = 0.0f;            ///< 高度
+    float confidence = 0.0f;        ///< 置信度
+    int32_t classId = -1;           ///< 类别编号
+};
+
+/// 结果流的 streamType
+constexpr uint32_t SHM_STREAM_RESULTS = 0xFFFF;
+
+/**
+ * @brief 读取结果
+ */
+enum class ShmReadStatus {
+    FRAME,          ///< 读到一帧
+    TIMEOUT,        ///< 超时前没有新帧
+    CLOSED          ///< 写端已关闭或进程已退出，需要重新打开
+};
+
+/**
+ * @brief 读端统计（写端通过共享内存中的读端表获取）
+ */
+struct ShmConsumerStats {
+    int32_t pid = 0;                ///< 读端进程号
+    uint64_t received = 0;          ///< 已读取帧数
+    uint64_t dropped = 0;           ///< 因读取过慢跳过的帧数
+};
+
+/**
+ * @brief 共享内存帧环 - 写端
+ *
+ * POSIX 共享内存中的固定槽位环，每个槽位为槽头加定长载荷区（按流配置确定大小）。
+ * 发布不加锁也不等待读端：写入最旧的槽位，槽头序号按 seqlock 方式标记
+ * 写入中/完成，读端拷贝后检查序号未变即为完整的一帧。有读端在等待时通过共享的 futex 唤醒。
+ * 只有一个写端，publish 需由调用方保证不并发。
+ */
+class ShmFrameRingWriter {
+public:
+    ShmFrameRingWriter() = default;
+    ~ShmFrameRingWriter();
+
+    // 禁止拷贝和赋值
+    ShmFrameRingWriter(const ShmFrameRingWriter&) = delete;
+    ShmFrameRingWriter& operator=(const ShmFrameRingWriter&) = delete;
+
+    /**
+     * @brief 创建共享内存（同名的旧共享内存会被删除）
+     * @param name 共享内存名称（不以 '/' 开头时自动补上）
+     * @param slotCount 槽位数量
+     * @param slotCapacity 每个槽位的载荷容量(字节)
+     * @return 是否成功，失败原因见 lastError()
+     */
+    bool create(const std::string& name, uint32_t slotCount, size_t slotCapacity);
+
+    /**
+     * @brief 标记关闭，唤醒读端并删除共享内存
+     */
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * @brief 发布一帧
+     * @param info 帧描述（sequence、publishTimeUs、dataSize 由写端填写）
+     * @param data 载荷
+     * @param size 载荷长度，超过槽位容量时不发布
+     * @return 是否发布
+     */
+    bool publish(const ShmFrameInfo& info, const void* data, size_t size);
+
+    /**
+     * @brief 已发布帧数
+     */
+    uint64_t publishedCount() const;
+
+    /**
+     * @brief 槽位载荷容量(字节)
+     */
+    size_t slotCapacity() const;
+
+    /**
+     * @brief 当前登记的读端
+     */
+    std::vector<ShmConsumerStats> consumers() const;
+
+    const std::string& name() const { return name_; }
+    const std::string& lastError() const { return lastError_; }
+
+private:
+    ShmRingHeader* header_ = nullptr;
+    size_t mappedSize_ = 0;
+    std::string name_;
+    std::string lastError_;
+};
+
+/**
+ * @brief 共享内存帧环 - 读端
+ *
+ * 每个读端有独立的读取位置，并登记在共享内存的读端表中供写端统计。
+ * 读取过慢时写端不会等待：latestOnly 模式直接跳到最新一帧，
+ * 顺序模式从仍未被覆盖的最旧一帧继续，跳过的帧计入 droppedCount()。
+ * 非线程安全，每个读取线程使用自己的实例。
+ */
+class ShmFrameRingReader {
+public:
+    ShmFrameRingReader() = default;
+    ~ShmFrameRingReader();
+
+    // 禁止拷贝和赋值
+    ShmFrameRingReader(const ShmFrameRingReader&) = delete;
+    ShmFrameRingReader& operator=(const ShmFrameRingReader&) = delete;
+
+    /**
+     * @brief 打开写端创建的共享内存，从打开之后发布的帧开始读取
+     * @param name 共享内存名称
+     * @param latestOnly 是否只读取最新一帧
+     * @return 是否成功，失败原因见 lastError()
+     */
+    bool open(const std::string& name, bool latestOnly = true);
+
+    /**
+     * @brief 注销读端并解除映射
+     */
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * @brief 读取下一帧，没有新帧时等待
+     * @param info 帧描述
+     * @param data 载荷（拷贝到调用方缓冲区，容量可重复使用）
+     * @param timeoutMs 超时(毫秒)，0 表示不等待
+     */
+    ShmReadStatus read(ShmFrameInfo& info, std::vector<uint8_t>& data, int timeoutMs);
+
+    /**
+     * @brief 已读取帧数
+     */
+    uint64_t receivedCount() const { return received_; }
+
+    /**
+     * @brief 跳过的帧数
+     */
+    uint64_t droppedCount() const { return dropped_; }
+
+    /**
+     * @brief 槽位载荷容量(字节)
+     */
+    size_t slotCapacity() const;
+
+    const std::string& lastError() const { return lastError_; }
+
+private:
+    /**
+     * @brief 拷贝第 sequence 帧，期间被覆盖时返回 false
+     */
+    bool copySlot(uint64_t sequence, ShmFrameInfo& info, std::vector<uint8_t>& data) const;
+
+    /**
+     * @brief 等待写端发布，最多 timeoutMs 毫秒
+     */
+    void waitPublish(int timeoutMs);
+
+    /**
+     * @brief 写端是否已关闭或进程已退出
+     */
+    bool producerGone() const;
+
+    ShmRingHeader* header_ = nullptr;
+    size_t mappedSize_ = 0;
+    bool latestOnly_ = true;
+    int consumerIndex_ = -1;        // 读端表中的位置（表满时为 -1，不影响读取）
+    uint64_t cursor_ = 0;           // 下一帧的发布序号
+    uint64_t received_ = 0;
+    uint64_t dropped_ = 0;
+    std::string lastError_;
+};
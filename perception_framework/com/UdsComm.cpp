@@ -0,0 +1,553 @@
+#include "UdsComm.hpp"
+#include "BinaryFrame.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace {
+
+// Large enough for the biggest binary frame; the kernel clamps it to net.core.wmem_max
+constexpr int SOCKET_BUFFER_SIZE = static_cast<int>(BinaryFrame::MAX_PAYLOAD + BinaryFrame::OVERHEAD);
+
+// Packets read from one peer per wake-up, so a chatty peer cannot starve the others
+constexpr int MAX_PACKETS_PER_PEER = 64;
+
+bool makeAddress(const std::string& path, sockaddr_un& addr) {
+    if (path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Socket path too long: ", path);
+        return false;
+    }
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+void setBufferSizes(int fd) {
+    int size = SOCKET_BUFFER_SIZE;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+} // namespace
+
+// UdsCommImpl implementation
+UdsCommImpl::UdsCommImpl(const std::string& socketPath, CommRole role, size_t maxQueuedMessages)
+    : socketPath_(socketPath), role_(role), maxQueuedMessages_(std::max<size_t>(maxQueuedMessages, 1)),
+      rxBuffer_(BinaryFrame::MAX_PAYLOAD + BinaryFrame::OVERHEAD) {
+}
+
+UdsCommImpl::~UdsCommImpl() {
+    cleanup();
+}
+
+bool UdsCommImpl::initialize() {
+    return initialize(role_);
+}
+
+bool UdsCommImpl::initialize(CommRole role) {
+    if (!createEventLoop()) {
+        return false;
+    }
+
+    if (role == CommRole::SERVER) {
+        if (initializeAsServer()) {
+            LOG_INFO("UDS communication initialized successfully (server mode): ", socketPath_);
+            return true;
+        }
+        LOG_ERROR("UDS communication initialization failed, cannot initialize as server");
+    } else if (role == CommRole::CLIENT) {
+        if (initializeAsClient()) {
+            LOG_INFO("UDS communication initialized successfully (client mode): ", socketPath_);
+            return true;
+        }
+        LOG_ERROR("UDS communication initialization failed, cannot connect to server");
+    } else {
+        // AUTO: join a running server, otherwise become the server
+        if (initializeAsClient()) {
+            LOG_INFO("UDS communication initialized successfully (client mode): ", socketPath_);
+            return true;
+        }
+        if (initializeAsServer()) {
+            LOG_INFO("UDS communication initialized successfully (server mode): ", socketPath_);
+            return true;
+        }
+        LOG_ERROR("UDS communication initialization failed, cannot initialize as server or client");
+    }
+
+    cleanup();
+    return false;
+}
+
+bool UdsCommImpl::initializeAsServer() {
+    isServer_ = true;
+
+    sockaddr_un addr;
+    if (!makeAddress(socketPath_, addr)) {
+        return false;
+    }
+
+    listenFd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ == -1) {
+        LOG_ERROR("Failed to create socket: ", strerror(errno));
+        return false;
+    }
+
+    // Remove a socket file left behind by a previous server
+    unlink(socketPath_.c_str());
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 ||
+        listen(listenFd_, SOMAXCONN) == -1) {
+        LOG_ERROR("Failed to listen on ", socketPath_, ": ", strerror(errno));
+        close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    chmod(socketPath_.c_str(), 0666);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event) == -1) {
+        LOG_ERROR("Failed to register listening socket with epoll: ", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool UdsCommImpl::initializeAsClient() {
+    isServer_ = false;
+
+    int fd = connectToServer();
+    if (fd == -1) {
+        return false;
+    }
+    addPeer(fd);
+    return true;
+}
+
+bool UdsCommImpl::createEventLoop() {
+    if (epollFd_ != -1) {
+        close(epollFd_);
+    }
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+    }
+
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ == -1 || wakeFd_ == -1) {
+        LOG_ERROR("Failed to create event loop: ", strerror(errno));
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event) == -1) {
+        LOG_ERROR("Failed to register wake-up eventfd with epoll: ", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int UdsCommImpl::connectToServer() {
+    sockaddr_un addr;
+    if (!makeAddress(socketPath_, addr)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        LOG_ERROR("Failed to create socket: ", strerror(errno));
+        return -1;
+    }
+
+    // A Unix socket connect completes (or fails) immediately, there is nothing to wait for
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void UdsCommImpl::cleanup() {
+    {
+        std::lock_guard<std::mutex> lock(peersMutex_);
+        for (auto& entry : peers_) {
+            close(entry.first);
+        }
+        peers_.clear();
+    }
+    isConnected_ = false;
+    pending_.clear();
+
+    if (listenFd_ != -1) {
+        close(listenFd_);
+        listenFd_ = -1;
+        LOG_INFO("Server: Deleting socket file");
+        unlink(socketPath_.c_str());
+    }
+
+    if (epollFd_ != -1) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+
+    if (wakeFd_ != -1) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+}
+
+int UdsCommImpl::acceptPeers() {
+    int accepted = 0;
+    for (;;) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Failed to accept connection: ", strerror(errno));
+            }
+            break;
+        }
+        addPeer(fd);
+        accepted++;
+    }
+    return accepted;
+}
+
+void UdsCommImpl::addPeer(int fd) {
+    setBufferSizes(fd);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+        LOG_ERROR("Failed to register connection with epoll: ", strerror(errno));
+        close(fd);
+        return;
+    }
+
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(peersMutex_);
+        auto peer = std::make_unique<Peer>();
+        peer->fd = fd;
+        peers_[fd] = std::move(peer);
+        count = peers_.size();
+    }
+    isConnected_ = true;
+    LOG_INFO("UDS peer connected (", count, " connected)");
+}
+
+void UdsCommImpl::removePeer(int fd) {
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(peersMutex_);
+        auto it = peers_.find(fd);
+        if (it == peers_.end()) {
+            return;
+        }
+        if (!it->second->queue.empty()) {
+            LOG_WARN("Discarding ", it->second->queue.size(), " queued messages of closed UDS peer");
+        }
+        // Closing the socket also removes it from the epoll set
+        close(fd);
+        peers_.erase(it);
+        count = peers_.size();
+    }
+    isConnected_ = count > 0;
+    LOG_WARN("UDS peer disconnected (", count, " connected)");
+}
+
+bool UdsCommImpl::sendMessage(const std::string& message) {
+    // Packet boundaries already delimit messages, no separator needed
+    iovec iov;
+    iov.iov_base = const_cast<char*>(message.data());
+    iov.iov_len = message.size();
+    return sendBuffers(&iov, 1);
+}
+
+bool UdsCommImpl::sendBuffers(const iovec* iov, int count) {
+    return sendCoalesced(iov, count, 0);
+}
+
+bool UdsCommImpl::sendCoalesced(const iovec* iov, int count, uint32_t key) {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += iov[i].iov_len;
+    }
+
+    std::lock_guard<std::mutex> lock(peersMutex_);
+    if (peers_.empty()) {
+        return false;
+    }
+
+    bool delivered = false;
+    for (auto& entry : peers_) {
+        delivered = sendToPeer(*entry.second, iov, count, total, key) || delivered;
+    }
+    return delivered;
+}
+
+bool UdsCommImpl::sendToPeer(Peer& peer, const iovec* iov, int count, size_t total, uint32_t key) {
+    // Keep packets in order: once something is queued, new packets go behind it
+    if (peer.queue.empty()) {
+        msghdr msg{};
+        msg.msg_iov = const_cast<iovec*>(iov);
+        msg.msg_iovlen = static_cast<size_t>(count);
+
+        ssize_t sent;
+        do {
+            sent = sendmsg(peer.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        } while (sent == -1 && errno == EINTR);
+
+        // SEQPACKET sends are all-or-nothing
+        if (sent >= 0) {
+            return true;
+        }
+        if (errno == EMSGSIZE) {
+            LOG_ERROR("Message of ", total, " bytes exceeds the socket buffer, not sent");
+            return false;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            // Peer went away; the receive loop sees the hang-up and removes it
+            return false;
+        }
+    }
+
+    // The peer is not keeping up: a newer coalescable packet replaces the unsent one with the same key
+    if (key != 0) {
+        for (auto it = peer.queue.rbegin(); it != peer.queue.rend(); ++it) {
+            if (it->key == key) {
+                it->data.clear();
+                for (int i = 0; i < count; i++) {
+                    it->data.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+                }
+                coalescedMessages_.fetch_add(1);
+                return true;
+            }
+        }
+    }
+
+    // Otherwise queue a copy, dropping the oldest packet when full
+    if (peer.queue.size() >= maxQueuedMessages_) {
+        peer.queue.pop_front();
+        if (droppedMessages_.fetch_add(1) % 1000 == 0) {
+            LOG_WARN("UDS peer send queue full, dropping oldest messages (", droppedMessages_.load(), " dropped)");
+        }
+    }
+    std::string packet;
+    packet.reserve(total);
+    for (int i = 0; i < count; i++) {
+        packet.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    }
+    peer.queue.push_back(QueuedPacket{std::move(packet), key});
+    armWrite(peer, true);
+    return true;
+}
+
+void UdsCommImpl::flushPeer(Peer& peer) {
+    while (!peer.queue.empty()) {
+        const std::string& packet = peer.queue.front().data;
+        ssize_t sent;
+        do {
+            sent = send(peer.fd, packet.data(), packet.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        } while (sent == -1 && errno == EINTR);
+
+        if (sent == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            if (errno == EMSGSIZE) {
+                LOG_ERROR("Queued message of ", packet.size(), " bytes exceeds the socket buffer, dropped");
+            } else {
+                // Hang-up is handled by the receive loop
+                return;
+            }
+        }
+        peer.queue.pop_front();
+    }
+    armWrite(peer, false);
+}
+
+void UdsCommImpl::armWrite(Peer& peer, bool enable) {
+    if (peer.writeArmed == enable) {
+        return;
+    }
+    epoll_event event{};
+    event.events = enable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.fd = peer.fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, peer.fd, &event) == 0) {
+        peer.writeArmed = enable;
+    }
+}
+
+bool UdsCommImpl::receiveMessage(std::string& message) {
+    // A pass may only accept a connection or flush queues, so keep waiting until the timeout
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(receiveTimeoutMs_);
+    auto collect = [this](std::string_view data) { pending_.emplace_back(data); };
+    while (pending_.empty()) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (receiveMessages(collect, static_cast<int>(std::max<int64_t>(remaining.count(), 0))) < 0 ||
+            remaining.count() <= 0) {
+            break;
+        }
+    }
+    if (pending_.empty()) {
+        return false;
+    }
+    message = std::move(pending_.front());
+    pending_.pop_front();
+    return true;
+}
+
+int UdsCommImpl::receiveMessages(const MessageHandler& handler, int timeoutMs) {
+    if (epollFd_ == -1) {
+        LOG_ERROR("Cannot receive messages: socket not initialized");
+        return -1;
+    }
+
+    // Messages buffered by receiveMessage are delivered first
+    int count = 0;
+    while (!pending_.empty()) {
+        std::string message = std::move(pending_.front());
+        pending_.pop_front();
+        handler(message);
+        count++;
+    }
+
+    // A client that lost the server reconnects on every pass; connect() does not block
+    if (!isServer_ && !isConnected_) {
+        int fd = connectToServer();
+        if (fd != -1) {
+            addPeer(fd);
+            LOG_INFO("Reconnected to UDS server");
+            if (peerConnectedHandler_) {
+                peerConnectedHandler_();
+            }
+        }
+    }
+
+    const int MAX_EVENTS = 32;
+    epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(epollFd_, events, MAX_EVENTS, count > 0 ? 0 : timeoutMs);
+    if (ready == -1) {
+        if (errno == EINTR) {
+            return count;
+        }
+        LOG_ERROR("epoll_wait failed: ", strerror(errno));
+        return count > 0 ? count : -1;
+    }
+
+    for (int i = 0; i < ready; i++) {
+        int fd = events[i].data.fd;
+        if (fd == wakeFd_) {
+            uint64_t value;
+            ssize_t ret = read(wakeFd_, &value, sizeof(value));
+            (void)ret;
+            continue;
+        }
+        if (fd == listenFd_) {
+            int accepted = acceptPeers();
+            for (int n = 0; n < accepted && peerConnectedHandler_; n++) {
+                peerConnectedHandler_();
+            }
+            continue;
+        }
+
+        if (events[i].events & EPOLLOUT) {
+            std::lock_guard<std::mutex> lock(peersMutex_);
+            auto it = peers_.find(fd);
+            if (it != peers_.end()) {
+                flushPeer(*it->second);
+            }
+        }
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            int handled = readPeer(fd, handler);
+            if (handled < 0) {
+                removePeer(fd);
+            } else {
+                count += handled;
+            }
+        }
+    }
+
+    return count;
+}
+
+int UdsCommImpl::readPeer(int fd, const MessageHandler& handler) {
+    int count = 0;
+    for (int i = 0; i < MAX_PACKETS_PER_PEER; i++) {
+        iovec iov;
+        iov.iov_base = rxBuffer_.data();
+        iov.iov_len = rxBuffer_.size();
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        ssize_t bytesRead = recvmsg(fd, &msg, MSG_DONTWAIT);
+        if (bytesRead == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return count;
+            }
+            LOG_ERROR("Read from socket failed: ", strerror(errno));
+            return -1;
+        }
+        if (bytesRead == 0) {
+            // Orderly shutdown by the peer
+            return -1;
+        }
+        if (msg.msg_flags & MSG_TRUNC) {
+            LOG_ERROR("Dropping oversized UDS packet");
+            continue;
+        }
+
+        handler(std::string_view(rxBuffer_.data(), static_cast<size_t>(bytesRead)));
+        count++;
+    }
+    return count;
+}
+
+void UdsCommImpl::interruptReceive() {
+    if (wakeFd_ != -1) {
+        uint64_t one = 1;
+        ssize_t ret = write(wakeFd_, &one, sizeof(one));
+        (void)ret;
+    }
+}
+
+void UdsCommImpl::setReceiveTimeout(int milliseconds) {
+    receiveTimeoutMs_ = std::max(0, milliseconds);
+}
+
+void UdsCommImpl::setPeerConnectedHandler(PeerConnectedHandler handler) {
+    peerConnectedHandler_ = std::move(handler);
+}
+
+bool UdsCommImpl::isConnected() const {
+    return isConnected_;
+}
+
+bool UdsCommImpl::isServer() const {
+    return isServer_;
+}
+
+size_t UdsCommImpl::peerCount() const {
+    std::lock_guard<std::mutex> lock(peersMutex_);
+    return peers_.size();
+}
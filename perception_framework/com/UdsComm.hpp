@@ -0,0 +1,236 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ICommunicationImpl.hpp"
+#include "Logger.hpp"
+
+/**
+ * @brief Unix 域套接字通信实现类 - SOCK_SEQPACKET，服务端可同时连接多个客户端
+ *
+ * SEQPACKET 保留消息边界，每条消息（文本或二进制帧）是一个数据包，不需要分隔符。
+ * 服务端发送的消息广播给所有客户端；每个客户端有独立的有界发送队列，
+ * 套接字写满时消息进入该客户端的队列（满时丢弃最旧的消息），
+ * 由接收线程在可写时发出，一个慢客户端不会阻塞发送线程或其他客户端。
+ * 可合并的消息（sendCoalesced）在队列中有同键的未发出消息时替换它，慢客户端只收到最新的一条。
+ * 接收线程的 epoll 循环同时负责接受新连接；客户端断开后服务端立即可以接受新的连接，
+ * 客户端在连接断开后每次接收时重新连接，没有打开顺序的要求和重试等待。
+ * 单个数据包受套接字发送缓冲区限制（net.core.wmem_max），超出时发送失败。
+ */
+class UdsCommImpl : public ICommunicationImpl {
+public:
+    using CommRole = ICommunicationImpl::CommRole;
+
+    /**
+     * @brief 构造函数
+     * @param socketPath 套接字路径
+     * @param role 通信角色
+     * @param maxQueuedMessages 每个客户端发送队列的最大消息数
+     */
+    explicit UdsCommImpl(const std::string& socketPath, CommRole role = CommRole::AUTO,
+                         size_t maxQueuedMessages = 256);
+
+    /**
+     * @brief 析构函数
+     */
+    ~UdsCommImpl() override;
+
+    /**
+     * @brief 初始化通信
+     * @param role 通信角色（AUTO：能连接到服务端时作为客户端，否则作为服务端）
+     * @return 是否成功
+     */
+    bool initialize(CommRole role);
+
+    // 实现无参数 initialize 接口
+    bool initialize() override;
+
+    /**
+     * @brief 清理通信资源
+     */
+    void cleanup() override;
+
+    /**
+     * @brief 发送消息（服务端广播给所有客户端）
+     * @param message 消息内容
+     * @return 是否至少发给（或排入队列）一个对端
+     */
+    bool sendMessage(const std::string& message) override;
+
+    /**
+     * @brief 分散写入一个数据包（服务端广播给所有客户端）
+     * @param iov 数据段
+     * @param count 段数
+     * @return 是否至少发给（或排入队列）一个对端
+     */
+    bool sendBuffers(const iovec* iov, int count) override;
+
+    /**
+     * @brief 分散写入一个可合并的数据包（服务端广播给所有客户端）
+     *
+     * 对端的发送队列中有同键的数据包时原位替换（保持它在队列中的位置），不增加队列长度。
+     * @param key 合并键，0 表示不合并
+     * @return 是否至少发给（或排入队列）一个对端
+     */
+    bool sendCoalesced(const iovec* iov, int count, uint32_t key) override;
+
+    /**
+     * @brief 接收消息
+     * @param message 接收到的消息
+     * @return 是否成功
+     */
+    bool receiveMessage(std::string& message) override;
+
+    /**
+     * @brief 等待数据到达并处理所有完整消息，同时接受新连接、发送排队的消息
+     * @param handler 消息处理函数
+     * @param timeoutMs 最长等待时间(毫秒)，0 表示不等待，-1 表示一直等待
+     * @return 处理的消息数，出错返回 -1
+     */
+    int receiveMessages(const MessageHandler& handler, int timeoutMs) override;
+
+    /**
+     * @brief 唤醒阻塞在 receiveMessages 中的线程
+     */
+    void interruptReceive() override;
+
+    /**
+     * @brief 设置接收超时（receiveMessage 没有缓存消息时最多等待的时间）
+     * @param milliseconds 超时时间(毫秒)，0 表示不等待
+     */
+    void setReceiveTimeout(int milliseconds) override;
+
+    /**
+     * @brief 设置新对端连接时的回调（在接收线程中调用）
+     */
+    void setPeerConnectedHandler(PeerConnectedHandler handler) override;
+
+    /**
+     * @brief 获取连接状态
+     * @return 是否至少有一个对端
+     */
+    bool isConnected() const override;
+
+    /**
+     * @brief 获取服务端标志
+     * @return 是否为服务端
+     */
+    bool isServer() const override;
+
+    /**
+     * @brief 当前连接的对端数
+     */
+    size_t peerCount() const;
+
+    /**
+     * @brief 因发送队列已满而丢弃的累计消息数
+     */
+    uint64_t droppedMessages() const { return droppedMessages_; }
+
+    /**
+     * @brief 在发送队列中被同键的新消息替换的累计消息数
+     */
+    uint64_t coalescedMessages() const { return coalescedMessages_; }
+
+private:
+    /**
+     * @brief 一个连接（服务端的每个客户端，或客户端到服务端的连接）
+     */
+    struct QueuedPacket {
+        std::string data;
+        uint32_t key{0};                // 合并键，0 表示不合并
+    };
+
+    struct Peer {
+        int fd{-1};
+        std::deque<QueuedPacket> queue; // 套接字写满时待发送的数据包
+        bool writeArmed{false};         // 是否已注册 EPOLLOUT
+    };
+
+    /**
+     * @brief 作为服务端初始化：创建监听套接字
+     * @return 是否成功
+     */
+    bool initializeAsServer();
+
+    /**
+     * @brief 作为客户端初始化：连接服务端
+     * @return 是否成功
+     */
+    bool initializeAsClient();
+
+    /**
+     * @brief 创建 epoll 实例和唤醒用的 eventfd
+     * @return 是否成功
+     */
+    bool createEventLoop();
+
+    /**
+     * @brief 连接服务端（非阻塞，立即返回）
+     * @return 套接字，失败返回 -1
+     */
+    int connectToServer();
+
+    /**
+     * @brief 接受所有等待中的连接
+     * @return 新连接数
+     */
+    int acceptPeers();
+
+    /**
+     * @brief 注册一个新连接
+     */
+    void addPeer(int fd);
+
+    /**
+     * @brief 关闭并移除一个连接
+     */
+    void removePeer(int fd);
+
+    /**
+     * @brief 读取一个连接上已到达的数据包
+     * @return 处理的消息数，连接已断开时返回 -1
+     */
+    int readPeer(int fd, const MessageHandler& handler);
+
+    /**
+     * @brief 发送一个数据包，写满时排入队列（调用方持有 peersMutex_）
+     * @return 是否已发送或排入队列
+     */
+    bool sendToPeer(Peer& peer, const iovec* iov, int count, size_t total, uint32_t key);
+
+    /**
+     * @brief 发送队列中的数据包，直到队列为空或套接字写满（调用方持有 peersMutex_）
+     */
+    void flushPeer(Peer& peer);
+
+    /**
+     * @brief 注册/取消 EPOLLOUT
+     */
+    void armWrite(Peer& peer, bool enable);
+
+private:
+    std::string socketPath_;            // 套接字路径
+    bool isServer_{false};              // 是否服务端
+    CommRole role_{CommRole::AUTO};     // 通信角色
+    size_t maxQueuedMessages_;          // 每个连接发送队列的最大消息数
+    int listenFd_{-1};                  // 监听套接字（服务端）
+    int epollFd_{-1};                   // epoll 实例
+    int wakeFd_{-1};                    // 唤醒用 eventfd
+    int receiveTimeoutMs_{0};           // receiveMessage 的等待时间
+    std::vector<char> rxBuffer_;        // 接收缓冲区（一个数据包）
+    std::deque<std::string> pending_;   // receiveMessage 尚未取出的消息
+    PeerConnectedHandler peerConnectedHandler_; // 新对端连接回调
+
+    std::map<int, std::unique_ptr<Peer>> peers_; // 套接字 -> 连接（接收线程增删，发送线程遍历）
+    mutable std::mutex peersMutex_;     // 保护 peers_ 及各连接的发送队列
+    std::atomic<bool> isConnected_{false}; // 是否至少有一个对端
+    std::atomic<uint64_t> droppedMessages_{0}; // 队列已满丢弃的消息数
+    std::atomic<uint64_t> coalescedMessages_{0}; // 队列中被替换的消息数
+};
@@ -1,14 +1,29 @@
+#include <protocol/light_protocol.h>
+#include <schedule/light_scheduler.h>
 #include <transport/serial_transport.h>
 
+#include <functional>
 #include <iostream>
+#include <string>
 
 class Session {
  public:
-  void init();
+  using LightFrameHandler = std::function<void(const LightProtocol&)>;
+
+  void init(const std::string& light_dev = "/dev/ttyUSB0", const LightScheduler::Config& schedule_config = {});
   void control_light_on();
   void control_light_off();
+  // 每帧调用一次，输入设备时间戳（DumpHelper::TimeStamp::deviceUs）和到达时刻（CLOCK_MONOTONIC 微秒）
+  void on_frame(uint64_t device_us, int64_t arrival_us = -1);
+  // 在之后第 frames_ahead 帧曝光开始后 offset_us 开/关灯，时间线未锁定时返回 false
+  bool schedule_light_on(uint32_t frames_ahead, int64_t offset_us);
+  bool schedule_light_off(uint32_t frames_ahead, int64_t offset_us);
+  LightScheduler* light_scheduler() { return light_scheduler_.get(); }
   void start();
   void stop();
+  // 灯控板回传帧的处理函数（在串口 io 线程中调用），需在 start 之前设置
+  void set_light_frame_handler(const LightFrameHandler& handler) { light_frame_handler_ = handler; }
+  const LightFrameParser& light_parser() const { return light_parser_; }
   static Session& get_instance() {
     static Session instance;
     return instance;
@@ -20,7 +35,13 @@ class Session {
   Session(Session&&) noexcept = default;
   Session& operator=(const Session&) = delete;
   Session& operator=(Session&&) noexcept = default;
-  void init_light_com();
+  void init_light_com(const std::string& dev_path, const LightScheduler::Config& schedule_config);
   void init_control_com();
+  static LightProtocol make_light_command(uint8_t cmd2);
+  void send_light_command(uint8_t cmd2);
+  bool schedule_light_command(uint8_t cmd2, uint32_t frames_ahead, int64_t offset_us);
   std::shared_ptr<SerialTransport> light_com_;
+  std::unique_ptr<LightScheduler> light_scheduler_;
+  LightFrameParser light_parser_;
+  LightFrameHandler light_frame_handler_;
 };
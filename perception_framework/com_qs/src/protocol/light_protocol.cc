@@ -0,0 +1,71 @@
+#include "protocol/light_protocol.h"
+
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kCrcPoly = 0x07;  // X^8+X^2+X^1+1
+
+constexpr std::array<uint8_t, 256> make_crc_table() {
+  std::array<uint8_t, 256> table{};
+  for (int i = 0; i < 256; i++) {
+    uint8_t crc = static_cast<uint8_t>(i);
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ kCrcPoly) : static_cast<uint8_t>(crc << 1);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 256> kCrcTable = make_crc_table();
+
+}  // namespace
+
+// 与原先逐位计算的 py_crc_8_s（补 8 个 0 位的移位寄存器实现）结果相同
+uint8_t crc8(const uint8_t* data, size_t len) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len; i++) {
+    crc = kCrcTable[crc ^ data[i]];
+  }
+  return crc;
+}
+
+void light_protocol_seal(LightProtocol& frame) {
+  frame.crc = crc8(reinterpret_cast<const uint8_t*>(&frame), offsetof(LightProtocol, crc));
+}
+
+size_t LightFrameParser::feed(const uint8_t* data, size_t len, const FrameCallback& callback) {
+  size_t parsed = 0;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t byte = data[i];
+    if (size_ == 0 && byte != kLightSyncByte) {
+      dropped_bytes_++;
+      continue;
+    }
+    frame_[size_++] = byte;
+    if (size_ < sizeof(LightProtocol)) {
+      continue;
+    }
+
+    if (crc8(frame_, offsetof(LightProtocol, crc)) == frame_[offsetof(LightProtocol, crc)]) {
+      LightProtocol frame;
+      std::memcpy(&frame, frame_, sizeof(frame));
+      size_ = 0;
+      frames_++;
+      parsed++;
+      if (callback) callback(frame);
+      continue;
+    }
+
+    // 校验失败：帧头可能是数据中的 0xFF，从下一个 0xFF 开始重新同步
+    crc_errors_++;
+    size_t next = 1;
+    while (next < size_ && frame_[next] != kLightSyncByte) next++;
+    dropped_bytes_ += next;
+    size_ -= next;
+    std::memmove(frame_, frame_ + next, size_);
+  }
+  return parsed;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#pragma pack(push, 1)
+struct LightProtocol {
+  uint8_t sync;
+  uint8_t addr;
+  uint8_t cmd1;
+  uint8_t cmd2;
+  uint8_t data1;
+  uint8_t data2;
+  uint8_t crc;
+};
+#pragma pack(pop)
+
+constexpr uint8_t kLightSyncByte = 0xFF;
+
+/**
+ * @brief CRC-8（多项式 0x07，初值 0，不反转），查表计算
+ * @param data 数据
+ * @param len 字节数
+ */
+uint8_t crc8(const uint8_t* data, size_t len);
+
+/**
+ * @brief 计算并填入帧的 crc 字段（覆盖 crc 之前的 6 个字节）
+ */
+void light_protocol_seal(LightProtocol& frame);
+
+/**
+ * @brief LightProtocol 增量解析器
+ *
+ * 输入任意切分的字节流，以 0xFF 同步字节定位帧头，凑满一帧后校验 CRC。
+ * 校验失败时从已缓存字节中的下一个 0xFF 重新同步，数据字段里的 0xFF 不会导致后续帧丢失。
+ * 非线程安全，由读回调所在线程独占使用。
+ */
+class LightFrameParser {
+ public:
+  using FrameCallback = std::function<void(const LightProtocol&)>;
+
+  /**
+   * @brief 输入一段字节流
+   * @param data 数据
+   * @param len 字节数
+   * @param callback 每解析出一个有效帧调用一次
+   * @return 本次解析出的帧数
+   */
+  size_t feed(const uint8_t* data, size_t len, const FrameCallback& callback);
+
+  /**
+   * @brief 丢弃未完成的帧
+   */
+  void reset() { size_ = 0; }
+
+  uint64_t frames() const { return frames_; }              // 累计有效帧数
+  uint64_t crc_errors() const { return crc_errors_; }      // 累计 CRC 错误数
+  uint64_t dropped_bytes() const { return dropped_bytes_; }  // 累计丢弃的字节数
+
+ private:
+  uint8_t frame_[sizeof(LightProtocol)];
+  size_t size_ = 0;
+  uint64_t frames_ = 0;
+  uint64_t crc_errors_ = 0;
+  uint64_t dropped_bytes_ = 0;
+};
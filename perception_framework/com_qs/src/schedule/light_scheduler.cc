@@ -0,0 +1,270 @@
+#include "schedule/light_scheduler.h"
+
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+constexpr size_t kMinFramesForLock = 3;
+constexpr int kSchedulerPriority = 10;  // SCHED_FIFO 优先级（没有权限时保持普通调度）
+
+}  // namespace
+
+// ==================== LatencySamples ====================
+
+void LatencySamples::add(int64_t sample_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  samples_.push_back(sample_us);
+  if (samples_.size() > window_) samples_.pop_front();
+  count_++;
+}
+
+LatencySamples::Summary LatencySamples::summary() const {
+  std::vector<int64_t> values;
+  Summary result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values.assign(samples_.begin(), samples_.end());
+    result.count = count_;
+  }
+  if (values.empty()) return result;
+
+  double sum = 0;
+  for (int64_t v : values) sum += static_cast<double>(v);
+  result.mean_us = sum / values.size();
+
+  std::sort(values.begin(), values.end());
+  result.p50_us = static_cast<double>(values[values.size() / 2]);
+
+  std::vector<int64_t> magnitudes(values.size());
+  std::transform(values.begin(), values.end(), magnitudes.begin(), [](int64_t v) { return v < 0 ? -v : v; });
+  std::sort(magnitudes.begin(), magnitudes.end());
+  result.p99_us = static_cast<double>(magnitudes[(magnitudes.size() - 1) * 99 / 100]);
+  result.max_abs_us = static_cast<double>(magnitudes.back());
+  return result;
+}
+
+// ==================== LightScheduler ====================
+
+LightScheduler::LightScheduler(SendFunction send) : LightScheduler(std::move(send), Config()) {}
+
+LightScheduler::LightScheduler(SendFunction send, const Config& config)
+    : send_(std::move(send)), config_(config) {
+  config_.history = std::max(config_.history, kMinFramesForLock);
+}
+
+LightScheduler::~LightScheduler() { stop(); }
+
+int64_t LightScheduler::monotonic_us() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+bool LightScheduler::start() {
+  if (running_) return true;
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (timer_fd_ < 0 || wake_fd_ < 0) {
+    std::cout << "create light scheduler timer failed" << std::endl;
+    stop();
+    return false;
+  }
+  running_ = true;
+  thread_ = std::thread(&LightScheduler::run, this);
+  return true;
+}
+
+void LightScheduler::stop() {
+  if (running_) {
+    running_ = false;
+    wake();
+  }
+  if (thread_.joinable()) thread_.join();
+  if (timer_fd_ >= 0) {
+    ::close(timer_fd_);
+    timer_fd_ = -1;
+  }
+  if (wake_fd_ >= 0) {
+    ::close(wake_fd_);
+    wake_fd_ = -1;
+  }
+  cancel_all();
+}
+
+void LightScheduler::observe_frame(uint64_t device_us, int64_t arrival_us) {
+  if (arrival_us < 0) arrival_us = monotonic_us();
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  int64_t index = 0;
+  if (!frames_.empty()) {
+    const FramePoint& last = frames_.back();
+    if (device_us <= last.device_us) return;  // 重复或乱序的帧
+
+    double delta = static_cast<double>(device_us - last.device_us);
+    int64_t step = 1;
+    if (frames_.size() >= 2) {
+      if (delta < slope_ * 0.5) {
+        // 间隔远小于估计的周期（帧率切换等），重新开始估计
+        frames_.clear();
+        host_offsets_.clear();
+      } else {
+        // 丢帧时间隔是周期的整数倍
+        step = std::max<int64_t>(1, std::llround(delta / slope_));
+        if (frames_.size() >= kMinFramesForLock) {
+          prediction_error_.add(static_cast<int64_t>(device_us) -
+                                std::llround(fit_device_us(static_cast<double>(last.index + step))));
+        }
+      }
+    }
+    if (!frames_.empty()) index = last.index + step;
+  }
+
+  frames_.push_back({index, device_us});
+  host_offsets_.push_back(arrival_us - static_cast<int64_t>(device_us));
+  while (frames_.size() > config_.history) frames_.pop_front();
+  while (host_offsets_.size() > config_.history) host_offsets_.pop_front();
+  host_offset_us_ = *std::min_element(host_offsets_.begin(), host_offsets_.end());
+
+  // 最小二乘拟合 device = intercept + slope * index（相对窗口首帧，避免大数相减丢失精度）
+  if (frames_.size() < 2) return;
+  const FramePoint& first = frames_.front();
+  double n = static_cast<double>(frames_.size());
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (const FramePoint& point : frames_) {
+    double x = static_cast<double>(point.index - first.index);
+    double y = static_cast<double>(point.device_us - first.device_us);
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+  }
+  double denominator = n * sxx - sx * sx;
+  if (denominator <= 0) return;
+  slope_ = (n * sxy - sx * sy) / denominator;
+  intercept_ = (sy - slope_ * sx) / n;
+}
+
+double LightScheduler::fit_device_us(double index) const {
+  const FramePoint& first = frames_.front();
+  return static_cast<double>(first.device_us) + intercept_ + slope_ * (index - static_cast<double>(first.index));
+}
+
+bool LightScheduler::locked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_.size() >= kMinFramesForLock;
+}
+
+double LightScheduler::period_us() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_.size() >= kMinFramesForLock ? slope_ : 0.0;
+}
+
+int64_t LightScheduler::predict_exposure(uint32_t frames_ahead) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (frames_.size() < kMinFramesForLock) return -1;
+  double device_us = fit_device_us(static_cast<double>(frames_.back().index + frames_ahead));
+  return std::llround(device_us) + host_offset_us_ + config_.exposure_offset_us;
+}
+
+bool LightScheduler::schedule(const uint8_t* command, size_t len, uint32_t frames_ahead, int64_t offset_us) {
+  int64_t exposure_us = predict_exposure(frames_ahead);
+  if (exposure_us < 0) return false;
+  return schedule_at(command, len, exposure_us + offset_us);
+}
+
+bool LightScheduler::schedule_at(const uint8_t* command, size_t len, int64_t effective_us) {
+  // 每字节 10 位（起始位 + 8 数据位 + 停止位），最后一个字节在 effective_us 到达
+  int64_t transmit_us = config_.baudrate > 0 ? static_cast<int64_t>(len) * 10 * 1000000 / config_.baudrate : 0;
+  int64_t fire_us = effective_us - transmit_us;
+  if (fire_us <= monotonic_us()) return false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push(Job{fire_us, next_seq_++, std::vector<uint8_t>(command, command + len)});
+  }
+  wake();
+  return true;
+}
+
+void LightScheduler::cancel_all() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  jobs_ = decltype(jobs_)();
+}
+
+size_t LightScheduler::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return jobs_.size();
+}
+
+void LightScheduler::wake() {
+  if (wake_fd_ < 0) return;
+  uint64_t one = 1;
+  ssize_t ret = ::write(wake_fd_, &one, sizeof(one));
+  (void)ret;
+}
+
+void LightScheduler::arm_timer(int64_t wake_us) {
+  itimerspec spec = {};
+  if (wake_us > 0) {
+    spec.it_value.tv_sec = wake_us / 1000000;
+    spec.it_value.tv_nsec = (wake_us % 1000000) * 1000;
+  }
+  // 时刻为 0 表示停止定时器；已过去的绝对时刻立即触发
+  timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void LightScheduler::run() {
+  pthread_setname_np(pthread_self(), "light_sched");
+  sched_param param = {};
+  param.sched_priority = kSchedulerPriority;
+  pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+  pollfd fds[2] = {{timer_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+  while (running_) {
+    int64_t next_fire = -1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!jobs_.empty()) next_fire = jobs_.top().fire_us;
+    }
+    arm_timer(next_fire < 0 ? 0 : std::max<int64_t>(1, next_fire - config_.spin_us));
+
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      std::cout << "light scheduler poll failed: " << errno << std::endl;
+      break;
+    }
+    uint64_t value;
+    if (fds[0].revents & POLLIN) (void)!::read(timer_fd_, &value, sizeof(value));
+    if (fds[1].revents & POLLIN) (void)!::read(wake_fd_, &value, sizeof(value));
+
+    // 触发所有进入忙等区间的命令
+    while (running_) {
+      Job job;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (jobs_.empty() || jobs_.top().fire_us - config_.spin_us > monotonic_us()) break;
+        job = jobs_.top();
+        jobs_.pop();
+      }
+      // 定时器唤醒有几十微秒的抖动，最后一段忙等到触发时刻
+      while (monotonic_us() < job.fire_us) {
+      }
+      int64_t sent_us = monotonic_us();
+      if (send_ && !send_(job.command.data(), job.command.size())) {
+        std::cout << "light scheduler send failed" << std::endl;
+      }
+      fire_jitter_.add(sent_us - job.fire_us);
+    }
+  }
+}
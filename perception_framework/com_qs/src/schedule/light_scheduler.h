@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 延迟样本窗口：保留最近的样本，按需计算分位数
+ */
+class LatencySamples {
+ public:
+  struct Summary {
+    uint64_t count = 0;       // 累计样本数
+    double mean_us = 0;       // 窗口内均值
+    double p50_us = 0;        // 窗口内中位数
+    double p99_us = 0;        // 窗口内 |样本| 的 99 分位
+    double max_abs_us = 0;    // 窗口内最大 |样本|
+  };
+
+  explicit LatencySamples(size_t window = 1024) : window_(window) {}
+
+  void add(int64_t sample_us);
+  Summary summary() const;
+
+ private:
+  size_t window_;
+  std::deque<int64_t> samples_;
+  uint64_t count_ = 0;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief 帧同步的灯控调度器
+ *
+ * 每帧调用 observe_frame 输入设备时间戳（DumpHelper::TimeStamp::deviceUs）和到达主机的时刻。
+ * 帧周期和相位由最近 history 帧的设备时间戳线性拟合（丢帧按周期整数倍计入帧序号），
+ * 设备时钟到主机 CLOCK_MONOTONIC 的偏移取最近 history 帧 (到达时刻 - 设备时间戳) 的最小值，
+ * 即传输延迟最小的那一帧。exposure_offset_us 校准设备时间戳到曝光开始的固定差值和最小传输延迟。
+ *
+ * 命令排入按触发时刻排序的队列，由专用线程用 timerfd 绝对时刻定时，
+ * 提前 spin_us 唤醒后忙等到触发时刻再写串口；触发时刻扣除串口发送命令所需的时间，
+ * 使命令的最后一个字节在目标时刻到达灯控板。
+ */
+class LightScheduler {
+ public:
+  // 在调度线程中同步发送一条命令
+  using SendFunction = std::function<bool(const uint8_t* data, size_t len)>;
+
+  struct Config {
+    int64_t exposure_offset_us = 0;  // 曝光开始相对映射到主机时钟的设备时间戳的偏移
+    uint32_t baudrate = 115200;      // 串口波特率，用于扣除发送时间（0 表示不扣除）
+    size_t history = 32;             // 参与拟合的帧数
+    int64_t spin_us = 200;           // 提前唤醒后忙等的时间
+  };
+
+  explicit LightScheduler(SendFunction send);
+  LightScheduler(SendFunction send, const Config& config);
+  ~LightScheduler();
+
+  LightScheduler(const LightScheduler&) = delete;
+  LightScheduler& operator=(const LightScheduler&) = delete;
+
+  /**
+   * @brief 启动调度线程
+   */
+  bool start();
+  void stop();
+
+  /**
+   * @brief 输入一帧的时间戳
+   * @param device_us 设备时间戳（微秒）
+   * @param arrival_us 帧到达主机的 CLOCK_MONOTONIC 时刻（微秒），小于 0 表示当前时刻
+   */
+  void observe_frame(uint64_t device_us, int64_t arrival_us = -1);
+
+  /**
+   * @brief 是否已有足够的帧用于预测
+   */
+  bool locked() const;
+
+  /**
+   * @brief 估计的帧周期（微秒），未锁定时为 0
+   */
+  double period_us() const;
+
+  /**
+   * @brief 预测之后第 frames_ahead 帧（1 为下一帧）曝光开始的 CLOCK_MONOTONIC 时刻（微秒）
+   * @return 未锁定时返回 -1
+   */
+  int64_t predict_exposure(uint32_t frames_ahead = 1) const;
+
+  /**
+   * @brief 让命令在之后第 frames_ahead 帧曝光开始后 offset_us 生效
+   * @return 未锁定或触发时刻已过时返回 false
+   */
+  bool schedule(const uint8_t* command, size_t len, uint32_t frames_ahead, int64_t offset_us);
+
+  /**
+   * @brief 让命令在 CLOCK_MONOTONIC 时刻 effective_us 生效
+   * @return 触发时刻已过时返回 false
+   */
+  bool schedule_at(const uint8_t* command, size_t len, int64_t effective_us);
+
+  /**
+   * @brief 取消所有未触发的命令
+   */
+  void cancel_all();
+
+  size_t pending() const;
+
+  // 实际写串口时刻 - 计划触发时刻
+  LatencySamples::Summary fire_jitter() const { return fire_jitter_.summary(); }
+  // 实际设备时间戳 - 预测的设备时间戳（每帧一次）
+  LatencySamples::Summary prediction_error() const { return prediction_error_.summary(); }
+
+  /**
+   * @brief 当前 CLOCK_MONOTONIC 时刻（微秒）
+   */
+  static int64_t monotonic_us();
+
+ private:
+  struct Job {
+    int64_t fire_us;
+    uint64_t seq;  // 同一时刻按加入顺序触发
+    std::vector<uint8_t> command;
+    bool operator>(const Job& other) const {
+      return fire_us != other.fire_us ? fire_us > other.fire_us : seq > other.seq;
+    }
+  };
+
+  void run();
+  void arm_timer(int64_t wake_us);
+  void wake();
+  // 调用方持有 mutex_；设备时间戳 -> 帧序号为 index 时的拟合值
+  double fit_device_us(double index) const;
+
+  SendFunction send_;
+  Config config_;
+
+  // 帧时间线
+  mutable std::mutex mutex_;
+  struct FramePoint {
+    int64_t index;
+    uint64_t device_us;
+  };
+  std::deque<FramePoint> frames_;
+  std::deque<int64_t> host_offsets_;  // 到达时刻 - 设备时间戳
+  double slope_ = 0;                  // 拟合的帧周期
+  double intercept_ = 0;              // 帧序号 0 的设备时间戳（相对 frames_.front().device_us）
+  int64_t host_offset_us_ = 0;        // 最小偏移
+
+  // 命令队列
+  std::priority_queue<Job, std::vector<Job>, std::greater<Job>> jobs_;
+  uint64_t next_seq_ = 0;
+
+  int timer_fd_ = -1;
+  int wake_fd_ = -1;
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  LatencySamples fire_jitter_;
+  LatencySamples prediction_error_;
+};
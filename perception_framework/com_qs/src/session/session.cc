@@ -1,84 +1,83 @@
 #include <session/session.h>
 
-#pragma pack(push, 1)
-struct LightProtocol {
-  uint8_t sync;
-  uint8_t addr;
-  uint8_t cmd1;
-  uint8_t cmd2;
-  uint8_t data1;
-  uint8_t data2;
-  uint8_t crc;
-};
-#pragma pack(pop)
-
-uint8_t py_crc_8_s(const uint8_t* di, uint32_t len) {
-  uint8_t crc_poly = 0x07;  // X^8+X^2+X^1+1 total 8 effective bits without X^8. Computed total data shall be
-                            // compensated 8-bit '0' before CRC computing.
-
-  uint32_t clen = len + 1;
-  uint8_t cdata;
-  uint8_t data_t = di[0];  // CRC register
-
-  for (uint32_t i = 1; i < clen; i++) {
-    cdata = di[i];
-    if (i == clen - 1) {
-      cdata = 0;
-    }
-    for (uint8_t j = 0; j <= 7; j++) {
-      if (data_t & 0x80)
-        data_t = ((data_t << 1) | ((cdata >> (7 - j)) & 0x01)) ^ crc_poly;
-      else
-        data_t = ((data_t << 1) | ((cdata >> (7 - j)) & 0x01));
-    }
-  }
-  return data_t;
-}
-
-void Session::init() {
-  init_light_com();
+void Session::init(const std::string& light_dev, const LightScheduler::Config& schedule_config) {
+  init_light_com(light_dev, schedule_config);
   init_control_com();
 }
 
-void Session::init_light_com() {
+void Session::init_light_com(const std::string& dev_path, const LightScheduler::Config& schedule_config) {
   uint32_t baudrate = 115200;
-  std::string dev_path = "/dev/ttyUSB0";
   light_com_ = std::make_shared<SerialTransport>(dev_path);
   light_com_->init(baudrate, 3);
+  // 定时命令在调度线程中调用 send：发送队列为空时直接写串口，否则排在 async_send 的数据之后
+  LightScheduler::Config config = schedule_config;
+  config.baudrate = baudrate;
+  std::weak_ptr<SerialTransport> com = light_com_;
+  light_scheduler_ = std::make_unique<LightScheduler>(
+      [com](const uint8_t* data, size_t len) {
+        auto transport = com.lock();
+        return transport && transport->send(data, len) == static_cast<int>(len);
+      },
+      config);
+  // 串口读到的字节可能是半帧或多帧，由解析器拼帧并在出错时重新同步
+  light_com_->setCallback([this](const std::vector<uint8_t>& data) {
+    light_parser_.feed(data.data(), data.size(), [this](const LightProtocol& frame) {
+      if (light_frame_handler_) light_frame_handler_(frame);
+    });
+  });
 }
 
-void Session::control_light_on() {
-  std::cout << "send light on msg" << std::endl;
-  std::vector<uint8_t> data;
-  LightProtocol content = {0xff, 0x1, 0, 9, 0, 1, 0};
-  content.crc = py_crc_8_s(reinterpret_cast<const uint8_t*>(&content), 6);
+LightProtocol Session::make_light_command(uint8_t cmd2) {
+  LightProtocol content = {kLightSyncByte, 0x1, 0, cmd2, 0, 1, 0};
+  light_protocol_seal(content);
+  return content;
+}
 
-  // 修正1: 将content的内容复制到vector中
-  data.assign(reinterpret_cast<const uint8_t*>(&content), reinterpret_cast<const uint8_t*>(&content) + sizeof(content));
+void Session::send_light_command(uint8_t cmd2) {
+  LightProtocol content = make_light_command(cmd2);
 
   if (light_com_) {
-    // 修正2: 发送vector的数据而不是vector本身的地址
-    light_com_->async_send(data);
+    light_com_->async_send(reinterpret_cast<const uint8_t*>(&content), sizeof(content));
   }
 }
 
+void Session::control_light_on() {
+  std::cout << "send light on msg" << std::endl;
+  send_light_command(9);
+}
+
 void Session::control_light_off() {
   std::cout << "send light off msg" << std::endl;
-  std::vector<uint8_t> data;
-  LightProtocol content = {0xff, 0x1, 0, 0xB, 0, 1, 0};
-  content.crc = py_crc_8_s(reinterpret_cast<const uint8_t*>(&content), 6);
+  send_light_command(0xB);
+}
 
-  // 修正1: 将content的内容复制到vector中
-  data.assign(reinterpret_cast<const uint8_t*>(&content), reinterpret_cast<const uint8_t*>(&content) + sizeof(content));
+bool Session::schedule_light_command(uint8_t cmd2, uint32_t frames_ahead, int64_t offset_us) {
+  if (!light_scheduler_) return false;
+  LightProtocol content = make_light_command(cmd2);
+  return light_scheduler_->schedule(reinterpret_cast<const uint8_t*>(&content), sizeof(content), frames_ahead,
+                                    offset_us);
+}
 
-  if (light_com_) {
-    // 修正2: 发送vector的数据而不是vector本身的地址
-    light_com_->async_send(data);
-  }
+bool Session::schedule_light_on(uint32_t frames_ahead, int64_t offset_us) {
+  return schedule_light_command(9, frames_ahead, offset_us);
+}
+
+bool Session::schedule_light_off(uint32_t frames_ahead, int64_t offset_us) {
+  return schedule_light_command(0xB, frames_ahead, offset_us);
+}
+
+void Session::on_frame(uint64_t device_us, int64_t arrival_us) {
+  if (light_scheduler_) light_scheduler_->observe_frame(device_us, arrival_us);
 }
 
 void Session::init_control_com() {}
 
-void Session::start() { light_com_->start(); }
+void Session::start() {
+  light_com_->start();
+  if (light_scheduler_) light_scheduler_->start();
+}
 
-void Session::stop() { light_com_->stop(); }
+void Session::stop() {
+  if (light_scheduler_) light_scheduler_->stop();
+  light_com_->stop();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 缓冲区池
+ *
+ * acquire 返回的句柄销毁时缓冲区回到池中，稳定运行后读写不再分配内存。
+ * 句柄可以比池活得久（池销毁后句柄直接释放缓冲区）。
+ */
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+ public:
+  using Buffer = std::vector<uint8_t>;
+
+  struct Releaser {
+    std::weak_ptr<BufferPool> pool;
+    void operator()(Buffer* buffer) const {
+      if (auto owner = pool.lock()) {
+        owner->release(buffer);
+      } else {
+        delete buffer;
+      }
+    }
+  };
+  using Handle = std::unique_ptr<Buffer, Releaser>;
+
+  /**
+   * @param buffer_size acquire 返回的缓冲区大小
+   * @param max_cached 池中最多保留的空闲缓冲区数
+   */
+  static std::shared_ptr<BufferPool> create(size_t buffer_size, size_t max_cached) {
+    return std::shared_ptr<BufferPool>(new BufferPool(buffer_size, max_cached));
+  }
+
+  /**
+   * @brief 取一个缓冲区，size() 为 buffer_size（内容未定义）
+   */
+  Handle acquire() {
+    Buffer* buffer = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        buffer = free_.back().release();
+        free_.pop_back();
+      } else {
+        allocated_++;
+      }
+    }
+    if (!buffer) {
+      buffer = new Buffer();
+      buffer->reserve(buffer_size_);
+    }
+    buffer->resize(buffer_size_);
+    return Handle(buffer, Releaser{weak_from_this()});
+  }
+
+  size_t buffer_size() const { return buffer_size_; }
+
+  // 累计新分配的缓冲区数
+  size_t allocated() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_;
+  }
+
+ private:
+  BufferPool(size_t buffer_size, size_t max_cached) : buffer_size_(buffer_size), max_cached_(max_cached) {}
+
+  void release(Buffer* buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < max_cached_) {
+      free_.emplace_back(buffer);
+    } else {
+      delete buffer;
+    }
+  }
+
+  const size_t buffer_size_;
+  const size_t max_cached_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Buffer>> free_;
+  size_t allocated_ = 0;
+};
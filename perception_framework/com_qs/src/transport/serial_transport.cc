@@ -1,12 +1,26 @@
 #include "transport/serial_transport.h"
 
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <system_error>
 #include <thread>
 
-SerialTransport::SerialTransport(const std::string& port) : port_(port) {}
+namespace {
+
+constexpr size_t kReadBufferSize = 1024;  // 单次读取的最大字节数
+constexpr size_t kTxBufferSize = 64;      // 发送缓冲区初始容量，更长的数据会使缓冲区扩容后留在池中
+constexpr size_t kMaxCachedBuffers = 8;
+
+}  // namespace
+
+SerialTransport::SerialTransport(const std::string& port)
+    : port_(port),
+      ctx_(std::make_shared<ThreadIoMgr>()),
+      serial_port_(std::make_unique<asio::serial_port>(ctx_->io)),
+      rx_pool_(BufferPool::create(kReadBufferSize, kMaxCachedBuffers)),
+      tx_pool_(BufferPool::create(kTxBufferSize, kMaxCachedBuffers)) {}
 
 SerialTransport::~SerialTransport() { stop(); }
 
@@ -22,14 +36,23 @@ bool SerialTransport::init(uint32_t baudrate, int retry_times) {
     // 配置串口参数
     if (!configure(baudrate)) {
       std::cout << "configure serial failed and try again" << std::endl;
+      ::close(fd_);
+      fd_ = -1;
       std::this_thread::sleep_for(std::chrono::seconds(1));
       continue;
     }
+    // 读写改由 serial_port_ 在 io 线程中异步完成
+    asio::error_code ec;
+    serial_port_->assign(fd_, ec);
+    if (ec) {
+      std::cout << "assign " << port_ << " failed: " << ec.message() << std::endl;
+      ::close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    return true;
   }
-  // 启动异步读取线程
-  running_ = true;
-  read_thread_ = std::thread(&SerialTransport::readThreadFunc, this);
-  return true;
+  return false;
 }
 
 bool SerialTransport::configure(uint32_t baudrate) {
@@ -92,22 +115,81 @@ bool SerialTransport::configure(uint32_t baudrate) {
 }
 
 void SerialTransport::start() {
-  ctx_ = std::make_shared<ThreadIoMgr>();
+  if (fd_ >= 0) {
+    running_ = true;
+    asio::post(ctx_->io, [this]() { start_read(); });
+  }
   ctx_->t = std::thread([this]() {
-    std::string thread_name = "tty_asend";
+    std::string thread_name = "tty_io";
     pthread_setname_np(pthread_self(), thread_name.c_str());
     ctx_->io.run();
   });
 }
 
-int SerialTransport::send(const std::vector<uint8_t>& data) {
+int SerialTransport::send(const std::vector<uint8_t>& data) { return send(data.data(), data.size()); }
+
+int SerialTransport::send(const uint8_t* data, size_t len) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (fd_ < 0) return -1;
-  return write(fd_, data.data(), data.size());
+  // io 线程正在写出队列中的数据，直接写会与之交错
+  if (!tx_queue_.empty()) {
+    enqueue_locked(data, len);
+    return static_cast<int>(len);
+  }
+  ssize_t written = ::write(fd_, data, len);
+  if (written < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+    written = 0;
+  }
+  // 非阻塞串口的部分写入：剩余字节由 io 线程接着写
+  if (static_cast<size_t>(written) < len) enqueue_locked(data + written, len - written);
+  return static_cast<int>(len);
+}
+
+void SerialTransport::async_send(const std::vector<uint8_t>& data) { async_send(data.data(), data.size()); }
+
+void SerialTransport::async_send(const uint8_t* data, size_t len) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) return;
+  enqueue_locked(data, len);
+}
+
+void SerialTransport::enqueue_locked(const uint8_t* data, size_t len) {
+  BufferPool::Handle buffer = tx_pool_->acquire();
+  buffer->assign(data, data + len);
+  tx_queue_.push_back(std::move(buffer));
+  // 已有写操作在进行时由其完成回调继续写出
+  if (tx_queue_.size() == 1) {
+    tx_offset_ = 0;
+    asio::post(ctx_->io, [this]() { write_next(); });
+  }
 }
 
-void SerialTransport::async_send(const std::vector<uint8_t>& data) {
-  ctx_->io.post([this, data]() { send(data); });
+void SerialTransport::write_next() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tx_queue_.empty() || fd_ < 0) return;
+  const BufferPool::Buffer& front = *tx_queue_.front();
+  auto remaining = asio::buffer(front.data() + tx_offset_, front.size() - tx_offset_);
+  serial_port_->async_write_some(remaining, [this](const asio::error_code& ec, size_t n) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (ec) {
+        if (ec != asio::error::operation_aborted) {
+          std::cout << "write " << port_ << " failed: " << ec.message() << std::endl;
+        }
+        tx_queue_.clear();
+        tx_offset_ = 0;
+        return;
+      }
+      // 部分写入时下一次接着写剩余部分
+      tx_offset_ += n;
+      if (tx_offset_ == tx_queue_.front()->size()) {
+        tx_queue_.pop_front();
+        tx_offset_ = 0;
+      }
+    }
+    write_next();
+  });
 }
 
 void SerialTransport::setCallback(const DataCallback& callback) {
@@ -116,50 +198,51 @@ void SerialTransport::setCallback(const DataCallback& callback) {
 }
 
 void SerialTransport::stop() {
-  if (running_) {
-    running_ = false;
-    if (read_thread_.joinable()) {
-      read_thread_.join();
-    }
-  }
-  ctx_->io.stop();
+  running_ = false;
   if (ctx_->t.joinable()) {
+    // 在 io 线程中关闭串口，未完成的读写以 operation_aborted 结束，之后 io.run 返回
+    asio::post(ctx_->io, [this]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      asio::error_code ec;
+      serial_port_->close(ec);
+      fd_ = -1;
+    });
+    ctx_->guard.reset();
     ctx_->t.join();
-  }
-  if (fd_ >= 0) {
+  } else if (serial_port_->is_open()) {
+    asio::error_code ec;
+    serial_port_->close(ec);
+    fd_ = -1;
+  } else if (fd_ >= 0) {
     ::close(fd_);
     fd_ = -1;
   }
 }
 
-void SerialTransport::readThreadFunc() {
-  std::vector<uint8_t> buffer(1024);
-  while (running_) {
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(fd_, &read_fds);
-
-    // 设置超时
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 100000;  // 100ms
-
-    // 等待数据到达
-    int ret = select(fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
-    if (ret < 0) {
-      if (errno != EINTR) break;  // 错误退出
-    } else if (ret > 0 && FD_ISSET(fd_, &read_fds)) {
-      // 读取数据
-      ssize_t n = read(fd_, buffer.data(), buffer.size());
-      if (n > 0) {
-        std::vector<uint8_t> data(buffer.begin(), buffer.begin() + n);
-        ctx_->io.post([this, data] {
-          if (callback_) callback_(data);  // 触发回调
-        });
-      } else if (n == 0) {
-        // 设备断开
-        break;
-      }
+void SerialTransport::start_read() {
+  if (!running_) return;
+  BufferPool::Handle buffer = rx_pool_->acquire();
+  auto target = asio::buffer(*buffer);
+  serial_port_->async_read_some(target, [this, buffer = std::move(buffer)](const asio::error_code& ec,
+                                                                          size_t n) mutable {
+    on_read(std::move(buffer), ec, n);
+  });
+}
+
+void SerialTransport::on_read(BufferPool::Handle buffer, const asio::error_code& ec, size_t n) {
+  if (ec) {
+    // 主动关闭时为 operation_aborted；其他错误（设备断开等）停止读取
+    if (ec != asio::error::operation_aborted) {
+      std::cout << "read " << port_ << " failed: " << ec.message() << std::endl;
     }
+    return;
+  }
+
+  if (n > 0 && callback_) {
+    buffer->resize(n);
+    callback_(*buffer);  // 触发回调
   }
+  // 缓冲区在这里回到池中，下一次读取复用
+  buffer.reset();
+  start_read();
 }
@@ -6,12 +6,16 @@
 
 #include <asio.hpp>
 #include <atomic>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "transport/buffer_pool.h"
+
 #if 0
 #define START_FRAME_MAGIC_ID (0x00BE0001)
 #define CONTENT_FRAME_MAGIC_ID (0x00000001)
@@ -37,9 +41,19 @@ struct ThreadIoMgr {
   std::thread t;
 };
 
+/**
+ * @brief 串口传输
+ *
+ * 读取是 asio::serial_port 上的异步操作，在 io 线程中完成，不轮询；
+ * 读取直接写入池中的缓冲区，在 io 线程中回调后缓冲区回到池中。
+ *
+ * 所有写入经过同一个发送队列（由 mutex_ 保护），串口上不会交错出现两帧的字节：
+ * send 在队列为空时直接在调用线程写串口（定时命令不经过 io 线程），没写完的
+ * 部分和 async_send 的数据一起排队，由 io 线程按顺序逐个写出并记录已写出的字节数。
+ */
 class SerialTransport {
  public:
-  // 数据接收回调类型
+  // 数据接收回调类型（在 io 线程中调用，data 只在回调期间有效）
   using DataCallback = std::function<void(const std::vector<uint8_t>&)>;
 
   SerialTransport(const std::string& port);
@@ -51,11 +65,12 @@ class SerialTransport {
   SerialTransport& operator=(const SerialTransport&) = delete;
 
   /**
-   * @brief 发送数据
+   * @brief 发送数据：发送队列为空时立即写串口，否则排在已有数据之后
    * @param data 待发送的二进制数据
-   * @return 实际发送的字节数（-1表示失败）
+   * @return 已写出或排队的字节数（-1表示失败）
    */
   int send(const std::vector<uint8_t>& data);
+  int send(const uint8_t* data, size_t len);
 
   /**
    * @brief 注册数据接收回调
@@ -63,29 +78,60 @@ class SerialTransport {
    */
   void setCallback(const DataCallback& callback);
 
+  /**
+   * @brief 启动 io 线程并开始异步读取
+   */
   void start();
   /**
    * @brief 手动关闭串口
    */
   void stop();
 
+  /**
+   * @brief 异步发送（数据拷贝进池中的缓冲区，调用返回后即可复用）
+   */
   void async_send(const std::vector<uint8_t>& data);
+  void async_send(const uint8_t* data, size_t len);
 
+  /**
+   * @brief 打开并配置串口
+   * @param baudrate 波特率
+   * @param retry_times 尝试次数，小于 0 表示一直重试
+   * @return 是否成功
+   */
   bool init(uint32_t baudrate, int retry_times);
 
+  /**
+   * @brief 累计新分配的读写缓冲区数（稳定运行后不再增长）
+   */
+  size_t buffers_allocated() const { return rx_pool_->allocated() + tx_pool_->allocated(); }
+
  private:
   // 串口配置初始化
   bool configure(uint32_t baudrate);
 
-  // 异步读取线程函数
-  void readThreadFunc();
+  // 发起一次异步读取
+  void start_read();
+
+  // 读取完成
+  void on_read(BufferPool::Handle buffer, const asio::error_code& ec, size_t n);
+
+  // 把数据加入发送队列，队列原本为空时通知 io 线程开始写出（需持有 mutex_）
+  void enqueue_locked(const uint8_t* data, size_t len);
+
+  // 写出发送队列头部缓冲区的剩余部分（io 线程）
+  void write_next();
 
   std::string port_;                  // 设备路径
-  int fd_ = -1;                       // 文件描述符
-  std::atomic<bool> running_{false};  // 线程运行标志
-  std::thread read_thread_;           // 异步读取线程
+  int fd_ = -1;                       // 文件描述符（由 serial_port_ 持有）
+  std::atomic<bool> running_{false};  // 读取运行标志
   DataCallback callback_;             // 数据回调
   std::mutex mutex_;                  // 线程安全锁
 
   std::shared_ptr<ThreadIoMgr> ctx_;
+  std::unique_ptr<asio::serial_port> serial_port_;
+  std::shared_ptr<BufferPool> rx_pool_;       // 读缓冲区
+  std::shared_ptr<BufferPool> tx_pool_;       // 异步发送缓冲区
+  std::deque<BufferPool::Handle> tx_queue_;   // 待写出的数据，非空时 io 线程正在写出头部（mutex_）
+  size_t tx_offset_ = 0;                      // 队列头部已写出的字节数（mutex_）
 };
@@ -0,0 +1,193 @@
+// 帧同步灯控调度测试：合成帧时间戳源 + 伪终端代替 /dev/ttyUSB0
+//   1. 时间线估计：设备时间戳抖动、丢帧、传输延迟下的周期与曝光时刻预测
+//   2. 实时调度：每帧预约下一帧曝光后的开灯命令，统计触发抖动和命令到达时刻误差
+#include <fcntl.h>
+#include <poll.h>
+#include <session/session.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string& name) {
+  std::cout << (condition ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+  if (!condition) g_failures++;
+}
+
+void print_summary(const std::string& name, const LatencySamples::Summary& s) {
+  std::cout << "    " << name << ": n=" << s.count << std::fixed << std::setprecision(1) << " mean " << s.mean_us
+            << " us, p50 " << s.p50_us << " us, p99|x| " << s.p99_us << " us, max|x| " << s.max_abs_us << " us"
+            << std::endl;
+}
+
+/**
+ * @brief 合成帧源：真实曝光时刻 t0 + i * period；设备时间戳带抖动且时钟原点不同；
+ *        到达主机的时刻 = 曝光时刻 + 最小延迟 + 随机延迟
+ */
+struct SyntheticFrames {
+  int64_t t0_us;
+  double period_us;
+  uint64_t device_origin_us = 7000000000ULL;  // 设备时钟与主机时钟无关
+  int64_t min_latency_us = 2000;
+  int64_t extra_latency_us = 1500;
+  int64_t device_jitter_us = 20;
+  std::mt19937 rng{42};
+
+  int64_t exposure_us(int64_t i) const { return t0_us + std::llround(i * period_us); }
+  uint64_t device_us(int64_t i) {
+    std::uniform_int_distribution<int64_t> jitter(-device_jitter_us, device_jitter_us);
+    return device_origin_us + std::llround(i * period_us) + jitter(rng);
+  }
+  int64_t arrival_us(int64_t i) {
+    std::uniform_int_distribution<int64_t> extra(0, extra_latency_us);
+    return exposure_us(i) + min_latency_us + extra(rng);
+  }
+};
+
+void test_timeline() {
+  std::cout << "\n1. 时间线估计" << std::endl;
+  LightScheduler::Config config;
+  config.exposure_offset_us = -2000;  // 校准最小传输延迟
+  LightScheduler scheduler(nullptr, config);
+
+  SyntheticFrames source{0, 1000000.0 / 30};
+  int64_t worst_exposure_error = 0;
+  for (int64_t i = 0; i < 600; i++) {
+    if (i % 17 == 16) continue;  // 丢帧
+    scheduler.observe_frame(source.device_us(i), source.arrival_us(i));
+    if (i >= 40) {
+      int64_t error = scheduler.predict_exposure(1) - source.exposure_us(i + 1);
+      worst_exposure_error = std::max(worst_exposure_error, std::abs(error));
+    }
+  }
+
+  check(scheduler.locked(), "锁定帧时间线");
+  std::cout << "    估计周期 " << std::fixed << std::setprecision(3) << scheduler.period_us() << " us（实际 "
+            << source.period_us << "）" << std::endl;
+  check(std::abs(scheduler.period_us() - source.period_us) < 1.0, "丢帧下周期误差小于 1 us");
+  LatencySamples::Summary prediction = scheduler.prediction_error();
+  print_summary("设备时间戳预测误差", prediction);
+  check(prediction.p99_us < 4 * source.device_jitter_us, "预测误差在设备时间戳抖动范围内");
+  std::cout << "    曝光时刻最大误差 " << worst_exposure_error << " us" << std::endl;
+  check(worst_exposure_error < 500, "预测的曝光时刻误差小于 0.5 ms");
+}
+
+struct PtyPair {
+  int master = -1;
+  std::string slave;
+  bool open() {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return false;
+    slave = ptsname(master);
+    return true;
+  }
+  ~PtyPair() {
+    if (master >= 0) ::close(master);
+  }
+};
+
+void test_realtime() {
+  std::cout << "\n2. 实时调度（伪终端）" << std::endl;
+  PtyPair pty;
+  if (!pty.open()) {
+    check(false, "打开伪终端");
+    return;
+  }
+
+  LightScheduler::Config config;
+  config.exposure_offset_us = -2000;
+  Session& session = Session::get_instance();
+  session.init(pty.slave, config);
+  session.start();
+
+  // 主端记录每条命令最后一个字节到达的时刻
+  std::atomic<bool> reading{true};
+  std::vector<int64_t> arrivals;
+  std::mutex arrivals_mutex;
+  std::thread reader([&]() {
+    size_t partial = 0;
+    while (reading) {
+      pollfd pfd = {pty.master, POLLIN, 0};
+      if (poll(&pfd, 1, 20) <= 0) continue;
+      uint8_t buf[256];
+      ssize_t n = ::read(pty.master, buf, sizeof(buf));
+      int64_t now = LightScheduler::monotonic_us();
+      if (n <= 0) continue;
+      partial += n;
+      std::lock_guard<std::mutex> lock(arrivals_mutex);
+      while (partial >= sizeof(LightProtocol)) {
+        arrivals.push_back(now);
+        partial -= sizeof(LightProtocol);
+      }
+    }
+  });
+
+  // 60 fps 合成帧，每帧预约下一帧曝光开始后 1 ms 开灯
+  const int64_t kOffsetUs = 1000;
+  const int64_t kTransmitUs = sizeof(LightProtocol) * 10 * 1000000 / 115200;
+  SyntheticFrames source{LightScheduler::monotonic_us() + 20000, 1000000.0 / 60};
+  std::vector<int64_t> targets;
+  for (int64_t i = 0; i < 150; i++) {
+    int64_t arrival = source.arrival_us(i);
+    uint64_t device = source.device_us(i);
+    while (LightScheduler::monotonic_us() < arrival) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    if (i % 17 == 16) continue;  // 丢帧
+    session.on_frame(device, arrival);
+    if (i >= 10 && session.schedule_light_on(1, kOffsetUs)) {
+      targets.push_back(source.exposure_us(i + 1) + kOffsetUs);
+    }
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  reading = false;
+  reader.join();
+
+  LatencySamples::Summary jitter = session.light_scheduler()->fire_jitter();
+  print_summary("触发抖动（写串口 - 计划时刻）", jitter);
+  check(jitter.count == targets.size() && !targets.empty(), "预约的命令全部触发");
+  check(jitter.p99_us < 1000, "触发抖动 p99 小于 1 ms");
+
+  // 伪终端没有波特率延迟，到达时刻加上发送时间即命令生效时刻
+  LatencySamples end_to_end;
+  {
+    std::lock_guard<std::mutex> lock(arrivals_mutex);
+    check(arrivals.size() == targets.size(), "主端收到全部命令");
+    for (size_t i = 0; i < std::min(arrivals.size(), targets.size()); i++) {
+      end_to_end.add(arrivals[i] + kTransmitUs - targets[i]);
+    }
+  }
+  LatencySamples::Summary error = end_to_end.summary();
+  print_summary("命令生效时刻 - 目标曝光时刻", error);
+  check(error.p99_us < 2000, "端到端误差 p99 小于 2 ms");
+
+  session.stop();
+}
+
+}  // namespace
+
+int main() {
+  std::cout << "=== 帧同步灯控调度测试 ===" << std::endl;
+  test_timeline();
+  test_realtime();
+  if (g_failures == 0) {
+    std::cout << "\n=== 测试全部通过 ===" << std::endl;
+    return 0;
+  }
+  std::cout << "\n=== 测试失败: " << g_failures << " ===" << std::endl;
+  return 1;
+}
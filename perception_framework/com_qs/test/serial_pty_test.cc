@@ -0,0 +1,302 @@
+// 串口传输与 LightProtocol 解析测试：用伪终端对代替 /dev/ttyUSB0
+//   1. 查表 CRC-8 与原逐位实现一致
+//   2. 解析器：任意切分、垃圾数据、CRC 错误、数据中的 0xFF
+//   3. SerialTransport：异步读写、读缓冲区复用、send 与 async_send 并发写入不交错
+//   4. Session：灯控命令字节、回传帧解析
+#include <fcntl.h>
+#include <poll.h>
+#include <session/session.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string& name) {
+  std::cout << (condition ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+  if (!condition) g_failures++;
+}
+
+// 原 session.cc 中的逐位实现，作为参照
+uint8_t reference_crc(const uint8_t* di, uint32_t len) {
+  uint8_t crc_poly = 0x07;
+  uint32_t clen = len + 1;
+  uint8_t cdata;
+  uint8_t data_t = di[0];
+  for (uint32_t i = 1; i < clen; i++) {
+    cdata = di[i];
+    if (i == clen - 1) cdata = 0;
+    for (uint8_t j = 0; j <= 7; j++) {
+      if (data_t & 0x80)
+        data_t = ((data_t << 1) | ((cdata >> (7 - j)) & 0x01)) ^ crc_poly;
+      else
+        data_t = ((data_t << 1) | ((cdata >> (7 - j)) & 0x01));
+    }
+  }
+  return data_t;
+}
+
+LightProtocol make_frame(uint8_t cmd2, uint8_t data1, uint8_t data2) {
+  LightProtocol frame = {kLightSyncByte, 0x1, 0, cmd2, data1, data2, 0};
+  light_protocol_seal(frame);
+  return frame;
+}
+
+const uint8_t* bytes(const LightProtocol& frame) { return reinterpret_cast<const uint8_t*>(&frame); }
+
+struct PtyPair {
+  int master = -1;
+  std::string slave;
+
+  bool open() {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return false;
+    slave = ptsname(master);
+    return true;
+  }
+  ~PtyPair() {
+    if (master >= 0) ::close(master);
+  }
+
+  // 从主端读取 n 字节，超时返回已读到的部分
+  std::vector<uint8_t> read(size_t n, int timeout_ms) {
+    std::vector<uint8_t> out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (out.size() < n) {
+      int left = static_cast<int>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+      pollfd pfd = {master, POLLIN, 0};
+      if (left <= 0 || poll(&pfd, 1, left) <= 0) break;
+      uint8_t buf[256];
+      ssize_t r = ::read(master, buf, std::min(sizeof(buf), n - out.size()));
+      if (r <= 0) break;
+      out.insert(out.end(), buf, buf + r);
+    }
+    return out;
+  }
+
+  void write(const uint8_t* data, size_t len) {
+    while (len > 0) {
+      ssize_t w = ::write(master, data, len);
+      if (w <= 0) return;
+      data += w;
+      len -= w;
+    }
+  }
+};
+
+bool wait_until(const std::function<bool()>& done, int timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void test_crc() {
+  std::cout << "\n1. CRC-8" << std::endl;
+  const char* check_string = "123456789";
+  check(crc8(reinterpret_cast<const uint8_t*>(check_string), 9) == 0xF4, "标准校验值 0xF4");
+
+  std::mt19937 rng(7);
+  bool same = true;
+  for (int i = 0; i < 10000 && same; i++) {
+    uint8_t frame[sizeof(LightProtocol)];
+    for (auto& b : frame) b = static_cast<uint8_t>(rng());
+    same = crc8(frame, 6) == reference_crc(frame, 6);
+  }
+  check(same, "与逐位实现结果一致（10000 个随机帧）");
+}
+
+void test_parser() {
+  std::cout << "\n2. 增量解析" << std::endl;
+  std::vector<LightProtocol> sent;
+  std::vector<bool> after_noise;               // 前面是否插入了噪声
+  std::vector<uint8_t> stream = {0x12, 0x34};  // 开头的垃圾数据
+  std::mt19937 rng(11);
+  for (int i = 0; i < 200; i++) {
+    // 数据字段经常取 0xFF，检验同步字节不依赖数据内容
+    LightProtocol frame = make_frame(static_cast<uint8_t>(i), (i % 3 == 0) ? 0xFF : i, 0xFF);
+    sent.push_back(frame);
+    after_noise.push_back(i % 10 == 6 || i % 10 == 8);
+    stream.insert(stream.end(), bytes(frame), bytes(frame) + sizeof(frame));
+    if (i % 10 == 5) {
+      // 截断的帧：后续帧要从它之后的 0xFF 重新同步
+      stream.insert(stream.end(), bytes(frame), bytes(frame) + 4);
+    }
+    if (i % 10 == 7) {
+      stream.push_back(0xFF);  // 孤立的同步字节
+    }
+  }
+
+  LightFrameParser parser;
+  std::vector<LightProtocol> received;
+  size_t pos = 0;
+  while (pos < stream.size()) {
+    size_t chunk = std::min<size_t>(1 + rng() % 13, stream.size() - pos);
+    parser.feed(stream.data() + pos, chunk, [&received](const LightProtocol& frame) { received.push_back(frame); });
+    pos += chunk;
+  }
+
+  // 帧没有转义，噪声和后一帧拼出的 7 字节有 1/256 的概率通过 CRC，
+  // 这时紧跟噪声的那一帧会丢失；其余帧必须按顺序全部收到
+  size_t next = 0;
+  size_t false_frames = 0;
+  bool ordered = true;
+  for (const LightProtocol& frame : received) {
+    size_t match = next;
+    while (match < sent.size() && std::memcmp(&frame, &sent[match], sizeof(LightProtocol)) != 0) match++;
+    if (match == sent.size()) {
+      false_frames++;
+      continue;
+    }
+    for (size_t skipped = next; skipped < match; skipped++) ordered = ordered && after_noise[skipped];
+    next = match + 1;
+  }
+  check(ordered && next == sent.size(), "任意切分、截断帧和孤立同步字节后各帧按序解析");
+  std::cout << "    CRC 错误 " << parser.crc_errors() << "，丢弃 " << parser.dropped_bytes() << " 字节，误判 "
+            << false_frames << " 帧" << std::endl;
+
+  LightProtocol corrupt = make_frame(1, 2, 3);
+  corrupt.data1 ^= 0x10;
+  LightProtocol good = make_frame(4, 5, 6);
+  size_t count = parser.feed(bytes(corrupt), sizeof(corrupt), nullptr) + parser.feed(bytes(good), sizeof(good), nullptr);
+  check(count == 1, "CRC 错误的帧被丢弃，下一帧正常");
+}
+
+void test_transport() {
+  std::cout << "\n3. SerialTransport（伪终端）" << std::endl;
+  PtyPair pty;
+  if (!pty.open()) {
+    check(false, "打开伪终端");
+    return;
+  }
+
+  SerialTransport serial(pty.slave);
+  check(serial.init(115200, 1), "打开并配置串口");
+
+  LightFrameParser parser;
+  std::atomic<size_t> frames{0};
+  serial.setCallback([&](const std::vector<uint8_t>& data) {
+    parser.feed(data.data(), data.size(), [&frames](const LightProtocol&) { frames++; });
+  });
+  serial.start();
+
+  const size_t kFrames = 2000;
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < kFrames; i++) {
+    LightProtocol frame = make_frame(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0xFF);
+    stream.insert(stream.end(), bytes(frame), bytes(frame) + sizeof(frame));
+  }
+  std::mt19937 rng(3);
+  for (size_t pos = 0; pos < stream.size();) {
+    size_t chunk = std::min<size_t>(1 + rng() % 64, stream.size() - pos);
+    pty.write(stream.data() + pos, chunk);
+    pos += chunk;
+  }
+  check(wait_until([&] { return frames == kFrames; }, 3000), "主端分段写入的帧全部解析");
+
+  size_t allocated = serial.buffers_allocated();
+  std::cout << "    读写缓冲区累计分配 " << allocated << " 个" << std::endl;
+  check(allocated <= 2, "读缓冲区循环复用");
+
+  // 异步发送按顺序写出
+  std::vector<uint8_t> expected;
+  for (int i = 0; i < 100; i++) {
+    LightProtocol frame = make_frame(static_cast<uint8_t>(i), 0, 1);
+    serial.async_send(bytes(frame), sizeof(frame));
+    expected.insert(expected.end(), bytes(frame), bytes(frame) + sizeof(frame));
+  }
+  check(pty.read(expected.size(), 2000) == expected, "异步发送的数据按顺序到达");
+
+  // send 与 async_send 同时写；主端在写完后才读取，数据超过伪终端缓冲区，出现部分写入
+  const int kEach = 10000;
+  std::thread direct([&] {
+    for (int i = 0; i < kEach; i++) {
+      LightProtocol frame = make_frame(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0xA);
+      serial.send(bytes(frame), sizeof(frame));
+    }
+  });
+  std::thread queued([&] {
+    for (int i = 0; i < kEach; i++) {
+      LightProtocol frame = make_frame(static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0xB);
+      serial.async_send(bytes(frame), sizeof(frame));
+    }
+  });
+  direct.join();
+  queued.join();
+  std::vector<uint8_t> mixed = pty.read(2 * kEach * sizeof(LightProtocol), 5000);
+  int next_direct = 0;
+  int next_queued = 0;
+  bool ordered = true;
+  LightFrameParser mixed_parser;
+  mixed_parser.feed(mixed.data(), mixed.size(), [&](const LightProtocol& frame) {
+    int& next = frame.data2 == 0xA ? next_direct : next_queued;
+    ordered = ordered && frame.cmd2 == static_cast<uint8_t>(next) && frame.data1 == static_cast<uint8_t>(next >> 8);
+    next++;
+  });
+  check(next_direct == kEach && next_queued == kEach && ordered, "并发写入的帧完整且各自按顺序到达");
+
+  serial.stop();
+}
+
+void test_session() {
+  std::cout << "\n4. Session" << std::endl;
+  PtyPair pty;
+  if (!pty.open()) {
+    check(false, "打开伪终端");
+    return;
+  }
+
+  Session& session = Session::get_instance();
+  session.init(pty.slave);
+  std::atomic<int> acks{0};
+  session.set_light_frame_handler([&acks](const LightProtocol& frame) {
+    if (frame.cmd2 == 9) acks++;
+  });
+  session.start();
+
+  session.control_light_on();
+  uint8_t expected[sizeof(LightProtocol)] = {0xFF, 0x1, 0, 9, 0, 1, 0};
+  expected[6] = reference_crc(expected, 6);
+  std::vector<uint8_t> sent = pty.read(sizeof(expected), 2000);
+  check(sent == std::vector<uint8_t>(expected, expected + sizeof(expected)), "开灯命令字节与原实现一致");
+
+  // 灯控板回传（中间夹杂噪声）
+  const uint8_t noise[] = {0x00, 0xFF, 0x13};
+  pty.write(noise, sizeof(noise));
+  pty.write(expected, sizeof(expected));
+  check(wait_until([&] { return acks == 1; }, 2000), "回传帧经解析器送达处理函数");
+
+  session.stop();
+}
+
+}  // namespace
+
+int main() {
+  std::cout << "=== 串口传输测试 ===" << std::endl;
+  test_crc();
+  test_parser();
+  test_transport();
+  test_session();
+  if (g_failures == 0) {
+    std::cout << "\n=== 测试全部通过 ===" << std::endl;
+    return 0;
+  }
+  std::cout << "\n=== 测试失败: " << g_failures << " ===" << std::endl;
+  return 1;
+}
@@ -3,7 +3,9 @@
 // =================== 构造函数 ===================
 
 ConfigHelper::ConfigHelper() {
-    // 构造函数中可以进行额外的初始化
+    // 保证 current() 始终有可用的快照
+    resetToDefaults();
+    
     if(!validateAll()) {
         LOG_WARN("Warning: Default configuration validation failed!");
     }
@@ -22,9 +24,14 @@ bool ConfigHelper::RenderConfig::validate() const {
 }
 
 bool ConfigHelper::SaveConfig::validate() const {
-    return !dumpPath.empty() && maxFramesToSave > 0 &&
+    return !dumpPath.empty() && maxFramesToSave >= 0 &&
+           filesPerDir > 0 && timeBucketMinutes > 0 && dumpQuotaMB >= 0 &&
            (imageFormat == "png" || imageFormat == "jpg" || imageFormat == "bmp") &&
-           frameInterval > 0;
+           (depthEncoding == "png" || depthEncoding == "rvl") &&
+           (metadataFormat == "columnar" || metadataFormat == "text") && metadataFlushIntervalMs >= 0 &&
+           (writerBackend == "threadpool" || writerBackend == "io_uring") && writerMaxInFlight > 0 &&
+           frameInterval > 0 && preTriggerSeconds >= 0.0 && postTriggerSeconds >= 0.0 &&
+           triggerBufferMaxMB > 0;
 }
 
 bool ConfigHelper::MetadataConfig::validate() const {
@@ -43,7 +50,19 @@ bool ConfigHelper::ParallelConfig::validate() const {
 
 bool ConfigHelper::InferenceConfig::validate() const {
     return inferenceInterval > 0 && defaultThreshold >= 0.0f && 
-           defaultThreshold <= 1.0f && maxQueueSize > 0;
+           defaultThreshold <= 1.0f && maxQueueSize > 0 && pipelineQueueSize > 0 &&
+           maxInferenceInterval >= inferenceInterval && targetLatencyMs > 0.0 &&
+           targetCpuShare > 0.0 && targetCpuShare <= 1.0 &&
+           (rateControlMode == "fixed" || rateControlMode == "latency" || rateControlMode == "cpu") &&
+           nmsThreshold >= 0.0f && nmsThreshold <= 1.0f && softNmsSigma > 0.0f &&
+           maxDetections >= 0 &&
+           (defaultEngineType == "onnx" || defaultEngineType == "opencv" || defaultEngineType == "auto") &&
+           trackerIouThreshold > 0.0f && trackerIouThreshold <= 1.0f &&
+           trackerMaxAge >= 0 && trackerMinHits > 0 &&
+           trackerFlowScale > 0.0f && trackerFlowScale <= 1.0f &&
+           tileSize >= 0 && tileOverlap >= 0.0f && tileOverlap <= 0.9f && tileWorkers >= 0 &&
+           (nmsMethod == "hard" || nmsMethod == "soft_linear" ||
+            nmsMethod == "soft_gaussian" || nmsMethod == "diou");
 }
 
 bool ConfigHelper::InferenceConfig::isValid() const {
@@ -52,16 +71,28 @@ bool ConfigHelper::InferenceConfig::isValid() const {
 
 bool ConfigHelper::CalibrationConfig::validate() const {
     return boardWidth > 0 && boardHeight > 0 && squareSize > 0 && 
-           minValidFrames > 0 && maxFrames >= minValidFrames && minInterval > 0;
+           minValidFrames > 0 && maxFrames >= minValidFrames && minInterval > 0 &&
+           minViewDistance >= 0.0 && convergenceThreshold >= 0.0;
 }
 
 bool ConfigHelper::LoggerConfig::validate() const {
     return (!enableFileLogging || !logDirectory.empty());
 }
 
+bool ConfigHelper::CommunicationConfig::validate() const {
+    return !commPath.empty() && heartbeatInterval > 0 && (transport == "fifo" || transport == "uds") &&
+           (!streamResults || binaryFraming) &&
+           (!enableSharedMemory || (!shmPrefix.empty() && shmPrefix.find('/') == std::string::npos &&
+                                    shmSlotCount >= 2 && shmSlotCount <= 64 &&
+                                    (shmDepthEncoding == "raw" || shmDepthEncoding == "rvl")));
+}
+
 // =================== 日志系统实现 ===================
 
 bool ConfigHelper::initializeLogger() {
+    auto snapshot = current();
+    const LoggerConfig& loggerConfig = snapshot->loggerConfig;
+    
     // 使用新的Logger高级接口，将所有目录管理交给Logger处理
     bool success = Logger::getInstance().initializeAdvanced(
         loggerConfig.logLevel,          // 日志级别
@@ -82,26 +113,90 @@ bool ConfigHelper::initializeLogger() {
 }
 
 void ConfigHelper::configureLogger(Logger::Level level, bool enableFile) {
-    loggerConfig.logLevel = level;
-    loggerConfig.enableFileLogging = enableFile;
+    update([level, enableFile](Snapshot& snapshot) {
+        snapshot.loggerConfig.logLevel = level;
+        snapshot.loggerConfig.enableFileLogging = enableFile;
+    });
     initializeLogger();
 }
 
 // =================== 配置管理实现 ===================
 
 bool ConfigHelper::validateAll() const {
-    return streamConfig.validate() && 
-           renderConfig.validate() && 
-           saveConfig.validate() && 
-           metadataConfig.validate() && 
-           hotPlugConfig.validate() && 
+    return current()->validateAll();
+}
+
+// =================== 配置快照实现 ===================
+
+bool ConfigHelper::Snapshot::validateAll() const {
+    return streamConfig.validate() &&
+           renderConfig.validate() &&
+           saveConfig.validate() &&
+           metadataConfig.validate() &&
+           hotPlugConfig.validate() &&
            parallelConfig.validate() &&
            inferenceConfig.validate() &&
            calibrationConfig.validate() &&
-           loggerConfig.validate();
+           loggerConfig.validate() &&
+           communicationConfig.validate();
+}
+
+void ConfigHelper::Snapshot::applyLiveSettings(const Snapshot& source) {
+    const SaveConfig& save = source.saveConfig;
+    saveConfig.enableDump = save.enableDump;
+    saveConfig.saveColor = save.saveColor;
+    saveConfig.saveDepth = save.saveDepth;
+    saveConfig.saveDepthColormap = save.saveDepthColormap;
+    saveConfig.saveDepthData = save.saveDepthData;
+    saveConfig.saveIR = save.saveIR;
+    saveConfig.saveMetadata = save.saveMetadata;
+    saveConfig.enableMetadataConsole = save.enableMetadataConsole;
+    saveConfig.depthEncoding = save.depthEncoding;
+    saveConfig.frameInterval = save.frameInterval;
+    saveConfig.triggerOnDetection = save.triggerOnDetection;
+
+    const InferenceConfig& inference = source.inferenceConfig;
+    inferenceConfig.inferenceInterval = inference.inferenceInterval;
+    inferenceConfig.rateControlMode = inference.rateControlMode;
+    inferenceConfig.targetLatencyMs = inference.targetLatencyMs;
+    inferenceConfig.targetCpuShare = inference.targetCpuShare;
+    inferenceConfig.maxInferenceInterval = inference.maxInferenceInterval;
+    inferenceConfig.defaultThreshold = inference.defaultThreshold;
+    inferenceConfig.enablePerformanceStats = inference.enablePerformanceStats;
+
+    renderConfig.windowTitle = source.renderConfig.windowTitle;
+    renderConfig.showFPS = source.renderConfig.showFPS;
+}
+
+uint64_t ConfigHelper::update(const std::function<void(Snapshot&)>& mutator) {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    auto snapshot = std::make_shared<Snapshot>(*current());
+    mutator(*snapshot);
+    return install(std::move(snapshot));
+}
+
+uint64_t ConfigHelper::install(std::shared_ptr<Snapshot> snapshot) {
+    SnapshotPtr previous = std::atomic_load(&current_);
+    snapshot->version = previous ? previous->version + 1 : 1;
+    uint64_t version = snapshot->version;
+    
+    std::atomic_store(&current_, SnapshotPtr(std::move(snapshot)));
+    return version;
 }
 
 void ConfigHelper::printConfig() const {
+    auto snapshot = current();
+    const StreamConfig& streamConfig = snapshot->streamConfig;
+    const RenderConfig& renderConfig = snapshot->renderConfig;
+    const SaveConfig& saveConfig = snapshot->saveConfig;
+    const MetadataConfig& metadataConfig = snapshot->metadataConfig;
+    const HotPlugConfig& hotPlugConfig = snapshot->hotPlugConfig;
+    const ParallelConfig& parallelConfig = snapshot->parallelConfig;
+    const InferenceConfig& inferenceConfig = snapshot->inferenceConfig;
+    const CalibrationConfig& calibrationConfig = snapshot->calibrationConfig;
+    const LoggerConfig& loggerConfig = snapshot->loggerConfig;
+    const CommunicationConfig& communicationConfig = snapshot->communicationConfig;
+    
     LOG_INFO("=== Current Configuration ===");
     LOG_INFO("Stream: Color=", streamConfig.enableColor, 
              ", Depth=", streamConfig.enableDepth, 
@@ -115,10 +210,24 @@ void ConfigHelper::printConfig() const {
              ", Color=", saveConfig.saveColor,
              ", Depth=", saveConfig.saveDepth,
              ", IR=", saveConfig.saveIR,
+             ", DepthEncoding=", saveConfig.depthEncoding,
              ", Metadata=", saveConfig.saveMetadata,
+             ", MetadataFormat=", saveConfig.metadataFormat,
              ", MetadataConsole=", saveConfig.enableMetadataConsole,
              ", Interval=", saveConfig.frameInterval,
+             ", MaxFrames=", saveConfig.maxFramesToSave,
+             ", FilesPerDir=", saveConfig.filesPerDir,
+             ", QuotaMB=", saveConfig.dumpQuotaMB,
              ", FrameStats=", saveConfig.enableFrameStats);
+    LOG_INFO("Dump Writer: Backend=", saveConfig.writerBackend,
+             ", MaxInFlight=", saveConfig.writerMaxInFlight,
+             ", DirectIO=", saveConfig.writerDirectIO,
+             ", Sync=", saveConfig.writerSync);
+    LOG_INFO("Trigger Record: Enabled=", saveConfig.enableTriggerRecord,
+             ", Pre=", saveConfig.preTriggerSeconds, "s",
+             ", Post=", saveConfig.postTriggerSeconds, "s",
+             ", BufferMB=", saveConfig.triggerBufferMaxMB,
+             ", OnDetection=", saveConfig.triggerOnDetection);
     LOG_INFO("Metadata Format: ShowTimestamp=", metadataConfig.showTimestamp,
              ", ShowFrameNumber=", metadataConfig.showFrameNumber,
              ", ShowDeviceInfo=", metadataConfig.showDeviceInfo);
@@ -131,7 +240,19 @@ void ConfigHelper::printConfig() const {
     LOG_INFO("Inference: Enabled=", inferenceConfig.enableInference,
              ", DefaultModel=", inferenceConfig.defaultModel,
              ", DefaultModelType=", inferenceConfig.defaultModelType,
+             ", DefaultEngineType=", inferenceConfig.defaultEngineType,
              ", DefaultThreshold=", inferenceConfig.defaultThreshold,
+             ", NMS=", inferenceConfig.nmsMethod, "@", inferenceConfig.nmsThreshold,
+             ", ClassAwareNMS=", inferenceConfig.classAwareNMS,
+             ", MaxDetections=", inferenceConfig.maxDetections,
+             ", Pipeline=", inferenceConfig.enablePipeline,
+             ", MmapModels=", inferenceConfig.useMmapModels,
+             ", ModelCache=", inferenceConfig.enableModelCache,
+             ", RateControl=", inferenceConfig.rateControlMode,
+             ", Tracking=", inferenceConfig.enableTracking,
+             ", TrackerOpticalFlow=", inferenceConfig.trackerOpticalFlow,
+             ", Tiling=", inferenceConfig.enableTiling,
+             ", TileOverlap=", inferenceConfig.tileOverlap,
              ", PerformanceStats=", inferenceConfig.enablePerformanceStats);
     LOG_INFO("Calibration: Enabled=", calibrationConfig.enableCalibration,
              ", BoardWidth=", calibrationConfig.boardWidth,
@@ -139,20 +260,23 @@ void ConfigHelper::printConfig() const {
              ", SquareSize=", calibrationConfig.squareSize,
              ", MinValidFrames=", calibrationConfig.minValidFrames,
              ", MaxFrames=", calibrationConfig.maxFrames,
-             ", MinInterval=", calibrationConfig.minInterval);
+             ", MinInterval=", calibrationConfig.minInterval,
+             ", MinViewDistance=", calibrationConfig.minViewDistance,
+             ", ConvergenceThreshold=", calibrationConfig.convergenceThreshold);
+    LOG_INFO("Communication: Enabled=", communicationConfig.enableCommunication,
+             ", Transport=", communicationConfig.transport,
+             ", HeartbeatInterval=", communicationConfig.heartbeatInterval,
+             ", BinaryFraming=", communicationConfig.binaryFraming,
+             ", SharedMemory=", communicationConfig.enableSharedMemory,
+             ", ShmSlots=", communicationConfig.shmSlotCount,
+             ", ShmDepthEncoding=", communicationConfig.shmDepthEncoding,
+             ", StreamResults=", communicationConfig.streamResults);
     LOG_INFO("Logger: Level=", static_cast<int>(loggerConfig.logLevel),
              ", FileLogging=", loggerConfig.enableFileLogging ? "enabled" : "disabled");
     LOG_INFO("============================");
 }
 
 void ConfigHelper::resetToDefaults() {
-    streamConfig = StreamConfig{};
-    renderConfig = RenderConfig{};
-    saveConfig = SaveConfig{};
-    metadataConfig = MetadataConfig{};
-    hotPlugConfig = HotPlugConfig{};
-    parallelConfig = ParallelConfig{};
-    inferenceConfig = InferenceConfig{};
-    calibrationConfig = CalibrationConfig{};
-    loggerConfig = LoggerConfig{};
-} 
\ No newline at end of file
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    install(std::make_shared<Snapshot>());
+}
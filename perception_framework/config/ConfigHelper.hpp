@@ -8,11 +8,19 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include "Logger.hpp"
 
 /**
  * @brief 配置管理器 - 单例模式
  * 提供应用程序的所有配置选项，支持配置验证和持久化
+ *
+ * 配置只保存在不可变快照中：读取统一通过 current()，修改（启动时设置、
+ * 配置文件加载与热加载、运行时命令）都通过 update() 生成新版本的快照。
  */
 class ConfigHelper {
 public:
@@ -39,7 +47,7 @@ public:
         int depthFPS = 30;                   // 深度流帧率
         
         bool validate() const;
-    } streamConfig;
+    };
 
     // 渲染配置
     struct RenderConfig {
@@ -51,7 +59,7 @@ public:
         std::string windowTitle = "Orbbec Camera Demo";  // 窗口标题
         
         bool validate() const;
-    } renderConfig;
+    };
 
     // 数据保存配置
     struct SaveConfig {
@@ -63,15 +71,34 @@ public:
         bool saveDepthData = true;           // 保存深度数据的纯数字格式(CSV)
         bool saveIR = true;                  // 保存红外图像
         bool savePointCloud = false;         // 保存点云数据
-        bool saveMetadata = true;            // 保存元数据为txt文件
+        bool saveMetadata = true;            // 保存元数据
+        std::string metadataFormat = "columnar"; // 元数据保存格式: "columnar"(每个数据流一个二进制日志) 或 "text"(每帧一个txt文件)
+        int metadataFlushIntervalMs = 1000;  // 列式元数据日志刷新间隔(毫秒)
         bool enableMetadataConsole = false;  // 启用元数据控制台显示
         std::string imageFormat = "png";     // 图像格式
-        int maxFramesToSave = 1000;          // 最大保存帧数
+        std::string depthEncoding = "png";   // 深度图编码: "png"(16位PNG) 或 "rvl"(无损RVL, 更快更小)
+        int maxFramesToSave = 1000;          // 每个会话最大保存帧数（0 表示不限制）
+        int filesPerDir = 1000;              // 每个分片目录的文件数上限
+        int timeBucketMinutes = 10;          // 时间桶目录长度(分钟)
+        int dumpQuotaMB = 0;                 // 会话磁盘配额(MB)，超出时删除最旧的分片目录（0 表示不限制）
         int frameInterval = 200;             // 统一帧间隔（保存、元数据文件、元数据控制台显示）
         bool enableFrameStats = false;       // 启用帧统计信息
         
+        // 写盘后端
+        std::string writerBackend = "threadpool"; // 写盘后端: "threadpool" 或 "io_uring"(不可用时自动回退)
+        int writerMaxInFlight = 16;          // 最大在途写请求数
+        bool writerDirectIO = true;          // 大文件使用 O_DIRECT（仅 io_uring）
+        bool writerSync = false;             // 每个文件关闭前执行 fdatasync
+        
+        // 触发式录制（保存事件前后的帧）
+        bool enableTriggerRecord = false;    // 启用触发式录制
+        double preTriggerSeconds = 2.0;      // 触发前保留时长(秒)
+        double postTriggerSeconds = 3.0;     // 触发后录制时长(秒)
+        int triggerBufferMaxMB = 256;        // 环形缓冲/写盘队列内存上限(MB)
+        bool triggerOnDetection = false;     // 检测到目标时自动触发
+        
         bool validate() const;
-    } saveConfig;
+    };
 
     // 元数据显示格式配置（显示间隔由SaveConfig.frameInterval统一控制）
     struct MetadataConfig {
@@ -80,7 +107,7 @@ public:
         bool showDeviceInfo = true;          // 显示设备信息
         
         bool validate() const;
-    } metadataConfig;
+    };
 
     // 热插拔配置
     struct HotPlugConfig {
@@ -93,7 +120,7 @@ public:
         bool waitForDeviceOnStartup = true;  // 启动时等待设备连接
         
         bool validate() const;
-    } hotPlugConfig;
+    };
 
     // 并行处理配置
     struct ParallelConfig {
@@ -102,27 +129,52 @@ public:
         int maxQueuedTasks = 100;                // 最大排队任务数
         
         bool validate() const;
-    } parallelConfig;
+    };
 
     // 推理配置
     struct InferenceConfig {
         bool enableInference = false;              // 是否启用推理
         std::string defaultModel = "";             // 默认模型路径
         std::string defaultModelType = "";         // 默认模型类型
+        std::string defaultEngineType = "onnx";    // 默认推理后端: "onnx", "opencv", "auto"(加载时测试并选择最快的后端)
         float defaultThreshold = 0.5f;             // 默认置信度阈值
         bool enableVisualization = true;           // 是否启用可视化
         bool enablePerformanceStats = false;       // 是否启用性能统计
-        int inferenceInterval = 1;                 // 推理间隔（每N帧推理一次）
+        int inferenceInterval = 1;                 // 推理间隔（每N帧推理一次；自适应模式下为最小间隔）
+        std::string rateControlMode = "fixed";     // 推理频率控制: "fixed"(固定间隔), "latency"(延迟预算), "cpu"(CPU占用)
+        double targetLatencyMs = 100.0;            // latency模式：端到端延迟预算（毫秒）
+        double targetCpuShare = 0.5;               // cpu模式：推理占用单核时间的比例 (0, 1]
+        int maxInferenceInterval = 30;             // 自适应模式的最大推理间隔
         std::string classNamesFile = "";           // 类别名称文件路径
         bool asyncInference = true;                // 是否异步推理
-        int maxQueueSize = 10;                     // 异步推理队列最大大小
+        int maxQueueSize = 10;                     // 异步推理最多同时排队的模型数（每个模型只保留最新一帧）
+        bool enablePipeline = false;               // 异步推理使用三级流水线（预处理/推理/后处理各一个线程）
+        int pipelineQueueSize = 2;                 // 流水线各阶段之间的队列大小
         std::string modelsDirectory = "./models/"; // 模型目录
+        bool useMmapModels = true;                 // 以内存映射方式加载模型文件（多进程共享权重页）
+        bool enableModelCache = true;              // 在模型目录的 .cache 下缓存优化后的模型
         bool enableFramePreprocessing = true;      // 是否启用帧预处理
         bool onlyProcessColorFrames = true;        // 是否只处理彩色帧
+        float nmsThreshold = 0.5f;                 // NMS IoU阈值
+        std::string nmsMethod = "hard";            // NMS方法: "hard", "soft_linear", "soft_gaussian", "diou"
+        float softNmsSigma = 0.5f;                 // 高斯Soft-NMS参数
+        bool classAwareNMS = true;                 // 只在同类别检测框之间抑制
+        int maxDetections = 0;                     // 每帧最大检测框数（0表示不限制）
+        bool enableTracking = false;               // 启用目标跟踪（跳过推理的帧输出预测框）
+        float trackerIouThreshold = 0.3f;          // 跟踪匹配所需最小IoU
+        int trackerMaxAge = 5;                     // 连续未匹配的检测次数超过该值后删除目标
+        int trackerMinHits = 2;                    // 匹配次数达到该值后才输出目标
+        bool trackerOpticalFlow = false;           // 跳过推理的帧用稀疏光流校正预测框
+        float trackerFlowScale = 0.25f;            // 光流图像缩放比例 (0, 1]
+        bool enableTiling = false;                 // 检测模型分块推理（高分辨率帧切成重叠的小块并行推理）
+        int tileSize = 0;                          // 分块边长（0表示使用模型输入尺寸）
+        float tileOverlap = 0.2f;                  // 相邻分块的重叠比例 [0, 0.9]
+        bool tileFullFrame = true;                 // 额外推理一次缩放后的整帧（检测跨越多个分块的大目标）
+        int tileWorkers = 0;                       // 并行推理的引擎副本数（0表示CPU核数）
         
         bool validate() const;
         bool isValid() const; // 兼容 InferenceManager 的命名
-    } inferenceConfig;
+    };
 
     // 相机标定配置
     struct CalibrationConfig {
@@ -134,13 +186,16 @@ public:
         int maxFrames = 50;                           // 最大采集帧数
         double minInterval = 1.0;                     // 采集间隔（秒）
         bool useSubPixel = true;                      // 是否使用亚像素精度
+        double minViewDistance = 0.15;                // 新视角与已采集视角的最小位姿差异（位置/尺度/倾斜的归一化距离）
+        bool incrementalCalibration = true;           // 每采集一个视角更新一次内参估计
+        double convergenceThreshold = 0.005;          // 内参相对变化连续低于该值时提前结束采集（0表示采满maxFrames）
         bool enableUndistortion = true;               // 是否启用去畸变
         std::string saveDirectory = "./calibration/"; // 保存目录
         bool autoStartCalibrationOnStartup = false;   // 启动时自动开始标定
         bool showCalibrationProgress = true;          // 显示标定进度
         
         bool validate() const;
-    } calibrationConfig;
+    };
 
     // 日志系统配置 - 简化版本
     struct LoggerConfig {
@@ -150,17 +205,81 @@ public:
         std::string logDirectory = "./logs/";             // 日志目录
         
         bool validate() const;
-    } loggerConfig;
+    };
 
     // 通信配置
     struct CommunicationConfig {
         bool enableCommunication = true;             // 是否启用通信
         std::string commPath = "/tmp/perception_";   // 通信管道基础路径
+        std::string transport = "fifo";              // 传输方式："fifo"（命名管道，一对一）或 "uds"（Unix 域套接字，多客户端）
         int heartbeatInterval = 1000;                // 心跳间隔(毫秒)
-    } communicationConfig;
+        bool binaryFraming = true;                   // 与对方协商后使用二进制帧（否则只用文本格式）
+        bool enableSharedMemory = false;             // 通过共享内存环向本机其他进程发布帧和检测结果
+        std::string shmPrefix = "perception_";       // 共享内存名称前缀（后接 color/depth/ir/results）
+        int shmSlotCount = 4;                        // 每个共享内存环的槽位数
+        std::string shmDepthEncoding = "raw";        // 共享内存深度流编码："raw"（Y16 原始数据）或 "rvl"（无损RVL，format 为 OB_FORMAT_RVL）
+        bool streamResults = false;                  // 推理结果编码为二进制记录，以 DATA 消息推送给对端（需要二进制帧）
+        
+        bool validate() const;
+    };
 
     /**
-     * @brief 初始化日志系统
+     * @brief 不可变配置快照
+     *
+     * 已发布的快照不再修改，读取方无需加锁。热路径组件可以记录 version，
+     * 版本变化时才重新计算由配置派生的状态。
+     */
+    struct Snapshot {
+        uint64_t version = 0;                 // 发布顺序编号，从 1 开始
+        StreamConfig streamConfig;
+        RenderConfig renderConfig;
+        SaveConfig saveConfig;
+        MetadataConfig metadataConfig;
+        HotPlugConfig hotPlugConfig;
+        ParallelConfig parallelConfig;
+        InferenceConfig inferenceConfig;
+        CalibrationConfig calibrationConfig;
+        LoggerConfig loggerConfig;
+        CommunicationConfig communicationConfig;
+
+        bool validateAll() const;
+
+        /**
+         * @brief 从 source 复制可以在运行中生效的设置，其余字段保持不变
+         *
+         * 包括：保存开关与各类型保存选项、帧间隔、深度编码、元数据控制台、
+         * 检测触发录制；推理间隔与频率控制参数、默认模型置信度阈值、性能统计；
+         * 窗口标题与 FPS 显示。流配置、写盘后端、保存路径、线程池等需要重启才能生效。
+         */
+        void applyLiveSettings(const Snapshot& source);
+    };
+
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    /**
+     * @brief 当前快照（一次原子读取）
+     * 持有返回的指针期间快照保持有效；发布新版本后，旧快照在最后一个持有者释放时销毁
+     */
+    SnapshotPtr current() const {
+        return std::atomic_load(&current_);
+    }
+
+    /**
+     * @brief 当前快照的版本号
+     */
+    uint64_t version() const {
+        return current()->version;
+    }
+
+    /**
+     * @brief 复制当前快照、修改后发布为新快照（多个写入方串行执行）
+     * @param mutator 修改快照副本的函数
+     * @return 新快照的版本号
+     */
+    uint64_t update(const std::function<void(Snapshot&)>& mutator);
+
+    /**
+     * @brief 按当前快照的日志配置初始化日志系统
      */
     bool initializeLogger();
 
@@ -173,7 +292,7 @@ public:
                         bool enableFile = true);
 
     /**
-     * @brief 验证所有配置的有效性
+     * @brief 验证当前快照中所有配置的有效性
      * @return true if all configurations are valid
      */
     bool validateAll() const;
@@ -184,7 +303,7 @@ public:
     void printConfig() const;
 
     /**
-     * @brief 重置为默认配置
+     * @brief 发布默认配置的快照
      */
     void resetToDefaults();
 
@@ -193,4 +312,12 @@ private:
     ~ConfigHelper() = default;
     ConfigHelper(const ConfigHelper&) = delete;
     ConfigHelper& operator=(const ConfigHelper&) = delete;
+
+    /**
+     * @brief 设置版本号并发布快照（调用方持有 publishMutex_）
+     */
+    uint64_t install(std::shared_ptr<Snapshot> snapshot);
+
+    std::mutex publishMutex_;
+    SnapshotPtr current_;           ///< 用 std::atomic_load/atomic_store 访问
 }; 
\ No newline at end of file
@@ -6,53 +6,32 @@
 
 bool ConfigParser::loadFromFile(const std::string& filepath) {
     try {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open config file: " << filepath << std::endl;
-            return false;
-        }
-        
-        Json::CharReaderBuilder builder;
         Json::Value root;
-        std::string errs;
-        
-        if (!Json::parseFromStream(builder, file, &root, &errs)) {
-            std::cerr << "Failed to parse JSON: " << errs << std::endl;
+        if (!readFile(filepath, root)) {
             return false;
         }
         
-        auto& configHelper = ConfigHelper::getInstance();
+        ConfigHelper::getInstance().update([&root](ConfigHelper::Snapshot& snapshot) {
+            parseSections(root, snapshot);
+        });
         
-        // 解析各个配置段
-        if (root.isMember("stream")) {
-            parseStreamConfig(root["stream"], configHelper.streamConfig);
-        }
-        if (root.isMember("render")) {
-            parseRenderConfig(root["render"], configHelper.renderConfig);
-        }
-        if (root.isMember("save")) {
-            parseSaveConfig(root["save"], configHelper.saveConfig);
-        }
-        if (root.isMember("metadata")) {
-            parseMetadataConfig(root["metadata"], configHelper.metadataConfig);
-        }
-        if (root.isMember("hotplug")) {
-            parseHotPlugConfig(root["hotplug"], configHelper.hotPlugConfig);
-        }
-        if (root.isMember("parallel")) {
-            parseParallelConfig(root["parallel"], configHelper.parallelConfig);
-        }
-        if (root.isMember("inference")) {
-            parseInferenceConfig(root["inference"], configHelper.inferenceConfig);
-        }
-        if (root.isMember("calibration")) {
-            parseCalibrationConfig(root["calibration"], configHelper.calibrationConfig);
-        }
-        if (root.isMember("logger")) {
-            parseLoggerConfig(root["logger"], configHelper.loggerConfig);
+        std::cout << "Configuration loaded successfully from: " << filepath << std::endl;
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading config: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool ConfigParser::loadSnapshotFromFile(const std::string& filepath, ConfigHelper::Snapshot& snapshot) {
+    try {
+        Json::Value root;
+        if (!readFile(filepath, root)) {
+            return false;
         }
         
-        std::cout << "Configuration loaded successfully from: " << filepath << std::endl;
+        parseSections(root, snapshot);
         return true;
     }
     catch (const std::exception& e) {
@@ -63,18 +42,7 @@ bool ConfigParser::loadFromFile(const std::string& filepath) {
 
 bool ConfigParser::saveToFile(const std::string& filepath) {
     try {
-        auto& configHelper = ConfigHelper::getInstance();
-        
-        Json::Value root;
-        root["stream"] = streamConfigToJson(configHelper.streamConfig);
-        root["render"] = renderConfigToJson(configHelper.renderConfig);
-        root["save"] = saveConfigToJson(configHelper.saveConfig);
-        root["metadata"] = metadataConfigToJson(configHelper.metadataConfig);
-        root["hotplug"] = hotPlugConfigToJson(configHelper.hotPlugConfig);
-        root["parallel"] = parallelConfigToJson(configHelper.parallelConfig);
-        root["inference"] = inferenceConfigToJson(configHelper.inferenceConfig);
-        root["calibration"] = calibrationConfigToJson(configHelper.calibrationConfig);
-        root["logger"] = loggerConfigToJson(configHelper.loggerConfig);
+        Json::Value root = sectionsToJson(*ConfigHelper::getInstance().current());
         
         Json::StreamWriterBuilder builder;
         builder["indentation"] = "  ";
@@ -108,36 +76,9 @@ bool ConfigParser::loadFromString(const std::string& jsonStr) {
             return false;
         }
         
-        auto& configHelper = ConfigHelper::getInstance();
-        
-        // 解析各个配置段（与 loadFromFile 相同逻辑）
-        if (root.isMember("stream")) {
-            parseStreamConfig(root["stream"], configHelper.streamConfig);
-        }
-        if (root.isMember("render")) {
-            parseRenderConfig(root["render"], configHelper.renderConfig);
-        }
-        if (root.isMember("save")) {
-            parseSaveConfig(root["save"], configHelper.saveConfig);
-        }
-        if (root.isMember("metadata")) {
-            parseMetadataConfig(root["metadata"], configHelper.metadataConfig);
-        }
-        if (root.isMember("hotplug")) {
-            parseHotPlugConfig(root["hotplug"], configHelper.hotPlugConfig);
-        }
-        if (root.isMember("parallel")) {
-            parseParallelConfig(root["parallel"], configHelper.parallelConfig);
-        }
-        if (root.isMember("inference")) {
-            parseInferenceConfig(root["inference"], configHelper.inferenceConfig);
-        }
-        if (root.isMember("calibration")) {
-            parseCalibrationConfig(root["calibration"], configHelper.calibrationConfig);
-        }
-        if (root.isMember("logger")) {
-            parseLoggerConfig(root["logger"], configHelper.loggerConfig);
-        }
+        ConfigHelper::getInstance().update([&root](ConfigHelper::Snapshot& snapshot) {
+            parseSections(root, snapshot);
+        });
         
         std::cout << "Configuration loaded successfully from JSON string" << std::endl;
         return true;
@@ -150,18 +91,7 @@ bool ConfigParser::loadFromString(const std::string& jsonStr) {
 
 std::string ConfigParser::saveToString() {
     try {
-        auto& configHelper = ConfigHelper::getInstance();
-        
-        Json::Value root;
-        root["stream"] = streamConfigToJson(configHelper.streamConfig);
-        root["render"] = renderConfigToJson(configHelper.renderConfig);
-        root["save"] = saveConfigToJson(configHelper.saveConfig);
-        root["metadata"] = metadataConfigToJson(configHelper.metadataConfig);
-        root["hotplug"] = hotPlugConfigToJson(configHelper.hotPlugConfig);
-        root["parallel"] = parallelConfigToJson(configHelper.parallelConfig);
-        root["inference"] = inferenceConfigToJson(configHelper.inferenceConfig);
-        root["calibration"] = calibrationConfigToJson(configHelper.calibrationConfig);
-        root["logger"] = loggerConfigToJson(configHelper.loggerConfig);
+        Json::Value root = sectionsToJson(*ConfigHelper::getInstance().current());
         
         Json::StreamWriterBuilder builder;
         builder["indentation"] = "  ";
@@ -173,6 +103,76 @@ std::string ConfigParser::saveToString() {
     }
 }
 
+Json::Value ConfigParser::snapshotToJson(const ConfigHelper::Snapshot& snapshot) {
+    return sectionsToJson(snapshot);
+}
+
+// =================== 内部辅助方法 ===================
+
+bool ConfigParser::readFile(const std::string& filepath, Json::Value& root) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open config file: " << filepath << std::endl;
+        return false;
+    }
+    
+    Json::CharReaderBuilder builder;
+    std::string errs;
+    if (!Json::parseFromStream(builder, file, &root, &errs)) {
+        std::cerr << "Failed to parse JSON: " << errs << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ConfigParser::parseSections(const Json::Value& root, ConfigHelper::Snapshot& target) {
+    if (root.isMember("stream")) {
+        parseStreamConfig(root["stream"], target.streamConfig);
+    }
+    if (root.isMember("render")) {
+        parseRenderConfig(root["render"], target.renderConfig);
+    }
+    if (root.isMember("save")) {
+        parseSaveConfig(root["save"], target.saveConfig);
+    }
+    if (root.isMember("metadata")) {
+        parseMetadataConfig(root["metadata"], target.metadataConfig);
+    }
+    if (root.isMember("hotplug")) {
+        parseHotPlugConfig(root["hotplug"], target.hotPlugConfig);
+    }
+    if (root.isMember("parallel")) {
+        parseParallelConfig(root["parallel"], target.parallelConfig);
+    }
+    if (root.isMember("inference")) {
+        parseInferenceConfig(root["inference"], target.inferenceConfig);
+    }
+    if (root.isMember("calibration")) {
+        parseCalibrationConfig(root["calibration"], target.calibrationConfig);
+    }
+    if (root.isMember("logger")) {
+        parseLoggerConfig(root["logger"], target.loggerConfig);
+    }
+    if (root.isMember("communication")) {
+        parseCommunicationConfig(root["communication"], target.communicationConfig);
+    }
+}
+
+Json::Value ConfigParser::sectionsToJson(const ConfigHelper::Snapshot& source) {
+    Json::Value root;
+    root["stream"] = streamConfigToJson(source.streamConfig);
+    root["render"] = renderConfigToJson(source.renderConfig);
+    root["save"] = saveConfigToJson(source.saveConfig);
+    root["metadata"] = metadataConfigToJson(source.metadataConfig);
+    root["hotplug"] = hotPlugConfigToJson(source.hotPlugConfig);
+    root["parallel"] = parallelConfigToJson(source.parallelConfig);
+    root["inference"] = inferenceConfigToJson(source.inferenceConfig);
+    root["calibration"] = calibrationConfigToJson(source.calibrationConfig);
+    root["logger"] = loggerConfigToJson(source.loggerConfig);
+    root["communication"] = communicationConfigToJson(source.communicationConfig);
+    return root;
+}
+
 // =================== 模板特化实现 ===================
 
 template<>
@@ -236,11 +236,26 @@ void ConfigParser::parseSaveConfig(const Json::Value& json, ConfigHelper::SaveCo
     config.saveIR = safeGetValue(json, "saveIR", config.saveIR);
     config.savePointCloud = safeGetValue(json, "savePointCloud", config.savePointCloud);
     config.saveMetadata = safeGetValue(json, "saveMetadata", config.saveMetadata);
+    config.metadataFormat = safeGetValue(json, "metadataFormat", config.metadataFormat);
+    config.metadataFlushIntervalMs = safeGetValue(json, "metadataFlushIntervalMs", config.metadataFlushIntervalMs);
     config.enableMetadataConsole = safeGetValue(json, "enableMetadataConsole", config.enableMetadataConsole);
     config.imageFormat = safeGetValue(json, "imageFormat", config.imageFormat);
+    config.depthEncoding = safeGetValue(json, "depthEncoding", config.depthEncoding);
     config.maxFramesToSave = safeGetValue(json, "maxFramesToSave", config.maxFramesToSave);
+    config.filesPerDir = safeGetValue(json, "filesPerDir", config.filesPerDir);
+    config.timeBucketMinutes = safeGetValue(json, "timeBucketMinutes", config.timeBucketMinutes);
+    config.dumpQuotaMB = safeGetValue(json, "dumpQuotaMB", config.dumpQuotaMB);
     config.frameInterval = safeGetValue(json, "frameInterval", config.frameInterval);
     config.enableFrameStats = safeGetValue(json, "enableFrameStats", config.enableFrameStats);
+    config.writerBackend = safeGetValue(json, "writerBackend", config.writerBackend);
+    config.writerMaxInFlight = safeGetValue(json, "writerMaxInFlight", config.writerMaxInFlight);
+    config.writerDirectIO = safeGetValue(json, "writerDirectIO", config.writerDirectIO);
+    config.writerSync = safeGetValue(json, "writerSync", config.writerSync);
+    config.enableTriggerRecord = safeGetValue(json, "enableTriggerRecord", config.enableTriggerRecord);
+    config.preTriggerSeconds = safeGetValue(json, "preTriggerSeconds", config.preTriggerSeconds);
+    config.postTriggerSeconds = safeGetValue(json, "postTriggerSeconds", config.postTriggerSeconds);
+    config.triggerBufferMaxMB = safeGetValue(json, "triggerBufferMaxMB", config.triggerBufferMaxMB);
+    config.triggerOnDetection = safeGetValue(json, "triggerOnDetection", config.triggerOnDetection);
 }
 
 void ConfigParser::parseMetadataConfig(const Json::Value& json, ConfigHelper::MetadataConfig& config) {
@@ -269,6 +284,7 @@ void ConfigParser::parseInferenceConfig(const Json::Value& json, ConfigHelper::I
     config.enableInference = safeGetValue(json, "enableInference", config.enableInference);
     config.defaultModel = safeGetValue(json, "defaultModel", config.defaultModel);
     config.defaultModelType = safeGetValue(json, "defaultModelType", config.defaultModelType);
+    config.defaultEngineType = safeGetValue(json, "defaultEngineType", config.defaultEngineType);
     config.defaultThreshold = safeGetValue(json, "defaultThreshold", config.defaultThreshold);
     config.enableVisualization = safeGetValue(json, "enableVisualization", config.enableVisualization);
     config.enablePerformanceStats = safeGetValue(json, "enablePerformanceStats", config.enablePerformanceStats);
@@ -277,8 +293,32 @@ void ConfigParser::parseInferenceConfig(const Json::Value& json, ConfigHelper::I
     config.asyncInference = safeGetValue(json, "asyncInference", config.asyncInference);
     config.maxQueueSize = safeGetValue(json, "maxQueueSize", config.maxQueueSize);
     config.modelsDirectory = safeGetValue(json, "modelsDirectory", config.modelsDirectory);
+    config.useMmapModels = safeGetValue(json, "useMmapModels", config.useMmapModels);
+    config.enableModelCache = safeGetValue(json, "enableModelCache", config.enableModelCache);
     config.enableFramePreprocessing = safeGetValue(json, "enableFramePreprocessing", config.enableFramePreprocessing);
     config.onlyProcessColorFrames = safeGetValue(json, "onlyProcessColorFrames", config.onlyProcessColorFrames);
+    config.rateControlMode = safeGetValue(json, "rateControlMode", config.rateControlMode);
+    config.targetLatencyMs = safeGetValue(json, "targetLatencyMs", config.targetLatencyMs);
+    config.targetCpuShare = safeGetValue(json, "targetCpuShare", config.targetCpuShare);
+    config.maxInferenceInterval = safeGetValue(json, "maxInferenceInterval", config.maxInferenceInterval);
+    config.enablePipeline = safeGetValue(json, "enablePipeline", config.enablePipeline);
+    config.pipelineQueueSize = safeGetValue(json, "pipelineQueueSize", config.pipelineQueueSize);
+    config.nmsThreshold = safeGetValue(json, "nmsThreshold", config.nmsThreshold);
+    config.nmsMethod = safeGetValue(json, "nmsMethod", config.nmsMethod);
+    config.softNmsSigma = safeGetValue(json, "softNmsSigma", config.softNmsSigma);
+    config.classAwareNMS = safeGetValue(json, "classAwareNMS", config.classAwareNMS);
+    config.maxDetections = safeGetValue(json, "maxDetections", config.maxDetections);
+    config.enableTracking = safeGetValue(json, "enableTracking", config.enableTracking);
+    config.trackerIouThreshold = safeGetValue(json, "trackerIouThreshold", config.trackerIouThreshold);
+    config.trackerMaxAge = safeGetValue(json, "trackerMaxAge", config.trackerMaxAge);
+    config.trackerMinHits = safeGetValue(json, "trackerMinHits", config.trackerMinHits);
+    config.trackerOpticalFlow = safeGetValue(json, "trackerOpticalFlow", config.trackerOpticalFlow);
+    config.trackerFlowScale = safeGetValue(json, "trackerFlowScale", config.trackerFlowScale);
+    config.enableTiling = safeGetValue(json, "enableTiling", config.enableTiling);
+    config.tileSize = safeGetValue(json, "tileSize", config.tileSize);
+    config.tileOverlap = safeGetValue(json, "tileOverlap", config.tileOverlap);
+    config.tileFullFrame = safeGetValue(json, "tileFullFrame", config.tileFullFrame);
+    config.tileWorkers = safeGetValue(json, "tileWorkers", config.tileWorkers);
 }
 
 void ConfigParser::parseCalibrationConfig(const Json::Value& json, ConfigHelper::CalibrationConfig& config) {
@@ -290,6 +330,9 @@ void ConfigParser::parseCalibrationConfig(const Json::Value& json, ConfigHelper:
     config.maxFrames = safeGetValue(json, "maxFrames", config.maxFrames);
     config.minInterval = safeGetValue(json, "minInterval", config.minInterval);
     config.useSubPixel = safeGetValue(json, "useSubPixel", config.useSubPixel);
+    config.minViewDistance = safeGetValue(json, "minViewDistance", config.minViewDistance);
+    config.incrementalCalibration = safeGetValue(json, "incrementalCalibration", config.incrementalCalibration);
+    config.convergenceThreshold = safeGetValue(json, "convergenceThreshold", config.convergenceThreshold);
     config.enableUndistortion = safeGetValue(json, "enableUndistortion", config.enableUndistortion);
     config.saveDirectory = safeGetValue(json, "saveDirectory", config.saveDirectory);
     config.autoStartCalibrationOnStartup = safeGetValue(json, "autoStartCalibrationOnStartup", config.autoStartCalibrationOnStartup);
@@ -309,6 +352,19 @@ void ConfigParser::parseLoggerConfig(const Json::Value& json, ConfigHelper::Logg
     config.logDirectory = safeGetValue(json, "logDirectory", config.logDirectory);
 }
 
+void ConfigParser::parseCommunicationConfig(const Json::Value& json, ConfigHelper::CommunicationConfig& config) {
+    config.enableCommunication = safeGetValue(json, "enableCommunication", config.enableCommunication);
+    config.commPath = safeGetValue(json, "commPath", config.commPath);
+    config.transport = safeGetValue(json, "transport", config.transport);
+    config.heartbeatInterval = safeGetValue(json, "heartbeatInterval", config.heartbeatInterval);
+    config.binaryFraming = safeGetValue(json, "binaryFraming", config.binaryFraming);
+    config.enableSharedMemory = safeGetValue(json, "enableSharedMemory", config.enableSharedMemory);
+    config.shmPrefix = safeGetValue(json, "shmPrefix", config.shmPrefix);
+    config.shmSlotCount = safeGetValue(json, "shmSlotCount", config.shmSlotCount);
+    config.shmDepthEncoding = safeGetValue(json, "shmDepthEncoding", config.shmDepthEncoding);
+    config.streamResults = safeGetValue(json, "streamResults", config.streamResults);
+}
+
 // =================== 序列化方法实现 ===================
 
 Json::Value ConfigParser::streamConfigToJson(const ConfigHelper::StreamConfig& config) {
@@ -350,11 +406,26 @@ Json::Value ConfigParser::saveConfigToJson(const ConfigHelper::SaveConfig& confi
     json["saveIR"] = config.saveIR;
     json["savePointCloud"] = config.savePointCloud;
     json["saveMetadata"] = config.saveMetadata;
+    json["metadataFormat"] = config.metadataFormat;
+    json["metadataFlushIntervalMs"] = config.metadataFlushIntervalMs;
     json["enableMetadataConsole"] = config.enableMetadataConsole;
     json["imageFormat"] = config.imageFormat;
+    json["depthEncoding"] = config.depthEncoding;
     json["maxFramesToSave"] = config.maxFramesToSave;
+    json["filesPerDir"] = config.filesPerDir;
+    json["timeBucketMinutes"] = config.timeBucketMinutes;
+    json["dumpQuotaMB"] = config.dumpQuotaMB;
     json["frameInterval"] = config.frameInterval;
     json["enableFrameStats"] = config.enableFrameStats;
+    json["writerBackend"] = config.writerBackend;
+    json["writerMaxInFlight"] = config.writerMaxInFlight;
+    json["writerDirectIO"] = config.writerDirectIO;
+    json["writerSync"] = config.writerSync;
+    json["enableTriggerRecord"] = config.enableTriggerRecord;
+    json["preTriggerSeconds"] = config.preTriggerSeconds;
+    json["postTriggerSeconds"] = config.postTriggerSeconds;
+    json["triggerBufferMaxMB"] = config.triggerBufferMaxMB;
+    json["triggerOnDetection"] = config.triggerOnDetection;
     return json;
 }
 
@@ -391,6 +462,7 @@ Json::Value ConfigParser::inferenceConfigToJson(const ConfigHelper::InferenceCon
     json["enableInference"] = config.enableInference;
     json["defaultModel"] = config.defaultModel;
     json["defaultModelType"] = config.defaultModelType;
+    json["defaultEngineType"] = config.defaultEngineType;
     json["defaultThreshold"] = config.defaultThreshold;
     json["enableVisualization"] = config.enableVisualization;
     json["enablePerformanceStats"] = config.enablePerformanceStats;
@@ -399,8 +471,32 @@ Json::Value ConfigParser::inferenceConfigToJson(const ConfigHelper::InferenceCon
     json["asyncInference"] = config.asyncInference;
     json["maxQueueSize"] = config.maxQueueSize;
     json["modelsDirectory"] = config.modelsDirectory;
+    json["useMmapModels"] = config.useMmapModels;
+    json["enableModelCache"] = config.enableModelCache;
     json["enableFramePreprocessing"] = config.enableFramePreprocessing;
     json["onlyProcessColorFrames"] = config.onlyProcessColorFrames;
+    json["rateControlMode"] = config.rateControlMode;
+    json["targetLatencyMs"] = config.targetLatencyMs;
+    json["targetCpuShare"] = config.targetCpuShare;
+    json["maxInferenceInterval"] = config.maxInferenceInterval;
+    json["enablePipeline"] = config.enablePipeline;
+    json["pipelineQueueSize"] = config.pipelineQueueSize;
+    json["nmsThreshold"] = config.nmsThreshold;
+    json["nmsMethod"] = config.nmsMethod;
+    json["softNmsSigma"] = config.softNmsSigma;
+    json["classAwareNMS"] = config.classAwareNMS;
+    json["maxDetections"] = config.maxDetections;
+    json["enableTracking"] = config.enableTracking;
+    json["trackerIouThreshold"] = config.trackerIouThreshold;
+    json["trackerMaxAge"] = config.trackerMaxAge;
+    json["trackerMinHits"] = config.trackerMinHits;
+    json["trackerOpticalFlow"] = config.trackerOpticalFlow;
+    json["trackerFlowScale"] = config.trackerFlowScale;
+    json["enableTiling"] = config.enableTiling;
+    json["tileSize"] = config.tileSize;
+    json["tileOverlap"] = config.tileOverlap;
+    json["tileFullFrame"] = config.tileFullFrame;
+    json["tileWorkers"] = config.tileWorkers;
     return json;
 }
 
@@ -414,6 +510,9 @@ Json::Value ConfigParser::calibrationConfigToJson(const ConfigHelper::Calibratio
     json["maxFrames"] = config.maxFrames;
     json["minInterval"] = config.minInterval;
     json["useSubPixel"] = config.useSubPixel;
+    json["minViewDistance"] = config.minViewDistance;
+    json["incrementalCalibration"] = config.incrementalCalibration;
+    json["convergenceThreshold"] = config.convergenceThreshold;
     json["enableUndistortion"] = config.enableUndistortion;
     json["saveDirectory"] = config.saveDirectory;
     json["autoStartCalibrationOnStartup"] = config.autoStartCalibrationOnStartup;
@@ -428,4 +527,19 @@ Json::Value ConfigParser::loggerConfigToJson(const ConfigHelper::LoggerConfig& c
     json["enableFileLogging"] = config.enableFileLogging;
     json["logDirectory"] = config.logDirectory;
     return json;
-} 
\ No newline at end of file
+}
+
+Json::Value ConfigParser::communicationConfigToJson(const ConfigHelper::CommunicationConfig& config) {
+    Json::Value json;
+    json["enableCommunication"] = config.enableCommunication;
+    json["commPath"] = config.commPath;
+    json["transport"] = config.transport;
+    json["heartbeatInterval"] = config.heartbeatInterval;
+    json["binaryFraming"] = config.binaryFraming;
+    json["enableSharedMemory"] = config.enableSharedMemory;
+    json["shmPrefix"] = config.shmPrefix;
+    json["shmSlotCount"] = config.shmSlotCount;
+    json["shmDepthEncoding"] = config.shmDepthEncoding;
+    json["streamResults"] = config.streamResults;
+    return json;
+}
@@ -37,7 +37,35 @@ public:
      */
     static std::string saveToString();
 
+    /**
+     * @brief 从JSON文件解析配置到快照，不修改 ConfigHelper
+     * @param filepath JSON配置文件路径
+     * @param snapshot 解析目标，文件中没有的字段保持原值
+     * @return 是否成功加载
+     */
+    static bool loadSnapshotFromFile(const std::string& filepath, ConfigHelper::Snapshot& snapshot);
+
+    /**
+     * @brief 将配置快照导出为JSON对象
+     */
+    static Json::Value snapshotToJson(const ConfigHelper::Snapshot& snapshot);
+
 private:
+    /**
+     * @brief 读取并解析JSON文件
+     */
+    static bool readFile(const std::string& filepath, Json::Value& root);
+
+    /**
+     * @brief 解析根对象中的各个配置段，未出现的段保持快照中的原值
+     */
+    static void parseSections(const Json::Value& root, ConfigHelper::Snapshot& target);
+
+    /**
+     * @brief 将快照的各个配置段导出为根对象
+     */
+    static Json::Value sectionsToJson(const ConfigHelper::Snapshot& source);
+
     /**
      * @brief 解析流配置
      */
@@ -83,6 +111,11 @@ private:
      */
     static void parseLoggerConfig(const Json::Value& json, ConfigHelper::LoggerConfig& config);
     
+    /**
+     * @brief 解析通信配置
+     */
+    static void parseCommunicationConfig(const Json::Value& json, ConfigHelper::CommunicationConfig& config);
+    
     // 序列化方法
     static Json::Value streamConfigToJson(const ConfigHelper::StreamConfig& config);
     static Json::Value renderConfigToJson(const ConfigHelper::RenderConfig& config);
@@ -93,6 +126,7 @@ private:
     static Json::Value inferenceConfigToJson(const ConfigHelper::InferenceConfig& config);
     static Json::Value calibrationConfigToJson(const ConfigHelper::CalibrationConfig& config);
     static Json::Value loggerConfigToJson(const ConfigHelper::LoggerConfig& config);
+    static Json::Value communicationConfigToJson(const ConfigHelper::CommunicationConfig& config);
     
     /**
      * @brief 安全获取JSON值的辅助方法
@@ -0,0 +1,176 @@
+#include "ConfigWatcher.hpp"
+#include "ConfigParser.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+ConfigWatcher::ConfigWatcher(std::string filepath, int debounceMs)
+    : path_(std::move(filepath)), debounceMs_(debounceMs) {
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start() {
+    if (running_) {
+        return true;
+    }
+
+    std::filesystem::path path(path_);
+    fileName_ = path.filename().string();
+    std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        LOG_ERROR("ConfigWatcher: inotify_init1 failed: ", std::strerror(errno));
+        return false;
+    }
+    // 写入完成或由临时文件改名而来
+    if (inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_ERROR("ConfigWatcher: failed to watch ", directory, ": ", std::strerror(errno));
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+    stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopFd_ < 0) {
+        LOG_ERROR("ConfigWatcher: eventfd failed: ", std::strerror(errno));
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&ConfigWatcher::run, this);
+    LOG_INFO("Watching config file for changes: ", path_);
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    if (write(stopFd_, &one, sizeof(one)) < 0) {
+        LOG_WARN("ConfigWatcher: failed to signal watcher thread: ", std::strerror(errno));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close(inotifyFd_);
+    close(stopFd_);
+    inotifyFd_ = -1;
+    stopFd_ = -1;
+}
+
+bool ConfigWatcher::reload() {
+    auto& config = ConfigHelper::getInstance();
+    ConfigHelper::SnapshotPtr snapshot = config.current();
+    const ConfigHelper::Snapshot& current = *snapshot;
+
+    // 文件中没有的字段沿用当前值
+    ConfigHelper::Snapshot candidate = current;
+    if (!ConfigParser::loadSnapshotFromFile(path_, candidate)) {
+        LOG_ERROR("Config reload failed, keeping current configuration: ", path_);
+        rejected_++;
+        return false;
+    }
+    if (!candidate.validateAll()) {
+        LOG_ERROR("Config reload rejected, validation failed: ", path_);
+        rejected_++;
+        return false;
+    }
+
+    ConfigHelper::Snapshot merged = current;
+    merged.applyLiveSettings(candidate);
+
+    // 逐项比较：未能合并的改动需要重启才能生效
+    Json::Value candidateJson = ConfigParser::snapshotToJson(candidate);
+    Json::Value mergedJson = ConfigParser::snapshotToJson(merged);
+    for (const auto& section : candidateJson.getMemberNames()) {
+        for (const auto& key : candidateJson[section].getMemberNames()) {
+            if (candidateJson[section][key] != mergedJson[section][key]) {
+                LOG_WARN("Config change requires restart: ", section, ".", key);
+            }
+        }
+    }
+
+    if (mergedJson == ConfigParser::snapshotToJson(current)) {
+        LOG_INFO("Config reloaded, no live settings changed");
+        unchanged_++;
+        return true;
+    }
+
+    uint64_t version = config.update([&candidate](ConfigHelper::Snapshot& snapshot) {
+        snapshot.applyLiveSettings(candidate);
+    });
+    LOG_INFO("Config reloaded from ", path_, ", version ", version);
+    applied_++;
+    return true;
+}
+
+ConfigWatcher::Stats ConfigWatcher::getStats() const {
+    Stats stats;
+    stats.applied = applied_.load();
+    stats.unchanged = unchanged_.load();
+    stats.rejected = rejected_.load();
+    return stats;
+}
+
+void ConfigWatcher::run() {
+    pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+    bool pending = false;
+
+    while (running_) {
+        // 有未处理的修改时等待到事件平息（编辑器保存往往产生多个事件）
+        int ready = poll(fds, 2, pending ? debounceMs_ : -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("ConfigWatcher: poll failed: ", std::strerror(errno));
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (ready == 0) {
+            pending = false;
+            try {
+                reload();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Exception while reloading config: ", e.what());
+            }
+            continue;
+        }
+        if ((fds[0].revents & POLLIN) && drainEvents()) {
+            pending = true;
+        }
+    }
+}
+
+bool ConfigWatcher::drainEvents() {
+    alignas(inotify_event) char buffer[4096];
+    bool matched = false;
+
+    while (true) {
+        ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (char* ptr = buffer; ptr < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+            if (event->len > 0 && fileName_ == event->name) {
+                matched = true;
+            }
+            ptr += sizeof(inotify_event) + event->len;
+        }
+    }
+    return matched;
+}
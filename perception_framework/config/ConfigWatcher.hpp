@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "ConfigHelper.hpp"
+
+/**
+ * @brief 配置文件热加载
+ *
+ * 用 inotify 监视配置文件所在目录（编辑器通常写临时文件再改名，直接监视文件会丢失事件），
+ * 文件写入或改名完成后等待一段时间没有新事件再重新加载。加载结果先整体验证，
+ * 只把可以在运行中生效的设置（见 ConfigHelper::Snapshot::applyLiveSettings）
+ * 合并到当前快照后发布，其他改动记录日志，重启后生效。
+ */
+class ConfigWatcher {
+public:
+    /**
+     * @brief 重新加载统计
+     */
+    struct Stats {
+        uint64_t applied = 0;       // 发布了新快照的次数
+        uint64_t unchanged = 0;     // 可热加载的设置没有变化
+        uint64_t rejected = 0;      // 解析或验证失败
+    };
+
+    /**
+     * @param filepath 配置文件路径
+     * @param debounceMs 最后一个文件事件之后等待的时间(毫秒)
+     */
+    explicit ConfigWatcher(std::string filepath, int debounceMs = 200);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief 开始监视
+     */
+    bool start();
+
+    /**
+     * @brief 停止监视线程
+     */
+    void stop();
+
+    /**
+     * @brief 立即重新加载一次配置文件
+     * @return 解析和验证通过时返回 true（可热加载的设置没有变化时不发布新快照）
+     */
+    bool reload();
+
+    Stats getStats() const;
+
+private:
+    void run();
+
+    /**
+     * @brief 读取 inotify 事件，返回是否涉及配置文件
+     */
+    bool drainEvents();
+
+    std::string path_;
+    std::string fileName_;
+    int debounceMs_;
+
+    int inotifyFd_ = -1;
+    int stopFd_ = -1;                          // eventfd，通知监视线程退出
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> unchanged_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
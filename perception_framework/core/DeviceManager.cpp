@@ -15,7 +15,8 @@ bool DeviceManager::initialize() {
     try {
         LOG_INFO("Initializing DeviceManager...");
         
-        auto& config = ConfigHelper::getInstance().hotPlugConfig;
+        auto snapshot = ConfigHelper::getInstance().current();
+        const auto& config = snapshot->hotPlugConfig;
         
         if(config.enableHotPlug) {
             setupHotPlugCallback();
@@ -46,11 +47,6 @@ bool DeviceManager::initialize() {
 void DeviceManager::start() {
     LOG_INFO("Starting DeviceManager");
     shouldStop_ = false;
-    
-    // 启动重连线程
-    if(!reconnectionThread_.joinable()) {
-        reconnectionThread_ = std::thread(&DeviceManager::reconnectionWorker, this);
-    }
 }
 
 void DeviceManager::stop() {
@@ -58,38 +54,14 @@ void DeviceManager::stop() {
     shouldStop_ = true;
     isReconnecting_ = false;  // 立即停止重连
     
+    // 取消尚未到期的稳定等待和重连，已在 worker_ 上排队的任务检查 shouldStop_ 后直接返回
+    auto& wheel = utils::TimerWheel::getInstance();
+    wheel.cancel(stabilizeTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
+    wheel.cancel(reconnectTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
+    
     // 通知所有等待的线程
     deviceCondition_.notify_all();
     
-    // 等待重连线程结束，但设置超时避免无限等待
-    if(reconnectionThread_.joinable()) {
-        auto start = std::chrono::steady_clock::now();
-        while(reconnectionThread_.joinable()) {
-            deviceCondition_.notify_all();
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            
-            // 超时检查，避免无限等待
-            auto elapsed = std::chrono::steady_clock::now() - start;
-            if(elapsed > std::chrono::seconds(2)) {
-                LOG_WARN("Reconnection thread join timeout, detaching...");
-                reconnectionThread_.detach();
-                break;
-            }
-            
-            if(!reconnectionThread_.joinable()) {
-                break;
-            }
-            
-            // 尝试join
-            try {
-                reconnectionThread_.join();
-                break;
-            } catch(...) {
-                // join失败，继续尝试
-            }
-        }
-    }
-    
     std::lock_guard<std::mutex> lock(deviceMutex_);
     currentDevice_.reset();
     setDeviceState(DeviceState::DISCONNECTED);
@@ -171,29 +143,27 @@ void DeviceManager::setupHotPlugCallback() {
 
 void DeviceManager::onDeviceChanged(std::shared_ptr<ob::DeviceList> removedList, 
                                    std::shared_ptr<ob::DeviceList> addedList) {
-    auto& config = ConfigHelper::getInstance().hotPlugConfig;
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->hotPlugConfig;
     
     if(config.printDeviceEvents) {
         printDeviceList("removed", removedList);
         printDeviceList("added", addedList);
     }
     
-    // 使用异步处理避免在回调中阻塞
-    std::thread([this, removedList, addedList]() {
-        auto& config = ConfigHelper::getInstance().hotPlugConfig;
-        
-        // 处理设备断开
-        if(removedList && removedList->getCount() > 0) {
-            handleDeviceDisconnection();
-        }
-        
-        // 处理设备连接
-        if(addedList && addedList->getCount() > 0) {
-            // 等待一段时间确保设备稳定
-            std::this_thread::sleep_for(std::chrono::milliseconds(config.deviceStabilizeDelayMs));
-            handleDeviceConnection();
-        }
-    }).detach();
+    // 不在 SDK 回调中阻塞：断开立即交给 worker_ 处理，连接等设备稳定后再处理
+    if(removedList && removedList->getCount() > 0) {
+        worker_.submit([this]() { handleDeviceDisconnection(); });
+    }
+    
+    if(addedList && addedList->getCount() > 0) {
+        // 短时间内的多次插入事件只在最后一次之后连接一次
+        auto& wheel = utils::TimerWheel::getInstance();
+        wheel.cancel(stabilizeTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
+        stabilizeTimer_ = wheel.schedule(std::chrono::milliseconds(config.deviceStabilizeDelayMs),
+                                         [this]() { handleDeviceConnection(); },
+                                         utils::TimerWheel::poolExecutor(worker_));
+    }
 }
 
 void DeviceManager::handleDeviceDisconnection() {
@@ -208,20 +178,25 @@ void DeviceManager::handleDeviceDisconnection() {
     setDeviceState(DeviceState::DISCONNECTED);
     
     // 如果启用自动重连，开始重连
-    if(ConfigHelper::getInstance().hotPlugConfig.autoReconnect) {
+    if(ConfigHelper::getInstance().current()->hotPlugConfig.autoReconnect && !shouldStop_) {
+        utils::TimerWheel::getInstance().cancel(reconnectTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
         isReconnecting_ = true;
         reconnectAttempts_ = 0;
-        deviceCondition_.notify_all();
+        scheduleReconnectAttempt();
     }
 }
 
 void DeviceManager::handleDeviceConnection() {
+    if(shouldStop_) {
+        return;
+    }
     LOG_INFO("New device detected, attempting to connect...");
     
     if(attemptConnection()) {
         setDeviceState(DeviceState::CONNECTED);
         isReconnecting_ = false;
         reconnectAttempts_ = 0;
+        utils::TimerWheel::getInstance().cancel(reconnectTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
         LOG_INFO("Device connected successfully");
     } else {
         LOG_WARN("Failed to connect to new device");
@@ -252,58 +227,44 @@ bool DeviceManager::attemptConnection() {
     }
 }
 
-void DeviceManager::reconnectionWorker() {
-    LOG_DEBUG("Reconnection worker started");
+void DeviceManager::scheduleReconnectAttempt() {
+    if(shouldStop_ || !isReconnecting_) {
+        return;
+    }
     
-    while(!shouldStop_) {
-        std::unique_lock<std::mutex> lock(deviceMutex_);
-        
-        // 等待重连信号或停止信号，设置超时避免无限等待
-        deviceCondition_.wait_for(lock, std::chrono::milliseconds(100), [this] { 
-            return isReconnecting_ || shouldStop_; 
-        });
-        
-        if(shouldStop_) break;
-        
-        if(isReconnecting_ && !shouldStop_) {
-            lock.unlock();
-            
-            auto& config = ConfigHelper::getInstance().hotPlugConfig;
-            
-            while(isReconnecting_ && reconnectAttempts_ < config.maxReconnectAttempts && !shouldStop_) {
-                reconnectAttempts_++;
-                setDeviceState(DeviceState::RECONNECTING);
-                
-                LOG_INFO("Reconnection attempt ", reconnectAttempts_.load(), "/", config.maxReconnectAttempts);
-                
-                // 分段等待重连延迟，以便快速响应停止信号
-                int delayMs = config.reconnectDelayMs;
-                while(delayMs > 0 && !shouldStop_) {
-                    int sleepTime = std::min(delayMs, 100);  // 每次最多睡眠100ms
-                    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
-                    delayMs -= sleepTime;
-                }
-                
-                if(shouldStop_) break;
-                
-                if(attemptConnection()) {
-                    setDeviceState(DeviceState::CONNECTED);
-                    isReconnecting_ = false;
-                    reconnectAttempts_ = 0;
-                    LOG_INFO("Reconnection successful on attempt ", reconnectAttempts_.load());
-                    break;
-                }
-            }
-            
-            if(isReconnecting_ && reconnectAttempts_ >= config.maxReconnectAttempts) {
-                LOG_ERROR("Reconnection failed after ", config.maxReconnectAttempts, " attempts");
-                setDeviceState(DeviceState::ERROR);
-                isReconnecting_ = false;
-            }
-        }
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->hotPlugConfig;
+    if(reconnectAttempts_ >= config.maxReconnectAttempts) {
+        LOG_ERROR("Reconnection failed after ", config.maxReconnectAttempts, " attempts");
+        setDeviceState(DeviceState::ERROR);
+        isReconnecting_ = false;
+        return;
     }
     
-    LOG_DEBUG("Reconnection worker stopped");
+    reconnectAttempts_++;
+    setDeviceState(DeviceState::RECONNECTING);
+    LOG_INFO("Reconnection attempt ", reconnectAttempts_.load(), "/", config.maxReconnectAttempts);
+    
+    // 重连延迟由时间轮计时，stop() 取消定时器即可立即停止
+    reconnectTimer_ = utils::TimerWheel::getInstance().schedule(
+        std::chrono::milliseconds(config.reconnectDelayMs),
+        [this]() { reconnectAttempt(); },
+        utils::TimerWheel::poolExecutor(worker_));
+}
+
+void DeviceManager::reconnectAttempt() {
+    if(shouldStop_ || !isReconnecting_) {
+        return;
+    }
+    
+    if(attemptConnection()) {
+        LOG_INFO("Reconnection successful on attempt ", reconnectAttempts_.load());
+        setDeviceState(DeviceState::CONNECTED);
+        isReconnecting_ = false;
+        reconnectAttempts_ = 0;
+        return;
+    }
+    scheduleReconnectAttempt();
 }
 
 void DeviceManager::printDeviceList(const std::string& prompt, std::shared_ptr<ob::DeviceList> deviceList) {
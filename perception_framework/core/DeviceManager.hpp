@@ -11,6 +11,8 @@
 #include "libobsensor/ObSensor.hpp"
 #include "Logger.hpp"
 #include "ConfigHelper.hpp"
+#include "ThreadPool.hpp"
+#include "TimerWheel.hpp"
 
 /**
  * @brief 设备管理器
@@ -95,7 +97,8 @@ private:
     void handleDeviceDisconnection();
     void handleDeviceConnection();
     bool attemptConnection();
-    void reconnectionWorker();
+    void scheduleReconnectAttempt();
+    void reconnectAttempt();
     void printDeviceList(const std::string& prompt, std::shared_ptr<ob::DeviceList> deviceList);
 
 private:
@@ -109,9 +112,13 @@ private:
     
     mutable std::mutex deviceMutex_;
     std::condition_variable deviceCondition_;
-    std::thread reconnectionThread_;
     
     DeviceEventCallback deviceEventCallback_;
     
     std::chrono::steady_clock::time_point lastDisconnectTime_;
+
+    // 设备稳定等待和重连间隔由全局时间轮计时，到期后在 worker_ 上串行处理
+    std::atomic<utils::TimerWheel::TimerId> stabilizeTimer_{utils::TimerWheel::INVALID_TIMER};
+    std::atomic<utils::TimerWheel::TimerId> reconnectTimer_{utils::TimerWheel::INVALID_TIMER};
+    utils::ThreadPool worker_{1};   // 最后声明、最先析构，排空任务时其他成员仍有效
 }; 
\ No newline at end of file
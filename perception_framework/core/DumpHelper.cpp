@@ -1,13 +1,19 @@
 #include "DumpHelper.hpp"
 #include "MetadataHelper.hpp"
+#include "MetadataLogger.hpp"
+#include "TriggerRecorder.hpp"
+#include "DumpWriter.hpp"
+#include "DumpSession.hpp"
 #include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
 #include "ConfigHelper.hpp"
 #include "Logger.hpp"
+#include "DepthCodec.hpp"
 
 // 简化的格式转换函数
 std::string formatName(OBFormat format) {
@@ -87,25 +93,10 @@ DumpHelper::TimeStamp DumpHelper::TimeStamp::extract(std::shared_ptr<ob::Frame>
         ts.systemUs = frame->getSystemTimeStampUs();
         ts.globalUs = frame->getGlobalTimeStampUs();
         
-        // 生成设备时间戳字符串
-        auto timestampMs = ts.deviceUs / 1000;
-        auto time = std::chrono::system_clock::from_time_t(timestampMs / 1000);
-        auto timeT = std::chrono::system_clock::to_time_t(time);
-        
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&timeT), "%Y%m%d_%H%M%S");
-        ss << "_" << std::setfill('0') << std::setw(3) << (timestampMs % 1000);
-        ts.deviceStr = ss.str();
-        
-        // 生成系统时间戳字符串
-        auto sysTimeMs = ts.systemUs / 1000;
-        auto sysTime = std::chrono::system_clock::from_time_t(sysTimeMs / 1000);
-        auto sysTimeT = std::chrono::system_clock::to_time_t(sysTime);
-        
-        std::stringstream sysS;
-        sysS << std::put_time(std::localtime(&sysTimeT), "%Y%m%d_%H%M%S");
-        sysS << "_" << std::setfill('0') << std::setw(3) << (sysTimeMs % 1000);
-        ts.systemStr = sysS.str();
+        // 生成时间戳字符串（整数格式化，同一秒内复用 localtime 结果）
+        char buffer[20];
+        ts.deviceStr.assign(buffer, DumpSession::formatTime(ts.deviceUs, buffer));
+        ts.systemStr.assign(buffer, DumpSession::formatTime(ts.systemUs, buffer));
         
     } catch (const std::exception& e) {
         LOG_ERROR("Error extracting timestamp: ", e.what());
@@ -140,20 +131,58 @@ DumpHelper::FrameMeta DumpHelper::FrameMeta::extract(std::shared_ptr<ob::Frame>
     return meta;
 }
 
-std::string DumpHelper::FrameMeta::baseFileName() const {
-    std::string processedTypeName = typeName;
-    std::replace(processedTypeName.begin(), processedTypeName.end(), ' ', '_');
-    
-    std::stringstream ss;
-    ss << timestamp.forFileName() 
-       << "-" << std::to_string(index)
-       << "-" << processedTypeName;
-    
+namespace {
+    // 追加字符串到固定缓冲，空间不足返回 nullptr
+    char* appendString(char* out, char* end, const char* str, size_t length) {
+        if (!out || static_cast<size_t>(end - out) <= length) return nullptr;
+        std::memcpy(out, str, length);
+        return out + length;
+    }
+
+    // 追加十进制整数到固定缓冲
+    char* appendNumber(char* out, char* end, uint64_t value) {
+        char digits[20];
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        if (!out || static_cast<size_t>(end - out) <= count) return nullptr;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = digits[count - 1 - i];
+        }
+        return out + count;
+    }
+}
+
+size_t DumpHelper::FrameMeta::formatBaseName(char* out, size_t capacity) const {
+    // <时间戳>-<帧索引>-<帧类型>[_<格式>]
+    char timeStr[20];
+    size_t timeLength = DumpSession::formatTime(timestamp.systemUs != 0 ? timestamp.systemUs
+                                                                        : timestamp.deviceUs, timeStr);
+    char* end = out + capacity;
+    char* p = appendString(out, end, timeStr, timeLength);
+    p = appendString(p, end, "-", 1);
+    p = appendNumber(p, end, index);
+    p = appendString(p, end, "-", 1);
+    char* typeStart = p;
+    p = appendString(p, end, typeName.data(), typeName.size());
+    if (p) {
+        std::replace(typeStart, p, ' ', '_');
+    }
     if (!formatName.empty()) {
-        ss << "_" << formatName;
+        p = appendString(p, end, "_", 1);
+        p = appendString(p, end, formatName.data(), formatName.size());
     }
+    if (!p) return 0;
     
-    return ss.str();
+    *p = '\0';
+    return static_cast<size_t>(p - out);
+}
+
+std::string DumpHelper::FrameMeta::baseFileName() const {
+    char buffer[SaveInfo::BASE_NAME_SIZE];
+    return std::string(buffer, formatBaseName(buffer, sizeof(buffer)));
 }
 
 // ==================== SaveInfo Implementation ====================
@@ -161,18 +190,34 @@ std::string DumpHelper::FrameMeta::baseFileName() const {
 DumpHelper::SaveInfo::SaveInfo(const std::string& path, std::shared_ptr<ob::Frame> frame) {
     basePath = Logger::ensureDirectoryExists(path);
     meta = FrameMeta::extract(frame);
+    baseNameLength = meta.formatBaseName(baseName, sizeof(baseName));
+}
+
+DumpHelper::SaveInfo::SaveInfo(std::shared_ptr<DumpSession> session, const DumpSession::Slot& slot,
+                               const FrameMeta& frameMeta)
+    : basePath(session->path()), meta(frameMeta), dirFd(slot.dirFd), shardId(slot.shardId),
+      session(std::move(session)), shard(slot.shard) {
+    baseNameLength = meta.formatBaseName(baseName, sizeof(baseName));
 }
 
-std::string DumpHelper::SaveInfo::filePath(const std::string& suffix, const std::string& ext) const {
-    std::stringstream ss;
-    ss << basePath << meta.baseFileName();
+size_t DumpHelper::SaveInfo::fileName(char* out, size_t capacity, const char* suffix, const char* ext) const {
+    char* end = out + capacity;
+    char* p = out;
     
-    if (!suffix.empty()) {
-        ss << "_" << suffix;
+    // 没有目录句柄时使用完整路径
+    if (dirFd == AT_FDCWD) {
+        p = appendString(p, end, basePath.data(), basePath.size());
     }
+    p = appendString(p, end, baseName, baseNameLength);
+    if (suffix && *suffix) {
+        p = appendString(p, end, "_", 1);
+        p = appendString(p, end, suffix, std::strlen(suffix));
+    }
+    p = appendString(p, end, ext, std::strlen(ext));
+    if (!p) return 0;
     
-    ss << ext;
-    return ss.str();
+    *p = '\0';
+    return static_cast<size_t>(p - out);
 }
 
 // ==================== DumpHelper Main Implementation ====================
@@ -185,12 +230,24 @@ DumpHelper& DumpHelper::getInstance() {
 DumpHelper::DumpHelper() {
     formatFilter_ = std::make_shared<ob::FormatConvertFilter>();
     metadataHelper_ = &MetadataHelper::getInstance();
+    metadataLogger_ = std::make_unique<MetadataLogger>();
+    triggerRecorder_ = &TriggerRecorder::getInstance();
+}
+
+DumpHelper::~DumpHelper() {
+    // TriggerRecorder 先于 DumpHelper 构造完成，需在此处先停止其写盘线程
+    triggerRecorder_->stop();
+    
+    // 等待剩余文件落盘
+    flush();
 }
 
 bool DumpHelper::initializeSavePath() {
-    auto& config = ConfigHelper::getInstance();
+    savePathRequested_ = true;
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
-    if (!config.saveConfig.enableDump) {
+    if (!config.saveConfig.enableDump && !config.saveConfig.enableTriggerRecord) {
         LOG_DEBUG("Data saving disabled");
         return true;
     }
@@ -199,19 +256,62 @@ bool DumpHelper::initializeSavePath() {
     
     if (normalizedPath.empty()) {
         LOG_ERROR("Failed to create dump directory: ", config.saveConfig.dumpPath);
-        config.saveConfig.enableDump = false;
+        ConfigHelper::getInstance().update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.saveConfig.enableDump = false;
+            snapshot.saveConfig.enableTriggerRecord = false;
+        });
         return false;
     }
     
-    config.saveConfig.dumpPath = normalizedPath;
     LOG_INFO("Data save path initialized: ", normalizedPath);
+    
+    // 按当前配置（重新）创建写盘后端；旧会话的目录句柄在其写请求完成后才能关闭
+    flush();
+    auto writer = createWriter();
+    
+    // 周期保存使用会话目录布局（分片目录句柄缓存）
+    std::shared_ptr<DumpSession> session;
+    if (config.saveConfig.enableDump) {
+        DumpSession::Options options;
+        options.rootPath = normalizedPath;
+        options.filesPerDir = config.saveConfig.filesPerDir;
+        options.bucketMinutes = config.saveConfig.timeBucketMinutes;
+        options.maxFrames = config.saveConfig.maxFramesToSave;
+        options.quotaMB = config.saveConfig.dumpQuotaMB;
+        session = std::make_shared<DumpSession>(options);
+        if (!session->open()) {
+            LOG_WARN("Failed to open dump session, saving to ", normalizedPath, " directly");
+            session.reset();
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    writer_ = writer;
+    session_ = session;
+    dumpPath_ = normalizedPath;
     return true;
 }
 
+std::string DumpHelper::getDumpPath() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (!dumpPath_.empty()) {
+            return dumpPath_;
+        }
+    }
+    return ConfigHelper::getInstance().current()->saveConfig.dumpPath;
+}
+
 void DumpHelper::processFrame(std::shared_ptr<ob::Frame> frame) {
     if (!frame) return;
     
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
+    
+    // 触发式录制需要连续帧，不受帧间隔限制
+    if (config.saveConfig.enableTriggerRecord) {
+        triggerRecorder_->pushFrame(frame);
+    }
     
     // 使用统一的帧间隔检查
     bool shouldProcess = (frame->getIndex() % config.saveConfig.frameInterval == 0);
@@ -226,16 +326,24 @@ void DumpHelper::processFrame(std::shared_ptr<ob::Frame> frame) {
 
         // Process frame saving (if enabled)
         if (config.saveConfig.enableDump) {
+            // 运行中才开启保存（命令或配置热加载）时先初始化保存路径
+            if (!savePathRequested_.load(std::memory_order_relaxed) && !savePathRequested_.exchange(true)) {
+                initializeSavePath();
+            }
+            
+            // 帧数据与元数据共用一次提取的保存信息
+            SaveInfo info;
+            if (!prepareSaveInfo(frame, snapshot, info)) {
+                return;
+            }
+            
             // Save frame data
-            std::string frameTypeStr = frameTypeName(frame->getType());
-            LOG_DEBUG("Saving frame, type: ", frameTypeStr, ", index: ", frame->getIndex());
-            save(frame, config.saveConfig.dumpPath);
+            LOG_DEBUG("Saving frame, type: ", info.meta.typeName, ", index: ", info.meta.index);
+            saveFrame(frame, info);
             
             // Save metadata file (if enabled)
             if (config.saveConfig.saveMetadata) {
-                LOG_DEBUG("Saving metadata for frame, type: ", frameTypeStr, 
-                          ", index: ", frame->getIndex());
-                saveMetadata(frame, config.saveConfig.dumpPath);
+                saveMetadata(frame, info);
             }
         }
         
@@ -244,17 +352,128 @@ void DumpHelper::processFrame(std::shared_ptr<ob::Frame> frame) {
     }
 }
 
+bool DumpHelper::prepareSaveInfo(std::shared_ptr<ob::Frame> frame, ConfigHelper::SnapshotPtr snapshot, SaveInfo& info) {
+    const auto& config = *snapshot;
+    
+    std::shared_ptr<DumpSession> session;
+    std::string dumpPath;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        session = session_;
+        dumpPath = dumpPath_.empty() ? config.saveConfig.dumpPath : dumpPath_;
+    }
+    
+    // 未初始化会话时直接保存到 dumpPath
+    if (!session) {
+        info = SaveInfo(dumpPath, frame);
+        info.config = std::move(snapshot);
+        return info.valid();
+    }
+    
+    FrameMeta meta = FrameMeta::extract(frame);
+    
+    // 预估本帧写入的文件数，用于分片目录计数
+    int files = 0;
+    if (shouldSave(config, meta.type)) {
+        files = 1;
+        if (meta.type == OB_FRAME_DEPTH) {
+            files += (config.saveConfig.saveDepthColormap ? 1 : 0) + (config.saveConfig.saveDepthData ? 1 : 0);
+        }
+    }
+    if (config.saveConfig.saveMetadata && config.saveConfig.metadataFormat == "text") {
+        files++;
+    }
+    
+    DumpSession::Slot slot;
+    if (!session->acquire(meta.typeName, meta.timestamp.systemUs, files, slot)) {
+        return false;
+    }
+    
+    info = SaveInfo(std::move(session), slot, meta);
+    info.config = std::move(snapshot);
+    return true;
+}
+
+bool DumpHelper::trigger(const std::string& reason) {
+    return triggerRecorder_->trigger(reason);
+}
+
+void DumpHelper::flush() {
+    metadataLogger_->flush();
+    
+    std::shared_ptr<DumpWriter> writer;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        writer = writer_;
+    }
+    
+    if (writer) {
+        writer->flush();
+        auto stats = writer->getStats();
+        LOG_DEBUG("Dump writer (", writer->name(), ") flushed: files=", stats.filesWritten,
+                  ", MB=", stats.bytesWritten / (1024.0 * 1024.0),
+                  ", P99=", stats.p99LatencyMs, "ms, failures=", stats.failures);
+    }
+}
+
+std::shared_ptr<DumpWriter> DumpHelper::createWriter() const {
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
+    
+    DumpWriter::Options options;
+    options.maxInFlight = config.saveConfig.writerMaxInFlight;
+    options.maxQueued = config.saveConfig.writerMaxInFlight * 4;
+    options.directIO = config.saveConfig.writerDirectIO;
+    options.syncOnClose = config.saveConfig.writerSync;
+    return DumpWriter::create(config.saveConfig.writerBackend, options);
+}
+
+std::shared_ptr<DumpWriter> DumpHelper::getWriter() {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    if (!writer_) {
+        writer_ = createWriter();
+    }
+    return writer_;
+}
+
+bool DumpHelper::writeFile(const SaveInfo& info, const char* fileName, std::vector<uint8_t>&& data) {
+    auto writer = getWriter();
+    if (!writer) {
+        LOG_ERROR("No dump writer available for: ", fileName);
+        return false;
+    }
+    
+    size_t bytes = data.size();
+    if (!writer->write(info.dirFd, fileName, std::move(data), info.shard)) {
+        return false;
+    }
+    
+    if (info.session) {
+        info.session->addBytes(info.shardId, bytes);
+    }
+    return true;
+}
+
 void DumpHelper::save(std::shared_ptr<ob::Frame> frame, const std::string& path) {
     if (!frame) return;
 
     try {
         SaveInfo info(path, frame);
+        info.config = ConfigHelper::getInstance().current();
+        saveFrame(frame, info);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error saving frame: ", e.what());
+    }
+}
+
+void DumpHelper::saveFrame(std::shared_ptr<ob::Frame> frame, const SaveInfo& info) {
+    try {
         if (!info.valid()) {
             return;
         }
         
         // 检查是否应该保存此类型的帧
-        if (!shouldSave(info.meta.type)) {
+        if (!shouldSave(*info.config, info.meta.type)) {
             LOG_DEBUG("Frame type ", info.meta.typeName, " not saved - disabled");
             return;
         }
@@ -316,7 +535,11 @@ bool DumpHelper::saveImage(const cv::Mat& image, const SaveInfo& info,
     }
     
     try {
-        std::string filePath = info.filePath(suffix, ext);
+        char filePath[SaveInfo::PATH_SIZE];
+        if (info.fileName(filePath, sizeof(filePath), suffix.c_str(), ext.c_str()) == 0) {
+            LOG_ERROR("File name too long for ", info.meta.typeName);
+            return false;
+        }
         
         // 检查文件扩展名，确保使用正确的保存参数
         std::vector<int> params;
@@ -338,21 +561,21 @@ bool DumpHelper::saveImage(const cv::Mat& image, const SaveInfo& info,
                   ", type: ", image.type(),
                   ", channels: ", image.channels());
         
-        bool success = false;
-        if (params.empty()) {
-            success = cv::imwrite(filePath, image);
-        } else {
-            success = cv::imwrite(filePath, image, params);
+        // 在当前线程编码，落盘交给写盘后端异步完成
+        std::vector<uint8_t> encoded;
+        if (!cv::imencode(ext, image, encoded, params)) {
+            LOG_ERROR("Failed to save ", info.meta.typeName, ": ", filePath,
+                      " (cv::imencode returned false)");
+            return false;
         }
         
-        if (success) {
+        if (writeFile(info, filePath, std::move(encoded))) {
             LOG_DEBUG(info.meta.typeName, 
                      (suffix.empty() ? "" : " " + suffix), 
-                     " saved: ", filePath);
+                     " queued: ", filePath);
             return true;
         } else {
-            LOG_ERROR("Failed to save ", info.meta.typeName, ": ", filePath,
-                      " (cv::imwrite returned false)");
+            LOG_ERROR("Failed to queue ", info.meta.typeName, " file: ", filePath);
             return false;
         }
     }
@@ -370,18 +593,19 @@ bool DumpHelper::saveText(const std::string& content, const SaveInfo& info,
     }
     
     try {
-        std::string filePath = info.filePath(suffix, ext);
-        std::ofstream file(filePath);
+        char filePath[SaveInfo::PATH_SIZE];
+        if (info.fileName(filePath, sizeof(filePath), suffix.c_str(), ext.c_str()) == 0) {
+            LOG_ERROR("File name too long for ", info.meta.typeName);
+            return false;
+        }
         
-        if (file.is_open()) {
-            file << content;
-            file.close();
+        if (writeFile(info, filePath, std::vector<uint8_t>(content.begin(), content.end()))) {
             LOG_DEBUG(info.meta.typeName, 
                      (suffix.empty() ? "" : " " + suffix), 
-                     " saved: ", filePath);
+                     " queued: ", filePath);
             return true;
         } else {
-            LOG_ERROR("Failed to create ", info.meta.typeName, " file: ", filePath);
+            LOG_ERROR("Failed to queue ", info.meta.typeName, " file: ", filePath);
             return false;
         }
     }
@@ -391,6 +615,37 @@ bool DumpHelper::saveText(const std::string& content, const SaveInfo& info,
     }
 }
 
+bool DumpHelper::saveBinary(std::vector<uint8_t> content, const SaveInfo& info,
+                            const std::string& suffix, const std::string& ext) {
+    if (!info.valid()) {
+        LOG_ERROR("Invalid save info for ", info.meta.typeName);
+        return false;
+    }
+    
+    try {
+        char filePath[SaveInfo::PATH_SIZE];
+        if (info.fileName(filePath, sizeof(filePath), suffix.c_str(), ext.c_str()) == 0) {
+            LOG_ERROR("File name too long for ", info.meta.typeName);
+            return false;
+        }
+        size_t bytes = content.size();
+        
+        if (writeFile(info, filePath, std::move(content))) {
+            LOG_DEBUG(info.meta.typeName, 
+                     (suffix.empty() ? "" : " " + suffix), 
+                     " queued: ", filePath, ", bytes: ", bytes);
+            return true;
+        } else {
+            LOG_ERROR("Failed to queue ", info.meta.typeName, " file: ", filePath);
+            return false;
+        }
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("Error saving ", info.meta.typeName, " binary: ", e.what());
+        return false;
+    }
+}
+
 cv::Mat DumpHelper::convertVideoFrame(std::shared_ptr<ob::VideoFrame> video) {
     if (!video) {
         LOG_ERROR("convertVideoFrame: null video frame");
@@ -689,18 +944,28 @@ void DumpHelper::saveDepth(std::shared_ptr<ob::Frame> frame, const SaveInfo& inf
             return;
         }
         
-        // 保存原始深度 - 使用深拷贝
-        cv::Mat depthMat(height, width, CV_16UC1, data);
-        cv::Mat depthCopy = depthMat.clone();
-        
-        if (depthCopy.empty() || !depthCopy.data) {
-            LOG_ERROR("saveDepth: failed to create depth matrix");
-            return;
-        }
-        
-        saveImage(depthCopy, info);
+        const auto& config = *info.config;
 
-        auto& config = ConfigHelper::getInstance();
+        if (config.saveConfig.depthEncoding == "rvl") {
+            // RVL 无损编码：直接读取帧数据，无需拷贝
+            std::vector<uint8_t> encoded;
+            if (utils::DepthCodec::encode(reinterpret_cast<const uint16_t*>(data), width, height, encoded) > 0) {
+                saveBinary(std::move(encoded), info, "", ".rvl");
+            } else {
+                LOG_ERROR("saveDepth: RVL encoding failed");
+            }
+        } else {
+            // 保存原始深度 - 使用深拷贝
+            cv::Mat depthMat(height, width, CV_16UC1, data);
+            cv::Mat depthCopy = depthMat.clone();
+            
+            if (depthCopy.empty() || !depthCopy.data) {
+                LOG_ERROR("saveDepth: failed to create depth matrix");
+                return;
+            }
+            
+            saveImage(depthCopy, info);
+        }
 
         // 保存colormap
         if (config.saveConfig.saveDepthColormap) {
@@ -909,9 +1174,7 @@ cv::Mat DumpHelper::createColormap(std::shared_ptr<ob::DepthFrame> depth) {
     }
 }
 
-bool DumpHelper::shouldSave(OBFrameType frameType) const {
-    auto& config = ConfigHelper::getInstance();
-    
+bool DumpHelper::shouldSave(const ConfigHelper::Snapshot& config, OBFrameType frameType) {
     switch (frameType) {
         case OB_FRAME_COLOR:
             return config.saveConfig.saveColor && config.streamConfig.enableColor;
@@ -938,10 +1201,29 @@ void DumpHelper::saveMetadata(std::shared_ptr<ob::Frame> frame, const std::strin
     
     try {
         SaveInfo info(path, frame);
+        info.config = ConfigHelper::getInstance().current();
+        saveMetadata(frame, info);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error saving metadata: ", e.what());
+    }
+}
+
+void DumpHelper::saveMetadata(std::shared_ptr<ob::Frame> frame, const SaveInfo& info) {
+    if (!frame || !metadataHelper_) return;
+    
+    try {
         if (!info.valid()) {
             return;
         }
         
+        const auto& config = *info.config;
+        if (config.saveConfig.metadataFormat == "columnar") {
+            // 每个数据流追加一行定长记录
+            metadataLogger_->setFlushInterval(config.saveConfig.metadataFlushIntervalMs);
+            metadataLogger_->append(frame, info.basePath);
+            return;
+        }
+        
         // 使用 MetadataHelper 组件提取元数据内容
         std::string metadataContent = metadataHelper_->extractMetadataToString(frame);
         
@@ -1,12 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include <fcntl.h>
 #include <opencv2/opencv.hpp>
 #include "libobsensor/ObSensor.hpp"
+#include "DumpSession.hpp"
+#include "ConfigHelper.hpp"
 
 // 前向声明
 class MetadataHelper;
+class TriggerRecorder;
+class DumpWriter;
+class MetadataLogger;
 
 // 简化的格式转换函数声明
 std::string formatName(OBFormat format);
@@ -45,21 +54,35 @@ public:
         
         // 生成基础文件名
         std::string baseFileName() const;
+        
+        // 生成基础文件名到固定缓冲（整数格式化，无临时字符串），返回长度，空间不足返回0
+        size_t formatBaseName(char* out, size_t capacity) const;
     };
 
     // 简化：保存信息
     struct SaveInfo {
-        std::string basePath;       // 基础路径
+        static constexpr size_t BASE_NAME_SIZE = 128;   // 基础文件名缓冲大小
+        static constexpr size_t PATH_SIZE = 4096;       // 文件名/路径缓冲大小
+        
+        std::string basePath;       // 基础路径（会话保存时为会话根目录）
         FrameMeta meta;             // 帧元数据
+        int dirFd = AT_FDCWD;       // 保存目录句柄（会话分片目录），AT_FDCWD 表示使用 basePath
+        uint64_t shardId = 0;       // 会话分片编号（用于配额统计）
+        std::shared_ptr<DumpSession> session;       // 所属会话
+        std::shared_ptr<const DumpSession::ShardHandle> shard;  // 分片句柄（随写请求传给写盘后端，写完前保持有效）
+        ConfigHelper::SnapshotPtr config;           // 本帧使用的配置快照（每帧只读取一次）
+        char baseName[BASE_NAME_SIZE] = {};          // 预生成的基础文件名
+        size_t baseNameLength = 0;
         
         SaveInfo() = default;
         SaveInfo(const std::string& path, std::shared_ptr<ob::Frame> frame);
+        SaveInfo(std::shared_ptr<DumpSession> session, const DumpSession::Slot& slot, const FrameMeta& frameMeta);
         
-        // 生成完整文件路径
-        std::string filePath(const std::string& suffix = "", const std::string& ext = ".png") const;
+        // 生成文件名到固定缓冲（有目录句柄时为相对文件名，否则为完整路径），空间不足返回0
+        size_t fileName(char* out, size_t capacity, const char* suffix, const char* ext) const;
         
         // 检查是否有效
-        bool valid() const { return !basePath.empty(); }
+        bool valid() const { return !basePath.empty() && baseNameLength > 0; }
     };
 
     static DumpHelper& getInstance();
@@ -67,21 +90,30 @@ public:
     // 初始化保存路径
     bool initializeSavePath();
 
+    // 规范化后的保存根目录（以 / 结尾；未初始化时返回配置中的原值）
+    std::string getDumpPath();
+
     // 统一的帧处理接口 - 根据配置自动处理所有相关操作
     void processFrame(std::shared_ptr<ob::Frame> frame);
 
-    // 保存帧数据 - 简化的统一接口
+    // 保存帧数据到指定目录 - 简化的统一接口（周期保存使用会话目录布局）
     void save(std::shared_ptr<ob::Frame> frame, const std::string& path);
     
-    // 保存元数据到文件（使用 MetadataHelper 组件）
+    // 保存元数据到文件（列式日志使用 MetadataLogger 组件，文本格式使用 MetadataHelper 组件）
     void saveMetadata(std::shared_ptr<ob::Frame> frame, const std::string& path);
     
     // 显示元数据到控制台（使用 MetadataHelper 组件）
     void displayMetadata(std::shared_ptr<ob::Frame> frame, int interval);
 
+    // 触发一次事件录制（使用 TriggerRecorder 组件），保存触发前后的帧
+    bool trigger(const std::string& reason);
+
+    // 等待所有已提交的写盘请求完成，并刷新元数据日志
+    void flush();
+
 private:
     DumpHelper();
-    ~DumpHelper() = default;
+    ~DumpHelper();
     DumpHelper(const DumpHelper&) = delete;
     DumpHelper& operator=(const DumpHelper&) = delete;
     
@@ -91,6 +123,19 @@ private:
                    
     bool saveText(const std::string& content, const SaveInfo& info,
                   const std::string& suffix = "", const std::string& ext = ".txt");
+
+    bool saveBinary(std::vector<uint8_t> content, const SaveInfo& info,
+                    const std::string& suffix = "", const std::string& ext = ".bin");
+
+    // 按会话布局准备保存信息（帧数据与元数据共用），超过最大保存帧数时返回 false
+    bool prepareSaveInfo(std::shared_ptr<ob::Frame> frame, ConfigHelper::SnapshotPtr config, SaveInfo& info);
+    void saveFrame(std::shared_ptr<ob::Frame> frame, const SaveInfo& info);
+    void saveMetadata(std::shared_ptr<ob::Frame> frame, const SaveInfo& info);
+    
+    // 将文件内容交给写盘后端异步落盘
+    bool writeFile(const SaveInfo& info, const char* fileName, std::vector<uint8_t>&& data);
+    std::shared_ptr<DumpWriter> getWriter();
+    std::shared_ptr<DumpWriter> createWriter() const;
     
     // 具体保存方法 - 简化版本
     void saveColor(std::shared_ptr<ob::Frame> frame, const SaveInfo& info);
@@ -105,7 +150,7 @@ private:
     cv::Mat createColormap(std::shared_ptr<ob::DepthFrame> depth);
     
     // 简化的工具方法
-    bool shouldSave(OBFrameType frameType) const;
+    static bool shouldSave(const ConfigHelper::Snapshot& config, OBFrameType frameType);
     cv::Mat convertVideoFrame(std::shared_ptr<ob::VideoFrame> frame);
     
     // SDK格式转换器
@@ -113,4 +158,17 @@ private:
     
     // 元数据处理组件
     MetadataHelper* metadataHelper_;
+
+    // 列式元数据日志组件
+    std::unique_ptr<MetadataLogger> metadataLogger_;
+
+    // 触发式录制组件
+    TriggerRecorder* triggerRecorder_;
+
+    // 写盘后端（按配置创建，io_uring 不可用时回退到线程池）
+    std::shared_ptr<DumpWriter> writer_;
+    std::shared_ptr<DumpSession> session_;      // 周期保存会话（initializeSavePath 时创建）
+    std::string dumpPath_;                      // 规范化后的保存路径（配置中的 dumpPath 保持原值）
+    std::mutex writerMutex_;
+    std::atomic<bool> savePathRequested_{false};
 }; 
\ No newline at end of file
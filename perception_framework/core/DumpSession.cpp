@@ -0,0 +1,272 @@
+#include "DumpSession.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    // 写入固定宽度的十进制整数（补0）
+    inline char* putDigits(char* out, unsigned value, int width) {
+        for (int i = width - 1; i >= 0; i--) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return out + width;
+    }
+
+    uint64_t nowUs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    int openDirectory(int parentFd, const char* name) {
+        if (::mkdirat(parentFd, name, 0755) != 0 && errno != EEXIST) {
+            return -1;
+        }
+        return ::openat(parentFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+
+    void removeShardDirectory(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+        if (ec) {
+            LOG_WARN("DumpSession: failed to delete ", path, ": ", ec.message());
+        }
+    }
+}
+
+// ==================== 时间格式化 ====================
+
+size_t DumpSession::formatTime(uint64_t us, char* out) {
+    // 同一秒内复用 "YYYYmmdd_HHMMSS" 前缀
+    thread_local int64_t cachedSecond = -1;
+    thread_local char cachedPrefix[16];
+
+    int64_t second = static_cast<int64_t>(us / 1000000);
+    if (second != cachedSecond) {
+        time_t t = static_cast<time_t>(second);
+        struct tm local;
+        localtime_r(&t, &local);
+
+        char* p = cachedPrefix;
+        p = putDigits(p, static_cast<unsigned>(local.tm_year + 1900), 4);
+        p = putDigits(p, static_cast<unsigned>(local.tm_mon + 1), 2);
+        p = putDigits(p, static_cast<unsigned>(local.tm_mday), 2);
+        *p++ = '_';
+        p = putDigits(p, static_cast<unsigned>(local.tm_hour), 2);
+        p = putDigits(p, static_cast<unsigned>(local.tm_min), 2);
+        p = putDigits(p, static_cast<unsigned>(local.tm_sec), 2);
+        *p = '\0';
+        cachedSecond = second;
+    }
+
+    std::memcpy(out, cachedPrefix, 15);
+    out[15] = '_';
+    putDigits(out + 16, static_cast<unsigned>((us / 1000) % 1000), 3);
+    out[19] = '\0';
+    return 19;
+}
+
+// ==================== DumpSession ====================
+
+DumpSession::ShardHandle::~ShardHandle() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    // 最后一个在途写请求已完成，目录可以删除（不在写盘线程上执行 remove_all）
+    if (cleaner_) {
+        std::string path = removalPath_;
+        cleaner_->submit([path]() { removeShardDirectory(path); });
+    }
+}
+
+void DumpSession::ShardHandle::removeOnRelease(const std::string& path,
+                                               std::shared_ptr<utils::ThreadPool> cleaner) const {
+    removalPath_ = path;
+    cleaner_ = std::move(cleaner);
+}
+
+DumpSession::DumpSession(const Options& options)
+    : options_(options) {
+}
+
+DumpSession::~DumpSession() {
+    // 先等待后台删除完成
+    cleaner_.reset();
+
+    // 当前分片句柄在最后一个在途写请求完成后关闭
+    for (auto& entry : streams_) {
+        if (entry.second.fd >= 0) ::close(entry.second.fd);
+    }
+    streams_.clear();
+    if (rootFd_ >= 0) {
+        ::close(rootFd_);
+    }
+}
+
+bool DumpSession::open() {
+    char timeStr[20];
+    formatTime(nowUs(), timeStr);
+    timeStr[15] = '\0';   // 只保留到秒
+
+    sessionPath_ = Logger::ensureDirectoryExists(options_.rootPath + "session_" + timeStr, true);
+    if (sessionPath_.empty()) {
+        LOG_ERROR("DumpSession: failed to create session directory under ", options_.rootPath);
+        return false;
+    }
+
+    rootFd_ = ::open(sessionPath_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd_ < 0) {
+        LOG_ERROR("DumpSession: failed to open ", sessionPath_, ": ", std::strerror(errno));
+        return false;
+    }
+
+    if (options_.quotaMB > 0) {
+        cleaner_ = std::make_shared<utils::ThreadPool>(1);
+    }
+
+    LOG_INFO("Dump session: ", sessionPath_, " (files/dir: ", options_.filesPerDir,
+             ", bucket: ", options_.bucketMinutes, " min, max frames: ", options_.maxFrames,
+             ", quota: ", options_.quotaMB, " MB)");
+    return true;
+}
+
+bool DumpSession::acquire(const std::string& stream, uint64_t systemUs, int files, Slot& slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rootFd_ < 0) return false;
+
+    if (options_.maxFrames > 0 && stats_.framesSaved >= static_cast<uint64_t>(options_.maxFrames)) {
+        stats_.framesRejected++;
+        if (!rejectLogged_) {
+            LOG_WARN("DumpSession: maxFramesToSave (", options_.maxFrames, ") reached, further frames are not saved");
+            rejectLogged_ = true;
+        }
+        return false;
+    }
+
+    auto& dir = streams_[stream];
+    if (dir.fd < 0) {
+        dir.fd = openDirectory(rootFd_, stream.c_str());
+        if (dir.fd < 0) {
+            LOG_ERROR("DumpSession: failed to create stream directory ", sessionPath_, stream,
+                      ": ", std::strerror(errno));
+            streams_.erase(stream);
+            return false;
+        }
+    }
+
+    if (systemUs == 0) {
+        systemUs = nowUs();
+    }
+    int64_t bucketUs = static_cast<int64_t>(std::max(1, options_.bucketMinutes)) * 60 * 1000000;
+    int64_t bucket = static_cast<int64_t>(systemUs) / bucketUs;
+
+    if (dir.bucket != bucket) {
+        dir.shardIndex = 0;
+        if (!openShard(stream, dir, bucket, static_cast<uint64_t>(bucket * bucketUs))) return false;
+    } else if (dir.files > 0 && dir.files + files > options_.filesPerDir) {
+        dir.shardIndex++;
+        if (!openShard(stream, dir, bucket, static_cast<uint64_t>(bucket * bucketUs))) return false;
+    }
+
+    dir.files += files;
+    stats_.framesSaved++;
+
+    slot.dirFd = dir.shard->fd();
+    slot.shardId = dir.shard->id();
+    slot.shard = dir.shard;
+    return true;
+}
+
+bool DumpSession::openShard(const std::string& stream, StreamDir& dir, int64_t bucket, uint64_t bucketStartUs) {
+    // 分片目录名: YYYYmmdd_HHMM_<序号>
+    char name[24];
+    formatTime(bucketStartUs, name);
+    name[13] = '_';
+    putDigits(name + 14, static_cast<unsigned>(dir.shardIndex % 1000), 3);
+    name[17] = '\0';
+
+    int fd = openDirectory(dir.fd, name);
+    if (fd < 0) {
+        LOG_ERROR("DumpSession: failed to create shard directory ", sessionPath_, stream, "/", name,
+                  ": ", std::strerror(errno));
+        return false;
+    }
+
+    // 旧分片句柄由在途写请求继续持有，最后一个写完时关闭
+    dir.shard = std::make_shared<const ShardHandle>(fd, nextShardId_++);
+    dir.shardPath = sessionPath_ + stream + "/" + name + "/";
+    dir.bucket = bucket;
+    dir.files = 0;
+
+    Shard shard;
+    shard.id = dir.shard->id();
+    shard.path = dir.shardPath;
+    shard.handle = dir.shard;
+    shards_.push_back(std::move(shard));
+
+    LOG_DEBUG("DumpSession: new shard ", dir.shardPath);
+    return true;
+}
+
+void DumpSession::addBytes(uint64_t shardId, uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 通常是最新的分片，从后往前查找（已删除的分片不再计入）
+    for (auto it = shards_.rbegin(); it != shards_.rend(); ++it) {
+        if (it->id == shardId) {
+            it->bytes += bytes;
+            stats_.bytesSaved += bytes;
+            break;
+        }
+    }
+
+    if (options_.quotaMB > 0) {
+        enforceQuotaLocked();
+    }
+}
+
+void DumpSession::enforceQuotaLocked() {
+    const uint64_t quotaBytes = static_cast<uint64_t>(options_.quotaMB) * 1024 * 1024;
+
+    auto it = shards_.begin();
+    while (stats_.bytesSaved > quotaBytes && it != shards_.end()) {
+        // 跳过正在写入的分片（空闲数据流的当前分片不阻塞其他分片的删除）
+        bool current = false;
+        for (const auto& entry : streams_) {
+            if (entry.second.shard && entry.second.shard->id() == it->id) {
+                current = true;
+                break;
+            }
+        }
+        if (current) {
+            ++it;
+            continue;
+        }
+
+        stats_.bytesSaved -= std::min(stats_.bytesSaved, it->bytes);
+        stats_.shardsDeleted++;
+        LOG_INFO("DumpSession: quota ", options_.quotaMB, " MB exceeded, deleting ", it->path);
+
+        // 仍有在途写请求时由最后一个句柄引用释放时删除，否则立即提交删除
+        if (auto handle = it->handle.lock()) {
+            handle->removeOnRelease(it->path, cleaner_);
+        } else {
+            std::string path = it->path;
+            cleaner_->submit([path]() { removeShardDirectory(path); });
+        }
+        it = shards_.erase(it);
+    }
+}
+
+DumpSession::Stats DumpSession::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
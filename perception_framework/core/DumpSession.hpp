@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "ThreadPool.hpp"
+
+/**
+ * @brief 数据保存会话 - 在 DumpHelper::initializeSavePath 时创建一次
+ *
+ * 目录布局：
+ *   <dumpPath>/session_<YYYYmmdd_HHMMSS>/<数据流>/<时间桶>_<分片>/<文件>
+ *  - 时间桶按 bucketMinutes 划分（本地时间 YYYYmmdd_HHMM），
+ *    每个分片目录最多 filesPerDir 个文件，超过后创建下一个分片
+ *  - 会话根目录、数据流目录与当前分片目录的句柄被缓存，
+ *    文件通过 openat(分片句柄, 文件名) 写入，避免每帧 stat/创建目录与完整路径解析
+ *  - 分片句柄带引用计数：会话持有当前分片，每个在途写请求各持有一份，
+ *    最后一个引用释放时关闭句柄
+ *  - maxFrames 限制本会话保存的帧数（0 表示不限制）
+ *  - quotaMB 为磁盘配额（0 表示不限制），超出时在后台按创建顺序删除最旧的分片目录：
+ *    跳过各数据流正在写入的分片；仍有在途写请求的分片在最后一个句柄引用释放时删除
+ */
+class DumpSession {
+public:
+    struct Options {
+        std::string rootPath;       ///< 保存根目录（dumpPath）
+        int filesPerDir = 1000;     ///< 每个分片目录的文件数上限
+        int bucketMinutes = 10;     ///< 时间桶长度(分钟)
+        int maxFrames = 0;          ///< 最大保存帧数（0 不限制）
+        int quotaMB = 0;            ///< 磁盘配额(MB)（0 不限制）
+    };
+
+    /**
+     * @brief 分片目录句柄，最后一个引用释放时关闭
+     */
+    class ShardHandle {
+    public:
+        ShardHandle(int fd, uint64_t id) : fd_(fd), id_(id) {}
+        ~ShardHandle();
+
+        ShardHandle(const ShardHandle&) = delete;
+        ShardHandle& operator=(const ShardHandle&) = delete;
+
+        int fd() const { return fd_; }
+        uint64_t id() const { return id_; }
+
+        /**
+         * @brief 标记分片待删除：最后一个引用释放（句柄关闭）后由 cleaner 删除 path
+         * 只能由持有引用的一方调用
+         */
+        void removeOnRelease(const std::string& path, std::shared_ptr<utils::ThreadPool> cleaner) const;
+
+    private:
+        int fd_;
+        uint64_t id_;
+        mutable std::string removalPath_;
+        mutable std::shared_ptr<utils::ThreadPool> cleaner_;
+    };
+
+    /**
+     * @brief 一帧的保存位置
+     */
+    struct Slot {
+        int dirFd = -1;             ///< 分片目录句柄（用于 openat）
+        uint64_t shardId = 0;       ///< 分片编号（用于配额统计）
+        std::shared_ptr<const ShardHandle> shard;   ///< 写入完成前持有，保证 dirFd 有效
+    };
+
+    struct Stats {
+        uint64_t framesSaved = 0;   ///< 已保存帧数
+        uint64_t framesRejected = 0;///< 超过 maxFrames 被拒绝的帧数
+        uint64_t bytesSaved = 0;    ///< 当前会话占用字节数（已扣除删除的分片）
+        uint64_t shardsDeleted = 0; ///< 因配额删除的分片数
+    };
+
+    explicit DumpSession(const Options& options);
+    ~DumpSession();
+
+    DumpSession(const DumpSession&) = delete;
+    DumpSession& operator=(const DumpSession&) = delete;
+
+    /**
+     * @brief 创建会话根目录并打开句柄
+     */
+    bool open();
+
+    /**
+     * @brief 为一帧选择保存目录
+     * @param stream 数据流名称（如 "Color"）
+     * @param systemUs 帧系统时间戳(微秒)，用于选择时间桶
+     * @param files 该帧将写入的文件数（用于分片计数）
+     * @param slot 输出：保存位置
+     * @return 超过 maxFrames 或目录创建失败时返回 false
+     */
+    bool acquire(const std::string& stream, uint64_t systemUs, int files, Slot& slot);
+
+    /**
+     * @brief 记录写入分片的字节数，超出配额时调度删除最旧分片
+     */
+    void addBytes(uint64_t shardId, uint64_t bytes);
+
+    /**
+     * @brief 会话根目录（以 '/' 结尾）
+     */
+    const std::string& path() const { return sessionPath_; }
+
+    Stats getStats() const;
+
+    /**
+     * @brief 按整数格式化本地时间，不使用 stringstream/put_time
+     * 同一秒内复用上次 localtime 结果
+     * @param us 时间戳(微秒)
+     * @param out 输出缓冲，至少 20 字节，输出 "YYYYmmdd_HHMMSS_mmm"（以0结尾）
+     * @return 写入的字符数（不含结尾0）
+     */
+    static size_t formatTime(uint64_t us, char* out);
+
+private:
+    struct Shard {
+        uint64_t id = 0;
+        std::string path;           ///< 以 '/' 结尾
+        uint64_t bytes = 0;
+        std::weak_ptr<const ShardHandle> handle;   ///< 失效后没有在途写请求
+    };
+
+    struct StreamDir {
+        int fd = -1;                ///< 数据流目录句柄
+        std::shared_ptr<const ShardHandle> shard;  ///< 当前分片
+        std::string shardPath;
+        int64_t bucket = -1;        ///< 当前时间桶编号
+        int shardIndex = 0;         ///< 时间桶内分片序号
+        int files = 0;              ///< 当前分片文件数
+    };
+
+    bool openShard(const std::string& stream, StreamDir& dir, int64_t bucket, uint64_t bucketStartUs);
+    void enforceQuotaLocked();
+
+    Options options_;
+    std::string sessionPath_;
+    int rootFd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, StreamDir> streams_;
+    std::deque<Shard> shards_;              ///< 按创建顺序
+    uint64_t nextShardId_ = 1;
+    Stats stats_;
+    bool rejectLogged_ = false;
+
+    std::shared_ptr<utils::ThreadPool> cleaner_;   ///< 后台删除线程（待删除分片的句柄也持有）
+};
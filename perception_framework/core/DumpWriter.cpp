@@ -0,0 +1,163 @@
+#include "DumpWriter.hpp"
+#include "IoUringDumpWriter.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ==================== DumpWriter ====================
+
+std::unique_ptr<DumpWriter> DumpWriter::create(const std::string& backend, const Options& options) {
+    if (backend == "io_uring") {
+        if (IoUringDumpWriter::isSupported()) {
+            auto writer = std::make_unique<IoUringDumpWriter>(options);
+            if (writer->isValid()) {
+                LOG_INFO("Dump writer backend: io_uring (in-flight: ", options.maxInFlight,
+                         ", buffer: ", options.bufferSize / 1024, " KB, O_DIRECT: ", options.directIO, ")");
+                return writer;
+            }
+        }
+        LOG_WARN("io_uring not available, falling back to thread pool dump writer");
+    } else if (backend != "threadpool") {
+        LOG_WARN("Unknown dump writer backend: ", backend, ", using threadpool");
+    }
+
+    LOG_INFO("Dump writer backend: threadpool (threads: ",
+             std::max(1, std::min(options.maxInFlight, 8)), ")");
+    return std::make_unique<ThreadPoolDumpWriter>(options);
+}
+
+DumpWriter::Stats DumpWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    Stats stats = stats_;
+
+    if (hasSubmit_) {
+        double seconds = std::chrono::duration<double>(Clock::now() - firstSubmit_).count();
+        if (seconds > 0.0) {
+            stats.throughputMBps = stats.bytesWritten / (1024.0 * 1024.0) / seconds;
+        }
+    }
+
+    if (!latencies_.empty()) {
+        std::vector<float> sorted = latencies_;
+        auto percentile = [&sorted](double p) {
+            size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+            std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+            return static_cast<double>(sorted[index]);
+        };
+        stats.p50LatencyMs = percentile(0.50);
+        stats.p99LatencyMs = percentile(0.99);
+    }
+    return stats;
+}
+
+void DumpWriter::resetStats() {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    stats_ = Stats{};
+    latencies_.clear();
+    latencyIndex_ = 0;
+    hasSubmit_ = false;
+}
+
+void DumpWriter::recordSubmit() {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    if (!hasSubmit_) {
+        firstSubmit_ = Clock::now();
+        hasSubmit_ = true;
+    }
+}
+
+void DumpWriter::recordCompletion(size_t bytes, Clock::time_point submitTime, bool success) {
+    float latencyMs = std::chrono::duration<float, std::milli>(Clock::now() - submitTime).count();
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    if (!success) {
+        stats_.failures++;
+        return;
+    }
+
+    stats_.filesWritten++;
+    stats_.bytesWritten += bytes;
+
+    if (latencies_.size() < LATENCY_SAMPLES) {
+        latencies_.push_back(latencyMs);
+    } else {
+        latencies_[latencyIndex_] = latencyMs;
+        latencyIndex_ = (latencyIndex_ + 1) % LATENCY_SAMPLES;
+    }
+}
+
+// ==================== ThreadPoolDumpWriter ====================
+
+ThreadPoolDumpWriter::ThreadPoolDumpWriter(const Options& options)
+    : options_(options) {
+    size_t threads = static_cast<size_t>(std::max(1, std::min(options_.maxInFlight, 8)));
+    pool_ = std::make_unique<utils::ThreadPool>(threads);
+}
+
+ThreadPoolDumpWriter::~ThreadPoolDumpWriter() {
+    flush();
+    pool_.reset();
+}
+
+bool ThreadPoolDumpWriter::write(int dirFd, const std::string& name, std::vector<uint8_t>&& data,
+                                 std::shared_ptr<const void> dirOwner) {
+    {
+        // 背压：排队文件数达到上限时等待
+        std::unique_lock<std::mutex> lock(pendingMutex_);
+        pendingCondition_.wait(lock, [this] { return pending_ < std::max(1, options_.maxQueued); });
+        pending_++;
+    }
+
+    recordSubmit();
+    auto submitTime = Clock::now();
+    auto payload = std::make_shared<std::vector<uint8_t>>(std::move(data));
+
+    pool_->submit([this, dirFd, name, payload, submitTime, dirOwner = std::move(dirOwner)]() mutable {
+        writeFile(dirFd, name, *payload, submitTime);
+        dirOwner.reset();
+
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pending_--;
+        pendingCondition_.notify_all();
+    });
+    return true;
+}
+
+void ThreadPoolDumpWriter::flush() {
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    pendingCondition_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void ThreadPoolDumpWriter::writeFile(int dirFd, const std::string& path, const std::vector<uint8_t>& data,
+                                     Clock::time_point submitTime) {
+    int fd = ::openat(dirFd, path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Dump writer: failed to open ", path, ": ", std::strerror(errno));
+        recordCompletion(0, submitTime, false);
+        return;
+    }
+
+    bool success = true;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t n = ::write(fd, data.data() + offset, data.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("Dump writer: failed to write ", path, ": ", std::strerror(errno));
+            success = false;
+            break;
+        }
+        offset += static_cast<size_t>(n);
+    }
+
+    if (success && options_.syncOnClose && ::fdatasync(fd) != 0) {
+        LOG_ERROR("Dump writer: fdatasync failed for ", path, ": ", std::strerror(errno));
+        success = false;
+    }
+
+    ::close(fd);
+    recordCompletion(data.size(), submitTime, success);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include "ThreadPool.hpp"
+
+/**
+ * @brief 数据保存写盘后端 - 可插拔接口
+ *
+ * DumpHelper 将编码好的文件内容交给写盘后端异步落盘，
+ * 避免在帧处理线程中执行阻塞的 open/write/close 序列。
+ * 提供两种实现：
+ *  - "threadpool"：可移植的线程池实现（POSIX open/write/close）
+ *  - "io_uring"  ：Linux io_uring 实现（批量提交、注册缓冲区、O_DIRECT、限制在途请求数）
+ * io_uring 不可用时自动回退到线程池实现。
+ */
+class DumpWriter {
+public:
+    /**
+     * @brief 写盘后端参数
+     */
+    struct Options {
+        int maxInFlight = 16;                   ///< 最大在途写请求数（io_uring 为 SQE 数，线程池为线程数上限）
+        int maxQueued = 64;                     ///< 最大排队文件数，超出时 write() 阻塞（背压）
+        size_t bufferSize = 1024 * 1024;        ///< io_uring 注册缓冲区大小（同时也是单次写入分块大小）
+        bool directIO = true;                   ///< 大文件使用 O_DIRECT（需要对齐时自动补齐后截断）
+        size_t directThreshold = 256 * 1024;    ///< 启用 O_DIRECT 的最小文件大小
+        bool syncOnClose = false;               ///< 关闭前执行 fdatasync
+    };
+
+    /**
+     * @brief 写盘统计信息
+     */
+    struct Stats {
+        uint64_t filesWritten = 0;      ///< 成功写入的文件数
+        uint64_t bytesWritten = 0;      ///< 成功写入的字节数
+        uint64_t failures = 0;          ///< 失败的文件数
+        double throughputMBps = 0.0;    ///< 持续吞吐（首次提交至今）
+        double p50LatencyMs = 0.0;      ///< 提交到落盘完成的延迟中位数
+        double p99LatencyMs = 0.0;      ///< 提交到落盘完成的 P99 延迟
+    };
+
+    virtual ~DumpWriter() = default;
+
+    /**
+     * @brief 创建写盘后端
+     * @param backend 后端名称: "threadpool" 或 "io_uring"
+     * @param options 后端参数
+     * @return 写盘后端实例（io_uring 不可用时返回线程池实现）
+     */
+    static std::unique_ptr<DumpWriter> create(const std::string& backend, const Options& options);
+
+    /**
+     * @brief 异步写入整个文件（覆盖已有文件）
+     * 队列已满时阻塞等待
+     * @param path 文件路径（目录需已存在）
+     * @param data 文件内容（所有权转移给写盘后端）
+     * @return 是否成功提交
+     */
+    bool write(const std::string& path, std::vector<uint8_t>&& data) {
+        return write(AT_FDCWD, path, std::move(data));
+    }
+
+    /**
+     * @brief 异步写入目录下的文件（openat，避免每次解析完整路径）
+     * @param dirFd 目录句柄，需保持打开直到 flush() 返回；AT_FDCWD 表示 name 为普通路径
+     * @param name 相对 dirFd 的文件名
+     * @param data 文件内容（所有权转移给写盘后端）
+     * @return 是否成功提交
+     */
+    bool write(int dirFd, const std::string& name, std::vector<uint8_t>&& data) {
+        return write(dirFd, name, std::move(data), nullptr);
+    }
+
+    /**
+     * @brief 异步写入目录下的文件，写入期间持有目录句柄的所有者
+     * @param dirOwner 保持 dirFd 有效的对象（如会话分片句柄），该文件写完（或失败）后才释放
+     */
+    virtual bool write(int dirFd, const std::string& name, std::vector<uint8_t>&& data,
+                       std::shared_ptr<const void> dirOwner) = 0;
+
+    /**
+     * @brief 等待所有已提交的写请求完成
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @brief 获取后端名称
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 重置统计信息
+     */
+    void resetStats();
+
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 记录一个文件的写入结果（由实现类在完成时调用）
+     */
+    void recordCompletion(size_t bytes, Clock::time_point submitTime, bool success);
+
+    /**
+     * @brief 记录首次提交时间（用于计算持续吞吐）
+     */
+    void recordSubmit();
+
+private:
+    static constexpr size_t LATENCY_SAMPLES = 8192;   ///< 延迟采样窗口大小
+
+    mutable std::mutex statsMutex_;
+    Stats stats_;
+    std::vector<float> latencies_;              ///< 最近的延迟样本(毫秒)，环形覆盖
+    size_t latencyIndex_ = 0;
+    Clock::time_point firstSubmit_;
+    bool hasSubmit_ = false;
+};
+
+/**
+ * @brief 线程池写盘后端（可移植回退实现）
+ */
+class ThreadPoolDumpWriter : public DumpWriter {
+public:
+    explicit ThreadPoolDumpWriter(const Options& options);
+    ~ThreadPoolDumpWriter() override;
+
+    using DumpWriter::write;
+    bool write(int dirFd, const std::string& name, std::vector<uint8_t>&& data,
+               std::shared_ptr<const void> dirOwner) override;
+    void flush() override;
+    const char* name() const override { return "threadpool"; }
+
+private:
+    void writeFile(int dirFd, const std::string& name, const std::vector<uint8_t>& data,
+                   Clock::time_point submitTime);
+
+    Options options_;
+    std::unique_ptr<utils::ThreadPool> pool_;
+    std::mutex pendingMutex_;
+    std::condition_variable pendingCondition_;
+    int pending_ = 0;
+};
@@ -30,7 +30,8 @@ bool ImageReceiver::initialize() {
     try {
         LOG_INFO("Initializing ImageReceiver...");
         
-        auto& config = ConfigHelper::getInstance();
+        auto snapshot = ConfigHelper::getInstance().current();
+        const auto& config = *snapshot;
         
         // 初始化数据保存路径（由DumpHelper负责）
         if(config.saveConfig.enableDump) {
@@ -42,6 +43,7 @@ bool ImageReceiver::initialize() {
         // 配置并行处理
         enableParallelProcessing_ = config.parallelConfig.enableParallelProcessing;
         threadPoolSize_ = config.parallelConfig.threadPoolSize;
+        maxQueuedTasks_ = static_cast<size_t>(config.parallelConfig.maxQueuedTasks);
         
         // 创建线程池
         if(enableParallelProcessing_) {
@@ -206,7 +208,8 @@ bool ImageReceiver::setupPipelines() {
     }
     
     try {
-        auto& config = ConfigHelper::getInstance();
+        auto snapshot = ConfigHelper::getInstance().current();
+        const auto& config = *snapshot;
         
         // 重新创建Pipeline对象以确保正确初始化
         mainPipeline_ = std::make_shared<ob::Pipeline>(device);
@@ -224,7 +227,7 @@ bool ImageReceiver::setupPipelines() {
         bool hasEnabledStreams = false;
         for(uint32_t i = 0; i < sensorList->getCount(); ++i) {
             auto sensorType = sensorList->getSensorType(i);
-            if(isVideoSensorTypeEnabled(sensorType)) {
+            if(isVideoSensorTypeEnabled(config.streamConfig, sensorType)) {
                 config_->enableStream(sensorType);
                 hasEnabledStreams = true;
                 LOG_DEBUG("Enabled sensor type: ", sensorType);
@@ -274,7 +277,7 @@ bool ImageReceiver::startPipelines() {
         }
         
         // 启动IMU数据流
-        if(ConfigHelper::getInstance().streamConfig.enableIMU && 
+        if(ConfigHelper::getInstance().current()->streamConfig.enableIMU && 
            imuPipeline_ && imuConfig_) {
             try {
                 imuPipeline_->start(imuConfig_, [this](std::shared_ptr<ob::FrameSet> frameset) {
@@ -357,17 +360,7 @@ void ImageReceiver::processFrameSetSerial(std::shared_ptr<ob::FrameSet> frameset
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
         // Update performance statistics
-        performanceStats_.currentProcessingTime = duration;
-        performanceStats_.totalProcessingTime += duration;
-        performanceStats_.processedFramesCount++;
-        
-        // Update min and max processing times
-        if (duration < performanceStats_.minProcessingTime) {
-            performanceStats_.minProcessingTime = duration;
-        }
-        if (duration > performanceStats_.maxProcessingTime) {
-            performanceStats_.maxProcessingTime = duration;
-        }
+        recordProcessingTime(duration);
 
         // Log frame processing info
         std::string frameTypeStr = ob::TypeHelper::convertOBFrameTypeToString(frameType);
@@ -422,18 +415,7 @@ void ImageReceiver::processFrameSetParallel(std::shared_ptr<ob::FrameSet> frames
                     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
                     // 更新性能统计数据
-                    performanceStats_.currentProcessingTime = duration;
-                    performanceStats_.totalProcessingTime += duration;
-                    performanceStats_.processedFramesCount++;
-                    
-                    // 更新最小和最大处理时间
-                    // 注意：这里可能有多线程竞争，但对统计数据影响很小
-                    if (duration < performanceStats_.minProcessingTime) {
-                        performanceStats_.minProcessingTime = duration;
-                    }
-                    if (duration > performanceStats_.maxProcessingTime) {
-                        performanceStats_.maxProcessingTime = duration;
-                    }
+                    this->recordProcessingTime(duration);
 
                     // 帧类型文本描述
                     std::string frameTypeStr = ob::TypeHelper::convertOBFrameTypeToString(frame->type());
@@ -482,8 +464,7 @@ void ImageReceiver::cleanupCompletedTasks() {
     );
     
     // If queue is too long, wait for some tasks to complete
-    auto& config = ConfigHelper::getInstance();
-    if(frameFutures_.size() > static_cast<size_t>(config.parallelConfig.maxQueuedTasks)) {
+    if(frameFutures_.size() > maxQueuedTasks_) {
         LOG_WARN("Waiting for tasks in queue to complete, current queue size: ", frameFutures_.size());
         if(!frameFutures_.empty()) {
             // Wait for first task to complete
@@ -519,10 +500,13 @@ void ImageReceiver::run() {
     try {
         LOG_INFO("Starting ImageReceiver main loop...");
         
+        // 性能统计由全局时间轮每秒更新一次，不再在主循环中轮询
+        statsTimer_ = utils::TimerWheel::getInstance().schedulePeriodic(
+            std::chrono::milliseconds(STATS_INTERVAL_MS), [this]() { updatePerformanceStats(); });
+        
         // 主循环 - 不再包含窗口显示逻辑
         while(!shouldExit_) {
             renderFrames(); // 只处理帧数据，不进行显示
-            updatePerformanceStats();
             
             // 控制循环频率
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -543,7 +527,7 @@ void ImageReceiver::run() {
 
 // 处理窗口事件，但不进行显示（显示由主线程负责）
 bool ImageReceiver::processWindowEvents() {
-    if (!window_ || !ConfigHelper::getInstance().renderConfig.enableRendering) {
+    if (!window_ || !ConfigHelper::getInstance().current()->renderConfig.enableRendering) {
         return true; // 无窗口或禁用渲染时，返回true表示继续运行
     }
     
@@ -552,7 +536,8 @@ bool ImageReceiver::processWindowEvents() {
 }
 
 void ImageReceiver::renderFrames() {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if(!config.renderConfig.enableRendering || !window_) {
         // 在无头模式下或无窗口时，仍然可以处理数据但不进行渲染
@@ -611,39 +596,51 @@ void ImageReceiver::renderFrames() {
 }
 
 void ImageReceiver::updatePerformanceStats() {
-    auto& config = ConfigHelper::getInstance().inferenceConfig;
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->inferenceConfig;
     if(!config.enablePerformanceStats) {
         return;
     }
     
+    // 在定时线程中执行，与按键触发的重置/打印互斥
+    std::lock_guard<std::mutex> lock(statsMutex_);
     auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - performanceStats_.lastStatsTime).count();
     
-    if(elapsed >= 1000) {  // 每秒更新一次
-        auto totalElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - performanceStats_.startTime).count();
-        
-        performanceStats_.currentFPS = (performanceStats_.frameCount.load() * 1000.0) / elapsed;
-        performanceStats_.averageFPS = (performanceStats_.totalFrames.load() * 1000.0) / totalElapsed;
-        
-        // 计算平均处理时间
-        auto processedFrames = performanceStats_.processedFramesCount.load();
-        if (processedFrames > 0) {
-            performanceStats_.avgProcessingTime = 
-                static_cast<double>(performanceStats_.totalProcessingTime.load()) / processedFrames;
-        }
-        
-        // 重置帧计数器，但保留总处理时间统计(仅在需要时重置)
-        performanceStats_.frameCount = 0;
-        performanceStats_.lastStatsTime = now;
-        
-        updateWindowTitle();
+    // 按实际经过的时间计算，定时器早到或晚到都不影响结果
+    double elapsed = std::chrono::duration<double>(now - performanceStats_.lastStatsTime).count();
+    double totalElapsed = std::chrono::duration<double>(now - performanceStats_.startTime).count();
+    if (elapsed <= 0.0 || totalElapsed <= 0.0) {
+        return;
     }
+    
+    // 取出并清零帧计数器，计数与清零之间到达的帧计入下一个周期
+    performanceStats_.currentFPS = performanceStats_.frameCount.exchange(0) / elapsed;
+    performanceStats_.averageFPS = performanceStats_.totalFrames.load() / totalElapsed;
+    performanceStats_.lastStatsTime = now;
+    
+    // 计算平均处理时间（保留总处理时间统计，仅在需要时重置）
+    auto processedFrames = performanceStats_.processedFramesCount.load();
+    if (processedFrames > 0) {
+        performanceStats_.avgProcessingTime = 
+            static_cast<double>(performanceStats_.totalProcessingTime.load()) / processedFrames;
+    }
+    
+    updateWindowTitle();
+}
+
+void ImageReceiver::recordProcessingTime(double durationMs) {
+    performanceStats_.currentProcessingTime = durationMs;
+    performanceStats_.totalProcessingTime += static_cast<uint64_t>(durationMs);
+    performanceStats_.processedFramesCount++;
+    
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    performanceStats_.minProcessingTime = std::min(performanceStats_.minProcessingTime, durationMs);
+    performanceStats_.maxProcessingTime = std::max(performanceStats_.maxProcessingTime, durationMs);
 }
 
 void ImageReceiver::updateWindowTitle() {
-    auto& config = ConfigHelper::getInstance().renderConfig;
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->renderConfig;
     if(!config.showFPS || !window_) {
         return;
     }
@@ -663,17 +660,27 @@ void ImageReceiver::updateWindowTitle() {
 }
 
 void ImageReceiver::printPerformanceStats() {
+    double currentFPS, averageFPS, avgProcessingTime, minProcessingTime, maxProcessingTime;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        currentFPS = performanceStats_.currentFPS;
+        averageFPS = performanceStats_.averageFPS;
+        avgProcessingTime = performanceStats_.avgProcessingTime;
+        minProcessingTime = performanceStats_.minProcessingTime;
+        maxProcessingTime = performanceStats_.maxProcessingTime;
+    }
+    
     LOG_INFO("=== Performance Statistics ===");
-    LOG_INFO("Current FPS: ", performanceStats_.currentFPS);
-    LOG_INFO("Average FPS: ", performanceStats_.averageFPS);
+    LOG_INFO("Current FPS: ", currentFPS);
+    LOG_INFO("Average FPS: ", averageFPS);
     LOG_INFO("Total Frames: ", performanceStats_.totalFrames.load());
     
     // 添加处理时间统计信息
     LOG_INFO("Frame Processing Time Statistics:");
     LOG_INFO("  - Current: ", performanceStats_.currentProcessingTime.load(), " ms");
-    LOG_INFO("  - Average: ", performanceStats_.avgProcessingTime, " ms");
-    LOG_INFO("  - Minimum: ", performanceStats_.minProcessingTime, " ms");
-    LOG_INFO("  - Maximum: ", performanceStats_.maxProcessingTime, " ms");
+    LOG_INFO("  - Average: ", avgProcessingTime, " ms");
+    LOG_INFO("  - Minimum: ", minProcessingTime, " ms");
+    LOG_INFO("  - Maximum: ", maxProcessingTime, " ms");
     LOG_INFO("  - Processed Frames: ", performanceStats_.processedFramesCount.load());
     
     LOG_INFO("Device State: ", static_cast<int>(deviceManager_->getDeviceState()));
@@ -689,6 +696,13 @@ void ImageReceiver::printPerformanceStats() {
         LOG_INFO("Parallel Processing: Disabled");
     }
     
+    // 全局时间轮（统计更新、无信号画面、热插拔、请求超时）的触发精度
+    auto timerStats = utils::TimerWheel::getInstance().getStats();
+    LOG_INFO("Timer Wheel: active=", timerStats.active, ", fired=", timerStats.fired,
+             ", wakeups=", timerStats.wakeups, ", skipped=", timerStats.skipped);
+    LOG_INFO("  - Lateness: mean=", timerStats.meanLateUs, " us, p50=", timerStats.p50LateUs,
+             " us, p99=", timerStats.p99LateUs, " us, max=", timerStats.maxLateUs, " us");
+    
     LOG_INFO("==============================");
     }
 
@@ -697,14 +711,13 @@ void ImageReceiver::stop() {
     shouldExit_ = true;
 }
 
-bool ImageReceiver::isVideoSensorTypeEnabled(OBSensorType sensorType) {
+bool ImageReceiver::isVideoSensorTypeEnabled(const ConfigHelper::StreamConfig& config, OBSensorType sensorType) {
     // 首先使用 SDK 提供的方法判断是否为视频传感器
     if (!ob::TypeHelper::isVideoSensorType(sensorType)) {
         return false;
     }
     
     // 再根据配置判断是否启用
-    auto& config = ConfigHelper::getInstance().streamConfig;
     switch(sensorType) {
         case OB_SENSOR_COLOR: return config.enableColor;
         case OB_SENSOR_DEPTH: return config.enableDepth;
@@ -727,6 +740,8 @@ void ImageReceiver::cleanup() {
         LOG_INFO("Cleaning up ImageReceiver...");
         
         shouldExit_ = true;
+        utils::TimerWheel::getInstance().cancel(statsTimer_);
+        statsTimer_ = utils::TimerWheel::INVALID_TIMER;
         stopPipelines();
         
         // 等待所有任务完成
@@ -882,6 +897,7 @@ bool ImageReceiver::restartStreaming() {
 }
 
 void ImageReceiver::resetPerformanceStats() {
+    std::lock_guard<std::mutex> lock(statsMutex_);
     auto now = std::chrono::steady_clock::now();
     
     performanceStats_.frameCount = 0;
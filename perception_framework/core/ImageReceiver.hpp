@@ -24,6 +24,7 @@
 #include "MetadataHelper.hpp"
 #include "DeviceManager.hpp"
 #include "ThreadPool.hpp"
+#include "TimerWheel.hpp"
 
 /**
  * @brief 图像接收器 - 主要的相机数据处理类
@@ -150,7 +151,7 @@ private:
     void stopPipelines();
     
     // 数据流管理
-    bool isVideoSensorTypeEnabled(OBSensorType sensorType);
+    static bool isVideoSensorTypeEnabled(const ConfigHelper::StreamConfig& config, OBSensorType sensorType);
     
     // 设备事件处理
     void onDeviceStateChanged(DeviceManager::DeviceState oldState, 
@@ -169,6 +170,7 @@ private:
     void updatePerformanceStats();
     void printPerformanceStats();
     void resetPerformanceStats();
+    void recordProcessingTime(double durationMs);
     
     // 并行处理
     void processFrameSetParallel(std::shared_ptr<ob::FrameSet> frameset);
@@ -207,7 +209,7 @@ private:
     std::atomic<bool> isInitialized_{false};
     std::atomic<StreamState> streamState_{StreamState::IDLE};
     
-    // 性能统计
+    // 性能统计（非原子字段受 statsMutex_ 保护：统计在定时线程更新，重置/打印由按键触发）
     struct PerformanceStats {
         std::atomic<uint64_t> frameCount{0};
         std::atomic<uint64_t> totalFrames{0};
@@ -224,6 +226,10 @@ private:
         double maxProcessingTime{0.0};                 // 最大处理时间(毫秒)
         double avgProcessingTime{0.0};                 // 平均处理时间(毫秒)
     } performanceStats_;
+    std::mutex statsMutex_;
+    utils::TimerWheel::TimerId statsTimer_ = utils::TimerWheel::INVALID_TIMER;  // 更新统计的周期定时器
+    // 触发时刻有抖动，FPS 按两次更新之间实际经过的时间计算
+    static constexpr int STATS_INTERVAL_MS = 1000;
 
     // 热插拔相关
     std::atomic<int> reconnectAttempts_{0};
@@ -236,6 +242,7 @@ private:
     // 并行处理配置
     bool enableParallelProcessing_ = true;  // 启用并行处理
     int threadPoolSize_ = 4;                // 线程池大小
+    size_t maxQueuedTasks_ = 100;           // 等待完成的最大任务数（启动时从配置读取）
     
     // 跟踪并行任务完成
     std::mutex futuresMutex_;
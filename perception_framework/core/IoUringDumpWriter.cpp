@@ -0,0 +1,670 @@
+#include "IoUringDumpWriter.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PERCEPTION_HAS_IO_URING 1
+#endif
+#endif
+
+#ifdef PERCEPTION_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+
+constexpr size_t DIRECT_ALIGNMENT = 4096;   // O_DIRECT 偏移/长度/缓冲区对齐
+
+inline size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/**
+ * @brief 单个文件的写入任务
+ */
+struct IoUringDumpWriter::Job {
+    int dirFd = AT_FDCWD;
+    std::shared_ptr<const void> dirOwner;   // 保持 dirFd 有效，任务结束时释放
+    std::string path;
+    std::vector<uint8_t> data;
+    Clock::time_point submitTime;
+    int fd = -1;
+    bool direct = false;        // 是否以 O_DIRECT 打开
+    bool opening = false;       // 是否已提交 OPENAT
+    size_t nextOffset = 0;      // 已准备写入的字节数
+    unsigned outstanding = 0;   // 在途 SQE 数
+    bool prepared = false;      // 所有写请求是否已准备
+    bool closing = false;       // 是否已提交 截断/同步/关闭 链
+    bool failed = false;
+};
+
+#ifdef PERCEPTION_HAS_IO_URING
+
+namespace {
+
+// 6.9 内核新增，旧版 <linux/io_uring.h> 中没有该枚举值；是否可用以 IORING_REGISTER_PROBE 结果为准
+constexpr uint8_t OP_FTRUNCATE = 55;
+
+enum class OpKind : uint8_t {
+    OPEN,
+    WRITE,
+    TRUNCATE,
+    SYNC,
+    CLOSE
+};
+
+/**
+ * @brief 一次 SQE 对应的上下文（通过 user_data 传递）
+ */
+struct Operation {
+    void* job;
+    OpKind kind;
+    int bufferIndex;    // 仅 WRITE 使用
+    unsigned length;
+    uint64_t offset;    // 文件偏移
+    unsigned done;      // 短写后已完成的字节数
+};
+
+inline int sysSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+inline int sysRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/**
+ * @brief 通过 IORING_REGISTER_PROBE 检查所需操作码
+ * 写入、OPENAT、CLOSE、FSYNC 缺一不可；FTRUNCATE 只决定能否使用 O_DIRECT（尾块补齐后需截断）
+ * @param canTruncate 输出：是否支持 IORING_OP_FTRUNCATE
+ */
+bool probeRequiredOps(int ringFd, bool& canTruncate) {
+    constexpr unsigned PROBE_OPS = 256;
+    std::vector<uint8_t> storage(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    canTruncate = false;
+    if (sysRegister(ringFd, IORING_REGISTER_PROBE, probe, PROBE_OPS) != 0) {
+        return false;  // 5.6 之前的内核不支持探测，同样不支持 OPENAT/CLOSE
+    }
+
+    auto supported = [probe](unsigned op) {
+        return op <= probe->last_op && op < probe->ops_len &&
+               (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    };
+    canTruncate = supported(OP_FTRUNCATE);
+    return supported(IORING_OP_WRITE) && supported(IORING_OP_WRITE_FIXED) &&
+           supported(IORING_OP_OPENAT) && supported(IORING_OP_CLOSE) && supported(IORING_OP_FSYNC);
+}
+
+} // namespace
+
+/**
+ * @brief io_uring 提交/完成队列的内存映射
+ */
+struct IoUringDumpWriter::Ring {
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned toSubmit = 0;      // 已放入 SQ 尚未提交的 SQE 数
+
+    void* sqPtr = MAP_FAILED;
+    size_t sqSize = 0;
+    void* cqPtr = MAP_FAILED;
+    size_t cqSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    bool setup(unsigned requested) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = sysSetup(requested, &params);
+        if (fd < 0) return false;
+
+        entries = params.sq_entries;
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+
+        sqPtr = ::mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED) return false;
+
+        if (singleMmap) {
+            cqPtr = sqPtr;
+        } else {
+            cqPtr = ::mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED) return false;
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesPtr = ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqesPtr == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+        auto* sq = static_cast<uint8_t*>(sqPtr);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<uint8_t*>(cqPtr);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void teardown() {
+        if (sqes) ::munmap(sqes, sqesSize);
+        if (cqPtr != MAP_FAILED && cqPtr != sqPtr) ::munmap(cqPtr, cqSize);
+        if (sqPtr != MAP_FAILED) ::munmap(sqPtr, sqSize);
+        if (fd >= 0) ::close(fd);
+        sqes = nullptr;
+        sqPtr = cqPtr = MAP_FAILED;
+        fd = -1;
+    }
+
+    // 获取一个空闲 SQE（填充后需调用 commit）
+    io_uring_sqe* acquire() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        unsigned tail = *sqTail;
+        if (tail - head >= entries) return nullptr;
+        io_uring_sqe* sqe = &sqes[tail & *sqMask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // SQ 剩余空间不足 count 时先提交已准备的 SQE（链接的 SQE 需在同一批提交）
+    bool reserve(unsigned count) {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (entries - (*sqTail - head) >= count) return true;
+        if (!enter(0)) return false;
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        return entries - (*sqTail - head) >= count;
+    }
+
+    void commit() {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        toSubmit++;
+    }
+
+    // 提交所有已准备的 SQE，并可选地等待至少 minComplete 个完成
+    bool enter(unsigned minComplete) {
+        while (toSubmit > 0 || minComplete > 0) {
+            unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+            int ret = sysEnter(fd, toSubmit, minComplete, flags);
+            if (ret < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            toSubmit -= std::min<unsigned>(toSubmit, static_cast<unsigned>(ret));
+            minComplete = 0;
+        }
+        return true;
+    }
+};
+
+bool IoUringDumpWriter::isSupported() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = sysSetup(1, &params);
+    if (fd < 0) return false;
+    bool canTruncate = false;
+    bool supported = probeRequiredOps(fd, canTruncate);
+    ::close(fd);
+    return supported;
+}
+
+IoUringDumpWriter::IoUringDumpWriter(const Options& options)
+    : options_(options) {
+    options_.maxInFlight = std::max(1, options_.maxInFlight);
+    options_.bufferSize = alignUp(std::max<size_t>(options_.bufferSize, DIRECT_ALIGNMENT), DIRECT_ALIGNMENT);
+
+    if (!setupRing()) {
+        teardownRing();
+        return;
+    }
+
+    valid_ = true;
+    running_ = true;
+    submitThread_ = std::thread(&IoUringDumpWriter::submitLoop, this);
+}
+
+IoUringDumpWriter::~IoUringDumpWriter() {
+    if (running_) {
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            running_ = false;
+        }
+        queueCondition_.notify_all();
+        if (submitThread_.joinable()) {
+            submitThread_.join();
+        }
+    }
+    teardownRing();
+}
+
+bool IoUringDumpWriter::setupRing() {
+    ring_ = std::make_unique<Ring>();
+    // SQ 需容纳所有缓冲区的写请求以及打开/截断/同步/关闭请求
+    if (!ring_->setup(static_cast<unsigned>(options_.maxInFlight) * 2 + 8)) {
+        LOG_WARN("io_uring setup failed: ", std::strerror(errno));
+        return false;
+    }
+
+    if (!probeRequiredOps(ring_->fd, canTruncate_)) {
+        LOG_WARN("io_uring lacks OPENAT/CLOSE/FSYNC support");
+        return false;
+    }
+    if (options_.directIO && !canTruncate_) {
+        LOG_INFO("io_uring FTRUNCATE not supported, O_DIRECT disabled");
+    }
+
+    std::vector<iovec> iovecs;
+    for (int i = 0; i < options_.maxInFlight; i++) {
+        void* buffer = nullptr;
+        if (::posix_memalign(&buffer, DIRECT_ALIGNMENT, options_.bufferSize) != 0) {
+            LOG_WARN("io_uring writer: failed to allocate aligned buffer");
+            return false;
+        }
+        buffers_.push_back(static_cast<uint8_t*>(buffer));
+        freeBuffers_.push_back(i);
+        iovecs.push_back({buffer, options_.bufferSize});
+    }
+
+    // 注册缓冲区失败（如 RLIMIT_MEMLOCK 限制）时退化为普通 WRITE
+    fixedBuffers_ = sysRegister(ring_->fd, IORING_REGISTER_BUFFERS, iovecs.data(),
+                                static_cast<unsigned>(iovecs.size())) == 0;
+    if (!fixedBuffers_) {
+        LOG_WARN("io_uring buffer registration failed (", std::strerror(errno), "), using unregistered writes");
+    }
+    return true;
+}
+
+void IoUringDumpWriter::teardownRing() {
+    if (ring_) {
+        ring_->teardown();
+        ring_.reset();
+    }
+    for (auto* buffer : buffers_) {
+        std::free(buffer);
+    }
+    buffers_.clear();
+    freeBuffers_.clear();
+}
+
+bool IoUringDumpWriter::write(int dirFd, const std::string& name, std::vector<uint8_t>&& data,
+                              std::shared_ptr<const void> dirOwner) {
+    if (!valid_) return false;
+
+    auto job = std::make_unique<Job>();
+    job->dirFd = dirFd;
+    job->dirOwner = std::move(dirOwner);
+    job->path = name;
+    job->data = std::move(data);
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        doneCondition_.wait(lock, [this] { return pending_ < std::max(1, options_.maxQueued) || !running_; });
+        if (!running_) return false;
+
+        recordSubmit();
+        job->submitTime = Clock::now();
+        queue_.push_back(std::move(job));
+        pending_++;
+    }
+    queueCondition_.notify_one();
+    return true;
+}
+
+void IoUringDumpWriter::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    doneCondition_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void IoUringDumpWriter::submitLoop() {
+    std::unique_ptr<Job> current;
+
+    while (true) {
+        if (!current) {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            if (queue_.empty() && inFlight_ == 0 && ring_->toSubmit == 0) {
+                queueCondition_.wait(lock, [this] { return !queue_.empty() || !running_; });
+                if (queue_.empty() && !running_) break;
+            }
+            if (!queue_.empty()) {
+                current = std::move(queue_.front());
+                queue_.pop_front();
+            }
+        }
+
+        // 尽可能多地为当前及后续文件准备写请求，然后一次提交
+        while (current && !freeBuffers_.empty()) {
+            if (current->fd < 0 && !current->failed) {
+                // 异步打开，完成前不准备写请求（其他文件的写入与关闭继续进行）
+                if (!current->opening) {
+                    size_t size = current->data.size();
+                    current->direct = options_.directIO && canTruncate_ && size >= options_.directThreshold;
+                    submitOpen(*current);
+                }
+                break;
+            }
+
+            if (current->failed) {
+                current->prepared = true;
+            } else if (!current->prepared) {
+                prepareWrites(*current);
+            }
+
+            if (current->prepared) {
+                Job* job = current.release();
+                if (job->outstanding == 0) {
+                    finishJob(job);
+                }
+
+                std::lock_guard<std::mutex> lock(queueMutex_);
+                if (!queue_.empty()) {
+                    current = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+            } else {
+                break;  // SQ 或缓冲区已满
+            }
+        }
+
+        // 没有新的请求可准备时阻塞等待至少一个完成
+        unsigned waitFor = (inFlight_ > 0 && (ring_->toSubmit == 0 || freeBuffers_.empty())) ? 1 : 0;
+        if (!ring_->enter(waitFor)) {
+            LOG_ERROR("io_uring_enter failed: ", std::strerror(errno));
+        }
+        reapCompletions();
+    }
+}
+
+unsigned IoUringDumpWriter::prepareWrites(Job& job) {
+    unsigned prepared = 0;
+    size_t size = job.data.size();
+
+    while (job.nextOffset < size && !freeBuffers_.empty()) {
+        io_uring_sqe* sqe = ring_->acquire();
+        if (!sqe) break;
+
+        int bufferIndex = freeBuffers_.back();
+        freeBuffers_.pop_back();
+
+        size_t chunk = std::min(options_.bufferSize, size - job.nextOffset);
+        size_t length = chunk;
+        uint8_t* buffer = buffers_[bufferIndex];
+        std::memcpy(buffer, job.data.data() + job.nextOffset, chunk);
+        if (job.direct) {
+            // O_DIRECT 要求长度对齐，尾块补零，完成后截断
+            length = alignUp(chunk, DIRECT_ALIGNMENT);
+            std::memset(buffer + chunk, 0, length - chunk);
+        }
+
+        auto* op = new Operation{&job, OpKind::WRITE, bufferIndex, static_cast<unsigned>(length), job.nextOffset, 0};
+        sqe->opcode = fixedBuffers_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = job.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = job.nextOffset;
+        sqe->buf_index = fixedBuffers_ ? static_cast<uint16_t>(bufferIndex) : 0;
+        sqe->user_data = reinterpret_cast<uint64_t>(op);
+        ring_->commit();
+
+        job.nextOffset += chunk;
+        job.outstanding++;
+        inFlight_++;
+        prepared++;
+    }
+
+    if (job.nextOffset >= size) {
+        job.prepared = true;
+    }
+    return prepared;
+}
+
+unsigned IoUringDumpWriter::reapCompletions() {
+    unsigned reaped = 0;
+    unsigned head = *ring_->cqHead;
+
+    while (true) {
+        unsigned tail = __atomic_load_n(ring_->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) break;
+
+        io_uring_cqe* cqe = &ring_->cqes[head & *ring_->cqMask];
+        auto* op = reinterpret_cast<Operation*>(cqe->user_data);
+        int result = cqe->res;
+        head++;
+        __atomic_store_n(ring_->cqHead, head, __ATOMIC_RELEASE);
+
+        Job* job = static_cast<Job*>(op->job);
+        switch (op->kind) {
+        case OpKind::OPEN:
+            job->opening = false;
+            if (result >= 0) {
+                job->fd = result;
+            } else if (result == -EINVAL && job->direct) {
+                // 文件系统不支持 O_DIRECT（如 tmpfs）时以缓冲写重新打开
+                job->direct = false;
+                submitOpen(*job);
+            } else {
+                LOG_ERROR("io_uring writer: failed to open ", job->path, ": ", std::strerror(-result));
+                job->failed = true;
+            }
+            break;
+
+        case OpKind::WRITE: {
+            unsigned written = op->done + static_cast<unsigned>(std::max(result, 0));
+            if (result > 0 && written < op->length) {
+                // 短写：剩余部分从 offset + 已写字节继续提交，缓冲区继续占用
+                io_uring_sqe* sqe = ring_->acquire();
+                if (!sqe && ring_->enter(0)) {
+                    sqe = ring_->acquire();
+                }
+                if (sqe) {
+                    op->done = written;
+                    sqe->opcode = fixedBuffers_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                    sqe->fd = job->fd;
+                    sqe->addr = reinterpret_cast<uint64_t>(buffers_[op->bufferIndex] + written);
+                    sqe->len = op->length - written;
+                    sqe->off = op->offset + written;
+                    sqe->buf_index = fixedBuffers_ ? static_cast<uint16_t>(op->bufferIndex) : 0;
+                    sqe->user_data = reinterpret_cast<uint64_t>(op);
+                    ring_->commit();
+                    continue;
+                }
+            }
+
+            freeBuffers_.push_back(op->bufferIndex);
+            if (result < 0 || written != op->length) {
+                if (!job->failed) {
+                    LOG_ERROR("io_uring writer: write failed for ", job->path, ": ",
+                              result < 0 ? std::strerror(-result) : "short write");
+                }
+                job->failed = true;
+            }
+            break;
+        }
+
+        case OpKind::TRUNCATE:
+        case OpKind::SYNC:
+            if (result < 0) {
+                LOG_ERROR("io_uring writer: ", op->kind == OpKind::TRUNCATE ? "ftruncate" : "fdatasync",
+                          " failed for ", job->path, ": ", std::strerror(-result));
+                job->failed = true;
+            }
+            break;
+
+        case OpKind::CLOSE:
+            if (result < 0) {
+                LOG_ERROR("io_uring writer: close failed for ", job->path, ": ", std::strerror(-result));
+                job->failed = true;
+            }
+            job->fd = -1;
+            break;
+        }
+
+        delete op;
+        inFlight_--;
+        job->outstanding--;
+        reaped++;
+
+        if (job->prepared && job->outstanding == 0) {
+            finishJob(job);
+        }
+    }
+    return reaped;
+}
+
+void IoUringDumpWriter::submitOpen(Job& job) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (job.direct ? O_DIRECT : 0);
+    if (!ring_->reserve(1)) {
+        LOG_ERROR("io_uring writer: failed to submit open for ", job.path, ": ", std::strerror(errno));
+        job.failed = true;
+        return;
+    }
+
+    io_uring_sqe* sqe = ring_->acquire();
+    auto* op = new Operation{&job, OpKind::OPEN, -1, 0, 0, 0};
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = job.dirFd;
+    sqe->addr = reinterpret_cast<uint64_t>(job.path.c_str());
+    sqe->len = 0644;
+    sqe->open_flags = static_cast<uint32_t>(flags);
+    sqe->user_data = reinterpret_cast<uint64_t>(op);
+    ring_->commit();
+
+    job.opening = true;
+    job.outstanding++;
+    inFlight_++;
+}
+
+void IoUringDumpWriter::submitClose(Job& job) {
+    // 截断 -> 同步 -> 关闭 以 HARDLINK 链接：前一步失败时仍会关闭文件
+    std::vector<OpKind> chain;
+    if (!job.failed) {
+        // O_DIRECT 尾块补齐的部分需截断回真实大小
+        if (job.direct) chain.push_back(OpKind::TRUNCATE);
+        if (options_.syncOnClose) chain.push_back(OpKind::SYNC);
+    }
+    chain.push_back(OpKind::CLOSE);
+
+    if (!ring_->reserve(static_cast<unsigned>(chain.size()))) {
+        // SQ 无法提交时同步关闭，避免泄漏文件描述符
+        LOG_ERROR("io_uring writer: failed to submit close for ", job.path, ": ", std::strerror(errno));
+        ::close(job.fd);
+        job.fd = -1;
+        job.failed = true;
+        return;
+    }
+
+    for (size_t i = 0; i < chain.size(); i++) {
+        io_uring_sqe* sqe = ring_->acquire();
+        auto* op = new Operation{&job, chain[i], -1, 0, 0, 0};
+        sqe->fd = job.fd;
+        switch (chain[i]) {
+        case OpKind::TRUNCATE:
+            sqe->opcode = OP_FTRUNCATE;
+            sqe->off = job.data.size();
+            break;
+        case OpKind::SYNC:
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+            break;
+        default:
+            sqe->opcode = IORING_OP_CLOSE;
+            break;
+        }
+        if (i + 1 < chain.size()) {
+            sqe->flags |= IOSQE_IO_HARDLINK;
+        }
+        sqe->user_data = reinterpret_cast<uint64_t>(op);
+        ring_->commit();
+
+        job.outstanding++;
+        inFlight_++;
+    }
+    job.closing = true;
+}
+
+void IoUringDumpWriter::finishJob(Job* job) {
+    // 写请求全部完成：先异步关闭，关闭完成时再次进入此函数
+    if (job->fd >= 0 && !job->closing) {
+        submitClose(*job);
+        if (job->outstanding > 0) {
+            return;
+        }
+    }
+
+    recordCompletion(job->data.size(), job->submitTime, !job->failed);
+    delete job;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        pending_--;
+    }
+    doneCondition_.notify_all();
+}
+
+#else // !PERCEPTION_HAS_IO_URING
+
+struct IoUringDumpWriter::Ring {};
+
+bool IoUringDumpWriter::isSupported() {
+    return false;
+}
+
+IoUringDumpWriter::IoUringDumpWriter(const Options& options)
+    : options_(options) {
+}
+
+IoUringDumpWriter::~IoUringDumpWriter() = default;
+
+bool IoUringDumpWriter::setupRing() { return false; }
+void IoUringDumpWriter::teardownRing() {}
+void IoUringDumpWriter::submitLoop() {}
+unsigned IoUringDumpWriter::prepareWrites(Job&) { return 0; }
+unsigned IoUringDumpWriter::reapCompletions() { return 0; }
+void IoUringDumpWriter::submitOpen(Job&) {}
+void IoUringDumpWriter::submitClose(Job&) {}
+void IoUringDumpWriter::finishJob(Job*) {}
+
+bool IoUringDumpWriter::write(int, const std::string&, std::vector<uint8_t>&&, std::shared_ptr<const void>) {
+    return false;
+}
+
+void IoUringDumpWriter::flush() {}
+
+#endif // PERCEPTION_HAS_IO_URING
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <deque>
+#include <thread>
+#include "DumpWriter.hpp"
+
+/**
+ * @brief io_uring 写盘后端
+ *
+ * 直接使用 io_uring 系统调用（不依赖 liburing）：
+ *  - 单个提交线程批量准备 SQE 后一次 io_uring_enter 提交，提交线程不执行阻塞的文件系统调用
+ *  - 文件通过 IORING_OP_OPENAT 打开，写完后以 HARDLINK 链接的 FTRUNCATE/FSYNC/CLOSE 收尾
+ *  - 固定数量的对齐缓冲区通过 IORING_REGISTER_BUFFERS 注册，使用 WRITE_FIXED 写入
+ *  - 大文件以 O_DIRECT 打开，尾块补齐对齐后再截断回真实大小（内核不支持 FTRUNCATE 时不使用 O_DIRECT）
+ *  - 在途写请求数不超过注册缓冲区数量（maxInFlight）
+ *  - 短写时从已写位置重新提交剩余部分
+ * 所需操作码通过 IORING_REGISTER_PROBE 检查，内核不支持或注册失败时 isSupported()/isValid()
+ * 返回 false，由工厂回退到线程池实现。
+ * test_dump_writer 的对比中吞吐低于线程池、P99 延迟更高，因此不是默认后端。
+ */
+class IoUringDumpWriter : public DumpWriter {
+public:
+    explicit IoUringDumpWriter(const Options& options);
+    ~IoUringDumpWriter() override;
+
+    /**
+     * @brief 当前平台/内核是否支持 io_uring 及所需操作码（WRITE/OPENAT/CLOSE/FSYNC）
+     */
+    static bool isSupported();
+
+    /**
+     * @brief 是否初始化成功
+     */
+    bool isValid() const { return valid_; }
+
+    using DumpWriter::write;
+    bool write(int dirFd, const std::string& name, std::vector<uint8_t>&& data,
+               std::shared_ptr<const void> dirOwner) override;
+    void flush() override;
+    const char* name() const override { return "io_uring"; }
+
+private:
+    struct Job;
+    struct Ring;
+
+    bool setupRing();
+    void teardownRing();
+    void submitLoop();
+
+    // 为当前任务准备尽可能多的写请求，返回准备的 SQE 数
+    unsigned prepareWrites(Job& job);
+    // 处理完成队列，返回处理的 CQE 数
+    unsigned reapCompletions();
+    // 提交 OPENAT
+    void submitOpen(Job& job);
+    // 提交链接的 截断/同步/关闭 请求
+    void submitClose(Job& job);
+    // 文件的所有写请求完成后收尾（提交关闭链；关闭完成后统计）
+    void finishJob(Job* job);
+
+    Options options_;
+    std::unique_ptr<Ring> ring_;
+    bool valid_ = false;
+
+    std::vector<uint8_t*> buffers_;       ///< 注册缓冲区（按页对齐）
+    std::vector<int> freeBuffers_;        ///< 空闲缓冲区索引
+    bool fixedBuffers_ = false;           ///< 是否注册成功（失败时使用普通 WRITE）
+    bool canTruncate_ = false;            ///< 内核是否支持 IORING_OP_FTRUNCATE（O_DIRECT 需要）
+    unsigned inFlight_ = 0;               ///< 在途 SQE 数
+
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;   ///< 新任务到达/停止
+    std::condition_variable doneCondition_;    ///< 任务完成（背压与 flush）
+    std::deque<std::unique_ptr<Job>> queue_;   ///< 待处理文件
+    int pending_ = 0;                          ///< 已提交未完成的文件数
+
+    std::atomic<bool> running_{false};
+    std::thread submitThread_;
+};
@@ -35,8 +35,10 @@ public:
     std::string extractPointsFrameInfo(std::shared_ptr<ob::PointsFrame> frame);
     std::string extractIMUFrameInfo(std::shared_ptr<ob::Frame> frame);
 
-private:
+    // 元数据类型名称
     std::string metadataTypeToString(OBFrameMetadataType type);
+
+private:
     std::string formatFrameInfo(std::shared_ptr<ob::Frame> frame);
 
 private:
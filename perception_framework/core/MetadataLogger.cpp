@@ -0,0 +1,366 @@
+#include "MetadataLogger.hpp"
+#include "DumpHelper.hpp"
+#include "MetadataHelper.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+    constexpr int IDLE_CLOSE_SECONDS = 10;              // 无新帧超过该时长关闭文件
+    constexpr int IDLE_CHECK_SECONDS = 5;               // 空闲检查周期
+}
+
+// ==================== MetadataLogger::Record ====================
+
+MetadataLogger::Record MetadataLogger::Record::extract(std::shared_ptr<ob::Frame> frame) {
+    Record record;
+    if (!frame) return record;
+
+    auto ts = DumpHelper::TimeStamp::extract(frame);
+    record.stream = frameTypeName(frame->getType());
+    record.frameType = static_cast<uint32_t>(frame->getType());
+    record.format = static_cast<uint32_t>(frame->getFormat());
+    record.row.index = frame->getIndex();
+    record.row.deviceUs = ts.deviceUs;
+    record.row.systemUs = ts.systemUs;
+    record.row.globalUs = ts.globalUs;
+
+    if (frame->is<ob::VideoFrame>()) {
+        auto videoFrame = frame->as<ob::VideoFrame>();
+        record.row.width = videoFrame->getWidth();
+        record.row.height = videoFrame->getHeight();
+    }
+
+    record.metadata.reserve(OB_FRAME_METADATA_TYPE_COUNT);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(OB_FRAME_METADATA_TYPE_COUNT); i++) {
+        auto type = static_cast<OBFrameMetadataType>(i);
+        if (frame->hasMetadata(type)) {
+            record.metadata.emplace_back(static_cast<uint16_t>(i), frame->getMetadataValue(type));
+        }
+    }
+    return record;
+}
+
+// ==================== MetadataLogger ====================
+
+MetadataLogger::MetadataLogger(int flushIntervalMs)
+    : flushIntervalMs_(flushIntervalMs), lastIdleCheck_(Clock::now()) {
+    scheduleFlush();
+}
+
+MetadataLogger::~MetadataLogger() {
+    utils::TimerWheel::getInstance().cancel(flushTimer_.exchange(utils::TimerWheel::INVALID_TIMER));
+    close();
+}
+
+bool MetadataLogger::append(std::shared_ptr<ob::Frame> frame, const std::string& directory) {
+    if (!frame) return false;
+
+    try {
+        return append(Record::extract(frame), directory);
+    } catch (const std::exception& e) {
+        LOG_ERROR("MetadataLogger: error extracting metadata: ", e.what());
+        return false;
+    }
+}
+
+bool MetadataLogger::append(const Record& record, const std::string& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+
+    auto& log = streams_[directory + "|" + record.stream];
+
+    // 首帧或出现新的元数据类型时切换到新分段
+    if (!log.file.is_open() || !schemaCovers(log, record)) {
+        if (!openSegment(log, record, directory)) {
+            streams_.erase(directory + "|" + record.stream);
+            return false;
+        }
+    }
+
+    // 编码定长行：RowHeader + values[columnCount]
+    const size_t columnCount = log.columns.size();
+    log.rowBuffer.assign(sizeof(RowHeader) + columnCount * sizeof(int64_t), 0);
+
+    RowHeader row = record.row;
+    row.presentMask = 0;
+    auto* values = reinterpret_cast<int64_t*>(log.rowBuffer.data() + sizeof(RowHeader));
+    for (const auto& item : record.metadata) {
+        auto it = std::lower_bound(log.columns.begin(), log.columns.end(), item.first);
+        size_t column = static_cast<size_t>(it - log.columns.begin());
+        row.presentMask |= (1ULL << column);
+        std::memcpy(&values[column], &item.second, sizeof(int64_t));
+    }
+    std::memcpy(log.rowBuffer.data(), &row, sizeof(RowHeader));
+
+    log.file.write(reinterpret_cast<const char*>(log.rowBuffer.data()), log.rowBuffer.size());
+    log.lastWrite = now;
+    log.unflushed = true;
+
+    if (now - log.lastFlush >= std::chrono::milliseconds(flushIntervalMs_)) {
+        log.file.flush();
+        log.lastFlush = now;
+        log.unflushed = false;
+    }
+
+    bool success = log.file.good();
+    if (!success) {
+        LOG_ERROR("MetadataLogger: failed to write ", log.path);
+    }
+
+    if (now - lastIdleCheck_ >= std::chrono::seconds(IDLE_CHECK_SECONDS)) {
+        closeIdleLocked(now);
+        lastIdleCheck_ = now;
+    }
+    return success;
+}
+
+void MetadataLogger::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    for (auto& entry : streams_) {
+        entry.second.file.flush();
+        entry.second.lastFlush = now;
+        entry.second.unflushed = false;
+    }
+}
+
+void MetadataLogger::setFlushInterval(int flushIntervalMs) {
+    if (flushIntervalMs_.exchange(flushIntervalMs) != flushIntervalMs) {
+        scheduleFlush();
+    }
+}
+
+void MetadataLogger::scheduleFlush() {
+    auto& wheel = utils::TimerWheel::getInstance();
+    int interval = flushIntervalMs_;
+
+    // 间隔为 0 时每次追加都会刷新，不需要定时任务
+    utils::TimerWheel::TimerId timer = utils::TimerWheel::INVALID_TIMER;
+    if (interval > 0) {
+        timer = wheel.schedulePeriodic(std::chrono::milliseconds(interval), [this] { flushPending(); });
+    }
+    // 先创建再替换，并发调用时被换出的任务都会被取消
+    wheel.cancel(flushTimer_.exchange(timer));
+}
+
+void MetadataLogger::flushPending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    for (auto& entry : streams_) {
+        StreamLog& log = entry.second;
+        if (log.unflushed) {
+            log.file.flush();
+            log.lastFlush = now;
+            log.unflushed = false;
+        }
+    }
+
+    if (now - lastIdleCheck_ >= std::chrono::seconds(IDLE_CHECK_SECONDS)) {
+        closeIdleLocked(now);
+        lastIdleCheck_ = now;
+    }
+}
+
+void MetadataLogger::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : streams_) {
+        entry.second.file.close();
+    }
+    streams_.clear();
+}
+
+bool MetadataLogger::schemaCovers(const StreamLog& log, const Record& record) {
+    for (const auto& item : record.metadata) {
+        if (!std::binary_search(log.columns.begin(), log.columns.end(), item.first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MetadataLogger::openSegment(StreamLog& log, const Record& record, const std::string& directory) {
+    // 新分段的列 = 旧列 ∪ 记录中的元数据类型
+    std::vector<uint16_t> columns = log.columns;
+    for (const auto& item : record.metadata) {
+        columns.push_back(item.first);
+    }
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+    if (columns.size() > MAX_COLUMNS) {
+        LOG_ERROR("MetadataLogger: too many metadata columns for ", record.stream, ": ", columns.size());
+        return false;
+    }
+
+    std::string metaDir = Logger::ensureDirectoryExists(directory + "/metadata", true);
+    if (metaDir.empty()) {
+        LOG_ERROR("MetadataLogger: failed to create metadata directory under ", directory);
+        return false;
+    }
+
+    // 文件名：<数据流>_<首帧索引>.obmeta，重名时追加序号
+    std::string base = metaDir + record.stream + "_" + std::to_string(record.row.index);
+    std::string path = base + FILE_EXTENSION;
+    for (int n = 1; std::filesystem::exists(path); n++) {
+        path = base + "_" + std::to_string(n) + FILE_EXTENSION;
+    }
+
+    if (log.file.is_open()) {
+        log.file.close();
+        LOG_INFO("MetadataLogger: new metadata field for ", record.stream, ", rotating to ", path);
+    }
+
+    log.file.open(path, std::ios::binary | std::ios::trunc);
+    if (!log.file.is_open()) {
+        LOG_ERROR("MetadataLogger: failed to create ", path);
+        return false;
+    }
+
+    FileHeader header;
+    header.columnCount = static_cast<uint16_t>(columns.size());
+    header.rowSize = static_cast<uint32_t>(sizeof(RowHeader) + columns.size() * sizeof(int64_t));
+    header.frameType = record.frameType;
+    header.format = record.format;
+    std::strncpy(header.stream, record.stream.c_str(), sizeof(header.stream) - 1);
+
+    log.file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    log.file.write(reinterpret_cast<const char*>(columns.data()), columns.size() * sizeof(uint16_t));
+    log.file.flush();
+
+    log.columns = std::move(columns);
+    log.path = path;
+    log.lastFlush = Clock::now();
+    LOG_DEBUG("MetadataLogger: opened ", path, " (columns: ", log.columns.size(),
+              ", row size: ", header.rowSize, " bytes)");
+    return log.file.good();
+}
+
+void MetadataLogger::closeIdleLocked(Clock::time_point now) {
+    for (auto it = streams_.begin(); it != streams_.end();) {
+        if (now - it->second.lastWrite >= std::chrono::seconds(IDLE_CLOSE_SECONDS)) {
+            LOG_DEBUG("MetadataLogger: closing idle log ", it->second.path);
+            it->second.file.close();
+            it = streams_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ==================== MetadataLogReader ====================
+
+bool MetadataLogReader::read(const std::string& path, Log& log) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR("MetadataLogReader: failed to open ", path);
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(&log.header), sizeof(log.header));
+    if (!file || log.header.magic != MetadataLogger::MAGIC || log.header.version != MetadataLogger::VERSION) {
+        LOG_ERROR("MetadataLogReader: invalid header in ", path);
+        return false;
+    }
+    log.header.stream[sizeof(log.header.stream) - 1] = '\0';
+
+    const size_t columnCount = log.header.columnCount;
+    if (columnCount > MetadataLogger::MAX_COLUMNS ||
+        log.header.rowSize != sizeof(MetadataLogger::RowHeader) + columnCount * sizeof(int64_t)) {
+        LOG_ERROR("MetadataLogReader: inconsistent schema in ", path);
+        return false;
+    }
+
+    log.columns.resize(columnCount);
+    file.read(reinterpret_cast<char*>(log.columns.data()), columnCount * sizeof(uint16_t));
+    if (!file) {
+        LOG_ERROR("MetadataLogReader: truncated schema in ", path);
+        return false;
+    }
+
+    log.rows.clear();
+    log.values.clear();
+    std::vector<char> buffer(log.header.rowSize);
+    while (file.read(buffer.data(), buffer.size())) {
+        MetadataLogger::RowHeader row;
+        std::memcpy(&row, buffer.data(), sizeof(row));
+        log.rows.push_back(row);
+
+        size_t offset = log.values.size();
+        log.values.resize(offset + columnCount);
+        std::memcpy(log.values.data() + offset, buffer.data() + sizeof(row), columnCount * sizeof(int64_t));
+    }
+    return true;
+}
+
+std::string MetadataLogReader::columnName(uint16_t type) {
+    std::string name = MetadataHelper::getInstance().metadataTypeToString(static_cast<OBFrameMetadataType>(type));
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name;
+}
+
+bool MetadataLogReader::exportCsv(const std::string& path, std::ostream& out) {
+    Log log;
+    if (!read(path, log)) return false;
+
+    out << "index,device_us,system_us,global_us,width,height";
+    for (auto column : log.columns) {
+        out << "," << columnName(column);
+    }
+    out << "\n";
+
+    const size_t columnCount = log.columns.size();
+    for (size_t r = 0; r < log.rows.size(); r++) {
+        const auto& row = log.rows[r];
+        out << row.index << "," << row.deviceUs << "," << row.systemUs << "," << row.globalUs
+            << "," << row.width << "," << row.height;
+        for (size_t c = 0; c < columnCount; c++) {
+            out << ",";
+            if (row.presentMask & (1ULL << c)) {
+                out << log.values[r * columnCount + c];
+            }
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool MetadataLogReader::exportJson(const std::string& path, std::ostream& out) {
+    Log log;
+    if (!read(path, log)) return false;
+
+    out << "{\n";
+    out << "  \"stream\": \"" << log.header.stream << "\",\n";
+    out << "  \"frameType\": " << log.header.frameType << ",\n";
+    out << "  \"format\": " << log.header.format << ",\n";
+    out << "  \"columns\": [";
+    for (size_t c = 0; c < log.columns.size(); c++) {
+        out << (c ? ", " : "") << "\"" << columnName(log.columns[c]) << "\"";
+    }
+    out << "],\n";
+    out << "  \"frames\": [";
+
+    const size_t columnCount = log.columns.size();
+    for (size_t r = 0; r < log.rows.size(); r++) {
+        const auto& row = log.rows[r];
+        out << (r ? ",\n" : "\n") << "    {\"index\": " << row.index
+            << ", \"deviceUs\": " << row.deviceUs
+            << ", \"systemUs\": " << row.systemUs
+            << ", \"globalUs\": " << row.globalUs
+            << ", \"width\": " << row.width
+            << ", \"height\": " << row.height
+            << ", \"metadata\": {";
+        bool first = true;
+        for (size_t c = 0; c < columnCount; c++) {
+            if (row.presentMask & (1ULL << c)) {
+                out << (first ? "" : ", ") << "\"" << columnName(log.columns[c]) << "\": "
+                    << log.values[r * columnCount + c];
+                first = false;
+            }
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
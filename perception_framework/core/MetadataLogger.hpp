@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "libobsensor/ObSensor.hpp"
+#include "TimerWheel.hpp"
+
+/**
+ * @brief 列式元数据日志 - 每个数据流一个追加写的二进制文件
+ *
+ * 取代"每帧一个元数据文本文件"的保存方式：
+ *  - 文件头记录数据流名称、帧类型、格式以及列（元数据类型）列表
+ *  - 每帧写入一行定长记录：帧索引、设备/系统/全局时间戳、宽高、
+ *    列存在位掩码以及每列的 int64 值
+ *  - 出现文件头中没有的元数据类型时，自动切换到新的分段文件（新的列表）
+ *  - 定期刷新到磁盘（共享时间轮定时刷新，帧率很低或停止写入时缓冲也会落盘），
+ *    长时间没有新帧的数据流自动关闭
+ * 通过 MetadataLogReader 按需导出为 CSV/JSON。
+ * 作为 DumpHelper 的组件使用。
+ *
+ * 文件布局（小端）：
+ *   FileHeader | uint16 columns[columnCount] | Row 0 | Row 1 | ...
+ *   Row = RowHeader | int64 values[columnCount]
+ */
+class MetadataLogger {
+public:
+    static constexpr uint32_t MAGIC = 0x4C4D424F;   ///< "OBML"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr const char* FILE_EXTENSION = ".obmeta";
+    static constexpr size_t MAX_COLUMNS = 64;       ///< presentMask 位数
+
+#pragma pack(push, 1)
+    struct FileHeader {
+        uint32_t magic = MAGIC;
+        uint16_t version = VERSION;
+        uint16_t columnCount = 0;     ///< 元数据列数
+        uint32_t rowSize = 0;         ///< 每行字节数
+        uint32_t frameType = 0;       ///< OBFrameType
+        uint32_t format = 0;          ///< OBFormat
+        char stream[32] = {};         ///< 数据流名称（以0结尾）
+    };
+
+    struct RowHeader {
+        uint64_t index = 0;           ///< 帧索引
+        uint64_t deviceUs = 0;        ///< 设备时间戳(微秒)
+        uint64_t systemUs = 0;        ///< 系统时间戳(微秒)
+        uint64_t globalUs = 0;        ///< 全局时间戳(微秒)
+        uint32_t width = 0;           ///< 图像宽度（非视频帧为0）
+        uint32_t height = 0;          ///< 图像高度（非视频帧为0）
+        uint64_t presentMask = 0;     ///< 第 i 位表示第 i 列在该帧中存在
+    };
+#pragma pack(pop)
+
+    /**
+     * @brief 一帧的元数据记录（与 SDK 帧解耦，便于测试与回放）
+     */
+    struct Record {
+        std::string stream;                                     ///< 数据流名称，如 "Color"
+        uint32_t frameType = 0;
+        uint32_t format = 0;
+        RowHeader row;                                          ///< presentMask 由写入时计算
+        std::vector<std::pair<uint16_t, int64_t>> metadata;     ///< (元数据类型, 值)
+
+        // 从帧中提取记录（遍历所有存在的元数据类型）
+        static Record extract(std::shared_ptr<ob::Frame> frame);
+    };
+
+    explicit MetadataLogger(int flushIntervalMs = 1000);
+    ~MetadataLogger();
+
+    MetadataLogger(const MetadataLogger&) = delete;
+    MetadataLogger& operator=(const MetadataLogger&) = delete;
+
+    /**
+     * @brief 追加一帧元数据
+     * @param frame 帧数据
+     * @param directory 保存目录（日志写入其下的 metadata/ 子目录）
+     * @return 是否写入成功
+     */
+    bool append(std::shared_ptr<ob::Frame> frame, const std::string& directory);
+
+    /**
+     * @brief 追加一条记录
+     */
+    bool append(const Record& record, const std::string& directory);
+
+    /**
+     * @brief 将所有数据流的缓冲写入磁盘
+     */
+    void flush();
+
+    /**
+     * @brief 关闭所有数据流文件
+     */
+    void close();
+
+    /**
+     * @brief 设置刷新间隔(毫秒)，间隔变化时重新创建定时刷新任务
+     */
+    void setFlushInterval(int flushIntervalMs);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct StreamLog {
+        std::ofstream file;
+        std::string path;
+        std::vector<uint16_t> columns;          ///< 当前分段的列（元数据类型）
+        std::vector<uint8_t> rowBuffer;         ///< 行编码缓冲（复用）
+        Clock::time_point lastWrite;
+        Clock::time_point lastFlush;
+        bool unflushed = false;                 ///< 有写入后尚未刷新的数据
+    };
+
+    // 以记录中的元数据类型创建新分段文件
+    bool openSegment(StreamLog& log, const Record& record, const std::string& directory);
+    // 当前分段是否包含记录中的所有元数据类型
+    static bool schemaCovers(const StreamLog& log, const Record& record);
+    // 关闭长时间无新帧的数据流（如已结束的触发事件目录）
+    void closeIdleLocked(Clock::time_point now);
+    // 按当前刷新间隔创建定时刷新任务（替换已有任务）
+    void scheduleFlush();
+    // 定时刷新：写入有未刷新数据的数据流并关闭空闲数据流（在定时线程中执行）
+    void flushPending();
+
+    std::mutex mutex_;
+    std::map<std::string, StreamLog> streams_;  ///< key: 目录 + 数据流名称
+    std::atomic<int> flushIntervalMs_;
+    Clock::time_point lastIdleCheck_;
+    std::atomic<utils::TimerWheel::TimerId> flushTimer_{utils::TimerWheel::INVALID_TIMER};
+};
+
+/**
+ * @brief 列式元数据日志读取与导出
+ */
+class MetadataLogReader {
+public:
+    struct Log {
+        MetadataLogger::FileHeader header;
+        std::vector<uint16_t> columns;
+        std::vector<MetadataLogger::RowHeader> rows;
+        std::vector<int64_t> values;            ///< rows.size() * columns.size()，按行存放
+    };
+
+    /**
+     * @brief 读取日志文件
+     * 文件末尾不完整的行（写入中断）会被忽略
+     * @return 文件头有效时返回 true
+     */
+    static bool read(const std::string& path, Log& log);
+
+    /**
+     * @brief 导出为 CSV（不存在的元数据为空）
+     */
+    static bool exportCsv(const std::string& path, std::ostream& out);
+
+    /**
+     * @brief 导出为 JSON
+     */
+    static bool exportJson(const std::string& path, std::ostream& out);
+
+    /**
+     * @brief 元数据列名称
+     */
+    static std::string columnName(uint16_t type);
+};
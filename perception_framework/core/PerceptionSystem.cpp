@@ -1,11 +1,77 @@
 #include "PerceptionSystem.hpp"
 #include "Logger.hpp"
 #include "ConfigHelper.hpp"
+#include "DumpHelper.hpp"
+#include "ONNXInference.hpp"
+#include "DepthCodec.hpp"
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <limits>
 #include <thread>
 #include <functional>
 #include <opencv2/opencv.hpp>
 
+namespace {
+
+int64_t steadyTimestampUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 结果记录的合并键：高位区分消息种类，低 16 位为模型编号
+constexpr uint32_t RESULT_COALESCE_KEY = 0x52000000;
+
+/**
+ * @brief 分割掩码摘要：每个非零取值一个条目（外接框，score 为面积占比）
+ */
+void summarizeSegmentation(const cv::Mat& mask, std::vector<ResultBox>& boxes) {
+    if (mask.empty() || mask.type() != CV_8UC1) {
+        return;
+    }
+    
+    struct Region {
+        uint64_t pixels = 0;
+        int minX = std::numeric_limits<int>::max();
+        int minY = std::numeric_limits<int>::max();
+        int maxX = -1;
+        int maxY = -1;
+    };
+    std::array<Region, 256> regions{};
+    for (int y = 0; y < mask.rows; ++y) {
+        const uint8_t* row = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < mask.cols; ++x) {
+            if (row[x] == 0) {
+                continue;
+            }
+            Region& region = regions[row[x]];
+            region.pixels++;
+            region.minX = std::min(region.minX, x);
+            region.maxX = std::max(region.maxX, x);
+            region.minY = std::min(region.minY, y);
+            region.maxY = std::max(region.maxY, y);
+        }
+    }
+    
+    double total = static_cast<double>(mask.total());
+    for (size_t value = 1; value < regions.size(); ++value) {
+        const Region& region = regions[value];
+        if (region.pixels == 0) {
+            continue;
+        }
+        ResultBox box;
+        box.x = static_cast<float>(region.minX);
+        box.y = static_cast<float>(region.minY);
+        box.width = static_cast<float>(region.maxX - region.minX + 1);
+        box.height = static_cast<float>(region.maxY - region.minY + 1);
+        box.score = static_cast<float>(region.pixels / total);
+        box.classId = static_cast<int32_t>(value);
+        boxes.push_back(box);
+    }
+}
+
+} // namespace
+
 // 单例实现
 PerceptionSystem& PerceptionSystem::getInstance() {
     static PerceptionSystem instance;
@@ -31,11 +97,17 @@ bool PerceptionSystem::initialize() {
 
     LOG_INFO("Initializing PerceptionSystem...");
     
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     // 初始化通信代理（如果启用）
     if (config.communicationConfig.enableCommunication) {
         LOG_INFO("Initializing communication proxy...");
+        CommunicationProxy::Transport transport;
+        if (CommunicationProxy::parseTransport(config.communicationConfig.transport, transport)) {
+            commProxy_.setTransport(transport);
+        }
+        commProxy_.setBinaryFraming(config.communicationConfig.binaryFraming);
         if(!commProxy_.initialize()) {
             LOG_ERROR("Failed to initialize CommunicationProxy");
             return false;
@@ -47,6 +119,11 @@ bool PerceptionSystem::initialize() {
         LOG_INFO("Communication proxy disabled by configuration");
     }
     
+    // 共享内存发布（在开始接收帧之前创建，之后不再修改）
+    if (config.communicationConfig.enableSharedMemory && !initializeSharedMemory()) {
+        LOG_WARN("Failed to initialize shared memory transport");
+    }
+    
     // 创建图像接收器
     imageReceiver_ = std::make_unique<ImageReceiver>();
     
@@ -84,10 +161,28 @@ void PerceptionSystem::processFrame(std::shared_ptr<ob::Frame> frame, OBFrameTyp
         return;
     }
     
+    // 发布到共享内存，不等待读端
+    if (!shmStreams_.empty()) {
+        try {
+            publishSharedFrame(frame, frameType);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Shared memory publish failed: ", e.what());
+        }
+    }
+    
     // 处理推理
     if (inferenceEnabled_ && getInferenceManager().isInitialized()) {
         try {
-            getInferenceManager().processFrame(frame, frameType);
+            bool submitted = getInferenceManager().processFrame(frame, frameType);
+            
+            // 跳过推理的彩色帧输出跟踪器的预测框
+            if (!submitted && tracker_ && frameType == OB_FRAME_COLOR) {
+                cv::Mat image;
+                if (ConfigHelper::getInstance().current()->inferenceConfig.trackerOpticalFlow) {
+                    image = getInferenceManager().prepareFrame(frame);
+                }
+                publishTracks(tracker_->predict(steadyTimestampUs(), image));
+            }
         } catch (const std::exception& e) {
             LOG_ERROR("Inference processing failed: ", e.what());
         }
@@ -104,7 +199,8 @@ void PerceptionSystem::processFrame(std::shared_ptr<ob::Frame> frame, OBFrameTyp
 }
 
 bool PerceptionSystem::enableInference() {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if (!config.inferenceConfig.enableInference) {
         LOG_WARN("Inference disabled in configuration");
@@ -127,7 +223,8 @@ void PerceptionSystem::disableInference() {
 }
 
 bool PerceptionSystem::enableCalibration() {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if (!config.calibrationConfig.enableCalibration) {
         LOG_WARN("Calibration disabled in configuration");
@@ -151,7 +248,8 @@ void PerceptionSystem::disableCalibration() {
 }
 
 bool PerceptionSystem::initializeInferenceSystem() {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if (!config.inferenceConfig.enableInference) {
         LOG_INFO("Inference system disabled by configuration");
@@ -164,6 +262,20 @@ bool PerceptionSystem::initializeInferenceSystem() {
         // 获取全局推理配置并进行必要的调整
         auto inferenceConfig = config.inferenceConfig;
         
+        // 创建跟踪器（须在推理回调之前，回调中会使用）
+        if (inferenceConfig.enableTracking) {
+            inference::ObjectTracker::Options trackerOptions;
+            trackerOptions.iouThreshold = inferenceConfig.trackerIouThreshold;
+            trackerOptions.maxAge = inferenceConfig.trackerMaxAge;
+            trackerOptions.minHits = inferenceConfig.trackerMinHits;
+            trackerOptions.opticalFlow = inferenceConfig.trackerOpticalFlow;
+            trackerOptions.flowScale = inferenceConfig.trackerFlowScale;
+            tracker_ = std::make_unique<inference::ObjectTracker>(trackerOptions);
+            LOG_INFO("Object tracking enabled (max age: ", trackerOptions.maxAge,
+                     ", min hits: ", trackerOptions.minHits,
+                     trackerOptions.opticalFlow ? ", optical flow" : "", ")");
+        }
+        
         // 设置推理回调
         inferenceManager.setInferenceCallback(
             [this](const std::string& modelName, const cv::Mat& image, 
@@ -190,7 +302,23 @@ bool PerceptionSystem::initializeInferenceSystem() {
 }
 
 bool PerceptionSystem::initializeCalibrationSystem() {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
+    
+    // 去畸变只依赖已保存的标定结果，不要求启用标定采集
+    if (config.calibrationConfig.enableUndistortion) {
+        undistortion_ = std::make_unique<calibration::UndistortionStage>();
+        auto result = getCalibrationManager().loadCalibrationResult("camera_calibration",
+                                                                    config.calibrationConfig.saveDirectory);
+        if (result.isValid) {
+            undistortion_->setCalibration(result);
+        } else {
+            LOG_INFO("No saved calibration, undistortion starts after the first calibration");
+        }
+        getInferenceManager().setFramePreprocessor([this](const cv::Mat& src, cv::Mat& dst) {
+            return undistortion_->apply(src, dst);
+        });
+    }
     
     if (!config.calibrationConfig.enableCalibration) {
         LOG_INFO("Calibration system disabled by configuration");
@@ -224,6 +352,9 @@ bool PerceptionSystem::initializeCalibrationSystem() {
             calibConfig.maxFrames = config.calibrationConfig.maxFrames;
             calibConfig.minInterval = config.calibrationConfig.minInterval;
             calibConfig.useSubPixel = config.calibrationConfig.useSubPixel;
+            calibConfig.minViewDistance = config.calibrationConfig.minViewDistance;
+            calibConfig.incrementalCalibration = config.calibrationConfig.incrementalCalibration;
+            calibConfig.convergenceThreshold = config.calibrationConfig.convergenceThreshold;
             calibConfig.enableUndistortion = config.calibrationConfig.enableUndistortion;
             calibConfig.saveDirectory = config.calibrationConfig.saveDirectory;
             
@@ -249,28 +380,307 @@ bool PerceptionSystem::initializeCalibrationSystem() {
 void PerceptionSystem::handleInferenceResult(const std::string& modelName, 
                                             const cv::Mat& image,
                                             std::shared_ptr<inference::InferenceResult> result) {
-    (void)image; // 消除未使用参数警告
-    
     if (!result || !result->isValid()) {
         return;
     }
     
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if (config.inferenceConfig.enablePerformanceStats) {
         LOG_DEBUG("Inference result for ", modelName, ": ", result->getSummary(), 
                   ", time: ", result->getInferenceTime(), " ms");
     }
     
+    // 检测到目标时触发事件录制
+    if (config.saveConfig.enableTriggerRecord && config.saveConfig.triggerOnDetection) {
+        auto onnxResult = std::dynamic_pointer_cast<inference::ONNXInferenceResult>(result);
+        if (onnxResult && !onnxResult->getDetectionResults().empty()) {
+            DumpHelper::getInstance().trigger("detection_" + modelName);
+        }
+    }
+    
+    // 检测结果发布到共享内存
+    if (shmResults_) {
+        auto onnxResult = std::dynamic_pointer_cast<inference::ONNXInferenceResult>(result);
+        if (onnxResult && onnxResult->getResultType() == "detection") {
+            publishSharedDetections(image, *onnxResult);
+        }
+    }
+    
+    // 推理结果推送给对端
+    if (config.communicationConfig.streamResults) {
+        auto onnxResult = std::dynamic_pointer_cast<inference::ONNXInferenceResult>(result);
+        if (onnxResult) {
+            publishResultRecord(modelName, image, *onnxResult);
+        }
+    }
+    
+    // 检测结果更新跟踪器
+    if (tracker_) {
+        auto onnxResult = std::dynamic_pointer_cast<inference::ONNXInferenceResult>(result);
+        if (onnxResult && onnxResult->getResultType() == "detection") {
+            // 按输入帧到达的时刻更新（与 predict 一致），不计推理与排队耗时
+            const auto& frameInfo = onnxResult->getFrameInfo();
+            int64_t captureTimeUs = frameInfo.captureTimeUs;
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex_);
+                trackImageSize_ = image.size();
+                tracksPreprocessed_ = frameInfo.preprocessed;
+            }
+            publishTracks(tracker_->update(onnxResult->getDetectionResults(),
+                                           captureTimeUs > 0 ? captureTimeUs : steadyTimestampUs(), image));
+            if (config.inferenceConfig.enablePerformanceStats) {
+                LOG_DEBUG(tracker_->getStatistics());
+            }
+        }
+    }
+    
     // 这里可以添加结果可视化或其他处理逻辑
     // 例如：在渲染的图像上绘制检测框、分类结果等
 }
 
+bool PerceptionSystem::initializeSharedMemory() {
+    try {
+        auto snapshot = ConfigHelper::getInstance().current();
+        const auto& config = *snapshot;
+        const auto& stream = config.streamConfig;
+        const auto& comm = config.communicationConfig;
+        uint32_t slotCount = static_cast<uint32_t>(comm.shmSlotCount);
+        
+        // 槽位按流配置的分辨率取上限：彩色按 4 字节/像素（覆盖 RGB/BGRA/YUYV），深度和红外按 2 字节/像素
+        size_t colorSlot = static_cast<size_t>(stream.colorWidth) * stream.colorHeight * 4;
+        size_t depthSlot = static_cast<size_t>(stream.depthWidth) * stream.depthHeight * 2;
+        struct StreamProfile {
+            bool enabled;
+            OBFrameType frameType;
+            const char* suffix;
+            size_t slotSize;
+        };
+        const StreamProfile profiles[] = {
+            {stream.enableColor, OB_FRAME_COLOR, "color", colorSlot},
+            {stream.enableDepth, OB_FRAME_DEPTH, "depth", depthSlot},
+            {stream.enableIR, OB_FRAME_IR, "ir", depthSlot},
+            {stream.enableIRLeft, OB_FRAME_IR_LEFT, "ir_left", depthSlot},
+            {stream.enableIRRight, OB_FRAME_IR_RIGHT, "ir_right", depthSlot},
+        };
+        
+        for (const auto& profile : profiles) {
+            if (!profile.enabled) {
+                continue;
+            }
+            auto channel = std::make_unique<SharedMemoryStream>();
+            channel->encodeRvl = profile.frameType == OB_FRAME_DEPTH && comm.shmDepthEncoding == "rvl";
+            if (!channel->writer.create(comm.shmPrefix + profile.suffix, slotCount, profile.slotSize)) {
+                LOG_ERROR("Failed to create shared memory ", comm.shmPrefix, profile.suffix, ": ",
+                          channel->writer.lastError());
+                continue;
+            }
+            LOG_INFO("Shared memory ", channel->writer.name(), ": ", slotCount, " slots x ",
+                     profile.slotSize, " bytes");
+            shmStreams_[profile.frameType] = std::move(channel);
+        }
+        
+        // 检测结果环：每个槽位最多 1024 个检测框
+        auto results = std::make_unique<SharedMemoryStream>();
+        if (results->writer.create(comm.shmPrefix + "results", slotCount, 1024 * sizeof(ShmDetection))) {
+            shmResults_ = std::move(results);
+        } else {
+            LOG_ERROR("Failed to create shared memory ", comm.shmPrefix, "results: ", results->writer.lastError());
+        }
+        
+        return !shmStreams_.empty();
+        
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error initializing shared memory transport: ", e.what());
+        return false;
+    }
+}
+
+void PerceptionSystem::publishSharedFrame(const std::shared_ptr<ob::Frame>& frame, OBFrameType frameType) {
+    auto it = shmStreams_.find(frameType);
+    if (it == shmStreams_.end() || !frame->is<ob::VideoFrame>()) {
+        return;
+    }
+    
+    auto videoFrame = frame->as<ob::VideoFrame>();
+    ShmFrameInfo info;
+    info.frameIndex = frame->getIndex();
+    info.deviceTimestampUs = frame->getTimeStampUs();
+    info.streamType = static_cast<uint32_t>(frameType);
+    info.format = static_cast<uint32_t>(frame->getFormat());
+    info.width = videoFrame->getWidth();
+    info.height = videoFrame->getHeight();
+    
+    auto& channel = *it->second;
+    std::lock_guard<std::mutex> lock(channel.mutex);
+    
+    // RVL 编码的深度帧：读端按 format 用 utils::DepthCodec 解码；编码结果放不进槽位时发布原始数据
+    if (channel.encodeRvl && info.format == OB_FORMAT_Y16) {
+        size_t encodedSize = utils::DepthCodec::encode(reinterpret_cast<const uint16_t*>(frame->getData()),
+                                                       static_cast<int>(info.width), static_cast<int>(info.height),
+                                                       channel.encoded);
+        if (encodedSize > 0 && encodedSize <= channel.writer.slotCapacity()) {
+            info.format = OB_FORMAT_RVL;
+            channel.writer.publish(info, channel.encoded.data(), encodedSize);
+            return;
+        }
+    }
+    
+    if (!channel.writer.publish(info, frame->getData(), frame->getDataSize()) && !channel.oversizeLogged) {
+        channel.oversizeLogged = true;
+        LOG_WARN("Frame of ", frame->getDataSize(), " bytes exceeds shared memory slot (",
+                 channel.writer.slotCapacity(), " bytes) of ", channel.writer.name(), ", frames are skipped");
+    }
+}
+
+void PerceptionSystem::publishSharedDetections(const cv::Mat& image,
+                                               const inference::ONNXInferenceResult& result) {
+    const auto& detections = result.getDetectionResults();
+    const auto& frameInfo = result.getFrameInfo();
+    std::vector<ShmDetection> records;
+    records.reserve(detections.size());
+    for (const auto& detection : detections) {
+        cv::Rect2f bbox = detection.bbox;
+        mapToSourceImage(bbox, image.size(), frameInfo.preprocessed);
+        ShmDetection record;
+        record.x = bbox.x;
+        record.y = bbox.y;
+        record.width = bbox.width;
+        record.height = bbox.height;
+        record.confidence = detection.confidence;
+        record.classId = detection.classId;
+        records.push_back(record);
+    }
+    
+    // 帧号与设备时间戳和帧流一致，读端据此把结果与对应的帧配对
+    ShmFrameInfo info;
+    info.frameIndex = frameInfo.frameIndex;
+    info.deviceTimestampUs = frameInfo.deviceTimestampUs;
+    info.streamType = SHM_STREAM_RESULTS;
+    info.width = static_cast<uint32_t>(image.cols);
+    info.height = static_cast<uint32_t>(image.rows);
+    
+    size_t maxRecords = shmResults_->writer.slotCapacity() / sizeof(ShmDetection);
+    std::lock_guard<std::mutex> lock(shmResults_->mutex);
+    shmResults_->writer.publish(info, records.data(), std::min(records.size(), maxRecords) * sizeof(ShmDetection));
+}
+
+void PerceptionSystem::publishResultRecord(const std::string& modelName, const cv::Mat& image,
+                                           const inference::ONNXInferenceResult& result) {
+    // 没有对端或对端只支持文本格式时不编码
+    if (commProxy_.getConnectionState() != CommunicationProxy::ConnectionState::CONNECTED ||
+        !commProxy_.isBinaryFramingActive()) {
+        return;
+    }
+    
+    const auto& frameInfo = result.getFrameInfo();
+    ResultRecordHeader header;
+    header.frameIndex = frameInfo.frameIndex;
+    header.deviceTimestampUs = frameInfo.deviceTimestampUs;
+    header.captureTimeUs = static_cast<uint64_t>(frameInfo.captureTimeUs);
+    header.resultTimeUs = static_cast<uint64_t>(steadyTimestampUs());
+    header.inferenceTimeUs = static_cast<uint32_t>(result.getInferenceTime() * 1000.0);
+    header.imageWidth = static_cast<uint16_t>(image.cols);
+    header.imageHeight = static_cast<uint16_t>(image.rows);
+    
+    std::lock_guard<std::mutex> lock(resultStreamMutex_);
+    resultBoxes_.clear();
+    const std::string& type = result.getResultType();
+    if (type == "detection") {
+        header.kind = ResultKind::DETECTION;
+        for (const auto& detection : result.getDetectionResults()) {
+            cv::Rect2f bbox = detection.bbox;
+            mapToSourceImage(bbox, image.size(), frameInfo.preprocessed);
+            ResultBox box;
+            box.x = bbox.x;
+            box.y = bbox.y;
+            box.width = bbox.width;
+            box.height = bbox.height;
+            box.score = detection.confidence;
+            box.classId = detection.classId;
+            resultBoxes_.push_back(box);
+        }
+    } else if (type == "classification") {
+        header.kind = ResultKind::CLASSIFICATION;
+        const auto& classification = result.getClassificationResult();
+        ResultBox box;
+        box.width = static_cast<float>(image.cols);
+        box.height = static_cast<float>(image.rows);
+        box.score = classification.confidence;
+        box.classId = classification.classId;
+        resultBoxes_.push_back(box);
+    } else if (type == "segmentation") {
+        header.kind = ResultKind::SEGMENTATION;
+        summarizeSegmentation(result.getSegmentationMask(), resultBoxes_);
+    } else {
+        return;
+    }
+    
+    auto inserted = resultModelIds_.emplace(modelName, static_cast<uint16_t>(resultModelIds_.size()));
+    header.modelId = inserted.first->second;
+    if (inserted.second) {
+        // 新分配的编号通知对端（对端也可以随时用 GET_MODELS 查询）
+        commProxy_.sendMessage(CommunicationProxy::MessageType::METADATA,
+                               "MODEL:" + std::to_string(header.modelId) + "=" + modelName);
+    }
+    
+    ResultRecord::encode(resultRecord_, header, resultBoxes_.data(), resultBoxes_.size());
+    commProxy_.sendBinary(CommunicationProxy::MessageType::DATA, resultRecord_.data(), resultRecord_.size(),
+                          RESULT_COALESCE_KEY | header.modelId);
+}
+
+std::string PerceptionSystem::getResultModelList() {
+    std::lock_guard<std::mutex> lock(resultStreamMutex_);
+    std::vector<const std::string*> names(resultModelIds_.size());
+    for (const auto& entry : resultModelIds_) {
+        names[entry.second] = &entry.first;
+    }
+    std::string list;
+    for (size_t id = 0; id < names.size(); ++id) {
+        if (id > 0) {
+            list += ",";
+        }
+        list += std::to_string(id) + "=" + *names[id];
+    }
+    return list;
+}
+
+void PerceptionSystem::setTrackingCallback(TrackingCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    trackingCallback_ = std::move(callback);
+}
+
+std::vector<inference::TrackedObject> PerceptionSystem::getTrackedObjects() const {
+    return tracker_ ? tracker_->getTracks() : std::vector<inference::TrackedObject>();
+}
+
+void PerceptionSystem::publishTracks(std::vector<inference::TrackedObject> objects) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (trackingCallback_) {
+        for (auto& object : objects) {
+            mapToSourceImage(object.bbox, trackImageSize_, tracksPreprocessed_);
+        }
+        try {
+            trackingCallback_(objects);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Error in tracking callback: ", e.what());
+        }
+    }
+}
+
+void PerceptionSystem::mapToSourceImage(cv::Rect2f& box, const cv::Size& size, bool preprocessed) const {
+    if (preprocessed && undistortion_) {
+        undistortion_->distortBox(box, size);
+    }
+}
+
 void PerceptionSystem::handleCalibrationProgress(calibration::CalibrationState state,
                                                 int currentFrames,
                                                 int totalFrames,
                                                 const std::string& message) {
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     if (config.calibrationConfig.showCalibrationProgress) {
         std::string stateStr;
@@ -291,6 +701,11 @@ void PerceptionSystem::handleCalibrationProgress(calibration::CalibrationState s
             }
         }
     }
+    
+    // 新的标定结果立即用于去畸变（映射表整体替换，不影响正在处理的帧）
+    if (state == calibration::CalibrationState::COMPLETED && undistortion_) {
+        undistortion_->setCalibration(getCalibrationManager().getLastResult());
+    }
 }
 
 void PerceptionSystem::registerStateHandlers() {
@@ -383,7 +798,8 @@ void PerceptionSystem::start() {
     LOG_INFO("Starting PerceptionSystem...");
     
     // 获取配置
-    auto& config = ConfigHelper::getInstance();
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = *snapshot;
     
     // 启动通信代理（如果启用）
     if (config.communicationConfig.enableCommunication) {
@@ -494,8 +910,13 @@ void PerceptionSystem::stop() {
         imageReceiver_->stopStreaming();
     }
     
+    // 取消去畸变预处理（推理管理器是单例，生命周期长于本对象）
+    if (undistortion_) {
+        getInferenceManager().setFramePreprocessor(nullptr);
+    }
+    
     // 停止通信代理（如果启用）
-    if (ConfigHelper::getInstance().communicationConfig.enableCommunication) {
+    if (ConfigHelper::getInstance().current()->communicationConfig.enableCommunication) {
         commProxy_.stop();
     }
     
@@ -515,6 +936,11 @@ bool PerceptionSystem::setState(SystemState newState) {
     // 执行状态转换
     currentState_ = newState;
     
+    // 进入错误状态时保存故障前后的帧（需在停止流之前触发）
+    if(newState == SystemState::ERROR) {
+        DumpHelper::getInstance().trigger("state_" + getStateName(oldState) + "_to_ERROR");
+    }
+    
     // 处理状态转换
     handleStateTransition(oldState, newState);
     
@@ -612,65 +1038,107 @@ void PerceptionSystem::setupCommunicationCallbacks() {
 void PerceptionSystem::handleCommunicationMessage(const CommunicationProxy::Message& message) {
     LOG_DEBUG("Received communication message: ", message.content);
     
+    // 状态切换命令本身没有回复；对方以请求方式发送时回复切换后的状态
+    auto switchTo = [this, &message](SystemState state) {
+        setState(state);
+        if (message.requestId != 0) {
+            commProxy_.reply(message, CommunicationProxy::MessageType::STATUS_REPORT,
+                             "CURRENT_STATE:" + getStateName(currentState_));
+        }
+    };
+    
     // 处理状态切换命令
     if(message.content == "START_RUNNING") {
         // 状态转换会触发耗时操作，但此时已在线程池中执行
-        setState(SystemState::RUNNING);
+        switchTo(SystemState::RUNNING);
     }
     else if(message.content == "START_PENDING") {
-        setState(SystemState::PENDING);
+        switchTo(SystemState::PENDING);
     }
     else if(message.content == "START_CALIBRATION") {
-        setState(SystemState::CALIBRATING);
+        switchTo(SystemState::CALIBRATING);
     }
     else if(message.content == "START_STANDBY") {
         // 将STANDBY命令映射到PENDING状态
-        setState(SystemState::PENDING);
+        switchTo(SystemState::PENDING);
     }
     else if(message.content == "START_UPGRADE") {
-        setState(SystemState::UPGRADING);
+        switchTo(SystemState::UPGRADING);
     }
     else if(message.content == "SHUTDOWN") {
-        setState(SystemState::SHUTDOWN);
+        switchTo(SystemState::SHUTDOWN);
     }
     else if(message.content == "REPORT_ERROR") {
-        setState(SystemState::ERROR);
+        switchTo(SystemState::ERROR);
     }
     else if(message.content == "GET_STATUS") {
         // 状态查询不涉及状态转换，可以快速响应
         // 发送状态报告，不考虑连接状态（如果未连接则丢弃）
-        commProxy_.sendMessage(
+        commProxy_.reply(message,
             CommunicationProxy::MessageType::STATUS_REPORT,
             "CURRENT_STATE:" + getStateName(currentState_)
         );
     }
+    else if(message.content == "GET_MODELS") {
+        // 结果记录中模型编号与名称的对照表
+        commProxy_.reply(message,
+            CommunicationProxy::MessageType::STATUS_REPORT,
+            "MODELS:" + getResultModelList()
+        );
+    }
     else if(message.content == "TAKE_SNAPSHOT" && imageReceiver_) {
         LOG_INFO("Taking snapshot command received");
-        // 直接修改全局配置而不是调用已删除的方法
-        ConfigHelper::getInstance().saveConfig.enableDump = true;
+        // 发布开启保存的新配置快照
+        ConfigHelper::getInstance().update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.saveConfig.enableDump = true;
+        });
+        if (message.requestId != 0) {
+            commProxy_.reply(message, CommunicationProxy::MessageType::STATUS_REPORT, "SNAPSHOT_REQUESTED");
+        }
     }
     else if(message.content == "START_CAPTURE") {
         LOG_INFO("Start capturing command received");
-        // 直接修改全局配置
-        ConfigHelper::getInstance().saveConfig.enableDump = true;
+        // 发布开启保存的新配置快照
+        ConfigHelper::getInstance().update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.saveConfig.enableDump = true;
+        });
         LOG_INFO("Data capture started");
-        commProxy_.sendMessage(
+        commProxy_.reply(message,
             CommunicationProxy::MessageType::STATUS_REPORT,
             "CAPTURE_STARTED"
         );
     }
     else if(message.content == "STOP_CAPTURE") {
         LOG_INFO("Stop capturing command received");
-        // 直接修改全局配置
-        ConfigHelper::getInstance().saveConfig.enableDump = false;
+        // 发布关闭保存的新配置快照
+        ConfigHelper::getInstance().update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.saveConfig.enableDump = false;
+        });
         LOG_INFO("Data capture stopped");
-        commProxy_.sendMessage(
+        commProxy_.reply(message,
             CommunicationProxy::MessageType::STATUS_REPORT,
             "CAPTURE_STOPPED"
         );
     }
+    else if(message.content == "TRIGGER_RECORD" || message.content.rfind("TRIGGER_RECORD:", 0) == 0) {
+        // 格式: TRIGGER_RECORD 或 TRIGGER_RECORD:<reason>
+        std::string reason = "command";
+        size_t colonPos = message.content.find(':');
+        if (colonPos != std::string::npos && colonPos + 1 < message.content.size()) {
+            reason = message.content.substr(colonPos + 1);
+        }
+        LOG_INFO("Trigger record command received, reason: ", reason);
+        bool accepted = DumpHelper::getInstance().trigger(reason);
+        commProxy_.reply(message,
+            CommunicationProxy::MessageType::STATUS_REPORT,
+            accepted ? "TRIGGER_ACCEPTED" : "TRIGGER_REJECTED"
+        );
+    }
     else {
         LOG_WARN("Unknown command: ", message.content);
+        if (message.requestId != 0) {
+            commProxy_.reply(message, CommunicationProxy::MessageType::ERROR, "UNKNOWN_COMMAND:" + message.content);
+        }
     }
 }
 
@@ -694,7 +1162,7 @@ void PerceptionSystem::handleHeartBeatMessage(const CommunicationProxy::Message&
     if (requestType == "PING") {
         // 回复心跳请求，包含当前状态信息和原始请求数据
         LOG_DEBUG("Replying to heartbeat request: PING:", requestData, " -> PONG:", requestData, ":", getStateName(currentState_));
-        commProxy_.sendMessage(
+        commProxy_.reply(message,
             CommunicationProxy::MessageType::HEARTBEAT,
             "PONG:" + requestData + ":" + getStateName(currentState_)
         );
@@ -739,5 +1207,9 @@ void PerceptionSystem::cleanup() {
         imageReceiver_.reset();
     }
     
+    // 不再有帧到达后关闭共享内存，读端收到 CLOSED
+    shmStreams_.clear();
+    shmResults_.reset();
+    
     LOG_DEBUG("PerceptionSystem cleanup completed");
 }
@@ -9,8 +9,12 @@
 #include <queue>
 #include "ImageReceiver.hpp"
 #include "CommunicationProxy.hpp"
+#include "ShmFrameRing.hpp"
+#include "ResultRecord.hpp"
 #include "InferenceManager.hpp"
+#include "ObjectTracker.hpp"
 #include "CalibrationManager.hpp"
+#include "UndistortionStage.hpp"
 
 /**
  * @brief 感知系统 - 整个相机系统的主控制类
@@ -38,6 +42,11 @@ public:
      */
     using StateHandler = std::function<void()>;
 
+    /**
+     * @brief 跟踪结果回调类型（推理帧与跳过推理的帧都会调用）
+     */
+    using TrackingCallback = std::function<void(const std::vector<inference::TrackedObject>& objects)>;
+
     /**
      * @brief 获取单例实例
      * @return 单例实例引用
@@ -142,6 +151,18 @@ public:
      * @return 是否启用
      */
     bool isCalibrationEnabled() const { return calibrationEnabled_; }
+    
+    /**
+     * @brief 设置跟踪结果回调
+     * @param callback 回调函数
+     */
+    void setTrackingCallback(TrackingCallback callback);
+    
+    /**
+     * @brief 获取最近一帧的跟踪目标
+     * @return 跟踪目标（未启用跟踪时为空）
+     */
+    std::vector<inference::TrackedObject> getTrackedObjects() const;
 
 private:
     /**
@@ -266,6 +287,69 @@ private:
                                   int totalFrames,
                                   const std::string& message);
     
+    /**
+     * @brief 发布跟踪结果（框映射回原始图像坐标）
+     * @param objects 跟踪目标
+     */
+    void publishTracks(std::vector<inference::TrackedObject> objects);
+    
+    /**
+     * @brief 推理图像经过去畸变时，把框映射回原始（带畸变）图像坐标
+     *
+     * 只有推理输入去畸变，显示、保存与共享内存发布的都是原始帧，发布的框需与之对应。
+     * @param box 推理图像上的框，原地替换
+     * @param size 推理图像分辨率
+     * @param preprocessed 推理图像是否经过帧预处理
+     */
+    void mapToSourceImage(cv::Rect2f& box, const cv::Size& size, bool preprocessed) const;
+    
+    /**
+     * @brief 按流配置创建共享内存环（enableSharedMemory 时）
+     * @return 是否成功
+     */
+    bool initializeSharedMemory();
+    
+    /**
+     * @brief 把一帧发布到对应流的共享内存环
+     * @param frame 帧
+     * @param frameType 帧类型
+     */
+    void publishSharedFrame(const std::shared_ptr<ob::Frame>& frame, OBFrameType frameType);
+    
+    /**
+     * @brief 把检测结果发布到结果共享内存环
+     * @param image 输入图像
+     * @param result 检测结果
+     */
+    void publishSharedDetections(const cv::Mat& image, const inference::ONNXInferenceResult& result);
+    
+    /**
+     * @brief 把推理结果编码为二进制记录，以 DATA 消息推送给对端（streamResults 时）
+     *
+     * 每个模型一个合并键：对端拥塞时发送队列中只保留该模型最新的结果。
+     * @param modelName 模型名称
+     * @param image 输入图像
+     * @param result 推理结果
+     */
+    void publishResultRecord(const std::string& modelName, const cv::Mat& image,
+                             const inference::ONNXInferenceResult& result);
+    
+    /**
+     * @brief 模型编号对照表，格式 "0=name,1=name"（GET_MODELS 命令的回复）
+     */
+    std::string getResultModelList();
+    
+    /**
+     * @brief 共享内存发布通道（并行处理模式下同一流的帧可能来自多个线程）
+     */
+    struct SharedMemoryStream {
+        std::mutex mutex;                     ///< 写端只允许一个线程发布
+        ShmFrameRingWriter writer;            ///< 共享内存环写端
+        bool oversizeLogged = false;          ///< 已记录过超出槽位容量的警告
+        bool encodeRvl = false;               ///< 深度帧以 RVL 编码后发布
+        std::vector<uint8_t> encoded;         ///< RVL 编码缓冲（复用）
+    };
+    
     // 成员变量
     CommunicationProxy& commProxy_;             ///< 通信代理引用
     std::unique_ptr<ImageReceiver> imageReceiver_; ///< 图像接收器
@@ -284,4 +368,23 @@ private:
     // 推理和标定功能状态
     std::atomic<bool> inferenceEnabled_{false};   ///< 推理功能启用标志
     std::atomic<bool> calibrationEnabled_{false}; ///< 标定功能启用标志
+    
+    // 目标跟踪（推理跳过的帧输出预测框）
+    std::unique_ptr<inference::ObjectTracker> tracker_; ///< 跟踪器（未启用时为空）
+    TrackingCallback trackingCallback_;       ///< 跟踪结果回调（受 callbackMutex_ 保护）
+    cv::Size trackImageSize_;                 ///< 跟踪器坐标所在的推理图像分辨率（受 callbackMutex_ 保护）
+    bool tracksPreprocessed_ = false;         ///< 跟踪器坐标是否为去畸变图像坐标（受 callbackMutex_ 保护）
+    
+    // 去畸变（enableUndistortion 时作为推理前的帧预处理）
+    std::unique_ptr<calibration::UndistortionStage> undistortion_;
+    
+    // 共享内存发布（initialize 时创建，之后只读，运行中不增删）
+    std::map<OBFrameType, std::unique_ptr<SharedMemoryStream>> shmStreams_; ///< 帧类型 -> 帧环
+    std::unique_ptr<SharedMemoryStream> shmResults_;  ///< 检测结果环（未启用时为空）
+    
+    // 推理结果推送（多个推理线程可能同时完成，编码缓冲区复用）
+    std::mutex resultStreamMutex_;                    ///< 保护以下成员
+    std::map<std::string, uint16_t> resultModelIds_;  ///< 模型名称 -> 编号（按首次出现的顺序分配）
+    std::vector<ResultBox> resultBoxes_;              ///< 条目缓冲区
+    std::vector<uint8_t> resultRecord_;               ///< 编码缓冲区
 }; 
\ No newline at end of file
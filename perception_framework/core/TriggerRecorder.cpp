@@ -0,0 +1,185 @@
+#include "TriggerRecorder.hpp"
+#include "DumpHelper.hpp"
+#include "DumpSession.hpp"
+#include "ConfigHelper.hpp"
+#include "Logger.hpp"
+#include <cctype>
+#include <chrono>
+
+TriggerRecorder& TriggerRecorder::getInstance() {
+    static TriggerRecorder instance;
+    return instance;
+}
+
+TriggerRecorder::TriggerRecorder() {
+    writerThread_ = std::thread(&TriggerRecorder::writerLoop, this);
+}
+
+TriggerRecorder::~TriggerRecorder() {
+    stop();
+}
+
+void TriggerRecorder::pushFrame(std::shared_ptr<ob::Frame> frame) {
+    if (!frame || !running_) return;
+
+    try {
+        // 深拷贝帧数据，释放 SDK 内部缓冲
+        auto copy = ob::FrameFactory::createFrameFromOtherFrame(frame, true);
+        if (!copy) return;
+
+        size_t bytes = copy->getDataSize();
+        auto options = windowOptions();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (window_.push(copy, bytes, Window::Clock::now(), options)) {
+            LOG_INFO("Trigger event finished: ", window_.eventPath());
+        }
+        postActive_ = window_.recording();
+        if (window_.hasPendingWrites()) {
+            writeCondition_.notify_one();
+        }
+    } catch (const ob::Error& e) {
+        LOG_ERROR("TriggerRecorder: failed to copy frame: ", e.getMessage());
+    } catch (const std::exception& e) {
+        LOG_ERROR("TriggerRecorder: error buffering frame: ", e.what());
+    }
+}
+
+bool TriggerRecorder::trigger(const std::string& reason) {
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->saveConfig;
+    if (!config.enableTriggerRecord || !running_) {
+        LOG_DEBUG("Trigger ignored (recorder disabled): ", reason);
+        return false;
+    }
+
+    auto now = Window::Clock::now();
+    auto options = windowOptions();
+
+    // 在锁外生成事件目录名；目录由写盘线程创建，mkdir 不阻塞采集线程的 pushFrame
+    std::string eventPath = makeEventPath(reason);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.triggers++;
+
+    // 进行中的事件：延长截止时间，历史帧已写出
+    if (window_.extend(now, options)) {
+        LOG_INFO("Trigger merged into active event: ", reason);
+        return true;
+    }
+
+    // 写出触发前历史帧（上一个事件录制阶段的帧不在环形缓冲中，不会重复写出）
+    size_t preFrames = window_.start(eventPath, now, options);
+    postActive_ = true;
+    writeCondition_.notify_one();
+
+    LOG_INFO("Trigger event started: ", reason, ", pre-trigger frames: ", preFrames,
+             ", path: ", eventPath);
+    return true;
+}
+
+TriggerRecorder::Stats TriggerRecorder::getStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.framesDropped = window_.droppedFrames();
+    stats.bufferedFrames = window_.bufferedFrames();
+    stats.bufferedBytes = window_.bufferedBytes();
+    stats.queuedBytes = window_.queuedBytes();
+    return stats;
+}
+
+void TriggerRecorder::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    writeCondition_.notify_all();
+    if (writerThread_.joinable()) {
+        writerThread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    window_.clear();
+    postActive_ = false;
+}
+
+TriggerRecorder::Window::Options TriggerRecorder::windowOptions() {
+    auto snapshot = ConfigHelper::getInstance().current();
+    const auto& config = snapshot->saveConfig;
+
+    Window::Options options;
+    options.preWindow = std::chrono::duration_cast<Window::Clock::duration>(
+        std::chrono::duration<double>(config.preTriggerSeconds));
+    options.postWindow = std::chrono::duration_cast<Window::Clock::duration>(
+        std::chrono::duration<double>(config.postTriggerSeconds));
+    options.maxBytes = static_cast<size_t>(config.triggerBufferMaxMB) * 1024 * 1024;
+    return options;
+}
+
+std::string TriggerRecorder::makeEventPath(const std::string& reason) {
+    std::string safeReason = reason.empty() ? "manual" : reason;
+    for (auto& c : safeReason) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+
+    uint64_t nowUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    char timeStr[20];
+    DumpSession::formatTime(nowUs, timeStr);
+
+    // 使用 DumpHelper 规范化后的根目录
+    std::string path = DumpHelper::getInstance().getDumpPath();
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    path += "events/";
+    path += timeStr;
+    path += '_';
+    path += safeReason;
+    path += '/';
+    return path;
+}
+
+void TriggerRecorder::writerLoop() {
+    std::string createdPath;  // 已创建的事件目录（仅写盘线程访问）
+    bool pathReady = false;
+
+    while (true) {
+        Window::WriteTask task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            writeCondition_.wait(lock, [this] { return !running_ || window_.hasPendingWrites(); });
+
+            if (!window_.pop(task)) {
+                break;  // 已停止且队列写完
+            }
+        }
+
+        try {
+            // 每个事件的第一帧到达时创建事件目录
+            if (task.path != createdPath) {
+                createdPath = task.path;
+                pathReady = !Logger::ensureDirectoryExists(task.path, true).empty();
+                if (!pathReady) {
+                    LOG_ERROR("Failed to create trigger event directory: ", task.path);
+                }
+            }
+            if (!pathReady) {
+                continue;
+            }
+
+            auto& dumpHelper = DumpHelper::getInstance();
+            dumpHelper.save(task.item, task.path);
+            if (ConfigHelper::getInstance().current()->saveConfig.saveMetadata) {
+                dumpHelper.saveMetadata(task.item, task.path);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.framesWritten++;
+        } catch (const std::exception& e) {
+            LOG_ERROR("TriggerRecorder: error writing frame: ", e.what());
+        }
+    }
+}
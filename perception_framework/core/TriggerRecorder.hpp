@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "libobsensor/ObSensor.hpp"
+#include "TriggerWindow.hpp"
+
+/**
+ * @brief 触发式录制器 - 保存事件前后的帧数据
+ *
+ * 在内存环形缓冲中保留最近 N 秒的帧（与写盘队列共用字节上限，见 TriggerWindow），
+ * 触发时将触发前的历史帧与触发后 M 秒内的帧交给后台写盘线程，
+ * 通过 DumpHelper::save 写入独立的事件目录。
+ * 作为 DumpHelper 的组件使用，触发源来自 PerceptionSystem。
+ */
+class TriggerRecorder {
+public:
+    /**
+     * @brief 录制统计信息
+     */
+    struct Stats {
+        uint64_t triggers = 0;        ///< 触发次数（含合并到进行中事件的触发）
+        uint64_t framesWritten = 0;   ///< 已写盘帧数
+        uint64_t framesDropped = 0;   ///< 字节上限不足丢弃的待写帧数
+        size_t bufferedFrames = 0;    ///< 当前环形缓冲帧数
+        size_t bufferedBytes = 0;     ///< 当前环形缓冲字节数
+        size_t queuedBytes = 0;       ///< 当前待写盘字节数
+    };
+
+    static TriggerRecorder& getInstance();
+
+    /**
+     * @brief 推入一帧（由 DumpHelper::processFrame 调用）
+     * 帧数据会被拷贝，避免长期占用 SDK 帧缓冲池
+     * @param frame 帧数据
+     */
+    void pushFrame(std::shared_ptr<ob::Frame> frame);
+
+    /**
+     * @brief 触发一次录制事件
+     * 若已有事件处于触发后录制阶段，则延长该事件而不是新建事件
+     * @param reason 触发原因（用于事件目录命名）
+     * @return 是否接受触发
+     */
+    bool trigger(const std::string& reason);
+
+    /**
+     * @brief 是否处于触发后录制阶段
+     */
+    bool isRecording() const { return postActive_; }
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats();
+
+    /**
+     * @brief 清空缓冲并停止写盘线程
+     */
+    void stop();
+
+private:
+    TriggerRecorder();
+    ~TriggerRecorder();
+    TriggerRecorder(const TriggerRecorder&) = delete;
+    TriggerRecorder& operator=(const TriggerRecorder&) = delete;
+
+    using Window = TriggerWindow<std::shared_ptr<ob::Frame>>;
+
+    // 从当前配置快照读取窗口参数
+    static Window::Options windowOptions();
+
+    // 生成事件目录名（不创建目录，目录由写盘线程在写第一帧前创建）
+    static std::string makeEventPath(const std::string& reason);
+
+    // 后台写盘线程
+    void writerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable writeCondition_;
+
+    Window window_;                           ///< 历史帧、写盘队列与事件窗口
+    std::atomic<bool> postActive_{false};     ///< 是否处于触发后录制阶段（window_ 的无锁副本）
+
+    Stats stats_;
+    std::atomic<bool> running_{true};
+    std::thread writerThread_;
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+
+/**
+ * @brief 触发式录制的缓冲窗口
+ *
+ * 管理触发前历史帧的环形缓冲、待写盘队列与触发后录制截止时间，本身不加锁，
+ * 由 TriggerRecorder 持锁调用（与帧类型无关，便于单独测试）。
+ *
+ * 环形缓冲与写盘队列共用一个字节预算：超出预算时先淘汰最旧的历史帧，
+ * 只有写盘队列本身占满预算时才丢弃待写帧。
+ * 触发后录制阶段的帧只进入写盘队列，不再进入环形缓冲，
+ * 因此紧随其后的新事件不会重复写出上一个事件已经写过的帧。
+ */
+template <typename Item>
+class TriggerWindow {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 窗口参数（每次调用传入，配置热加载后立即生效）
+     */
+    struct Options {
+        Clock::duration preWindow{};    ///< 触发前保留时长
+        Clock::duration postWindow{};   ///< 触发后录制时长
+        size_t maxBytes = 0;            ///< 环形缓冲与写盘队列的总字节上限
+    };
+
+    /**
+     * @brief 写盘任务
+     */
+    struct WriteTask {
+        Item item{};
+        std::string path;               ///< 所属事件目录
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief 推入一帧
+     * 触发后录制阶段内的帧加入写盘队列，否则进入环形缓冲
+     * @return 本帧到达时触发后录制阶段已经结束，返回 true
+     */
+    bool push(Item item, size_t bytes, Clock::time_point now, const Options& options) {
+        bool finished = false;
+        if (postActive_) {
+            if (now <= postDeadline_) {
+                enqueue(std::move(item), bytes, options);
+                return false;
+            }
+            postActive_ = false;
+            finished = true;
+        }
+
+        ring_.push_back({std::move(item), now, bytes});
+        ringBytes_ += bytes;
+        evict(now, options);
+        return finished;
+    }
+
+    /**
+     * @brief 事件处于触发后录制阶段时延长截止时间
+     * @return 是否合并到进行中的事件
+     */
+    bool extend(Clock::time_point now, const Options& options) {
+        if (!postActive_ || now > postDeadline_) {
+            return false;
+        }
+        postDeadline_ = now + options.postWindow;
+        return true;
+    }
+
+    /**
+     * @brief 开始新事件：历史帧整体移入写盘队列，进入触发后录制阶段
+     * @param path 事件目录
+     * @return 写出的历史帧数
+     */
+    size_t start(const std::string& path, Clock::time_point now, const Options& options) {
+        eventPath_ = path;
+        evict(now, options);
+
+        // 帧从环形缓冲移到写盘队列，总字节数不变，不会因预算被丢弃
+        size_t preFrames = ring_.size();
+        while (!ring_.empty()) {
+            BufferedFrame buffered = std::move(ring_.front());
+            ring_.pop_front();
+            ringBytes_ -= buffered.bytes;
+            enqueue(std::move(buffered.item), buffered.bytes, options);
+        }
+
+        postDeadline_ = now + options.postWindow;
+        postActive_ = true;
+        return preFrames;
+    }
+
+    /**
+     * @brief 取出最早的写盘任务
+     */
+    bool pop(WriteTask& task) {
+        if (writeQueue_.empty()) {
+            return false;
+        }
+        task = std::move(writeQueue_.front());
+        writeQueue_.pop_front();
+        queuedBytes_ -= task.bytes;
+        return true;
+    }
+
+    /**
+     * @brief 清空历史帧并结束当前事件（保留待写盘队列）
+     */
+    void clear() {
+        ring_.clear();
+        ringBytes_ = 0;
+        postActive_ = false;
+    }
+
+    bool recording() const { return postActive_; }
+    const std::string& eventPath() const { return eventPath_; }
+    bool hasPendingWrites() const { return !writeQueue_.empty(); }
+    size_t bufferedFrames() const { return ring_.size(); }
+    size_t bufferedBytes() const { return ringBytes_; }
+    size_t queuedFrames() const { return writeQueue_.size(); }
+    size_t queuedBytes() const { return queuedBytes_; }
+    uint64_t droppedFrames() const { return dropped_; }
+
+private:
+    struct BufferedFrame {
+        Item item;
+        Clock::time_point time;
+        size_t bytes = 0;
+    };
+
+    // 淘汰超出时间窗口的历史帧，并为待写帧让出字节预算
+    void evict(Clock::time_point now, const Options& options) {
+        while (!ring_.empty() &&
+               (now - ring_.front().time > options.preWindow ||
+                ringBytes_ + queuedBytes_ > options.maxBytes)) {
+            ringBytes_ -= ring_.front().bytes;
+            ring_.pop_front();
+        }
+    }
+
+    // 加入写盘队列：先淘汰历史帧腾出预算，仍放不下时丢弃（磁盘跟不上）
+    void enqueue(Item item, size_t bytes, const Options& options) {
+        while (!ring_.empty() && ringBytes_ + queuedBytes_ + bytes > options.maxBytes) {
+            ringBytes_ -= ring_.front().bytes;
+            ring_.pop_front();
+        }
+        if (ringBytes_ + queuedBytes_ + bytes > options.maxBytes) {
+            dropped_++;
+            return;
+        }
+        writeQueue_.push_back({std::move(item), eventPath_, bytes});
+        queuedBytes_ += bytes;
+    }
+
+    std::deque<BufferedFrame> ring_;        ///< 触发前历史帧
+    size_t ringBytes_ = 0;
+    std::deque<WriteTask> writeQueue_;      ///< 待写盘帧
+    size_t queuedBytes_ = 0;
+
+    bool postActive_ = false;               ///< 是否处于触发后录制阶段
+    Clock::time_point postDeadline_;        ///< 触发后录制截止时间
+    std::string eventPath_;                 ///< 当前事件目录
+    uint64_t dropped_ = 0;                  ///< 因预算不足丢弃的待写帧
+};
@@ -0,0 +1,258 @@
+#include "AutoInferenceEngine.hpp"
+#include "ModelCache.hpp"
+#include "OpenCVDNNInference.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace inference {
+
+namespace {
+
+constexpr int WARMUP_RUNS = 2;                  // 预热次数（首次执行包含内存分配与内核选择）
+constexpr int TIMED_RUNS = 5;                   // 计时次数，取中位数
+constexpr double OUTPUT_TOLERANCE = 1e-3;       // 输出一致的最大相对误差
+constexpr const char* DECISION_VERSION = "auto-1";
+constexpr const char* DECISION_EXTENSION = ".backend";
+
+/**
+ * @brief 后端选择缓存键中的选项：可用后端、OpenCV 版本与输入形状
+ */
+std::string decisionOptions(const ModelConfig& config, const std::vector<std::string>& backends) {
+    std::ostringstream oss;
+    oss << "backends=";
+    for (const auto& backend : backends) {
+        oss << backend << ",";
+    }
+    oss << ";opencv=" << cv::getVersionString() << ";shape=";
+    for (size_t i = 0; i < config.inputShape.size(); i++) {
+        oss << (i > 0 ? "x" : "") << config.inputShape[i];
+    }
+    return oss.str();
+}
+
+/**
+ * @brief 两组输出的最大相对误差（尺寸不同时为无穷大）
+ */
+double outputError(const std::vector<float>& reference, const std::vector<float>& output) {
+    if (reference.size() != output.size() || reference.empty()) {
+        return INFINITY;
+    }
+    double scale = 1.0;
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        scale = std::max(scale, static_cast<double>(std::fabs(reference[i])));
+        maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(reference[i] - output[i])));
+    }
+    return maxDiff / scale;
+}
+
+} // namespace
+
+std::vector<std::string> AutoInferenceEngine::availableBackends() {
+    std::vector<std::string> backends = {"onnx"};
+    if (OpenCVDNNEngine::isAvailable()) {
+        backends.push_back("opencv");
+    }
+    return backends;
+}
+
+std::shared_ptr<InferenceEngine> AutoInferenceEngine::createBackend(const std::string& backend,
+                                                                    const ModelConfig& config) {
+    auto engine = InferenceEngineFactory::createEngine(backend);
+    if (!engine) {
+        return nullptr;
+    }
+    ModelConfig backendConfig = config;
+    backendConfig.engineType = backend;
+    if (!engine->initialize(backendConfig)) {
+        return nullptr;
+    }
+    return engine;
+}
+
+bool AutoInferenceEngine::initialize(const ModelConfig& config) {
+    engine_.reset();
+    selected_.clear();
+    decisionCached_ = false;
+    benchmark_.clear();
+
+    std::vector<std::string> backends = availableBackends();
+
+    // 查找缓存的选择结果
+    std::string key;
+    MappedModel model;
+    if (!config.cacheDirectory.empty() && model.open(config.modelPath, config.useMmap)) {
+        key = ModelCache::makeKey(model.hash(), DECISION_VERSION, decisionOptions(config, backends));
+        model.close();
+
+        std::string path = ModelCache(config.cacheDirectory).lookup(config.modelPath, key, DECISION_EXTENSION);
+        std::string backend;
+        if (!path.empty()) {
+            std::ifstream file(path);
+            std::getline(file, backend);
+        }
+        if (std::find(backends.begin(), backends.end(), backend) != backends.end()) {
+            engine_ = createBackend(backend, config);
+            if (engine_) {
+                selected_ = backend;
+                decisionCached_ = true;
+                LOG_INFO("Auto engine: using cached backend selection '", backend, "' for ", config.modelPath);
+                return true;
+            }
+            LOG_WARN("Auto engine: cached backend '", backend, "' failed to initialize, re-running benchmark");
+        }
+    }
+
+    if (!runBenchmark(config)) {
+        LOG_ERROR("Auto engine: no backend could run model ", config.modelPath);
+        return false;
+    }
+
+    if (!key.empty()) {
+        ModelCache cache(config.cacheDirectory);
+        cache.store(config.modelPath, key, reinterpret_cast<const uint8_t*>(selected_.data()), selected_.size(),
+                    DECISION_EXTENSION);
+    }
+    return true;
+}
+
+bool AutoInferenceEngine::runBenchmark(const ModelConfig& config) {
+    // 合成输入：固定种子的随机图像，经各后端自己的预处理得到模型输入
+    cv::Mat image(480, 640, CV_8UC3);
+    cv::RNG rng(12345);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+
+    std::vector<float> referenceOutput;
+    std::shared_ptr<InferenceEngine> best;
+    double bestMs = 0.0;
+
+    for (const auto& backend : availableBackends()) {
+        BenchmarkEntry entry;
+        entry.backend = backend;
+
+        auto loadStart = std::chrono::steady_clock::now();
+        auto engine = createBackend(backend, config);
+        entry.loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+        InferenceTensors tensors;
+        if (!engine || !engine->supportsStages() || !engine->preprocess(image, tensors)) {
+            benchmark_.push_back(entry);
+            continue;
+        }
+        entry.initialized = true;
+
+        std::vector<double> times;
+        std::vector<float> output;
+        bool ok = true;
+        for (int run = 0; run < WARMUP_RUNS + TIMED_RUNS && ok; run++) {
+            InferenceTensors runTensors = tensors;
+            auto startTime = std::chrono::steady_clock::now();
+            ok = engine->execute(runTensors);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            if (run >= WARMUP_RUNS) {
+                times.push_back(ms);
+            }
+            if (run == 0) {
+                output = std::move(runTensors.output);
+            }
+        }
+        if (!ok) {
+            entry.initialized = false;
+            benchmark_.push_back(entry);
+            continue;
+        }
+
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        entry.medianMs = times[times.size() / 2];
+
+        // 第一个可用的后端作为参考，其余后端输出必须与之一致
+        if (referenceOutput.empty()) {
+            referenceOutput = std::move(output);
+            entry.agrees = true;
+        } else {
+            entry.maxError = outputError(referenceOutput, output);
+            entry.agrees = entry.maxError <= OUTPUT_TOLERANCE;
+            if (!entry.agrees) {
+                LOG_WARN("Auto engine: backend '", backend, "' output differs from reference (error: ",
+                         entry.maxError, "), excluded");
+            }
+        }
+
+        if (entry.agrees && (!best || entry.medianMs < bestMs)) {
+            best = engine;
+            bestMs = entry.medianMs;
+            selected_ = backend;
+        }
+        benchmark_.push_back(entry);
+    }
+
+    for (const auto& entry : benchmark_) {
+        LOG_INFO("Auto engine: ", entry.backend, " - ",
+                 entry.initialized ? "load " + std::to_string(entry.loadMs) + " ms, run " +
+                                     std::to_string(entry.medianMs) + " ms" : "unavailable",
+                 entry.initialized && !entry.agrees ? " (output mismatch)" : "");
+    }
+
+    if (!best) {
+        return false;
+    }
+    engine_ = best;
+    LOG_INFO("Auto engine: selected backend '", selected_, "' (", bestMs, " ms)");
+    return true;
+}
+
+std::shared_ptr<InferenceResult> AutoInferenceEngine::infer(const cv::Mat& inputImage) {
+    return engine_ ? engine_->infer(inputImage) : nullptr;
+}
+
+std::string AutoInferenceEngine::getModelInfo() const {
+    std::ostringstream oss;
+    oss << "Auto Inference Engine (backend: " << (selected_.empty() ? "none" : selected_)
+        << (decisionCached_ ? ", cached" : "") << ")\n";
+    oss << std::fixed << std::setprecision(2);
+    for (const auto& entry : benchmark_) {
+        oss << "  " << entry.backend << ": ";
+        if (entry.initialized) {
+            oss << entry.medianMs << " ms" << (entry.agrees ? "" : " (output mismatch)") << "\n";
+        } else {
+            oss << "unavailable\n";
+        }
+    }
+    if (engine_) {
+        oss << engine_->getModelInfo();
+    }
+    return oss.str();
+}
+
+void AutoInferenceEngine::setThreshold(float threshold) {
+    if (engine_) {
+        engine_->setThreshold(threshold);
+    }
+}
+
+std::string AutoInferenceEngine::getModelType() const {
+    return engine_ ? engine_->getModelType() : "";
+}
+
+bool AutoInferenceEngine::supportsStages() const {
+    return engine_ && engine_->supportsStages();
+}
+
+bool AutoInferenceEngine::preprocess(const cv::Mat& inputImage, InferenceTensors& tensors) {
+    return engine_ && engine_->preprocess(inputImage, tensors);
+}
+
+bool AutoInferenceEngine::execute(InferenceTensors& tensors) {
+    return engine_ && engine_->execute(tensors);
+}
+
+std::shared_ptr<InferenceResult> AutoInferenceEngine::postprocess(InferenceTensors& tensors) {
+    return engine_ ? engine_->postprocess(tensors) : nullptr;
+}
+
+} // namespace inference
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "InferenceBase.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inference {
+
+/**
+ * @brief 自动选择推理后端的引擎（engineType = "auto"）
+ *
+ * 初始化时依次创建各可用后端（onnx、opencv），用合成图像经各自的预处理得到模型输入，
+ * 预热后计时多次执行模型，检查输出与参考后端（第一个初始化成功的后端）在容差内一致，
+ * 保留一致的后端中最快的一个，其余释放。
+ * 选择结果以模型哈希、后端版本与输入形状为键缓存在 cacheDirectory 中，再次加载时跳过测试。
+ * 所有接口转发给选中的后端。
+ */
+class AutoInferenceEngine : public InferenceEngine {
+public:
+    /**
+     * @brief 单个后端的测试结果
+     */
+    struct BenchmarkEntry {
+        std::string backend;
+        bool initialized = false;       ///< 是否初始化成功
+        bool agrees = false;            ///< 输出是否与参考后端一致
+        double loadMs = 0.0;            ///< 初始化耗时(毫秒)
+        double medianMs = 0.0;          ///< 模型执行耗时中位数(毫秒)
+        double maxError = 0.0;          ///< 与参考后端输出的最大相对误差
+    };
+
+    bool initialize(const ModelConfig& config) override;
+    std::shared_ptr<InferenceResult> infer(const cv::Mat& inputImage) override;
+    std::string getModelInfo() const override;
+    void setThreshold(float threshold) override;
+    bool isInitialized() const override { return engine_ && engine_->isInitialized(); }
+    std::string getModelType() const override;
+
+    bool supportsStages() const override;
+    bool preprocess(const cv::Mat& inputImage, InferenceTensors& tensors) override;
+    bool execute(InferenceTensors& tensors) override;
+    std::shared_ptr<InferenceResult> postprocess(InferenceTensors& tensors) override;
+
+    /**
+     * @brief 选中的后端名称
+     */
+    const std::string& getSelectedBackend() const { return selected_; }
+
+    /**
+     * @brief 选择结果是否来自缓存
+     */
+    bool isDecisionCached() const { return decisionCached_; }
+
+    /**
+     * @brief 最近一次测试的结果（命中缓存时为空）
+     */
+    const std::vector<BenchmarkEntry>& getBenchmark() const { return benchmark_; }
+
+    /**
+     * @brief 当前构建可用的后端
+     */
+    static std::vector<std::string> availableBackends();
+
+private:
+    /**
+     * @brief 测试所有可用后端并选出最快的
+     * @return 是否至少有一个后端可用
+     */
+    bool runBenchmark(const ModelConfig& config);
+
+    /**
+     * @brief 创建并初始化指定后端
+     */
+    std::shared_ptr<InferenceEngine> createBackend(const std::string& backend, const ModelConfig& config);
+
+    std::shared_ptr<InferenceEngine> engine_;
+    std::string selected_;
+    bool decisionCached_ = false;
+    std::vector<BenchmarkEntry> benchmark_;
+};
+
+} // namespace inference
@@ -0,0 +1,422 @@
+#include "DetectionPostprocess.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DETECTION_POSTPROCESS_SSE2 1
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define DETECTION_POSTPROCESS_NEON 1
+#endif
+
+namespace inference {
+
+namespace {
+
+constexpr float OVERLAP_EPS = 1e-9f;
+
+/**
+ * @brief 参考框（当前保留的框）
+ */
+struct RefBox {
+    float x1, y1, x2, y2, area;
+};
+
+inline float overlapScalar(const RefBox& r, float x1, float y1, float x2, float y2, float area, bool diou) {
+    float iw = std::max(0.0f, std::min(r.x2, x2) - std::max(r.x1, x1));
+    float ih = std::max(0.0f, std::min(r.y2, y2) - std::max(r.y1, y1));
+    float inter = iw * ih;
+    float iou = inter / std::max(r.area + area - inter, OVERLAP_EPS);
+    if (diou) {
+        float dx = (x1 + x2) - (r.x1 + r.x2);
+        float dy = (y1 + y2) - (r.y1 + r.y2);
+        float cw = std::max(r.x2, x2) - std::min(r.x1, x1);
+        float ch = std::max(r.y2, y2) - std::min(r.y1, y1);
+        iou -= 0.25f * (dx * dx + dy * dy) / std::max(cw * cw + ch * ch, OVERLAP_EPS);
+    }
+    return iou;
+}
+
+/**
+ * @brief 计算参考框与 count 个框的 IoU（diou 为 true 时计算 DIoU）
+ */
+void computeOverlap(const RefBox& r, const float* x1, const float* y1, const float* x2, const float* y2,
+                    const float* area, size_t count, bool diou, float* out) {
+    size_t i = 0;
+
+#if defined(DETECTION_POSTPROCESS_SSE2)
+    const __m128 rx1 = _mm_set1_ps(r.x1);
+    const __m128 ry1 = _mm_set1_ps(r.y1);
+    const __m128 rx2 = _mm_set1_ps(r.x2);
+    const __m128 ry2 = _mm_set1_ps(r.y2);
+    const __m128 rarea = _mm_set1_ps(r.area);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 eps = _mm_set1_ps(OVERLAP_EPS);
+    const __m128 rcx = _mm_add_ps(rx1, rx2);
+    const __m128 rcy = _mm_add_ps(ry1, ry2);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 bx1 = _mm_loadu_ps(x1 + i);
+        __m128 by1 = _mm_loadu_ps(y1 + i);
+        __m128 bx2 = _mm_loadu_ps(x2 + i);
+        __m128 by2 = _mm_loadu_ps(y2 + i);
+
+        __m128 iw = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(rx2, bx2), _mm_max_ps(rx1, bx1)));
+        __m128 ih = _mm_max_ps(zero, _mm_sub_ps(_mm_min_ps(ry2, by2), _mm_max_ps(ry1, by1)));
+        __m128 inter = _mm_mul_ps(iw, ih);
+        __m128 uni = _mm_sub_ps(_mm_add_ps(rarea, _mm_loadu_ps(area + i)), inter);
+        __m128 iou = _mm_div_ps(inter, _mm_max_ps(uni, eps));
+
+        if (diou) {
+            __m128 dx = _mm_sub_ps(_mm_add_ps(bx1, bx2), rcx);
+            __m128 dy = _mm_sub_ps(_mm_add_ps(by1, by2), rcy);
+            __m128 rho2 = _mm_mul_ps(quarter, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+            __m128 cw = _mm_sub_ps(_mm_max_ps(rx2, bx2), _mm_min_ps(rx1, bx1));
+            __m128 ch = _mm_sub_ps(_mm_max_ps(ry2, by2), _mm_min_ps(ry1, by1));
+            __m128 c2 = _mm_add_ps(_mm_mul_ps(cw, cw), _mm_mul_ps(ch, ch));
+            iou = _mm_sub_ps(iou, _mm_div_ps(rho2, _mm_max_ps(c2, eps)));
+        }
+        _mm_storeu_ps(out + i, iou);
+    }
+#elif defined(DETECTION_POSTPROCESS_NEON)
+    const float32x4_t rx1 = vdupq_n_f32(r.x1);
+    const float32x4_t ry1 = vdupq_n_f32(r.y1);
+    const float32x4_t rx2 = vdupq_n_f32(r.x2);
+    const float32x4_t ry2 = vdupq_n_f32(r.y2);
+    const float32x4_t rarea = vdupq_n_f32(r.area);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t eps = vdupq_n_f32(OVERLAP_EPS);
+    const float32x4_t rcx = vaddq_f32(rx1, rx2);
+    const float32x4_t rcy = vaddq_f32(ry1, ry2);
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t bx1 = vld1q_f32(x1 + i);
+        float32x4_t by1 = vld1q_f32(y1 + i);
+        float32x4_t bx2 = vld1q_f32(x2 + i);
+        float32x4_t by2 = vld1q_f32(y2 + i);
+
+        float32x4_t iw = vmaxq_f32(zero, vsubq_f32(vminq_f32(rx2, bx2), vmaxq_f32(rx1, bx1)));
+        float32x4_t ih = vmaxq_f32(zero, vsubq_f32(vminq_f32(ry2, by2), vmaxq_f32(ry1, by1)));
+        float32x4_t inter = vmulq_f32(iw, ih);
+        float32x4_t uni = vsubq_f32(vaddq_f32(rarea, vld1q_f32(area + i)), inter);
+        float32x4_t iou = vdivq_f32(inter, vmaxq_f32(uni, eps));
+
+        if (diou) {
+            float32x4_t dx = vsubq_f32(vaddq_f32(bx1, bx2), rcx);
+            float32x4_t dy = vsubq_f32(vaddq_f32(by1, by2), rcy);
+            float32x4_t rho2 = vmulq_n_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)), 0.25f);
+            float32x4_t cw = vsubq_f32(vmaxq_f32(rx2, bx2), vminq_f32(rx1, bx1));
+            float32x4_t ch = vsubq_f32(vmaxq_f32(ry2, by2), vminq_f32(ry1, by1));
+            float32x4_t c2 = vaddq_f32(vmulq_f32(cw, cw), vmulq_f32(ch, ch));
+            iou = vsubq_f32(iou, vdivq_f32(rho2, vmaxq_f32(c2, eps)));
+        }
+        vst1q_f32(out + i, iou);
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = overlapScalar(r, x1[i], y1[i], x2[i], y2[i], area[i], diou);
+    }
+}
+
+} // namespace
+
+// ==================== NMSOptions ====================
+
+NMSMethod NMSOptions::parseMethod(const std::string& name) {
+    if (name == "soft_linear") return NMSMethod::SOFT_LINEAR;
+    if (name == "soft_gaussian" || name == "soft") return NMSMethod::SOFT_GAUSSIAN;
+    if (name == "diou") return NMSMethod::DIOU;
+    return NMSMethod::HARD;
+}
+
+// ==================== DetectionCandidates ====================
+
+void DetectionCandidates::clear() {
+    x1.clear();
+    y1.clear();
+    x2.clear();
+    y2.clear();
+    score.clear();
+    classId.clear();
+}
+
+void DetectionCandidates::reserve(size_t count) {
+    x1.reserve(count);
+    y1.reserve(count);
+    x2.reserve(count);
+    y2.reserve(count);
+    score.reserve(count);
+    classId.reserve(count);
+}
+
+void DetectionCandidates::push(float bx1, float by1, float bx2, float by2, float s, int cls) {
+    x1.push_back(bx1);
+    y1.push_back(by1);
+    x2.push_back(bx2);
+    y2.push_back(by2);
+    score.push_back(s);
+    classId.push_back(cls);
+}
+
+// ==================== DetectionPostprocessor ====================
+
+int DetectionPostprocessor::argmax(const float* data, int count, float& maxValue) {
+    if (count <= 0) {
+        maxValue = 0.0f;
+        return -1;
+    }
+
+    int i = 0;
+    float best = data[0];
+
+#if defined(DETECTION_POSTPROCESS_SSE2)
+    if (count >= 4) {
+        __m128 vmax = _mm_loadu_ps(data);
+        for (i = 4; i + 4 <= count; i += 4) {
+            vmax = _mm_max_ps(vmax, _mm_loadu_ps(data + i));
+        }
+        vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+        vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+        best = _mm_cvtss_f32(vmax);
+    }
+#elif defined(DETECTION_POSTPROCESS_NEON)
+    if (count >= 4) {
+        float32x4_t vmax = vld1q_f32(data);
+        for (i = 4; i + 4 <= count; i += 4) {
+            vmax = vmaxq_f32(vmax, vld1q_f32(data + i));
+        }
+        best = vmaxvq_f32(vmax);
+    }
+#endif
+
+    for (; i < count; i++) {
+        best = std::max(best, data[i]);
+    }
+
+    // 第一个等于最大值的位置
+    maxValue = best;
+    for (int j = 0; j < count; j++) {
+        if (data[j] == best) {
+            return j;
+        }
+    }
+    return 0;  // 全部为 NaN
+}
+
+void DetectionPostprocessor::decodeYolo(const float* output, size_t numRows, int numClasses, float threshold,
+                                        float scaleX, float scaleY, DetectionCandidates& out) {
+    out.clear();
+    if (!output || numRows == 0 || numClasses <= 0) {
+        return;
+    }
+
+    const size_t stride = static_cast<size_t>(numClasses) + 5;
+    const float* objectness = output + 4;
+
+    // 第一步：objectness 过滤，无分支地压缩出通过阈值的行
+    // objectness 在行主序输出中按 stride 跨行存放，每个值位于不同的缓存行，
+    // 这一步受内存访问限制，逐个读取即可（打包成 SIMD 向量没有收益）
+    rows_.resize(numRows);
+    size_t count = 0;
+    for (size_t i = 0; i < numRows; i++) {
+        rows_[count] = static_cast<uint32_t>(i);
+        count += (objectness[i * stride] >= threshold) ? 1 : 0;
+    }
+
+    // 第二步：仅对通过的行计算类别 argmax
+    out.reserve(count);
+    for (size_t k = 0; k < count; k++) {
+        const float* row = output + static_cast<size_t>(rows_[k]) * stride;
+        const float obj = row[4];
+
+        float bestClassScore = 0.0f;
+        int bestClass = argmax(row + 5, numClasses, bestClassScore);
+        float score = bestClassScore * obj;
+        if (!(score > threshold)) {
+            continue;
+        }
+
+        float cx = row[0] * scaleX;
+        float cy = row[1] * scaleY;
+        float halfW = row[2] * scaleX * 0.5f;
+        float halfH = row[3] * scaleY * 0.5f;
+        out.push(cx - halfW, cy - halfH, cx + halfW, cy + halfH, score, bestClass);
+    }
+}
+
+const std::vector<int>& DetectionPostprocessor::nms(DetectionCandidates& candidates, const NMSOptions& options) {
+    keep_.clear();
+    const size_t n = candidates.size();
+    if (n == 0) {
+        return keep_;
+    }
+
+    // 类别感知时按 (类别, 分数降序) 排序，每个类别占据连续区间；否则只按分数排序
+    order_.resize(n);
+    std::iota(order_.begin(), order_.end(), 0);
+    const auto& score = candidates.score;
+    const auto& classId = candidates.classId;
+    if (options.classAware) {
+        std::stable_sort(order_.begin(), order_.end(), [&](int a, int b) {
+            return classId[a] != classId[b] ? classId[a] < classId[b] : score[a] > score[b];
+        });
+    } else {
+        std::stable_sort(order_.begin(), order_.end(), [&](int a, int b) { return score[a] > score[b]; });
+    }
+
+    // 按排序结果填充结构数组工作区
+    wx1_.resize(n);
+    wy1_.resize(n);
+    wx2_.resize(n);
+    wy2_.resize(n);
+    area_.resize(n);
+    wscore_.resize(n);
+    windex_.resize(n);
+    wclass_.resize(n);
+    overlap_.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        int idx = order_[i];
+        wx1_[i] = candidates.x1[idx];
+        wy1_[i] = candidates.y1[idx];
+        wx2_[i] = candidates.x2[idx];
+        wy2_[i] = candidates.y2[idx];
+        area_[i] = (wx2_[i] - wx1_[i]) * (wy2_[i] - wy1_[i]);
+        wscore_[i] = score[idx];
+        windex_[i] = idx;
+        wclass_[i] = classId[idx];
+    }
+
+    if (options.method == NMSMethod::SOFT_LINEAR || options.method == NMSMethod::SOFT_GAUSSIAN) {
+        softNms(candidates, options);
+    } else {
+        hardNms(options);
+    }
+
+    // 合并各类别结果，按最终分数降序输出
+    std::stable_sort(keep_.begin(), keep_.end(), [&](int a, int b) { return score[a] > score[b]; });
+    if (options.maxDetections > 0 && keep_.size() > static_cast<size_t>(options.maxDetections)) {
+        keep_.resize(static_cast<size_t>(options.maxDetections));
+    }
+    return keep_;
+}
+
+size_t DetectionPostprocessor::segmentEnd(size_t begin, const NMSOptions& options) const {
+    const size_t n = windex_.size();
+    if (!options.classAware) {
+        return n;
+    }
+    size_t end = begin + 1;
+    while (end < n && wclass_[end] == wclass_[begin]) {
+        end++;
+    }
+    return end;
+}
+
+void DetectionPostprocessor::hardNms(const NMSOptions& options) {
+    const size_t n = windex_.size();
+    const bool diou = options.method == NMSMethod::DIOU;
+
+    // 每个类别区间内按分数降序排列
+    for (size_t begin = 0; begin < n;) {
+        const size_t end = segmentEnd(begin, options);
+
+        size_t head = begin;
+        size_t remaining = end - begin;
+        while (remaining > 0) {
+            keep_.push_back(windex_[head]);
+
+            // 当前框与区间内剩余框的重叠度
+            const RefBox ref{wx1_[head], wy1_[head], wx2_[head], wy2_[head], area_[head]};
+            const size_t first = head + 1;
+            const size_t rest = remaining - 1;
+            computeOverlap(ref, &wx1_[first], &wy1_[first], &wx2_[first], &wy2_[first], &area_[first],
+                           rest, diou, overlap_.data());
+
+            // 原地压缩未被抑制的框（无分支）
+            size_t write = first;
+            for (size_t j = 0; j < rest; j++) {
+                const size_t read = first + j;
+                wx1_[write] = wx1_[read];
+                wy1_[write] = wy1_[read];
+                wx2_[write] = wx2_[read];
+                wy2_[write] = wy2_[read];
+                area_[write] = area_[read];
+                windex_[write] = windex_[read];
+                write += (overlap_[j] <= options.iouThreshold) ? 1 : 0;
+            }
+
+            head = first;
+            remaining = write - first;
+        }
+
+        begin = end;
+    }
+}
+
+void DetectionPostprocessor::softNms(DetectionCandidates& candidates, const NMSOptions& options) {
+    const size_t n = windex_.size();
+    const bool gaussian = options.method == NMSMethod::SOFT_GAUSSIAN;
+    const float invSigma = 1.0f / std::max(options.sigma, OVERLAP_EPS);
+
+    for (size_t begin = 0; begin < n;) {
+        const size_t end = segmentEnd(begin, options);
+
+        size_t head = begin;
+        size_t remaining = end - begin;
+        while (remaining > 0) {
+            // 衰减后顺序会变化，每轮取剩余框中分数最高的放到 head
+            size_t best = head + static_cast<size_t>(
+                std::max_element(wscore_.begin() + head, wscore_.begin() + head + remaining) - (wscore_.begin() + head));
+            if (best != head) {
+                std::swap(wx1_[head], wx1_[best]);
+                std::swap(wy1_[head], wy1_[best]);
+                std::swap(wx2_[head], wx2_[best]);
+                std::swap(wy2_[head], wy2_[best]);
+                std::swap(area_[head], area_[best]);
+                std::swap(wscore_[head], wscore_[best]);
+                std::swap(windex_[head], windex_[best]);
+            }
+
+            keep_.push_back(windex_[head]);
+            candidates.score[windex_[head]] = wscore_[head];
+
+            const RefBox ref{wx1_[head], wy1_[head], wx2_[head], wy2_[head], area_[head]};
+            const size_t first = head + 1;
+            const size_t rest = remaining - 1;
+            computeOverlap(ref, &wx1_[first], &wy1_[first], &wx2_[first], &wy2_[first], &area_[first],
+                           rest, false, overlap_.data());
+
+            // 衰减分数，删除低于 minScore 的框
+            size_t write = first;
+            for (size_t j = 0; j < rest; j++) {
+                const size_t read = first + j;
+                const float iou = overlap_[j];
+                float decay;
+                if (gaussian) {
+                    decay = std::exp(-(iou * iou) * invSigma);
+                } else {
+                    decay = iou > options.iouThreshold ? 1.0f - iou : 1.0f;
+                }
+                wx1_[write] = wx1_[read];
+                wy1_[write] = wy1_[read];
+                wx2_[write] = wx2_[read];
+                wy2_[write] = wy2_[read];
+                area_[write] = area_[read];
+                windex_[write] = windex_[read];
+                wscore_[write] = wscore_[read] * decay;
+                write += (wscore_[write] >= options.minScore) ? 1 : 0;
+            }
+
+            head = first;
+            remaining = write - first;
+        }
+
+        begin = end;
+    }
+}
+
+} // namespace inference
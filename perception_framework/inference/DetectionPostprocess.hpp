@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inference {
+
+/**
+ * @brief NMS 方法
+ */
+enum class NMSMethod {
+    HARD,           ///< 标准 NMS：IoU 超过阈值的框被删除
+    SOFT_LINEAR,    ///< Soft-NMS（线性衰减）：score *= (1 - IoU)
+    SOFT_GAUSSIAN,  ///< Soft-NMS（高斯衰减）：score *= exp(-IoU^2 / sigma)
+    DIOU            ///< DIoU-NMS：IoU 减去中心距离惩罚项后与阈值比较
+};
+
+/**
+ * @brief NMS 参数
+ */
+struct NMSOptions {
+    NMSMethod method = NMSMethod::HARD;
+    float iouThreshold = 0.5f;      ///< IoU（或 DIoU）阈值
+    float sigma = 0.5f;             ///< 高斯 Soft-NMS 衰减参数
+    float minScore = 0.001f;        ///< Soft-NMS 衰减后低于该分数的框被删除
+    bool classAware = true;         ///< 只在同类别的框之间抑制
+    int maxDetections = 0;          ///< 最大输出框数（0 表示不限制）
+
+    /**
+     * @brief 解析方法名称: "hard", "soft_linear", "soft_gaussian", "diou"
+     * @return 无法识别时返回 HARD
+     */
+    static NMSMethod parseMethod(const std::string& name);
+};
+
+/**
+ * @brief 检测候选框（结构数组布局，便于 SIMD 计算 IoU）
+ * 坐标为左上角/右下角 (x1, y1, x2, y2)
+ */
+struct DetectionCandidates {
+    std::vector<float> x1, y1, x2, y2;
+    std::vector<float> score;
+    std::vector<int> classId;
+
+    size_t size() const { return score.size(); }
+    void clear();
+    void reserve(size_t count);
+    void push(float bx1, float by1, float bx2, float by2, float s, int cls);
+};
+
+/**
+ * @brief 检测后处理：YOLO 输出解码 + NMS
+ *
+ * 解码分两步：
+ *  1. 逐行读取 objectness（行主序输出中跨行存放），无分支地压缩出通过阈值的行索引
+ *  2. 仅对通过的行计算类别 argmax（SIMD 求最大值），不限制候选框数量
+ * NMS 在结构数组上进行，每保留一个框后用 SIMD 计算其与剩余框的 IoU/DIoU 并压缩剩余框；
+ * 类别感知时按 (类别, 分数) 排序，每个类别占据连续区间，一次调用批量处理所有类别。
+ *
+ * 内部缓冲在多次调用间复用，实例不是线程安全的。
+ */
+class DetectionPostprocessor {
+public:
+    /**
+     * @brief 解码 YOLO 格式输出（每行: cx, cy, w, h, objectness, 类别分数...）
+     * @param output 模型输出
+     * @param numRows 候选框数量
+     * @param numClasses 类别数
+     * @param threshold 置信度阈值（objectness 与 objectness*类别分数 均需达到）
+     * @param scaleX 横坐标缩放（如原图宽度，输出为归一化坐标时）
+     * @param scaleY 纵坐标缩放
+     * @param out 输出候选框（会先清空）
+     */
+    void decodeYolo(const float* output, size_t numRows, int numClasses, float threshold,
+                    float scaleX, float scaleY, DetectionCandidates& out);
+
+    /**
+     * @brief 非极大值抑制
+     * Soft-NMS 会将衰减后的分数写回 candidates.score
+     * @param candidates 候选框
+     * @param options NMS 参数
+     * @return 保留的候选框索引（按分数从高到低）
+     */
+    const std::vector<int>& nms(DetectionCandidates& candidates, const NMSOptions& options);
+
+    /**
+     * @brief 求 data[0..count) 的最大值索引（相同最大值取第一个）
+     */
+    static int argmax(const float* data, int count, float& maxValue);
+
+private:
+    size_t segmentEnd(size_t begin, const NMSOptions& options) const;
+    void hardNms(const NMSOptions& options);
+    void softNms(DetectionCandidates& candidates, const NMSOptions& options);
+
+    // 复用的中间缓冲
+    std::vector<uint32_t> rows_;                        ///< objectness 通过的行
+    std::vector<int> order_;                            ///< 按 (类别, 分数) 排序的索引
+    std::vector<float> wx1_, wy1_, wx2_, wy2_, area_;   ///< 工作区（按排序结果排列）
+    std::vector<float> wscore_;
+    std::vector<int> windex_;                           ///< 工作区对应的候选框索引
+    std::vector<int> wclass_;
+    std::vector<float> overlap_;                        ///< 与当前框的 IoU/DIoU
+    std::vector<int> keep_;
+};
+
+} // namespace inference
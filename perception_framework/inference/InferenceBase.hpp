@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -8,6 +9,16 @@
 
 namespace inference {
 
+/**
+ * @brief 推理输入帧的来源信息（由 InferenceManager 在推理完成后填入结果）
+ */
+struct FrameInfo {
+    uint64_t frameIndex = 0;        // 设备帧号
+    uint64_t deviceTimestampUs = 0; // 设备时间戳(微秒)
+    int64_t captureTimeUs = 0;      // 帧到达的时刻（steady_clock，微秒），0 表示未知
+    bool preprocessed = false;      // 推理图像经过帧预处理（去畸变），结果坐标不是原始帧坐标
+};
+
 /**
  * @brief 推理结果的基类
  */
@@ -15,6 +26,12 @@ class InferenceResult {
 public:
     virtual ~InferenceResult() = default;
     
+    /**
+     * @brief 输入帧的来源信息
+     */
+    const FrameInfo& getFrameInfo() const { return frameInfo_; }
+    void setFrameInfo(const FrameInfo& info) { frameInfo_ = info; }
+    
     /**
      * @brief 获取推理执行时间
      * @return 推理时间(毫秒)
@@ -32,6 +49,9 @@ public:
      * @return 结果摘要字符串
      */
     virtual std::string getSummary() const = 0;
+
+private:
+    FrameInfo frameInfo_;
 };
 
 /**
@@ -40,18 +60,35 @@ public:
 struct ModelConfig {
     std::string modelPath;              // 模型文件路径
     std::string modelType;              // 模型类型: "classification", "detection", "segmentation"
-    std::string engineType = "onnx";    // 推理引擎类型
+    std::string engineType = "onnx";    // 推理引擎类型: "onnx", "opencv", "auto"
     std::vector<std::string> classNames; // 类别名称
     float confidenceThreshold = 0.5f;   // 置信度阈值
+    float nmsThreshold = 0.5f;          // NMS IoU阈值
+    std::string nmsMethod = "hard";     // NMS方法: "hard", "soft_linear", "soft_gaussian", "diou"
+    float softNmsSigma = 0.5f;          // 高斯Soft-NMS参数
+    bool classAwareNMS = true;          // 只在同类别框之间抑制
+    int maxDetections = 0;              // 最大检测框数 (0为不限制)
     std::vector<int64_t> inputShape;    // 输入形状 (可选)
     std::vector<std::string> inputNames; // 输入名称 (可选)
     std::vector<std::string> outputNames; // 输出名称 (可选)
+    std::string cacheDirectory;         // 优化模型缓存目录 (为空不缓存)
+    bool useMmap = true;                // 以内存映射方式加载模型文件
     
     bool isValid() const {
         return !modelPath.empty() && !modelType.empty() && !engineType.empty();
     }
 };
 
+/**
+ * @brief 推理各阶段（预处理/模型执行/后处理）之间传递的数据
+ */
+struct InferenceTensors {
+    cv::Size imageSize;                 // 原始图像大小
+    std::vector<float> input;           // 预处理后的模型输入
+    std::vector<float> output;          // 模型输出
+    double processingTime = 0.0;        // 已完成阶段的累计耗时(毫秒)
+};
+
 /**
  * @brief 推理引擎的基类
  */
@@ -96,6 +133,35 @@ public:
      * @return 模型类型
      */
     virtual std::string getModelType() const = 0;
+
+    /**
+     * @brief 是否支持分阶段执行（供 InferencePipeline 使用）
+     * 支持时 preprocess/execute/postprocess 可以在不同线程上对不同帧并发调用，
+     * 同一帧的三个阶段依次调用，结果与 infer 相同
+     */
+    virtual bool supportsStages() const { return false; }
+
+    /**
+     * @brief 预处理阶段
+     * @param inputImage 输入图像
+     * @param tensors 输出：模型输入
+     * @return 是否成功
+     */
+    virtual bool preprocess(const cv::Mat& /*inputImage*/, InferenceTensors& /*tensors*/) { return false; }
+
+    /**
+     * @brief 模型执行阶段
+     * @param tensors 输入/输出张量
+     * @return 是否成功
+     */
+    virtual bool execute(InferenceTensors& /*tensors*/) { return false; }
+
+    /**
+     * @brief 后处理阶段
+     * @param tensors 模型输出
+     * @return 推理结果
+     */
+    virtual std::shared_ptr<InferenceResult> postprocess(InferenceTensors& /*tensors*/) { return nullptr; }
 };
 
 /**
@@ -105,7 +171,7 @@ class InferenceEngineFactory {
 public:
     /**
      * @brief 创建推理引擎
-     * @param engineType 引擎类型 ("onnx", "tensorrt", 等)
+     * @param engineType 引擎类型 ("onnx", "opencv", "auto"(加载时测试并选择最快的后端))
      * @return 推理引擎指针
      */
     static std::shared_ptr<InferenceEngine> createEngine(const std::string& engineType);
@@ -1,14 +1,30 @@
 #include "InferenceManager.hpp"
 #include "ONNXInference.hpp"
+#include "TiledInference.hpp"
 #include "CVWindow.hpp"
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <thread>
 #include <iomanip>
+#include <filesystem>
 
 namespace inference {
 
+namespace {
+
+InferenceRateController::Options rateOptionsFrom(const InferenceConfig& config) {
+    InferenceRateController::Options options;
+    options.mode = InferenceRateController::parseMode(config.rateControlMode);
+    options.minInterval = config.inferenceInterval;
+    options.maxInterval = config.maxInferenceInterval;
+    options.targetLatencyMs = config.targetLatencyMs;
+    options.targetCpuShare = config.targetCpuShare;
+    return options;
+}
+
+} // namespace
+
 InferenceManager& InferenceManager::getInstance() {
     static InferenceManager instance;
     return instance;
@@ -36,11 +52,25 @@ bool InferenceManager::initialize(const InferenceConfig& config) {
     // 初始化统计
     stats_.startTime = std::chrono::steady_clock::now();
     
+    // 推理频率控制
+    rateController_.configure(rateOptionsFrom(config_));
+    performanceStats_ = config_.enablePerformanceStats;
+    liveConfig_ = config_;
+    
+    // 之后发布的配置快照中可热加载的设置在 processFrame 中同步
+    configVersion_ = ConfigHelper::getInstance().version();
+    
     // 启动异步推理工作线程
     if (config_.asyncInference) {
         shouldStop_ = false;
         asyncWorker_ = std::thread(&InferenceManager::asyncInferenceWorker, this);
         LOG_INFO("Async inference worker thread started");
+        
+        // 三级流水线：预处理/模型执行/后处理在不同线程上重叠执行，每个模型只保留最新的一帧输入
+        if (config_.enablePipeline) {
+            pipeline_ = std::make_unique<InferencePipeline>(static_cast<size_t>(config_.pipelineQueueSize), true);
+            pipeline_->start();
+        }
     }
     
     // 加载默认模型
@@ -48,7 +78,13 @@ bool InferenceManager::initialize(const InferenceConfig& config) {
         ModelConfig modelConfig;
         modelConfig.modelPath = config_.defaultModel;
         modelConfig.modelType = config_.defaultModelType;
+        modelConfig.engineType = config_.defaultEngineType;
         modelConfig.confidenceThreshold = config_.defaultThreshold;
+        modelConfig.nmsThreshold = config_.nmsThreshold;
+        modelConfig.nmsMethod = config_.nmsMethod;
+        modelConfig.softNmsSigma = config_.softNmsSigma;
+        modelConfig.classAwareNMS = config_.classAwareNMS;
+        modelConfig.maxDetections = config_.maxDetections;
         
         // 加载类别名称
         if (!config_.classNamesFile.empty()) {
@@ -68,30 +104,50 @@ bool InferenceManager::initialize(const InferenceConfig& config) {
 }
 
 bool InferenceManager::loadModel(const std::string& modelName, const ModelConfig& modelConfig) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     if (!modelConfig.isValid()) {
         LOG_ERROR("Invalid model configuration for: ", modelName);
         return false;
     }
     
-    // 创建推理引擎
-    auto engine = InferenceEngineFactory::createEngine(modelConfig.engineType);
+    // 模型加载策略来自全局配置（调用方未指定缓存目录时使用模型目录下的缓存）
+    ModelConfig engineConfig = modelConfig;
+    engineConfig.useMmap = config_.useMmapModels;
+    if (engineConfig.cacheDirectory.empty() && config_.enableModelCache) {
+        engineConfig.cacheDirectory = (std::filesystem::path(config_.modelsDirectory) / ".cache").string();
+    }
+    
+    // 创建推理引擎（检测模型启用分块时由分块引擎持有多个副本并行推理）
+    std::shared_ptr<InferenceEngine> engine;
+    if (config_.enableTiling && engineConfig.modelType == "detection") {
+        TiledInferenceEngine::Options tileOptions;
+        tileOptions.tileSize = cv::Size(config_.tileSize, config_.tileSize);
+        tileOptions.overlap = config_.tileOverlap;
+        tileOptions.fullFrame = config_.tileFullFrame;
+        tileOptions.workers = config_.tileWorkers;
+        engine = std::make_shared<TiledInferenceEngine>(tileOptions);
+    } else {
+        engine = InferenceEngineFactory::createEngine(engineConfig.engineType);
+    }
     if (!engine) {
         LOG_ERROR("Failed to create inference engine for: ", modelName);
         return false;
     }
     
-    // 初始化引擎
-    if (!engine->initialize(modelConfig)) {
+    // 初始化引擎（图优化与权重加载可能耗时较长，不持有锁，其他模型的推理不受影响）
+    auto startTime = std::chrono::steady_clock::now();
+    if (!engine->initialize(engineConfig)) {
         LOG_ERROR("Failed to initialize inference engine for: ", modelName);
         return false;
     }
+    double loadTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
     
     // 存储引擎
-    engines_[modelName] = engine;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        engines_[modelName] = engine;
+    }
     
-    LOG_INFO("Model loaded successfully: ", modelName, " (", modelConfig.modelType, ")");
+    LOG_INFO("Model loaded successfully: ", modelName, " (", engineConfig.modelType, ") in ", loadTimeMs, " ms");
     return true;
 }
 
@@ -111,6 +167,12 @@ bool InferenceManager::unloadModel(const std::string& modelName) {
 
 std::shared_ptr<InferenceResult> InferenceManager::runInference(const std::string& modelName, 
                                                                const cv::Mat& inputImage) {
+    return executeInference(modelName, inputImage, std::chrono::steady_clock::now());
+}
+
+std::shared_ptr<InferenceResult> InferenceManager::executeInference(const std::string& modelName,
+                                                                   const cv::Mat& inputImage,
+                                                                   std::chrono::steady_clock::time_point submitTime) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     auto it = engines_.find(modelName);
@@ -129,24 +191,11 @@ std::shared_ptr<InferenceResult> InferenceManager::runInference(const std::strin
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
         double inferenceTimeMs = duration.count() / 1000.0;
         
-        // 更新统计 - 使用fetch_add来处理原子变量
-        stats_.totalInferences.fetch_add(1);
-        if (result && result->isValid()) {
-            stats_.successfulInferences.fetch_add(1);
-        } else {
-            stats_.failedInferences.fetch_add(1);
-        }
-        
-        // 原子变量不能直接用+=，需要先获取当前值再设置
-        double currentTotal = stats_.totalInferenceTime.load();
-        stats_.totalInferenceTime.store(currentTotal + inferenceTimeMs);
-        
-        uint64_t totalCount = stats_.totalInferences.load();
-        if (totalCount > 0) {
-            stats_.avgInferenceTime.store(stats_.totalInferenceTime.load() / totalCount);
-        }
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - submitTime);
+        recordInference(result && result->isValid(), inferenceTimeMs, latency.count() / 1000.0);
         
-        if (config_.enablePerformanceStats) {
+        if (performanceStats_) {
             LOG_DEBUG("Inference completed for ", modelName, " in ", inferenceTimeMs, " ms");
         }
         
@@ -158,20 +207,78 @@ std::shared_ptr<InferenceResult> InferenceManager::runInference(const std::strin
     }
 }
 
+void InferenceManager::recordInference(bool success, double inferenceTimeMs, double latencyMs) {
+    // 更新统计 - 使用fetch_add来处理原子变量
+    stats_.totalInferences.fetch_add(1);
+    if (success) {
+        stats_.successfulInferences.fetch_add(1);
+    } else {
+        stats_.failedInferences.fetch_add(1);
+    }
+    
+    // 原子变量不能直接用+=，使用CAS累加（流水线后处理线程与同步推理可能同时更新）
+    double currentTotal = stats_.totalInferenceTime.load();
+    while (!stats_.totalInferenceTime.compare_exchange_weak(currentTotal, currentTotal + inferenceTimeMs)) {
+    }
+    
+    uint64_t totalCount = stats_.totalInferences.load();
+    if (totalCount > 0) {
+        stats_.avgInferenceTime.store(stats_.totalInferenceTime.load() / totalCount);
+    }
+    
+    if (success) {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        rateController_.recordInference(inferenceTimeMs, latencyMs,
+            std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+    }
+}
+
 bool InferenceManager::runInferenceAsync(const std::string& modelName, 
                                         const cv::Mat& inputImage, 
-                                        InferenceCallback callback) {
+                                        InferenceCallback callback,
+                                        const FrameInfo& frameInfo) {
     if (!config_.asyncInference) {
         LOG_ERROR("Async inference is disabled");
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    
-    if (asyncQueue_.size() >= static_cast<size_t>(config_.maxQueueSize)) {
-        LOG_WARN("Async inference queue is full, dropping frame");
-        stats_.framesSkipped.fetch_add(1);
-        return false;
+    // 引擎支持分阶段执行时走流水线，否则回退到单线程异步队列
+    if (pipeline_) {
+        std::shared_ptr<InferenceEngine> engine;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = engines_.find(modelName);
+            if (it != engines_.end()) {
+                engine = it->second;
+            }
+        }
+        
+        if (engine && engine->supportsStages()) {
+            InferenceCallback resultCallback = callback ? callback : globalCallback_;
+            auto completion = [this, resultCallback, frameInfo](const std::string& name, const cv::Mat& image,
+                                                                std::shared_ptr<InferenceResult> result,
+                                                                double latencyMs) {
+                bool success = result && result->isValid();
+                if (result) {
+                    result->setFrameInfo(frameInfo);
+                }
+                recordInference(success, success ? result->getInferenceTime() : latencyMs, latencyMs);
+                if (performanceStats_) {
+                    LOG_DEBUG("Pipelined inference completed for ", name, " in ", latencyMs, " ms");
+                }
+                if (resultCallback) {
+                    resultCallback(name, image, result);
+                }
+            };
+            
+            // 流水线输入槽位只保留最新帧，被覆盖的帧计入流水线统计
+            if (!pipeline_->submit(modelName, engine, inputImage.clone(), completion)) {
+                LOG_WARN("Inference pipeline is not running, dropping frame");
+                stats_.framesSkipped.fetch_add(1);
+                return false;
+            }
+            return true;
+        }
     }
     
     AsyncTask task;
@@ -179,8 +286,26 @@ bool InferenceManager::runInferenceAsync(const std::string& modelName,
     task.image = inputImage.clone();
     task.callback = callback ? callback : globalCallback_;
     task.submitTime = std::chrono::steady_clock::now();
+    task.frameInfo = frameInfo;
+    
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    
+    // 每个模型只保留最新的一帧：工作线程忙时覆盖尚未开始的旧帧
+    auto it = pendingTasks_.find(modelName);
+    if (it != pendingTasks_.end()) {
+        it->second = std::move(task);
+        stats_.framesSkipped.fetch_add(1);
+        return true;
+    }
+    
+    if (pendingTasks_.size() >= static_cast<size_t>(config_.maxQueueSize)) {
+        LOG_WARN("Async inference queue is full, dropping frame");
+        stats_.framesSkipped.fetch_add(1);
+        return false;
+    }
     
-    asyncQueue_.push(task);
+    pendingTasks_.emplace(modelName, std::move(task));
+    pendingOrder_.push_back(modelName);
     queueCondition_.notify_one();
     
     return true;
@@ -196,14 +321,28 @@ bool InferenceManager::processFrame(std::shared_ptr<ob::Frame> frame, OBFrameTyp
         return false;
     }
     
-    // 检查处理间隔
-    frameCounter_++;
-    if (frameCounter_ % config_.inferenceInterval != 0) {
+    // 配置热加载后同步推理间隔、阈值等设置（只有一个线程执行）
+    auto snapshot = ConfigHelper::getInstance().current();
+    uint64_t appliedVersion = configVersion_.load(std::memory_order_relaxed);
+    if (snapshot->version != appliedVersion &&
+        configVersion_.compare_exchange_strong(appliedVersion, snapshot->version)) {
+        applyLiveConfig(snapshot->inferenceConfig);
+    }
+    
+    // 由频率控制器决定是否推理该帧（固定间隔或按延迟/CPU预算自适应）
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    if (!rateController_.shouldRun(nowUs)) {
         return false;
     }
     
-    // 转换帧为Mat
-    cv::Mat image = convertFrameToMat(frame);
+    FrameInfo frameInfo;
+    frameInfo.frameIndex = frame->getIndex();
+    frameInfo.deviceTimestampUs = frame->getTimeStampUs();
+    frameInfo.captureTimeUs = nowUs;
+    
+    // 转换帧为Mat（并执行去畸变等帧预处理）
+    cv::Mat image = prepareFrame(frame, &frameInfo.preprocessed);
     if (image.empty()) {
         LOG_ERROR("Failed to convert frame to Mat");
         return false;
@@ -225,9 +364,12 @@ bool InferenceManager::processFrame(std::shared_ptr<ob::Frame> frame, OBFrameTyp
     
     // 执行推理
     if (config_.asyncInference) {
-        return runInferenceAsync(modelName, image, globalCallback_);
+        return runInferenceAsync(modelName, image, globalCallback_, frameInfo);
     } else {
         auto result = runInference(modelName, image);
+        if (result) {
+            result->setFrameInfo(frameInfo);
+        }
         if (result && globalCallback_) {
             globalCallback_(modelName, image, result);
         }
@@ -235,6 +377,36 @@ bool InferenceManager::processFrame(std::shared_ptr<ob::Frame> frame, OBFrameTyp
     }
 }
 
+void InferenceManager::setFramePreprocessor(FramePreprocessor preprocessor) {
+    std::lock_guard<std::mutex> lock(preprocessorMutex_);
+    framePreprocessor_ = std::move(preprocessor);
+}
+
+cv::Mat InferenceManager::prepareFrame(std::shared_ptr<ob::Frame> frame, bool* preprocessed) {
+    if (preprocessed) {
+        *preprocessed = false;
+    }
+    cv::Mat image = convertFrameToMat(frame);
+    if (image.empty() || !config_.enableFramePreprocessing) {
+        return image;
+    }
+    
+    FramePreprocessor preprocessor;
+    {
+        std::lock_guard<std::mutex> lock(preprocessorMutex_);
+        preprocessor = framePreprocessor_;
+    }
+    
+    cv::Mat processed;
+    if (preprocessor && preprocessor(image, processed)) {
+        if (preprocessed) {
+            *preprocessed = true;
+        }
+        return processed;
+    }
+    return image;
+}
+
 cv::Mat InferenceManager::convertFrameToMat(std::shared_ptr<ob::Frame> frame) {
     if (!frame) {
         return cv::Mat();
@@ -296,24 +468,33 @@ void InferenceManager::asyncInferenceWorker() {
         
         // 等待任务或停止信号
         queueCondition_.wait(lock, [this] { 
-            return !asyncQueue_.empty() || shouldStop_; 
+            return !pendingOrder_.empty() || shouldStop_; 
         });
         
         if (shouldStop_) {
             break;
         }
         
-        if (asyncQueue_.empty()) {
+        if (pendingOrder_.empty()) {
             continue;
         }
         
-        // 获取任务
-        AsyncTask task = asyncQueue_.front();
-        asyncQueue_.pop();
+        // 获取任务（该模型的最新帧）
+        std::string modelName = pendingOrder_.front();
+        pendingOrder_.pop_front();
+        auto it = pendingTasks_.find(modelName);
+        if (it == pendingTasks_.end()) {
+            continue;
+        }
+        AsyncTask task = std::move(it->second);
+        pendingTasks_.erase(it);
         lock.unlock();
         
         // 执行推理
-        auto result = runInference(task.modelName, task.image);
+        auto result = executeInference(task.modelName, task.image, task.submitTime);
+        if (result) {
+            result->setFrameInfo(task.frameInfo);
+        }
         
         // 调用回调
         if (task.callback) {
@@ -364,6 +545,35 @@ bool InferenceManager::setModelThreshold(const std::string& modelName, float thr
     return true;
 }
 
+void InferenceManager::applyLiveConfig(const InferenceConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    performanceStats_ = config.enablePerformanceStats;
+    
+    // 其他配置段的修改也会发布新快照，推理设置没变时保留频率控制器的测量状态
+    bool rateChanged = config.rateControlMode != liveConfig_.rateControlMode ||
+                       config.inferenceInterval != liveConfig_.inferenceInterval ||
+                       config.maxInferenceInterval != liveConfig_.maxInferenceInterval ||
+                       config.targetLatencyMs != liveConfig_.targetLatencyMs ||
+                       config.targetCpuShare != liveConfig_.targetCpuShare;
+    bool thresholdChanged = config.defaultThreshold != liveConfig_.defaultThreshold;
+    if (!rateChanged && !thresholdChanged) {
+        return;
+    }
+    
+    if (rateChanged) {
+        rateController_.configure(rateOptionsFrom(config));
+    }
+    auto it = engines_.find("default");
+    if (thresholdChanged && it != engines_.end()) {
+        it->second->setThreshold(config.defaultThreshold);
+    }
+    liveConfig_ = config;
+    
+    LOG_INFO("Inference settings updated: rate control ", config.rateControlMode,
+             ", interval ", config.inferenceInterval, "-", config.maxInferenceInterval,
+             ", threshold ", config.defaultThreshold);
+}
+
 void InferenceManager::setInferenceCallback(InferenceCallback callback) {
     globalCallback_ = callback;
 }
@@ -375,7 +585,10 @@ std::string InferenceManager::getStatistics() const {
     oss << "Successful: " << stats_.successfulInferences.load() << "\n";
     oss << "Failed: " << stats_.failedInferences.load() << "\n";
     oss << "Frames Processed: " << stats_.framesProcessed.load() << "\n";
-    oss << "Frames Skipped: " << stats_.framesSkipped.load() << "\n";
+    auto rateStats = rateController_.getStats();
+    uint64_t overloadSkipped = stats_.framesSkipped.load() + (pipeline_ ? pipeline_->getFramesReplaced() : 0);
+    oss << "Frames Skipped (rate control): " << rateStats.framesSkipped << "\n";
+    oss << "Frames Skipped (overload): " << overloadSkipped << "\n";
     oss << "Average Inference Time: " << std::fixed << std::setprecision(2) 
         << stats_.avgInferenceTime.load() << " ms\n";
     
@@ -388,6 +601,15 @@ std::string InferenceManager::getStatistics() const {
         oss << "Inference Rate: " << std::fixed << std::setprecision(2) << inferenceRate << " inferences/sec\n";
     }
     
+    oss << "Rate Control: " << config_.rateControlMode << ", interval " << rateStats.interval
+        << ", effective " << std::fixed << std::setprecision(2) << rateStats.effectiveRate << " inferences/sec"
+        << ", inference " << rateStats.inferenceMs << " ms, latency " << rateStats.latencyMs << " ms"
+        << ", frame period " << rateStats.framePeriodMs << " ms\n";
+    
+    if (pipeline_) {
+        oss << pipeline_->getStatistics();
+    }
+    
     oss << "============================";
     return oss.str();
 }
@@ -401,6 +623,10 @@ void InferenceManager::resetStatistics() {
     stats_.framesProcessed = 0;
     stats_.framesSkipped = 0;
     stats_.startTime = std::chrono::steady_clock::now();
+    rateController_.resetStats();
+    if (pipeline_) {
+        pipeline_->resetStatistics();
+    }
     
     LOG_INFO("Inference statistics reset");
 }
@@ -412,6 +638,12 @@ void InferenceManager::stop() {
     
     shouldStop_ = true;
     
+    // 停止流水线（在途帧持有引擎引用，需在清理引擎前结束）
+    if (pipeline_) {
+        pipeline_->stop();
+        pipeline_.reset();
+    }
+    
     // 通知异步工作线程停止
     if (asyncWorker_.joinable()) {
         queueCondition_.notify_all();
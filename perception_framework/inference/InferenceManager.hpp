@@ -5,7 +5,7 @@
 #include <vector>
 #include <map>
 #include <functional>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
@@ -14,6 +14,8 @@
 #include <opencv2/opencv.hpp>
 #include "libobsensor/ObSensor.hpp"
 #include "InferenceBase.hpp"
+#include "InferencePipeline.hpp"
+#include "InferenceRateController.hpp"
 #include "Logger.hpp"
 #include "ConfigHelper.hpp"
 
@@ -29,6 +31,12 @@ using InferenceCallback = std::function<void(const std::string& modelName,
                                            const cv::Mat& image,
                                            std::shared_ptr<InferenceResult> result)>;
 
+/**
+ * @brief 帧预处理函数类型（如去畸变）
+ * @return 是否写入了 dst（返回 false 时使用原图）
+ */
+using FramePreprocessor = std::function<bool(const cv::Mat& src, cv::Mat& dst)>;
+
 /**
  * @brief 推理管理器类，负责管理推理引擎实例和模型加载
  * 与现有的perception_app架构集成
@@ -73,11 +81,13 @@ public:
      * @param modelName 模型名称
      * @param inputImage 输入图像
      * @param callback 回调函数
+     * @param frameInfo 输入帧的来源信息（回调时由结果的 getFrameInfo 取得）
      * @return 是否成功提交任务
      */
     bool runInferenceAsync(const std::string& modelName, 
                           const cv::Mat& inputImage, 
-                          InferenceCallback callback = nullptr);
+                          InferenceCallback callback = nullptr,
+                          const FrameInfo& frameInfo = FrameInfo{});
     
     /**
      * @brief 处理帧数据（主要接口，在ImageReceiver中调用）
@@ -114,12 +124,23 @@ public:
      */
     void setInferenceCallback(InferenceCallback callback);
     
+    /**
+     * @brief 设置帧预处理（enableFramePreprocessing 开启时在推理前对每帧执行）
+     * @param preprocessor 预处理函数，为空时取消
+     */
+    void setFramePreprocessor(FramePreprocessor preprocessor);
+    
     /**
      * @brief 获取推理统计信息
      * @return 统计信息字符串
      */
     std::string getStatistics() const;
     
+    /**
+     * @brief 获取推理频率控制状态（当前跳帧数、实际推理频率、控制器跳过的帧数等）
+     */
+    InferenceRateController::Stats getRateControlStats() const { return rateController_.getStats(); }
+    
     /**
      * @brief 重置统计信息
      */
@@ -135,12 +156,6 @@ public:
      * @brief 停止推理管理器
      */
     void stop();
-
-private:
-    InferenceManager() = default;
-    ~InferenceManager();
-    InferenceManager(const InferenceManager&) = delete;
-    InferenceManager& operator=(const InferenceManager&) = delete;
     
     /**
      * @brief 转换Orbbec帧为OpenCV Mat
@@ -149,6 +164,20 @@ private:
      */
     cv::Mat convertFrameToMat(std::shared_ptr<ob::Frame> frame);
     
+    /**
+     * @brief 转换Orbbec帧并执行帧预处理，得到推理使用的图像
+     * @param frame Orbbec帧
+     * @param preprocessed 可选，返回是否执行了帧预处理（图像坐标与原始帧不同）
+     * @return OpenCV Mat
+     */
+    cv::Mat prepareFrame(std::shared_ptr<ob::Frame> frame, bool* preprocessed = nullptr);
+
+private:
+    InferenceManager() = default;
+    ~InferenceManager();
+    InferenceManager(const InferenceManager&) = delete;
+    InferenceManager& operator=(const InferenceManager&) = delete;
+    
     /**
      * @brief 加载类别名称文件
      * @param filePath 文件路径
@@ -156,6 +185,27 @@ private:
      */
     std::vector<std::string> loadClassNames(const std::string& filePath);
     
+    /**
+     * @brief 执行推理并更新统计
+     * @param submitTime 提交时间（用于计算包含排队的端到端延迟）
+     */
+    std::shared_ptr<InferenceResult> executeInference(const std::string& modelName,
+                                                      const cv::Mat& inputImage,
+                                                      std::chrono::steady_clock::time_point submitTime);
+    
+    /**
+     * @brief 更新推理统计并反馈给频率控制器
+     * @param success 是否成功
+     * @param inferenceTimeMs 推理耗时(毫秒)
+     * @param latencyMs 从提交到完成的时间(毫秒)
+     */
+    void recordInference(bool success, double inferenceTimeMs, double latencyMs);
+    
+    /**
+     * @brief 应用配置快照中可热加载的推理设置（频率控制、默认模型阈值、性能统计）
+     */
+    void applyLiveConfig(const InferenceConfig& config);
+    
     /**
      * @brief 异步推理工作线程
      */
@@ -169,23 +219,30 @@ private:
         cv::Mat image;
         InferenceCallback callback;
         std::chrono::steady_clock::time_point submitTime;
+        FrameInfo frameInfo;
     };
 
 private:
     std::map<std::string, std::shared_ptr<InferenceEngine>> engines_;
     InferenceConfig config_;
     InferenceCallback globalCallback_;
+    FramePreprocessor framePreprocessor_;
+    std::mutex preprocessorMutex_;
     
     mutable std::mutex mutex_;
     std::atomic<bool> initialized_{false};
     std::atomic<bool> shouldStop_{false};
     
-    // 异步推理支持
-    std::queue<AsyncTask> asyncQueue_;
+    // 异步推理支持：每个模型一个待处理槽位，新帧覆盖未开始的旧帧（工作线程总是取到最新帧）
+    std::map<std::string, AsyncTask> pendingTasks_;
+    std::deque<std::string> pendingOrder_;      // 有待处理帧的模型（按首次提交顺序轮转）
     std::mutex queueMutex_;
     std::condition_variable queueCondition_;
     std::thread asyncWorker_;
     
+    // 三级推理流水线（enablePipeline 时创建）
+    std::unique_ptr<InferencePipeline> pipeline_;
+    
     // 性能统计
     struct Statistics {
         std::atomic<uint64_t> totalInferences{0};
@@ -194,12 +251,17 @@ private:
         std::atomic<double> totalInferenceTime{0.0};
         std::atomic<double> avgInferenceTime{0.0};
         std::atomic<uint64_t> framesProcessed{0};
-        std::atomic<uint64_t> framesSkipped{0};
+        std::atomic<uint64_t> framesSkipped{0};    // 过载丢弃（被新帧覆盖或流水线已满）
         std::chrono::steady_clock::time_point startTime;
     } stats_;
     
-    // 帧处理计数器
-    std::atomic<uint64_t> frameCounter_{0};
+    // 推理频率控制（决定每帧是否推理）
+    InferenceRateController rateController_;
+    
+    // 已同步的配置快照版本，以及最近一次应用的可热加载设置（受 mutex_ 保护）
+    std::atomic<uint64_t> configVersion_{0};
+    InferenceConfig liveConfig_;
+    std::atomic<bool> performanceStats_{false};
 };
 
 } // namespace inference 
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "InferencePipeline.hpp"
+#include "Logger.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace inference {
+
+namespace {
+
+int64_t steadyUs(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point startTime) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+}
+
+const char* STAGE_NAMES[] = {"Preprocess", "Execute", "Postprocess"};
+
+} // namespace
+
+InferencePipeline::InferencePipeline(size_t queueSize, bool latestWins)
+    : inputQueue_(latestWins ? MAX_LATEST_SLOTS : queueSize),
+      executeQueue_(queueSize),
+      postprocessQueue_(queueSize),
+      latestWins_(latestWins) {
+    statsStartUs_ = steadyUs(std::chrono::steady_clock::now());
+}
+
+InferencePipeline::~InferencePipeline() {
+    stop();
+}
+
+void InferencePipeline::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    statsStartUs_ = steadyUs(std::chrono::steady_clock::now());
+    threads_[PREPROCESS] = std::thread(&InferencePipeline::preprocessLoop, this);
+    threads_[EXECUTE] = std::thread(&InferencePipeline::executeLoop, this);
+    threads_[POSTPROCESS] = std::thread(&InferencePipeline::postprocessLoop, this);
+
+    LOG_INFO("Inference pipeline started (queue size: ", executeQueue_.capacity(),
+             latestWins_ ? ", latest frame wins" : "", ")");
+}
+
+void InferencePipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    stopping_ = true;
+    inputQueue_.close();
+    executeQueue_.close();
+    postprocessQueue_.close();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    LOG_INFO("Inference pipeline stopped");
+}
+
+bool InferencePipeline::submit(const std::string& modelName, std::shared_ptr<InferenceEngine> engine,
+                               const cv::Mat& image, Completion completion) {
+    if (!running_ || !engine) {
+        return false;
+    }
+
+    auto item = std::make_unique<Item>();
+    item->modelName = modelName;
+    item->engine = std::move(engine);
+    item->image = image;
+    item->completion = std::move(completion);
+    item->submitTime = std::chrono::steady_clock::now();
+
+    if (latestWins_) {
+        auto sameModel = [&modelName](const ItemPtr& queued) { return queued->modelName == modelName; };
+        if (inputQueue_.pushReplace(std::move(item), sameModel)) {
+            framesReplaced_.fetch_add(1);
+        }
+        return running_.load();
+    }
+    return inputQueue_.tryPush(std::move(item));
+}
+
+void InferencePipeline::recordStage(Stage stage, std::chrono::steady_clock::time_point startTime, bool ok) {
+    uint64_t us = elapsedUs(startTime);
+    StageStats& stats = stageStats_[stage];
+
+    stats.processed.fetch_add(1);
+    if (!ok) {
+        stats.failed.fetch_add(1);
+    }
+    stats.busyUs.fetch_add(us);
+
+    uint64_t previous = stats.maxUs.load();
+    while (us > previous && !stats.maxUs.compare_exchange_weak(previous, us)) {
+    }
+}
+
+void InferencePipeline::preprocessLoop() {
+    ItemPtr item;
+    while (inputQueue_.pop(item)) {
+        if (stopping_) {
+            break;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        try {
+            item->failed = !item->engine->preprocess(item->image, item->tensors);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Pipeline preprocess failed for ", item->modelName, ": ", e.what());
+            item->failed = true;
+        }
+        recordStage(PREPROCESS, startTime, !item->failed);
+
+        // 失败的帧也传递下去，保证回调按提交顺序调用
+        if (!executeQueue_.push(std::move(item))) {
+            break;
+        }
+    }
+}
+
+void InferencePipeline::executeLoop() {
+    ItemPtr item;
+    while (executeQueue_.pop(item)) {
+        if (stopping_) {
+            break;
+        }
+
+        if (!item->failed) {
+            auto startTime = std::chrono::steady_clock::now();
+            try {
+                item->failed = !item->engine->execute(item->tensors);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Pipeline execute failed for ", item->modelName, ": ", e.what());
+                item->failed = true;
+            }
+            recordStage(EXECUTE, startTime, !item->failed);
+        }
+
+        if (!postprocessQueue_.push(std::move(item))) {
+            break;
+        }
+    }
+}
+
+void InferencePipeline::postprocessLoop() {
+    ItemPtr item;
+    while (postprocessQueue_.pop(item)) {
+        if (stopping_) {
+            break;
+        }
+
+        std::shared_ptr<InferenceResult> result;
+        if (!item->failed) {
+            auto startTime = std::chrono::steady_clock::now();
+            try {
+                result = item->engine->postprocess(item->tensors);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Pipeline postprocess failed for ", item->modelName, ": ", e.what());
+            }
+            recordStage(POSTPROCESS, startTime, result != nullptr);
+        }
+
+        uint64_t latencyUs = elapsedUs(item->submitTime);
+        completed_.fetch_add(1);
+        latencyUs_.fetch_add(latencyUs);
+
+        if (item->completion) {
+            try {
+                item->completion(item->modelName, item->image, result, latencyUs / 1000.0);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error in inference callback: ", e.what());
+            }
+        }
+        item.reset();
+    }
+}
+
+std::string InferencePipeline::getStatistics() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+
+    double elapsedSec = (steadyUs(std::chrono::steady_clock::now()) - statsStartUs_.load()) / 1e6;
+    uint64_t completed = completed_.load();
+
+    oss << "Pipeline: " << completed << " frames completed";
+    if (completed > 0) {
+        oss << ", avg latency " << latencyUs_.load() / 1000.0 / completed << " ms";
+    }
+    if (elapsedSec > 0) {
+        oss << ", throughput " << completed / elapsedSec << " frames/sec";
+    }
+    if (latestWins_) {
+        oss << ", replaced " << framesReplaced_.load();
+    }
+    oss << "\n";
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        const StageStats& stats = stageStats_[stage];
+        uint64_t processed = stats.processed.load();
+        double busyMs = stats.busyUs.load() / 1000.0;
+
+        oss << "  " << std::left << std::setw(12) << STAGE_NAMES[stage] << std::right
+            << " frames: " << processed
+            << ", failed: " << stats.failed.load()
+            << ", avg: " << (processed > 0 ? busyMs / processed : 0.0) << " ms"
+            << ", max: " << stats.maxUs.load() / 1000.0 << " ms"
+            << ", busy: " << (elapsedSec > 0 ? busyMs / 10.0 / elapsedSec : 0.0) << "%\n";
+    }
+
+    const BoundedQueue<ItemPtr>* queues[] = {&inputQueue_, &executeQueue_, &postprocessQueue_};
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        auto occupancy = queues[stage]->occupancy();
+        oss << "  " << std::left << std::setw(12) << STAGE_NAMES[stage] << std::right
+            << " queue: " << queues[stage]->size() << "/" << queues[stage]->capacity()
+            << ", peak: " << occupancy.peak
+            << ", avg: " << occupancy.average << "\n";
+    }
+
+    return oss.str();
+}
+
+void InferencePipeline::resetStatistics() {
+    for (auto& stats : stageStats_) {
+        stats.processed = 0;
+        stats.failed = 0;
+        stats.busyUs = 0;
+        stats.maxUs = 0;
+    }
+    completed_ = 0;
+    framesReplaced_ = 0;
+    latencyUs_ = 0;
+    inputQueue_.resetOccupancy();
+    executeQueue_.resetOccupancy();
+    postprocessQueue_.resetOccupancy();
+    statsStartUs_ = steadyUs(std::chrono::steady_clock::now());
+}
+
+} // namespace inference
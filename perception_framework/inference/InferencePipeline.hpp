@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <opencv2/opencv.hpp>
+#include "InferenceBase.hpp"
+
+namespace inference {
+
+/**
+ * @brief 有界阻塞队列（流水线阶段之间的交接队列）
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    /**
+     * @brief 阻塞入队，队列满时等待
+     * @return 队列已关闭时返回 false
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        pushLocked(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief 非阻塞入队
+     * @return 队列已满或已关闭时返回 false
+     */
+    bool tryPush(T item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || items_.size() >= capacity_) return false;
+        pushLocked(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief 非阻塞入队，用新元素替换队列中第一个满足 match 的旧元素（保持其排队位置）；
+     * 没有可替换的元素且队列满时丢弃最旧的元素
+     * @return 是否替换或丢弃了旧元素（队列已关闭时不入队，返回 false）
+     */
+    template <typename Match>
+    bool pushReplace(T item, Match match) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) return false;
+        for (auto& queued : items_) {
+            if (match(queued)) {
+                queued = std::move(item);
+                return true;
+            }
+        }
+        bool evicted = false;
+        if (items_.size() >= capacity_) {
+            items_.pop_front();
+            evicted = true;
+        }
+        pushLocked(std::move(item));
+        return evicted;
+    }
+
+    /**
+     * @brief 阻塞出队
+     * @return 队列已关闭且为空时返回 false
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 关闭队列：唤醒所有等待者，之后入队失败，出队取完剩余元素后失败
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief 入队时的占用统计
+     */
+    struct Occupancy {
+        size_t peak = 0;            ///< 入队后的最大长度
+        double average = 0.0;       ///< 入队后的平均长度
+    };
+
+    Occupancy occupancy() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Occupancy result;
+        result.peak = peak_;
+        result.average = pushes_ > 0 ? static_cast<double>(occupancySum_) / pushes_ : 0.0;
+        return result;
+    }
+
+    void resetOccupancy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        peak_ = items_.size();
+        occupancySum_ = 0;
+        pushes_ = 0;
+    }
+
+private:
+    void pushLocked(T&& item) {
+        items_.push_back(std::move(item));
+        peak_ = std::max(peak_, items_.size());
+        occupancySum_ += items_.size();
+        pushes_++;
+        notEmpty_.notify_one();
+    }
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<T> items_;
+    bool closed_ = false;
+
+    size_t peak_ = 0;
+    uint64_t occupancySum_ = 0;
+    uint64_t pushes_ = 0;
+};
+
+/**
+ * @brief 三级推理流水线：预处理 -> 模型执行 -> 后处理
+ *
+ * 每个阶段一个专用线程，阶段之间通过有界队列交接，
+ * 第 N 帧执行模型时第 N+1 帧在预处理、第 N-1 帧在后处理。
+ * 帧按提交顺序完成，完成回调在后处理线程中调用。
+ * 输入队列满时 submit 直接返回 false（丢帧）；latestWins 模式下每个模型一个输入槽位，
+ * 新帧只覆盖同一模型尚未开始预处理的旧帧，保证每个模型总是处理自己的最新帧，
+ * 多个模型之间按提交顺序轮流执行。
+ * 阶段之间的队列满时上游阶段等待（反压）。
+ * 引擎需支持分阶段执行（InferenceEngine::supportsStages）。
+ */
+class InferencePipeline {
+public:
+    /**
+     * @brief 完成回调
+     * @param modelName 模型名称
+     * @param image 输入图像
+     * @param result 推理结果（失败时为 nullptr）
+     * @param latencyMs 从提交到完成的时间(毫秒)
+     */
+    using Completion = std::function<void(const std::string& modelName,
+                                          const cv::Mat& image,
+                                          std::shared_ptr<InferenceResult> result,
+                                          double latencyMs)>;
+
+    /**
+     * @param queueSize 阶段之间交接队列的容量
+     * @param latestWins 每个模型一个输入槽位，新帧覆盖同一模型未开始的旧帧
+     */
+    explicit InferencePipeline(size_t queueSize = 2, bool latestWins = false);
+    ~InferencePipeline();
+
+    InferencePipeline(const InferencePipeline&) = delete;
+    InferencePipeline& operator=(const InferencePipeline&) = delete;
+
+    void start();
+
+    /**
+     * @brief 停止流水线，丢弃尚未开始的帧，等待各阶段线程退出
+     */
+    void stop();
+
+    /**
+     * @brief 提交一帧
+     * @param modelName 模型名称
+     * @param engine 推理引擎（在途期间保持引用，卸载模型不影响在途帧）
+     * @param image 输入图像（调用方需保证在完成前不被修改，一般传入克隆）
+     * @param completion 完成回调
+     * @return 输入队列已满（非 latestWins 模式）或流水线未运行时返回 false
+     */
+    bool submit(const std::string& modelName, std::shared_ptr<InferenceEngine> engine,
+                const cv::Mat& image, Completion completion);
+
+    /**
+     * @brief 各阶段耗时与队列占用
+     */
+    std::string getStatistics() const;
+
+    void resetStatistics();
+
+    /**
+     * @brief latestWins 模式下被同一模型的新帧覆盖的帧数
+     */
+    uint64_t getFramesReplaced() const { return framesReplaced_.load(); }
+
+private:
+    enum Stage { PREPROCESS = 0, EXECUTE, POSTPROCESS, STAGE_COUNT };
+
+    static constexpr size_t MAX_LATEST_SLOTS = 16;  ///< latestWins 模式下输入槽位上限（同时加载的模型数）
+
+    struct Item {
+        std::string modelName;
+        std::shared_ptr<InferenceEngine> engine;
+        cv::Mat image;
+        Completion completion;
+        InferenceTensors tensors;
+        std::chrono::steady_clock::time_point submitTime;
+        bool failed = false;
+    };
+    using ItemPtr = std::unique_ptr<Item>;
+
+    struct StageStats {
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> busyUs{0};
+        std::atomic<uint64_t> maxUs{0};
+    };
+
+    void preprocessLoop();
+    void executeLoop();
+    void postprocessLoop();
+    void recordStage(Stage stage, std::chrono::steady_clock::time_point startTime, bool ok);
+
+    BoundedQueue<ItemPtr> inputQueue_;
+    BoundedQueue<ItemPtr> executeQueue_;
+    BoundedQueue<ItemPtr> postprocessQueue_;
+
+    std::thread threads_[STAGE_COUNT];
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+    const bool latestWins_;
+
+    StageStats stageStats_[STAGE_COUNT];
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> framesReplaced_{0};
+    std::atomic<uint64_t> latencyUs_{0};
+    std::atomic<int64_t> statsStartUs_{0};      ///< 统计起点（steady_clock 微秒）
+};
+
+} // namespace inference
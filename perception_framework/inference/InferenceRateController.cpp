@@ -0,0 +1,131 @@
+#include "InferenceRateController.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace inference {
+
+namespace {
+
+constexpr double SMOOTHING = 0.2;               // 指数平滑系数
+constexpr double MAX_FRAME_GAP_MS = 1000.0;     // 超过该间隔视为数据流中断，不计入帧间隔
+constexpr int ADJUST_COOLDOWN = 4;              // LATENCY 模式两次调整之间至少完成的推理次数
+constexpr double CEIL_SLACK = 0.01;             // 向上取整时容忍的测量误差，避免 3.0001 -> 4
+
+inline double smooth(double previous, double sample) {
+    return previous <= 0.0 ? sample : previous + SMOOTHING * (sample - previous);
+}
+
+} // namespace
+
+InferenceRateController::InferenceRateController(const Options& options) {
+    configure(options);
+}
+
+void InferenceRateController::configure(const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    options_.minInterval = std::max(1, options_.minInterval);
+    options_.maxInterval = std::max(options_.minInterval, options_.maxInterval);
+    interval_ = options_.minInterval;
+    latencyAdjust_ = 0;
+    completionsSinceAdjust_ = 0;
+    frameCounter_ = 0;
+}
+
+InferenceRateController::Mode InferenceRateController::parseMode(const std::string& name) {
+    if (name == "latency") return Mode::LATENCY;
+    if (name == "cpu") return Mode::CPU;
+    return Mode::FIXED;
+}
+
+bool InferenceRateController::shouldRun(int64_t nowUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (lastFrameUs_ > 0) {
+        double periodMs = (nowUs - lastFrameUs_) / 1000.0;
+        if (periodMs > 0.0 && periodMs < MAX_FRAME_GAP_MS) {
+            framePeriodMs_ = smooth(framePeriodMs_, periodMs);
+        }
+    }
+    lastFrameUs_ = nowUs;
+
+    if (++frameCounter_ >= static_cast<uint64_t>(interval_)) {
+        frameCounter_ = 0;
+        return true;
+    }
+    framesSkipped_++;
+    return false;
+}
+
+void InferenceRateController::recordInference(double inferenceMs, double latencyMs, int64_t nowUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    inferenceMs_ = smooth(inferenceMs_, inferenceMs);
+    latencyMs_ = smooth(latencyMs_, latencyMs);
+    if (lastCompletionUs_ > 0 && nowUs > lastCompletionUs_) {
+        double periodMs = (nowUs - lastCompletionUs_) / 1000.0;
+        if (periodMs < MAX_FRAME_GAP_MS) {
+            completionPeriodMs_ = smooth(completionPeriodMs_, periodMs);
+        }
+    }
+    lastCompletionUs_ = nowUs;
+    completionsSinceAdjust_++;
+
+    updateIntervalLocked();
+}
+
+void InferenceRateController::updateIntervalLocked() {
+    if (options_.mode == Mode::FIXED) {
+        interval_ = options_.minInterval;
+        return;
+    }
+    if (framePeriodMs_ <= 0.0 || inferenceMs_ <= 0.0) {
+        return;
+    }
+
+    double interval = 1.0;
+    if (options_.mode == Mode::CPU) {
+        double share = std::min(1.0, std::max(options_.targetCpuShare, 0.01));
+        interval = std::ceil(inferenceMs_ / (share * framePeriodMs_) - CEIL_SLACK);
+    } else {
+        // 推理必须跟得上输入帧率，否则延迟会因排队无限增长
+        interval = std::ceil(inferenceMs_ / framePeriodMs_ - CEIL_SLACK);
+
+        // 排队导致延迟超出预算时增加跳帧；仅推理本身超预算时跳帧无法改善延迟
+        if (completionsSinceAdjust_ >= ADJUST_COOLDOWN) {
+            double queueingMs = latencyMs_ - inferenceMs_;
+            if (latencyMs_ > options_.targetLatencyMs && queueingMs > 0.1 * options_.targetLatencyMs) {
+                latencyAdjust_ = std::min(latencyAdjust_ + 1, options_.maxInterval);
+                completionsSinceAdjust_ = 0;
+            } else if (latencyMs_ < 0.7 * options_.targetLatencyMs && latencyAdjust_ > 0) {
+                latencyAdjust_--;
+                completionsSinceAdjust_ = 0;
+            }
+        }
+        interval += latencyAdjust_;
+    }
+
+    interval_ = static_cast<int>(std::min<double>(options_.maxInterval,
+                                                  std::max<double>(options_.minInterval, interval)));
+}
+
+InferenceRateController::Stats InferenceRateController::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.interval = interval_;
+    stats.inferenceMs = inferenceMs_;
+    stats.latencyMs = latencyMs_;
+    stats.framePeriodMs = framePeriodMs_;
+    stats.effectiveRate = completionPeriodMs_ > 0.0 ? 1000.0 / completionPeriodMs_ : 0.0;
+    stats.framesSkipped = framesSkipped_;
+    return stats;
+}
+
+void InferenceRateController::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    framesSkipped_ = 0;
+    completionPeriodMs_ = 0.0;
+    lastCompletionUs_ = 0;
+}
+
+} // namespace inference
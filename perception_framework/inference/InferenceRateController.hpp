@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace inference {
+
+/**
+ * @brief 自适应推理频率控制器
+ *
+ * 根据持续测量的推理耗时与帧间隔动态选择跳帧数（每 interval 帧推理一次）：
+ *  - FIXED:   固定 interval（原 inferenceInterval 行为）
+ *  - LATENCY: 保证推理跟得上帧率（interval >= 推理耗时/帧间隔），
+ *             并按测得的端到端延迟（含排队）加性增减 interval，使延迟不超过 targetLatencyMs
+ *  - CPU:     推理线程占用时间不超过单核的 targetCpuShare，
+ *             interval = ceil(推理耗时 / (targetCpuShare * 帧间隔))
+ * interval 限制在 [minInterval, maxInterval] 之内。线程安全。
+ */
+class InferenceRateController {
+public:
+    enum class Mode { FIXED, LATENCY, CPU };
+
+    struct Options {
+        Mode mode = Mode::FIXED;
+        int minInterval = 1;            ///< 最小跳帧数（FIXED 模式下即固定值）
+        int maxInterval = 30;           ///< 最大跳帧数
+        double targetLatencyMs = 100.0; ///< LATENCY 模式：端到端延迟预算(毫秒)
+        double targetCpuShare = 0.5;    ///< CPU 模式：推理占用单核时间的比例 (0, 1]
+    };
+
+    struct Stats {
+        int interval = 1;                   ///< 当前跳帧数
+        double inferenceMs = 0.0;           ///< 推理耗时（指数平滑）
+        double latencyMs = 0.0;             ///< 端到端延迟（指数平滑）
+        double framePeriodMs = 0.0;         ///< 输入帧间隔（指数平滑）
+        double effectiveRate = 0.0;         ///< 实际推理频率(次/秒)
+        uint64_t framesSkipped = 0;         ///< 被控制器跳过的帧数
+    };
+
+    InferenceRateController() = default;
+    explicit InferenceRateController(const Options& options);
+
+    void configure(const Options& options);
+
+    /**
+     * @brief 每个输入帧调用一次，决定该帧是否推理
+     * @param nowUs 当前时间(微秒, steady_clock)
+     */
+    bool shouldRun(int64_t nowUs);
+
+    /**
+     * @brief 记录一次完成的推理
+     * @param inferenceMs 推理耗时(毫秒)
+     * @param latencyMs 从提交到完成的时间(毫秒)，包含排队时间
+     * @param nowUs 完成时间(微秒, steady_clock)
+     */
+    void recordInference(double inferenceMs, double latencyMs, int64_t nowUs);
+
+    Stats getStats() const;
+
+    void resetStats();
+
+    /**
+     * @brief 解析模式名称: "fixed", "latency", "cpu"
+     * @return 无法识别时返回 FIXED
+     */
+    static Mode parseMode(const std::string& name);
+
+private:
+    void updateIntervalLocked();
+
+    Options options_;
+
+    mutable std::mutex mutex_;
+    int interval_ = 1;
+    int latencyAdjust_ = 0;             ///< LATENCY 模式下的额外跳帧数
+    int completionsSinceAdjust_ = 0;
+    uint64_t frameCounter_ = 0;
+
+    double inferenceMs_ = 0.0;
+    double latencyMs_ = 0.0;
+    double framePeriodMs_ = 0.0;
+    double completionPeriodMs_ = 0.0;   ///< 推理完成间隔（指数平滑）
+    int64_t lastFrameUs_ = 0;
+    int64_t lastCompletionUs_ = 0;
+    uint64_t framesSkipped_ = 0;
+};
+
+} // namespace inference
@@ -0,0 +1,288 @@
+#include "ModelCache.hpp"
+#include "Logger.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace inference {
+
+namespace {
+
+// ==================== XXH64 ====================
+
+constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round64(0, value);
+    return acc * PRIME1 + PRIME4;
+}
+
+std::string toHex(uint64_t value, int digits) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(digits) << std::setfill('0') << value;
+    return oss.str();
+}
+
+} // namespace
+
+// ==================== MappedModel ====================
+
+MappedModel::~MappedModel() {
+    close();
+}
+
+MappedModel::MappedModel(MappedModel&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedModel& MappedModel::operator=(MappedModel&& other) noexcept {
+    if (this != &other) {
+        close();
+        mapped_ = other.mapped_;
+        size_ = other.size_;
+        buffer_ = std::move(other.buffer_);
+        data_ = mapped_ ? other.data_ : buffer_.data();
+        path_ = std::move(other.path_);
+        hash_ = other.hash_;
+        hashValid_ = other.hashValid_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+        other.hashValid_ = false;
+    }
+    return *this;
+}
+
+bool MappedModel::open(const std::string& path, bool useMmap) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    if (useMmap) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED) {
+            // 加载时会顺序读取全部权重，提前预读
+            ::madvise(ptr, size, MADV_WILLNEED);
+            data_ = static_cast<const uint8_t*>(ptr);
+            mapped_ = true;
+        } else {
+            LOG_WARN("mmap failed for ", path, ": ", std::strerror(errno), ", reading into memory");
+        }
+    }
+
+    if (!mapped_) {
+        buffer_.resize(size);
+        size_t offset = 0;
+        while (offset < size) {
+            ssize_t n = ::read(fd, buffer_.data() + offset, size - offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                ::close(fd);
+                buffer_.clear();
+                return false;
+            }
+            offset += static_cast<size_t>(n);
+        }
+        data_ = buffer_.data();
+    }
+
+    ::close(fd);
+    size_ = size;
+    path_ = path;
+    return true;
+}
+
+void MappedModel::close() {
+    if (mapped_ && data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    path_.clear();
+    hashValid_ = false;
+}
+
+uint64_t MappedModel::hash() const {
+    if (!hashValid_) {
+        hash_ = ModelCache::hashBytes(data_, size_);
+        hashValid_ = true;
+    }
+    return hash_;
+}
+
+// ==================== ModelCache ====================
+
+ModelCache::ModelCache(const std::string& directory) : directory_(directory) {}
+
+uint64_t ModelCache::hashBytes(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + PRIME5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    while (p + 8 <= end) {
+        h ^= round64(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string ModelCache::makeKey(uint64_t modelHash, const std::string& backendVersion,
+                                const std::string& sessionOptions) {
+    std::string options = backendVersion + '\n' + sessionOptions;
+    uint64_t optionsHash = hashBytes(options.data(), options.size());
+    return toHex(modelHash, 16) + "-" + toHex(optionsHash >> 32, 8);
+}
+
+std::string ModelCache::modelStem(const std::string& modelPath) {
+    std::string stem = std::filesystem::path(modelPath).stem().string();
+    return stem.empty() ? "model" : stem;
+}
+
+std::string ModelCache::entryPath(const std::string& modelPath, const std::string& key,
+                                  const std::string& extension) const {
+    return (std::filesystem::path(directory_) / (modelStem(modelPath) + "." + key + extension)).string();
+}
+
+std::string ModelCache::lookup(const std::string& modelPath, const std::string& key,
+                               const std::string& extension) const {
+    std::string path = entryPath(modelPath, key, extension);
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        return path;
+    }
+    return "";
+}
+
+bool ModelCache::store(const std::string& modelPath, const std::string& key, const uint8_t* data, size_t size,
+                       const std::string& extension) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        LOG_WARN("Failed to create model cache directory ", directory_, ": ", ec.message());
+        return false;
+    }
+
+    std::string path = entryPath(modelPath, key, extension);
+    std::string tmpPath = path + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size)) || !file.flush()) {
+            LOG_WARN("Failed to write model cache entry: ", tmpPath);
+            file.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOG_WARN("Failed to commit model cache entry ", path, ": ", std::strerror(errno));
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // 删除同一模型的旧条目（模型或选项已变化，不会再命中）
+    std::string prefix = modelStem(modelPath) + ".";
+    std::string current = std::filesystem::path(path).filename().string();
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name != current && name.compare(0, prefix.size(), prefix) == 0 &&
+            name.size() > extension.size() &&
+            name.compare(name.size() - extension.size(), extension.size(), extension) == 0 &&
+            name.size() == current.size()) {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+    return true;
+}
+
+} // namespace inference
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inference {
+
+/**
+ * @brief 只读模型文件
+ *
+ * 默认以 MAP_SHARED 只读映射文件，权重页由页缓存提供，
+ * 多个进程加载同一模型时共享物理内存，也不必先整体拷贝到堆上。
+ * 映射失败（或 useMmap 为 false）时退回整体读入内存。
+ */
+class MappedModel {
+public:
+    MappedModel() = default;
+    ~MappedModel();
+
+    MappedModel(const MappedModel&) = delete;
+    MappedModel& operator=(const MappedModel&) = delete;
+    MappedModel(MappedModel&& other) noexcept;
+    MappedModel& operator=(MappedModel&& other) noexcept;
+
+    /**
+     * @brief 打开模型文件
+     * @param path 文件路径
+     * @param useMmap 是否使用内存映射
+     * @return 是否成功（空文件视为失败）
+     */
+    bool open(const std::string& path, bool useMmap = true);
+
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    bool isMapped() const { return mapped_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+    /**
+     * @brief 文件内容的 64 位哈希（XXH64，首次调用时计算）
+     */
+    uint64_t hash() const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> buffer_;       ///< 未映射时的文件内容
+    std::string path_;
+    mutable uint64_t hash_ = 0;
+    mutable bool hashValid_ = false;
+};
+
+/**
+ * @brief 优化后模型的磁盘缓存
+ *
+ * 条目以 "<模型名>.<模型哈希>-<后端与会话选项哈希><扩展名>" 保存在缓存目录中
+ * （优化后的模型为 .ort，自动选择的后端为 .backend），
+ * 模型内容、后端版本或会话选项任一变化都会得到新的键。
+ * 写入先写临时文件再 rename，进程中途退出不会留下不完整的条目；
+ * 同一模型的旧条目在写入新条目后删除。
+ */
+class ModelCache {
+public:
+    explicit ModelCache(const std::string& directory);
+
+    /**
+     * @brief 生成缓存键
+     * @param modelHash 原始模型内容哈希
+     * @param backendVersion 推理后端版本
+     * @param sessionOptions 影响优化结果的会话选项
+     */
+    static std::string makeKey(uint64_t modelHash, const std::string& backendVersion,
+                               const std::string& sessionOptions);
+
+    /**
+     * @brief 计算数据的 XXH64 哈希
+     */
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+    /**
+     * @brief 缓存条目路径（不检查是否存在）
+     */
+    std::string entryPath(const std::string& modelPath, const std::string& key,
+                          const std::string& extension = ".ort") const;
+
+    /**
+     * @brief 查找缓存条目
+     * @return 条目路径，不存在时返回空字符串
+     */
+    std::string lookup(const std::string& modelPath, const std::string& key,
+                       const std::string& extension = ".ort") const;
+
+    /**
+     * @brief 写入缓存条目
+     * @return 是否成功
+     */
+    bool store(const std::string& modelPath, const std::string& key, const uint8_t* data, size_t size,
+               const std::string& extension = ".ort");
+
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    static std::string modelStem(const std::string& modelPath);
+
+    std::string directory_;
+};
+
+} // namespace inference
@@ -1,10 +1,40 @@
 #include "ONNXInference.hpp"
+#include "OpenCVDNNInference.hpp"
+#include "AutoInferenceEngine.hpp"
 #include "Logger.hpp"
 #include <random>
 #include <chrono>
+#include <sstream>
 
 namespace inference {
 
+namespace {
+
+double elapsedMs(std::chrono::high_resolution_clock::time_point startTime) {
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - startTime);
+    return duration.count() / 1000.0; // 转换为毫秒
+}
+
+// 后端版本写入缓存键，后端升级后旧的优化模型自动失效
+// 接入 ONNX Runtime 后使用 OrtGetApiBase()->GetVersionString()
+constexpr const char* BACKEND_VERSION = "onnx-sim-1";
+
+/**
+ * @brief 影响图优化结果的会话选项
+ */
+std::string sessionOptionsKey(const std::vector<int64_t>& inputShape) {
+    std::ostringstream oss;
+    oss << "shape=";
+    for (size_t i = 0; i < inputShape.size(); i++) {
+        oss << (i > 0 ? "x" : "") << inputShape[i];
+    }
+    oss << ";graph_opt=all;ep=cpu";
+    return oss.str();
+}
+
+} // namespace
+
 // ONNXInferenceResult 实现
 ONNXInferenceResult::ONNXInferenceResult() {
     // 构造函数
@@ -55,9 +85,11 @@ bool ONNXInferenceEngine::initialize(const ModelConfig& config) {
         classNames_ = config.classNames;
         threshold_ = config.confidenceThreshold;
         
-        // 这里应该是真正的ONNX Runtime初始化
-        // 为了演示，我们创建一个模拟的会话
-        session_ = reinterpret_cast<void*>(0x12345678); // 模拟指针
+        nmsOptions_.method = NMSOptions::parseMethod(config.nmsMethod);
+        nmsOptions_.iouThreshold = config.nmsThreshold;
+        nmsOptions_.sigma = config.softNmsSigma;
+        nmsOptions_.classAware = config.classAwareNMS;
+        nmsOptions_.maxDetections = config.maxDetections;
         
         // 设置输入形状（默认值）
         if (!config.inputShape.empty()) {
@@ -65,6 +97,9 @@ bool ONNXInferenceEngine::initialize(const ModelConfig& config) {
         } else {
             inputShape_ = {1, 3, 640, 640}; // NCHW格式
         }
+        if (inputShape_.size() == 4) {
+            inputSize_ = cv::Size(static_cast<int>(inputShape_[3]), static_cast<int>(inputShape_[2]));
+        }
         
         // 设置输入输出名称
         if (!config.inputNames.empty()) {
@@ -79,6 +114,17 @@ bool ONNXInferenceEngine::initialize(const ModelConfig& config) {
             outputNames_ = {"output"};
         }
         
+        // 加载模型（内存映射 + 优化模型缓存）
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        if (!loadModelData(config)) {
+            LOG_WARN("Model file not readable, using simulated session: ", modelPath_);
+        }
+        
+        // 这里应该是真正的ONNX Runtime初始化
+        // 为了演示，我们创建一个模拟的会话
+        session_ = reinterpret_cast<void*>(0x12345678); // 模拟指针
+        loadTimeMs_ = elapsedMs(loadStart);
+        
         initialized_ = true;
         
         LOG_INFO("ONNX Inference Engine initialized successfully");
@@ -88,6 +134,13 @@ bool ONNXInferenceEngine::initialize(const ModelConfig& config) {
                  inputShape_[0], ", ", inputShape_[1], ", ", 
                  inputShape_[2], ", ", inputShape_[3], "]");
         LOG_INFO("  Threshold: ", threshold_);
+        LOG_INFO("  Load Time: ", loadTimeMs_, " ms (", loadedFromCache_ ? "cached" : "cold",
+                 modelData_.isMapped() ? ", mmap" : "", ")");
+        if (modelType_ == "detection") {
+            LOG_INFO("  NMS: ", config.nmsMethod, " (IoU: ", nmsOptions_.iouThreshold,
+                     ", class aware: ", nmsOptions_.classAware ? "yes" : "no",
+                     ", max detections: ", nmsOptions_.maxDetections, ")");
+        }
         
         return true;
     } catch (const std::exception& e) {
@@ -96,88 +149,144 @@ bool ONNXInferenceEngine::initialize(const ModelConfig& config) {
     }
 }
 
+bool ONNXInferenceEngine::loadModelData(const ModelConfig& config) {
+    loadedFromCache_ = false;
+    modelData_.close();
+    
+    MappedModel model;
+    if (!model.open(config.modelPath, config.useMmap)) {
+        return false;
+    }
+    
+    if (config.cacheDirectory.empty()) {
+        // 实际 ONNX Runtime: Ort::Session(env, modelData_.data(), modelData_.size(), options)
+        modelData_ = std::move(model);
+        return true;
+    }
+    
+    ModelCache cache(config.cacheDirectory);
+    std::string key = ModelCache::makeKey(model.hash(), BACKEND_VERSION, sessionOptionsKey(inputShape_));
+    std::string cachedPath = cache.lookup(config.modelPath, key);
+    if (!cachedPath.empty() && modelData_.open(cachedPath, config.useMmap)) {
+        // 实际 ONNX Runtime: 用 ORT 格式字节创建会话，graph_optimization_level 设为 ORT_DISABLE_ALL，
+        // 并设置 session.use_ort_model_bytes_directly=1 直接引用映射的内存，跳过图优化与权重拷贝
+        loadedFromCache_ = true;
+        LOG_INFO("  Optimized model cache hit: ", cachedPath);
+        return true;
+    }
+    
+    // 冷启动：图优化后保存优化结果
+    // 实际 ONNX Runtime: SessionOptions::SetOptimizedModelFilePath(<临时路径>) 在创建会话时写出 ORT 格式模型，
+    // 模拟会话没有图变换，优化结果即原始模型
+    if (cache.store(config.modelPath, key, model.data(), model.size())) {
+        LOG_INFO("  Optimized model cached: ", cache.entryPath(config.modelPath, key));
+    }
+    modelData_ = std::move(model);
+    return true;
+}
+
 std::shared_ptr<InferenceResult> ONNXInferenceEngine::infer(const cv::Mat& inputImage) {
+    InferenceTensors tensors;
+    if (!preprocess(inputImage, tensors) || !execute(tensors)) {
+        return nullptr;
+    }
+    return postprocess(tensors);
+}
+
+bool ONNXInferenceEngine::preprocess(const cv::Mat& inputImage, InferenceTensors& tensors) {
     if (!initialized_) {
         LOG_ERROR("Engine not initialized");
-        return nullptr;
+        return false;
     }
     
     if (inputImage.empty()) {
         LOG_ERROR("Empty input image");
-        return nullptr;
+        return false;
     }
     
-    auto result = std::make_shared<ONNXInferenceResult>();
     auto startTime = std::chrono::high_resolution_clock::now();
     
     try {
-        // 预处理图像
-        auto preprocessedData = preprocessImage(inputImage);
-        
-        // 这里应该是真正的ONNX Runtime推理
+        tensors.imageSize = inputImage.size();
+        tensors.input = preprocessImage(inputImage);
+        tensors.output.clear();
+        tensors.processingTime = elapsedMs(startTime);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Preprocessing failed: ", e.what());
+        return false;
+    }
+}
+
+bool ONNXInferenceEngine::execute(InferenceTensors& tensors) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    try {
+        // 这里应该是真正的ONNX Runtime推理（Ort::Session::Run 可在多线程中调用）
         // 为了演示，我们创建模拟输出
-        std::vector<float> modelOutput;
+        std::vector<float>& modelOutput = tensors.output;
         
         if (modelType_ == "classification") {
             // 模拟分类输出（1000个类别的概率）
             modelOutput.resize(1000);
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-            
-            for (auto& val : modelOutput) {
-                val = dis(gen);
-            }
-            
-            // 后处理分类结果
-            auto classResult = postprocessClassification(modelOutput);
-            result->setClassificationResult(classResult);
-            
         } else if (modelType_ == "detection") {
             // 模拟检测输出
             modelOutput.resize(25200 * 85); // YOLO格式示例
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-            
-            for (auto& val : modelOutput) {
-                val = dis(gen);
-            }
-            
-            // 后处理检测结果
-            auto detections = postprocessDetection(modelOutput, inputImage.size());
-            result->setDetectionResults(detections);
-            
         } else if (modelType_ == "segmentation") {
             // 模拟分割输出
-            int outputHeight = inputImage.rows / 4;
-            int outputWidth = inputImage.cols / 4;
+            int outputHeight = tensors.imageSize.height / 4;
+            int outputWidth = tensors.imageSize.width / 4;
             modelOutput.resize(outputHeight * outputWidth);
+        }
+        
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+        
+        for (auto& val : modelOutput) {
+            val = dis(gen);
+        }
+        
+        tensors.processingTime += elapsedMs(startTime);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Inference failed: ", e.what());
+        return false;
+    }
+}
+
+std::shared_ptr<InferenceResult> ONNXInferenceEngine::postprocess(InferenceTensors& tensors) {
+    auto result = std::make_shared<ONNXInferenceResult>();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    try {
+        std::lock_guard<std::mutex> lock(postprocessMutex_);
+        
+        if (modelType_ == "classification") {
+            // 后处理分类结果
+            auto classResult = postprocessClassification(tensors.output);
+            result->setClassificationResult(classResult);
             
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-            
-            for (auto& val : modelOutput) {
-                val = dis(gen);
-            }
+        } else if (modelType_ == "detection") {
+            // 后处理检测结果
+            auto detections = postprocessDetection(tensors.output, tensors.imageSize);
+            result->setDetectionResults(detections);
             
+        } else if (modelType_ == "segmentation") {
             // 后处理分割结果
-            auto mask = postprocessSegmentation(modelOutput, inputImage.size());
+            auto mask = postprocessSegmentation(tensors.output, tensors.imageSize);
             result->setSegmentationMask(mask);
         }
         
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        double inferenceTime = duration.count() / 1000.0; // 转换为毫秒
+        tensors.processingTime += elapsedMs(startTime);
         
-        result->setInferenceTime(inferenceTime);
+        result->setInferenceTime(tensors.processingTime);
         result->setValid(true);
         
         return result;
         
     } catch (const std::exception& e) {
-        LOG_ERROR("Inference failed: ", e.what());
+        LOG_ERROR("Postprocessing failed: ", e.what());
         return nullptr;
     }
 }
@@ -190,6 +299,8 @@ std::string ONNXInferenceEngine::getModelInfo() const {
     oss << "  Input Size: " << inputSize_.width << "x" << inputSize_.height << "\n";
     oss << "  Threshold: " << threshold_ << "\n";
     oss << "  Classes: " << classNames_.size() << "\n";
+    oss << "  Model Data: " << modelData_.size() / 1024 << " KB" << (modelData_.isMapped() ? " (mmap)" : "") << "\n";
+    oss << "  Load Time: " << loadTimeMs_ << " ms (" << (loadedFromCache_ ? "cached" : "cold") << ")\n";
     oss << "  Initialized: " << (initialized_ ? "Yes" : "No");
     return oss.str();
 }
@@ -252,53 +363,40 @@ std::vector<DetectionBox> ONNXInferenceEngine::postprocessDetection(const std::v
                                                                     const cv::Size& imageSize) {
     std::vector<DetectionBox> detections;
     
-    // 这里是YOLO格式的简化处理
-    // 实际实现需要根据具体的模型格式调整
-    int numBoxes = output.size() / 85; // 假设每个框有85个值（4坐标+1置信度+80类别）
+    // YOLO格式：每个框 5 + 类别数 个值（4坐标+1置信度+类别分数）
+    int numClasses = static_cast<int>(classNames_.size());
+    if (numClasses <= 0 || output.size() % static_cast<size_t>(numClasses + 5) != 0) {
+        numClasses = 80;
+    }
+    size_t numBoxes = output.size() / static_cast<size_t>(numClasses + 5);
     
-    for (int i = 0; i < numBoxes && i < 100; ++i) { // 限制最多100个框
-        int offset = i * 85;
-        
-        float confidence = output[offset + 4];
-        if (confidence < threshold_) {
-            continue;
-        }
-        
-        // 解析边界框
-        float x = output[offset + 0] * imageSize.width;
-        float y = output[offset + 1] * imageSize.height;
-        float w = output[offset + 2] * imageSize.width;
-        float h = output[offset + 3] * imageSize.height;
+    // 解码（objectness 过滤后再计算类别 argmax）
+    postprocessor_.decodeYolo(output.data(), numBoxes, numClasses, threshold_,
+                              static_cast<float>(imageSize.width), static_cast<float>(imageSize.height),
+                              candidates_);
+    
+    // 应用NMS
+    const auto& keep = postprocessor_.nms(candidates_, nmsOptions_);
+    
+    detections.reserve(keep.size());
+    for (int idx : keep) {
+        DetectionBox box;
+        box.bbox = cv::Rect2f(candidates_.x1[idx], candidates_.y1[idx],
+                              candidates_.x2[idx] - candidates_.x1[idx],
+                              candidates_.y2[idx] - candidates_.y1[idx]);
+        box.classId = candidates_.classId[idx];
+        box.confidence = candidates_.score[idx];
         
-        // 找到最大类别概率
-        int bestClass = 0;
-        float bestScore = 0.0f;
-        for (int j = 5; j < 85; ++j) {
-            float score = output[offset + j] * confidence;
-            if (score > bestScore) {
-                bestScore = score;
-                bestClass = j - 5;
-            }
+        if (box.classId < static_cast<int>(classNames_.size())) {
+            box.className = classNames_[box.classId];
+        } else {
+            box.className = "class_" + std::to_string(box.classId);
         }
         
-        if (bestScore > threshold_) {
-            DetectionBox box;
-            box.bbox = cv::Rect2f(x - w/2, y - h/2, w, h);
-            box.classId = bestClass;
-            box.confidence = bestScore;
-            
-            if (bestClass < static_cast<int>(classNames_.size())) {
-                box.className = classNames_[bestClass];
-            } else {
-                box.className = "class_" + std::to_string(bestClass);
-            }
-            
-            detections.push_back(box);
-        }
+        detections.push_back(std::move(box));
     }
     
-    // 应用NMS
-    return applyNMS(detections);
+    return detections;
 }
 
 cv::Mat ONNXInferenceEngine::postprocessSegmentation(const std::vector<float>& output, 
@@ -331,67 +429,17 @@ cv::Mat ONNXInferenceEngine::postprocessSegmentation(const std::vector<float>& o
     return finalMask;
 }
 
-std::vector<DetectionBox> ONNXInferenceEngine::applyNMS(const std::vector<DetectionBox>& boxes) {
-    std::vector<DetectionBox> result;
-    
-    if (boxes.empty()) {
-        return result;
-    }
-    
-    // 简化的NMS实现
-    const float nmsThreshold = 0.5f;
-    
-    // 按置信度排序
-    std::vector<int> indices;
-    for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
-        indices.push_back(i);
-    }
-    
-    std::sort(indices.begin(), indices.end(), [&boxes](int a, int b) {
-        return boxes[a].confidence > boxes[b].confidence;
-    });
-    
-    std::vector<bool> suppressed(boxes.size(), false);
-    
-    for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
-        int idx = indices[i];
-        if (suppressed[idx]) {
-            continue;
-        }
-        
-        result.push_back(boxes[idx]);
-        
-        // 抑制重叠的框
-        for (int j = i + 1; j < static_cast<int>(indices.size()); ++j) {
-            int jdx = indices[j];
-            if (suppressed[jdx]) {
-                continue;
-            }
-            
-            // 计算IoU
-            cv::Rect2f rect1 = boxes[idx].bbox;
-            cv::Rect2f rect2 = boxes[jdx].bbox;
-            
-            float intersectionArea = (rect1 & rect2).area();
-            float unionArea = rect1.area() + rect2.area() - intersectionArea;
-            
-            if (unionArea > 0) {
-                float iou = intersectionArea / unionArea;
-                if (iou > nmsThreshold) {
-                    suppressed[jdx] = true;
-                }
-            }
-        }
-    }
-    
-    return result;
-}
-
 // InferenceEngineFactory 实现
 std::shared_ptr<InferenceEngine> InferenceEngineFactory::createEngine(const std::string& engineType) {
     if (engineType == "onnx") {
         return std::make_shared<ONNXInferenceEngine>();
     }
+    if (engineType == "opencv") {
+        return std::make_shared<OpenCVDNNEngine>();
+    }
+    if (engineType == "auto") {
+        return std::make_shared<AutoInferenceEngine>();
+    }
     // 可以在这里添加其他引擎类型
     
     LOG_ERROR("Unsupported inference engine type: ", engineType);
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "InferenceBase.hpp"
+#include "DetectionPostprocess.hpp"
+#include "ModelCache.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 namespace inference {
 
@@ -89,6 +92,30 @@ public:
     void setThreshold(float threshold) override { threshold_ = threshold; }
     bool isInitialized() const override { return initialized_; }
     std::string getModelType() const override { return modelType_; }
+    
+    /**
+     * @brief 最近一次初始化的模型加载耗时(毫秒)
+     */
+    double getLoadTimeMs() const { return loadTimeMs_; }
+    
+    /**
+     * @brief 最近一次初始化是否命中优化模型缓存
+     */
+    bool isLoadedFromCache() const { return loadedFromCache_; }
+    
+    // 分阶段执行（InferencePipeline）
+    bool supportsStages() const override { return true; }
+    bool preprocess(const cv::Mat& inputImage, InferenceTensors& tensors) override;
+    bool execute(InferenceTensors& tensors) override;
+    std::shared_ptr<InferenceResult> postprocess(InferenceTensors& tensors) override;
+
+protected:
+    /**
+     * @brief 加载模型数据：命中缓存时映射优化后的模型，否则映射原始模型并写入缓存
+     * @param config 模型配置
+     * @return 模型文件是否可读
+     */
+    virtual bool loadModelData(const ModelConfig& config);
 
 private:
     /**
@@ -122,27 +149,33 @@ private:
      */
     cv::Mat postprocessSegmentation(const std::vector<float>& output, 
                                    const cv::Size& imageSize);
-    
-    /**
-     * @brief 非极大值抑制
-     * @param boxes 检测框
-     * @return 过滤后的检测框
-     */
-    std::vector<DetectionBox> applyNMS(const std::vector<DetectionBox>& boxes);
 
-private:
+protected:
     bool initialized_ = false;
     std::string modelPath_;
     std::string modelType_;
     std::vector<std::string> classNames_;
     float threshold_ = 0.5f;
-    
+
+private:
+    // 检测后处理（缓冲在多次推理间复用，后处理阶段由 postprocessMutex_ 串行化）
+    std::mutex postprocessMutex_;
+    DetectionPostprocessor postprocessor_;
+    DetectionCandidates candidates_;
+    NMSOptions nmsOptions_;
+
+protected:
     // 模型输入输出信息
     cv::Size inputSize_ = cv::Size(640, 640);
     std::vector<int64_t> inputShape_;
     std::vector<std::string> inputNames_;
     std::vector<std::string> outputNames_;
     
+    // 模型数据（会话存续期间保持映射，会话可直接引用其中的权重）
+    MappedModel modelData_;
+    double loadTimeMs_ = 0.0;
+    bool loadedFromCache_ = false;
+    
     // 模拟的模型会话（实际应该是ONNX Runtime会话）
     void* session_ = nullptr;
 };
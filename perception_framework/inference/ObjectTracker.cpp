@@ -0,0 +1,385 @@
+#include "ObjectTracker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace inference {
+
+namespace {
+
+constexpr double SMOOTHING = 0.1;               // 耗时统计的指数平滑系数
+constexpr float MAX_DT = 1.0f;                  // 单次预测的最大时间步长(秒)，避免数据流中断后框飞出画面
+constexpr float MEAS_STD = 0.05f;               // 检测框测量噪声（相对框尺寸）
+constexpr float FLOW_STD = 0.1f;                // 光流测量噪声（相对框尺寸）
+constexpr float ACCEL_STD = 2.0f;               // 加速度噪声（框尺寸/秒^2）
+constexpr float INIT_VEL_STD = 2.0f;            // 新目标的初始速度不确定度（框尺寸/秒）
+constexpr int FLOW_GRID = 3;                    // 每个目标的光流网格点数 FLOW_GRID x FLOW_GRID
+constexpr size_t MIN_FLOW_POINTS = 3;           // 有效光流点少于该值时不校正
+
+inline float iou(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float x1 = std::max(a.x, b.x);
+    float y1 = std::max(a.y, b.y);
+    float x2 = std::min(a.x + a.width, b.x + b.width);
+    float y2 = std::min(a.y + a.height, b.y + b.height);
+    float inter = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+    float uni = a.width * a.height + b.width * b.height - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+inline double elapsedUs(std::chrono::steady_clock::time_point startTime) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+inline double smooth(double previous, double sample) {
+    return previous <= 0.0 ? sample : previous + SMOOTHING * (sample - previous);
+}
+
+// 两个时间戳之间的预测步长(秒)，早于 fromUs 时为 0
+inline float stepSeconds(int64_t fromUs, int64_t toUs) {
+    return toUs > fromUs ? std::min(MAX_DT, (toUs - fromUs) / 1e6f) : 0.0f;
+}
+
+inline float accelVariance(float size) {
+    return (ACCEL_STD * size) * (ACCEL_STD * size);
+}
+
+float median(std::vector<float>& values) {
+    auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+} // namespace
+
+// ==================== Kalman ====================
+
+void ObjectTracker::Axis::init(float z, float posVar, float velVar) {
+    pos = z;
+    vel = 0.0f;
+    p00 = posVar;
+    p01 = 0.0f;
+    p11 = velVar;
+}
+
+void ObjectTracker::Axis::predict(float dt, float accelVar) {
+    // x = F x, P = F P F^T + Q，F = [1 dt; 0 1]，Q 为离散白噪声加速度模型
+    float dt2 = dt * dt;
+    pos += vel * dt;
+    p00 += 2.0f * dt * p01 + dt2 * p11 + 0.25f * dt2 * dt2 * accelVar;
+    p01 += dt * p11 + 0.5f * dt2 * dt * accelVar;
+    p11 += dt2 * accelVar;
+}
+
+void ObjectTracker::Axis::correct(float z, float measVar) {
+    // H = [1 0]，标量新息，无需矩阵求逆
+    float s = p00 + measVar;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+    float y = z - pos;
+    pos += k0 * y;
+    vel += k1 * y;
+    p11 -= k1 * p01;
+    p01 -= k0 * p01;
+    p00 -= k0 * p00;
+}
+
+cv::Rect2f ObjectTracker::Track::boxAt(int64_t timestampUs) const {
+    float accelVar = accelVariance(std::max(w.pos, h.pos));
+    Axis x = cx, y = cy, bw = w, bh = h;
+    float dt = stepSeconds(stateUs, timestampUs);
+    bw.predict(dt, accelVar);
+    bh.predict(dt, accelVar);
+
+    // 中心点优先从光流校正后的状态预测（仅当光流状态不晚于目标时刻）
+    if (flowUs >= stateUs && flowUs > 0 && flowUs <= timestampUs) {
+        x = flowX;
+        y = flowY;
+        dt = stepSeconds(flowUs, timestampUs);
+    }
+    x.predict(dt, accelVar);
+    y.predict(dt, accelVar);
+
+    float width = std::max(bw.pos, 1.0f);
+    float height = std::max(bh.pos, 1.0f);
+    return cv::Rect2f(x.pos - width * 0.5f, y.pos - height * 0.5f, width, height);
+}
+
+// ==================== Tracker ====================
+
+ObjectTracker::ObjectTracker() : ObjectTracker(Options()) {}
+
+ObjectTracker::ObjectTracker(const Options& options) : options_(options) {
+    options_.maxAge = std::max(0, options_.maxAge);
+    options_.minHits = std::max(1, options_.minHits);
+    options_.flowScale = std::min(1.0f, std::max(0.05f, options_.flowScale));
+}
+
+void ObjectTracker::initTrack(Track& track, const DetectionBox& detection, int64_t timestampUs) {
+    const cv::Rect2f& box = detection.bbox;
+    float size = std::max(box.width, box.height);
+    float posVar = (MEAS_STD * size) * (MEAS_STD * size);
+    float velVar = (INIT_VEL_STD * size) * (INIT_VEL_STD * size);
+
+    track.cx.init(box.x + box.width * 0.5f, posVar, velVar);
+    track.cy.init(box.y + box.height * 0.5f, posVar, velVar);
+    track.w.init(box.width, posVar, velVar);
+    track.h.init(box.height, posVar, velVar);
+    track.stateUs = timestampUs;
+    track.flowUs = 0;
+    track.classId = detection.classId;
+    track.className = detection.className;
+    track.confidence = detection.confidence;
+    track.hits = 1;
+    track.misses = 0;
+    track.matched = true;
+}
+
+void ObjectTracker::correctTrack(Track& track, const DetectionBox& detection, int64_t timestampUs) {
+    // 滤波状态先预测到检测的采集时刻；早于上次检测的结果（乱序到达）在当前状态上校正
+    if (timestampUs > track.stateUs) {
+        float dt = stepSeconds(track.stateUs, timestampUs);
+        float accelVar = accelVariance(std::max(track.w.pos, track.h.pos));
+        track.cx.predict(dt, accelVar);
+        track.cy.predict(dt, accelVar);
+        track.w.predict(dt, accelVar);
+        track.h.predict(dt, accelVar);
+        track.stateUs = timestampUs;
+    }
+    // 光流校正以检测前的状态为基础，检测到达后丢弃
+    track.flowUs = 0;
+
+    const cv::Rect2f& box = detection.bbox;
+    float size = std::max(box.width, box.height);
+    float measVar = (MEAS_STD * size) * (MEAS_STD * size);
+
+    track.cx.correct(box.x + box.width * 0.5f, measVar);
+    track.cy.correct(box.y + box.height * 0.5f, measVar);
+    track.w.correct(box.width, measVar);
+    track.h.correct(box.height, measVar);
+    track.confidence = detection.confidence;
+    track.className = detection.className;
+    track.hits++;
+    track.misses = 0;
+    track.matched = true;
+}
+
+void ObjectTracker::setReferenceLocked(const cv::Mat& image, int64_t timestampUs) {
+    if (!options_.opticalFlow || image.empty()) {
+        return;
+    }
+    referenceUs_ = timestampUs;
+
+    cv::Mat small;
+    cv::resize(image, small, cv::Size(), options_.flowScale, options_.flowScale, cv::INTER_AREA);
+    if (small.channels() == 3) {
+        cv::cvtColor(small, prevGray_, cv::COLOR_BGR2GRAY);
+    } else if (small.type() == CV_8UC1) {
+        prevGray_ = small;
+    } else {
+        small.convertTo(prevGray_, CV_8U, 255.0 / 65535.0);
+    }
+}
+
+void ObjectTracker::applyFlowLocked(const cv::Mat& image, int64_t timestampUs) {
+    if (!options_.opticalFlow || image.empty() || timestampUs < referenceUs_) {
+        return;
+    }
+
+    cv::Mat prevGray = prevGray_;
+    int64_t prevUs = referenceUs_;
+    setReferenceLocked(image, timestampUs);
+    if (prevGray.empty() || prevGray.size() != prevGray_.size() || tracks_.empty()) {
+        return;
+    }
+
+    // 所有目标的网格点一次调用，金字塔只构建一次
+    std::vector<cv::Point2f> prevPoints;
+    prevPoints.reserve(tracks_.size() * FLOW_GRID * FLOW_GRID);
+    for (const auto& track : tracks_) {
+        cv::Rect2f box = track.boxAt(prevUs);
+        for (int gy = 0; gy < FLOW_GRID; gy++) {
+            for (int gx = 0; gx < FLOW_GRID; gx++) {
+                float x = box.x + box.width * (gx + 1) / (FLOW_GRID + 1);
+                float y = box.y + box.height * (gy + 1) / (FLOW_GRID + 1);
+                prevPoints.emplace_back(x * options_.flowScale, y * options_.flowScale);
+            }
+        }
+    }
+
+    std::vector<cv::Point2f> nextPoints;
+    std::vector<unsigned char> status;
+    std::vector<float> error;
+    cv::calcOpticalFlowPyrLK(prevGray, prevGray_, prevPoints, nextPoints, status, error,
+                             cv::Size(15, 15), 2);
+
+    std::vector<float> dxs, dys;
+    dxs.reserve(FLOW_GRID * FLOW_GRID);
+    dys.reserve(FLOW_GRID * FLOW_GRID);
+    for (size_t t = 0; t < tracks_.size(); t++) {
+        dxs.clear();
+        dys.clear();
+        for (size_t i = t * FLOW_GRID * FLOW_GRID; i < (t + 1) * FLOW_GRID * FLOW_GRID; i++) {
+            if (status[i]) {
+                dxs.push_back((nextPoints[i].x - prevPoints[i].x) / options_.flowScale);
+                dys.push_back((nextPoints[i].y - prevPoints[i].y) / options_.flowScale);
+            }
+        }
+        if (dxs.size() < MIN_FLOW_POINTS) {
+            continue;
+        }
+
+        // 网格点取自上一参考帧时刻的框，因此位移相对上一参考帧的中心
+        Track& track = tracks_[t];
+        float size = std::max(track.w.pos, track.h.pos);
+        float measVar = (FLOW_STD * size) * (FLOW_STD * size);
+        float centerX = prevPoints[t * FLOW_GRID * FLOW_GRID + FLOW_GRID + 1].x / options_.flowScale;
+        float centerY = prevPoints[t * FLOW_GRID * FLOW_GRID + FLOW_GRID + 1].y / options_.flowScale;
+
+        // 光流状态从上次光流校正（或检测状态）预测到当前帧后校正
+        if (track.flowUs < track.stateUs || track.flowUs == 0) {
+            track.flowX = track.cx;
+            track.flowY = track.cy;
+            track.flowUs = track.stateUs;
+        }
+        float dt = stepSeconds(track.flowUs, timestampUs);
+        float accelVar = accelVariance(size);
+        track.flowX.predict(dt, accelVar);
+        track.flowY.predict(dt, accelVar);
+        track.flowX.correct(centerX + median(dxs), measVar);
+        track.flowY.correct(centerY + median(dys), measVar);
+        track.flowUs = timestampUs;
+    }
+}
+
+std::vector<TrackedObject> ObjectTracker::update(const std::vector<DetectionBox>& detections, int64_t timestampUs,
+                                                 const cv::Mat& image) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    lastTimestampUs_ = std::max(lastTimestampUs_, timestampUs);
+
+    // 同类别的预测框（预测到检测的采集时刻）与检测框的 IoU，按 IoU 降序贪心匹配
+    candidates_.clear();
+    for (size_t t = 0; t < tracks_.size(); t++) {
+        cv::Rect2f box = tracks_[t].boxAt(timestampUs);
+        for (size_t d = 0; d < detections.size(); d++) {
+            if (detections[d].classId != tracks_[t].classId) {
+                continue;
+            }
+            float overlap = iou(box, detections[d].bbox);
+            if (overlap >= options_.iouThreshold) {
+                candidates_.push_back({overlap, static_cast<int>(t), static_cast<int>(d)});
+            }
+        }
+    }
+    std::sort(candidates_.begin(), candidates_.end(),
+              [](const Candidate& a, const Candidate& b) { return a.iou > b.iou; });
+
+    trackMatched_.assign(tracks_.size(), 0);
+    detectionMatched_.assign(detections.size(), 0);
+    for (const auto& candidate : candidates_) {
+        if (trackMatched_[candidate.track] || detectionMatched_[candidate.detection]) {
+            continue;
+        }
+        trackMatched_[candidate.track] = 1;
+        detectionMatched_[candidate.detection] = 1;
+        correctTrack(tracks_[candidate.track], detections[candidate.detection], timestampUs);
+    }
+
+    for (size_t t = 0; t < tracks_.size(); t++) {
+        if (!trackMatched_[t]) {
+            tracks_[t].misses++;
+            tracks_[t].matched = false;
+        }
+    }
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                                 [this](const Track& track) { return track.misses > options_.maxAge; }),
+                  tracks_.end());
+
+    for (size_t d = 0; d < detections.size(); d++) {
+        if (!detectionMatched_[d]) {
+            Track track;
+            track.id = nextId_++;
+            initTrack(track, detections[d], timestampUs);
+            tracks_.push_back(std::move(track));
+            stats_.totalTracks++;
+        }
+    }
+
+    setReferenceLocked(image, timestampUs);
+    publishLocked(false);
+
+    double us = elapsedUs(startTime);
+    stats_.updates++;
+    stats_.lastUpdateUs = us;
+    stats_.avgUpdateUs = smooth(stats_.avgUpdateUs, us);
+    return output_;
+}
+
+std::vector<TrackedObject> ObjectTracker::predict(int64_t timestampUs, const cv::Mat& image) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    lastTimestampUs_ = std::max(lastTimestampUs_, timestampUs);
+    applyFlowLocked(image, timestampUs);
+    publishLocked(true);
+
+    double us = elapsedUs(startTime);
+    stats_.predictions++;
+    stats_.lastPredictUs = us;
+    stats_.avgPredictUs = smooth(stats_.avgPredictUs, us);
+    return output_;
+}
+
+void ObjectTracker::publishLocked(bool predicted) {
+    output_.clear();
+    for (const auto& track : tracks_) {
+        if (track.hits < options_.minHits) {
+            continue;
+        }
+        TrackedObject object;
+        object.trackId = track.id;
+        object.bbox = track.boxAt(lastTimestampUs_);
+        object.classId = track.classId;
+        object.confidence = track.confidence;
+        object.className = track.className;
+        object.predicted = predicted || !track.matched;
+        object.hits = track.hits;
+        output_.push_back(std::move(object));
+    }
+}
+
+std::vector<TrackedObject> ObjectTracker::getTracks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return output_;
+}
+
+void ObjectTracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tracks_.clear();
+    output_.clear();
+    prevGray_.release();
+    lastTimestampUs_ = 0;
+    referenceUs_ = 0;
+}
+
+ObjectTracker::Stats ObjectTracker::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.activeTracks = tracks_.size();
+    return stats;
+}
+
+std::string ObjectTracker::getStatistics() const {
+    Stats stats = getStats();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Tracker: " << stats.activeTracks << " active tracks, " << stats.totalTracks << " created"
+        << ", update " << stats.avgUpdateUs << " us (" << stats.updates << ")"
+        << ", predict " << stats.avgPredictUs << " us (" << stats.predictions << ")";
+    return oss.str();
+}
+
+} // namespace inference
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "ONNXInference.hpp"
+
+namespace inference {
+
+/**
+ * @brief 跟踪目标
+ */
+struct TrackedObject {
+    int trackId = -1;               ///< 持久目标ID
+    cv::Rect2f bbox;
+    int classId = -1;
+    float confidence = 0.0f;        ///< 最近一次匹配检测的置信度
+    std::string className;
+    bool predicted = false;         ///< 本帧没有匹配的检测，框为预测值
+    int hits = 0;                   ///< 累计匹配次数
+};
+
+/**
+ * @brief 轻量多目标跟踪器（SORT 风格）
+ *
+ * 每个目标的中心点与宽高各用一个匀速卡尔曼滤波器（状态：位置/速度）跟踪，
+ * 时间步长取实际时间戳差，推理频率变化时预测仍然正确。
+ * 滤波状态保存在最近一次匹配检测的采集时刻，输出框按最新帧时间戳向前预测，
+ * 因此推理有延迟（检测结果晚若干帧到达）时，检测仍与其采集时刻的预测框匹配和校正。
+ *  - update: 推理结果到达时调用，按 IoU 贪心匹配同类别的预测框与检测框，
+ *            未匹配的检测创建新目标，连续 maxAge 次未匹配的目标被删除
+ *  - predict: 未推理的帧调用，输出预测框；启用光流时在缩小的灰度图上
+ *            对每个目标的网格点做金字塔 LK 光流，用位移中值校正中心点
+ *            （光流校正只作用于输出，下一次检测到达时丢弃）
+ * 匹配次数达到 minHits 的目标才会输出。线程安全。
+ */
+class ObjectTracker {
+public:
+    struct Options {
+        float iouThreshold = 0.3f;      ///< 匹配所需最小 IoU
+        int maxAge = 5;                 ///< 连续未匹配的检测次数超过该值后删除目标
+        int minHits = 2;                ///< 匹配次数达到该值后才输出
+        bool opticalFlow = false;       ///< 未推理的帧用稀疏光流校正
+        float flowScale = 0.25f;        ///< 光流图像缩放比例
+    };
+
+    struct Stats {
+        uint64_t updates = 0;           ///< update 调用次数
+        uint64_t predictions = 0;       ///< predict 调用次数
+        double lastUpdateUs = 0.0;      ///< 最近一次 update 耗时(微秒)
+        double avgUpdateUs = 0.0;       ///< update 平均耗时(微秒)
+        double lastPredictUs = 0.0;     ///< 最近一次 predict 耗时(微秒)
+        double avgPredictUs = 0.0;      ///< predict 平均耗时(微秒)
+        size_t activeTracks = 0;        ///< 当前目标数（含未确认）
+        uint64_t totalTracks = 0;       ///< 累计创建的目标数
+    };
+
+    ObjectTracker();
+    explicit ObjectTracker(const Options& options);
+
+    /**
+     * @brief 用新的检测结果更新目标
+     * @param detections 检测框
+     * @param timestampUs 检测所用图像的采集时间戳(微秒, steady_clock)，可早于之前 predict 的时间戳
+     * @param image 检测所用图像（启用光流时作为下一次光流的参考帧）
+     * @return 已确认的目标（预测到最近一帧的时间戳）
+     */
+    std::vector<TrackedObject> update(const std::vector<DetectionBox>& detections, int64_t timestampUs,
+                                      const cv::Mat& image = cv::Mat());
+
+    /**
+     * @brief 预测未推理帧上的目标位置
+     * @param timestampUs 时间戳(微秒, steady_clock)
+     * @param image 当前帧（启用光流时使用）
+     * @return 已确认的目标（predicted 为 true）
+     */
+    std::vector<TrackedObject> predict(int64_t timestampUs, const cv::Mat& image = cv::Mat());
+
+    /**
+     * @brief 最近一次 update/predict 的输出
+     */
+    std::vector<TrackedObject> getTracks() const;
+
+    void reset();
+
+    Stats getStats() const;
+
+    /**
+     * @brief 统计信息字符串
+     */
+    std::string getStatistics() const;
+
+private:
+    /**
+     * @brief 一维匀速卡尔曼滤波器（状态：位置、速度）
+     */
+    struct Axis {
+        float pos = 0.0f;
+        float vel = 0.0f;
+        float p00 = 0.0f, p01 = 0.0f, p11 = 0.0f;   ///< 协方差（对称）
+
+        void init(float z, float posVar, float velVar);
+        void predict(float dt, float accelVar);
+        void correct(float z, float measVar);
+    };
+
+    struct Track {
+        int id = -1;
+        Axis cx, cy, w, h;              ///< 最近一次匹配检测时刻的滤波状态
+        int64_t stateUs = 0;            ///< 滤波状态对应的时间戳
+        Axis flowX, flowY;              ///< 光流校正后的中心点
+        int64_t flowUs = 0;             ///< 光流状态对应的时间戳（0 表示无）
+        int classId = -1;
+        float confidence = 0.0f;
+        std::string className;
+        int hits = 0;
+        int misses = 0;                 ///< 连续未匹配的检测次数
+        bool matched = false;           ///< 最近一次 update 是否匹配
+
+        // 预测到 timestampUs 的框（不修改滤波状态）
+        cv::Rect2f boxAt(int64_t timestampUs) const;
+    };
+
+    void applyFlowLocked(const cv::Mat& image, int64_t timestampUs);
+    void setReferenceLocked(const cv::Mat& image, int64_t timestampUs);
+    void publishLocked(bool predicted);
+    void initTrack(Track& track, const DetectionBox& detection, int64_t timestampUs);
+    void correctTrack(Track& track, const DetectionBox& detection, int64_t timestampUs);
+
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::vector<Track> tracks_;
+    std::vector<TrackedObject> output_;
+    int nextId_ = 1;
+    int64_t lastTimestampUs_ = 0;       ///< 最新帧的时间戳（输出框预测到该时刻）
+
+    cv::Mat prevGray_;                  ///< 光流参考帧（缩小的灰度图）
+    int64_t referenceUs_ = 0;           ///< 光流参考帧的时间戳
+
+    // 复用的中间缓冲
+    struct Candidate {
+        float iou;
+        int track;
+        int detection;
+    };
+    std::vector<Candidate> candidates_;
+    std::vector<char> trackMatched_;
+    std::vector<char> detectionMatched_;
+
+    Stats stats_;
+};
+
+} // namespace inference
@@ -0,0 +1,121 @@
+#include "OpenCVDNNInference.hpp"
+#include "Logger.hpp"
+#include <chrono>
+#include <sstream>
+
+namespace inference {
+
+#ifdef HAVE_OPENCV_DNN
+namespace {
+
+double elapsedMs(std::chrono::high_resolution_clock::time_point startTime) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+} // namespace
+#endif
+
+bool OpenCVDNNEngine::isAvailable() {
+#ifdef HAVE_OPENCV_DNN
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OpenCVDNNEngine::loadModelData(const ModelConfig& config) {
+    // 直接映射原始模型，缓存中的优化模型是 ONNX Runtime 格式，DNN 无法解析
+    loadedFromCache_ = false;
+    return modelData_.open(config.modelPath, config.useMmap);
+}
+
+bool OpenCVDNNEngine::initialize(const ModelConfig& config) {
+    if (!isAvailable()) {
+        LOG_ERROR("OpenCV DNN module not available");
+        return false;
+    }
+
+    if (!ONNXInferenceEngine::initialize(config)) {
+        return false;
+    }
+
+    if (!modelData_.isOpen()) {
+        LOG_ERROR("OpenCV DNN requires a readable model file: ", config.modelPath);
+        initialized_ = false;
+        return false;
+    }
+
+#ifdef HAVE_OPENCV_DNN
+    auto startTime = std::chrono::high_resolution_clock::now();
+    try {
+        net_ = cv::dnn::readNetFromONNX(reinterpret_cast<const char*>(modelData_.data()), modelData_.size());
+        if (net_.empty()) {
+            LOG_ERROR("OpenCV DNN failed to parse model: ", config.modelPath);
+            initialized_ = false;
+            return false;
+        }
+        net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to initialize OpenCV DNN engine: ", e.what());
+        initialized_ = false;
+        return false;
+    }
+    loadTimeMs_ += elapsedMs(startTime);
+#endif
+
+    LOG_INFO("OpenCV DNN backend ready (", cv::getVersionString(), ", load time: ", loadTimeMs_, " ms)");
+    return true;
+}
+
+bool OpenCVDNNEngine::execute(InferenceTensors& tensors) {
+#ifdef HAVE_OPENCV_DNN
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    try {
+        std::vector<int> shape(inputShape_.begin(), inputShape_.end());
+        size_t expected = 1;
+        for (int dim : shape) {
+            expected *= static_cast<size_t>(dim);
+        }
+        if (tensors.input.size() != expected) {
+            LOG_ERROR("Input size mismatch: ", tensors.input.size(), " (expected ", expected, ")");
+            return false;
+        }
+
+        // 输入直接引用预处理结果，不拷贝
+        cv::Mat blob(static_cast<int>(shape.size()), shape.data(), CV_32F, tensors.input.data());
+        cv::Mat output;
+        {
+            std::lock_guard<std::mutex> lock(netMutex_);
+            net_.setInput(blob);
+            output = net_.forward();
+        }
+
+        if (!output.isContinuous()) {
+            output = output.clone();
+        }
+        const float* data = output.ptr<float>();
+        tensors.output.assign(data, data + output.total());
+        tensors.processingTime += elapsedMs(startTime);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("OpenCV DNN inference failed: ", e.what());
+        return false;
+    }
+#else
+    (void)tensors;
+    return false;
+#endif
+}
+
+std::string OpenCVDNNEngine::getModelInfo() const {
+    std::ostringstream oss;
+    oss << "OpenCV DNN Inference Engine (" << cv::getVersionString() << ")\n";
+    std::string info = ONNXInferenceEngine::getModelInfo();
+    // 去掉基类信息的标题行
+    oss << info.substr(info.find('\n') + 1);
+    return oss.str();
+}
+
+} // namespace inference
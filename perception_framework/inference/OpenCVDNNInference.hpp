@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ONNXInference.hpp"
+#include <opencv2/opencv.hpp>
+#include <mutex>
+
+namespace inference {
+
+/**
+ * @brief OpenCV DNN 推理引擎
+ *
+ * 用 OpenCV DNN 模块（CPU）执行同一个 ONNX 模型，预处理与后处理沿用
+ * ONNXInferenceEngine，因此两个后端的输入输出完全一致，可以互相替换。
+ * 模型从内存映射的原始 ONNX 文件解析（DNN 没有可缓存的优化格式）。
+ * cv::dnn::Net::forward 不可重入，模型执行阶段由 netMutex_ 串行化。
+ */
+class OpenCVDNNEngine : public ONNXInferenceEngine {
+public:
+    OpenCVDNNEngine() = default;
+    ~OpenCVDNNEngine() override = default;
+
+    bool initialize(const ModelConfig& config) override;
+    std::string getModelInfo() const override;
+    bool execute(InferenceTensors& tensors) override;
+
+    /**
+     * @brief 当前 OpenCV 是否带有 DNN 模块
+     */
+    static bool isAvailable();
+
+protected:
+    bool loadModelData(const ModelConfig& config) override;
+
+private:
+    std::mutex netMutex_;
+#ifdef HAVE_OPENCV_DNN
+    cv::dnn::Net net_;
+#endif
+};
+
+} // namespace inference
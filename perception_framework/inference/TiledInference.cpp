@@ -0,0 +1,275 @@
+#include "TiledInference.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <sstream>
+#include <thread>
+
+namespace inference {
+
+namespace {
+
+/**
+ * @brief 单个方向上的分块起点
+ */
+std::vector<int> tileOffsets(int length, int tile, float overlap) {
+    if (length <= tile) {
+        return {0};
+    }
+    int stride = std::max(1, static_cast<int>(std::lround(tile * (1.0f - overlap))));
+    int count = (length - tile + stride - 1) / stride + 1;
+    std::vector<int> offsets;
+    offsets.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) {
+        offsets.push_back(std::min(i * stride, length - tile));
+    }
+    return offsets;
+}
+
+constexpr float EDGE_MARGIN = 1.0f;             // 距分块边界小于该值(像素)的框视为被截断
+constexpr float CONTAINED_RATIO = 0.7f;         // 截断框落在更高分框内的面积比例超过该值时去掉
+
+/**
+ * @brief 整帧坐标系中的检测框
+ */
+struct TileDetection {
+    DetectionBox box;
+    bool truncated = false;     ///< 框贴着分块的内部边界（不是帧边缘），目标可能只有一部分可见
+};
+
+/**
+ * @brief 在一个引擎副本上依次推理分配给它的区域，检测框平移回整帧坐标
+ */
+std::vector<TileDetection> runRegions(InferenceEngine& engine, const cv::Mat& image,
+                                      const std::vector<cv::Rect>& regions) {
+    std::vector<TileDetection> detections;
+    for (const auto& region : regions) {
+        auto result = std::dynamic_pointer_cast<ONNXInferenceResult>(engine.infer(image(region)));
+        if (!result || !result->isValid()) {
+            LOG_WARN("Tile inference failed at (", region.x, ", ", region.y, ")");
+            continue;
+        }
+
+        bool innerLeft = region.x > 0;
+        bool innerTop = region.y > 0;
+        bool innerRight = region.x + region.width < image.cols;
+        bool innerBottom = region.y + region.height < image.rows;
+        for (const auto& box : result->getDetectionResults()) {
+            TileDetection detection;
+            detection.box = box;
+            detection.truncated = (innerLeft && box.bbox.x < EDGE_MARGIN) ||
+                                  (innerTop && box.bbox.y < EDGE_MARGIN) ||
+                                  (innerRight && box.bbox.x + box.bbox.width > region.width - EDGE_MARGIN) ||
+                                  (innerBottom && box.bbox.y + box.bbox.height > region.height - EDGE_MARGIN);
+            detection.box.bbox.x += static_cast<float>(region.x);
+            detection.box.bbox.y += static_cast<float>(region.y);
+            detections.push_back(std::move(detection));
+        }
+    }
+    return detections;
+}
+
+/**
+ * @brief a 落在 b 内的面积占 a 的比例
+ */
+float containedRatio(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float w = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+    float h = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+    float area = a.width * a.height;
+    return (w > 0.0f && h > 0.0f && area > 0.0f) ? w * h / area : 0.0f;
+}
+
+} // namespace
+
+TiledInferenceEngine::TiledInferenceEngine() : TiledInferenceEngine(Options()) {
+}
+
+TiledInferenceEngine::TiledInferenceEngine(const Options& options, EngineFactory factory)
+    : options_(options), factory_(std::move(factory)) {
+    if (!factory_) {
+        factory_ = [](const ModelConfig& config) { return InferenceEngineFactory::createEngine(config.engineType); };
+    }
+}
+
+std::vector<cv::Rect> TiledInferenceEngine::computeTiles(const cv::Size& frameSize, const cv::Size& tileSize,
+                                                         float overlap) {
+    std::vector<cv::Rect> tiles;
+    if (frameSize.width <= 0 || frameSize.height <= 0 || tileSize.width <= 0 || tileSize.height <= 0) {
+        return tiles;
+    }
+
+    auto xs = tileOffsets(frameSize.width, tileSize.width, overlap);
+    auto ys = tileOffsets(frameSize.height, tileSize.height, overlap);
+    int width = std::min(tileSize.width, frameSize.width);
+    int height = std::min(tileSize.height, frameSize.height);
+
+    tiles.reserve(xs.size() * ys.size());
+    for (int y : ys) {
+        for (int x : xs) {
+            tiles.emplace_back(x, y, width, height);
+        }
+    }
+    return tiles;
+}
+
+bool TiledInferenceEngine::initialize(const ModelConfig& config) {
+    std::lock_guard<std::mutex> lock(inferMutex_);
+    engines_.clear();
+    pool_.reset();
+
+    try {
+        // 分块尺寸默认与模型输入一致，分块内不需要缩放
+        tileSize_ = options_.tileSize;
+        if (tileSize_.width <= 0 || tileSize_.height <= 0) {
+            tileSize_ = cv::Size(640, 640);
+            if (config.inputShape.size() == 4) {
+                tileSize_ = cv::Size(static_cast<int>(config.inputShape[3]), static_cast<int>(config.inputShape[2]));
+            }
+        }
+
+        nmsOptions_.method = NMSOptions::parseMethod(config.nmsMethod);
+        nmsOptions_.iouThreshold = config.nmsThreshold;
+        nmsOptions_.sigma = config.softNmsSigma;
+        nmsOptions_.classAware = config.classAwareNMS;
+        nmsOptions_.maxDetections = config.maxDetections;
+
+        int workers = options_.workers > 0 ? options_.workers
+                                           : static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(1, workers);
+
+        // 各副本独立初始化：会话状态互不共享，模型文件经 mmap 后权重页只占一份物理内存
+        for (int i = 0; i < workers; i++) {
+            auto engine = factory_(config);
+            if (!engine || !engine->initialize(config)) {
+                LOG_ERROR("Failed to initialize tile engine ", i, " for: ", config.modelPath);
+                engines_.clear();
+                return false;
+            }
+            engines_.push_back(engine);
+        }
+        pool_ = std::make_unique<utils::ThreadPool>(engines_.size());
+
+        LOG_INFO("Tiled inference ready: ", engines_.size(), " workers, tile ", tileSize_.width, "x",
+                 tileSize_.height, ", overlap ", options_.overlap, ", full frame ", options_.fullFrame ? "on" : "off");
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to initialize tiled inference: ", e.what());
+        engines_.clear();
+        pool_.reset();
+        return false;
+    }
+}
+
+std::shared_ptr<InferenceResult> TiledInferenceEngine::infer(const cv::Mat& inputImage) {
+    std::lock_guard<std::mutex> lock(inferMutex_);
+    auto result = std::make_shared<ONNXInferenceResult>();
+
+    if (engines_.empty() || inputImage.empty()) {
+        LOG_ERROR("Tiled inference engine not initialized or empty input");
+        return result;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    try {
+        cv::Size frameSize(inputImage.cols, inputImage.rows);
+        auto tiles = computeTiles(frameSize, tileSize_, options_.overlap);
+        lastTileCount_ = tiles.size();
+
+        // 只有一块且覆盖整帧时整帧推理与分块推理相同
+        std::vector<cv::Rect> regions = tiles;
+        cv::Rect frameRect(0, 0, frameSize.width, frameSize.height);
+        if (options_.fullFrame && !(tiles.size() == 1 && tiles[0] == frameRect)) {
+            regions.insert(regions.begin(), frameRect);
+        }
+
+        // 区域轮流分配给各副本，每个副本在自己的线程上顺序推理
+        size_t workers = std::min(engines_.size(), regions.size());
+        std::vector<std::vector<cv::Rect>> assigned(workers);
+        for (size_t i = 0; i < regions.size(); i++) {
+            assigned[i % workers].push_back(regions[i]);
+        }
+
+        std::vector<std::future<std::vector<TileDetection>>> futures;
+        futures.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            InferenceEngine* engine = engines_[i].get();
+            futures.push_back(pool_->enqueue([engine, &inputImage, &assigned, i]() {
+                return runRegions(*engine, inputImage, assigned[i]);
+            }));
+        }
+
+        std::vector<TileDetection> boxes;
+        for (auto& future : futures) {
+            auto part = future.get();
+            boxes.insert(boxes.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+
+        // 跨分块 NMS：重叠区域内同一目标的多个框只保留一个
+        candidates_.clear();
+        candidates_.reserve(boxes.size());
+        for (const auto& detection : boxes) {
+            const auto& bbox = detection.box.bbox;
+            candidates_.push(bbox.x, bbox.y, bbox.x + bbox.width, bbox.y + bbox.height,
+                             detection.box.confidence, detection.box.classId);
+        }
+        const auto& keep = postprocessor_.nms(candidates_, nmsOptions_);
+
+        // 截断框与完整框 IoU 低，NMS 无法合并；按分数从高到低，去掉大部分落在已保留同类框内的截断框
+        std::vector<DetectionBox> detections;
+        detections.reserve(keep.size());
+        for (int idx : keep) {
+            const TileDetection& detection = boxes[static_cast<size_t>(idx)];
+            bool duplicate = false;
+            if (detection.truncated) {
+                for (const auto& kept : detections) {
+                    if ((!nmsOptions_.classAware || kept.classId == detection.box.classId) &&
+                        containedRatio(detection.box.bbox, kept.bbox) >= CONTAINED_RATIO) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+            }
+            if (!duplicate) {
+                DetectionBox box = detection.box;
+                box.confidence = candidates_.score[idx];
+                detections.push_back(std::move(box));
+            }
+        }
+
+        result->setDetectionResults(detections);
+        result->setValid(true);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Tiled inference failed: ", e.what());
+    }
+
+    result->setInferenceTime(std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count());
+    return result;
+}
+
+std::string TiledInferenceEngine::getModelInfo() const {
+    std::ostringstream oss;
+    oss << "Tiled Inference Engine (" << engines_.size() << " workers, tile " << tileSize_.width << "x"
+        << tileSize_.height << ", overlap " << options_.overlap << (options_.fullFrame ? ", full frame" : "")
+        << ")\n";
+    if (!engines_.empty()) {
+        oss << engines_.front()->getModelInfo();
+    }
+    return oss.str();
+}
+
+void TiledInferenceEngine::setThreshold(float threshold) {
+    std::lock_guard<std::mutex> lock(inferMutex_);
+    for (auto& engine : engines_) {
+        engine->setThreshold(threshold);
+    }
+}
+
+std::string TiledInferenceEngine::getModelType() const {
+    return engines_.empty() ? "" : engines_.front()->getModelType();
+}
+
+} // namespace inference
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ONNXInference.hpp"
+#include "ThreadPool.hpp"
+#include <opencv2/opencv.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inference {
+
+/**
+ * @brief 分块推理引擎（高分辨率帧上的检测模型）
+ *
+ * 整帧缩放到模型输入尺寸会让小目标只剩几个像素。分块推理把帧切成与模型输入
+ * 同尺寸、相互重叠的分块（ROI，不拷贝像素），每块以原始分辨率推理：
+ *  - 持有 workers 个独立初始化的引擎副本（模型文件以 mmap 加载，权重页由副本共享），
+ *    每个副本在线程池中处理 i, i+workers, ... 号分块，互不加锁
+ *  - 可选额外推理一次缩放后的整帧，检测跨越多个分块的大目标
+ *  - 各分块的检测框平移回整帧坐标后，统一做一次 NMS 合并重叠区域中的重复框；
+ *    被分块内部边界截断的框与完整框的 IoU 可能很低，NMS 后再去掉大部分面积
+ *    落在更高分同类框内的截断框
+ * 重叠宽度应大于需要检测的小目标尺寸，保证每个小目标至少完整落在一个分块内。
+ * 不支持分阶段执行，异步推理时走单线程队列（分块之间已经并行）。
+ * infer 由 inferMutex_ 串行化。
+ */
+class TiledInferenceEngine : public InferenceEngine {
+public:
+    struct Options {
+        cv::Size tileSize;              ///< 分块尺寸（为空时使用模型输入尺寸）
+        float overlap = 0.2f;           ///< 相邻分块的重叠比例 [0, 0.9]
+        bool fullFrame = true;          ///< 额外推理缩放后的整帧
+        int workers = 0;                ///< 引擎副本数（0 表示 CPU 核数）
+    };
+
+    /**
+     * @brief 创建未初始化的引擎副本（默认按 ModelConfig::engineType 由工厂创建）
+     */
+    using EngineFactory = std::function<std::shared_ptr<InferenceEngine>(const ModelConfig&)>;
+
+    TiledInferenceEngine();
+    explicit TiledInferenceEngine(const Options& options, EngineFactory factory = nullptr);
+    ~TiledInferenceEngine() override = default;
+
+    bool initialize(const ModelConfig& config) override;
+    std::shared_ptr<InferenceResult> infer(const cv::Mat& inputImage) override;
+    std::string getModelInfo() const override;
+    void setThreshold(float threshold) override;
+    bool isInitialized() const override { return !engines_.empty(); }
+    std::string getModelType() const override;
+
+    /**
+     * @brief 计算覆盖整帧的分块
+     * 每个方向上步长为 tileSize * (1 - overlap)，最后一块与帧边缘对齐；
+     * 帧小于分块的方向只有一块（与帧同宽/高）
+     */
+    static std::vector<cv::Rect> computeTiles(const cv::Size& frameSize, const cv::Size& tileSize, float overlap);
+
+    /**
+     * @brief 最近一次推理的分块数（不含整帧）
+     */
+    size_t getLastTileCount() const { return lastTileCount_; }
+
+    /**
+     * @brief 引擎副本数
+     */
+    size_t getWorkerCount() const { return engines_.size(); }
+
+private:
+    Options options_;
+    EngineFactory factory_;
+    cv::Size tileSize_;
+    NMSOptions nmsOptions_;
+
+    std::vector<std::shared_ptr<InferenceEngine>> engines_;
+    std::unique_ptr<utils::ThreadPool> pool_;
+
+    std::mutex inferMutex_;
+    DetectionPostprocessor postprocessor_;
+    DetectionCandidates candidates_;
+    size_t lastTileCount_ = 0;
+};
+
+} // namespace inference
@@ -14,7 +14,10 @@
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <filesystem>
 #include "ConfigHelper.hpp"
+#include "ConfigParser.hpp"
+#include "ConfigWatcher.hpp"
 #include "core/PerceptionSystem.hpp"
 #include "Logger.hpp"
 #include "CommunicationProxy.hpp"
@@ -70,13 +73,21 @@ int main() {
         
         // =================== 继续原有逻辑 ===================
         
-        // 添加这里：明确设置关键配置参数
-        config.streamConfig.enableColor = true;
-        config.streamConfig.enableDepth = true;
-        config.renderConfig.enableRendering = true;
-        config.hotPlugConfig.enableHotPlug = true;
-        config.hotPlugConfig.waitForDeviceOnStartup = true;
-        config.inferenceConfig.enablePerformanceStats = true;
+        // 加载配置文件（存在时）；以文件中的设置为准，热加载时不会与启动时的设置不一致
+        const std::string configPath = "config.json";
+        bool configLoaded = std::filesystem::exists(configPath) && ConfigParser::loadFromFile(configPath);
+        
+        // 没有配置文件时明确设置关键配置参数（与 config.json 中的设置相同）
+        if (!configLoaded) {
+            config.update([](ConfigHelper::Snapshot& snapshot) {
+                snapshot.streamConfig.enableColor = true;
+                snapshot.streamConfig.enableDepth = true;
+                snapshot.renderConfig.enableRendering = true;
+                snapshot.hotPlugConfig.enableHotPlug = true;
+                snapshot.hotPlugConfig.waitForDeviceOnStartup = true;
+                snapshot.inferenceConfig.enablePerformanceStats = true;
+            });
+        }
 
         if(!config.validateAll()) {
             LOG_ERROR("Configuration validation failed!");
@@ -86,8 +97,18 @@ int main() {
         // 打印当前配置
             config.printConfig();
         
+        // 配置文件修改后热加载可在运行中生效的设置
+        ConfigWatcher configWatcher(configPath);
+        if (configLoaded) {
+            configWatcher.start();
+        }
+        
         // 初始化通信代理 - 作为服务端
         auto& commProxy = CommunicationProxy::getInstance();
+        CommunicationProxy::Transport transport;
+        if(CommunicationProxy::parseTransport(config.current()->communicationConfig.transport, transport)) {
+            commProxy.setTransport(transport);
+        }
         if(!commProxy.initialize("/tmp/orbbec_camera", CommunicationProxy::CommRole::SERVER)) {
             LOG_ERROR("Failed to initialize CommunicationProxy");
             return -1;
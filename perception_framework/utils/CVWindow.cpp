@@ -28,8 +28,7 @@ CVWindow::CVWindow(std::string name, uint32_t width, uint32_t height, ArrangeMod
       isWindowDestroyed_(false),
       alpha_(0.6f),
       showPrompt_(false),
-      showingNoSignalFrame_(false),
-      lastNoSignalUpdateTime_(std::chrono::steady_clock::now()) {
+      showingNoSignalFrame_(false) {
 
 #if defined(TO_DISABLE_OPENCV_LOG)
     cv::utils::logging::setLogLevel(cv::utils::logging::LogLevel::LOG_LEVEL_SILENT);
@@ -47,6 +46,8 @@ CVWindow::CVWindow(std::string name, uint32_t width, uint32_t height, ArrangeMod
     // start processing thread
     processThread_ = std::thread(&CVWindow::processFrames, this);
 
+    scheduleNoSignalRefresh();
+
     winCreatedTime_ = getNowTimesMs();
 }
 
@@ -61,9 +62,11 @@ void CVWindow::setKeyPressedCallback(std::function<void(int)> callback) {
 
 // 处理窗口事件，但不显示图像
 bool CVWindow::processEvents() {
-    // 自动更新无信号画面的时间戳（如果正在显示无信号画面）
-    checkAndUpdateNoSignalFrame();
-    
+    // 定时器只做标记，无信号画面在窗口线程中重绘
+    if(noSignalRefreshPending_.exchange(false)) {
+        updateNoSignalFrame();
+    }
+
     // 只处理键盘事件，不显示图像
     int key = cv::waitKey(1);
     if(key != -1) {
@@ -132,24 +135,11 @@ cv::Mat CVWindow::getRenderMat() {
     return renderMat_.clone();
 }
 
-// 检查并更新无信号画面时间戳
-void CVWindow::checkAndUpdateNoSignalFrame() {
-    if (showingNoSignalFrame_.load()) {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - lastNoSignalUpdateTime_).count();
-        
-        if (elapsed >= 1) {
-            createNoSignalFrame();
-            std::lock_guard<std::mutex> lock(renderMatsMtx_);
-            if (!noSignalMat_.empty()) {
-                renderMat_ = noSignalMat_.clone();
-            }
-        }
-    }
-}
-
 // close window
 void CVWindow::close() {
+    utils::TimerWheel::getInstance().cancel(noSignalTimer_);
+    noSignalTimer_ = utils::TimerWheel::INVALID_TIMER;
+
     {
         std::lock_guard<std::mutex> lock(renderMatsMtx_);
         closed_ = true;
@@ -182,6 +172,7 @@ void CVWindow::reset() {
     // restart thread
     closed_        = false;
     processThread_ = std::thread(&CVWindow::processFrames, this);
+    scheduleNoSignalRefresh();
 }
 
 // set the window size
@@ -645,9 +636,32 @@ void CVWindow::createNoSignalFrame() {
     
     cv::putText(noSignalMat, timeStr, cv::Point(10, height_ - 10), fontFace, 0.5, cv::Scalar(255, 255, 255), 1);
     
-    // 保存无信号画面
-    noSignalMat_ = noSignalMat.clone();
-    lastNoSignalUpdateTime_ = std::chrono::steady_clock::now();
+    // 保存无信号画面（整体替换，已发布给 renderMat_ 的旧画面不受影响）
+    noSignalMat_ = noSignalMat;
+}
+
+void CVWindow::presentNoSignalFrame() {
+    cv::Mat noSignalMat;
+    {
+        std::lock_guard<std::mutex> lock(noSignalMutex_);
+        noSignalMat = noSignalMat_;
+    }
+    if (noSignalMat.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(renderMatsMtx_);
+    renderMat_ = noSignalMat;
+}
+
+void CVWindow::scheduleNoSignalRefresh() {
+    // 全局时间轮每秒标记一次，由 processEvents 在窗口线程中刷新时间戳，不在定时线程中绘制
+    noSignalTimer_ = utils::TimerWheel::getInstance().schedulePeriodic(
+        std::chrono::milliseconds(1000), [this]() {
+            if (showingNoSignalFrame_.load()) {
+                noSignalRefreshPending_ = true;
+            }
+        });
 }
 
 void CVWindow::showNoSignalFrame() {
@@ -656,16 +670,17 @@ void CVWindow::showNoSignalFrame() {
     }
     
     // 如果还没有无信号画面，先创建一个
-    if (noSignalMat_.empty()) {
+    bool created;
+    {
+        std::lock_guard<std::mutex> lock(noSignalMutex_);
+        created = !noSignalMat_.empty();
+    }
+    if (!created) {
         createNoSignalFrame();
     }
     
     showingNoSignalFrame_ = true;
-    
-    std::lock_guard<std::mutex> lock(renderMatsMtx_);
-    if (!noSignalMat_.empty()) {
-        renderMat_ = noSignalMat_.clone();
-    }
+    presentNoSignalFrame();
 }
 
 void CVWindow::hideNoSignalFrame() {
@@ -679,10 +694,7 @@ bool CVWindow::isShowingNoSignalFrame() const {
 void CVWindow::updateNoSignalFrame() {
     if (showingNoSignalFrame_.load()) {
         createNoSignalFrame();
-        std::lock_guard<std::mutex> lock(renderMatsMtx_);
-        if (!noSignalMat_.empty()) {
-            renderMat_ = noSignalMat_.clone();
-        }
+        presentNoSignalFrame();
     }
 }
 
@@ -14,6 +14,7 @@
 #include <chrono>
 
 #include "utils.hpp"
+#include "TimerWheel.hpp"
 
 namespace ob_smpl {
 
@@ -80,7 +81,7 @@ public:
     void showNoSignalFrame();
     void hideNoSignalFrame();
     bool isShowingNoSignalFrame() const;
-    void updateNoSignalFrame(); // 更新无信号画面（如时间戳）
+    void updateNoSignalFrame(); // 更新无信号画面（如时间戳），在窗口线程中调用
 
 private:
     // frames processing thread function
@@ -99,9 +100,8 @@ private:
 
     // 无信号画面相关方法
     void createNoSignalFrame();
-    
-    // 更新无信号画面时间戳（内部方法）
-    void checkAndUpdateNoSignalFrame();
+    void presentNoSignalFrame();    // 把无信号画面设为当前渲染图像
+    void scheduleNoSignalRefresh(); // 每秒标记一次待刷新
 
 private:
     std::string name_;
@@ -135,9 +135,10 @@ private:
 
     // 无信号画面相关成员变量
     std::atomic<bool> showingNoSignalFrame_;
-    cv::Mat noSignalMat_;
-    std::chrono::steady_clock::time_point lastNoSignalUpdateTime_;
+    cv::Mat noSignalMat_;            // 受 noSignalMutex_ 保护
     std::mutex noSignalMutex_;
+    std::atomic<bool> noSignalRefreshPending_{false};  // 时间戳待刷新（定时器置位，窗口线程清除）
+    utils::TimerWheel::TimerId noSignalTimer_ = utils::TimerWheel::INVALID_TIMER;  // 每秒标记无信号画面待刷新
 };
 
 }  // namespace ob_smpl
@@ -0,0 +1,392 @@
+#include "DepthCodec.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEPTH_CODEC_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DEPTH_CODEC_NEON 1
+#endif
+
+namespace utils {
+
+namespace {
+
+// ==================== 游程扫描（向量化） ====================
+
+/**
+ * @brief 返回从 p 开始的第一个非零像素位置（不存在则返回 end）
+ */
+inline const uint16_t* skipZeros(const uint16_t* p, const uint16_t* end) {
+#if defined(DEPTH_CODEC_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)));
+        if (mask != 0xFFFFu) {
+            return p + (__builtin_ctz(~mask & 0xFFFFu) >> 1);
+        }
+        p += 8;
+    }
+#elif defined(DEPTH_CODEC_NEON)
+    while (end - p >= 8) {
+        uint16x8_t eq = vceqq_u16(vld1q_u16(p), vdupq_n_u16(0));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(eq, 4)), 0);
+        if (mask != ~0ull) {
+            return p + (__builtin_ctzll(~mask) >> 3);
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && *p == 0) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief 返回从 p 开始的第一个零值像素位置（不存在则返回 end）
+ */
+inline const uint16_t* skipNonZeros(const uint16_t* p, const uint16_t* end) {
+#if defined(DEPTH_CODEC_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)));
+        if (mask != 0) {
+            return p + (__builtin_ctz(mask) >> 1);
+        }
+        p += 8;
+    }
+#elif defined(DEPTH_CODEC_NEON)
+    while (end - p >= 8) {
+        uint16x8_t eq = vceqq_u16(vld1q_u16(p), vdupq_n_u16(0));
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(eq, 4)), 0);
+        if (mask != 0) {
+            return p + (__builtin_ctzll(mask) >> 3);
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && *p != 0) {
+        ++p;
+    }
+    return p;
+}
+
+// ==================== 半字节写入/读取 ====================
+
+/**
+ * @brief 半字节写入器：按高位在前的顺序将半字节打包为 32 位字
+ * 调用方保证输出缓冲容量足够（见 maxEncodedSize）
+ */
+class NibbleWriter {
+public:
+    explicit NibbleWriter(uint8_t* out) : out_(out), begin_(out) {}
+
+    // 变长编码：低 3 位先写，最高位为续位标志
+    inline void vle(uint32_t value) {
+        if (value < 8) {
+            append(value, 1);
+        } else if (value < 64) {
+            append((((value & 7u) | 8u) << 4) | (value >> 3), 2);
+        } else {
+            do {
+                uint32_t nibble = value & 7u;
+                value >>= 3;
+                if (value) nibble |= 8u;
+                append(nibble, 1);
+            } while (value);
+        }
+    }
+
+    // 写入 8 个已打包的单半字节编码（高位在前）
+    inline void appendWord(uint32_t word) {
+        acc_ = (acc_ << 32) | word;
+        store(static_cast<uint32_t>(acc_ >> bits_));
+    }
+
+    // 写出剩余半字节，返回已写字节数
+    size_t flush() {
+        if (bits_ > 0) {
+            store(static_cast<uint32_t>(acc_ << (32 - bits_)));
+            bits_ = 0;
+        }
+        return static_cast<size_t>(out_ - begin_);
+    }
+
+private:
+    inline void append(uint32_t code, int count) {
+        acc_ = (acc_ << (4 * count)) | code;
+        bits_ += 4 * count;
+        if (bits_ >= 32) {
+            bits_ -= 32;
+            store(static_cast<uint32_t>(acc_ >> bits_));
+        }
+    }
+
+    inline void store(uint32_t word) {
+        std::memcpy(out_, &word, sizeof(word));
+        out_ += sizeof(word);
+    }
+
+    uint8_t* out_;
+    uint8_t* begin_;
+    uint64_t acc_ = 0;
+    int bits_ = 0;
+};
+
+/**
+ * @brief 半字节读取器：64 位左对齐缓冲，带边界检查
+ */
+class NibbleReader {
+public:
+    NibbleReader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    inline bool vle(uint32_t& value) {
+        value = 0;
+        int shift = 0;
+        uint32_t nibble;
+        do {
+            if (avail_ == 0) {
+                refill();
+                if (avail_ == 0) return false;
+            }
+            nibble = static_cast<uint32_t>(buf_ >> 60);
+            buf_ <<= 4;
+            --avail_;
+            if (shift > 30) return false;  // 超出 32 位，数据损坏
+            value |= (nibble & 7u) << shift;
+            shift += 3;
+        } while (nibble & 8u);
+        return true;
+    }
+
+    // 若接下来 8 个半字节均为单半字节编码，则一次取出
+    inline bool take8(uint32_t& word) {
+        if (avail_ < 8) {
+            refill();
+            if (avail_ < 8) return false;
+        }
+        word = static_cast<uint32_t>(buf_ >> 32);
+        if (word & 0x88888888u) return false;
+        buf_ <<= 32;
+        avail_ -= 8;
+        return true;
+    }
+
+private:
+    inline void refill() {
+        while (avail_ <= 8 && end_ - p_ >= 4) {
+            uint32_t word;
+            std::memcpy(&word, p_, sizeof(word));
+            p_ += 4;
+            buf_ |= static_cast<uint64_t>(word) << (32 - 4 * avail_);
+            avail_ += 8;
+        }
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t buf_ = 0;
+    int avail_ = 0;
+};
+
+inline uint32_t zigzagEncode(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t v) {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1u);
+}
+
+/**
+ * @brief 编码一段非零游程的差分值
+ * 每 8 个像素一组计算 zigzag 差分（可被编译器向量化），
+ * 若整组均可用单个半字节表示则直接拼成一个 32 位字写出
+ */
+inline int32_t encodeDeltaRun(NibbleWriter& writer, const uint16_t* q, const uint16_t* end, int32_t previous) {
+    while (end - q >= 8) {
+        uint32_t zz[8];
+        uint32_t any = 0;
+        for (int k = 0; k < 8; ++k) {
+            int32_t current = q[k];
+            zz[k] = zigzagEncode(current - (k == 0 ? previous : static_cast<int32_t>(q[k - 1])));
+            any |= zz[k];
+        }
+
+        if (any < 8) {
+            writer.appendWord((zz[0] << 28) | (zz[1] << 24) | (zz[2] << 20) | (zz[3] << 16) |
+                              (zz[4] << 12) | (zz[5] << 8) | (zz[6] << 4) | zz[7]);
+        } else {
+            for (int k = 0; k < 8; ++k) {
+                writer.vle(zz[k]);
+            }
+        }
+
+        previous = q[7];
+        q += 8;
+    }
+
+    for (; q < end; ++q) {
+        int32_t current = *q;
+        writer.vle(zigzagEncode(current - previous));
+        previous = current;
+    }
+    return previous;
+}
+
+} // namespace
+
+// ==================== DepthCodec ====================
+
+size_t DepthCodec::maxEncodedSize(int width, int height) {
+    if (width <= 0 || height <= 0) return 0;
+    // 每像素最多 6 个数值半字节 + 游程开销，按 4 字节/像素预留足够余量
+    size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    return sizeof(Header) + pixels * 4 + 16;
+}
+
+size_t DepthCodec::encode(const uint16_t* src, int width, int height,
+                          std::vector<uint8_t>& out, Prediction prediction) {
+    size_t capacity = maxEncodedSize(width, height);
+    if (capacity == 0 || !src) return 0;
+
+    out.resize(capacity);
+    size_t written = encode(src, width, height, out.data(), out.size(), prediction);
+    out.resize(written);
+    return written;
+}
+
+size_t DepthCodec::encode(const uint16_t* src, int width, int height,
+                          uint8_t* dst, size_t dstCapacity, Prediction prediction) {
+    if (!src || !dst || width <= 0 || height <= 0 ||
+        dstCapacity < maxEncodedSize(width, height)) {
+        return 0;
+    }
+
+    const uint16_t* p = src;
+    const uint16_t* end = src + static_cast<size_t>(width) * static_cast<size_t>(height);
+    NibbleWriter writer(dst + sizeof(Header));
+
+    if (prediction == Prediction::PREVIOUS) {
+        int32_t previous = 0;
+        while (p < end) {
+            const uint16_t* runStart = skipZeros(p, end);
+            const uint16_t* runEnd = skipNonZeros(runStart, end);
+            writer.vle(static_cast<uint32_t>(runStart - p));
+            writer.vle(static_cast<uint32_t>(runEnd - runStart));
+            previous = encodeDeltaRun(writer, runStart, runEnd, previous);
+            p = runEnd;
+        }
+    } else {
+        while (p < end) {
+            const uint16_t* runStart = skipZeros(p, end);
+            const uint16_t* runEnd = skipNonZeros(runStart, end);
+            writer.vle(static_cast<uint32_t>(runStart - p));
+            writer.vle(static_cast<uint32_t>(runEnd - runStart));
+            for (const uint16_t* q = runStart; q < runEnd; ++q) {
+                writer.vle(*q);
+            }
+            p = runEnd;
+        }
+    }
+
+    size_t payload = writer.flush();
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.prediction = static_cast<uint16_t>(prediction);
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.payloadBytes = static_cast<uint32_t>(payload);
+    std::memcpy(dst, &header, sizeof(header));
+
+    return sizeof(Header) + payload;
+}
+
+bool DepthCodec::readHeader(const uint8_t* data, size_t size, Header& header) {
+    if (!data || size < sizeof(Header)) return false;
+
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) return false;
+    if (header.prediction > static_cast<uint16_t>(Prediction::PREVIOUS)) return false;
+    if (header.width == 0 || header.height == 0 ||
+        header.width > 65536 || header.height > 65536) return false;
+    if (header.payloadBytes > size - sizeof(Header)) return false;
+    return true;
+}
+
+bool DepthCodec::decode(const uint8_t* data, size_t size,
+                        std::vector<uint16_t>& out, int& width, int& height) {
+    Header header;
+    if (!readHeader(data, size, header)) return false;
+
+    size_t pixels = static_cast<size_t>(header.width) * header.height;
+    out.resize(pixels);
+    if (!decode(data, size, out.data(), out.size())) {
+        out.clear();
+        return false;
+    }
+
+    width = static_cast<int>(header.width);
+    height = static_cast<int>(header.height);
+    return true;
+}
+
+bool DepthCodec::decode(const uint8_t* data, size_t size, uint16_t* dst, size_t dstPixels) {
+    Header header;
+    if (!dst || !readHeader(data, size, header)) return false;
+
+    size_t pixels = static_cast<size_t>(header.width) * header.height;
+    if (dstPixels < pixels) return false;
+
+    NibbleReader reader(data + sizeof(Header), header.payloadBytes);
+    uint16_t* o = dst;
+    uint16_t* end = dst + pixels;
+    bool usePrevious = header.prediction == static_cast<uint16_t>(Prediction::PREVIOUS);
+    int32_t previous = 0;
+
+    while (o < end) {
+        uint32_t zeros = 0;
+        uint32_t nonZeros = 0;
+
+        if (!reader.vle(zeros) || zeros > static_cast<size_t>(end - o)) return false;
+        std::memset(o, 0, zeros * sizeof(uint16_t));
+        o += zeros;
+
+        if (!reader.vle(nonZeros) || nonZeros > static_cast<size_t>(end - o)) return false;
+
+        uint32_t i = 0;
+        uint32_t word = 0;
+        while (i < nonZeros) {
+            // 快速路径：8 个单半字节差分一次解出
+            if (usePrevious && nonZeros - i >= 8 && reader.take8(word)) {
+                for (int k = 0; k < 8; ++k) {
+                    int32_t value = previous + zigzagDecode((word >> (28 - 4 * k)) & 7u);
+                    if (value <= 0 || value > 0xFFFF) return false;
+                    *o++ = static_cast<uint16_t>(value);
+                    previous = value;
+                }
+                i += 8;
+                continue;
+            }
+
+            uint32_t code = 0;
+            if (!reader.vle(code)) return false;
+
+            int32_t value = usePrevious ? previous + zigzagDecode(code) : static_cast<int32_t>(code);
+            // 非零游程中的像素必须是合法的非零 16 位值
+            if (value <= 0 || value > 0xFFFF) return false;
+            *o++ = static_cast<uint16_t>(value);
+            previous = value;
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+} // namespace utils
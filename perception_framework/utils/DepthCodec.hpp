@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief 无损深度图编解码器（RVL: Run-length Variable Length）
+ *
+ * 基于 Wilson 2017 提出的 RVL 算法：交替编码零值游程与非零游程长度，
+ * 非零像素可选地与前一个有效像素做差分预测，差值经 zigzag 映射后
+ * 以 4bit 半字节（3bit 数据 + 1bit 续位）变长编码。
+ *
+ * 游程扫描使用 SSE2 / NEON 向量化，编码结果带自描述头部，
+ * 可直接用于数据保存、录制缓冲以及进程间帧传输。
+ * 纯 CPU 实现，不依赖 OpenCV 与 OrbbecSDK。
+ */
+class DepthCodec {
+public:
+    /**
+     * @brief 非零像素的预测方式
+     */
+    enum class Prediction : uint16_t {
+        NONE = 0,       // 直接编码像素值
+        PREVIOUS = 1    // 与前一个非零像素做差分（标准 RVL）
+    };
+
+    /**
+     * @brief 编码数据头部（小端，紧跟压缩数据）
+     */
+#pragma pack(push, 1)
+    struct Header {
+        uint32_t magic;         // 魔数 "RVL1"
+        uint16_t version;       // 格式版本
+        uint16_t prediction;    // 预测方式
+        uint32_t width;         // 图像宽度
+        uint32_t height;        // 图像高度
+        uint32_t payloadBytes;  // 压缩数据字节数（4字节对齐）
+    };
+#pragma pack(pop)
+
+    static constexpr uint32_t MAGIC = 0x314C5652;  // "RVL1"
+    static constexpr uint16_t VERSION = 1;
+
+    /**
+     * @brief 计算编码结果的最大可能字节数（含头部）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @return 最大字节数
+     */
+    static size_t maxEncodedSize(int width, int height);
+
+    /**
+     * @brief 编码 16 位深度图
+     * @param src 深度数据（行连续，width*height 个像素）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param out 输出缓冲（会被调整为实际编码大小）
+     * @param prediction 预测方式
+     * @return 编码后字节数，失败返回 0
+     */
+    static size_t encode(const uint16_t* src, int width, int height,
+                         std::vector<uint8_t>& out,
+                         Prediction prediction = Prediction::PREVIOUS);
+
+    /**
+     * @brief 编码到调用方提供的缓冲区（容量至少为 maxEncodedSize）
+     * @return 编码后字节数，失败返回 0
+     */
+    static size_t encode(const uint16_t* src, int width, int height,
+                         uint8_t* dst, size_t dstCapacity,
+                         Prediction prediction = Prediction::PREVIOUS);
+
+    /**
+     * @brief 解码深度图
+     * 对输入做完整边界检查，损坏或截断的数据返回 false
+     * @param data 编码数据
+     * @param size 编码数据字节数
+     * @param out 输出深度数据
+     * @param width 输出图像宽度
+     * @param height 输出图像高度
+     * @return 是否成功
+     */
+    static bool decode(const uint8_t* data, size_t size,
+                       std::vector<uint16_t>& out, int& width, int& height);
+
+    /**
+     * @brief 解码到调用方提供的缓冲区（容量至少为 width*height 个像素）
+     * @return 是否成功
+     */
+    static bool decode(const uint8_t* data, size_t size,
+                       uint16_t* dst, size_t dstPixels);
+
+    /**
+     * @brief 读取并校验头部
+     * @return 头部是否有效
+     */
+    static bool readHeader(const uint8_t* data, size_t size, Header& header);
+};
+
+} // namespace utils
@@ -0,0 +1,323 @@
+#include "TimerWheel.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace utils {
+
+TimerWheel& TimerWheel::getInstance() {
+    // 回调可能引用其他单例，进程退出时不析构
+    static TimerWheel* instance = new TimerWheel();
+    return *instance;
+}
+
+TimerWheel::TimerWheel() : origin_(Clock::now()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_ = std::thread(&TimerWheel::run, this);
+    threadId_ = thread_.get_id();
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Task task, Executor executor) {
+    delay = std::max(delay, std::chrono::milliseconds(0));
+    return add(Clock::now() + delay, std::chrono::milliseconds(0), std::move(task), std::move(executor));
+}
+
+TimerWheel::TimerId TimerWheel::schedulePeriodic(std::chrono::milliseconds period, Task task, Executor executor) {
+    period = std::max(period, std::chrono::milliseconds(1));
+    // 对齐到 tick 边界：之后每次触发都落在边界上，没有取整带来的固定延迟
+    Clock::time_point due = origin_ + std::chrono::milliseconds(tickAt(Clock::now() + period));
+    return add(due, period, std::move(task), std::move(executor));
+}
+
+TimerWheel::TimerId TimerWheel::add(Clock::time_point due, std::chrono::milliseconds period, Task task,
+                                    Executor executor) {
+    if (!task) {
+        return INVALID_TIMER;
+    }
+
+    auto timer = std::make_unique<Timer>();
+    timer->due = due;
+    timer->expireTick = tickAt(due);
+    timer->period = period;
+    timer->task = std::make_shared<Task>(std::move(task));
+    timer->executor = std::move(executor);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return INVALID_TIMER;
+    }
+    TimerId id = nextId_++;
+    timer->id = id;
+    place(timer.get());
+    bool earlier = timer->expireTick < wakeTick_;
+    timers_.emplace(id, std::move(timer));
+    if (earlier) {
+        condition_.notify_one();
+    }
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id == INVALID_TIMER) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool found = false;
+    auto it = timers_.find(id);
+    if (it != timers_.end()) {
+        unlink(it->second.get());
+        timers_.erase(it);
+        found = true;
+    }
+    auto queued = std::remove_if(dispatchQueue_.begin(), dispatchQueue_.end(),
+                                 [id](const Dispatch& dispatch) { return dispatch.id == id; });
+    if (queued != dispatchQueue_.end()) {
+        dispatchQueue_.erase(queued, dispatchQueue_.end());
+        found = true;
+    }
+    if (found) {
+        stats_.cancelled++;
+    }
+
+    // 回调正在派发时等待其结束（回调内部取消自身除外）
+    if (std::this_thread::get_id() != threadId_) {
+        dispatchDone_.wait(lock, [this, id] { return runningId_ != id; });
+    }
+    return found;
+}
+
+void TimerWheel::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    condition_.notify_all();
+    if (thread_.joinable() && std::this_thread::get_id() != threadId_) {
+        thread_.join();
+    } else if (thread_.joinable()) {
+        thread_.detach();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_ = {};
+    occupied_ = {};
+    timers_.clear();
+    dispatchQueue_.clear();
+}
+
+TimerWheel::Stats TimerWheel::getStats() const {
+    Stats result;
+    std::vector<int64_t> samples;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = stats_;
+        result.active = timers_.size();
+        samples.assign(lateness_.begin(), lateness_.end());
+    }
+    if (samples.empty()) {
+        return result;
+    }
+
+    double sum = 0.0;
+    for (int64_t sample : samples) {
+        sum += static_cast<double>(sample);
+    }
+    std::sort(samples.begin(), samples.end());
+    result.meanLateUs = sum / samples.size();
+    result.p50LateUs = static_cast<double>(samples[samples.size() / 2]);
+    result.p99LateUs = static_cast<double>(samples[(samples.size() - 1) * 99 / 100]);
+    result.maxLateUs = static_cast<double>(samples.back());
+    return result;
+}
+
+uint64_t TimerWheel::tickAt(Clock::time_point time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    // 向上取整，保证到期 tick 不早于计划时刻
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_).count();
+    return static_cast<uint64_t>((elapsed + 999999) / 1000000);
+}
+
+void TimerWheel::place(Timer* timer) {
+    // 已过期的定时器放入下一个待处理的槽位
+    uint64_t expire = std::max(timer->expireTick, currentTick_);
+    uint64_t delta = expire - currentTick_;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= slotWidth(level + 1)) {
+        level++;
+    }
+    if (delta >= slotWidth(LEVELS)) {
+        // 超出时间轮范围：先停在最高层最远的槽位，下移时重新计算
+        expire = currentTick_ + slotWidth(LEVELS) - 1;
+    }
+
+    int slot = static_cast<int>((expire >> (SLOT_BITS * level)) & (SLOTS - 1));
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = nullptr;
+    timer->next = slots_[level][slot];
+    if (timer->next) {
+        timer->next->prev = timer;
+    }
+    slots_[level][slot] = timer;
+    occupied_[level] |= 1ULL << slot;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        slots_[timer->level][timer->slot] = timer->next;
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    if (!slots_[timer->level][timer->slot]) {
+        occupied_[timer->level] &= ~(1ULL << timer->slot);
+    }
+    timer->prev = timer->next = nullptr;
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+    // 第 0 层槽位在其 tick 到期，更高层槽位在轮转到该槽位时整体下移
+    uint64_t next = NO_TICK;
+    for (int level = 0; level < LEVELS; level++) {
+        uint64_t bits = occupied_[level];
+        if (!bits) {
+            continue;
+        }
+        uint64_t width = slotWidth(level);
+        uint64_t span = slotWidth(level + 1);
+        uint64_t base = currentTick_ & ~(span - 1);
+        while (bits) {
+            int slot = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            uint64_t tick = base + slot * width;
+            if (tick < currentTick_) {
+                tick += span;
+            }
+            next = std::min(next, tick);
+        }
+    }
+    return next;
+}
+
+void TimerWheel::advance(uint64_t tick, Clock::time_point now) {
+    currentTick_ = tick;
+
+    // 从高到低下移，下移到低层的定时器在同一 tick 内继续处理
+    for (int level = LEVELS - 1; level > 0; level--) {
+        if (tick & (slotWidth(level) - 1)) {
+            continue;
+        }
+        int slot = static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+        Timer* timer = slots_[level][slot];
+        slots_[level][slot] = nullptr;
+        occupied_[level] &= ~(1ULL << slot);
+        while (timer) {
+            Timer* next = timer->next;
+            place(timer);
+            timer = next;
+        }
+    }
+
+    int slot = static_cast<int>(tick & (SLOTS - 1));
+    Timer* timer = slots_[0][slot];
+    slots_[0][slot] = nullptr;
+    occupied_[0] &= ~(1ULL << slot);
+    currentTick_ = tick + 1;
+
+    while (timer) {
+        Timer* next = timer->next;
+        dispatchQueue_.push_back(Dispatch{timer->id, timer->due, timer->task, timer->executor});
+        if (timer->period.count() > 0) {
+            // 按计划时刻累加周期，跳过已错过的触发
+            timer->due += timer->period;
+            if (timer->due <= now) {
+                auto missed = (now - timer->due) / timer->period + 1;
+                timer->due += timer->period * missed;
+                stats_.skipped += static_cast<uint64_t>(missed);
+            }
+            timer->expireTick = tickAt(timer->due);
+            place(timer);
+        } else {
+            timers_.erase(timer->id);
+        }
+        timer = next;
+    }
+}
+
+void TimerWheel::dispatchExpired(std::unique_lock<std::mutex>& lock) {
+    while (running_ && !dispatchQueue_.empty()) {
+        Dispatch dispatch = std::move(dispatchQueue_.front());
+        dispatchQueue_.pop_front();
+        runningId_ = dispatch.id;
+
+        auto late = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - dispatch.due).count();
+        lateness_.push_back(late);
+        if (lateness_.size() > LATENESS_WINDOW) {
+            lateness_.pop_front();
+        }
+        stats_.fired++;
+
+        lock.unlock();
+        try {
+            if (dispatch.executor) {
+                std::shared_ptr<Task> task = dispatch.task;
+                dispatch.executor([task]() { (*task)(); });
+            } else {
+                (*dispatch.task)();
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("定时器回调异常: ", e.what());
+        } catch (...) {
+            LOG_ERROR("定时器回调发生未知异常");
+        }
+        lock.lock();
+
+        runningId_ = INVALID_TIMER;
+        dispatchDone_.notify_all();
+    }
+}
+
+void TimerWheel::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        Clock::time_point now = Clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count();
+        uint64_t nowTick = static_cast<uint64_t>(std::max<int64_t>(elapsed, 0));
+
+        // 依次处理所有已到期的槽位，中间没有事件的 tick 直接跳过
+        uint64_t next;
+        while ((next = nextEventTick()) <= nowTick) {
+            advance(next, now);
+        }
+        currentTick_ = std::max(currentTick_, nowTick + 1);
+
+        if (!dispatchQueue_.empty()) {
+            dispatchExpired(lock);
+            continue;
+        }
+
+        wakeTick_ = next;
+        if (next == NO_TICK) {
+            condition_.wait(lock);
+        } else {
+            condition_.wait_until(lock, origin_ + std::chrono::milliseconds(next));
+        }
+        wakeTick_ = NO_TICK;
+        stats_.wakeups++;
+    }
+}
+
+} // namespace utils
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace utils {
+
+/**
+ * @brief 分层时间轮定时器
+ *
+ * 精度 1 ms，4 层 × 64 槽：第 0 层覆盖 64 ms，每上一层的槽宽是下一层的 64 倍，
+ * 共覆盖约 4.7 小时，更远的定时器留在最高层，到期前逐层下移。插入和取消均为 O(1)。
+ *
+ * 单个线程推进时间轮：没有定时器时一直等待，否则只在最近一个非空槽位到期
+ * （或有定时器需要下移）的时刻醒来，不按固定间隔空转。
+ *
+ * 到期的回调交给创建定时器时指定的执行器；未指定时直接在定时线程中执行，
+ * 这类回调必须很快返回，否则会推迟其他定时器。周期定时器按计划时刻累加周期，
+ * 不累积漂移；落后超过一个周期时跳过错过的触发。
+ */
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    using Task = std::function<void()>;
+    using Executor = std::function<void(Task)>;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    /**
+     * @brief 运行统计（延迟 = 实际派发时刻 - 计划时刻，取最近 1024 次）
+     */
+    struct Stats {
+        uint64_t fired = 0;         // 已派发的回调次数
+        uint64_t cancelled = 0;     // 被取消的定时器数
+        uint64_t skipped = 0;       // 周期定时器因落后跳过的触发次数
+        uint64_t wakeups = 0;       // 定时线程醒来次数
+        size_t active = 0;          // 尚未到期的定时器数
+        double meanLateUs = 0.0;
+        double p50LateUs = 0.0;
+        double p99LateUs = 0.0;
+        double maxLateUs = 0.0;
+    };
+
+    /**
+     * @brief 进程级共享实例（首次使用时创建，进程退出时不析构，避免静态析构顺序问题）
+     */
+    static TimerWheel& getInstance();
+
+    TimerWheel();
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief 创建一次性定时器
+     * @param delay 延迟（不足 1 ms 向上取整，回调不会早于计划时刻）
+     * @param task 回调
+     * @param executor 执行回调的执行器，为空时在定时线程中执行
+     * @return 定时器编号，时间轮已停止时返回 INVALID_TIMER
+     */
+    TimerId schedule(std::chrono::milliseconds delay, Task task, Executor executor = nullptr);
+
+    /**
+     * @brief 创建周期定时器，首次触发在一个周期之后
+     * @param period 周期（至少 1 ms）
+     */
+    TimerId schedulePeriodic(std::chrono::milliseconds period, Task task, Executor executor = nullptr);
+
+    /**
+     * @brief 取消定时器
+     *
+     * 返回后回调不会再被派发；若回调正在定时线程中执行（或正在交给执行器），
+     * 会等待其结束，因此不要在持有回调所需的锁时调用。在回调内部取消自身是安全的。
+     * 已交给执行器、尚未执行的回调不受影响。
+     *
+     * @return 定时器仍在等待时返回 true，已触发的一次性定时器或无效编号返回 false
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief 停止定时线程并丢弃所有定时器
+     */
+    void stop();
+
+    /**
+     * @brief 获取运行统计
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief 把回调提交到线程池的执行器
+     */
+    static Executor poolExecutor(ThreadPool& pool) {
+        return [&pool](Task task) { pool.submit(std::move(task)); };
+    }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t NO_TICK = UINT64_MAX;
+    static constexpr size_t LATENESS_WINDOW = 1024;
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 第 level 层一个槽位覆盖的 tick 数
+     */
+    static constexpr uint64_t slotWidth(int level) {
+        return 1ULL << (SLOT_BITS * level);
+    }
+
+    struct Timer {
+        TimerId id = INVALID_TIMER;
+        uint64_t expireTick = 0;
+        Clock::time_point due;
+        std::chrono::milliseconds period{0};     // 0 表示一次性
+        std::shared_ptr<Task> task;
+        Executor executor;
+        Timer* prev = nullptr;                   // 槽位内的双向链表
+        Timer* next = nullptr;
+        int level = 0;
+        int slot = 0;
+    };
+
+    TimerId add(Clock::time_point due, std::chrono::milliseconds period, Task task, Executor executor);
+    uint64_t tickAt(Clock::time_point time) const;
+    void place(Timer* timer);
+    void unlink(Timer* timer);
+    uint64_t nextEventTick() const;
+    void advance(uint64_t tick, Clock::time_point now);
+    void dispatchExpired(std::unique_lock<std::mutex>& lock);
+    void run();
+
+    const Clock::time_point origin_;
+    uint64_t currentTick_ = 0;                   // 下一个待处理的 tick
+    uint64_t wakeTick_ = NO_TICK;                // 定时线程计划醒来的 tick
+    std::array<std::array<Timer*, SLOTS>, LEVELS> slots_{};
+    std::array<uint64_t, LEVELS> occupied_{};    // 各层非空槽位位图
+    std::unordered_map<TimerId, std::unique_ptr<Timer>> timers_;
+    TimerId nextId_ = 1;
+
+    /**
+     * @brief 已到期、等待派发的回调
+     */
+    struct Dispatch {
+        TimerId id;
+        Clock::time_point due;
+        std::shared_ptr<Task> task;
+        Executor executor;
+    };
+    std::deque<Dispatch> dispatchQueue_;
+    TimerId runningId_ = INVALID_TIMER;          // 正在派发的定时器
+    std::thread::id threadId_;
+
+    Stats stats_;
+    std::deque<int64_t> lateness_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;          // 唤醒定时线程
+    std::condition_variable dispatchDone_;       // 通知 cancel() 回调已派发完成
+    bool running_ = true;
+    std::thread thread_;
+};
+
+} // namespace utils
@@ -131,6 +131,7 @@ private:
         LOG_INFO("  6 - 拍照");
         LOG_INFO("  7 - 开始数据采集");
         LOG_INFO("  8 - 停止数据采集");
+        LOG_INFO("  9 - 触发事件录制");
         LOG_INFO("  0 或 q - 退出");
     }
     
@@ -180,6 +181,11 @@ private:
                     sendCommand("STOP_CAPTURE");
                     break;
                     
+                case '9':
+                    LOG_INFO("触发事件录制");
+                    sendCommand("TRIGGER_RECORD:manual");
+                    break;
+                    
                 case '0': case 'q': case 'Q':
                     LOG_INFO("退出程序...");
                     state_ = ControllerState::STOPPING;
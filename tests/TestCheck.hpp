@@ -0,0 +1,49 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file TestCheck.hpp
+ * @brief 单元测试公用的断言、结果汇总与性能测试开关
+ *
+ * 每个测试程序是单独的可执行文件，只包含一次本头文件。
+ * 性能测试段默认不运行（ctest 只跑正确性检查），通过命令行参数 --benchmark
+ * 或环境变量 PERCEPTION_TEST_BENCHMARK=1 开启。
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+inline int g_failures = 0;
+
+// 打印检查结果，失败时计数
+inline void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    if (!condition) {
+        g_failures++;
+    }
+}
+
+// 打印汇总并返回进程退出码
+inline int testSummary() {
+    if (g_failures == 0) {
+        std::cout << "\n=== 测试全部通过 ===" << std::endl;
+        return 0;
+    }
+    std::cout << "\n=== 测试失败: " << g_failures << " ===" << std::endl;
+    return 1;
+}
+
+// 是否运行性能测试段
+inline bool benchmarkEnabled(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            return true;
+        }
+    }
+    const char* env = std::getenv("PERCEPTION_TEST_BENCHMARK");
+    return env && std::strcmp(env, "1") == 0;
+}
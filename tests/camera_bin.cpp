@@ -64,10 +64,12 @@ int main(int argc, char** argv) {
         auto& config = ConfigHelper::getInstance();
         
         // 配置日志系统 - camera_bin 使用文件日志
-        config.loggerConfig.logLevel = Logger::Level::INFO;
-        config.loggerConfig.logDirectory = "./logs/";
-        config.loggerConfig.enableFileLogging = true;  // camera_bin 启用文件日志
-        config.loggerConfig.enableConsole = true;
+        config.update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.loggerConfig.logLevel = Logger::Level::INFO;
+            snapshot.loggerConfig.logDirectory = "./logs/";
+            snapshot.loggerConfig.enableFileLogging = true;  // camera_bin 启用文件日志
+            snapshot.loggerConfig.enableConsole = true;
+        });
         
         // 通过 ConfigHelper 统一初始化日志系统
         if (!config.initializeLogger()) {
@@ -84,35 +86,39 @@ int main(int argc, char** argv) {
         
         LOG_INFO("Configuring camera parameters...");
         
-        // 配置相机参数
-        config.streamConfig.enableColor = true;
-        config.streamConfig.enableDepth = true;
-        config.streamConfig.enableIR = true;
-        config.renderConfig.enableRendering = true;  // 启用窗口渲染
-        config.renderConfig.showFPS = true;
-        config.hotPlugConfig.enableHotPlug = true;
-        config.hotPlugConfig.waitForDeviceOnStartup = true;
-        config.hotPlugConfig.printDeviceEvents = true;
-        config.inferenceConfig.enablePerformanceStats = true;
-        config.saveConfig.enableFrameStats = true;
-        config.saveConfig.enableMetadataConsole = false;  // 禁用元数据控制台显示
-        
-        // 跳过通信代理 - 避免阻塞
+        config.update([skipCommunication](ConfigHelper::Snapshot& snapshot) {
+            // 配置相机参数
+            snapshot.streamConfig.enableColor = true;
+            snapshot.streamConfig.enableDepth = true;
+            snapshot.streamConfig.enableIR = true;
+            snapshot.renderConfig.enableRendering = true;  // 启用窗口渲染
+            snapshot.renderConfig.showFPS = true;
+            snapshot.hotPlugConfig.enableHotPlug = true;
+            snapshot.hotPlugConfig.waitForDeviceOnStartup = true;
+            snapshot.hotPlugConfig.printDeviceEvents = true;
+            snapshot.inferenceConfig.enablePerformanceStats = true;
+            snapshot.saveConfig.enableFrameStats = true;
+            snapshot.saveConfig.enableMetadataConsole = false;  // 禁用元数据控制台显示
+        
+            // 跳过通信代理 - 避免阻塞
+            if (skipCommunication) {
+                snapshot.communicationConfig.enableCommunication = false;
+            }
+        
+            // 配置数据保存
+            snapshot.saveConfig.enableDump = true;
+            snapshot.saveConfig.dumpPath = "./dumps/";
+            snapshot.saveConfig.saveColor = true;
+            snapshot.saveConfig.saveDepth = true;
+            snapshot.saveConfig.saveDepthColormap = true;
+            snapshot.saveConfig.saveIR = true;
+            snapshot.saveConfig.imageFormat = "png";
+            snapshot.saveConfig.maxFramesToSave = 1000;
+        });
         if (skipCommunication) {
-            config.communicationConfig.enableCommunication = false;
             LOG_INFO("Communication proxy disabled by command line option");
         }
         
-        // 配置数据保存
-        config.saveConfig.enableDump = true;
-        config.saveConfig.dumpPath = "./dumps/";
-        config.saveConfig.saveColor = true;
-        config.saveConfig.saveDepth = true;
-        config.saveConfig.saveDepthColormap = true;
-        config.saveConfig.saveIR = true;
-        config.saveConfig.imageFormat = "png";
-        config.saveConfig.maxFramesToSave = 1000;
-        
         // 验证配置
         if (!config.validateAll()) {
             LOG_ERROR("Configuration validation failed!");
@@ -14,25 +14,28 @@ int main() {
         std::cout << "配置加载成功！" << std::endl;
         
         // 显示加载后的配置
-        std::cout << "彩色流启用: " << (config.streamConfig.enableColor ? "是" : "否") << std::endl;
-        std::cout << "深度流启用: " << (config.streamConfig.enableDepth ? "是" : "否") << std::endl;
-        std::cout << "窗口尺寸: " << config.renderConfig.windowWidth 
-                  << "x" << config.renderConfig.windowHeight << std::endl;
-        std::cout << "推理启用: " << (config.inferenceConfig.enableInference ? "是" : "否") << std::endl;
-        std::cout << "标定启用: " << (config.calibrationConfig.enableCalibration ? "是" : "否") << std::endl;
+        auto loaded = config.current();
+        std::cout << "彩色流启用: " << (loaded->streamConfig.enableColor ? "是" : "否") << std::endl;
+        std::cout << "深度流启用: " << (loaded->streamConfig.enableDepth ? "是" : "否") << std::endl;
+        std::cout << "窗口尺寸: " << loaded->renderConfig.windowWidth 
+                  << "x" << loaded->renderConfig.windowHeight << std::endl;
+        std::cout << "推理启用: " << (loaded->inferenceConfig.enableInference ? "是" : "否") << std::endl;
+        std::cout << "标定启用: " << (loaded->calibrationConfig.enableCalibration ? "是" : "否") << std::endl;
     } else {
         std::cout << "配置加载失败！" << std::endl;
     }
     
     // 2. 修改配置
     std::cout << "\n2. 修改配置..." << std::endl;
-    config.streamConfig.colorWidth = 1920;
-    config.streamConfig.colorHeight = 1080;
-    config.inferenceConfig.enableInference = true;
-    config.inferenceConfig.defaultThreshold = 0.8f;
-    config.calibrationConfig.enableCalibration = true;
-    config.calibrationConfig.boardWidth = 11;
-    config.calibrationConfig.boardHeight = 8;
+    config.update([](ConfigHelper::Snapshot& snapshot) {
+        snapshot.streamConfig.colorWidth = 1920;
+        snapshot.streamConfig.colorHeight = 1080;
+        snapshot.inferenceConfig.enableInference = true;
+        snapshot.inferenceConfig.defaultThreshold = 0.8f;
+        snapshot.calibrationConfig.enableCalibration = true;
+        snapshot.calibrationConfig.boardWidth = 11;
+        snapshot.calibrationConfig.boardHeight = 8;
+    });
     
     // 3. 保存配置到新文件
     std::cout << "\n3. 保存修改后的配置..." << std::endl;
@@ -71,12 +74,13 @@ int main() {
     
     if (ConfigParser::loadFromString(partialConfig)) {
         std::cout << "部分配置加载成功！" << std::endl;
-        std::cout << "新的彩色流尺寸: " << config.streamConfig.colorWidth 
-                  << "x" << config.streamConfig.colorHeight << std::endl;
-        std::cout << "红外流启用: " << (config.streamConfig.enableIR ? "是" : "否") << std::endl;
-        std::cout << "标定板尺寸: " << config.calibrationConfig.boardWidth 
-                  << "x" << config.calibrationConfig.boardHeight << std::endl;
-        std::cout << "方格大小: " << config.calibrationConfig.squareSize << "mm" << std::endl;
+        auto loaded = config.current();
+        std::cout << "新的彩色流尺寸: " << loaded->streamConfig.colorWidth 
+                  << "x" << loaded->streamConfig.colorHeight << std::endl;
+        std::cout << "红外流启用: " << (loaded->streamConfig.enableIR ? "是" : "否") << std::endl;
+        std::cout << "标定板尺寸: " << loaded->calibrationConfig.boardWidth 
+                  << "x" << loaded->calibrationConfig.boardHeight << std::endl;
+        std::cout << "方格大小: " << loaded->calibrationConfig.squareSize << "mm" << std::endl;
     } else {
         std::cout << "部分配置加载失败！" << std::endl;
     }
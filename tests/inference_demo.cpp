@@ -18,19 +18,22 @@ int main(int argc, char* argv[]) {
         auto& config = ConfigHelper::getInstance();
         
         // 配置推理系统
-        config.inferenceConfig.enableInference = true;
-        config.inferenceConfig.defaultModel = "demo_model.onnx";
-        config.inferenceConfig.defaultModelType = "classification";
-        config.inferenceConfig.defaultThreshold = 0.5f;
-        config.inferenceConfig.enableVisualization = true;
-        config.inferenceConfig.enablePerformanceStats = true;
-        config.inferenceConfig.asyncInference = false;
+        config.update([](ConfigHelper::Snapshot& snapshot) {
+            snapshot.inferenceConfig.enableInference = true;
+            snapshot.inferenceConfig.defaultModel = "demo_model.onnx";
+            snapshot.inferenceConfig.defaultModelType = "classification";
+            snapshot.inferenceConfig.defaultThreshold = 0.5f;
+            snapshot.inferenceConfig.enableVisualization = true;
+            snapshot.inferenceConfig.enablePerformanceStats = true;
+            snapshot.inferenceConfig.asyncInference = false;
+        
+        });
         
         // 获取推理管理器
         auto& inferenceManager = inference::InferenceManager::getInstance();
         
         // 初始化推理系统
-        auto inferenceConfig = config.inferenceConfig;
+        auto inferenceConfig = config.current()->inferenceConfig;
         
         if (!inferenceManager.initialize(inferenceConfig)) {
             LOG_ERROR("推理管理器初始化失败");
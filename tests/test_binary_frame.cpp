@@ -0,0 +1,298 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_binary_frame.cpp
+ * @brief 二进制消息帧编解码测试程序
+ *
+ * 1. 编码/解码往返：预分配缓冲区编码与 writev 三段描述结果一致，载荷可含分隔符
+ * 2. 文本消息与二进制帧混合的流，按任意长度分段到达
+ * 3. 解码器模糊测试：随机字节、损坏的帧（位翻转、截断、改写长度）混入正常消息
+ * 4. 编码耗时：二进制帧 vs 文本序列化（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "com/BinaryFrame.hpp"
+#include "com/MessageRingBuffer.hpp"
+#include "com/CommunicationProxy.hpp"
+#include "TestCheck.hpp"
+
+static std::string encodeFrame(uint8_t type, uint32_t sequence, const std::string& payload) {
+    FrameHeader header;
+    header.type = type;
+    header.sequence = sequence;
+    header.timestampUs = 1000000ull + sequence;
+    std::string out(BinaryFrame::OVERHEAD + payload.size(), '\0');
+    size_t size = BinaryFrame::encode(&out[0], out.size(), header, payload.data(), payload.size());
+    out.resize(size);
+    return out;
+}
+
+static std::string flatten(const BinaryFrame::IoVec& vec) {
+    std::string out;
+    for (const auto& part : vec.iov) {
+        out.append(static_cast<const char*>(part.iov_base), part.iov_len);
+    }
+    return out;
+}
+
+/**
+ * @brief 按随机长度分段送入接收缓冲区，收集所有输出消息
+ */
+static std::vector<std::string> feed(MessageRingBuffer& buffer, const std::string& stream, std::mt19937& rng) {
+    std::vector<std::string> messages;
+    std::uniform_int_distribution<size_t> chunkDist(1, 300);
+    size_t offset = 0;
+    while (offset < stream.size()) {
+        size_t chunk = std::min(chunkDist(rng), stream.size() - offset);
+        char* dest = buffer.prepareWrite(chunk);
+        if (!dest) {
+            buffer.clear();
+            continue;
+        }
+        std::memcpy(dest, stream.data() + offset, chunk);
+        buffer.commitWrite(chunk);
+        offset += chunk;
+
+        std::string_view message;
+        while (buffer.nextMessage(message)) {
+            messages.emplace_back(message);
+        }
+    }
+    return messages;
+}
+
+static void testRoundTrip() {
+    std::cout << "1. 编码/解码往返" << std::endl;
+
+    check(BinaryFrame::crc32("123456789", 9) == 0xCBF43926u, "CRC-32 标准校验值");
+
+    std::string payload("line1\nline2\n\xA5\x5A binary \0 tail", 28);
+    FrameHeader header;
+    header.type = 5;
+    header.flags = 0x0102;
+    header.sequence = 42;
+    header.timestampUs = 0x0123456789ABCDEFull;
+
+    char buffer[256];
+    size_t size = BinaryFrame::encode(buffer, sizeof(buffer), header, payload.data(), payload.size());
+    check(size == BinaryFrame::OVERHEAD + payload.size(), "编码长度 = 头部 + 载荷 + 校验码");
+
+    FrameHeader decoded;
+    std::string_view decodedPayload;
+    bool ok = BinaryFrame::decode(std::string_view(buffer, size), decoded, decodedPayload);
+    check(ok && decoded.type == 5 && decoded.flags == 0x0102 && decoded.sequence == 42 &&
+          decoded.timestampUs == header.timestampUs && decodedPayload == payload,
+          "解码后头部字段和载荷（含分隔符、魔数、0 字节）不变");
+
+    BinaryFrame::IoVec vec;
+    check(BinaryFrame::prepare(vec, header, payload.data(), payload.size()) &&
+          flatten(vec) == std::string(buffer, size) && vec.iov[1].iov_base == payload.data(),
+          "writev 三段描述与编码结果一致，载荷不拷贝");
+
+    check(BinaryFrame::encode(buffer, 16, header, payload.data(), payload.size()) == 0, "缓冲区不足时编码失败");
+    std::vector<char> large(BinaryFrame::MAX_PAYLOAD + 1);
+    check(!BinaryFrame::prepare(vec, header, large.data(), large.size()), "载荷超过上限时拒绝");
+
+    std::string empty = encodeFrame(1, 7, "");
+    check(BinaryFrame::decode(empty, decoded, decodedPayload) && decodedPayload.empty(), "空载荷");
+
+    std::string corrupted(buffer, size);
+    corrupted[BinaryFrame::HEADER_SIZE + 3] ^= 0x10;
+    check(!BinaryFrame::decode(corrupted, decoded, decodedPayload), "载荷损坏时校验失败");
+    corrupted.assign(buffer, size);
+    corrupted[21] ^= 0x01;
+    size_t frameSize = 0;
+    check(BinaryFrame::scan(corrupted.data(), BinaryFrame::HEADER_SIZE, frameSize) ==
+          BinaryFrame::ScanResult::INVALID, "长度字段损坏时只凭头部即可判定无效");
+}
+
+static void testMixedStream() {
+    std::cout << std::endl << "2. 文本与二进制混合的流" << std::endl;
+
+    std::mt19937 rng(1);
+    std::vector<std::string> expected;
+    std::string stream;
+    for (int i = 0; i < 500; i++) {
+        if (i % 3 == 0) {
+            std::string text = "0:status " + std::to_string(i);
+            expected.push_back(text);
+            stream += text + "\n";
+        } else {
+            std::string payload(static_cast<size_t>(rng() % 2000), '\0');
+            for (auto& c : payload) {
+                c = static_cast<char>(rng());
+            }
+            std::string frame = encodeFrame(5, static_cast<uint32_t>(i), payload);
+            expected.push_back(frame);
+            stream += frame;
+        }
+    }
+
+    MessageRingBuffer buffer(256, 1024 * 1024);
+    auto messages = feed(buffer, stream, rng);
+    check(messages == expected, "500 条混合消息按顺序完整切分");
+    check(buffer.droppedBytes() == 0, "没有丢弃数据");
+
+    auto message = CommunicationProxy::Message::deserialize("2:error text");
+    check(message.type == CommunicationProxy::MessageType::ERROR && message.content == "error text",
+          "文本格式仍可解析");
+}
+
+static void testFuzz() {
+    std::cout << std::endl << "3. 解码器模糊测试" << std::endl;
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+
+    // 3.1 随机字节直接送入解码器（部分以魔数开头，覆盖头部检查之后的路径）
+    int falseAccepts = 0;
+    for (int i = 0; i < 200000; i++) {
+        std::string data(static_cast<size_t>(rng() % 64), '\0');
+        for (auto& c : data) {
+            c = static_cast<char>(byteDist(rng));
+        }
+        if (data.size() >= 3 && i % 2 == 0) {
+            data[0] = static_cast<char>(BinaryFrame::MAGIC0);
+            data[1] = static_cast<char>(BinaryFrame::MAGIC1);
+            data[2] = static_cast<char>(BinaryFrame::VERSION);
+        }
+        FrameHeader header;
+        std::string_view payload;
+        if (BinaryFrame::decode(data, header, payload)) {
+            falseAccepts++;
+        }
+    }
+    check(falseAccepts == 0, "200000 段随机数据无一被误判为有效帧");
+
+    // 3.2 损坏的帧混入正常消息流
+    const int rounds = 200;
+    size_t intactTotal = 0;
+    size_t intactRecovered = 0;
+    bool allValid = true;
+    bool ordered = true;
+    for (int round = 0; round < rounds; round++) {
+        std::vector<std::string> intact;
+        std::string stream;
+        for (int i = 0; i < 50; i++) {
+            std::string payload(static_cast<size_t>(rng() % 300), '\0');
+            for (auto& c : payload) {
+                c = static_cast<char>(byteDist(rng));
+            }
+            std::string frame = encodeFrame(4, static_cast<uint32_t>(round * 100 + i), payload);
+
+            switch (rng() % 6) {
+                case 0:     // 位翻转
+                    frame[rng() % frame.size()] ^= static_cast<char>(1 << (rng() % 8));
+                    break;
+                case 1:     // 截断
+                    frame.resize(rng() % frame.size());
+                    break;
+                case 2:     // 改写长度
+                    frame[20 + rng() % 4] ^= static_cast<char>(1 + rng() % 255);
+                    break;
+                case 3:     // 随机字节
+                    frame.assign(rng() % 40, '\0');
+                    for (auto& c : frame) {
+                        c = static_cast<char>(byteDist(rng));
+                    }
+                    break;
+                default:
+                    intact.push_back(frame);
+                    break;
+            }
+            stream += frame;
+        }
+
+        MessageRingBuffer buffer(128, 64 * 1024);
+        auto messages = feed(buffer, stream, rng);
+
+        // 输出的二进制帧都必须有效，且按顺序属于未损坏的帧
+        size_t next = 0;
+        for (const auto& message : messages) {
+            if (!BinaryFrame::isFrameStart(message.data(), message.size())) {
+                continue;
+            }
+            FrameHeader header;
+            std::string_view payload;
+            allValid = allValid && BinaryFrame::decode(message, header, payload);
+            while (next < intact.size() && intact[next] != message) {
+                next++;
+            }
+            if (next == intact.size()) {
+                ordered = false;
+            } else {
+                intactRecovered++;
+                next++;
+            }
+        }
+        intactTotal += intact.size();
+    }
+
+    double recovery = intactTotal > 0 ? static_cast<double>(intactRecovered) / intactTotal : 0.0;
+    std::cout << "  未损坏的帧恢复 " << intactRecovered << "/" << intactTotal << " ("
+              << std::fixed << std::setprecision(1) << recovery * 100.0 << "%)" << std::endl;
+    check(allValid, "输出的二进制帧全部通过校验");
+    check(ordered, "输出的帧按顺序来自未损坏的帧，不会拼出新帧");
+    check(recovery >= 0.95, "损坏数据之后能重新同步 (>= 95%)");
+}
+
+static void benchmarkEncode() {
+    std::cout << std::endl << "4. 编码耗时" << std::endl;
+
+    const int iterations = 200000;
+    std::string content(256, 'd');
+    std::vector<char> buffer(BinaryFrame::OVERHEAD + content.size());
+    FrameHeader header;
+    header.type = 5;
+
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        header.sequence = static_cast<uint32_t>(i);
+        BinaryFrame::IoVec vec;
+        BinaryFrame::prepare(vec, header, content.data(), content.size());
+        sink += vec.iov[2].iov_len;
+    }
+    double iovNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                   iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        header.sequence = static_cast<uint32_t>(i);
+        sink += BinaryFrame::encode(buffer.data(), buffer.size(), header, content.data(), content.size());
+    }
+    double encodeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                      iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        CommunicationProxy::Message message(CommunicationProxy::MessageType::DATA, content);
+        sink += (message.serialize() + "\n").size();
+    }
+    double textNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                    iterations;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  256 字节载荷: writev 描述 " << iovNs << " ns, 预分配缓冲区编码 " << encodeNs
+              << " ns, 文本序列化 " << textNs << " ns (" << sink % 2 << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== 二进制消息帧测试 ===" << std::endl << std::endl;
+
+    testRoundTrip();
+    testMixedStream();
+    testFuzz();
+    if (benchmarkEnabled(argc, argv)) {
+        benchmarkEncode();
+    }
+
+    return testSummary();
+}
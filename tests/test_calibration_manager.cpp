@@ -0,0 +1,398 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_calibration_manager.cpp
+ * @brief 标定管理器棋盘检测与视角选择测试程序
+ *
+ * 合成棋盘图像（按已知位姿透视投影渲染），角点真值由投影得到。
+ *
+ * 1. 缩小粗检测 + 原分辨率细化与原分辨率直接检测结果一致，且接近真值
+ * 2. 没有棋盘的图像不误检
+ * 3. processFrame 不等待检测：检测线程忙时新帧覆盖旧帧并计入丢弃数
+ * 4. 视角选择：与已采集视角几乎相同的位姿被拒绝，新位置的视角被接受且覆盖增加
+ * 5. 增量估计收敛后在达到 maxFrames 之前结束采集并开始标定
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include "calibration/CalibrationManager.hpp"
+#include "TestCheck.hpp"
+
+using namespace calibration;
+
+namespace {
+
+const cv::Size BOARD_SIZE(9, 6);           // 内角点数
+const float SQUARE_MM = 30.0f;             // 方格边长(毫米)
+const int PLANE_SQUARE_PX = 120;           // 板面纹理上的方格像素
+const cv::Size IMAGE_SIZE(1920, 1080);
+
+// 合成相机内参
+cv::Mat makeCameraMatrix(const cv::Size& size) {
+    cv::Mat K = cv::Mat::eye(3, 3, CV_64F);
+    K.at<double>(0, 0) = 1.25 * size.width * 0.5;
+    K.at<double>(1, 1) = 1.25 * size.width * 0.5;
+    K.at<double>(0, 2) = size.width * 0.5;
+    K.at<double>(1, 2) = size.height * 0.5;
+    return K;
+}
+
+// 板面纹理：四周留一格白边，坐标原点在第一个内角点
+cv::Mat makeBoardPlane() {
+    int cols = BOARD_SIZE.width + 1 + 2;
+    int rows = BOARD_SIZE.height + 1 + 2;
+    cv::Mat plane(rows * PLANE_SQUARE_PX, cols * PLANE_SQUARE_PX, CV_8UC1, cv::Scalar(255));
+    for (int r = 0; r <= BOARD_SIZE.height; r++) {
+        for (int c = 0; c <= BOARD_SIZE.width; c++) {
+            if ((r + c) % 2 == 0) {
+                cv::rectangle(plane, cv::Rect((c + 1) * PLANE_SQUARE_PX, (r + 1) * PLANE_SQUARE_PX,
+                                              PLANE_SQUARE_PX, PLANE_SQUARE_PX),
+                              cv::Scalar(0), cv::FILLED);
+            }
+        }
+    }
+    return plane;
+}
+
+// 板面坐标(毫米) -> 纹理像素坐标（像素中心约定）
+cv::Point2f planePixel(float xMm, float yMm) {
+    return cv::Point2f((xMm / SQUARE_MM + 2.0f) * PLANE_SQUARE_PX - 0.5f,
+                       (yMm / SQUARE_MM + 2.0f) * PLANE_SQUARE_PX - 0.5f);
+}
+
+/**
+ * @brief 按位姿渲染棋盘图像
+ * @param corners 输出的内角点真值
+ */
+cv::Mat renderBoard(const cv::Mat& plane, const cv::Mat& K, const cv::Vec3d& rvec, const cv::Vec3d& tvec,
+                    const cv::Size& size, std::vector<cv::Point2f>& corners) {
+    // 纹理四角对应的板面坐标
+    float left = -2.0f * SQUARE_MM + 0.5f * SQUARE_MM / PLANE_SQUARE_PX;
+    float top = left;
+    float right = left + plane.cols * SQUARE_MM / PLANE_SQUARE_PX;
+    float bottom = top + plane.rows * SQUARE_MM / PLANE_SQUARE_PX;
+    std::vector<cv::Point3f> outline = {
+        {left, top, 0.0f}, {right, top, 0.0f}, {right, bottom, 0.0f}, {left, bottom, 0.0f}};
+    std::vector<cv::Point2f> outlineTexture;
+    for (const auto& p : outline) {
+        outlineTexture.push_back(planePixel(p.x, p.y));
+    }
+    std::vector<cv::Point2f> outlineImage;
+    cv::projectPoints(outline, rvec, tvec, K, cv::Mat(), outlineImage);
+    cv::Mat H = cv::getPerspectiveTransform(outlineTexture, outlineImage);
+
+    cv::Mat image;
+    cv::warpPerspective(plane, image, H, size, cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(150));
+    cv::GaussianBlur(image, image, cv::Size(3, 3), 0);
+
+    std::vector<cv::Point3f> inner;
+    for (int r = 0; r < BOARD_SIZE.height; r++) {
+        for (int c = 0; c < BOARD_SIZE.width; c++) {
+            inner.emplace_back(c * SQUARE_MM, r * SQUARE_MM, 0.0f);
+        }
+    }
+    cv::projectPoints(inner, rvec, tvec, K, cv::Mat(), corners);
+    return image;
+}
+
+double maxDistance(const std::vector<cv::Point2f>& a, const std::vector<cv::Point2f>& b) {
+    if (a.size() != b.size()) {
+        return 1e9;
+    }
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = std::max(worst, static_cast<double>(std::hypot(a[i].x - b[i].x, a[i].y - b[i].y)));
+    }
+    return worst;
+}
+
+// 原分辨率直接检测，细化窗口与 detectChessboard 相同
+bool detectFullResolution(const cv::Mat& gray, std::vector<cv::Point2f>& corners) {
+    if (!cv::findChessboardCorners(gray, BOARD_SIZE, corners,
+                                   cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE)) {
+        return false;
+    }
+    float spacing = std::hypot(corners[1].x - corners[0].x, corners[1].y - corners[0].y);
+    int halfWindow = std::clamp(static_cast<int>(spacing * 0.4f), 3, 11);
+    cv::cornerSubPix(gray, corners, cv::Size(halfWindow, halfWindow), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1));
+    return true;
+}
+
+ConfigHelper::CalibrationConfig makeConfig() {
+    ConfigHelper::CalibrationConfig config;
+    config.boardWidth = BOARD_SIZE.width;
+    config.boardHeight = BOARD_SIZE.height;
+    config.squareSize = SQUARE_MM;
+    config.minInterval = 0.001;
+    config.incrementalCalibration = false;
+    config.saveDirectory = "";
+    return config;
+}
+
+/**
+ * @brief 求平移量，使倾斜 rvec 的棋盘中心投影到图像 (u, v) 处、深度为 z
+ */
+cv::Vec3d translationFor(const cv::Mat& K, const cv::Vec3d& rvec, double u, double v, double z) {
+    cv::Mat R;
+    cv::Rodrigues(rvec, R);
+    cv::Mat center = (cv::Mat_<double>(3, 1) << (BOARD_SIZE.width - 1) * SQUARE_MM * 0.5,
+                      (BOARD_SIZE.height - 1) * SQUARE_MM * 0.5, 0.0);
+    cv::Mat ray = (cv::Mat_<double>(3, 1) << (u - K.at<double>(0, 2)) / K.at<double>(0, 0),
+                   (v - K.at<double>(1, 2)) / K.at<double>(1, 1), 1.0);
+    cv::Mat t = ray * z - R * center;
+    return cv::Vec3d(t.at<double>(0), t.at<double>(1), t.at<double>(2));
+}
+
+/**
+ * @brief 提交一帧并等待检测线程对它做出接受/拒绝判断
+ * @return 判断完成（或采集已结束）
+ */
+bool submitAndWait(CalibrationManager& manager, const cv::Mat& frame) {
+    // 采集间隔按毫秒计
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    CalibrationEstimate before = manager.getCurrentEstimate();
+    if (!manager.processFrame(frame)) {
+        return false;
+    }
+    for (int i = 0; i < 500; i++) {
+        CalibrationEstimate now = manager.getCurrentEstimate();
+        if (now.views + now.rejectedViews > before.views + before.rejectedViews ||
+            manager.getState() != CalibrationState::COLLECTING) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== 标定管理器棋盘检测测试 ===" << std::endl << std::endl;
+
+    cv::Mat plane = makeBoardPlane();
+    cv::Mat K = makeCameraMatrix(IMAGE_SIZE);
+
+    // 1. 缩小检测 + 细化 vs 原分辨率检测
+    std::cout << "1. 缩小检测与原分辨率检测一致" << std::endl;
+    {
+        struct Pose {
+            const char* name;
+            cv::Vec3d rvec;
+            cv::Vec3d tvec;
+        };
+        const Pose poses[] = {
+            {"正对", {0.0, 0.0, 0.0}, {-120.0, -75.0, 550.0}},
+            {"倾斜", {0.35, -0.3, 0.1}, {-60.0, -110.0, 620.0}},
+            {"远处偏角", {-0.2, 0.45, -0.15}, {150.0, 40.0, 900.0}},
+        };
+        for (const auto& pose : poses) {
+            std::vector<cv::Point2f> truth;
+            cv::Mat gray = renderBoard(plane, K, pose.rvec, pose.tvec, IMAGE_SIZE, truth);
+
+            std::vector<cv::Point2f> corners;
+            auto start = std::chrono::steady_clock::now();
+            bool found = CalibrationManager::detectChessboard(gray, BOARD_SIZE, corners, true);
+            double downscaledMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::vector<cv::Point2f> reference;
+            start = std::chrono::steady_clock::now();
+            bool referenceFound = detectFullResolution(gray, reference);
+            double fullMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::string name = pose.name;
+            check(found && corners.size() == truth.size(), name + ": 缩小检测找到全部角点");
+            check(referenceFound, name + ": 原分辨率检测找到棋盘");
+            if (!found || !referenceFound) {
+                continue;
+            }
+            double toReference = maxDistance(corners, reference);
+            double toTruth = maxDistance(corners, truth);
+            std::cout << "    与原分辨率检测最大偏差 " << toReference << " px, 与真值最大偏差 " << toTruth
+                      << " px, 耗时 " << downscaledMs << " ms (原分辨率 " << fullMs << " ms)" << std::endl;
+            check(toReference < 0.2, name + ": 细化结果与原分辨率检测一致 (< 0.2 px)");
+            check(toTruth < 0.35, name + ": 角点接近真值 (< 0.35 px)");
+        }
+
+        // 宽度不超过粗检测上限时不缩小，仍做亚像素细化
+        cv::Size smallSize(640, 480);
+        std::vector<cv::Point2f> truth;
+        cv::Mat gray = renderBoard(plane, makeCameraMatrix(smallSize), {0.1, -0.2, 0.0}, {-120.0, -75.0, 550.0},
+                                   smallSize, truth);
+        std::vector<cv::Point2f> corners;
+        bool found = CalibrationManager::detectChessboard(gray, BOARD_SIZE, corners, true);
+        check(found && maxDistance(corners, truth) < 0.35, "640x480 不缩小时角点接近真值");
+    }
+
+    // 2. 无棋盘
+    std::cout << "\n2. 无棋盘图像不误检" << std::endl;
+    {
+        std::vector<cv::Point2f> corners;
+        cv::Mat blank(IMAGE_SIZE, CV_8UC1, cv::Scalar(128));
+        check(!CalibrationManager::detectChessboard(blank, BOARD_SIZE, corners, true), "均匀图像");
+
+        cv::Mat noise(IMAGE_SIZE, CV_8UC1);
+        cv::RNG rng(11);
+        rng.fill(noise, cv::RNG::UNIFORM, 0, 256);
+        check(!CalibrationManager::detectChessboard(noise, BOARD_SIZE, corners, true), "随机噪声图像");
+    }
+
+    // 3. processFrame 不阻塞
+    std::cout << "\n3. processFrame 不等待检测" << std::endl;
+    {
+        auto& manager = CalibrationManager::getInstance();
+        check(manager.initialize(), "initialize");
+        check(manager.startCalibration(makeConfig()), "startCalibration");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        std::vector<cv::Point2f> truth;
+        cv::Mat gray = renderBoard(plane, K, {0.2, 0.1, 0.0}, {-120.0, -75.0, 600.0}, IMAGE_SIZE, truth);
+        cv::Mat frame;
+        cv::cvtColor(gray, frame, cv::COLOR_GRAY2BGR);
+
+        const int submissions = 200;
+        uint64_t accepted = 0;
+        double maxCallMs = 0.0;
+        for (int i = 0; i < submissions; i++) {
+            auto start = std::chrono::steady_clock::now();
+            if (manager.processFrame(frame)) {
+                accepted++;
+            }
+            maxCallMs = std::max(maxCallMs, std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count());
+            // 采集间隔按毫秒计，留出间隔让每次提交都被接受
+            std::this_thread::sleep_for(std::chrono::microseconds(1100));
+        }
+
+        // 等待检测线程处理完槽位中的最后一帧
+        ChessboardDetectionStats stats;
+        for (int i = 0; i < 200; i++) {
+            stats = manager.getDetectionStats();
+            if (stats.boardsFound + stats.framesDropped >= stats.framesSubmitted) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::cout << "    提交 " << stats.framesSubmitted << ", 丢弃 " << stats.framesDropped << ", 检测到 "
+                  << stats.boardsFound << ", 单次检测 " << stats.lastDetectionMs << " ms, processFrame 最长 "
+                  << maxCallMs << " ms" << std::endl;
+
+        check(stats.framesSubmitted == accepted, "提交计数与 processFrame 返回值一致");
+        check(stats.framesDropped > 0, "检测线程忙时新帧覆盖旧帧并计入丢弃数");
+        check(stats.boardsFound > 0, "检测线程检测到棋盘");
+        check(stats.boardsFound + stats.framesDropped == stats.framesSubmitted, "每个提交的帧要么被检测要么被丢弃");
+        check(maxCallMs < 20.0, "processFrame 只拷贝帧，不等待检测");
+
+        manager.stopCalibration();
+        manager.stop();
+    }
+
+    // 4. 相近位姿被拒绝，新视角增加覆盖
+    std::cout << "\n4. 视角选择" << std::endl;
+    {
+        auto& manager = CalibrationManager::getInstance();
+        auto config = makeConfig();
+        config.minViewDistance = 0.15;
+        check(manager.initialize() && manager.startCalibration(config), "开始采集");
+
+        std::vector<cv::Point2f> truth;
+        cv::Vec3d tilt(0.25, -0.2, 0.0);
+        cv::Mat first = renderBoard(plane, K, tilt, translationFor(K, tilt, 700.0, 400.0, 650.0), IMAGE_SIZE, truth);
+        check(submitAndWait(manager, first), "第一个视角被处理");
+        CalibrationEstimate estimate = manager.getCurrentEstimate();
+        check(estimate.views == 1 && estimate.rejectedViews == 0, "第一个视角被接受");
+        double firstCoverage = estimate.coverage;
+
+        check(submitAndWait(manager, first), "相同画面被处理");
+        estimate = manager.getCurrentEstimate();
+        check(estimate.views == 1 && estimate.rejectedViews == 1, "相同位姿被拒绝");
+
+        cv::Vec3d nearTilt(0.26, -0.2, 0.005);
+        cv::Mat near = renderBoard(plane, K, nearTilt, translationFor(K, nearTilt, 701.0, 401.0, 651.0),
+                                   IMAGE_SIZE, truth);
+        check(submitAndWait(manager, near), "近似画面被处理");
+        estimate = manager.getCurrentEstimate();
+        check(estimate.views == 1 && estimate.rejectedViews == 2, "几乎相同的位姿被拒绝");
+        check(estimate.coverage == firstCoverage, "被拒绝的视角不改变覆盖");
+
+        cv::Vec3d otherTilt(-0.25, 0.3, 0.0);
+        cv::Mat other = renderBoard(plane, K, otherTilt, translationFor(K, otherTilt, 1300.0, 700.0, 650.0),
+                                    IMAGE_SIZE, truth);
+        check(submitAndWait(manager, other), "新视角被处理");
+        estimate = manager.getCurrentEstimate();
+        std::cout << "    覆盖 " << firstCoverage << " -> " << estimate.coverage << std::endl;
+        check(estimate.views == 2 && estimate.rejectedViews == 2, "新位置与倾斜的视角被接受");
+        check(estimate.coverage > firstCoverage, "覆盖增加");
+
+        manager.stopCalibration();
+        manager.stop();
+    }
+
+    // 5. 收敛后提前结束采集
+    std::cout << "\n5. 增量估计收敛后提前结束采集" << std::endl;
+    {
+        auto& manager = CalibrationManager::getInstance();
+        auto config = makeConfig();
+        config.minValidFrames = 6;
+        config.maxFrames = 20;
+        config.incrementalCalibration = true;
+        config.convergenceThreshold = 0.01;
+        check(manager.initialize() && manager.startCalibration(config), "开始采集");
+
+        // 图像上 4x3 个位置，倾斜方向轮换；第二轮换一个深度与倾斜
+        const double us[] = {360.0, 760.0, 1160.0, 1560.0};
+        const double vs[] = {240.0, 540.0, 840.0};
+        const cv::Vec3d tilts[] = {{0.3, 0.0, 0.0}, {0.0, 0.3, 0.05}, {-0.3, 0.0, -0.05},
+                                   {0.0, -0.3, 0.0}, {0.2, 0.2, 0.1}};
+        std::vector<cv::Mat> frames;
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < 12; i++) {
+                cv::Vec3d tilt = tilts[(i + round * 2) % 5] * (round == 0 ? 1.0 : -0.8);
+                double z = round == 0 ? 650.0 : 750.0;
+                std::vector<cv::Point2f> truth;
+                frames.push_back(renderBoard(plane, K, tilt, translationFor(K, tilt, us[i % 4], vs[i / 4], z),
+                                             IMAGE_SIZE, truth));
+            }
+        }
+
+        double lastCoverage = 0.0;
+        bool coverageMonotonic = true;
+        size_t submitted = 0;
+        for (const auto& frame : frames) {
+            if (manager.getState() != CalibrationState::COLLECTING) {
+                break;
+            }
+            submitAndWait(manager, frame);
+            submitted++;
+            double coverage = manager.getCurrentEstimate().coverage;
+            coverageMonotonic = coverageMonotonic && coverage >= lastCoverage;
+            lastCoverage = coverage;
+        }
+
+        // 等待最终标定完成
+        for (int i = 0; i < 600 && manager.getState() == CalibrationState::PROCESSING; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CalibrationEstimate estimate = manager.getCurrentEstimate();
+        std::cout << "    提交 " << submitted << " 帧, 采集 " << estimate.views << " 个视角, 覆盖 "
+                  << estimate.coverage << ", fx=" << estimate.fx << ", fy=" << estimate.fy << std::endl;
+        check(coverageMonotonic && lastCoverage >= 0.5, "覆盖随视角增加");
+        check(estimate.converged, "内参估计收敛");
+        check(estimate.views >= config.minValidFrames && estimate.views < config.maxFrames,
+              "在达到 maxFrames 之前结束采集");
+        check(submitted < frames.size(), "收敛后不再采集新帧");
+        check(std::fabs(estimate.fx - K.at<double>(0, 0)) / K.at<double>(0, 0) < 0.05, "焦距估计接近真值");
+        check(manager.getState() == CalibrationState::COMPLETED, "最终标定完成");
+
+        manager.stop();
+    }
+
+    return testSummary();
+}
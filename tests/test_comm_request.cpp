@@ -0,0 +1,373 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_comm_request.cpp
+ * @brief CommunicationProxy 请求/回复测试程序
+ *
+ * CommunicationProxy 是单例，回复端运行在 fork 出的子进程中（UDS 服务端）。
+ * 1. 请求编号编解码：文本格式 "<type>#<id>:" / "<type>@<id>:"，接收缓冲区能正确切分
+ * 2. 请求/回复：流水线请求按编号匹配、同类型消息按顺序处理、回调中可以注册回调、超时、回调形式
+ * 3. 命令往返延迟：无负载 vs 并发心跳负载
+ * 4. 连接断开时未完成的请求立即失败，不等到超时
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "com/CommunicationProxy.hpp"
+#include "com/MessageRingBuffer.hpp"
+#include "Logger.hpp"
+#include "TestCheck.hpp"
+
+using Message = CommunicationProxy::Message;
+using MessageType = CommunicationProxy::MessageType;
+using Clock = std::chrono::steady_clock;
+
+static double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static void printLatency(const std::string& name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q) { return samples[static_cast<size_t>(q * (samples.size() - 1))]; };
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(1)
+              << " p50 " << std::setw(7) << at(0.50) << " us"
+              << "  p99 " << std::setw(7) << at(0.99) << " us"
+              << "  max " << std::setw(8) << samples.back() << " us" << std::endl;
+}
+
+// ==================== 1. 编解码 ====================
+
+static void testEncoding() {
+    std::cout << "\n1. 请求编号编解码" << std::endl;
+
+    Message request(MessageType::COMMAND, "GET_STATUS");
+    request.requestId = 17;
+    check(request.serialize() == "0#17:GET_STATUS", "请求序列化为 <type>#<id>:");
+
+    Message response(MessageType::STATUS_REPORT, "CURRENT_STATE:RUNNING");
+    response.requestId = 17;
+    response.isResponse = true;
+    check(response.serialize() == "1@17:CURRENT_STATE:RUNNING", "回复序列化为 <type>@<id>:");
+
+    Message decoded = Message::deserialize("1@17:CURRENT_STATE:RUNNING");
+    check(decoded.type == MessageType::STATUS_REPORT && decoded.requestId == 17 && decoded.isResponse &&
+          decoded.content == "CURRENT_STATE:RUNNING", "回复反序列化");
+
+    Message plain = Message::deserialize("3:PING:1");
+    check(plain.requestId == 0 && !plain.isResponse && plain.content == "PING:1", "普通消息编号为 0");
+
+    MessageRingBuffer buffer(64, 4096);
+    const std::string stream = "0#5:START_RUNNING\n1@5:OK\n3:PING:1\n0#:BAD\n2:ERR\n";
+    std::memcpy(buffer.prepareWrite(stream.size()), stream.data(), stream.size());
+    buffer.commitWrite(stream.size());
+    std::vector<std::string> messages;
+    std::string_view message;
+    while (buffer.nextMessage(message, '\n')) {
+        messages.emplace_back(message);
+    }
+    check(messages.size() == 4 && messages[0] == "0#5:START_RUNNING" && messages[1] == "1@5:OK" &&
+          messages[3] == "2:ERR", "接收缓冲区切分带编号的消息，丢弃缺少编号的消息");
+}
+
+// ==================== 回复端（子进程） ====================
+
+static int runResponder(const std::string& basePath) {
+    auto& proxy = CommunicationProxy::getInstance();
+    proxy.setTransport(CommunicationProxy::Transport::UDS);
+    if (!proxy.initialize(basePath, ICommunicationImpl::CommRole::SERVER)) {
+        return 1;
+    }
+
+    std::atomic<bool> exitRequested{false};
+    std::atomic<int> commandIndex{0};
+
+    proxy.registerCallback(MessageType::COMMAND, [&](const Message& message) {
+        if (message.content == "IGNORE") {
+            return;
+        }
+        if (message.content == "EXIT") {
+            proxy.reply(message, MessageType::STATUS_REPORT, "BYE");
+            exitRequested = true;
+            return;
+        }
+        if (message.content == "REGISTER") {
+            // 回调中修改注册表（旧实现在持有注册表锁时调用回调，这里会死锁）
+            proxy.registerCallback(MessageType::METADATA, [](const Message&) {});
+            proxy.reply(message, MessageType::STATUS_REPORT, "REGISTERED");
+            return;
+        }
+        int index = commandIndex++;
+        proxy.reply(message, MessageType::STATUS_REPORT, "ACK:" + std::to_string(index) + ":" + message.content);
+    });
+
+    proxy.registerCallback(MessageType::HEARTBEAT, [&](const Message& message) {
+        proxy.reply(message, MessageType::HEARTBEAT, "PONG:" + message.content);
+    });
+
+    proxy.start();
+    while (!exitRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // 让 BYE 发出后再断开
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    proxy.stop();
+    return 0;
+}
+
+// ==================== 2. 请求/回复 ====================
+
+static void testRequests(CommunicationProxy& proxy) {
+    std::cout << "\n2. 请求/回复" << std::endl;
+
+    // 流水线：先发出全部请求再等待
+    const int PIPELINE = 32;
+    std::vector<std::future<Message>> futures;
+    for (int i = 0; i < PIPELINE; ++i) {
+        futures.push_back(proxy.request(MessageType::COMMAND, "P" + std::to_string(i), 2000));
+    }
+    bool matched = true;
+    bool ordered = true;
+    int firstIndex = -1;
+    for (int i = 0; i < PIPELINE; ++i) {
+        try {
+            Message reply = futures[i].get();
+            std::string suffix = ":P" + std::to_string(i);
+            matched = matched && reply.type == MessageType::STATUS_REPORT &&
+                      reply.content.size() > suffix.size() &&
+                      reply.content.compare(reply.content.size() - suffix.size(), suffix.size(), suffix) == 0;
+            // 回复端按处理顺序编号，同一类型的消息必须按发送顺序处理
+            int index = std::stoi(reply.content.substr(4));
+            if (firstIndex < 0) {
+                firstIndex = index;
+            }
+            ordered = ordered && index == firstIndex + i;
+        } catch (const std::exception& e) {
+            std::cout << "    " << e.what() << std::endl;
+            matched = false;
+        }
+    }
+    check(matched, "流水线请求的回复按编号匹配");
+    check(ordered, "同类型命令按发送顺序处理");
+    check(proxy.pendingRequestCount() == 0, "完成后没有遗留的请求");
+
+    // 回调中注册回调
+    auto registered = proxy.request(MessageType::COMMAND, "REGISTER", 1000);
+    bool registerOk = false;
+    try {
+        registerOk = registered.get().content == "REGISTERED";
+    } catch (const std::exception& e) {
+        std::cout << "    " << e.what() << std::endl;
+    }
+    check(registerOk, "回调执行时不持有注册表锁");
+
+    // 超时
+    auto start = Clock::now();
+    auto ignored = proxy.request(MessageType::COMMAND, "IGNORE", 30);
+    bool timedOut = false;
+    try {
+        ignored.get();
+    } catch (const std::runtime_error&) {
+        timedOut = true;
+    }
+    double waitedMs = elapsedUs(start) / 1000.0;
+    std::cout << "    超时请求在 " << std::fixed << std::setprecision(1) << waitedMs << " ms 后失败" << std::endl;
+    check(timedOut && waitedMs >= 30.0 && waitedMs < 150.0, "请求按时超时");
+
+    // 回调形式
+    std::promise<std::pair<bool, std::string>> done;
+    proxy.request(MessageType::COMMAND, "CALLBACK", 1000, [&done](bool success, const Message& reply) {
+        done.set_value({success, reply.content});
+    });
+    auto result = done.get_future();
+    bool callbackOk = result.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+    if (callbackOk) {
+        auto value = result.get();
+        callbackOk = value.first && value.second.find(":CALLBACK") != std::string::npos;
+    }
+    check(callbackOk, "回调形式的请求");
+}
+
+// ==================== 3. 负载下的往返延迟 ====================
+
+static std::vector<double> measureRoundTrips(CommunicationProxy& proxy, int count) {
+    std::vector<double> samples;
+    samples.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        auto start = Clock::now();
+        try {
+            proxy.request(MessageType::COMMAND, "GET_STATUS", 1000).get();
+            samples.push_back(elapsedUs(start));
+        } catch (const std::exception&) {
+            // 计入失败，由调用方检查样本数
+        }
+    }
+    return samples;
+}
+
+static void testLatencyUnderLoad(CommunicationProxy& proxy) {
+    std::cout << "\n3. 命令往返延迟" << std::endl;
+
+    const int COUNT = 2000;
+    std::vector<double> idle = measureRoundTrips(proxy, COUNT);
+    check(idle.size() == static_cast<size_t>(COUNT), "无负载时全部收到回复");
+    if (!idle.empty()) {
+        printLatency("无负载", idle);
+    }
+
+    // 两个线程持续发送心跳，回复端同步回复 PONG
+    std::atomic<bool> loading{true};
+    std::atomic<uint64_t> heartbeats{0};
+    std::vector<std::thread> load;
+    for (int t = 0; t < 2; ++t) {
+        load.emplace_back([&proxy, &loading, &heartbeats, t]() {
+            uint64_t n = 0;
+            while (loading) {
+                if (proxy.sendMessage(MessageType::HEARTBEAT, "PING:" + std::to_string(t) + ":" + std::to_string(n++))) {
+                    heartbeats++;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+    }
+
+    auto loadStart = Clock::now();
+    std::vector<double> loaded = measureRoundTrips(proxy, COUNT);
+    double loadSeconds = elapsedUs(loadStart) / 1e6;
+    loading = false;
+    for (auto& thread : load) {
+        thread.join();
+    }
+
+    check(loaded.size() == static_cast<size_t>(COUNT), "心跳负载下全部收到回复");
+    if (!loaded.empty()) {
+        std::cout << "  心跳负载 " << static_cast<uint64_t>(heartbeats / loadSeconds) << " 条/秒" << std::endl;
+        printLatency("心跳负载", loaded);
+        check(loaded[static_cast<size_t>(0.99 * (loaded.size() - 1))] < 50000.0, "负载下 p99 低于 50 ms");
+    }
+
+    // 流水线吞吐量：保持 16 个未完成的请求
+    const int WINDOW = 16;
+    auto start = Clock::now();
+    std::vector<std::future<Message>> window;
+    int completed = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        window.push_back(proxy.request(MessageType::COMMAND, "GET_STATUS", 1000));
+        if (window.size() == WINDOW) {
+            for (auto& future : window) {
+                try {
+                    future.get();
+                    completed++;
+                } catch (const std::exception&) {
+                }
+            }
+            window.clear();
+        }
+    }
+    for (auto& future : window) {
+        try {
+            future.get();
+            completed++;
+        } catch (const std::exception&) {
+        }
+    }
+    double seconds = elapsedUs(start) / 1e6;
+    std::cout << "  流水线(" << WINDOW << ") " << static_cast<uint64_t>(completed / seconds) << " 请求/秒" << std::endl;
+    check(completed == COUNT, "流水线请求全部完成");
+}
+
+// ==================== 4. 断开连接 ====================
+
+static void testDisconnect(CommunicationProxy& proxy, pid_t child) {
+    std::cout << "\n4. 断开连接" << std::endl;
+
+    auto orphan = proxy.request(MessageType::COMMAND, "IGNORE", 5000);
+    auto bye = proxy.request(MessageType::COMMAND, "EXIT", 1000);
+    bool byeOk = false;
+    try {
+        byeOk = bye.get().content == "BYE";
+    } catch (const std::exception&) {
+    }
+    check(byeOk, "回复端确认退出");
+
+    auto start = Clock::now();
+    bool failed = false;
+    try {
+        orphan.get();
+    } catch (const std::runtime_error&) {
+        failed = true;
+    }
+    double waitedMs = elapsedUs(start) / 1000.0;
+    std::cout << "    断开后 " << std::fixed << std::setprecision(1) << waitedMs << " ms 请求失败" << std::endl;
+    check(failed && waitedMs < 1000.0, "断开时未完成的请求立即失败");
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "回复端正常退出");
+}
+
+int main() {
+    std::cout << "=== CommunicationProxy 请求/回复测试 ===" << std::endl;
+    Logger::getInstance().initialize(Logger::Level::WARN, true);
+
+    testEncoding();
+
+    const std::string basePath = "/tmp/test_comm_request_" + std::to_string(getpid());
+    const std::string socketPath = basePath + ".sock";
+    unlink(socketPath.c_str());
+
+    pid_t child = fork();
+    if (child < 0) {
+        std::cout << "fork 失败" << std::endl;
+        return 1;
+    }
+    if (child == 0) {
+        _exit(runResponder(basePath));
+    }
+
+    // 等待回复端开始监听
+    struct stat st;
+    for (int i = 0; i < 200 && stat(socketPath.c_str(), &st) != 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    auto& proxy = CommunicationProxy::getInstance();
+    proxy.setTransport(CommunicationProxy::Transport::UDS);
+    bool ready = proxy.initialize(basePath, ICommunicationImpl::CommRole::CLIENT);
+    if (ready) {
+        proxy.start();
+        ready = proxy.waitForConnection(2000);
+    }
+    check(ready, "连接到回复端");
+    if (!ready) {
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+        return 1;
+    }
+
+    // 等待二进制帧协商完成，之后的请求以二进制帧发送
+    for (int i = 0; i < 100 && !proxy.isBinaryFramingActive(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    check(proxy.isBinaryFramingActive(), "二进制帧协商完成");
+
+    testRequests(proxy);
+    testLatencyUnderLoad(proxy);
+    testDisconnect(proxy, child);
+
+    proxy.stop();
+    unlink(socketPath.c_str());
+
+    return testSummary();
+}
@@ -0,0 +1,221 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_config_reload.cpp
+ * @brief 配置快照与热加载测试程序
+ *
+ * 1. 快照发布：publish/update 生成新版本，已发布的快照保持不变，不再被持有的旧快照被释放
+ * 2. 并发读取：写入方不断发布新快照时读取方看到的总是完整一致的快照
+ * 3. 文件热加载：改名替换配置文件后只合并可热加载的设置，其他改动不生效
+ * 4. 拒绝无效配置：解析失败或验证失败时保留当前配置
+ * 5. 事件合并：短时间内的多次写入只重新加载一次
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "config/ConfigHelper.hpp"
+#include "config/ConfigParser.hpp"
+#include "config/ConfigWatcher.hpp"
+#include "TestCheck.hpp"
+
+using Snapshot = ConfigHelper::Snapshot;
+
+/**
+ * @brief 先写临时文件再改名替换（与编辑器保存的方式相同）
+ */
+static void writeConfig(const std::string& path, const std::string& content) {
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp);
+        file << content;
+    }
+    std::filesystem::rename(temp, path);
+}
+
+/**
+ * @brief 等待配置版本超过 version，超时返回 false
+ */
+static bool waitForVersion(uint64_t version, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (ConfigHelper::getInstance().version() > version) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static void testPublish() {
+    std::cout << "\n1. 快照发布" << std::endl;
+    auto& config = ConfigHelper::getInstance();
+
+    uint64_t version = config.update([](Snapshot& snapshot) {
+        snapshot.saveConfig.frameInterval = 7;
+    });
+    ConfigHelper::SnapshotPtr published = config.current();
+    check(published->version == version && published->saveConfig.frameInterval == 7, "update 发布修改后的快照");
+
+    uint64_t updated = config.update([](Snapshot& snapshot) {
+        snapshot.saveConfig.enableDump = !snapshot.saveConfig.enableDump;
+    });
+    check(updated == version + 1, "update 生成下一个版本");
+    check(config.current()->saveConfig.enableDump != published->saveConfig.enableDump, "新快照包含修改");
+    check(published->version == version && published->saveConfig.frameInterval == 7, "已发布的快照保持不变");
+
+    std::weak_ptr<const Snapshot> superseded = config.current();
+    config.update([](Snapshot& snapshot) { snapshot.saveConfig.frameInterval = 8; });
+    check(superseded.expired(), "没有读取方持有的旧快照被释放");
+}
+
+static void testConcurrentReaders() {
+    std::cout << "\n2. 并发读取" << std::endl;
+    auto& config = ConfigHelper::getInstance();
+
+    // 每次同时修改两个字段，读取方检查两者始终一致
+    config.update([](Snapshot& snapshot) {
+        snapshot.saveConfig.frameInterval = 0;
+        snapshot.inferenceConfig.inferenceInterval = 0;
+    });
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::atomic<uint64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; i++) {
+        readers.emplace_back([&]() {
+            uint64_t lastVersion = 0;
+            while (!stop) {
+                ConfigHelper::SnapshotPtr snapshot = config.current();
+                if (snapshot->saveConfig.frameInterval != snapshot->inferenceConfig.inferenceInterval ||
+                    snapshot->version < lastVersion) {
+                    torn++;
+                }
+                lastVersion = snapshot->version;
+                reads++;
+            }
+        });
+    }
+
+    const int updates = 2000;
+    for (int i = 1; i <= updates; i++) {
+        config.update([i](Snapshot& snapshot) {
+            snapshot.saveConfig.frameInterval = i;
+            snapshot.inferenceConfig.inferenceInterval = i;
+        });
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    std::cout << "    " << updates << " 次发布, " << reads.load() << " 次读取" << std::endl;
+    check(torn == 0, "读取方没有看到不一致或回退的快照");
+    check(config.current()->saveConfig.frameInterval == updates, "最后一次发布生效");
+}
+
+static void testFileReload(const std::string& path) {
+    std::cout << "\n3. 文件热加载" << std::endl;
+    auto& config = ConfigHelper::getInstance();
+    config.update([](Snapshot& snapshot) {
+        snapshot.saveConfig.frameInterval = 200;
+        snapshot.inferenceConfig.inferenceInterval = 1;
+    });
+    int colorWidth = config.current()->streamConfig.colorWidth;
+
+    ConfigWatcher watcher(path, 100);
+    check(watcher.start(), "开始监视配置文件");
+
+    uint64_t version = config.version();
+    writeConfig(path, R"({
+  "save": { "enableDump": true, "frameInterval": 5, "saveIR": false, "dumpPath": "/tmp/elsewhere/" },
+  "inference": { "inferenceInterval": 3, "defaultThreshold": 0.7 },
+  "stream": { "colorWidth": 640 },
+  "render": { "showFPS": false }
+})");
+    check(waitForVersion(version, 2000), "配置文件替换后发布新快照");
+
+    ConfigHelper::SnapshotPtr current = config.current();
+    const Snapshot& snapshot = *current;
+    check(snapshot.saveConfig.enableDump && snapshot.saveConfig.frameInterval == 5 && !snapshot.saveConfig.saveIR,
+          "保存开关与帧间隔已生效");
+    check(snapshot.inferenceConfig.inferenceInterval == 3 && snapshot.inferenceConfig.defaultThreshold == 0.7f,
+          "推理间隔与阈值已生效");
+    check(!snapshot.renderConfig.showFPS, "渲染选项已生效");
+    check(snapshot.streamConfig.colorWidth == colorWidth, "流配置需要重启，未生效");
+    check(snapshot.saveConfig.dumpPath != "/tmp/elsewhere/", "保存路径需要重启，未生效");
+    check(watcher.getStats().applied == 1, "加载一次");
+}
+
+static void testRejected(const std::string& path) {
+    std::cout << "\n4. 拒绝无效配置" << std::endl;
+    auto& config = ConfigHelper::getInstance();
+
+    ConfigWatcher watcher(path, 100);
+    watcher.start();
+    uint64_t version = config.version();
+
+    writeConfig(path, R"({ "save": { "frameInterval": 0 } })");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    writeConfig(path, R"({ "save": { "frameInterval": 9, )");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+    check(config.version() == version, "没有发布新快照");
+    check(config.current()->saveConfig.frameInterval == 5, "保留当前配置");
+    check(watcher.getStats().rejected == 2, "验证失败与解析失败各记录一次");
+
+    // 写入与当前相同的设置不发布新快照
+    writeConfig(path, R"({ "save": { "frameInterval": 5 } })");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    check(config.version() == version && watcher.getStats().unchanged == 1, "设置未变化时不发布");
+}
+
+static void testDebounce(const std::string& path) {
+    std::cout << "\n5. 事件合并" << std::endl;
+    auto& config = ConfigHelper::getInstance();
+
+    ConfigWatcher watcher(path, 150);
+    watcher.start();
+    uint64_t version = config.version();
+
+    for (int i = 1; i <= 10; i++) {
+        writeConfig(path, "{ \"save\": { \"frameInterval\": " + std::to_string(10 + i) + " } }");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // 同目录其他文件的改动不触发加载
+    writeConfig(std::filesystem::path(path).replace_filename("other.json").string(), "{}");
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+
+    ConfigWatcher::Stats stats = watcher.getStats();
+    check(config.version() == version + 1, "连续写入只发布一次");
+    check(stats.applied == 1 && stats.unchanged == 0 && stats.rejected == 0, "只重新加载一次");
+    check(config.current()->saveConfig.frameInterval == 20, "使用最后一次写入的内容");
+}
+
+int main() {
+    std::cout << "=== 配置快照与热加载测试 ===" << std::endl;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("config_reload_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::string path = (directory / "config.json").string();
+    writeConfig(path, "{}");
+
+    testPublish();
+    testConcurrentReaders();
+    testFileReload(path);
+    testRejected(path);
+    testDebounce(path);
+
+    std::filesystem::remove_all(directory);
+
+    return testSummary();
+}
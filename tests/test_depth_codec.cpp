@@ -0,0 +1,200 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_depth_codec.cpp
+ * @brief RVL 深度编解码器测试程序
+ *
+ * 1. 往返正确性测试：多种合成深度图（全零、满值、随机、空洞、奇数尺寸等）
+ *    编码后解码必须逐像素一致，损坏/截断数据必须被拒绝且不越界
+ * 2. 吞吐量测试：1280x720 深度图与 PNG(压缩级别1) 对比编码/解码速度与压缩率（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <opencv2/opencv.hpp>
+#include "utils/DepthCodec.hpp"
+#include "TestCheck.hpp"
+
+using utils::DepthCodec;
+
+// 生成接近真实场景的深度图：两个平面 + 传感器噪声 + 空洞区域
+static std::vector<uint16_t> makeSceneDepth(int width, int height, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<uint16_t> depth(static_cast<size_t>(width) * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float value = (x < width / 2) ? 1500.0f + 0.3f * y : 900.0f + 0.2f * x;
+            value += noise(rng);
+            bool hole = std::hypot(x - width / 4, y - height / 3) < height / 12 || x < width / 32;
+            depth[static_cast<size_t>(y) * width + x] = hole ? 0 : static_cast<uint16_t>(std::lround(value));
+        }
+    }
+    return depth;
+}
+
+static bool roundTrip(const std::vector<uint16_t>& depth, int width, int height,
+                      DepthCodec::Prediction prediction) {
+    std::vector<uint8_t> encoded;
+    if (DepthCodec::encode(depth.data(), width, height, encoded, prediction) == 0) {
+        return false;
+    }
+    if (encoded.size() > DepthCodec::maxEncodedSize(width, height)) {
+        return false;
+    }
+
+    std::vector<uint16_t> decoded;
+    int decodedWidth = 0;
+    int decodedHeight = 0;
+    if (!DepthCodec::decode(encoded.data(), encoded.size(), decoded, decodedWidth, decodedHeight)) {
+        return false;
+    }
+    return decodedWidth == width && decodedHeight == height && decoded == depth;
+}
+
+static void testRoundTrip() {
+    std::cout << "\n1. 往返正确性测试" << std::endl;
+
+    std::mt19937 rng(42);
+    const DepthCodec::Prediction predictions[] = {
+        DepthCodec::Prediction::PREVIOUS, DepthCodec::Prediction::NONE
+    };
+
+    for (auto prediction : predictions) {
+        std::string tag = prediction == DepthCodec::Prediction::PREVIOUS ? " (delta)" : " (raw)";
+
+        std::vector<uint16_t> zeros(640 * 480, 0);
+        check(roundTrip(zeros, 640, 480, prediction), "全零图像" + tag);
+
+        std::vector<uint16_t> full(640 * 480, 0xFFFF);
+        check(roundTrip(full, 640, 480, prediction), "满值图像" + tag);
+
+        std::vector<uint16_t> alternating(641 * 3);
+        for (size_t i = 0; i < alternating.size(); i++) {
+            alternating[i] = (i % 2) ? 0 : ((i % 4) ? 1 : 0xFFFF);
+        }
+        check(roundTrip(alternating, 641, 3, prediction), "零/极值交替" + tag);
+
+        std::vector<uint16_t> single(1, 1234);
+        check(roundTrip(single, 1, 1, prediction), "1x1 图像" + tag);
+
+        check(roundTrip(makeSceneDepth(1280, 720, 7), 1280, 720, prediction), "场景深度 1280x720" + tag);
+
+        bool randomOk = true;
+        for (int t = 0; t < 500 && randomOk; t++) {
+            int width = 1 + static_cast<int>(rng() % 67);
+            int height = 1 + static_cast<int>(rng() % 13);
+            std::vector<uint16_t> depth(static_cast<size_t>(width) * height);
+            for (auto& v : depth) {
+                uint32_t mode = rng() % 4;
+                v = mode == 0 ? 0 : (mode == 1 ? 0xFFFF : static_cast<uint16_t>(rng()));
+            }
+            randomOk = roundTrip(depth, width, height, prediction);
+        }
+        check(randomOk, "随机尺寸/随机数据 x500" + tag);
+    }
+}
+
+static void testCorruptData() {
+    std::cout << "\n2. 损坏数据测试" << std::endl;
+
+    int width = 320;
+    int height = 240;
+    auto depth = makeSceneDepth(width, height, 3);
+    std::vector<uint8_t> encoded;
+    DepthCodec::encode(depth.data(), width, height, encoded);
+
+    std::vector<uint16_t> decoded;
+    int w = 0;
+    int h = 0;
+
+    check(!DepthCodec::decode(encoded.data(), sizeof(DepthCodec::Header) - 1, decoded, w, h), "头部截断被拒绝");
+    check(!DepthCodec::decode(encoded.data(), encoded.size() / 2, decoded, w, h), "数据截断被拒绝");
+
+    auto badMagic = encoded;
+    badMagic[0] ^= 0xFF;
+    check(!DepthCodec::decode(badMagic.data(), badMagic.size(), decoded, w, h), "错误魔数被拒绝");
+
+    // 随机翻转比特：不要求一定失败，但不能崩溃；成功时尺寸必须一致
+    std::mt19937 rng(9);
+    bool stable = true;
+    for (int t = 0; t < 2000; t++) {
+        auto corrupted = encoded;
+        corrupted[sizeof(DepthCodec::Header) + rng() % (corrupted.size() - sizeof(DepthCodec::Header))] ^=
+            static_cast<uint8_t>(1u << (rng() % 8));
+        if (DepthCodec::decode(corrupted.data(), corrupted.size(), decoded, w, h)) {
+            stable = stable && decoded.size() == depth.size();
+        }
+    }
+    check(stable, "随机比特翻转 x2000 无越界");
+}
+
+static double measureMs(const std::function<void()>& fn, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+static void benchmark() {
+    std::cout << "\n3. 吞吐量测试 (1280x720, 单线程)" << std::endl;
+
+    const int width = 1280;
+    const int height = 720;
+    const int iterations = 50;
+    const double rawMB = width * height * 2 / (1024.0 * 1024.0);
+    auto depth = makeSceneDepth(width, height, 11);
+
+    // RVL：使用预分配缓冲，避免计入内存分配
+    std::vector<uint8_t> buffer(DepthCodec::maxEncodedSize(width, height));
+    std::vector<uint16_t> decoded(depth.size());
+    size_t rvlSize = 0;
+    double rvlEncodeMs = measureMs([&] {
+        rvlSize = DepthCodec::encode(depth.data(), width, height, buffer.data(), buffer.size());
+    }, iterations);
+    double rvlDecodeMs = measureMs([&] {
+        DepthCodec::decode(buffer.data(), rvlSize, decoded.data(), decoded.size());
+    }, iterations);
+
+    // PNG 压缩级别 1（与 DumpHelper 保存参数一致）
+    cv::Mat depthMat(height, width, CV_16UC1, depth.data());
+    std::vector<uint8_t> png;
+    std::vector<int> params = {cv::IMWRITE_PNG_COMPRESSION, 1};
+    double pngEncodeMs = measureMs([&] { cv::imencode(".png", depthMat, png, params); }, iterations / 5);
+    cv::Mat pngDecoded;
+    double pngDecodeMs = measureMs([&] { pngDecoded = cv::imdecode(png, cv::IMREAD_UNCHANGED); }, iterations / 5);
+
+    auto report = [&](const std::string& name, size_t size, double encMs, double decMs) {
+        std::cout << "  " << std::left << std::setw(6) << name << std::right << std::fixed << std::setprecision(2)
+                  << " 压缩率: " << std::setw(5) << (width * height * 2.0 / size) << "x"
+                  << "  编码: " << std::setw(7) << encMs << " ms (" << std::setw(7) << rawMB / encMs * 1000.0 << " MB/s)"
+                  << "  解码: " << std::setw(7) << decMs << " ms (" << std::setw(7) << rawMB / decMs * 1000.0 << " MB/s)"
+                  << std::endl;
+    };
+    report("RVL", rvlSize, rvlEncodeMs, rvlDecodeMs);
+    report("PNG-1", png.size(), pngEncodeMs, pngDecodeMs);
+
+    check(decoded == depth, "RVL 基准数据往返一致");
+    check(cv::countNonZero(pngDecoded != depthMat) == 0, "PNG 基准数据往返一致");
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== RVL 深度编解码器测试 ===" << std::endl;
+
+    testRoundTrip();
+    testCorruptData();
+    if (benchmarkEnabled(argc, argv)) {
+        benchmark();
+    }
+
+    return testSummary();
+}
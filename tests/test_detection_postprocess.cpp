@@ -0,0 +1,314 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_detection_postprocess.cpp
+ * @brief 检测后处理（YOLO 解码 + NMS）测试程序
+ *
+ * 1. 正确性测试：argmax / 解码 / 标准 NMS（类别无关与类别感知）与逐行朴素实现结果一致，
+ *    Soft-NMS、DIoU-NMS 与 maxDetections 行为符合预期
+ * 2. 性能测试：25200x85 输出，低/高候选密度下与逐行解码 + O(n^2) NMS 对比（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include "inference/DetectionPostprocess.hpp"
+#include "TestCheck.hpp"
+
+using inference::DetectionCandidates;
+using inference::DetectionPostprocessor;
+using inference::NMSMethod;
+using inference::NMSOptions;
+
+// ==================== 朴素参考实现 ====================
+
+// 逐行解码（原 ONNXInferenceEngine::postprocessDetection 的逻辑，去掉 100 框上限）
+static void naiveDecode(const std::vector<float>& output, int numClasses, float threshold,
+                        float scaleX, float scaleY, DetectionCandidates& out) {
+    out.clear();
+    const size_t stride = static_cast<size_t>(numClasses) + 5;
+    const size_t numRows = output.size() / stride;
+    for (size_t i = 0; i < numRows; i++) {
+        const float* row = output.data() + i * stride;
+        float confidence = row[4];
+        if (confidence < threshold) {
+            continue;
+        }
+        int bestClass = 0;
+        float bestScore = 0.0f;
+        for (int j = 0; j < numClasses; j++) {
+            float score = row[5 + j] * confidence;
+            if (score > bestScore) {
+                bestScore = score;
+                bestClass = j;
+            }
+        }
+        if (bestScore > threshold) {
+            float x = row[0] * scaleX;
+            float y = row[1] * scaleY;
+            float w = row[2] * scaleX;
+            float h = row[3] * scaleY;
+            out.push(x - w / 2, y - h / 2, x + w / 2, y + h / 2, bestScore, bestClass);
+        }
+    }
+}
+
+// O(n^2) 标准 NMS
+static std::vector<int> naiveNms(const DetectionCandidates& c, float threshold, bool classAware) {
+    std::vector<int> indices(c.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&](int a, int b) { return c.score[a] > c.score[b]; });
+
+    std::vector<bool> suppressed(c.size(), false);
+    std::vector<int> result;
+    for (size_t i = 0; i < indices.size(); i++) {
+        int a = indices[i];
+        if (suppressed[a]) continue;
+        result.push_back(a);
+        for (size_t j = i + 1; j < indices.size(); j++) {
+            int b = indices[j];
+            if (suppressed[b] || (classAware && c.classId[a] != c.classId[b])) continue;
+            float iw = std::max(0.0f, std::min(c.x2[a], c.x2[b]) - std::max(c.x1[a], c.x1[b]));
+            float ih = std::max(0.0f, std::min(c.y2[a], c.y2[b]) - std::max(c.y1[a], c.y1[b]));
+            float inter = iw * ih;
+            float uni = (c.x2[a] - c.x1[a]) * (c.y2[a] - c.y1[a]) +
+                        (c.x2[b] - c.x1[b]) * (c.y2[b] - c.y1[b]) - inter;
+            if (uni > 0 && inter / uni > threshold) {
+                suppressed[b] = true;
+            }
+        }
+    }
+    return result;
+}
+
+// ==================== 合成数据 ====================
+
+/**
+ * @brief 生成 YOLO 格式输出
+ * @param density objectness 通过阈值的行比例
+ * 通过的行围绕少量目标中心聚集，模拟同一目标的多个候选框
+ */
+static std::vector<float> makeYoloOutput(size_t numRows, int numClasses, float density, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    std::normal_distribution<float> jitter(0.0f, 0.01f);
+
+    const size_t stride = static_cast<size_t>(numClasses) + 5;
+    std::vector<float> output(numRows * stride);
+
+    const int numObjects = 40;
+    std::vector<float> objX(numObjects), objY(numObjects), objW(numObjects), objH(numObjects);
+    std::vector<int> objClass(numObjects);
+    for (int k = 0; k < numObjects; k++) {
+        objX[k] = 0.1f + 0.8f * uni(rng);
+        objY[k] = 0.1f + 0.8f * uni(rng);
+        objW[k] = 0.03f + 0.15f * uni(rng);
+        objH[k] = 0.03f + 0.15f * uni(rng);
+        objClass[k] = static_cast<int>(uni(rng) * numClasses) % numClasses;
+    }
+
+    for (size_t i = 0; i < numRows; i++) {
+        float* row = output.data() + i * stride;
+        bool positive = uni(rng) < density;
+        int k = static_cast<int>(uni(rng) * numObjects) % numObjects;
+        row[0] = objX[k] + jitter(rng);
+        row[1] = objY[k] + jitter(rng);
+        row[2] = objW[k] * (1.0f + 5.0f * jitter(rng));
+        row[3] = objH[k] * (1.0f + 5.0f * jitter(rng));
+        row[4] = positive ? 0.5f + 0.5f * uni(rng) : 0.3f * uni(rng);
+        for (int j = 0; j < numClasses; j++) {
+            row[5 + j] = 0.2f * uni(rng);
+        }
+        if (positive) {
+            row[5 + objClass[k]] = 0.6f + 0.4f * uni(rng);
+        }
+    }
+    return output;
+}
+
+static bool sameCandidates(const DetectionCandidates& a, const DetectionCandidates& b) {
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2 &&
+           a.score == b.score && a.classId == b.classId;
+}
+
+// ==================== 正确性测试 ====================
+
+static void testArgmax() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+    bool ok = true;
+    for (int count = 1; count <= 100 && ok; count++) {
+        std::vector<float> data(count);
+        for (auto& v : data) v = std::round(uni(rng) * 20.0f);   // 制造相同最大值
+        float maxValue = 0.0f;
+        int idx = DetectionPostprocessor::argmax(data.data(), count, maxValue);
+        int expected = static_cast<int>(std::max_element(data.begin(), data.end()) - data.begin());
+        ok = idx == expected && maxValue == data[expected];
+    }
+    check(ok, "argmax 与 std::max_element 一致（含相同最大值）");
+}
+
+static void testDecode() {
+    DetectionPostprocessor postprocessor;
+    bool ok = true;
+    for (uint32_t seed = 1; seed <= 5 && ok; seed++) {
+        // 行数不是 4 的倍数，覆盖尾部处理
+        auto output = makeYoloOutput(1003, 80, 0.1f * seed, seed);
+        DetectionCandidates expected, actual;
+        naiveDecode(output, 80, 0.5f, 640.0f, 480.0f, expected);
+        postprocessor.decodeYolo(output.data(), 1003, 80, 0.5f, 640.0f, 480.0f, actual);
+        ok = sameCandidates(expected, actual) && expected.size() > 0;
+    }
+    check(ok, "解码结果与逐行实现一致");
+
+    // 类别数不是 4 的倍数
+    auto output = makeYoloOutput(517, 3, 0.3f, 11);
+    DetectionCandidates expected, actual;
+    naiveDecode(output, 3, 0.4f, 1.0f, 1.0f, expected);
+    postprocessor.decodeYolo(output.data(), 517, 3, 0.4f, 1.0f, 1.0f, actual);
+    check(sameCandidates(expected, actual), "3 类别解码结果一致");
+}
+
+static void testHardNms() {
+    DetectionPostprocessor postprocessor;
+    bool agnosticOk = true;
+    bool awareOk = true;
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        auto output = makeYoloOutput(4000, 5, 0.2f, seed);
+        DetectionCandidates candidates;
+        postprocessor.decodeYolo(output.data(), 4000, 5, 0.5f, 640.0f, 640.0f, candidates);
+
+        NMSOptions options;
+        options.classAware = false;
+        auto expected = naiveNms(candidates, options.iouThreshold, false);
+        agnosticOk = agnosticOk && postprocessor.nms(candidates, options) == expected;
+
+        options.classAware = true;
+        expected = naiveNms(candidates, options.iouThreshold, true);
+        awareOk = awareOk && postprocessor.nms(candidates, options) == expected;
+    }
+    check(agnosticOk, "类别无关 NMS 与 O(n^2) 实现一致");
+    check(awareOk, "类别感知 NMS 与 O(n^2) 实现一致");
+
+    DetectionCandidates empty;
+    check(postprocessor.nms(empty, NMSOptions()).empty(), "空输入");
+}
+
+static void testNmsVariants() {
+    DetectionPostprocessor postprocessor;
+
+    // 两个同类别重叠框 (IoU = 0.6)，一个其他类别的重叠框
+    DetectionCandidates base;
+    base.push(0, 0, 100, 100, 0.9f, 0);
+    base.push(0, 25, 100, 125, 0.8f, 0);
+    base.push(0, 0, 100, 100, 0.7f, 1);
+
+    DetectionCandidates c = base;
+    NMSOptions options;
+    auto keep = postprocessor.nms(c, options);
+    check(keep == std::vector<int>({0, 2}), "标准 NMS：同类别重叠框被抑制，不同类别保留");
+
+    c = base;
+    options.maxDetections = 1;
+    keep = postprocessor.nms(c, options);
+    check(keep == std::vector<int>({0}), "maxDetections 限制输出数量");
+    options.maxDetections = 0;
+
+    c = base;
+    options.method = NMSMethod::SOFT_LINEAR;
+    keep = postprocessor.nms(c, options);
+    check(keep.size() == 3 && std::fabs(c.score[1] - 0.8f * 0.4f) < 1e-5f,
+          "线性 Soft-NMS：重叠框保留并按 (1 - IoU) 衰减");
+    check(keep == std::vector<int>({0, 2, 1}), "Soft-NMS 输出按衰减后分数排序");
+
+    c = base;
+    options.method = NMSMethod::SOFT_GAUSSIAN;
+    options.minScore = 0.5f;
+    keep = postprocessor.nms(c, options);
+    check(keep == std::vector<int>({0, 2}), "高斯 Soft-NMS：衰减后低于 minScore 的框被删除");
+    options.minScore = 0.001f;
+
+    // 中心距离大的相交框：IoU 高于阈值但 DIoU 低于阈值
+    DetectionCandidates far;
+    far.push(0, 0, 100, 100, 0.9f, 0);
+    far.push(15, 20, 115, 120, 0.8f, 0);   // IoU ≈ 0.515, DIoU ≈ 0.493
+    options.method = NMSMethod::HARD;
+    c = far;
+    check(postprocessor.nms(c, options).size() == 1, "标准 NMS 抑制 IoU=0.515 的框");
+    options.method = NMSMethod::DIOU;
+    c = far;
+    check(postprocessor.nms(c, options).size() == 2, "DIoU-NMS 因中心距离保留该框");
+    check(NMSOptions::parseMethod("diou") == NMSMethod::DIOU &&
+          NMSOptions::parseMethod("soft_linear") == NMSMethod::SOFT_LINEAR &&
+          NMSOptions::parseMethod("unknown") == NMSMethod::HARD, "方法名称解析");
+}
+
+// ==================== 性能测试 ====================
+
+template <typename Func>
+static double measureMs(int iterations, Func&& func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        func();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+static void benchmark(const char* label, float density, int iterations) {
+    const size_t numRows = 25200;
+    const int numClasses = 80;
+    auto output = makeYoloOutput(numRows, numClasses, density, 42);
+
+    DetectionCandidates naiveCandidates;
+    size_t naiveKept = 0;
+    double naiveMs = measureMs(iterations, [&]() {
+        naiveDecode(output, numClasses, 0.5f, 640.0f, 640.0f, naiveCandidates);
+        naiveKept = naiveNms(naiveCandidates, 0.5f, false).size();
+    });
+
+    DetectionPostprocessor postprocessor;
+    DetectionCandidates candidates;
+    NMSOptions options;
+    size_t kept = 0;
+    double decodeMs = measureMs(iterations, [&]() {
+        postprocessor.decodeYolo(output.data(), numRows, numClasses, 0.5f, 640.0f, 640.0f, candidates);
+    });
+    double totalMs = measureMs(iterations, [&]() {
+        postprocessor.decodeYolo(output.data(), numRows, numClasses, 0.5f, 640.0f, 640.0f, candidates);
+        kept = postprocessor.nms(candidates, options).size();
+    });
+
+    std::cout << "  " << std::left << std::setw(10) << label << std::right
+              << " 候选: " << std::setw(6) << candidates.size()
+              << "  逐行+O(n^2): " << std::setw(8) << naiveMs << " ms (保留 " << naiveKept << ")"
+              << "  新实现: " << std::setw(7) << totalMs << " ms (解码 " << decodeMs
+              << " ms, 保留 " << kept << ")"
+              << "  加速: " << std::setprecision(1) << naiveMs / std::max(totalMs, 1e-6) << "x"
+              << std::setprecision(3) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "=== 检测后处理测试 ===" << std::endl << std::endl;
+
+    std::cout << "1. 正确性测试" << std::endl;
+    testArgmax();
+    testDecode();
+    testHardNms();
+    testNmsVariants();
+
+    if (benchmarkEnabled(argc, argv)) {
+        std::cout << std::endl << "2. 性能对比 (25200 x 85)" << std::endl;
+        benchmark("低密度", 0.005f, 50);
+        benchmark("高密度", 0.2f, 5);
+    }
+
+    return testSummary();
+}
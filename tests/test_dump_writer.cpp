@@ -0,0 +1,277 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_dump_writer.cpp
+ * @brief 数据保存写盘后端测试程序
+ *
+ * 1. 正确性测试：两种后端写入的文件大小与内容必须与提交数据一致（含 O_DIRECT 尾块截断）
+ * 2. 保存会话：分片目录、openat 写入、最大帧数与滚动删除配额，
+ *    写盘队列跨越大量分片时旧分片句柄保持有效；空闲数据流的当前分片不阻塞配额清理，
+ *    仍被持有的分片在最后一个引用释放后删除
+ * 3. 性能对比：模拟数据保存负载（彩色PNG/深度/元数据混合），对比 threadpool 与 io_uring（性能测试，--benchmark 时运行）
+ *    的持续吞吐(MB/s)与 P99 写入延迟
+ *
+ * 用法: test_dump_writer [输出目录] [文件数] [fsync(0/1)]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ctime>
+#include "core/DumpWriter.hpp"
+#include "core/DumpSession.hpp"
+#include "Logger.hpp"
+#include "TestCheck.hpp"
+
+static std::vector<uint8_t> makePayload(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    std::mt19937 rng(seed);
+    for (auto& b : data) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+static bool fileMatches(const std::string& path, const std::vector<uint8_t>& expected) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return content == expected;
+}
+
+static void testCorrectness(const std::string& backend, const std::string& dir) {
+    DumpWriter::Options options;
+    options.maxInFlight = 4;
+    options.bufferSize = 64 * 1024;
+    options.directThreshold = 16 * 1024;
+    auto writer = DumpWriter::create(backend, options);
+
+    // 覆盖空文件、未对齐尾块、多分块等情况
+    const size_t sizes[] = {0, 1, 4095, 4096, 16 * 1024 + 3, 64 * 1024, 300 * 1024 + 17};
+    std::vector<std::vector<uint8_t>> payloads;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        payloads.push_back(makePayload(sizes[i], static_cast<uint32_t>(i)));
+        auto copy = payloads.back();
+        writer->write(dir + "/" + backend + "_" + std::to_string(i) + ".bin", std::move(copy));
+    }
+    writer->flush();
+
+    bool allMatch = true;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        allMatch = allMatch && fileMatches(dir + "/" + backend + "_" + std::to_string(i) + ".bin", payloads[i]);
+    }
+    check(allMatch, std::string(writer->name()) + " 写入内容一致");
+    check(writer->getStats().failures == 0, std::string(writer->name()) + " 无写入失败");
+}
+
+static size_t countFiles(const std::string& dir) {
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file()) count++;
+    }
+    return count;
+}
+
+static void testSession(const std::string& backend, const std::string& dir) {
+    // 时间格式化与 strftime 一致
+    uint64_t us = 1700000000123456ULL;
+    char formatted[20];
+    DumpSession::formatTime(us, formatted);
+    time_t seconds = static_cast<time_t>(us / 1000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char expected[32];
+    std::strftime(expected, sizeof(expected), "%Y%m%d_%H%M%S_123", &local);
+    check(std::string(formatted) == expected, "formatTime 与 strftime 一致");
+
+    DumpSession::Options sessionOptions;
+    sessionOptions.rootPath = dir + "/";
+    sessionOptions.filesPerDir = 10;
+    sessionOptions.maxFrames = 100;
+    sessionOptions.quotaMB = 1;
+
+    auto writer = DumpWriter::create(backend, DumpWriter::Options{});
+    uint64_t accepted = 0;
+    std::string sessionPath;
+    {
+        DumpSession session(sessionOptions);
+        check(session.open(), "创建会话目录");
+        sessionPath = session.path();
+
+        // 120 帧 x 64KB，每帧一个文件：前 100 帧被接受，分布在 10 个分片中
+        for (int i = 0; i < 120; i++) {
+            DumpSession::Slot slot;
+            if (!session.acquire("Color", us + static_cast<uint64_t>(i) * 1000, 1, slot)) continue;
+            accepted++;
+            writer->write(slot.dirFd, "frame_" + std::to_string(i) + ".bin", makePayload(64 * 1024, i), slot.shard);
+            session.addBytes(slot.shardId, 64 * 1024);
+        }
+        writer->flush();
+
+        auto stats = session.getStats();
+        check(accepted == 100 && stats.framesRejected == 20, "maxFrames 限制保存帧数");
+        check(stats.bytesSaved <= 1024 * 1024, "会话占用不超过配额");
+        check(stats.shardsDeleted > 0, "超出配额时删除最旧分片 (删除: " + std::to_string(stats.shardsDeleted) + ")");
+    }
+    // 会话析构时等待后台删除完成
+    size_t files = countFiles(sessionPath);
+    check(files > 0 && files <= 1024 * 1024 / (64 * 1024) + 10, "磁盘文件数符合配额 (文件: " + std::to_string(files) + ")");
+    check(writer->getStats().failures == 0, std::string(writer->name()) + " openat 写入无失败");
+    std::filesystem::remove_all(sessionPath);
+
+    // 每个分片一个文件，单个在途请求：排队的写请求跨越几十个已切换的分片，会话先于写完析构
+    DumpWriter::Options queuedOptions;
+    queuedOptions.maxInFlight = 1;
+    queuedOptions.maxQueued = 256;
+    auto queued = DumpWriter::create(backend, queuedOptions);
+    sessionOptions.filesPerDir = 1;
+    sessionOptions.maxFrames = 0;
+    sessionOptions.quotaMB = 0;
+    {
+        DumpSession session(sessionOptions);
+        session.open();
+        sessionPath = session.path();
+        for (int i = 0; i < 64; i++) {
+            DumpSession::Slot slot;
+            if (session.acquire("Depth", us + static_cast<uint64_t>(i) * 1000, 1, slot)) {
+                queued->write(slot.dirFd, "frame_" + std::to_string(i) + ".bin", makePayload(256 * 1024, i), slot.shard);
+            }
+        }
+    }
+    queued->flush();
+
+    size_t shards = 0;
+    bool onePerShard = true;
+    for (const auto& entry : std::filesystem::directory_iterator(sessionPath + "Depth")) {
+        shards++;
+        onePerShard = onePerShard && countFiles(entry.path().string()) == 1;
+    }
+    check(queued->getStats().failures == 0 && shards == 64 && onePerShard,
+          std::string(queued->name()) + " 分片切换后排队的写请求仍写入原分片");
+    std::filesystem::remove_all(sessionPath);
+}
+
+static void testQuotaRelease(const std::string& dir) {
+    const uint64_t us = 1700000000ull * 1000000;
+    DumpSession::Options options;
+    options.rootPath = dir + "/";
+    options.filesPerDir = 1;
+    options.quotaMB = 1;
+
+    std::string sessionPath;
+    std::string depthShard;
+    std::string heldShard;
+    DumpSession::Slot held;
+    {
+        DumpSession session(options);
+        session.open();
+        sessionPath = session.path();
+
+        // Depth 只保存一帧后空闲：它的当前分片是最旧的分片
+        DumpSession::Slot idle;
+        session.acquire("Depth", us, 1, idle);
+        session.addBytes(idle.shardId, 64 * 1024);
+        depthShard = std::filesystem::directory_iterator(sessionPath + "Depth")->path().string();
+
+        // Color 的第一个分片由模拟的在途写请求持有
+        session.acquire("Color", us, 1, held);
+        session.addBytes(held.shardId, 64 * 1024);
+        heldShard = std::filesystem::directory_iterator(sessionPath + "Color")->path().string();
+
+        for (int i = 1; i < 40; i++) {
+            DumpSession::Slot slot;
+            session.acquire("Color", us + static_cast<uint64_t>(i) * 1000, 1, slot);
+            session.addBytes(slot.shardId, 64 * 1024);
+        }
+
+        auto stats = session.getStats();
+        check(stats.bytesSaved <= 1024 * 1024 && stats.shardsDeleted > 0,
+              "空闲数据流的当前分片不阻塞配额清理 (删除: " + std::to_string(stats.shardsDeleted) + ")");
+        check(std::filesystem::exists(depthShard), "不删除空闲数据流的当前分片");
+        check(std::filesystem::exists(heldShard), "仍被持有的分片暂不删除");
+
+        // 最后一个引用释放时提交删除，会话析构时等待删除完成
+        held = DumpSession::Slot();
+    }
+    check(!std::filesystem::exists(heldShard), "引用释放后删除分片");
+    std::filesystem::remove_all(sessionPath);
+}
+
+static void benchmark(const std::string& backend, const std::string& dir, int files, bool sync) {
+    DumpWriter::Options options;
+    options.syncOnClose = sync;
+    auto writer = DumpWriter::create(backend, options);
+
+    // 每帧：彩色PNG(~1.2MB) + 深度RVL(~450KB) + 元数据(~2KB)
+    auto color = makePayload(1200 * 1024, 1);
+    auto depth = makePayload(450 * 1024, 2);
+    auto meta = makePayload(2 * 1024, 3);
+
+    writer->resetStats();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < files; i++) {
+        std::string base = dir + "/" + backend + "_bench_" + std::to_string(i % 64);
+        auto c = color;
+        auto d = depth;
+        auto m = meta;
+        writer->write(base + "_color.png", std::move(c));
+        writer->write(base + "_depth.rvl", std::move(d));
+        writer->write(base + "_meta.txt", std::move(m));
+    }
+    writer->flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto stats = writer->getStats();
+    std::cout << "  " << std::left << std::setw(10) << writer->name() << std::right << std::fixed
+              << std::setprecision(1)
+              << " 文件: " << std::setw(5) << stats.filesWritten
+              << "  吞吐: " << std::setw(7) << stats.bytesWritten / (1024.0 * 1024.0) / seconds << " MB/s"
+              << std::setprecision(2)
+              << "  P50: " << std::setw(7) << stats.p50LatencyMs << " ms"
+              << "  P99: " << std::setw(7) << stats.p99LatencyMs << " ms"
+              << "  失败: " << stats.failures << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // 位置参数: [目录] [帧数] [fsync]，--benchmark 可出现在任意位置
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) != "--benchmark") {
+            args.push_back(argv[i]);
+        }
+    }
+    std::string dir = args.size() > 0 ? args[0] : "./dump_writer_test";
+    int frames = args.size() > 1 ? std::stoi(args[1]) : 300;
+    bool sync = args.size() > 2 && args[2] == "1";
+
+    Logger::getInstance().initialize(Logger::Level::WARN, true);
+    std::filesystem::create_directories(dir);
+
+    std::cout << "=== 写盘后端测试 ===" << std::endl;
+
+    std::cout << "\n1. 正确性测试" << std::endl;
+    testCorrectness("threadpool", dir);
+    testCorrectness("io_uring", dir);
+
+    std::cout << "\n2. 保存会话" << std::endl;
+    testSession("threadpool", dir);
+    testSession("io_uring", dir);
+    testQuotaRelease(dir);
+
+    if (benchmarkEnabled(argc, argv)) {
+        std::cout << "\n3. 性能对比 (" << frames << " 帧 x 3 文件, fsync: " << (sync ? "开" : "关")
+                  << ", 目录: " << dir << ")" << std::endl;
+        benchmark("threadpool", dir, frames, sync);
+        benchmark("io_uring", dir, frames, sync);
+    }
+
+    std::filesystem::remove_all(dir);
+
+    return testSummary();
+}
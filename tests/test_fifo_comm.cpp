@@ -0,0 +1,372 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_fifo_comm.cpp
+ * @brief FIFO 通信与接收缓冲区测试程序
+ *
+ * 1. MessageRingBuffer：跨读取拆分的消息、一次读取多条消息、数据回移、扩容、超长消息
+ * 2. 同一进程内建立一对 FIFO（服务端 + 客户端），消息按顺序完整到达；
+ *    单次接收读取的字节数有上限，管道中剩余的数据下次调用直接读取；
+ *    管道写满时可合并消息不等待，每个 key 只保留最新一条，消息不被截断
+ * 3. 往返延迟：epoll 阻塞等待 vs 原轮询方式（非阻塞读 + 10ms 休眠）
+ * 4. 吞吐量：大量小消息，每次唤醒处理的消息数（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "com/FifoComm.hpp"
+#include "com/MessageRingBuffer.hpp"
+#include "TestCheck.hpp"
+
+static void append(MessageRingBuffer& buffer, const std::string& data) {
+    char* dest = buffer.prepareWrite(data.size());
+    if (dest) {
+        std::memcpy(dest, data.data(), data.size());
+        buffer.commitWrite(data.size());
+    }
+}
+
+static void testRingBuffer() {
+    std::cout << "1. 接收缓冲区" << std::endl;
+
+    MessageRingBuffer buffer(64, 1024);
+    std::string_view message;
+
+    append(buffer, "0:hel");
+    check(!buffer.nextMessage(message), "不完整的消息不返回");
+    append(buffer, "lo\n1:a\n2:");
+    check(buffer.nextMessage(message) && message == "0:hello", "跨两次读取的消息拼接完整");
+    check(buffer.nextMessage(message) && message == "1:a", "一次读取中的多条消息依次返回");
+    check(!buffer.nextMessage(message) && buffer.size() == 2, "剩余半条消息保留");
+
+    // 填满尾部空间，触发把剩余数据移回起始位置
+    append(buffer, std::string(40, 'x') + "\n");
+    check(buffer.nextMessage(message) && message == "2:" + std::string(40, 'x'), "回移后消息内容不变");
+    check(buffer.size() == 0 && buffer.capacity() == 64, "取完后不扩容");
+
+    std::string longMessage = "3:" + std::string(300, 'y');
+    append(buffer, longMessage + "\n");
+    check(buffer.nextMessage(message) && message == longMessage && buffer.capacity() >= 300, "长消息自动扩容");
+
+    check(buffer.prepareWrite(2048) == nullptr, "超过最大容量时拒绝写入");
+    buffer.clear();
+    check(buffer.size() == 0 && buffer.prepareWrite(16) != nullptr, "清空后可继续写入");
+}
+
+/**
+ * @brief 同一进程内的一对 FIFO 端点
+ */
+struct FifoPair {
+    std::unique_ptr<FifoCommImpl> server;
+    std::unique_ptr<FifoCommImpl> client;
+
+    bool open(const std::string& basePath) {
+        server = std::make_unique<FifoCommImpl>(basePath, FifoCommImpl::CommRole::SERVER);
+        client = std::make_unique<FifoCommImpl>(basePath, FifoCommImpl::CommRole::CLIENT);
+
+        // 服务端阻塞等待客户端打开管道，放到单独线程
+        std::atomic<bool> serverOk{false};
+        std::thread serverThread([&]() { serverOk = server->initialize(FifoCommImpl::CommRole::SERVER); });
+
+        struct stat st;
+        for (int i = 0; i < 200 && (stat((basePath + "_in").c_str(), &st) != 0 ||
+                                    stat((basePath + "_out").c_str(), &st) != 0); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        bool clientOk = client->initialize(FifoCommImpl::CommRole::CLIENT);
+        serverThread.join();
+        return serverOk && clientOk;
+    }
+};
+
+/**
+ * @brief 回显线程：服务端收到的每条消息原样发回
+ */
+class EchoServer {
+public:
+    EchoServer(FifoCommImpl& comm, bool legacyPolling) : comm_(comm) {
+        thread_ = std::thread([this, legacyPolling]() {
+            while (running_) {
+                if (legacyPolling) {
+                    // 原 CommunicationProxy 接收循环：每轮最多 10 条，之后休眠 10ms
+                    std::string message;
+                    for (int i = 0; i < 10 && comm_.receiveMessage(message); i++) {
+                        comm_.sendMessage(message);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                } else {
+                    comm_.receiveMessages([this](std::string_view message) {
+                        comm_.sendMessage(std::string(message));
+                    }, 100);
+                }
+            }
+        });
+    }
+
+    ~EchoServer() {
+        running_ = false;
+        comm_.interruptReceive();
+        thread_.join();
+    }
+
+private:
+    FifoCommImpl& comm_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+/**
+ * @brief 测量往返延迟(微秒)，返回排序后的样本
+ */
+static std::vector<double> measureRoundTrips(FifoCommImpl& client, int iterations, bool legacyPolling) {
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+
+    for (int i = 0; i < iterations; i++) {
+        std::string request = "0:ping " + std::to_string(i);
+        auto start = std::chrono::steady_clock::now();
+        client.sendMessage(request);
+
+        bool received = false;
+        auto deadline = start + std::chrono::seconds(2);
+        while (!received && std::chrono::steady_clock::now() < deadline) {
+            if (legacyPolling) {
+                std::string reply;
+                received = client.receiveMessage(reply) && reply == request;
+                if (!received) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            } else {
+                client.receiveMessages([&](std::string_view reply) { received = received || reply == request; }, 100);
+            }
+        }
+        if (!received) {
+            break;
+        }
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+static void printLatency(const std::string& name, const std::vector<double>& samples) {
+    if (samples.empty()) {
+        std::cout << "  " << name << ": 无样本" << std::endl;
+        return;
+    }
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << name << ": 平均 " << sum / samples.size() << " us, p50 " << samples[samples.size() / 2]
+              << " us, p99 " << samples[samples.size() * 99 / 100] << " us" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== FIFO 通信测试 ===" << std::endl << std::endl;
+
+    testRingBuffer();
+
+    std::cout << std::endl << "2. 建立连接与消息顺序" << std::endl;
+    FifoPair pair;
+    std::string basePath = "/tmp/test_fifo_comm_" + std::to_string(getpid());
+    bool connected = pair.open(basePath);
+    check(connected, "服务端与客户端建立连接");
+    if (!connected) {
+        return testSummary();
+    }
+
+    {
+        const int count = 1000;
+        for (int i = 0; i < count; i++) {
+            pair.client->sendMessage("4:" + std::to_string(i));
+        }
+
+        int received = 0;
+        bool ordered = true;
+        int wakeups = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (received < count && std::chrono::steady_clock::now() < deadline) {
+            int n = pair.server->receiveMessages([&](std::string_view message) {
+                ordered = ordered && message == "4:" + std::to_string(received);
+                received++;
+            }, 100);
+            wakeups += n > 0 ? 1 : 0;
+        }
+        check(received == count && ordered, "1000 条消息按顺序完整到达");
+        check(wakeups < count, "一次唤醒处理多条消息 (" + std::to_string(wakeups) + " 次唤醒)");
+
+        std::string single;
+        pair.client->sendMessage("0:a");
+        pair.client->sendMessage("0:b");
+        pair.server->setReceiveTimeout(500);
+        bool first = pair.server->receiveMessage(single) && single == "0:a";
+        bool second = pair.server->receiveMessage(single) && single == "0:b";
+        check(first && second, "receiveMessage 逐条返回，剩余消息留在缓冲区");
+
+        // receiveMessage 读到一条完整消息即返回，管道中剩余数据不会再触发边沿事件
+        const int burst = 40;
+        const std::string filler(1000, 'q');
+        for (int i = 0; i < burst; i++) {
+            pair.client->sendMessage("6:" + std::to_string(i) + ":" + filler);
+        }
+        int burstReceived = 0;
+        auto burstStart = std::chrono::steady_clock::now();
+        while (burstReceived < burst && pair.server->receiveMessage(single) &&
+               single == "6:" + std::to_string(burstReceived) + ":" + filler) {
+            burstReceived++;
+        }
+        double burstMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - burstStart).count();
+        check(burstReceived == burst && burstMs < 400.0, "receiveMessage 逐条读取管道中的剩余数据，不等待新事件");
+
+        // 写端持续写入时，单次 receiveMessages 仍会返回
+        {
+            const int streamCount = 4096;
+            std::thread writer([&]() {
+                for (int i = 0; i < streamCount; i++) {
+                    pair.client->sendMessage("7:" + filler);
+                }
+            });
+            int streamed = 0;
+            size_t maxBytesPerCall = 0;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (streamed < streamCount && std::chrono::steady_clock::now() < deadline) {
+                size_t bytes = 0;
+                streamed += std::max(0, pair.server->receiveMessages([&](std::string_view message) {
+                    bytes += message.size() + 1;
+                }, 100));
+                maxBytesPerCall = std::max(maxBytesPerCall, bytes);
+            }
+            writer.join();
+            std::cout << "    单次调用最多处理 " << maxBytesPerCall << " 字节" << std::endl;
+            check(streamed == streamCount, "持续写入的 " + std::to_string(streamCount) + " 条消息全部到达");
+            check(maxBytesPerCall <= 256 * 1024 + 16 * 1024, "单次 receiveMessages 读取的字节数有上限");
+        }
+
+        // 对端不读时 sendCoalesced 不等待，可写后由接收线程写出排队的消息
+        {
+            const std::string payload(4000, 'c');
+            const int perKey = 200;
+            bool accepted = true;
+            double maxCallMs = 0.0;
+            for (int i = 0; i < perKey; i++) {
+                for (int key = 1; key <= 2; key++) {
+                    std::string message = "8:" + std::to_string(key) + ":" + std::to_string(i) + ":" + payload + "\n";
+                    iovec iov;
+                    iov.iov_base = message.data();
+                    iov.iov_len = message.size();
+                    auto callStart = std::chrono::steady_clock::now();
+                    accepted = pair.server->sendCoalesced(&iov, 1, static_cast<uint32_t>(key)) && accepted;
+                    maxCallMs = std::max(maxCallMs, std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - callStart).count());
+                }
+            }
+
+            int last[3] = {-1, -1, -1};
+            int delivered = 0;
+            bool intact = true;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+            while ((last[1] != perKey - 1 || last[2] != perKey - 1) && std::chrono::steady_clock::now() < deadline) {
+                pair.server->receiveMessages([](std::string_view) {}, 1);
+                pair.client->receiveMessages([&](std::string_view message) {
+                    size_t seqEnd = message.find(':', 4);
+                    if (message.substr(0, 2) != "8:" || seqEnd == std::string_view::npos) {
+                        intact = false;
+                        return;
+                    }
+                    int key = message[2] - '0';
+                    int seq = std::stoi(std::string(message.substr(4, seqEnd - 4)));
+                    intact = intact && (key == 1 || key == 2) && seq > last[key] && message.substr(seqEnd + 1) == payload;
+                    if (key == 1 || key == 2) {
+                        last[key] = seq;
+                    }
+                    delivered++;
+                }, 1);
+            }
+            std::cout << "    发送 " << 2 * perKey << " 条，送达 " << delivered << " 条，替换 "
+                      << pair.server->coalescedMessages() << " 条，单次调用最长 " << maxCallMs << " ms" << std::endl;
+            check(accepted && maxCallMs < 5.0, "管道写满时 sendCoalesced 不等待");
+            check(intact && last[1] == perKey - 1 && last[2] == perKey - 1, "消息完整有序，每个 key 的最后一条送达");
+            check(pair.server->coalescedMessages() > 0 && delivered < 2 * perKey, "写不下的旧消息被同 key 的新消息替换");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread waker([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            pair.server->interruptReceive();
+        });
+        int n = pair.server->receiveMessages([](std::string_view) {}, 5000);
+        double waitedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        waker.join();
+        check(n == 0 && waitedMs < 1000.0, "interruptReceive 唤醒阻塞的接收");
+    }
+
+    std::cout << std::endl << "3. 往返延迟" << std::endl;
+    {
+        std::vector<double> epollSamples;
+        std::vector<double> legacySamples;
+        {
+            EchoServer echo(*pair.server, false);
+            epollSamples = measureRoundTrips(*pair.client, 2000, false);
+        }
+        {
+            EchoServer echo(*pair.server, true);
+            legacySamples = measureRoundTrips(*pair.client, 30, true);
+        }
+        // 切换模式时可能残留回显消息
+        pair.client->receiveMessages([](std::string_view) {}, 50);
+
+        printLatency("epoll 阻塞等待", epollSamples);
+        printLatency("轮询 + 10ms 休眠", legacySamples);
+        check(epollSamples.size() == 2000 && legacySamples.size() == 30, "所有请求都收到回复");
+        check(!epollSamples.empty() && !legacySamples.empty() &&
+              epollSamples[epollSamples.size() / 2] < legacySamples[legacySamples.size() / 2],
+              "阻塞等待的延迟低于轮询");
+    }
+
+    if (benchmarkEnabled(argc, argv)) {
+        std::cout << std::endl << "4. 吞吐量" << std::endl;
+        const int count = 200000;
+        const std::string payload = "5:" + std::string(62, 'p');
+        std::atomic<int> received{0};
+        std::atomic<int> wakeups{0};
+
+        std::thread reader([&]() {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+            while (received < count && std::chrono::steady_clock::now() < deadline) {
+                int n = pair.server->receiveMessages([&](std::string_view) { received++; }, 100);
+                wakeups += n > 0 ? 1 : 0;
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            pair.client->sendMessage(payload);
+        }
+        reader.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  " << count << " 条 " << payload.size() + 1 << " 字节消息: " << count / seconds / 1000.0
+                  << " k 条/秒, " << count * (payload.size() + 1) / seconds / (1024.0 * 1024.0) << " MB/秒" << std::endl;
+        std::cout << "  唤醒 " << wakeups << " 次, 平均每次 " << static_cast<double>(received) / std::max(1, wakeups.load())
+                  << " 条" << std::endl;
+        check(received == count, "所有消息都已接收");
+    }
+
+    pair.client->cleanup();
+    pair.server->cleanup();
+
+    return testSummary();
+}
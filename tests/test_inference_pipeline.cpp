@@ -0,0 +1,219 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_inference_pipeline.cpp
+ * @brief 三级推理流水线测试程序
+ *
+ * 使用各阶段固定耗时的模拟引擎：
+ * 1. 正确性：帧按提交顺序完成，每帧结果与串行 infer 相同，失败帧回调 nullptr
+ * 2. 吞吐量：与逐帧串行执行三个阶段对比，并输出各阶段统计
+ * 3. 最新帧优先：每个模型的输入槽位只被同一模型的新帧覆盖，各模型完成的最后一帧是最后提交的帧
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include "inference/InferencePipeline.hpp"
+#include "TestCheck.hpp"
+
+using namespace inference;
+
+/**
+ * @brief 模拟结果：记录帧序号
+ */
+class FakeResult : public InferenceResult {
+public:
+    explicit FakeResult(int value) : value_(value) {}
+    double getInferenceTime() const override { return 0.0; }
+    bool isValid() const override { return true; }
+    std::string getSummary() const override { return std::to_string(value_); }
+    int value() const { return value_; }
+
+private:
+    int value_;
+};
+
+/**
+ * @brief 模拟引擎：各阶段休眠固定时间，帧序号按提交顺序通过 enqueueIndex 传入
+ * 序号为负数时预处理失败
+ */
+class FakeEngine : public InferenceEngine {
+public:
+    explicit FakeEngine(int stageMs) : stageMs_(stageMs) {}
+
+    bool initialize(const ModelConfig&) override { return true; }
+    std::string getModelInfo() const override { return "fake"; }
+    void setThreshold(float) override {}
+    bool isInitialized() const override { return true; }
+    std::string getModelType() const override { return "fake"; }
+
+    std::shared_ptr<InferenceResult> infer(const cv::Mat& image) override {
+        InferenceTensors tensors;
+        if (!preprocess(image, tensors) || !execute(tensors)) {
+            return nullptr;
+        }
+        return postprocess(tensors);
+    }
+
+    bool supportsStages() const override { return true; }
+
+    bool preprocess(const cv::Mat&, InferenceTensors& tensors) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(stageMs_));
+        tensors.input.assign(1, static_cast<float>(pendingIndex()));
+        return tensors.input[0] >= 0;
+    }
+
+    bool execute(InferenceTensors& tensors) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(stageMs_));
+        tensors.output.assign(1, tensors.input[0] * 2.0f);
+        return true;
+    }
+
+    std::shared_ptr<InferenceResult> postprocess(InferenceTensors& tensors) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(stageMs_));
+        return std::make_shared<FakeResult>(static_cast<int>(tensors.output[0]) + 1);
+    }
+
+    // 提交顺序与预处理顺序一致，按顺序取出帧序号
+    void enqueueIndex(int index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        indices_.push_back(index);
+    }
+
+private:
+    int pendingIndex() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int index = indices_.front();
+        indices_.erase(indices_.begin());
+        return index;
+    }
+
+    int stageMs_;
+    std::mutex mutex_;
+    std::vector<int> indices_;
+};
+
+int main() {
+    std::cout << "=== 推理流水线测试 ===" << std::endl << std::endl;
+
+    const int stageMs = 10;
+    const int frames = 40;
+    auto engine = std::make_shared<FakeEngine>(stageMs);
+
+    // 串行基准：每帧依次执行三个阶段
+    std::vector<int> expected;
+    auto serialStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        engine->enqueueIndex(i);
+        auto result = std::dynamic_pointer_cast<FakeResult>(engine->infer(cv::Mat()));
+        expected.push_back(result ? result->value() : -1);
+    }
+    double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - serialStart).count();
+
+    std::cout << "1. 正确性测试" << std::endl;
+    InferencePipeline pipeline(2);
+    pipeline.start();
+
+    std::mutex resultMutex;
+    std::vector<int> results;
+    std::vector<std::string> names;
+    auto completion = [&](const std::string& name, const cv::Mat&, std::shared_ptr<InferenceResult> result, double) {
+        auto fake = std::dynamic_pointer_cast<FakeResult>(result);
+        std::lock_guard<std::mutex> lock(resultMutex);
+        results.push_back(fake ? fake->value() : -1);
+        names.push_back(name);
+    };
+
+    auto pipelineStart = std::chrono::steady_clock::now();
+    int dropped = 0;
+    for (int i = 0; i < frames; i++) {
+        engine->enqueueIndex(i);
+        // 输入队列满时等待后重试（与相机帧率匹配的生产者）
+        while (!pipeline.submit("frame" + std::to_string(i), engine, cv::Mat(), completion)) {
+            dropped++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (static_cast<int>(results.size()) == frames) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double pipelineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pipelineStart).count();
+
+    check(results == expected, "每帧结果与串行执行一致");
+    bool ordered = true;
+    for (int i = 0; i < frames; i++) {
+        ordered = ordered && names[i] == "frame" + std::to_string(i);
+    }
+    check(ordered, "按提交顺序完成");
+    check(dropped > 0, "输入队列满时 submit 返回 false");
+
+    // 预处理失败的帧回调 nullptr，不影响后续帧
+    results.clear();
+    names.clear();
+    engine->enqueueIndex(-1);
+    engine->enqueueIndex(5);
+    pipeline.submit("bad", engine, cv::Mat(), completion);
+    pipeline.submit("good", engine, cv::Mat(), completion);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (results.size() == 2) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    check(results[0] == -1 && results[1] == 11, "失败帧回调 nullptr，后续帧正常");
+
+    std::cout << std::endl << "2. 吞吐量对比 (" << frames << " 帧, 每阶段 " << stageMs << " ms)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  串行:   " << serialMs << " ms (" << frames * 1000.0 / serialMs << " 帧/秒)" << std::endl;
+    std::cout << "  流水线: " << pipelineMs << " ms (" << frames * 1000.0 / pipelineMs << " 帧/秒)" << std::endl;
+    check(pipelineMs < serialMs * 0.6, "流水线吞吐量高于串行");
+
+    std::cout << std::endl << pipeline.getStatistics();
+    pipeline.stop();
+
+    std::cout << std::endl << "3. 最新帧优先" << std::endl;
+    {
+        // 两个模型交替提交，帧序号通过图像行数传递（被覆盖的帧不会经过预处理）
+        auto slowEngine = std::make_shared<FakeEngine>(20);
+        InferencePipeline latest(1, true);
+        latest.start();
+        std::vector<std::pair<std::string, int>> completed;
+        auto record = [&](const std::string& name, const cv::Mat& image, std::shared_ptr<InferenceResult>, double) {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            completed.emplace_back(name, image.rows - 1);
+        };
+        for (int i = 0; i < 20; i++) {
+            for (const char* model : {"detector", "classifier"}) {
+                slowEngine->enqueueIndex(i);
+                latest.submit(model, slowEngine, cv::Mat(i + 1, 1, CV_8UC1), record);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        // 等待流水线排空
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        latest.stop();
+
+        std::vector<int> detector;
+        std::vector<int> classifier;
+        for (const auto& entry : completed) {
+            (entry.first == "detector" ? detector : classifier).push_back(entry.second);
+        }
+        check(latest.getFramesReplaced() > 0, "忙时新帧覆盖旧帧 (覆盖: " + std::to_string(latest.getFramesReplaced()) + ")");
+        check(!detector.empty() && detector.back() == 19 && !classifier.empty() && classifier.back() == 19,
+              "每个模型最后提交的帧都被处理");
+        check(detector.size() >= 2 && classifier.size() >= 2,
+              "一个模型的新帧不会覆盖另一个模型的帧 (detector: " + std::to_string(detector.size()) +
+              ", classifier: " + std::to_string(classifier.size()) + ")");
+    }
+
+    return testSummary();
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_inference_rate.cpp
+ * @brief 推理频率控制器测试程序
+ *
+ * 模拟 30fps 输入与固定推理耗时：
+ * 1. FIXED：保持固定间隔，配置参数被规范化
+ * 2. CPU：间隔收敛到 ceil(推理耗时 / (占用比例 * 帧间隔))
+ * 3. LATENCY：无排队时为跟上帧率的最小间隔，持续排队时增大，延迟恢复后回落
+ * 4. 冷却：LATENCY 模式每 4 次推理完成最多调整一次
+ * 5. 上下限：计算结果限制在 [minInterval, maxInterval]
+ */
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include "inference/InferenceRateController.hpp"
+#include "TestCheck.hpp"
+
+using namespace inference;
+using Mode = InferenceRateController::Mode;
+
+static const int64_t FRAME_US = 33333;
+
+static InferenceRateController::Options makeOptions(Mode mode, int minInterval = 1, int maxInterval = 30) {
+    InferenceRateController::Options options;
+    options.mode = mode;
+    options.minInterval = minInterval;
+    options.maxInterval = maxInterval;
+    return options;
+}
+
+/**
+ * @brief 输入 frames 帧，推理的帧按给定耗时与延迟完成
+ */
+static void simulate(InferenceRateController& controller, int64_t& nowUs, int frames,
+                     double inferenceMs, double latencyMs) {
+    for (int frame = 0; frame < frames; frame++) {
+        nowUs += FRAME_US;
+        if (controller.shouldRun(nowUs)) {
+            controller.recordInference(inferenceMs, latencyMs, nowUs + static_cast<int64_t>(inferenceMs * 1000));
+        }
+    }
+}
+
+static std::string intervalOf(const InferenceRateController& controller) {
+    return " (interval: " + std::to_string(controller.getStats().interval) + ")";
+}
+
+static void testFixed() {
+    std::cout << "\n1. FIXED" << std::endl;
+    int64_t nowUs = 1000000;
+    InferenceRateController controller(makeOptions(Mode::FIXED, 2));
+    simulate(controller, nowUs, 300, 50.0, 500.0);
+    auto stats = controller.getStats();
+    check(stats.interval == 2 && stats.framesSkipped == 150, "保持固定间隔，不受耗时与延迟影响");
+    check(std::fabs(stats.framePeriodMs - 33.333) < 0.1, "测得输入帧间隔");
+
+    controller.resetStats();
+    check(controller.getStats().framesSkipped == 0 && controller.getStats().interval == 2, "resetStats 只清除统计");
+
+    controller.configure(makeOptions(Mode::FIXED, 0, -5));
+    simulate(controller, nowUs, 10, 50.0, 50.0);
+    check(controller.getStats().interval == 1 && controller.getStats().framesSkipped == 0,
+          "minInterval 至少为 1，maxInterval 不小于 minInterval");
+
+    check(InferenceRateController::parseMode("latency") == Mode::LATENCY &&
+          InferenceRateController::parseMode("cpu") == Mode::CPU &&
+          InferenceRateController::parseMode("unknown") == Mode::FIXED, "parseMode 无法识别时为 FIXED");
+}
+
+static void testCpu() {
+    std::cout << "\n2. CPU" << std::endl;
+    int64_t nowUs = 1000000;
+    auto options = makeOptions(Mode::CPU);
+    options.targetCpuShare = 0.5;
+    InferenceRateController controller(options);
+    simulate(controller, nowUs, 300, 50.0, 50.0);
+    auto stats = controller.getStats();
+    check(stats.interval == 3, "占用 50% 时每 3 帧推理一次" + intervalOf(controller));
+    check(std::fabs(stats.effectiveRate - 10.0) < 0.5, "实际推理频率约 10 次/秒");
+
+    // 推理耗时变化后重新收敛
+    simulate(controller, nowUs, 300, 20.0, 20.0);
+    check(controller.getStats().interval == 2, "推理变快后间隔减小" + intervalOf(controller));
+
+    options.targetCpuShare = 1.0;
+    controller.configure(options);
+    simulate(controller, nowUs, 300, 50.0, 50.0);
+    check(controller.getStats().interval == 2, "占用 100% 时只需跟上帧率" + intervalOf(controller));
+}
+
+static void testLatency() {
+    std::cout << "\n3. LATENCY" << std::endl;
+    int64_t nowUs = 1000000;
+    auto options = makeOptions(Mode::LATENCY);
+    options.targetLatencyMs = 100.0;
+    InferenceRateController controller(options);
+
+    simulate(controller, nowUs, 300, 50.0, 50.0);
+    check(controller.getStats().interval == 2, "无排队时间隔为跟上帧率的最小值" + intervalOf(controller));
+
+    simulate(controller, nowUs, 300, 50.0, 180.0);
+    int raised = controller.getStats().interval;
+    check(raised > 2, "持续排队超预算时增大间隔" + intervalOf(controller));
+
+    // 推理本身超出预算：跳帧无法改善延迟，只保证跟上帧率
+    InferenceRateController slow(options);
+    int64_t slowUs = 1000000;
+    simulate(slow, slowUs, 300, 150.0, 155.0);
+    check(slow.getStats().interval == 5, "推理本身超预算时不额外跳帧" + intervalOf(slow));
+
+    simulate(controller, nowUs, 600, 50.0, 50.0);
+    check(controller.getStats().interval == 2, "延迟恢复后间隔回落" + intervalOf(controller));
+}
+
+static void testCooldown() {
+    std::cout << "\n4. 冷却" << std::endl;
+    int64_t nowUs = 1000000;
+    auto options = makeOptions(Mode::LATENCY);
+    options.targetLatencyMs = 100.0;
+    InferenceRateController controller(options);
+
+    // 先测得帧间隔，再逐次记录排队严重的推理
+    for (int frame = 0; frame < 10; frame++) {
+        nowUs += FRAME_US;
+        controller.shouldRun(nowUs);
+    }
+    int intervals[8];
+    for (int i = 0; i < 8; i++) {
+        nowUs += FRAME_US;
+        controller.recordInference(50.0, 180.0, nowUs);
+        intervals[i] = controller.getStats().interval;
+    }
+    check(intervals[0] == 2 && intervals[2] == 2, "冷却期内不调整");
+    check(intervals[3] == 3 && intervals[6] == 3, "第 4 次完成时增加一帧");
+    check(intervals[7] == 4, "再经过 4 次完成才再次调整");
+}
+
+static void testClamp() {
+    std::cout << "\n5. 上下限" << std::endl;
+    int64_t nowUs = 1000000;
+
+    auto options = makeOptions(Mode::CPU, 1, 5);
+    options.targetCpuShare = 0.1;
+    InferenceRateController capped(options);
+    simulate(capped, nowUs, 300, 50.0, 50.0);
+    check(capped.getStats().interval == 5, "超过 maxInterval 时取上限" + intervalOf(capped));
+
+    options.targetCpuShare = 0.0;
+    options.maxInterval = 1000;
+    capped.configure(options);
+    simulate(capped, nowUs, 300, 50.0, 50.0);
+    check(capped.getStats().interval == 150, "占用比例至少为 1%" + intervalOf(capped));
+
+    options = makeOptions(Mode::CPU, 4, 30);
+    options.targetCpuShare = 0.5;
+    InferenceRateController floored(options);
+    simulate(floored, nowUs, 300, 50.0, 50.0);
+    check(floored.getStats().interval == 4, "低于 minInterval 时取下限" + intervalOf(floored));
+
+    options = makeOptions(Mode::LATENCY, 1, 3);
+    options.targetLatencyMs = 100.0;
+    InferenceRateController latency(options);
+    simulate(latency, nowUs, 600, 50.0, 400.0);
+    check(latency.getStats().interval == 3, "延迟调整不超过 maxInterval" + intervalOf(latency));
+}
+
+int main() {
+    std::cout << "=== 推理频率控制器测试 ===" << std::endl;
+
+    testFixed();
+    testCpu();
+    testLatency();
+    testCooldown();
+    testClamp();
+
+    return testSummary();
+}
@@ -0,0 +1,171 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_metadata_log.cpp
+ * @brief 列式元数据日志测试与导出工具
+ *
+ * 无参数运行时执行自测：
+ * 1. 写入/读取往返：时间戳、宽高、元数据值与存在位掩码一致
+ * 2. 出现新的元数据类型时切换分段，旧分段保持完整
+ * 3. 截断的尾行被忽略，CSV/JSON 导出行数正确
+ * 4. 定时刷新：没有新帧时缓冲的行也会在刷新间隔后落盘
+ *
+ * 导出模式: test_metadata_log <文件.obmeta> [csv|json]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "core/MetadataLogger.hpp"
+#include "Logger.hpp"
+#include "TestCheck.hpp"
+
+namespace fs = std::filesystem;
+
+static MetadataLogger::Record makeRecord(uint64_t index, bool withBrightness) {
+    MetadataLogger::Record record;
+    record.stream = "Color";
+    record.frameType = OB_FRAME_COLOR;
+    record.format = OB_FORMAT_MJPG;
+    record.row.index = index;
+    record.row.deviceUs = 1000000 + index * 33333;
+    record.row.systemUs = 2000000 + index * 33333;
+    record.row.globalUs = 3000000 + index * 33333;
+    record.row.width = 1280;
+    record.row.height = 720;
+    record.metadata.emplace_back(OB_FRAME_METADATA_TYPE_TIMESTAMP, static_cast<int64_t>(record.row.deviceUs));
+    record.metadata.emplace_back(OB_FRAME_METADATA_TYPE_EXPOSURE, 100 + static_cast<int64_t>(index % 7));
+    record.metadata.emplace_back(OB_FRAME_METADATA_TYPE_GAIN, 16);
+    if (withBrightness) {
+        record.metadata.emplace_back(OB_FRAME_METADATA_TYPE_BRIGHTNESS, -3);
+    }
+    return record;
+}
+
+static std::vector<std::string> listLogs(const std::string& dir) {
+    std::vector<std::string> files;
+    for (const auto& entry : fs::directory_iterator(dir + "/metadata")) {
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static size_t countLines(const std::string& text) {
+    return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+}
+
+static void runSelfTest(const std::string& dir) {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::cout << "\n1. 写入/读取往返" << std::endl;
+    {
+        MetadataLogger logger(0);
+        for (uint64_t i = 0; i < 100; i++) {
+            logger.append(makeRecord(i, false), dir);
+        }
+        // 第100帧出现新的元数据类型 -> 切换分段
+        for (uint64_t i = 100; i < 150; i++) {
+            logger.append(makeRecord(i, true), dir);
+        }
+        // 新分段中缺少 Brightness 的帧仍写入当前分段
+        logger.append(makeRecord(150, false), dir);
+    }
+
+    auto files = listLogs(dir);
+    check(files.size() == 2, "新元数据类型触发分段切换 (分段数: " + std::to_string(files.size()) + ")");
+    if (files.size() != 2) return;
+
+    MetadataLogReader::Log first;
+    MetadataLogReader::Log second;
+    check(MetadataLogReader::read(files[0], first), "读取第一个分段");
+    check(MetadataLogReader::read(files[1], second), "读取第二个分段");
+    check(first.rows.size() == 100 && first.columns.size() == 3, "第一个分段: 100 行, 3 列");
+    check(second.rows.size() == 51 && second.columns.size() == 4, "第二个分段: 51 行, 4 列");
+
+    bool valuesMatch = true;
+    for (size_t r = 0; r < first.rows.size(); r++) {
+        auto expected = makeRecord(r, false);
+        const auto& row = first.rows[r];
+        valuesMatch = valuesMatch && row.index == r && row.deviceUs == expected.row.deviceUs &&
+                      row.systemUs == expected.row.systemUs && row.globalUs == expected.row.globalUs &&
+                      row.width == 1280 && row.height == 720 && row.presentMask == 0x7;
+        // 列按元数据类型排序: TIMESTAMP(0), EXPOSURE(4), GAIN(5)
+        valuesMatch = valuesMatch && first.values[r * 3 + 1] == 100 + static_cast<int64_t>(r % 7) &&
+                      first.values[r * 3 + 2] == 16;
+    }
+    check(valuesMatch, "时间戳、宽高与元数据值一致");
+
+    const auto& lastRow = second.rows.back();
+    check(lastRow.presentMask == 0x7, "缺失字段在存在位掩码中为0");
+    check(second.values[(second.rows.size() - 2) * 4 + 3] == -3, "负值元数据往返一致");
+
+    std::cout << "\n2. 磁盘占用" << std::endl;
+    auto firstSize = fs::file_size(files[0]);
+    std::cout << "  100 帧占用 " << firstSize << " 字节 (每帧 " << first.header.rowSize << " 字节)" << std::endl;
+    check(first.header.rowSize == sizeof(MetadataLogger::RowHeader) + 3 * sizeof(int64_t), "定长行大小");
+
+    std::cout << "\n3. 截断与导出" << std::endl;
+    fs::resize_file(files[0], firstSize - 10);
+    MetadataLogReader::Log truncated;
+    check(MetadataLogReader::read(files[0], truncated) && truncated.rows.size() == 99, "截断的尾行被忽略");
+
+    std::ostringstream csv;
+    check(MetadataLogReader::exportCsv(files[1], csv), "导出 CSV");
+    check(countLines(csv.str()) == 52, "CSV 行数 = 表头 + 51");
+    check(csv.str().find("index,device_us,system_us,global_us,width,height") == 0, "CSV 表头");
+
+    std::ostringstream json;
+    check(MetadataLogReader::exportJson(files[1], json), "导出 JSON");
+    check(json.str().find("\"stream\": \"Color\"") != std::string::npos, "JSON 数据流名称");
+
+    std::ofstream garbage(dir + "/garbage.obmeta", std::ios::binary);
+    garbage << "not a metadata log";
+    garbage.close();
+    MetadataLogReader::Log invalid;
+    check(!MetadataLogReader::read(dir + "/garbage.obmeta", invalid), "拒绝无效文件头");
+
+    std::cout << "\n4. 定时刷新" << std::endl;
+    {
+        std::string flushDir = dir + "/flush";
+        MetadataLogger logger(200);
+        logger.append(makeRecord(0, false), flushDir);
+        auto logs = listLogs(flushDir);
+
+        MetadataLogReader::Log buffered;
+        check(logs.size() == 1 && MetadataLogReader::read(logs[0], buffered) && buffered.rows.empty(),
+              "刷新间隔内的行留在缓冲中");
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        MetadataLogReader::Log flushed;
+        check(logs.size() == 1 && MetadataLogReader::read(logs[0], flushed) && flushed.rows.size() == 1,
+              "没有新帧时由定时任务刷新");
+    }
+
+    fs::remove_all(dir);
+}
+
+int main(int argc, char* argv[]) {
+    Logger::getInstance().initialize(Logger::Level::WARN, true);
+
+    if (argc > 1) {
+        // 导出模式
+        std::string format = argc > 2 ? argv[2] : "csv";
+        bool ok = (format == "json") ? MetadataLogReader::exportJson(argv[1], std::cout)
+                                     : MetadataLogReader::exportCsv(argv[1], std::cout);
+        return ok ? 0 : 1;
+    }
+
+    std::cout << "=== 列式元数据日志测试 ===" << std::endl;
+    runSelfTest("./metadata_log_test");
+
+    return testSummary();
+}
@@ -0,0 +1,175 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_model_cache.cpp
+ * @brief 模型内存映射加载与优化模型缓存测试程序
+ *
+ * 1. XXH64 哈希与参考实现一致
+ * 2. 内存映射与整体读入得到相同内容
+ * 3. 缓存键随模型内容/后端版本/会话选项变化，写入后命中，旧条目被清理
+ * 4. ONNX 引擎冷启动写入缓存，再次初始化命中缓存，输出两次加载耗时
+ * 5. auto 引擎测试可用后端并缓存选择结果，再次加载直接使用缓存的后端
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "inference/ModelCache.hpp"
+#include "inference/ONNXInference.hpp"
+#include "inference/AutoInferenceEngine.hpp"
+#include "TestCheck.hpp"
+
+using namespace inference;
+namespace fs = std::filesystem;
+
+static void writeFile(const fs::path& path, const std::vector<uint8_t>& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+static size_t countEntries(const fs::path& directory) {
+    size_t count = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        (void)entry;
+        count++;
+    }
+    return count;
+}
+
+int main() {
+    std::cout << "=== 模型缓存测试 ===" << std::endl << std::endl;
+
+    fs::path root = fs::temp_directory_path() / ("test_model_cache_" + std::to_string(::getpid()));
+    fs::create_directories(root);
+    fs::path cacheDir = root / ".cache";
+
+    std::cout << "1. XXH64" << std::endl;
+    {
+        std::vector<uint8_t> bytes;
+        for (int r = 0; r < 4; r++) {
+            for (int i = 0; i < 256; i++) {
+                bytes.push_back(static_cast<uint8_t>(i));
+            }
+        }
+        bytes.insert(bytes.end(), {'x', 'y', 'z'});
+        check(ModelCache::hashBytes("", 0) == 0xEF46DB3751D8E999ULL, "空输入");
+        check(ModelCache::hashBytes("abc", 3) == 0x44BC2CF5AD770999ULL, "短输入 (< 32 字节)");
+        check(ModelCache::hashBytes(bytes.data(), bytes.size()) == 0xE146CB31B65BC21AULL, "长输入 (1027 字节)");
+    }
+
+    // 模拟模型文件（随机权重）
+    const size_t modelSize = 64 * 1024 * 1024;
+    std::vector<uint8_t> weights(modelSize);
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < modelSize; i += 8) {
+        uint64_t v = rng();
+        std::memcpy(&weights[i], &v, 8);
+    }
+    fs::path modelPath = root / "yolov8n.onnx";
+    writeFile(modelPath, weights);
+
+    std::cout << std::endl << "2. 内存映射" << std::endl;
+    {
+        MappedModel mapped;
+        MappedModel loaded;
+        check(mapped.open(modelPath.string(), true) && mapped.isMapped(), "以 mmap 打开");
+        check(loaded.open(modelPath.string(), false) && !loaded.isMapped(), "整体读入");
+        check(mapped.size() == modelSize && std::memcmp(mapped.data(), weights.data(), modelSize) == 0, "映射内容正确");
+        check(mapped.hash() == loaded.hash(), "两种方式哈希一致");
+
+        MappedModel moved = std::move(loaded);
+        check(!loaded.isOpen() && moved.size() == modelSize && moved.hash() == mapped.hash(), "移动后内容不变");
+        check(!MappedModel().open((root / "missing.onnx").string()), "不存在的文件打开失败");
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t hash = ModelCache::hashBytes(mapped.data(), mapped.size());
+        double hashMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        (void)hash;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  哈希 " << modelSize / (1024 * 1024) << " MB: " << hashMs << " ms ("
+                  << modelSize / 1e6 / hashMs << " GB/s)" << std::endl;
+    }
+
+    std::cout << std::endl << "3. 缓存键与条目" << std::endl;
+    {
+        uint64_t hash = ModelCache::hashBytes(weights.data(), weights.size());
+        std::string key = ModelCache::makeKey(hash, "v1", "shape=1x3x640x640");
+        check(key == ModelCache::makeKey(hash, "v1", "shape=1x3x640x640"), "相同输入得到相同的键");
+        check(key != ModelCache::makeKey(hash ^ 1, "v1", "shape=1x3x640x640"), "模型内容变化时键变化");
+        check(key != ModelCache::makeKey(hash, "v2", "shape=1x3x640x640"), "后端版本变化时键变化");
+        check(key != ModelCache::makeKey(hash, "v1", "shape=1x3x320x320"), "会话选项变化时键变化");
+
+        ModelCache cache(cacheDir.string());
+        check(cache.lookup(modelPath.string(), key).empty(), "写入前未命中");
+        check(cache.store(modelPath.string(), key, weights.data(), 1024), "写入条目");
+        check(cache.lookup(modelPath.string(), key) == cache.entryPath(modelPath.string(), key), "写入后命中");
+
+        std::string newKey = ModelCache::makeKey(hash, "v2", "shape=1x3x640x640");
+        cache.store(modelPath.string(), newKey, weights.data(), 1024);
+        check(cache.lookup(modelPath.string(), key).empty() && countEntries(cacheDir) == 1,
+              "新条目写入后旧条目被清理");
+        fs::remove_all(cacheDir);
+    }
+
+    std::cout << std::endl << "4. 引擎加载 (冷启动 vs 缓存)" << std::endl;
+    {
+        ModelConfig config;
+        config.modelPath = modelPath.string();
+        config.modelType = "detection";
+        config.cacheDirectory = cacheDir.string();
+
+        ONNXInferenceEngine cold;
+        check(cold.initialize(config) && !cold.isLoadedFromCache(), "冷启动未命中缓存");
+        check(countEntries(cacheDir) == 1, "冷启动写入优化模型");
+
+        ONNXInferenceEngine cached;
+        check(cached.initialize(config) && cached.isLoadedFromCache(), "再次加载命中缓存");
+
+        config.inputShape = {1, 3, 320, 320};
+        ONNXInferenceEngine reshaped;
+        check(reshaped.initialize(config) && !reshaped.isLoadedFromCache(), "输入形状变化后不命中旧缓存");
+
+        std::cout << "  冷启动: " << cold.getLoadTimeMs() << " ms" << std::endl;
+        std::cout << "  命中缓存: " << cached.getLoadTimeMs() << " ms" << std::endl;
+    }
+
+    std::cout << std::endl << "5. 自动选择后端" << std::endl;
+    {
+        ModelConfig config;
+        config.modelPath = modelPath.string();
+        config.modelType = "classification";
+        config.engineType = "auto";
+        config.cacheDirectory = cacheDir.string();
+
+        auto first = std::dynamic_pointer_cast<AutoInferenceEngine>(InferenceEngineFactory::createEngine("auto"));
+        check(first && first->initialize(config), "auto 引擎初始化");
+        check(first && !first->isDecisionCached() &&
+              first->getBenchmark().size() == AutoInferenceEngine::availableBackends().size(),
+              "首次加载测试所有可用后端");
+        for (const auto& entry : first->getBenchmark()) {
+            std::cout << "  " << entry.backend << ": "
+                      << (entry.initialized ? std::to_string(entry.medianMs) + " ms" : "unavailable")
+                      << (entry.initialized && !entry.agrees ? " (output mismatch)" : "") << std::endl;
+        }
+        check(first && !first->getSelectedBackend().empty() && first->isInitialized() && first->supportsStages(),
+              "选中后端 (" + (first ? first->getSelectedBackend() : std::string()) + ") 并转发接口");
+
+        AutoInferenceEngine second;
+        check(second.initialize(config) && second.isDecisionCached() &&
+              second.getSelectedBackend() == first->getSelectedBackend() && second.getBenchmark().empty(),
+              "再次加载使用缓存的选择结果");
+        check(second.getModelType() == "classification", "模型类型由选中后端提供");
+    }
+
+    fs::remove_all(root);
+
+    return testSummary();
+}
@@ -0,0 +1,264 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_object_tracker.cpp
+ * @brief 多目标跟踪器测试程序
+ *
+ * 使用匀速运动的合成目标，每 3 帧给一次检测结果：
+ * 1. 目标ID在推理帧与预测帧之间保持不变
+ * 2. 跳过推理的帧上预测框误差小于沿用上次检测框
+ * 3. 生命周期：minHits 之前不输出，连续 maxAge 次未匹配后删除，不同类别不互相匹配
+ * 4. 推理延迟：检测结果晚若干帧到达（按采集时间戳更新），ID 保持且输出框跟上当前帧
+ * 5. 性能：50 个目标的 update/predict 单帧耗时（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <vector>
+#include "inference/ObjectTracker.hpp"
+#include "TestCheck.hpp"
+
+using namespace inference;
+
+/**
+ * @brief 匀速运动的合成目标
+ */
+struct MovingObject {
+    float x, y, vx, vy, w, h;
+    int classId;
+
+    DetectionBox at(double t) const {
+        DetectionBox box;
+        box.bbox = cv::Rect2f(x + vx * static_cast<float>(t), y + vy * static_cast<float>(t), w, h);
+        box.classId = classId;
+        box.confidence = 0.9f;
+        box.className = "class" + std::to_string(classId);
+        return box;
+    }
+};
+
+static float centerError(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float dx = (a.x + a.width * 0.5f) - (b.x + b.width * 0.5f);
+    float dy = (a.y + a.height * 0.5f) - (b.y + b.height * 0.5f);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/**
+ * @brief 按中心距离找到与真值最接近的跟踪目标
+ */
+static const TrackedObject* nearest(const std::vector<TrackedObject>& objects, const cv::Rect2f& truth) {
+    const TrackedObject* best = nullptr;
+    float bestError = 1e9f;
+    for (const auto& object : objects) {
+        float error = centerError(object.bbox, truth);
+        if (error < bestError) {
+            bestError = error;
+            best = &object;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== 目标跟踪测试 ===" << std::endl << std::endl;
+
+    const int64_t frameUs = 33333;
+    const int detectEvery = 3;
+
+    std::vector<MovingObject> scene = {
+        {100, 100, 120, 0, 60, 120, 0},
+        {400, 200, -90, 40, 80, 80, 1},
+        {200, 400, 60, -60, 50, 100, 0},
+        {600, 50, 0, 150, 40, 40, 2},
+        {50, 300, 200, 10, 70, 140, 0},
+    };
+
+    std::cout << "1. ID 保持 (30fps, 每 " << detectEvery << " 帧推理一次)" << std::endl;
+    ObjectTracker tracker;
+    std::vector<int> ids(scene.size(), -1);
+    bool idsStable = true;
+    bool predictedFlag = true;
+    double trackerError = 0.0, holdError = 0.0;
+    int predictedSamples = 0;
+    std::vector<cv::Rect2f> lastDetections(scene.size());
+
+    for (int frame = 0; frame < 90; frame++) {
+        int64_t nowUs = 1000000 + frame * frameUs;
+        double t = frame * frameUs / 1e6;
+        bool detect = frame % detectEvery == 0;
+
+        std::vector<TrackedObject> objects;
+        if (detect) {
+            std::vector<DetectionBox> detections;
+            for (size_t i = 0; i < scene.size(); i++) {
+                detections.push_back(scene[i].at(t));
+                lastDetections[i] = detections.back().bbox;
+            }
+            objects = tracker.update(detections, nowUs);
+        } else {
+            objects = tracker.predict(nowUs);
+        }
+
+        if (frame < detectEvery * 2) {
+            continue;
+        }
+        for (size_t i = 0; i < scene.size(); i++) {
+            cv::Rect2f truth = scene[i].at(t).bbox;
+            const TrackedObject* object = nearest(objects, truth);
+            if (!object) {
+                idsStable = false;
+                continue;
+            }
+            if (ids[i] < 0) {
+                ids[i] = object->trackId;
+            }
+            idsStable = idsStable && object->trackId == ids[i];
+            if (!detect) {
+                predictedFlag = predictedFlag && object->predicted;
+                // 前几次检测用于估计速度，之后统计误差
+                if (frame >= detectEvery * 4) {
+                    trackerError += centerError(object->bbox, truth);
+                    holdError += centerError(lastDetections[i], truth);
+                    predictedSamples++;
+                }
+            }
+        }
+    }
+    std::map<int, int> idCount;
+    for (int id : ids) {
+        idCount[id]++;
+    }
+    check(idsStable, "每个目标的ID始终不变");
+    check(idCount.size() == scene.size(), "不同目标的ID互不相同");
+    check(predictedFlag, "跳过推理的帧标记为预测");
+
+    std::cout << std::endl << "2. 预测精度" << std::endl;
+    trackerError /= std::max(1, predictedSamples);
+    holdError /= std::max(1, predictedSamples);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  沿用上次检测框: 平均中心误差 " << holdError << " px" << std::endl;
+    std::cout << "  跟踪器预测:     平均中心误差 " << trackerError << " px" << std::endl;
+    check(trackerError < holdError * 0.25, "预测误差远小于沿用上次检测框");
+
+    std::cout << std::endl << "3. 生命周期" << std::endl;
+    {
+        ObjectTracker::Options options;
+        options.maxAge = 2;
+        options.minHits = 2;
+        ObjectTracker lifecycle(options);
+        MovingObject object{100, 100, 0, 0, 50, 50, 0};
+        MovingObject other{100, 100, 0, 0, 50, 50, 1};   // 与 object 重叠但类别不同
+
+        int64_t nowUs = 1000000;
+        auto objects = lifecycle.update({object.at(0)}, nowUs);
+        check(objects.empty(), "第一次匹配前不输出");
+        objects = lifecycle.update({object.at(0), other.at(0)}, nowUs += frameUs);
+        check(objects.size() == 1 && !objects[0].predicted, "达到 minHits 后输出");
+        objects = lifecycle.update({object.at(0), other.at(0)}, nowUs += frameUs);
+        check(objects.size() == 2 && objects[0].trackId != objects[1].trackId, "不同类别的重叠目标不互相匹配");
+
+        for (int i = 0; i < options.maxAge; i++) {
+            objects = lifecycle.update({other.at(0)}, nowUs += frameUs);
+        }
+        bool kept = false;
+        for (const auto& tracked : objects) {
+            kept = kept || (tracked.classId == 0 && tracked.predicted);
+        }
+        check(kept, "未匹配次数未超过 maxAge 时保留预测框");
+        objects = lifecycle.update({other.at(0)}, nowUs += frameUs);
+        check(objects.size() == 1 && objects[0].classId == 1, "超过 maxAge 后删除");
+        check(lifecycle.getStats().totalTracks == 2, "累计创建 2 个目标");
+    }
+
+    const int latencyFrames = 4;
+    std::cout << std::endl << "4. 推理延迟 (检测结果晚 " << latencyFrames << " 帧到达)" << std::endl;
+    {
+        ObjectTracker delayed;
+        std::vector<int> delayedIds(scene.size(), -1);
+        bool stable = true;
+        double delayedError = 0.0, lagError = 0.0;
+        int samples = 0;
+
+        for (int frame = 0; frame < 120; frame++) {
+            int64_t nowUs = 1000000 + frame * frameUs;
+            double t = frame * frameUs / 1e6;
+            auto objects = delayed.predict(nowUs);
+
+            // 本帧到达的是 latencyFrames 帧之前采集的图像的检测结果
+            int captured = frame - latencyFrames;
+            if (captured < 0 || captured % detectEvery != 0) {
+                continue;
+            }
+            double captureT = captured * frameUs / 1e6;
+            std::vector<DetectionBox> detections;
+            for (const auto& object : scene) {
+                detections.push_back(object.at(captureT));
+            }
+            objects = delayed.update(detections, 1000000 + captured * frameUs);
+
+            if (captured < detectEvery * 4) {
+                continue;
+            }
+            for (size_t i = 0; i < scene.size(); i++) {
+                cv::Rect2f truth = scene[i].at(t).bbox;
+                const TrackedObject* object = nearest(objects, truth);
+                if (!object) {
+                    stable = false;
+                    continue;
+                }
+                if (delayedIds[i] < 0) {
+                    delayedIds[i] = object->trackId;
+                }
+                stable = stable && object->trackId == delayedIds[i];
+                delayedError += centerError(object->bbox, truth);
+                lagError += centerError(detections[i].bbox, truth);
+                samples++;
+            }
+        }
+
+        delayedError /= std::max(1, samples);
+        lagError /= std::max(1, samples);
+        std::cout << "  直接使用延迟的检测框: 平均中心误差 " << lagError << " px" << std::endl;
+        std::cout << "  跟踪器输出:           平均中心误差 " << delayedError << " px" << std::endl;
+        check(stable && delayed.getStats().totalTracks == scene.size(), "延迟的检测结果匹配到原目标，ID 不变");
+        check(delayedError < lagError * 0.25, "输出框预测到当前帧，不滞后于延迟的检测结果");
+    }
+
+    if (benchmarkEnabled(argc, argv)) {
+        std::cout << std::endl << "5. 性能 (50 个目标)" << std::endl;
+        std::vector<MovingObject> crowd;
+        for (int i = 0; i < 50; i++) {
+            crowd.push_back({static_cast<float>((i % 10) * 120), static_cast<float>((i / 10) * 150),
+                             static_cast<float>(i % 7 - 3) * 20.0f, static_cast<float>(i % 5 - 2) * 20.0f,
+                             60, 100, i % 3});
+        }
+
+        ObjectTracker perf;
+        std::vector<DetectionBox> detections;
+        for (int frame = 0; frame < 300; frame++) {
+            int64_t nowUs = 1000000 + frame * frameUs;
+            double t = frame * frameUs / 1e6;
+            if (frame % detectEvery == 0) {
+                detections.clear();
+                for (const auto& object : crowd) {
+                    detections.push_back(object.at(t));
+                }
+                perf.update(detections, nowUs);
+            } else {
+                perf.predict(nowUs);
+            }
+        }
+
+        auto stats = perf.getStats();
+        std::cout << "  " << perf.getStatistics() << std::endl;
+        check(stats.activeTracks == crowd.size(), "目标数稳定 (" + std::to_string(stats.activeTracks) + ")");
+        check(stats.avgUpdateUs < 1000.0, "update 耗时 < 1 ms");
+        check(stats.avgPredictUs < 1000.0, "predict 耗时 < 1 ms");
+    }
+
+    return testSummary();
+}
@@ -0,0 +1,271 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_result_record.cpp
+ * @brief 推理结果二进制记录测试程序
+ *
+ * 1. 编解码：各结果类型往返一致，损坏的记录被拒绝
+ * 2. 与 JSON 对比：每条结果的序列化耗时和字节数
+ * 3. 按对端合并：慢客户端的队列中每个模型只保留最新的结果，其他消息不受影响
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <json/json.h>
+#include "com/ResultRecord.hpp"
+#include "com/UdsComm.hpp"
+#include "TestCheck.hpp"
+
+static ResultRecordHeader makeHeader(ResultKind kind, uint16_t modelId, uint64_t frameIndex) {
+    ResultRecordHeader header;
+    header.kind = kind;
+    header.modelId = modelId;
+    header.frameIndex = frameIndex;
+    header.deviceTimestampUs = 7000000000ULL + frameIndex * 33333;
+    header.captureTimeUs = 123456789ULL + frameIndex * 33333;
+    header.resultTimeUs = header.captureTimeUs + 8500;
+    header.inferenceTimeUs = 8123;
+    header.imageWidth = 1280;
+    header.imageHeight = 720;
+    return header;
+}
+
+static std::vector<ResultBox> makeBoxes(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> coord(0.0f, 1200.0f);
+    std::uniform_real_distribution<float> score(0.3f, 1.0f);
+    std::vector<ResultBox> boxes(count);
+    for (size_t i = 0; i < count; i++) {
+        boxes[i].x = coord(rng);
+        boxes[i].y = coord(rng) * 0.5f;
+        boxes[i].width = coord(rng) * 0.1f;
+        boxes[i].height = coord(rng) * 0.1f;
+        boxes[i].score = score(rng);
+        boxes[i].classId = static_cast<int32_t>(rng() % 80);
+    }
+    return boxes;
+}
+
+static bool sameHeader(const ResultRecordHeader& a, const ResultRecordHeader& b) {
+    return a.kind == b.kind && a.modelId == b.modelId && a.frameIndex == b.frameIndex &&
+           a.deviceTimestampUs == b.deviceTimestampUs && a.captureTimeUs == b.captureTimeUs &&
+           a.resultTimeUs == b.resultTimeUs && a.inferenceTimeUs == b.inferenceTimeUs &&
+           a.imageWidth == b.imageWidth && a.imageHeight == b.imageHeight;
+}
+
+static bool sameBoxes(const std::vector<ResultBox>& a, const std::vector<ResultBox>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(ResultBox)) == 0);
+}
+
+/**
+ * @brief JSON 基线：与记录相同的字段，模型用名称表示
+ */
+static std::string encodeJson(Json::StreamWriterBuilder& builder, const std::string& modelName,
+                              const ResultRecordHeader& header, const std::vector<ResultBox>& boxes) {
+    Json::Value json;
+    json["model"] = modelName;
+    json["kind"] = "detection";
+    json["frameIndex"] = Json::UInt64(header.frameIndex);
+    json["deviceTimestampUs"] = Json::UInt64(header.deviceTimestampUs);
+    json["captureTimeUs"] = Json::UInt64(header.captureTimeUs);
+    json["resultTimeUs"] = Json::UInt64(header.resultTimeUs);
+    json["inferenceTimeUs"] = header.inferenceTimeUs;
+    json["width"] = header.imageWidth;
+    json["height"] = header.imageHeight;
+    Json::Value& array = json["boxes"];
+    array = Json::Value(Json::arrayValue);
+    for (const auto& box : boxes) {
+        Json::Value item;
+        item["x"] = box.x;
+        item["y"] = box.y;
+        item["w"] = box.width;
+        item["h"] = box.height;
+        item["score"] = box.score;
+        item["classId"] = box.classId;
+        array.append(std::move(item));
+    }
+    return Json::writeString(builder, json);
+}
+
+static void testCodec() {
+    std::cout << "1. 编解码" << std::endl;
+    std::mt19937 rng(1);
+
+    bool roundTrip = true;
+    const ResultKind kinds[] = {ResultKind::CLASSIFICATION, ResultKind::DETECTION, ResultKind::SEGMENTATION};
+    for (ResultKind kind : kinds) {
+        for (size_t count : {0, 1, 17, 300}) {
+            ResultRecordHeader header = makeHeader(kind, 3, 42 + count);
+            std::vector<ResultBox> boxes = makeBoxes(count, rng);
+            std::vector<uint8_t> record;
+            ResultRecord::encode(record, header, boxes.data(), boxes.size());
+
+            ResultRecordHeader decoded;
+            std::vector<ResultBox> decodedBoxes;
+            roundTrip = roundTrip && record.size() == ResultRecord::encodedSize(count) &&
+                        ResultRecord::decode(record.data(), record.size(), decoded, decodedBoxes) &&
+                        sameHeader(header, decoded) && sameBoxes(boxes, decodedBoxes);
+        }
+    }
+    check(roundTrip, "三种结果类型、0~300 个条目往返一致");
+
+    ResultRecordHeader header = makeHeader(ResultKind::DETECTION, 1, 7);
+    std::vector<ResultBox> boxes = makeBoxes(4, rng);
+    std::vector<uint8_t> record;
+    ResultRecord::encode(record, header, boxes.data(), boxes.size());
+    ResultRecordHeader decoded;
+    std::vector<ResultBox> decodedBoxes;
+
+    std::vector<uint8_t> truncated(record.begin(), record.end() - 1);
+    std::vector<uint8_t> badMagic = record;
+    badMagic[0] ^= 0xFF;
+    std::vector<uint8_t> badKind = record;
+    badKind[3] = 9;
+    check(!ResultRecord::decode(truncated.data(), truncated.size(), decoded, decodedBoxes) &&
+          !ResultRecord::decode(badMagic.data(), badMagic.size(), decoded, decodedBoxes) &&
+          !ResultRecord::decode(badKind.data(), badKind.size(), decoded, decodedBoxes) &&
+          !ResultRecord::decode(record.data(), ResultRecord::HEADER_SIZE - 1, decoded, decodedBoxes),
+          "长度、魔数或结果类型不符的记录被拒绝");
+
+    uint8_t small[ResultRecord::HEADER_SIZE];
+    check(ResultRecord::encode(small, sizeof(small), header, boxes.data(), boxes.size()) == 0,
+          "缓冲区不足时不写入");
+}
+
+static void testVersusJson() {
+    std::cout << std::endl << "2. 与 JSON 对比" << std::endl;
+    std::mt19937 rng(2);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    const std::string modelName = "yolov8n_person";
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  框数   二进制字节  JSON字节   二进制ns   JSON ns" << std::endl;
+    bool smaller = true;
+    bool faster = true;
+    for (size_t count : {0, 5, 20, 100}) {
+        std::vector<ResultBox> boxes = makeBoxes(count, rng);
+        const int iterations = count >= 100 ? 2000 : 20000;
+
+        // 编码缓冲区复用（与 PerceptionSystem 相同）
+        std::vector<uint8_t> record;
+        size_t binaryBytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            ResultRecordHeader header = makeHeader(ResultKind::DETECTION, 0, static_cast<uint64_t>(i));
+            ResultRecord::encode(record, header, boxes.data(), boxes.size());
+            binaryBytes += record.size();
+        }
+        double binaryNs = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+
+        size_t jsonBytes = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            ResultRecordHeader header = makeHeader(ResultKind::DETECTION, 0, static_cast<uint64_t>(i));
+            jsonBytes += encodeJson(builder, modelName, header, boxes).size();
+        }
+        double jsonNs = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+
+        std::cout << "  " << std::setw(4) << count << std::setw(12) << binaryBytes / iterations
+                  << std::setw(10) << jsonBytes / iterations << std::setw(11) << binaryNs
+                  << std::setw(11) << jsonNs << std::endl;
+        smaller = smaller && binaryBytes < jsonBytes;
+        faster = faster && binaryNs < jsonNs;
+    }
+    check(smaller, "每条结果的字节数少于 JSON");
+    check(faster, "序列化耗时少于 JSON");
+}
+
+static void testCoalescing(const std::string& path) {
+    std::cout << std::endl << "3. 按对端合并" << std::endl;
+
+    const size_t queueLimit = 64;
+    UdsCommImpl server(path, UdsCommImpl::CommRole::SERVER, queueLimit);
+    server.initialize(UdsCommImpl::CommRole::SERVER);
+    UdsCommImpl slow(path, UdsCommImpl::CommRole::CLIENT);
+    slow.initialize(UdsCommImpl::CommRole::CLIENT);
+    auto noop = [](std::string_view) {};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (server.peerCount() < 1 && std::chrono::steady_clock::now() < deadline) {
+        server.receiveMessages(noop, 10);
+    }
+
+    // 两个模型交替产生结果，每 1000 条结果插入一条不可合并的状态消息；客户端暂不读取
+    const uint32_t coalesceKey = 0x52000000;
+    const int results = 20000;
+    std::mt19937 rng(3);
+    std::vector<ResultBox> boxes = makeBoxes(20, rng);
+    std::vector<uint8_t> record;
+    int statusSent = 0;
+    for (int i = 0; i < results; i++) {
+        uint16_t modelId = static_cast<uint16_t>(i % 2);
+        ResultRecord::encode(record, makeHeader(ResultKind::DETECTION, modelId, static_cast<uint64_t>(i)),
+                             boxes.data(), boxes.size());
+        iovec iov{record.data(), record.size()};
+        server.sendCoalesced(&iov, 1, coalesceKey | modelId);
+        if (i % 1000 == 999) {
+            server.sendMessage("1:status " + std::to_string(statusSent++));
+        }
+    }
+
+    // 客户端开始读取：先是套接字缓冲区中的旧结果，然后是队列中每个模型最新的结果
+    std::map<uint16_t, uint64_t> lastFrame;
+    bool ordered = true;
+    int recordsReceived = 0;
+    int statusReceived = 0;
+    bool statusOrdered = true;
+    {
+        std::atomic<bool> running{true};
+        std::thread serverLoop([&]() {
+            while (running) {
+                server.receiveMessages(noop, 20);
+            }
+        });
+        while (slow.receiveMessages([&](std::string_view message) {
+            ResultRecordHeader header;
+            std::vector<ResultBox> decoded;
+            if (ResultRecord::decode(message.data(), message.size(), header, decoded)) {
+                auto it = lastFrame.find(header.modelId);
+                ordered = ordered && (it == lastFrame.end() || header.frameIndex > it->second);
+                lastFrame[header.modelId] = header.frameIndex;
+                recordsReceived++;
+            } else {
+                statusOrdered = statusOrdered && message == "1:status " + std::to_string(statusReceived);
+                statusReceived++;
+            }
+        }, 200) > 0) {
+        }
+        running = false;
+        server.interruptReceive();
+        serverLoop.join();
+    }
+
+    std::cout << "  发送 " << results << " 条结果，收到 " << recordsReceived << " 条，队列中合并 "
+              << server.coalescedMessages() << " 条，丢弃 " << server.droppedMessages() << " 条" << std::endl;
+    check(server.coalescedMessages() > 0 && recordsReceived < results, "拥塞时同一模型的旧结果被新结果替换");
+    check(ordered && lastFrame[0] == results - 2 && lastFrame[1] == results - 1, "每个模型最新的结果都送达，帧号递增");
+    check(server.droppedMessages() == 0 && statusReceived == statusSent && statusOrdered,
+          "合并后队列不会写满，不可合并的消息全部按顺序送达");
+}
+
+int main() {
+    std::cout << "=== 推理结果二进制记录测试 ===" << std::endl << std::endl;
+
+    testCodec();
+    testVersusJson();
+    testCoalescing("/tmp/test_result_record_" + std::to_string(getpid()) + ".sock");
+
+    return testSummary();
+}
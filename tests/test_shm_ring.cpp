@@ -0,0 +1,304 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_shm_ring.cpp
+ * @brief 共享内存帧环测试程序
+ *
+ * 1. 发布/读取：帧描述和载荷不变，超时，超出槽位容量的帧被拒绝，读端登记
+ * 2. 慢读端：只读最新帧 / 顺序读取两种模式下跳到最新帧，写端不等待
+ * 3. 写端关闭后读端返回 CLOSED
+ * 4. 双进程吞吐量与延迟（fork 出读端进程）（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "com/ShmFrameRing.hpp"
+#include "TestCheck.hpp"
+
+static std::string ringName(const char* tag) {
+    return "/perception_test_" + std::string(tag) + "_" + std::to_string(getpid());
+}
+
+static uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 载荷内容由序号决定，读端据此检查是否读到了拼接的帧
+ */
+static void fillPayload(std::vector<uint8_t>& data, uint64_t sequence) {
+    std::memset(data.data(), static_cast<int>(sequence & 0xFF), data.size());
+    std::memcpy(data.data(), &sequence, sizeof(sequence));
+    std::memcpy(data.data() + data.size() - sizeof(sequence), &sequence, sizeof(sequence));
+}
+
+static bool payloadIntact(const std::vector<uint8_t>& data, uint64_t sequence) {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    std::memcpy(&head, data.data(), sizeof(head));
+    std::memcpy(&tail, data.data() + data.size() - sizeof(tail), sizeof(tail));
+    return head == sequence && tail == sequence && data[data.size() / 2] == static_cast<uint8_t>(sequence & 0xFF);
+}
+
+static ShmFrameInfo makeInfo(uint64_t index) {
+    ShmFrameInfo info;
+    info.frameIndex = index;
+    info.deviceTimestampUs = 1000000 + index * 33333;
+    info.streamType = 2;
+    info.format = 22;
+    info.width = 64;
+    info.height = 48;
+    return info;
+}
+
+static void testPublishRead() {
+    std::cout << "1. 发布/读取" << std::endl;
+
+    ShmFrameRingWriter writer;
+    check(writer.create(ringName("basic"), 4, 4096), "创建共享内存");
+
+    ShmFrameRingReader reader;
+    check(reader.open(writer.name(), false), "读端打开");
+    auto consumers = writer.consumers();
+    check(consumers.size() == 1 && consumers[0].pid == getpid(), "读端登记在共享内存中");
+
+    ShmFrameInfo info;
+    std::vector<uint8_t> data;
+    check(reader.read(info, data, 0) == ShmReadStatus::TIMEOUT, "没有新帧时不等待立即返回");
+    auto start = std::chrono::steady_clock::now();
+    check(reader.read(info, data, 30) == ShmReadStatus::TIMEOUT &&
+          std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30), "等待到超时");
+
+    std::vector<uint8_t> payload(3000);
+    for (uint64_t i = 0; i < 3; i++) {
+        fillPayload(payload, i);
+        writer.publish(makeInfo(100 + i), payload.data(), payload.size());
+    }
+    bool ordered = true;
+    for (uint64_t i = 0; i < 3; i++) {
+        ordered = ordered && reader.read(info, data, 100) == ShmReadStatus::FRAME && info.sequence == i &&
+                  info.frameIndex == 100 + i && info.deviceTimestampUs == makeInfo(100 + i).deviceTimestampUs &&
+                  info.width == 64 && info.height == 48 && info.format == 22 && info.dataSize == payload.size() &&
+                  payloadIntact(data, i);
+    }
+    check(ordered, "3 帧按顺序读取，帧描述和载荷不变");
+
+    std::vector<uint8_t> large(4097);
+    check(!writer.publish(makeInfo(0), large.data(), large.size()), "超出槽位容量的帧不发布");
+
+    // 另一个线程发布，读端在 futex 上被唤醒
+    std::thread publisher([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        fillPayload(payload, 3);
+        writer.publish(makeInfo(103), payload.data(), payload.size());
+    });
+    check(reader.read(info, data, 1000) == ShmReadStatus::FRAME && info.sequence == 3, "等待中的读端被唤醒");
+    publisher.join();
+
+    reader.close();
+    check(writer.consumers().empty(), "读端关闭后注销");
+}
+
+static void testSlowConsumer() {
+    std::cout << std::endl << "2. 慢读端" << std::endl;
+
+    ShmFrameRingWriter writer;
+    writer.create(ringName("slow"), 4, 1024);
+    ShmFrameRingReader latest;
+    ShmFrameRingReader sequential;
+    latest.open(writer.name(), true);
+    sequential.open(writer.name(), false);
+
+    std::vector<uint8_t> payload(512);
+    for (uint64_t i = 0; i < 10; i++) {
+        fillPayload(payload, i);
+        writer.publish(makeInfo(i), payload.data(), payload.size());
+    }
+    check(writer.publishedCount() == 10, "读端不读取时写端照常发布");
+
+    ShmFrameInfo info;
+    std::vector<uint8_t> data;
+    check(latest.read(info, data, 0) == ShmReadStatus::FRAME && info.sequence == 9 && payloadIntact(data, 9) &&
+          latest.droppedCount() == 9, "只读最新帧：直接跳到第 9 帧，跳过 9 帧");
+    check(latest.read(info, data, 0) == ShmReadStatus::TIMEOUT, "之后没有新帧");
+
+    bool ordered = true;
+    for (uint64_t i = 6; i < 10; i++) {
+        ordered = ordered && sequential.read(info, data, 0) == ShmReadStatus::FRAME && info.sequence == i &&
+                  payloadIntact(data, i);
+    }
+    check(ordered && sequential.droppedCount() == 6, "顺序读取：从未被覆盖的最旧一帧（第 6 帧）继续");
+
+    auto consumers = writer.consumers();
+    bool statsShared = consumers.size() == 2;
+    for (const auto& consumer : consumers) {
+        statsShared = statsShared && consumer.received + consumer.dropped == 10;
+    }
+    check(statsShared, "读端统计在写端可见");
+}
+
+static void testClose() {
+    std::cout << std::endl << "3. 写端关闭" << std::endl;
+
+    auto writer = std::make_unique<ShmFrameRingWriter>();
+    writer->create(ringName("close"), 2, 64);
+    ShmFrameRingReader reader;
+    reader.open(writer->name());
+
+    std::thread closer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writer->close();
+    });
+    ShmFrameInfo info;
+    std::vector<uint8_t> data;
+    auto start = std::chrono::steady_clock::now();
+    ShmReadStatus status = reader.read(info, data, 5000);
+    closer.join();
+    check(status == ShmReadStatus::CLOSED && std::chrono::steady_clock::now() - start < std::chrono::seconds(1),
+          "等待中的读端在写端关闭后立即返回 CLOSED");
+    ShmFrameRingReader late;
+    check(!late.open(writer->name()), "关闭后共享内存已删除");
+}
+
+/**
+ * @brief 读端进程的统计结果，通过管道传回
+ */
+struct ChildReport {
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    uint64_t corrupted = 0;
+    uint64_t outOfOrder = 0;
+    double latencyP50Us = 0.0;
+    double latencyP99Us = 0.0;
+    double latencyMaxUs = 0.0;
+};
+
+/**
+ * @brief 两个进程间传输 frames 帧
+ * @param intervalUs 发布间隔，0 表示尽快发布
+ */
+static bool runTwoProcess(const char* tag, size_t frameSize, int frames, int intervalUs, bool latestOnly,
+                          ChildReport& report, double& publishSeconds) {
+    ShmFrameRingWriter writer;
+    if (!writer.create(ringName(tag), 4, frameSize)) {
+        std::cout << "  create failed: " << writer.lastError() << std::endl;
+        return false;
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        ::close(fds[0]);
+        ChildReport result;
+        ShmFrameRingReader reader;
+        if (reader.open(writer.name(), latestOnly)) {
+            std::vector<double> latencies;
+            latencies.reserve(static_cast<size_t>(frames));
+            ShmFrameInfo info;
+            std::vector<uint8_t> data;
+            uint64_t last = 0;
+            bool first = true;
+            while (reader.read(info, data, 2000) == ShmReadStatus::FRAME) {
+                latencies.push_back(static_cast<double>(nowUs() - info.publishTimeUs));
+                result.corrupted += payloadIntact(data, info.sequence) ? 0 : 1;
+                result.outOfOrder += (!first && info.sequence <= last) ? 1 : 0;
+                last = info.sequence;
+                first = false;
+                if (info.frameIndex + 1 == static_cast<uint64_t>(frames)) {
+                    break;
+                }
+            }
+            result.received = reader.receivedCount();
+            result.dropped = reader.droppedCount();
+            if (!latencies.empty()) {
+                std::sort(latencies.begin(), latencies.end());
+                result.latencyP50Us = latencies[latencies.size() / 2];
+                result.latencyP99Us = latencies[latencies.size() * 99 / 100];
+                result.latencyMaxUs = latencies.back();
+            }
+        }
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+    }
+    ::close(fds[1]);
+
+    // 等待读端登记后再开始发布
+    for (int i = 0; i < 2000 && writer.consumers().empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<uint8_t> payload(frameSize);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        fillPayload(payload, static_cast<uint64_t>(i));
+        ShmFrameInfo info;
+        info.frameIndex = static_cast<uint64_t>(i);
+        writer.publish(info, payload.data(), payload.size());
+        if (intervalUs > 0) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<int64_t>(intervalUs) * (i + 1)));
+        }
+    }
+    publishSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool ok = read(fds[0], &report, sizeof(report)) == static_cast<ssize_t>(sizeof(report));
+    ::close(fds[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void benchmarkTwoProcess() {
+    std::cout << std::endl << "4. 双进程吞吐量与延迟" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // 4.1 1280x720 RGB 帧尽快发布，读端只读最新帧
+    const size_t colorFrame = 1280 * 720 * 3;
+    const int burstFrames = 2000;
+    ChildReport burst;
+    double seconds = 0.0;
+    bool ok = runTwoProcess("burst", colorFrame, burstFrames, 0, true, burst, seconds);
+    std::cout << "  1280x720x3 尽快发布: " << burstFrames / seconds << " 帧/s ("
+              << burstFrames * static_cast<double>(colorFrame) / seconds / 1e9 << " GB/s), 读端收到 "
+              << burst.received << " 帧, 跳过 " << burst.dropped << " 帧, 延迟 p50 " << burst.latencyP50Us
+              << " us, p99 " << burst.latencyP99Us << " us" << std::endl;
+    check(ok && burst.received > 0 && burst.corrupted == 0 && burst.outOfOrder == 0,
+          "读端跟不上时写端不等待，读到的帧完整且不乱序");
+
+    // 4.2 按 500 帧/秒 发布，顺序读取，测量唤醒延迟
+    const int pacedFrames = 1000;
+    ChildReport paced;
+    ok = runTwoProcess("paced", colorFrame, pacedFrames, 2000, false, paced, seconds);
+    std::cout << "  1280x720x3 每 2ms 一帧: 读端收到 " << paced.received << "/" << pacedFrames << " 帧, 延迟 p50 "
+              << paced.latencyP50Us << " us, p99 " << paced.latencyP99Us << " us, max " << paced.latencyMaxUs
+              << " us" << std::endl;
+    check(ok && paced.corrupted == 0 && paced.outOfOrder == 0 &&
+          paced.received + paced.dropped == static_cast<uint64_t>(pacedFrames),
+          "按帧率发布时每帧要么读到要么计入跳过");
+    check(paced.received >= static_cast<uint64_t>(pacedFrames) * 9 / 10, "按帧率发布时读端基本不丢帧 (>= 90%)");
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== 共享内存帧环测试 ===" << std::endl << std::endl;
+
+    testPublishRead();
+    testSlowConsumer();
+    testClose();
+    if (benchmarkEnabled(argc, argv)) {
+        benchmarkTwoProcess();
+    }
+
+    return testSummary();
+}
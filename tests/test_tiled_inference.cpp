@@ -0,0 +1,258 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_tiled_inference.cpp
+ * @brief 高分辨率分块推理测试程序
+ *
+ * 1. 分块几何：覆盖整帧、不越界、相邻分块重叠、小帧只有一块
+ * 2. 小目标：整帧缩放后漏检的小目标在分块推理中被检出
+ * 3. 跨分块合并：重叠区域内与跨越分块边界的目标只输出一个框，坐标在整帧坐标系
+ * 4. 吞吐量：引擎副本数从 1 增加到 CPU 核数时的加速比（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "inference/TiledInference.hpp"
+#include "TestCheck.hpp"
+
+using namespace inference;
+
+/**
+ * @brief 模拟检测引擎
+ * 根据 ROI 在整帧中的位置输出落在分块内的真值目标（裁剪到分块内，可见面积不足 30% 的不输出）；
+ * 整帧输入按模型输入尺寸缩放，缩放后小于 minPixels 的目标漏检。每次推理做固定量的计算。
+ */
+class FakeDetector : public InferenceEngine {
+public:
+    FakeDetector(const std::vector<DetectionBox>& objects, int workIterations)
+        : objects_(objects), workIterations_(workIterations) {}
+
+    bool initialize(const ModelConfig&) override {
+        initialized_ = true;
+        return true;
+    }
+
+    std::shared_ptr<InferenceResult> infer(const cv::Mat& image) override {
+        cv::Size whole;
+        cv::Point offset;
+        image.locateROI(whole, offset);
+
+        // 模拟模型计算量
+        volatile double sink = 0.0;
+        for (int i = 0; i < workIterations_; i++) {
+            sink = sink + std::sqrt(static_cast<double>(i));
+        }
+
+        float scale = std::min(1.0f, static_cast<float>(INPUT_SIZE) / std::max(image.cols, image.rows));
+        cv::Rect2f tile(static_cast<float>(offset.x), static_cast<float>(offset.y),
+                        static_cast<float>(image.cols), static_cast<float>(image.rows));
+
+        std::vector<DetectionBox> boxes;
+        for (const auto& object : objects_) {
+            if (std::min(object.bbox.width, object.bbox.height) * scale < MIN_PIXELS) {
+                continue;
+            }
+            float x1 = std::max(object.bbox.x, tile.x);
+            float y1 = std::max(object.bbox.y, tile.y);
+            float x2 = std::min(object.bbox.x + object.bbox.width, tile.x + tile.width);
+            float y2 = std::min(object.bbox.y + object.bbox.height, tile.y + tile.height);
+            if (x2 <= x1 || y2 <= y1 || (x2 - x1) * (y2 - y1) < 0.3f * object.bbox.area()) {
+                continue;
+            }
+            DetectionBox box = object;
+            box.bbox = cv::Rect2f(x1 - tile.x, y1 - tile.y, x2 - x1, y2 - y1);
+            box.confidence = object.confidence * (x2 - x1) * (y2 - y1) / object.bbox.area();
+            boxes.push_back(box);
+        }
+
+        auto result = std::make_shared<ONNXInferenceResult>();
+        result->setDetectionResults(boxes);
+        result->setValid(true);
+        return result;
+    }
+
+    std::string getModelInfo() const override { return "FakeDetector"; }
+    void setThreshold(float) override {}
+    bool isInitialized() const override { return initialized_; }
+    std::string getModelType() const override { return "detection"; }
+
+    static constexpr int INPUT_SIZE = 640;
+    static constexpr float MIN_PIXELS = 10.0f;
+
+private:
+    std::vector<DetectionBox> objects_;
+    int workIterations_;
+    bool initialized_ = false;
+};
+
+static DetectionBox makeObject(float x, float y, float w, float h, int classId) {
+    DetectionBox box;
+    box.bbox = cv::Rect2f(x, y, w, h);
+    box.classId = classId;
+    box.confidence = 0.9f;
+    box.className = "class_" + std::to_string(classId);
+    return box;
+}
+
+static ModelConfig makeModelConfig() {
+    ModelConfig config;
+    config.modelPath = "fake.onnx";
+    config.modelType = "detection";
+    config.inputShape = {1, 3, FakeDetector::INPUT_SIZE, FakeDetector::INPUT_SIZE};
+    config.nmsThreshold = 0.5f;
+    return config;
+}
+
+static std::shared_ptr<TiledInferenceEngine> makeTiledEngine(const std::vector<DetectionBox>& objects,
+                                                             int workers, bool fullFrame, int workIterations = 0) {
+    TiledInferenceEngine::Options options;
+    options.overlap = 0.2f;
+    options.fullFrame = fullFrame;
+    options.workers = workers;
+    auto engine = std::make_shared<TiledInferenceEngine>(options, [objects, workIterations](const ModelConfig&) {
+        return std::make_shared<FakeDetector>(objects, workIterations);
+    });
+    engine->initialize(makeModelConfig());
+    return engine;
+}
+
+static std::vector<DetectionBox> detect(TiledInferenceEngine& engine, const cv::Mat& frame) {
+    auto result = std::dynamic_pointer_cast<ONNXInferenceResult>(engine.infer(frame));
+    return result && result->isValid() ? result->getDetectionResults() : std::vector<DetectionBox>();
+}
+
+static bool near(const cv::Rect2f& a, const cv::Rect2f& b) {
+    return std::fabs(a.x - b.x) < 0.5f && std::fabs(a.y - b.y) < 0.5f &&
+           std::fabs(a.width - b.width) < 0.5f && std::fabs(a.height - b.height) < 0.5f;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== 分块推理测试 ===" << std::endl << std::endl;
+
+    const cv::Size frameSize(1920, 1080);
+    const cv::Size tileSize(640, 640);
+    cv::Mat frame(frameSize.height, frameSize.width, CV_8UC3);
+
+    std::cout << "1. 分块几何" << std::endl;
+    {
+        auto tiles = TiledInferenceEngine::computeTiles(frameSize, tileSize, 0.2f);
+        check(tiles.size() == 8, "1920x1080 / 640 / 20% 重叠得到 4x2 块 (" + std::to_string(tiles.size()) + ")");
+
+        bool inside = true;
+        std::vector<int> coverage(static_cast<size_t>(frameSize.width * frameSize.height), 0);
+        for (const auto& tile : tiles) {
+            inside = inside && tile.x >= 0 && tile.y >= 0 && tile.width == tileSize.width &&
+                     tile.height == tileSize.height && tile.x + tile.width <= frameSize.width &&
+                     tile.y + tile.height <= frameSize.height;
+            for (int y = std::max(0, tile.y); y < std::min(frameSize.height, tile.y + tile.height); y++) {
+                for (int x = std::max(0, tile.x); x < std::min(frameSize.width, tile.x + tile.width); x++) {
+                    coverage[static_cast<size_t>(y * frameSize.width + x)]++;
+                }
+            }
+        }
+        check(inside, "分块尺寸等于模型输入且不越界");
+        check(std::find(coverage.begin(), coverage.end(), 0) == coverage.end(), "覆盖整帧");
+
+        int minOverlap = tileSize.width;
+        for (size_t i = 1; i < 4; i++) {
+            minOverlap = std::min(minOverlap, tiles[i - 1].x + tiles[i - 1].width - tiles[i].x);
+        }
+        check(minOverlap >= 128, "相邻分块至少重叠 20% (" + std::to_string(minOverlap) + " px)");
+
+        auto small = TiledInferenceEngine::computeTiles(cv::Size(320, 240), tileSize, 0.2f);
+        check(small.size() == 1 && small[0] == cv::Rect(0, 0, 320, 240), "小于分块的帧只有一块");
+        check(TiledInferenceEngine::computeTiles(cv::Size(640, 640), tileSize, 0.2f).size() == 1,
+              "与分块同尺寸的帧只有一块");
+    }
+
+    std::cout << std::endl << "2. 小目标" << std::endl;
+    {
+        // 16 像素的目标整帧缩放 3 倍后只剩约 5 像素
+        std::vector<DetectionBox> objects = {makeObject(100, 100, 16, 16, 0), makeObject(1700, 900, 16, 16, 1),
+                                             makeObject(800, 300, 400, 300, 2)};
+        FakeDetector plain(objects, 0);
+        auto plainResult = std::dynamic_pointer_cast<ONNXInferenceResult>(plain.infer(frame));
+        check(plainResult && plainResult->getDetectionResults().size() == 1, "整帧推理漏检小目标");
+
+        auto tiled = makeTiledEngine(objects, 2, true);
+        auto detections = detect(*tiled, frame);
+        size_t found = 0;
+        for (const auto& object : objects) {
+            for (const auto& box : detections) {
+                if (box.classId == object.classId && near(box.bbox, object.bbox)) {
+                    found++;
+                }
+            }
+        }
+        check(found == objects.size() && detections.size() == objects.size(),
+              "分块推理检出全部目标 (" + std::to_string(detections.size()) + " 个框)");
+        check(tiled->getLastTileCount() == 8, "使用 8 个分块");
+    }
+
+    std::cout << std::endl << "3. 跨分块合并" << std::endl;
+    {
+        // 完全落在第 1、2 列重叠区 [512, 640) 内的目标，和跨越分块边界的目标
+        std::vector<DetectionBox> objects = {makeObject(530, 200, 80, 80, 0), makeObject(590, 700, 120, 100, 1)};
+        auto tiled = makeTiledEngine(objects, 4, false);
+        auto detections = detect(*tiled, frame);
+
+        check(detections.size() == objects.size(), "重叠区域的重复框被合并 (" +
+              std::to_string(detections.size()) + " 个框)");
+        bool mapped = detections.size() == objects.size();
+        for (const auto& object : objects) {
+            bool matched = false;
+            for (const auto& box : detections) {
+                matched = matched || (box.classId == object.classId && near(box.bbox, object.bbox));
+            }
+            mapped = mapped && matched;
+        }
+        check(mapped, "保留完整可见的框并映射回整帧坐标");
+    }
+
+    if (benchmarkEnabled(argc, argv)) {
+        std::cout << std::endl << "4. 吞吐量" << std::endl;
+        std::vector<DetectionBox> objects = {makeObject(100, 100, 50, 50, 0)};
+        const int frames = 10;
+        const int workIterations = 2000000;
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<int> workerCounts = {1};
+        for (int workers = 2; workers <= static_cast<int>(std::min(cores, 8u)); workers *= 2) {
+            workerCounts.push_back(workers);
+        }
+
+        double baseFps = 0.0;
+        double bestSpeedup = 1.0;
+        std::cout << std::fixed << std::setprecision(2);
+        for (int workers : workerCounts) {
+            auto tiled = makeTiledEngine(objects, workers, true, workIterations);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) {
+                detect(*tiled, frame);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double fps = frames / seconds;
+            if (workers == 1) {
+                baseFps = fps;
+            }
+            bestSpeedup = std::max(bestSpeedup, fps / baseFps);
+            std::cout << "  " << workers << " 个副本: " << fps << " 帧/秒 (9 块/帧, 加速 " << fps / baseFps << "x)"
+                      << std::endl;
+        }
+
+        if (workerCounts.size() > 1) {
+            double expected = 0.6 * static_cast<double>(workerCounts.back());
+            check(bestSpeedup >= expected, "加速比随副本数接近线性增长");
+        } else {
+            std::cout << "  单核环境，跳过加速比检查" << std::endl;
+        }
+    }
+
+    return testSummary();
+}
@@ -0,0 +1,267 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_timer_wheel.cpp
+ * @brief 分层时间轮定时器测试程序
+ *
+ * 1. 一次性定时器：随机延迟（含随机取消）全部按时触发，不早于计划时刻，统计触发延迟
+ * 2. 跨层下移：秒级定时器经多层下移后按时触发，定时线程只在事件时刻醒来
+ * 3. 周期定时器：按计划时刻累加周期，长时间运行不漂移
+ * 4. 取消：回调执行中取消会等待其结束，回调内部可以取消自身
+ * 5. 执行器：回调交给线程池执行，不占用定时线程
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/TimerWheel.hpp"
+#include "TestCheck.hpp"
+
+using Clock = std::chrono::steady_clock;
+using utils::TimerWheel;
+
+static int64_t elapsedUs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+static void printStats(const TimerWheel::Stats& stats) {
+    std::cout << std::fixed << std::setprecision(1)
+              << "    触发 " << stats.fired << " 次, 取消 " << stats.cancelled << ", 唤醒 " << stats.wakeups
+              << " 次; 延迟 mean " << stats.meanLateUs << " us, p50 " << stats.p50LateUs
+              << " us, p99 " << stats.p99LateUs << " us, max " << stats.maxLateUs << " us" << std::endl;
+}
+
+static void testOneShot() {
+    std::cout << "\n1. 一次性定时器" << std::endl;
+    TimerWheel wheel;
+
+    const int count = 2000;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> delayDist(0, 1500);
+    std::vector<Clock::time_point> due(count);
+    std::vector<Clock::time_point> fired(count);
+    std::vector<std::atomic<int>> hits(count);
+    std::vector<TimerWheel::TimerId> ids(count);
+
+    for (int i = 0; i < count; i++) {
+        auto delay = std::chrono::milliseconds(delayDist(rng));
+        due[i] = Clock::now() + delay;
+        ids[i] = wheel.schedule(delay, [&, i]() {
+            fired[i] = Clock::now();
+            hits[i]++;
+        });
+    }
+
+    // 取消一半（延迟大于 100 ms 的才能保证在触发前取消）
+    int cancelled = 0;
+    std::vector<bool> expectFire(count, true);
+    for (int i = 0; i < count; i += 2) {
+        if (due[i] - Clock::now() > std::chrono::milliseconds(100)) {
+            if (wheel.cancel(ids[i])) {
+                cancelled++;
+            }
+            expectFire[i] = false;
+        }
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1700));
+
+    int wrongCount = 0;
+    int early = 0;
+    for (int i = 0; i < count; i++) {
+        if (hits[i] != (expectFire[i] ? 1 : 0)) {
+            wrongCount++;
+        } else if (expectFire[i] && fired[i] < due[i]) {
+            early++;
+        }
+    }
+    TimerWheel::Stats stats = wheel.getStats();
+    printStats(stats);
+    check(wrongCount == 0, "未取消的定时器各触发一次，取消的不触发");
+    check(early == 0, "没有定时器早于计划时刻触发");
+    check(static_cast<int>(stats.cancelled) == cancelled, "取消计数正确");
+    check(stats.active == 0, "全部到期后没有残留定时器");
+    check(stats.p50LateUs < 2000, "触发延迟中位数小于 2 ms（1 ms tick 向上取整 + 唤醒延迟）");
+    check(!wheel.cancel(ids[1]), "已触发的一次性定时器不能取消");
+}
+
+static void testCascade() {
+    std::cout << "\n2. 跨层下移" << std::endl;
+    TimerWheel wheel;
+
+    // 70 ms 在第 1 层，4.2 s 在第 2 层
+    const std::vector<int> delays = {70, 1000, 4200};
+    std::vector<Clock::time_point> due;
+    std::vector<Clock::time_point> fired(delays.size());
+    std::atomic<int> count{0};
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < delays.size(); i++) {
+        due.push_back(Clock::now() + std::chrono::milliseconds(delays[i]));
+        wheel.schedule(std::chrono::milliseconds(delays[i]), [&, i]() {
+            fired[i] = Clock::now();
+            count++;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(4400));
+
+    check(count == static_cast<int>(delays.size()), "各层定时器全部触发");
+    for (size_t i = 0; i < delays.size(); i++) {
+        int64_t late = elapsedUs(due[i], fired[i]);
+        std::cout << "    " << delays[i] << " ms: 延迟 " << late << " us" << std::endl;
+        check(late >= 0 && late < 5000, std::to_string(delays[i]) + " ms 定时器按时触发");
+    }
+
+    TimerWheel::Stats stats = wheel.getStats();
+    printStats(stats);
+    std::cout << "    " << elapsedUs(start, Clock::now()) / 1000 << " ms 内唤醒 " << stats.wakeups << " 次" << std::endl;
+    check(stats.wakeups < 20, "定时线程只在事件时刻醒来（不按 tick 轮询）");
+}
+
+static void testPeriodic() {
+    std::cout << "\n3. 周期定时器" << std::endl;
+    TimerWheel wheel;
+
+    const int64_t periodMs = 7;
+    std::mutex mutex;
+    std::vector<Clock::time_point> times;
+    TimerWheel::TimerId id = wheel.schedulePeriodic(std::chrono::milliseconds(periodMs), [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        times.push_back(Clock::now());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    check(wheel.cancel(id), "取消周期定时器");
+
+    // 相对首次触发、按周期取整后的偏差（落后时会跳过触发）：首尾各 21 次的中位数之差即漂移
+    size_t firedAtCancel;
+    double drift = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        firedAtCancel = times.size();
+        std::vector<int64_t> offsets;
+        for (size_t i = 0; i < times.size(); i++) {
+            int64_t elapsed = elapsedUs(times[0], times[i]);
+            int64_t periods = (elapsed + periodMs * 500) / (periodMs * 1000);
+            offsets.push_back(elapsed - periods * periodMs * 1000);
+        }
+        if (offsets.size() >= 42) {
+            std::vector<int64_t> head(offsets.begin(), offsets.begin() + 21);
+            std::vector<int64_t> tail(offsets.end() - 21, offsets.end());
+            std::nth_element(head.begin(), head.begin() + 10, head.end());
+            std::nth_element(tail.begin(), tail.begin() + 10, tail.end());
+            drift = static_cast<double>(tail[10] - head[10]);
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    TimerWheel::Stats stats = wheel.getStats();
+    size_t scheduled = firedAtCancel + stats.skipped;
+    std::cout << "    触发 " << firedAtCancel << " 次, 跳过 " << stats.skipped << " 次, " << std::fixed
+              << std::setprecision(1) << "首尾漂移 " << drift << " us" << std::endl;
+    check(scheduled >= 1500 / periodMs - 2 && scheduled <= 1500 / periodMs, "触发次数（含跳过）与周期一致");
+    check(std::abs(drift) < 1000, "长时间运行不漂移");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        check(times.size() == firedAtCancel, "取消后不再触发");
+    }
+    printStats(stats);
+}
+
+static void testCancel() {
+    std::cout << "\n4. 取消" << std::endl;
+    TimerWheel wheel;
+
+    // 回调执行中取消：cancel 等待回调结束
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    TimerWheel::TimerId slow = wheel.schedulePeriodic(std::chrono::milliseconds(5), [&]() {
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+    while (!entered) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    wheel.cancel(slow);
+    check(finished, "cancel 返回前正在执行的回调已结束");
+
+    // 回调内部取消自身
+    std::atomic<int> selfHits{0};
+    auto selfId = std::make_shared<std::atomic<TimerWheel::TimerId>>(TimerWheel::INVALID_TIMER);
+    *selfId = wheel.schedulePeriodic(std::chrono::milliseconds(3), [&, selfId]() {
+        if (++selfHits == 3) {
+            wheel.cancel(*selfId);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    check(selfHits == 3, "回调内部取消自身后不再触发");
+
+    // 停止后不再接受定时器
+    wheel.stop();
+    check(wheel.schedule(std::chrono::milliseconds(1), []() {}) == TimerWheel::INVALID_TIMER,
+          "停止后拒绝新的定时器");
+}
+
+static void testExecutor() {
+    std::cout << "\n5. 执行器" << std::endl;
+    TimerWheel wheel;
+    utils::ThreadPool pool(2);
+
+    std::thread::id wheelThread;
+    std::atomic<bool> inlineDone{false};
+    wheel.schedule(std::chrono::milliseconds(1), [&]() {
+        wheelThread = std::this_thread::get_id();
+        inlineDone = true;
+    });
+
+    // 执行器上的慢回调不影响其他定时器
+    std::atomic<int> slowDone{0};
+    for (int i = 0; i < 4; i++) {
+        wheel.schedule(std::chrono::milliseconds(5), [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            slowDone++;
+        }, TimerWheel::poolExecutor(pool));
+    }
+    std::thread::id poolThread;
+    std::atomic<bool> poolDone{false};
+    wheel.schedule(std::chrono::milliseconds(10), [&]() {
+        poolThread = std::this_thread::get_id();
+        poolDone = true;
+    }, TimerWheel::poolExecutor(pool));
+    Clock::time_point quickDue = Clock::now() + std::chrono::milliseconds(20);
+    Clock::time_point quickFired;
+    std::atomic<bool> quickDone{false};
+    wheel.schedule(std::chrono::milliseconds(20), [&]() {
+        quickFired = Clock::now();
+        quickDone = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    check(inlineDone && quickDone, "定时线程上的回调已执行");
+    check(quickDone && elapsedUs(quickDue, quickFired) < 5000, "执行器忙时定时线程上的回调仍按时触发");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    check(slowDone == 4 && poolDone, "执行器上的回调全部执行");
+    check(poolThread != wheelThread, "回调在执行器线程上执行");
+    printStats(wheel.getStats());
+}
+
+int main() {
+    std::cout << "=== 分层时间轮定时器测试 ===" << std::endl;
+
+    testOneShot();
+    testCascade();
+    testPeriodic();
+    testCancel();
+    testExecutor();
+
+    return testSummary();
+}
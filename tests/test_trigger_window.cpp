@@ -0,0 +1,177 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_trigger_window.cpp
+ * @brief 触发式录制缓冲窗口测试程序
+ *
+ * 1. 触发前窗口：只保留最近 N 秒的历史帧，触发时按顺序写出
+ * 2. 触发后窗口：截止时间内的帧写盘，之后的帧回到环形缓冲
+ * 3. 字节预算：环形缓冲与写盘队列合计不超过上限，先淘汰历史帧再丢弃待写帧
+ * 4. 重叠触发：录制阶段内的触发延长事件，紧随其后的新事件不重复写出已写过的帧
+ */
+
+#include <iostream>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+#include "core/TriggerWindow.hpp"
+#include "TestCheck.hpp"
+
+using Window = TriggerWindow<int>;
+using Clock = Window::Clock;
+
+static Window::Options makeOptions(int preMs, int postMs, size_t maxBytes) {
+    Window::Options options;
+    options.preWindow = std::chrono::milliseconds(preMs);
+    options.postWindow = std::chrono::milliseconds(postMs);
+    options.maxBytes = maxBytes;
+    return options;
+}
+
+/**
+ * @brief 取出全部待写帧
+ */
+static std::vector<Window::WriteTask> drain(Window& window) {
+    std::vector<Window::WriteTask> tasks;
+    Window::WriteTask task;
+    while (window.pop(task)) {
+        tasks.push_back(task);
+    }
+    return tasks;
+}
+
+static Clock::time_point at(Clock::time_point base, int ms) {
+    return base + std::chrono::milliseconds(ms);
+}
+
+static void testPreWindow() {
+    std::cout << "\n1. 触发前窗口" << std::endl;
+    Window window;
+    auto options = makeOptions(1000, 500, 1 << 20);
+    auto base = Clock::now();
+
+    // 每 100ms 一帧，共 30 帧（3 秒）
+    for (int i = 0; i < 30; i++) {
+        window.push(i, 100, at(base, i * 100), options);
+    }
+    check(window.bufferedFrames() == 11, "只保留最近 1 秒的历史帧");
+
+    size_t preFrames = window.start("event_a", at(base, 2950), options);
+    auto tasks = drain(window);
+    check(preFrames == 10 && tasks.size() == 10, "触发时淘汰过期帧后写出历史帧");
+    check(!tasks.empty() && tasks.front().item == 20 && tasks.back().item == 29, "历史帧按时间顺序写出");
+    check(!tasks.empty() && tasks.front().path == "event_a", "写盘任务带有事件目录");
+    check(window.bufferedFrames() == 0 && window.bufferedBytes() == 0, "触发后环形缓冲清空");
+}
+
+static void testPostWindow() {
+    std::cout << "\n2. 触发后窗口" << std::endl;
+    Window window;
+    auto options = makeOptions(1000, 500, 1 << 20);
+    auto base = Clock::now();
+
+    window.start("event_a", base, options);
+    check(window.recording(), "进入触发后录制阶段");
+
+    bool finished = false;
+    for (int i = 1; i <= 8; i++) {
+        finished = window.push(i, 100, at(base, i * 100), options) || finished;
+    }
+    auto tasks = drain(window);
+    check(tasks.size() == 5 && tasks.back().item == 5, "截止时间内的帧写盘");
+    check(finished && !window.recording(), "截止后的第一帧结束事件");
+    check(window.bufferedFrames() == 3, "截止后的帧回到环形缓冲");
+}
+
+static void testByteBudget() {
+    std::cout << "\n3. 字节预算" << std::endl;
+    Window window;
+    auto options = makeOptions(10000, 10000, 1000);
+    auto base = Clock::now();
+
+    for (int i = 0; i < 20; i++) {
+        window.push(i, 100, at(base, i), options);
+    }
+    check(window.bufferedBytes() == 1000 && window.bufferedFrames() == 10, "环形缓冲不超过字节上限");
+
+    // 写盘线程未取走任何帧：写盘队列与环形缓冲合计仍受同一上限约束
+    window.start("event_a", at(base, 20), options);
+    bool withinBudget = true;
+    for (int i = 20; i < 40; i++) {
+        window.push(i, 100, at(base, i), options);
+        withinBudget = withinBudget && window.bufferedBytes() + window.queuedBytes() <= options.maxBytes;
+    }
+    check(withinBudget, "录制期间合计字节数不超过上限（不是两倍）");
+    check(window.queuedBytes() == 1000 && window.droppedFrames() == 20, "写盘队列占满预算时丢弃新帧");
+
+    // 写盘队列腾出空间后恢复写入
+    drain(window);
+    window.push(40, 100, at(base, 40), options);
+    check(window.queuedFrames() == 1 && window.droppedFrames() == 20, "写盘队列腾出空间后恢复写入");
+
+    // 录制结束后，历史帧为待写帧让出预算
+    Window idle;
+    auto small = makeOptions(10000, 100, 500);
+    idle.start("event_b", base, small);
+    for (int i = 0; i < 3; i++) {
+        idle.push(i, 100, at(base, 10 + i), small);
+    }
+    for (int i = 3; i < 10; i++) {
+        idle.push(i, 100, at(base, 200 + i), small);
+    }
+    check(idle.queuedBytes() == 300 && idle.bufferedBytes() == 200, "历史帧只使用写盘队列剩余的预算");
+}
+
+static void testOverlappingTriggers() {
+    std::cout << "\n4. 重叠触发" << std::endl;
+    Window window;
+    auto options = makeOptions(1000, 300, 1 << 20);
+    auto base = Clock::now();
+    std::vector<Window::WriteTask> written;
+
+    for (int i = 0; i < 5; i++) {
+        window.push(i, 100, at(base, i * 100), options);
+    }
+    window.start("event_a", at(base, 450), options);
+
+    // 录制阶段内再次触发：延长截止时间，不新建事件
+    window.push(5, 100, at(base, 500), options);
+    check(window.extend(at(base, 600), options), "录制阶段内的触发合并到进行中的事件");
+    for (int i = 6; i <= 12; i++) {
+        window.push(i, 100, at(base, i * 100), options);
+    }
+    auto first = drain(window);
+    check(!first.empty() && first.back().item == 9, "合并后截止时间延长");
+    written.insert(written.end(), first.begin(), first.end());
+
+    // 事件结束后立即触发新事件：历史帧只包含上一个事件未写过的帧
+    check(!window.extend(at(base, 1250), options), "截止后的触发不合并");
+    window.start("event_b", at(base, 1250), options);
+    for (int i = 13; i <= 20; i++) {
+        window.push(i, 100, at(base, i * 100), options);
+    }
+    auto second = drain(window);
+    check(!second.empty() && second.front().item == 10 && second.front().path == "event_b",
+          "新事件从上一个事件之后的帧开始");
+    written.insert(written.end(), second.begin(), second.end());
+
+    std::set<int> unique;
+    for (const auto& task : written) {
+        unique.insert(task.item);
+    }
+    check(unique.size() == written.size(), "每帧只写出一次");
+    check(written.size() == 16 && *unique.begin() == 0 && *unique.rbegin() == 15, "两个事件覆盖连续的帧");
+}
+
+int main() {
+    std::cout << "=== 触发式录制缓冲窗口测试 ===" << std::endl;
+
+    testPreWindow();
+    testPostWindow();
+    testByteBudget();
+    testOverlappingTriggers();
+
+    return testSummary();
+}
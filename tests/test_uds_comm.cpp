@@ -0,0 +1,343 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_uds_comm.cpp
+ * @brief Unix 域套接字通信测试程序
+ *
+ * 1. 一个服务端连接三个客户端：广播按顺序到达每个客户端，数据包边界保留（载荷可含分隔符）
+ * 2. 慢客户端：不读取的客户端只在自己的队列里丢弃最旧的消息，不阻塞发送和其他客户端
+ * 3. 重新连接：客户端断开后立即接受新连接；服务端重启后客户端自动重连
+ * 4. 往返延迟：UDS vs FIFO（性能测试，--benchmark 时运行）
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "com/UdsComm.hpp"
+#include "com/FifoComm.hpp"
+#include "com/BinaryFrame.hpp"
+#include "TestCheck.hpp"
+
+/**
+ * @brief 接收线程：持续调用 receiveMessages（与 CommunicationProxy 的接收线程相同）
+ */
+class ReceiveLoop {
+public:
+    ReceiveLoop(ICommunicationImpl& comm, ICommunicationImpl::MessageHandler handler)
+        : comm_(comm), handler_(std::move(handler)) {
+        thread_ = std::thread([this]() {
+            while (running_) {
+                comm_.receiveMessages(handler_, 100);
+            }
+        });
+    }
+
+    ~ReceiveLoop() {
+        running_ = false;
+        comm_.interruptReceive();
+        thread_.join();
+    }
+
+private:
+    ICommunicationImpl& comm_;
+    ICommunicationImpl::MessageHandler handler_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+/**
+ * @brief 反复接收直到满足条件或超时
+ */
+template <typename Predicate>
+static bool pumpUntil(ICommunicationImpl& comm, const ICommunicationImpl::MessageHandler& handler,
+                      Predicate done, int timeoutMs = 2000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        comm.receiveMessages(handler, 10);
+    }
+    return done();
+}
+
+static void testFanOut(const std::string& path) {
+    std::cout << "1. 多客户端广播" << std::endl;
+
+    UdsCommImpl server(path, UdsCommImpl::CommRole::SERVER);
+    check(server.initialize(UdsCommImpl::CommRole::SERVER) && server.isServer(), "服务端初始化");
+
+    int connectedEvents = 0;
+    server.setPeerConnectedHandler([&]() { connectedEvents++; });
+
+    std::vector<std::unique_ptr<UdsCommImpl>> clients;
+    bool allConnected = true;
+    for (int i = 0; i < 3; i++) {
+        clients.push_back(std::make_unique<UdsCommImpl>(path, UdsCommImpl::CommRole::CLIENT));
+        allConnected = allConnected && clients.back()->initialize(UdsCommImpl::CommRole::CLIENT) &&
+                       !clients.back()->isServer();
+    }
+    auto noop = [](std::string_view) {};
+    pumpUntil(server, noop, [&]() { return server.peerCount() == 3; });
+    check(allConnected && server.peerCount() == 3 && connectedEvents == 3, "三个客户端同时连接，无需重试");
+
+    // 文本消息与含分隔符的二进制帧混合
+    std::string payload("a\nb\n\xA5\x5A", 6);
+    std::string frame(BinaryFrame::OVERHEAD + payload.size(), '\0');
+    FrameHeader header;
+    header.type = 5;
+    BinaryFrame::encode(&frame[0], frame.size(), header, payload.data(), payload.size());
+
+    const int count = 1000;
+    std::vector<std::string> expected;
+    for (int i = 0; i < count; i++) {
+        expected.push_back(i % 10 == 0 ? frame : "4:" + std::to_string(i));
+        server.sendMessage(expected.back());
+    }
+
+    bool allOrdered = true;
+    for (auto& client : clients) {
+        std::vector<std::string> received;
+        pumpUntil(*client, [&](std::string_view message) { received.emplace_back(message); },
+                  [&]() { return received.size() >= expected.size(); });
+        allOrdered = allOrdered && received == expected;
+    }
+    check(allOrdered, "1000 条广播按顺序到达每个客户端，二进制帧完整");
+
+    int fromClients = 0;
+    for (int i = 0; i < 3; i++) {
+        clients[i]->sendMessage("0:client " + std::to_string(i));
+    }
+    pumpUntil(server, [&](std::string_view message) { fromClients += message.rfind("0:client ", 0) == 0; },
+              [&]() { return fromClients == 3; });
+    check(fromClients == 3, "服务端收到每个客户端的消息");
+
+    std::string single;
+    clients[0]->sendMessage("0:a");
+    clients[0]->sendMessage("0:b");
+    server.setReceiveTimeout(500);
+    bool first = server.receiveMessage(single) && single == "0:a";
+    bool second = server.receiveMessage(single) && single == "0:b";
+    check(first && second, "receiveMessage 逐条返回");
+}
+
+static void testSlowClient(const std::string& path) {
+    std::cout << std::endl << "2. 慢客户端" << std::endl;
+
+    const size_t queueLimit = 64;
+    UdsCommImpl server(path, UdsCommImpl::CommRole::SERVER, queueLimit);
+    server.initialize(UdsCommImpl::CommRole::SERVER);
+    UdsCommImpl fast(path, UdsCommImpl::CommRole::CLIENT);
+    UdsCommImpl slow(path, UdsCommImpl::CommRole::CLIENT);
+    fast.initialize(UdsCommImpl::CommRole::CLIENT);
+    slow.initialize(UdsCommImpl::CommRole::CLIENT);
+    auto noop = [](std::string_view) {};
+    pumpUntil(server, noop, [&]() { return server.peerCount() == 2; });
+
+    const int count = 20000;
+    std::atomic<int> fastReceived{0};
+    std::atomic<bool> fastOrdered{true};
+    double maxSendUs = 0.0;
+    {
+        ReceiveLoop serverLoop(server, noop);
+        ReceiveLoop fastLoop(fast, [&](std::string_view message) {
+            int index = std::stoi(std::string(message.substr(2, message.find(' ') - 2)));
+            fastOrdered = fastOrdered && index == fastReceived;
+            fastReceived++;
+        });
+
+        std::string padding(1000, 'x');
+        for (int i = 0; i < count; i++) {
+            auto start = std::chrono::steady_clock::now();
+            server.sendMessage("5:" + std::to_string(i) + " " + padding);
+            maxSendUs = std::max(maxSendUs, std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count());
+            if (i % 100 == 99) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (fastReceived < count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // 慢客户端现在开始读取：收到的是套接字缓冲区中的旧消息加上队列中最新的消息
+    int slowReceived = 0;
+    int slowLast = -1;
+    bool slowOrdered = true;
+    ReceiveLoop serverLoop(server, noop);
+    while (slow.receiveMessages([&](std::string_view message) {
+        int index = std::stoi(std::string(message.substr(2, message.find(' ') - 2)));
+        slowOrdered = slowOrdered && index > slowLast;
+        slowLast = index;
+        slowReceived++;
+    }, 200) > 0) {
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  快客户端收到 " << fastReceived << "/" << count << ", 慢客户端收到 " << slowReceived
+              << " (最后一条 #" << slowLast << "), 丢弃 " << server.droppedMessages() << ", 单次广播最长 "
+              << maxSendUs << " us" << std::endl;
+    check(fastReceived == count && fastOrdered, "快客户端按顺序收到全部消息");
+    check(server.droppedMessages() > 0 && slowReceived < count, "慢客户端的队列有上限，超出部分丢弃");
+    check(slowOrdered && slowLast == count - 1, "慢客户端丢弃的是最旧的消息，最新消息仍会送达");
+    check(maxSendUs < 50000.0, "广播不会因慢客户端而阻塞");
+}
+
+static void testReconnect(const std::string& path) {
+    std::cout << std::endl << "3. 重新连接" << std::endl;
+
+    auto server = std::make_unique<UdsCommImpl>(path, UdsCommImpl::CommRole::SERVER);
+    server->initialize(UdsCommImpl::CommRole::SERVER);
+    std::atomic<int> serverConnected{0};
+    server->setPeerConnectedHandler([&]() { serverConnected++; });
+    auto noop = [](std::string_view) {};
+
+    {
+        UdsCommImpl client(path, UdsCommImpl::CommRole::CLIENT);
+        client.initialize(UdsCommImpl::CommRole::CLIENT);
+        pumpUntil(*server, noop, [&]() { return server->peerCount() == 1; });
+        client.cleanup();
+    }
+    pumpUntil(*server, noop, [&]() { return !server->isConnected(); });
+    check(!server->isConnected(), "客户端断开后服务端标记为未连接");
+
+    std::atomic<int> reconnectedAt{0};
+    double acceptMs = 0.0;
+    UdsCommImpl client(path, UdsCommImpl::CommRole::CLIENT);
+    {
+        ReceiveLoop serverLoop(*server, noop);
+        auto start = std::chrono::steady_clock::now();
+        client.initialize(UdsCommImpl::CommRole::CLIENT);
+        while (serverConnected < 2 && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+            std::this_thread::yield();
+        }
+        acceptMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::cout << std::fixed << std::setprecision(2) << "  新客户端被接受用时 " << acceptMs << " ms" << std::endl;
+    check(serverConnected == 2 && acceptMs < 100.0, "新客户端立即被接受");
+
+    // 服务端重启：客户端在接收循环中自动重连
+    int clientReconnected = 0;
+    client.setPeerConnectedHandler([&]() { clientReconnected++; });
+    server->cleanup();
+    pumpUntil(client, noop, [&]() { return !client.isConnected(); });
+    check(!client.isConnected(), "服务端退出后客户端标记为未连接");
+
+    server = std::make_unique<UdsCommImpl>(path, UdsCommImpl::CommRole::SERVER);
+    server->initialize(UdsCommImpl::CommRole::SERVER);
+    pumpUntil(client, noop, [&]() { return client.isConnected(); });
+    check(client.isConnected() && clientReconnected == 1, "服务端重启后客户端自动重连并触发回调");
+
+    std::string received;
+    client.sendMessage("0:after restart");
+    server->setReceiveTimeout(500);
+    check(server->receiveMessage(received) && received == "0:after restart", "重连后消息正常到达");
+
+    UdsCommImpl autoRole(path, UdsCommImpl::CommRole::AUTO);
+    check(autoRole.initialize() && !autoRole.isServer(), "AUTO：服务端存在时作为客户端");
+}
+
+/**
+ * @brief 测量往返延迟(微秒)，返回排序后的样本
+ */
+static std::vector<double> measureRoundTrips(ICommunicationImpl& server, ICommunicationImpl& client, int iterations) {
+    ReceiveLoop echo(server, [&server](std::string_view message) { server.sendMessage(std::string(message)); });
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+    for (int i = 0; i < iterations; i++) {
+        std::string request = "0:ping " + std::to_string(i);
+        auto start = std::chrono::steady_clock::now();
+        client.sendMessage(request);
+
+        bool received = false;
+        pumpUntil(client, [&](std::string_view reply) { received = received || reply == request; },
+                  [&]() { return received; });
+        if (!received) {
+            break;
+        }
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+static void printLatency(const std::string& name, const std::vector<double>& samples) {
+    if (samples.empty()) {
+        std::cout << "  " << name << ": 无样本" << std::endl;
+        return;
+    }
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << name << ": 平均 " << sum / samples.size() << " us, p50 " << samples[samples.size() / 2]
+              << " us, p99 " << samples[samples.size() * 99 / 100] << " us" << std::endl;
+}
+
+static void benchmarkRoundTrip(const std::string& path) {
+    std::cout << std::endl << "4. 往返延迟" << std::endl;
+
+    const int iterations = 5000;
+    std::vector<double> udsSamples;
+    {
+        UdsCommImpl server(path, UdsCommImpl::CommRole::SERVER);
+        UdsCommImpl client(path, UdsCommImpl::CommRole::CLIENT);
+        server.initialize(UdsCommImpl::CommRole::SERVER);
+        client.initialize(UdsCommImpl::CommRole::CLIENT);
+        udsSamples = measureRoundTrips(server, client, iterations);
+    }
+
+    std::vector<double> fifoSamples;
+    {
+        std::string basePath = path + "_fifo";
+        FifoCommImpl server(basePath, FifoCommImpl::CommRole::SERVER);
+        FifoCommImpl client(basePath, FifoCommImpl::CommRole::CLIENT);
+
+        // FIFO 服务端阻塞等待客户端打开管道，放到单独线程
+        std::atomic<bool> serverOk{false};
+        std::thread serverThread([&]() { serverOk = server.initialize(FifoCommImpl::CommRole::SERVER); });
+        struct stat st;
+        for (int i = 0; i < 200 && (stat((basePath + "_in").c_str(), &st) != 0 ||
+                                    stat((basePath + "_out").c_str(), &st) != 0); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        bool clientOk = client.initialize(FifoCommImpl::CommRole::CLIENT);
+        serverThread.join();
+        if (serverOk && clientOk) {
+            fifoSamples = measureRoundTrips(server, client, iterations);
+        }
+        client.cleanup();
+    }
+
+    printLatency("UDS (SOCK_SEQPACKET)", udsSamples);
+    printLatency("FIFO", fifoSamples);
+    check(udsSamples.size() == static_cast<size_t>(iterations) && fifoSamples.size() == static_cast<size_t>(iterations),
+          "所有请求都收到回复");
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== Unix 域套接字通信测试 ===" << std::endl << std::endl;
+
+    std::string path = "/tmp/test_uds_comm_" + std::to_string(getpid());
+    testFanOut(path + ".sock");
+    testSlowClient(path + "_slow.sock");
+    testReconnect(path + "_reconnect.sock");
+    if (benchmarkEnabled(argc, argv)) {
+        benchmarkRoundTrip(path);
+    }
+
+    return testSummary();
+}
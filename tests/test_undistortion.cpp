@@ -0,0 +1,166 @@
+// Copyright (c) Orbbec Inc. All Rights Reserved.
+// Licensed under the MIT License.
+
+/**
+ * @file test_undistortion.cpp
+ * @brief 流式去畸变处理阶段测试程序
+ *
+ * 1. 预计算映射 + 分带 remap 与 cv::undistort 结果一致
+ * 2. 每帧耗时：cv::undistort（每次重算映射）vs UndistortionStage
+ * 3. 不同分辨率（相同宽高比）按比例缩放内参，宽高比不同时不处理
+ * 4. 去畸变图像上的点与框映射回原始图像坐标（与 cv::undistortPoints 互逆）
+ * 5. 替换标定结果后使用新映射，清除后不再处理
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include "calibration/UndistortionStage.hpp"
+#include "TestCheck.hpp"
+
+using namespace calibration;
+
+static CalibrationResult makeCalibration(const cv::Size& size, double k1) {
+    CalibrationResult result;
+    result.cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
+    result.cameraMatrix.at<double>(0, 0) = 0.9 * size.width;
+    result.cameraMatrix.at<double>(1, 1) = 0.9 * size.width;
+    result.cameraMatrix.at<double>(0, 2) = size.width * 0.5 + 3.0;
+    result.cameraMatrix.at<double>(1, 2) = size.height * 0.5 - 2.0;
+    result.distCoeffs = cv::Mat::zeros(1, 5, CV_64F);
+    result.distCoeffs.at<double>(0, 0) = k1;
+    result.distCoeffs.at<double>(0, 1) = 0.08;
+    result.distCoeffs.at<double>(0, 2) = 0.001;
+    result.distCoeffs.at<double>(0, 3) = -0.0005;
+    result.imageSize = size;
+    result.rms = 0.3;
+    result.isValid = true;
+    return result;
+}
+
+static cv::Mat makeImage(const cv::Size& size) {
+    cv::Mat image(size.height, size.width, CV_8UC3);
+    cv::RNG rng(7);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+    return image;
+}
+
+template <typename F>
+static double measureMs(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main() {
+    std::cout << "=== 去畸变处理阶段测试 ===" << std::endl << std::endl;
+
+    const cv::Size size(1280, 720);
+    CalibrationResult calibration = makeCalibration(size, -0.25);
+    cv::Mat image = makeImage(size);
+
+    UndistortionStage stage;
+    check(!stage.isActive(), "未设置标定结果时不处理");
+    stage.setCalibration(calibration);
+
+    std::cout << "1. 结果一致性" << std::endl;
+    {
+        cv::Mat reference, output;
+        cv::undistort(image, reference, calibration.cameraMatrix, calibration.distCoeffs);
+        check(stage.apply(image, output), "去畸变成功");
+        check(output.size() == image.size() && output.type() == image.type(), "输出尺寸与类型不变");
+        double maxDiff = cv::norm(reference, output, cv::NORM_INF);
+        check(maxDiff <= 1.0, "与 cv::undistort 的最大差异 " + std::to_string(maxDiff) + " <= 1");
+    }
+
+    std::cout << std::endl << "2. 每帧耗时" << std::endl;
+    {
+        const int iterations = 50;
+        cv::Mat output;
+        double undistortMs = measureMs(iterations, [&]() {
+            cv::undistort(image, output, calibration.cameraMatrix, calibration.distCoeffs);
+        });
+        double stageMs = measureMs(iterations, [&]() { stage.apply(image, output); });
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "  cv::undistort:     " << undistortMs << " ms/帧" << std::endl;
+        std::cout << "  UndistortionStage: " << stageMs << " ms/帧 (" << undistortMs / stageMs << "x)" << std::endl;
+        check(stageMs < undistortMs, "预计算映射比每帧重算更快");
+        check(stage.getStats().mapsBuilt == 1, "同一分辨率只生成一次映射");
+    }
+
+    std::cout << std::endl << "3. 分辨率" << std::endl;
+    {
+        cv::Size half(size.width / 2, size.height / 2);
+        cv::Mat small = makeImage(half);
+        cv::Mat output;
+        check(stage.apply(small, output) && output.size() == half, "相同宽高比的分辨率按比例缩放内参");
+
+        CalibrationResult scaled = calibration;
+        scaled.cameraMatrix = calibration.cameraMatrix.clone();
+        for (int r = 0; r < 2; r++) {
+            for (int c = 0; c < 3; c++) {
+                scaled.cameraMatrix.at<double>(r, c) *= 0.5;
+            }
+        }
+        cv::Mat reference;
+        cv::undistort(small, reference, scaled.cameraMatrix, scaled.distCoeffs);
+        check(cv::norm(reference, output, cv::NORM_INF) <= 1.0, "缩放内参后结果与 cv::undistort 一致");
+
+        cv::Mat square = makeImage(cv::Size(640, 640));
+        check(!stage.apply(square, output), "宽高比不同时不处理");
+        check(stage.getStats().mapsBuilt == 2, "每个兼容分辨率生成一次映射");
+    }
+
+    std::cout << std::endl << "4. 映射回原始图像坐标" << std::endl;
+    {
+        // 原始图像上的点经 cv::undistortPoints 去畸变后，应映射回原处
+        std::vector<cv::Point2f> original = {{100.0f, 80.0f}, {640.0f, 360.0f}, {1200.0f, 650.0f}, {900.0f, 120.0f}};
+        std::vector<cv::Point2f> points;
+        cv::undistortPoints(original, points, calibration.cameraMatrix, calibration.distCoeffs, cv::noArray(),
+                            calibration.cameraMatrix);
+        check(stage.distortPoints(points, size), "映射成功");
+        double maxError = 0.0;
+        for (size_t i = 0; i < points.size(); i++) {
+            maxError = std::max(maxError, cv::norm(points[i] - original[i]));
+        }
+        check(maxError < 0.1, "与 cv::undistortPoints 互逆 (最大误差 " + std::to_string(maxError) + " 像素)");
+
+        // 框的四角与各边中点都落在映射后的框内
+        cv::Rect2f box(200.0f, 150.0f, 300.0f, 200.0f);
+        cv::Rect2f mapped = box;
+        check(stage.distortBox(mapped, size), "框映射成功");
+        std::vector<cv::Point2f> samples = {{200.0f, 150.0f}, {350.0f, 150.0f}, {500.0f, 350.0f}, {200.0f, 250.0f}};
+        stage.distortPoints(samples, size);
+        bool contained = true;
+        for (const auto& sample : samples) {
+            contained = contained && sample.x >= mapped.x - 1e-3f && sample.x <= mapped.x + mapped.width + 1e-3f &&
+                        sample.y >= mapped.y - 1e-3f && sample.y <= mapped.y + mapped.height + 1e-3f;
+        }
+        check(contained, "映射后的框包含原框边上的点");
+
+        cv::Rect2f square = box;
+        check(!stage.distortBox(square, cv::Size(640, 640)) && square == box, "宽高比不同时不映射");
+    }
+
+    std::cout << std::endl << "5. 替换标定结果" << std::endl;
+    {
+        cv::Mat before, after;
+        stage.apply(image, before);
+        CalibrationResult updated = makeCalibration(size, -0.1);
+        stage.setCalibration(updated);
+
+        cv::Mat reference;
+        cv::undistort(image, reference, updated.cameraMatrix, updated.distCoeffs);
+        check(stage.apply(image, after) && cv::norm(reference, after, cv::NORM_INF) <= 1.0, "使用新的映射表");
+        check(cv::norm(before, after, cv::NORM_INF) > 0.0, "新旧结果不同");
+
+        stage.reset();
+        check(!stage.isActive() && !stage.apply(image, after), "清除后不再处理");
+    }
+
+    return testSummary();
+}